@@ -1,8 +1,18 @@
+use std::borrow::Cow;
+use std::io::Read;
+
+use flate2::read::GzDecoder;
 use lambda_http::{Body, Request, Response};
 use serde::{Deserialize, Serialize};
 
-use crate::error::ApiError;
-use esp32_backend::domain::Reading;
+use crate::error::{ApiError, ValidationError};
+use esp32_backend::domain::{Reading, SensorStatus, SensorValues};
+
+/// Schema tag selecting the columnar request format
+pub const COLUMNAR_SCHEMA: &str = "columnar-v1";
+
+/// Largest body accepted after decompression (guards against gzip bombs)
+pub const MAX_DECODED_BODY_BYTES: u64 = 1024 * 1024;
 
 /// Request payload for POST /data endpoint
 ///
@@ -14,6 +24,168 @@ pub struct DataRequest {
     pub readings: Vec<Reading>,
 }
 
+/// Columnar request payload for POST /data (`"schema": "columnar-v1"`)
+///
+/// Device identity is sent once; every per-reading field is an array with one entry
+/// per reading. Bit N of `sensor_mask` marks sensor N as present, in firmware order:
+/// bme280_temp_c, ds18b20_temp_c, humidity_pct, pressure_hpa, soil_moisture_pct.
+/// Values of absent sensors are placeholders and are dropped.
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct ColumnarDataRequest {
+    pub schema: String,
+    pub hardware_id: String,
+    pub boot_id: String,
+    pub firmware_version: String,
+    #[serde(default)]
+    pub friendly_name: Option<String>,
+    pub batch_id: Vec<String>,
+    pub timestamp_ms: Vec<i64>,
+    pub sensor_mask: Vec<u8>,
+    pub bme280_temp_c: Vec<f64>,
+    pub ds18b20_temp_c: Vec<f64>,
+    pub humidity_pct: Vec<f64>,
+    pub pressure_hpa: Vec<f64>,
+    pub soil_moisture_pct: Vec<f64>,
+}
+
+impl ColumnarDataRequest {
+    /// Expand the columns into one row Reading per batch_id
+    ///
+    /// Fails if any column does not have exactly one entry per batch_id.
+    pub fn into_data_request(self) -> Result<DataRequest, String> {
+        let ColumnarDataRequest {
+            hardware_id,
+            boot_id,
+            firmware_version,
+            friendly_name,
+            batch_id,
+            timestamp_ms,
+            sensor_mask,
+            bme280_temp_c,
+            ds18b20_temp_c,
+            humidity_pct,
+            pressure_hpa,
+            soil_moisture_pct,
+            ..
+        } = self;
+
+        let count = batch_id.len();
+        let columns = [
+            ("timestamp_ms", timestamp_ms.len()),
+            ("sensor_mask", sensor_mask.len()),
+            ("bme280_temp_c", bme280_temp_c.len()),
+            ("ds18b20_temp_c", ds18b20_temp_c.len()),
+            ("humidity_pct", humidity_pct.len()),
+            ("pressure_hpa", pressure_hpa.len()),
+            ("soil_moisture_pct", soil_moisture_pct.len()),
+        ];
+        for (name, len) in columns {
+            if len != count {
+                return Err(format!(
+                    "column {} has {} entries, expected {}",
+                    name, len, count
+                ));
+            }
+        }
+
+        let readings = batch_id
+            .into_iter()
+            .enumerate()
+            .map(|(i, batch_id)| {
+                let present = |bit: u8| sensor_mask[i] & (1 << bit) != 0;
+                let value = |bit: u8, column: &[f64]| present(bit).then(|| column[i]);
+                let status =
+                    |bit: u8| (if present(bit) { "ok" } else { "unavailable" }).to_string();
+
+                Reading {
+                    batch_id,
+                    hardware_id: hardware_id.clone(),
+                    timestamp_ms: timestamp_ms[i],
+                    boot_id: boot_id.clone(),
+                    firmware_version: firmware_version.clone(),
+                    friendly_name: friendly_name.clone(),
+                    sensors: SensorValues {
+                        bme280_temp_c: value(0, &bme280_temp_c),
+                        ds18b20_temp_c: value(1, &ds18b20_temp_c),
+                        humidity_pct: value(2, &humidity_pct),
+                        pressure_hpa: value(3, &pressure_hpa),
+                        soil_moisture_pct: value(4, &soil_moisture_pct),
+                    },
+                    sensor_status: SensorStatus {
+                        bme280: status(0),
+                        ds18b20: status(1),
+                        soil_moisture: status(4),
+                    },
+                }
+            })
+            .collect();
+
+        Ok(DataRequest { readings })
+    }
+}
+
+/// Parse a POST /data body in either schema
+///
+/// Bodies without a top-level `schema` field are row requests (`readings` array);
+/// `"schema": "columnar-v1"` selects [`ColumnarDataRequest`], which is expanded to rows.
+pub fn parse_data_request(body: &[u8]) -> Result<DataRequest, ValidationError> {
+    #[derive(Deserialize)]
+    struct SchemaProbe {
+        #[serde(default)]
+        schema: Option<String>,
+    }
+
+    let parse_error =
+        |e: serde_json::Error| ValidationError::InvalidBody(format!("Failed to parse JSON: {}", e));
+
+    let probe: SchemaProbe = serde_json::from_slice(body).map_err(parse_error)?;
+    match probe.schema.as_deref() {
+        None => serde_json::from_slice(body).map_err(parse_error),
+        Some(COLUMNAR_SCHEMA) => {
+            let columnar: ColumnarDataRequest =
+                serde_json::from_slice(body).map_err(parse_error)?;
+            columnar
+                .into_data_request()
+                .map_err(ValidationError::InvalidBody)
+        }
+        Some(other) => Err(ValidationError::InvalidBody(format!(
+            "Unsupported schema: {}",
+            other
+        ))),
+    }
+}
+
+/// Undo the request's `Content-Encoding`
+///
+/// Devices gzip large catch-up batches; uncompressed bodies are borrowed unchanged.
+pub fn decode_body<'a>(
+    content_encoding: Option<&str>,
+    body: &'a [u8],
+) -> Result<Cow<'a, [u8]>, ValidationError> {
+    match content_encoding.map(str::trim) {
+        None | Some("") | Some("identity") => Ok(Cow::Borrowed(body)),
+        Some(encoding) if encoding.eq_ignore_ascii_case("gzip") => {
+            let mut decoded = Vec::new();
+            GzDecoder::new(body)
+                .take(MAX_DECODED_BODY_BYTES + 1)
+                .read_to_end(&mut decoded)
+                .map_err(|e| {
+                    ValidationError::InvalidBody(format!("Failed to decompress gzip body: {}", e))
+                })?;
+            if decoded.len() as u64 > MAX_DECODED_BODY_BYTES {
+                return Err(ValidationError::InvalidBody(
+                    "Decompressed body too large".to_string(),
+                ));
+            }
+            Ok(Cow::Owned(decoded))
+        }
+        Some(other) => Err(ValidationError::InvalidBody(format!(
+            "Unsupported Content-Encoding: {}",
+            other
+        ))),
+    }
+}
+
 /// Response payload for POST /data endpoint
 ///
 /// Returns two lists of batch IDs:
@@ -68,9 +240,14 @@ pub async fn handle_data(
         }
     };
 
-    let request: DataRequest = serde_json::from_slice(body_bytes).map_err(|e| {
-        crate::error::ValidationError::InvalidBody(format!("Failed to parse JSON: {}", e))
-    })?;
+    let content_encoding = event
+        .headers()
+        .get("content-encoding")
+        .and_then(|v| v.to_str().ok());
+    let body_bytes = decode_body(content_encoding, body_bytes)?;
+
+    // Row and columnar bodies both end up as a DataRequest
+    let request = parse_data_request(&body_bytes)?;
 
     // Step 3: Enforce batch size limit (100 readings max) after authentication
     if request.readings.len() > 100 {
@@ -298,4 +475,134 @@ mod tests {
         assert_eq!(request.readings[0].sensors.ds18b20_temp_c, None);
         assert_eq!(request.readings[0].friendly_name, None);
     }
+
+    fn columnar_body(mask: &str, bme280: &str) -> String {
+        format!(
+            r#"{{
+                "schema": "columnar-v1",
+                "device_id": "dev-1",
+                "hardware_id": "AA:BB:CC:DD:EE:FF",
+                "boot_id": "550e8400-e29b-41d4-a716-446655440000",
+                "firmware_version": "1.0.16",
+                "count": 2,
+                "batch_id": ["batch1", "batch2"],
+                "seq": [1, 2],
+                "timestamp_ms": [1704067800000, 1704067860000],
+                "sample_count": [20, 20],
+                "sensor_mask": {},
+                "bme280_temp_c": {},
+                "ds18b20_temp_c": [0, 21.8],
+                "humidity_pct": [45.2, 45.3],
+                "pressure_hpa": [0, 0],
+                "soil_moisture_pct": [0, 0],
+                "health": {{"uptime_ms": 1000}}
+            }}"#,
+            mask, bme280
+        )
+    }
+
+    #[test]
+    fn test_columnar_request_expands_to_readings() {
+        let body = columnar_body("[5, 7]", "[22.5, 22.6]");
+        let request = parse_data_request(body.as_bytes()).unwrap();
+
+        assert_eq!(request.readings.len(), 2);
+        let first = &request.readings[0];
+        assert_eq!(first.batch_id, "batch1");
+        assert_eq!(first.hardware_id, "AA:BB:CC:DD:EE:FF");
+        assert_eq!(first.timestamp_ms, 1704067800000);
+        assert_eq!(first.firmware_version, "1.0.16");
+        assert_eq!(first.friendly_name, None);
+        assert_eq!(first.sensors.bme280_temp_c, Some(22.5));
+        assert_eq!(first.sensors.ds18b20_temp_c, None);
+        assert_eq!(first.sensors.humidity_pct, Some(45.2));
+        assert_eq!(first.sensors.pressure_hpa, None);
+        assert_eq!(first.sensor_status.bme280, "ok");
+        assert_eq!(first.sensor_status.ds18b20, "unavailable");
+        assert_eq!(first.sensor_status.soil_moisture, "unavailable");
+
+        let second = &request.readings[1];
+        assert_eq!(second.batch_id, "batch2");
+        assert_eq!(second.sensors.ds18b20_temp_c, Some(21.8));
+        assert_eq!(second.sensor_status.ds18b20, "ok");
+    }
+
+    #[test]
+    fn test_columnar_request_rejects_short_column() {
+        let body = columnar_body("[5, 7]", "[22.5]");
+        let result = parse_data_request(body.as_bytes());
+
+        match result {
+            Err(ValidationError::InvalidBody(msg)) => assert!(msg.contains("bme280_temp_c")),
+            other => panic!("expected InvalidBody, got {:?}", other),
+        }
+    }
+
+    #[test]
+    fn test_unknown_schema_is_rejected() {
+        let body = r#"{"schema": "columnar-v9", "readings": []}"#;
+        let result = parse_data_request(body.as_bytes());
+
+        match result {
+            Err(ValidationError::InvalidBody(msg)) => assert!(msg.contains("columnar-v9")),
+            other => panic!("expected InvalidBody, got {:?}", other),
+        }
+    }
+
+    #[test]
+    fn test_row_request_without_schema_still_parses() {
+        let body = r#"{
+            "readings": [
+                {
+                    "batch_id": "batch1",
+                    "hardware_id": "AA:BB:CC:DD:EE:FF",
+                    "timestamp_ms": 1704067800000,
+                    "boot_id": "550e8400-e29b-41d4-a716-446655440000",
+                    "firmware_version": "1.0.16",
+                    "sensors": {},
+                    "sensor_status": {
+                        "bme280": "ok",
+                        "ds18b20": "ok",
+                        "soil_moisture": "ok"
+                    }
+                }
+            ]
+        }"#;
+
+        let request = parse_data_request(body.as_bytes()).unwrap();
+        assert_eq!(request.readings.len(), 1);
+        assert_eq!(request.readings[0].batch_id, "batch1");
+    }
+
+    #[test]
+    fn test_gzip_body_is_decoded() {
+        use flate2::write::GzEncoder;
+        use flate2::Compression;
+        use std::io::Write;
+
+        let body = br#"{"readings": []}"#;
+        let mut encoder = GzEncoder::new(Vec::new(), Compression::default());
+        encoder.write_all(body).unwrap();
+        let compressed = encoder.finish().unwrap();
+
+        let decoded = decode_body(Some("gzip"), &compressed).unwrap();
+        assert_eq!(&decoded[..], &body[..]);
+        assert!(parse_data_request(&decoded).unwrap().readings.is_empty());
+    }
+
+    #[test]
+    fn test_identity_body_is_borrowed() {
+        let body = b"{}";
+        assert!(matches!(decode_body(None, body).unwrap(), Cow::Borrowed(_)));
+        assert!(matches!(
+            decode_body(Some("identity"), body).unwrap(),
+            Cow::Borrowed(_)
+        ));
+    }
+
+    #[test]
+    fn test_bad_encodings_are_rejected() {
+        assert!(decode_body(Some("gzip"), b"not gzip").is_err());
+        assert!(decode_body(Some("br"), b"{}").is_err());
+    }
 }
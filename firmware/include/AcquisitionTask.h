@@ -0,0 +1,127 @@
+#ifndef ACQUISITION_TASK_H
+#define ACQUISITION_TASK_H
+
+#include <cstdint>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+#include "SensorManager.h"
+#include "SpscRing.h"
+#include "models/SensorReadings.h"
+
+/**
+ * AcquisitionTask runs sensor sampling in a dedicated FreeRTOS task with a
+ * fixed period (vTaskDelayUntil), decoupled from networking and rendering
+ * in loop(). Completed SensorReadings are published through a lock-free
+ * single-producer/single-consumer ring (SpscRing), and a task notification wakes
+ * loop() when it is waiting. When the consumer falls behind the new reading is
+ * dropped and counted: only the consumer may move the ring's tail, and at one
+ * reading per period a full queue means loop() has stalled for QUEUE_LENGTH periods.
+ *
+ * The task also brings the sensors up (SensorManager::initialize()) before its
+ * first reading, so bus probing and init retries overlap display init and the
+ * WiFi association in setup() instead of running ahead of them.
+ */
+class AcquisitionTask {
+   public:
+    static constexpr uint8_t QUEUE_LENGTH = 8;
+    static constexpr uint32_t STACK_SIZE = 4096;
+    static constexpr uint8_t TASK_PRIORITY = 3;  // Above loop() (1) and networking
+    static constexpr int8_t TASK_CORE = 1;       // APP_CPU, away from the WiFi stack
+
+    explicit AcquisitionTask(SensorManager& sensorManager);
+    ~AcquisitionTask();
+
+    /**
+     * Start the acquisition task. Configure the SensorManager
+     * first: the task initializes it before the first reading.
+     * @param periodMs Initial sampling period in milliseconds
+     * @param warmStart Passed to SensorManager::initialize() (deep-sleep wake)
+     * @return true if the task was created
+     */
+    bool start(uint32_t periodMs, bool warmStart = false);
+
+    /**
+     * Block until the task has initialized the sensors.
+     * @param timeoutMs Longest wait
+     * @return false on timeout (or if the task is not running)
+     */
+    bool waitForSensors(uint32_t timeoutMs);
+
+    /**
+     * @return How long SensorManager::initialize() took in the task (0 until done)
+     */
+    uint32_t getSensorInitMs() const { return sensorInitMs; }
+
+    /**
+     * Stop the task and discard queued readings.
+     */
+    void stop();
+
+    /**
+     * Change the sampling period; takes effect after the current period.
+     * @param periodMs Sampling period in milliseconds
+     */
+    void setPeriodMs(uint32_t periodMs);
+
+    /**
+     * @return Current sampling period in milliseconds
+     */
+    uint32_t getPeriodMs() const { return periodMs; }
+
+    /**
+     * Take the next completed reading without blocking.
+     * @param out Receives the reading
+     * @return true if a reading was available
+     */
+    bool receive(SensorReadings& out);
+
+    /**
+     * Block until a reading is queued (it stays queued for receive()) or the time runs
+     * out; loop() idles here so a reading is taken as soon as it is published. Call it
+     * from the task that calls receive(): that task is the one notified.
+     * @param timeoutMs Longest wait
+     * @return true if a reading is waiting
+     */
+    bool waitForReading(uint32_t timeoutMs);
+
+    /**
+     * @return Readings dropped because the queue was full
+     */
+    uint32_t getDroppedCount() const { return droppedCount; }
+
+    /**
+     * @return Time spent in SensorManager::readSensors() since start (energy accounting)
+     */
+    uint32_t getBusyMs() const { return busyMs; }
+
+    /**
+     * @return true if the task is running
+     */
+    bool isRunning() const;
+
+   private:
+    SensorManager& sensors;
+    volatile uint32_t periodMs;
+    volatile uint32_t droppedCount;
+    volatile uint32_t busyMs;
+    volatile bool sensorsReady;
+    volatile uint32_t sensorInitMs;
+    bool warmStart;
+
+#ifdef ARDUINO
+    StaticSpscRing<SensorReadings, QUEUE_LENGTH> queue;
+    TaskHandle_t taskHandle;
+    TaskHandle_t volatile consumerHandle;  // Notified on publish (set by waitForReading())
+
+    static void taskEntry(void* arg);
+    void run();
+#endif
+};
+
+#endif  // ACQUISITION_TASK_H
@@ -0,0 +1,78 @@
+#ifndef ADAPTIVE_SAMPLER_H
+#define ADAPTIVE_SAMPLER_H
+
+#include <stdint.h>
+
+#include "BatteryMonitor.h"
+#include "models/SensorReadings.h"
+
+#define ADAPTIVE_MIN_INTERVAL_MS 2000  // Never sample faster than this
+#define ADAPTIVE_SPEEDUP 4             // Event interval = base / 4 (battery normal)
+#define ADAPTIVE_LOW_SPEEDUP 2         // Event interval = base / 2 (battery low; none critical)
+#define ADAPTIVE_MAX_SLOW_STEPS 2      // Flat signals double the interval up to 4x base
+#define ADAPTIVE_QUIET_READINGS 3      // Flat readings before each doubling
+
+// Rates of change that count as an event (activity 1.0)
+#define ADAPTIVE_SOIL_FAST_PER_MIN 1.0f  // Soil moisture %/min (irrigation)
+#define ADAPTIVE_TEMP_FAST_PER_MIN 0.5f  // C/min (door opened, heater)
+
+#define ADAPTIVE_QUIET_ACTIVITY 0.2f  // Below this a reading counts as flat
+#define ADAPTIVE_ACTIVITY_DECAY 0.5f  // Activity fades by this per reading after an event
+
+/**
+ * AdaptiveSampler paces sensor readings by how fast the signals move. Each fresh soil
+ * moisture and temperature value is turned into a rate of change, normalized so that
+ * 1.0 is an event (ADAPTIVE_*_FAST_PER_MIN); the peak is held and fades per reading.
+ * An event drops the interval to base / ADAPTIVE_SPEEDUP at once; flat readings step it
+ * back up to the base and then, when slowing down is allowed (battery mode), double it
+ * every ADAPTIVE_QUIET_READINGS up to 2^ADAPTIVE_MAX_SLOW_STEPS times the base.
+ *
+ * The base is the battery-derived interval (PowerManager::getAdaptiveReadingInterval()),
+ * and the battery level limits the speed-up, so events never cost more than the
+ * battery allows.
+ */
+class AdaptiveSampler {
+   public:
+    AdaptiveSampler();
+
+    /**
+     * Fold in a reading (stale and unavailable values are skipped)
+     * @param readings Reading just taken by the acquisition task
+     */
+    void addReading(const SensorReadings& readings);
+
+    /**
+     * @param baseMs Battery-derived reading interval
+     * @param level Battery level (limits the speed-up)
+     * @param slowWhenFlat Stretch the interval past the base on flat signals
+     * @return Interval until the next reading
+     */
+    uint32_t getIntervalMs(uint32_t baseMs, BatteryLevel level, bool slowWhenFlat) const;
+
+    // Normalized rate of change (1.0 = event)
+    float getActivity() const { return activity; }
+
+    // -1 = event pace, 0 = base, >0 = doublings for flat signals
+    int8_t getPaceStep() const { return paceStep; }
+
+    void reset();
+
+   private:
+    enum Signal : uint8_t { SIGNAL_SOIL, SIGNAL_BME280_TEMP, SIGNAL_DS18B20_TEMP, NUM_SIGNALS };
+
+    struct Track {
+        float value;
+        uint32_t timeMs;
+        bool valid;
+    };
+
+    Track tracks[NUM_SIGNALS];
+    float activity;
+    int8_t paceStep;
+    uint8_t quietReadings;
+
+    // Normalized rate for one fresh value (0 for the first value of a signal)
+    float rateOf(Signal signal, float value, uint32_t timeMs, float fastPerMin);
+};
+
+#endif  // ADAPTIVE_SAMPLER_H
@@ -0,0 +1,50 @@
+#ifndef BATTERY_MONITOR_H
+#define BATTERY_MONITOR_H
+
+#include <stdint.h>
+
+// Li-ion thresholds and range (volts)
+#define BATTERY_LOW_VOLTAGE 3.3f
+#define BATTERY_CRITICAL_VOLTAGE 3.0f
+#define BATTERY_FULL_VOLTAGE 4.2f
+#define BATTERY_EMPTY_VOLTAGE 3.0f
+
+#define BATTERY_LEVEL_HYSTERESIS 0.05f  // Volts above a threshold before its level clears
+#define BATTERY_FILTER_ALPHA 0.2f       // Weight of each new sample in the low-pass filter
+
+/**
+ * Charge level bands, with BATTERY_LEVEL_HYSTERESIS between them
+ */
+enum class BatteryLevel : uint8_t { NORMAL, LOW_CHARGE, CRITICAL };
+
+/**
+ * BatteryMonitor turns calibrated battery voltage samples into a stable estimate: an
+ * exponential low-pass filter over the samples, and charge levels that only clear once
+ * the voltage is BATTERY_LEVEL_HYSTERESIS above their threshold, so a voltage sitting
+ * on a threshold does not flap between levels (and reading intervals). The first
+ * sample seeds the filter.
+ */
+class BatteryMonitor {
+   public:
+    BatteryMonitor();
+
+    /**
+     * Fold in a new sample
+     * @param volts Calibrated battery voltage (after the divider correction)
+     */
+    void addSample(float volts);
+
+    bool hasSample() const { return seeded; }
+    float getVoltage() const { return filtered; }
+    BatteryLevel getLevel() const { return level; }
+
+    // Linear charge estimate between BATTERY_EMPTY_VOLTAGE and BATTERY_FULL_VOLTAGE
+    uint8_t getPercent() const;
+
+   private:
+    float filtered;
+    bool seeded;
+    BatteryLevel level;
+};
+
+#endif  // BATTERY_MONITOR_H
@@ -8,8 +8,13 @@
 typedef std::string String;
 #endif
 
+#include "TextBuffer.h"
+
 class BootId {
    public:
+    // Characters in a UUID: 8-4-4-4-12 hex digits and four hyphens
+    static constexpr size_t UUID_LENGTH = 36;
+
     // Generate a new UUID v4 boot ID
     static String generate();
 
@@ -17,8 +22,8 @@ class BootId {
     static bool isValidUuid(const String& uuid);
 
    private:
-    // Generate random hex string of specified length
-    static String randomHex(int length);
+    // Append length random uppercase hex digits
+    static void appendRandomHex(TextBuffer<UUID_LENGTH + 1>& text, int length);
 };
 
 #endif  // BOOT_ID_H
@@ -0,0 +1,58 @@
+#ifndef BOOT_PROFILER_H
+#define BOOT_PROFILER_H
+
+#include <stdint.h>
+
+#include "models/BootProfile.h"
+
+/**
+ * BootProfiler times setup() phase by phase. The current and the previous boot's
+ * profiles live in RTC slow memory (RTC_DATA_ATTR), so after a deep-sleep wake the last
+ * cycle is still there to compare against; both are lost on power loss.
+ *
+ * Phases finish out of order: WiFi and NTP complete in loop() after setup() returns. A
+ * phase timed in several pieces (NVS is opened for config and again for state) adds
+ * them up. A phase that is never started (e.g. touch detection on a glance wake) stays
+ * out of BootProfile::doneMask.
+ */
+class BootProfiler {
+   public:
+    /**
+     * Start a new boot: the last boot's profile becomes previous()
+     * @param nowMs millis() at setup() entry
+     */
+    static void beginBoot(uint32_t nowMs);
+
+    static void start(BootPhase phase, uint32_t nowMs);
+
+    /**
+     * Add the time since start() to the phase (ignored unless it is running)
+     * @return true if the time was recorded
+     */
+    static bool finish(BootPhase phase, uint32_t nowMs);
+
+    // Record a phase timed elsewhere (e.g. sensor init in the acquisition task)
+    static void record(BootPhase phase, uint32_t durationMs);
+
+    // Started and not finished since
+    static bool isStarted(BootPhase phase);
+
+    // Finished at least once this boot
+    static bool isFinished(BootPhase phase);
+
+    // setup() returned
+    static void endSetup(uint32_t nowMs);
+
+    static const BootProfile& current();
+
+    /**
+     * @return The previous boot's profile; false if there was none (first boot after
+     *         power-on)
+     */
+    static bool previous(BootProfile& out);
+
+    // Payload key for a phase ("config_file", "nvs", ...)
+    static const char* phaseKey(BootPhase phase);
+};
+
+#endif  // BOOT_PROFILER_H
@@ -39,8 +39,29 @@ struct ConfigFileData {
     String friendlyName;          // default: "ESP32-Sensor-{hardware_id}"
     uint8_t displayBrightness;    // default: 128 (0-255)
     uint32_t dataUploadInterval;  // default: 60 seconds
+    bool alignWindows;            // default: true (windows on wall-clock multiples)
+    bool eventUplink;             // default: true (soil alerts sent at once)
     uint32_t sensorReadInterval;  // default: 10 seconds
     bool enableDeepSleep;         // default: false
+    String bme280Profile;         // default: "weather" ("weather", "precision", "default")
+    String payloadFormat;         // default: "rows" ("rows", "columnar", "cbor")
+    String staticIp;              // default: "" (DHCP)
+    String staticGateway;         // default: ""
+    String staticSubnet;          // default: "" (255.255.255.0)
+    String staticDns;             // default: "" (gateway)
+    String transport;             // default: "http" ("http", "mqtt")
+    String mqttUrl;               // default: ""
+    String mqttTopic;             // default: "" (sensors/<device_id>/readings)
+    String uplinkPolicy;          // default: "every_window" ("every_n", "interval", "adaptive")
+    uint8_t uplinkWindows;        // default: 4
+    uint32_t uplinkInterval;      // default: 900 seconds
+    uint32_t metricsInterval;     // default: 3600 seconds (0 = every upload)
+    uint32_t ntpMaxAge;           // default: 21600 seconds (0 = re-sync every wake)
+    float deadbandTemp;           // default: 0 (C, report any change)
+    float deadbandHumidity;       // default: 0 (%)
+    float deadbandPressure;       // default: 0 (hPa)
+    float deadbandSoil;           // default: 0 (%)
+    uint8_t deadbandHeartbeat;    // default: 12 windows
 };
 
 class ConfigFileManager {
@@ -73,8 +94,8 @@ class ConfigFileManager {
     String lastError;
     bool fsInitialized;
 
-    // CRC32 checksum calculation
-    String calculateChecksum(const String& jsonContent);
+    // CRC32 checksum as stored in the file (8 uppercase hex digits)
+    String formatChecksum(uint32_t crc);
 
     // Field validation helpers
     bool validateStringLength(const String& str, uint16_t maxLen);
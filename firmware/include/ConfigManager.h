@@ -12,12 +12,38 @@
 #endif
 
 #include "ConfigFileManager.h"
+#include "ConfigSnapshot.h"
+#include "SerialCommandReader.h"
 #include "TouchDetector.h"
+#include "models/Bme280Profile.h"
 #include "models/Config.h"
+#include "models/PayloadFormat.h"
+#include "models/UplinkPolicy.h"
+#include "models/UploadTransport.h"
 
 // Callback type for registration command
 typedef std::function<void()> RegistrationCallback;
 
+/**
+ * Value the console is waiting for during an interactive edit (config commands ask for
+ * their values one line at a time)
+ */
+enum class ConfigPrompt : uint8_t {
+    NONE,
+    WIFI_SSID,
+    WIFI_PASSWORD,
+    API_ENDPOINT,
+    API_TOKEN,
+    READING_INTERVAL,
+    PUBLISH_INTERVAL,
+    PAGE_CYCLE_INTERVAL,
+    SOIL_DRY_READY,  // "press Enter" with the sensor in dry soil
+    SOIL_DRY_ADC,
+    SOIL_WET_READY,
+    SOIL_WET_ADC,
+    DEVICE_ID
+};
+
 class ConfigManager {
    public:
     ConfigManager();
@@ -25,7 +51,24 @@ class ConfigManager {
 
     void initialize();
     bool loadConfig();
+    /**
+     * Validate and schedule a save. Saves requested in quick succession are written once,
+     * CONFIG_SAVE_DEBOUNCE_MS after the last one, and only keys that changed reach NVS
+     * @return false if the configuration is invalid
+     */
     bool saveConfig();
+
+    // Write a scheduled save once it has settled and publish a deferred snapshot; call
+    // every loop
+    void processPendingSave();
+
+    /**
+     * Write a scheduled save now (before a restart or deep sleep)
+     * @return true if nothing was pending or the write succeeded
+     */
+    bool flushPendingSave();
+
+    bool isSavePending() const { return savePending; }
     void setDefaults();
     bool validateConfig();
 
@@ -38,10 +81,36 @@ class ConfigManager {
     // New: Get list of missing required fields
     String getMissingRequiredFields();
 
-    void handleSerialConfig();
+    /**
+     * Add the config commands to the console and route prompt answers and provisioning
+     * input through its line filter
+     * @param reader Console reader polled from loop()
+     */
+    void registerSerialCommands(SerialCommandReader& reader);
 
     Config& getConfig();
 
+    /**
+     * Hold the published read-only view with derived endpoint fields (any task). The
+     * loop task never rebuilds a held snapshot, so its Strings stay valid until
+     * releaseSnapshot(); a change published meanwhile goes to the other copy.
+     * @return Snapshot as of the last publishSnapshot()
+     */
+    const ConfigSnapshot& acquireSnapshot();
+    void releaseSnapshot(const ConfigSnapshot& held);
+
+    /**
+     * Rebuild the snapshot from the live configuration after a change and publish it.
+     * Loop task only (the task that edits Config). While the spare copy is still held
+     * the rebuild waits; processPendingSave() retries it every loop.
+     */
+    void publishSnapshot();
+
+    /**
+     * @return Counter bumped by every configuration change (load, edit, defaults, save)
+     */
+    uint32_t getConfigVersion() const { return configVersion; }
+
     // Public for testing
     String sanitizeSensitiveData(const String& data);
 
@@ -64,11 +133,19 @@ class ConfigManager {
 
     // Provisioning mode methods
     void enterProvisioningMode();
-    void handleProvisioningSerialInput();
     bool isInProvisioningMode() const;
 
    private:
     Config config;
+    uint32_t configVersion;  // Starts at 1, so the empty snapshot (version 0) is stale
+
+    // Two copies: readers hold the published one while the loop task rebuilds the other
+    ConfigSnapshot snapshots[2];
+    uint8_t publishedSnapshot;  // Index acquireSnapshot() hands out
+    uint8_t snapshotHolds[2];   // Outstanding acquisitions per copy
+#ifdef ARDUINO
+    portMUX_TYPE snapshotMux;  // Guards publishedSnapshot and snapshotHolds across cores
+#endif
 #ifdef ARDUINO
     Preferences nvs;
 #endif
@@ -92,12 +169,43 @@ class ConfigManager {
     String provisioningWifiPassword;
     String provisioningBackendUrl;
 
+    // Interactive edit in progress
+    ConfigPrompt prompt;
+
+    // Coalesced saves: values last written to NVS, to write only the keys that changed
+    Config persisted;
+    bool persistedValid;  // persisted matches NVS (false until loaded from or written to it)
+    bool savePending;
+    uint32_t saveRequestedMs;
+
+    // dev.confirm_id as last read or written
+    String confirmationIdCache;
+    bool confirmationIdLoaded;
+
+    // Write changed keys to NVS with one commit, then the config file
+    bool writeConfig();
+
+    // Publish a new snapshot after changing config
+    void markConfigChanged() {
+        configVersion++;
+        publishSnapshot();
+    }
+
     // Helper to convert ConfigFileData to Config
     void applyConfigFileData(const ConfigFileData& fileData);
 
     // Migrate NVS config to file
     void migrateNvsToFile();
 
+    /**
+     * Take a console line meant for the config manager before the command table sees it
+     * @return true if the line answered a prompt or was provisioning input
+     */
+    bool filterSerialLine(const char* line);
+    void handlePromptLine(const String& value);
+    void handleProvisioningCommand(const String& command);
+    void handleSaveCommand();
+
     void printConfigMenu();
     void printCurrentConfig();
     void updateWiFiCredentials();
@@ -112,4 +220,21 @@ class ConfigManager {
     bool validateCalibration();
 };
 
+// Holds ConfigManager's published snapshot for the lifetime of the object
+class SnapshotHold {
+   public:
+    explicit SnapshotHold(ConfigManager& manager)
+        : manager(manager), snapshot(manager.acquireSnapshot()) {}
+    ~SnapshotHold() { manager.releaseSnapshot(snapshot); }
+    SnapshotHold(const SnapshotHold&) = delete;
+    SnapshotHold& operator=(const SnapshotHold&) = delete;
+
+    const ConfigSnapshot& get() const { return snapshot; }
+    const Config& getConfig() const { return snapshot.getConfig(); }
+
+   private:
+    ConfigManager& manager;
+    const ConfigSnapshot& snapshot;
+};
+
 #endif  // CONFIG_MANAGER_H
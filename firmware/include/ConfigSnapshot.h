@@ -0,0 +1,93 @@
+#ifndef CONFIG_SNAPSHOT_H
+#define CONFIG_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "models/Config.h"
+
+/**
+ * ConfigSnapshot is a read-only copy of the configuration plus everything the upload and
+ * registration paths derive from it: endpoint scheme, host, port and path, the fallback
+ * http:// URL, the Authorization header, the registration URL and the MQTT broker and
+ * topic. ConfigManager rebuilds
+ * it on the loop task only when its change counter moves and hands it out by reference,
+ * so no request copies Config's Strings or re-parses the endpoint. A published snapshot
+ * is never modified; the next change is built into a second copy.
+ */
+class ConfigSnapshot {
+   public:
+    ConfigSnapshot();
+
+    /**
+     * Copy the configuration and derive the endpoint fields
+     * @param source Live configuration
+     * @param changeCount ConfigManager change counter the copy belongs to
+     */
+    void rebuild(const Config& source, uint32_t changeCount);
+
+    const Config& getConfig() const { return config; }
+    uint32_t getVersion() const { return version; }
+
+    // The API endpoint has a scheme and a host
+    bool hasEndpoint() const { return host.length() > 0; }
+    bool isHttps() const { return https; }
+    const String& getHost() const { return host; }
+
+    /**
+     * @param secure Port for HTTPS (the endpoint's) or for the plain HTTP fallback
+     * @return The explicit port, or the scheme default
+     */
+    uint16_t getPort(bool secure) const;
+
+    const String& getPath() const { return path; }  // At least "/"
+
+    // The endpoint with http:// in place of https:// (for allowHttpFallback)
+    const String& getInsecureEndpoint() const { return insecureEndpoint; }
+
+    // "Bearer <token>", empty without a token
+    const String& getAuthHeader() const { return authHeader; }
+
+    // Last path segment of the endpoint replaced with "register"
+    const String& getRegistrationUrl() const { return registrationUrl; }
+
+    // Broker of Config::mqttUrl (empty host if the URL has no valid host and port)
+    const String& getMqttHost() const { return mqttHost; }
+    uint16_t getMqttPort() const { return mqttPort; }  // Explicit, or 8883/1883
+    bool isMqttTls() const { return mqttTls; }          // mqtts://
+
+    // Config::mqttTopic, or sensors/<deviceId>/readings when it is empty
+    const String& getMqttTopic() const { return mqttTopic; }
+
+    /**
+     * Derive the registration URL: strip trailing slashes, the query and the fragment,
+     * then replace the last path segment with "register" (or append "/register")
+     * @param endpoint Data endpoint URL
+     */
+    static String deriveRegistrationUrl(const char* endpoint);
+
+   private:
+    Config config;
+    uint32_t version;
+    bool https;
+    String host;
+    uint16_t explicitPort;  // 0 = scheme default
+    String path;
+    String insecureEndpoint;
+    String authHeader;
+    String registrationUrl;
+    String mqttHost;
+    uint16_t mqttPort;
+    bool mqttTls;
+    String mqttTopic;
+
+    /**
+     * Split scheme://[user@]host[:port][/path]
+     * @param port Receives the explicit port (0 if none)
+     * @return Start of the path, or nullptr if there is none
+     */
+    static const char* parseAuthority(const char* url, String& host, uint16_t& port);
+    static String copyRange(const char* begin, size_t length);
+};
+
+#endif  // CONFIG_SNAPSHOT_H
@@ -0,0 +1,95 @@
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <esp_rom_crc.h>
+#endif
+
+#define CRC32_HEX_LENGTH 8  // Digits written by crc32ToHex()
+
+#ifndef ARDUINO
+namespace crc32_detail {
+
+// Slicing-by-8 tables (reflected polynomial 0xEDB88320), built at compile time
+struct SliceTable {
+    uint32_t entries[8][256];
+
+    constexpr SliceTable() : entries() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t crc = i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+            }
+            entries[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; i++) {
+            for (int slice = 1; slice < 8; slice++) {
+                uint32_t previous = entries[slice - 1][i];
+                entries[slice][i] = (previous >> 8) ^ entries[0][previous & 0xFF];
+            }
+        }
+    }
+};
+
+inline constexpr SliceTable SLICE_TABLE{};
+
+inline uint32_t loadLe32(const uint8_t* bytes) {
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+}  // namespace crc32_detail
+#endif
+
+/**
+ * CRC-32 (IEEE 802.3, as used by gzip and zlib). Integrity checks for the config file, the
+ * RTC state image, the gzip trailer and the display change keys all go through here.
+ *
+ * On the ESP32 this is the mask ROM's table-driven esp_rom_crc32_le(), which costs no
+ * flash; host builds use slicing-by-8. Both give the same result as the zlib crc32().
+ * @param data Bytes to add
+ * @param length Number of bytes
+ * @param previous Result of the previous call to continue a running CRC (0 to start)
+ * @return CRC of everything passed so far
+ */
+inline uint32_t crc32Update(const void* data, size_t length, uint32_t previous = 0) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+#ifdef ARDUINO
+    return esp_rom_crc32_le(previous, bytes, length);
+#else
+    const uint32_t(&table)[8][256] = crc32_detail::SLICE_TABLE.entries;
+    uint32_t crc = previous ^ 0xFFFFFFFF;
+    while (length >= 8) {
+        uint32_t low = crc ^ crc32_detail::loadLe32(bytes);
+        uint32_t high = crc32_detail::loadLe32(bytes + 4);
+        crc = table[7][low & 0xFF] ^ table[6][(low >> 8) & 0xFF] ^ table[5][(low >> 16) & 0xFF] ^
+              table[4][low >> 24] ^ table[3][high & 0xFF] ^ table[2][(high >> 8) & 0xFF] ^
+              table[1][(high >> 16) & 0xFF] ^ table[0][high >> 24];
+        bytes += 8;
+        length -= 8;
+    }
+    while (length > 0) {
+        crc = table[0][(crc ^ *bytes++) & 0xFF] ^ (crc >> 8);
+        length--;
+    }
+    return crc ^ 0xFFFFFFFF;
+#endif
+}
+
+/**
+ * Write a CRC as 8 uppercase hex digits (the config file's checksum format)
+ * @param crc Value to format
+ * @param out Receives CRC32_HEX_LENGTH digits and a terminator
+ */
+inline void crc32ToHex(uint32_t crc, char out[CRC32_HEX_LENGTH + 1]) {
+    static const char DIGITS[] = "0123456789ABCDEF";
+    for (int i = CRC32_HEX_LENGTH - 1; i >= 0; i--) {
+        out[i] = DIGITS[crc & 0x0F];
+        crc >>= 4;
+    }
+    out[CRC32_HEX_LENGTH] = '\0';
+}
+
+#endif  // CRC32_H
@@ -3,32 +3,139 @@
 
 #include <stdint.h>
 
+#include "RingExtrema.h"
+#include "RunningStats.h"
+#include "SpscRing.h"
 #include "models/AveragedData.h"
+#include "models/BufferedBatch.h"
+#include "models/DataSnapshot.h"
+#include "models/DisplayBucket.h"
 #include "models/DisplayPoint.h"
+#include "models/DisplaySeries.h"
+#include "models/PackedAveragedData.h"
 #include "models/SensorReadings.h"
 #include "models/SensorType.h"
 
-// Compile-time constant for maximum publish samples
-#define MAX_PUBLISH_SAMPLES 120
+// Compile-time constant for maximum publish samples (readings are folded into running
+// aggregates, so this no longer sizes a buffer; it only bounds the sample counters)
+#define MAX_PUBLISH_SAMPLES 3600
 
-// Compile-time constant for transmission ring buffer size
+// Default transmission ring size, held in internal DRAM (configureBuffers() can grow it)
 #define MAX_DATA_BUFFER_SIZE 50
 
-// Compile-time constant for display buffer size (240 points = 4 hours at 1-minute intervals)
+// Default display buffer size (240 points = 4 hours at 1-minute intervals), internal DRAM
 #define MAX_DISPLAY_POINTS 240
 
+// Upper bounds for rings allocated from PSRAM at boot (2000 windows ~ 200 KB,
+// 2880 points = 48 hours at 1-minute intervals ~ 92 KB)
+#define PSRAM_DATA_BUFFER_SIZE 2000
+#define PSRAM_DISPLAY_POINTS 2880
+
+// Coarse display tiers (96 x 15 minutes = 24 hours, 168 x 1 hour = 7 days)
+#define DISPLAY_QUARTER_HOUR_POINTS 96
+#define DISPLAY_HOUR_POINTS 168
+
+// Maximum points returned by a downsampled display query
+#define MAX_GRAPH_POINTS 120
+
+/**
+ * Receives a window evicted from the full transmission ring (e.g. to spill it to flash)
+ * @return true if the window was kept; false counts it as a buffer overflow
+ */
+typedef bool (*OverflowSink)(const PackedAveragedData& record, void* context);
+
 /**
  * DataManager handles three types of data buffers:
- * 1. Averaging Buffer: Fixed-size array for accumulating sensor readings
- * 2. Data Buffer: Ring buffer for transmission queue (Task 10)
- * 3. Display Buffer: Ring buffer for graph history (Task 11)
+ * 1. Averaging Buffer: Streaming per-field aggregates for the current publish window
+ * 2. Data Buffer: Ring buffer for transmission queue (Task 10), stored as PackedAveragedData
+ * 3. Display Buffer: Tiered ring buffers for graph history (Task 11)
+ *    (1-minute points for 4 h, 15-minute and 1-hour min/mean/max buckets for 24 h and 7 d),
+ *    stored as one shared timestamp column plus one value column per sensor
+ *
+ * Both rings are SpscRing instances; a display tier's ring runs over its timestamp
+ * column and the value columns are indexed by the same slots.
+ *
+ * The transmission ring and the 1-minute display tier default to internal arrays; on
+ * modules with PSRAM, configureBuffers() moves them to larger PSRAM allocations at boot.
+ * The averaging state and coarse tiers always stay in internal DRAM; the coarse buckets are
+ * 16-bit fixed point to keep them small.
+ *
+ * The coarse tiers are not saved across deep sleep: RtcStateStore keeps only the newest
+ * 1-minute points and the tiers are rebuilt from those. Their 24 h / 7 d history therefore
+ * fills on nodes that stay awake (mains power), not on battery nodes that sleep between
+ * readings.
  */
 class DataManager {
    public:
     DataManager();
+    ~DataManager();
+    DataManager(const DataManager&) = delete;
+    DataManager& operator=(const DataManager&) = delete;
+
+    /**
+     * Size the transmission ring and 1-minute display history (call before adding data)
+     * @param dataCapacity Buffered windows (clamped to MAX_DATA_BUFFER_SIZE..
+     *        PSRAM_DATA_BUFFER_SIZE); the default size uses the internal array
+     * @param displayPoints 1-minute history points (clamped to MAX_DISPLAY_POINTS..
+     *        PSRAM_DISPLAY_POINTS)
+     * @return false if data was already added or an allocation failed (that ring then
+     *         keeps its default size)
+     */
+    bool configureBuffers(uint16_t dataCapacity, uint16_t displayPoints);
+
+    /**
+     * Pick ring sizes that use about a quarter of the free PSRAM
+     * @param psramFreeBytes Free PSRAM (0 on modules without it)
+     * @param dataCapacity Receives the suggested transmission ring size
+     * @param displayPoints Receives the suggested 1-minute history size
+     */
+    static void recommendBufferSizes(size_t psramFreeBytes, uint16_t& dataCapacity,
+                                     uint16_t& displayPoints);
+
+    uint16_t getDataBufferCapacity() const { return dataRing.getCapacity(); }
+    uint16_t getDisplayCapacity() const { return displayRing.getCapacity(); }
 
     // Averaging Buffer operations (Task 9)
     void addReading(const SensorReadings& reading);
+
+    /**
+     * Fold soil samples taken outside addReading() (the ULP during deep sleep) into the
+     * current window. They count towards the publish interval, but never complete it:
+     * the window closes on the next full reading, which carries the other sensors.
+     * @param samples Soil moisture stats in %
+     * @param nowMs Window start if the window is still empty
+     */
+    void addSoilSamples(const RunningStats& samples, uint32_t nowMs);
+
+    /**
+     * Close windows on wall-clock multiples of windowMs (300000: every 5 minutes on the
+     * minute) once the clock is synced, instead of after publishIntervalSamples readings
+     * @param windowMs Window length (0 = count-based windows)
+     */
+    void setWindowAlignment(uint32_t windowMs);
+
+    /**
+     * Called with each reading before addReading() (no-op while alignment is off)
+     * @param monotonicMs The reading's monotonicMs
+     * @param epochMs Its epoch time (0 if not synced: the window stays count-based)
+     * @return true if the reading is past the open window's wall-clock end: publish that
+     *         window first, the reading starts the next one
+     */
+    bool closesAlignedWindow(uint32_t monotonicMs, uint64_t epochMs);
+
+    /**
+     * @param monotonicMs Time of the next reading
+     * @return true if that reading closes the open window
+     */
+    bool windowClosesAt(uint32_t monotonicMs) const;
+
+    /**
+     * @param epochMs Epoch time
+     * @param windowMs Window length (non-zero)
+     * @return Time to the next multiple of windowMs (windowMs if exactly on one)
+     */
+    static uint32_t msToWindowBoundary(uint64_t epochMs, uint32_t windowMs);
+
     bool shouldPublish();
     AveragedData calculateAverages();
     void clearAveragingBuffer();
@@ -36,16 +143,133 @@ class DataManager {
     // Transmission Ring Buffer operations (Task 10)
     void bufferForTransmission(const AveragedData& data);
     uint16_t getBufferedDataCount() const;
-    const AveragedData* getBufferedData(uint16_t& count) const;
+
+    /**
+     * Get a zero-copy view of the backlog as up to two contiguous ring segments
+     * @return Oldest-first view; both segments are empty when nothing is buffered
+     */
+    BufferedBatch getBufferedBatch() const;
+
+    /**
+     * Expand one buffered window to the wire-format struct
+     * @param index 0 = oldest buffered entry
+     * @param out Receives the expanded entry (batchId re-derived from the timestamps)
+     * @return false if index is out of range
+     */
+    bool getBufferedEntry(uint16_t index, AveragedData& out) const;
     void clearAcknowledgedData(const char* batchIds[], uint16_t batchIdCount);
+
+    /**
+     * Drop every buffered window with sequence <= the cumulative ack watermark
+     * @return Number of entries removed (only advances the tail; oldest entries go first)
+     */
+    uint16_t acknowledgeThrough(uint32_t sequence);
+
+    /**
+     * Drop buffered windows whose sequence lies in [firstSequence, lastSequence]
+     * @return Number of entries removed
+     */
+    uint16_t acknowledgeRange(uint32_t firstSequence, uint32_t lastSequence);
+
+    uint32_t getNextSequence() const { return nextSequence; }
     bool isBufferNearFull() const;  // Returns true if > 80% full (warning threshold)
 
+    /**
+     * Route windows evicted at the 90% threshold to a sink instead of discarding them
+     * @param sink Callback (nullptr restores discard-oldest)
+     * @param context Passed through to the sink
+     */
+    void setOverflowSink(OverflowSink sink, void* context);
+
+    /**
+     * Rotate both rings in place to start at index 0 and view them for persistence
+     * @param nowMs Current monotonic time (sets the snapshot's display clock)
+     * @return Contiguous oldest-first views; valid until data is added or removed
+     */
+    DataSnapshot snapshot(uint32_t nowMs);
+
+    /**
+     * Get writable views of the empty rings so a backend can restore into them directly
+     * @return Views and capacities; null pointers if the rings already hold data
+     */
+    DataRestoreTarget beginRestore();
+
+    /**
+     * Adopt the entries written through beginRestore(); the coarse display tiers are
+     * rebuilt from the restored 1-minute points
+     * @param recordCount Backlog windows written (oldest first; sequences kept)
+     * @param resumeSequence Sequence counter to continue from
+     * @param overflowCount Overflow counter to continue from
+     * @param displayCount 1-minute points written
+     * @param clockNowMs Display clock of the snapshot, advanced by any time spent asleep
+     * @param nowMs Current monotonic time (millis() restarts after deep sleep)
+     * @return false if the rings already hold data or a count exceeds its capacity
+     */
+    bool commitRestore(uint16_t recordCount, uint32_t resumeSequence, uint16_t overflowCount,
+                       uint16_t displayCount, uint32_t clockNowMs, uint32_t nowMs);
+
+    /**
+     * Convert a reading timestamp to the display clock (monotonic time plus the offset
+     * carried over a deep-sleep restore)
+     */
+    uint32_t displayClockMs(uint32_t monotonicMs) const {
+        return monotonicMs + displayClockOffsetMs;
+    }
+
     // Display Buffer operations (Task 11)
     void addToDisplayBuffer(const SensorReadings& reading);
     uint16_t getDisplayDataCount(SensorType type) const;
     const DisplayPoint* getDisplayData(SensorType type, uint16_t& count,
                                        uint16_t maxPoints = 0) const;
 
+    /**
+     * Get the display history covering a time span, from the finest tier that spans it
+     * @param type Sensor to query
+     * @param spanMs Time span ending at the newest point (0 = whole 1-minute tier)
+     * @param count Receives the number of points returned
+     * @param maxPoints Downsample to at most this many points with a min/max envelope
+     *        (0 = no limit, capped at MAX_GRAPH_POINTS); bounded results are cached until
+     *        the next display point arrives
+     * @return Oldest-first points (bucket means for coarse tiers), or nullptr when empty
+     */
+    const DisplayPoint* getDisplayHistory(SensorType type, uint32_t spanMs, uint16_t& count,
+                                          uint16_t maxPoints = 0) const;
+
+    /**
+     * Get the min/mean/max buckets of a tier, oldest first, including the open bucket
+     * @return Buckets, or nullptr when the tier is empty (MINUTE tier has no buckets)
+     */
+    const DisplayBucket* getDisplayBuckets(SensorType type, DisplayTier tier,
+                                           uint16_t& count) const;
+
+    /**
+     * Get a zero-copy (timestamps, values) view of a tier
+     * @return View over the closed points/buckets (bucket means for coarse tiers); the open
+     *         coarse bucket is only reported by getDisplayHistory()/getDisplayBuckets()
+     */
+    DisplaySeries getDisplaySeries(SensorType type, DisplayTier tier = DisplayTier::MINUTE) const;
+
+    /**
+     * Get the lowest and highest value over the same span getDisplayHistory() returns:
+     * the 1-minute tier from running extrema kept as points enter and leave the ring,
+     * coarse tiers from their bucket extremes, scanned once until the history changes
+     * @param spanMs Time span ending at the newest point (0 = whole 1-minute tier)
+     * @return false when the span holds no (non-NaN) value; coarse tiers report the
+     *         bucket extremes, so the range also covers peaks inside a bucket
+     */
+    bool getDisplayRange(SensorType type, uint32_t spanMs, float& minValue,
+                         float& maxValue) const;
+
+    DisplayTier selectDisplayTier(uint32_t spanMs) const;
+    uint32_t getDisplayTierSpanMs(DisplayTier tier) const;
+
+    // Batch ID derivation (shared by calculateAverages() and packed-record expansion)
+    static void formatBatchId(char* batchId, size_t bufferSize, const AveragedData& data);
+
+    // Conversion between the wire-format struct and the compact buffered record
+    static void packAveragedData(const AveragedData& data, PackedAveragedData& packed);
+    static void unpackAveragedData(const PackedAveragedData& packed, AveragedData& data);
+
     // Configuration
     void setPublishIntervalSamples(uint16_t samples);
     uint16_t getPublishIntervalSamples() const;
@@ -55,42 +279,125 @@ class DataManager {
     uint16_t getBufferOverflowCount() const;
 
    private:
-    // Fixed-size averaging buffer (no heap allocation)
-    SensorReadings averagingBuffer[MAX_PUBLISH_SAMPLES];
-    uint16_t averagingBufferCount;  // Current number of readings in buffer
+    // Streaming averaging window: O(1) per reading, no per-sample storage
+    RunningStats sensorStats[NUM_SENSORS];  // Indexed by SensorType
+    RunningStats ds18b20ProbeStats[MAX_DS18B20_PROBES];
+    uint32_t windowStartMs;         // monotonicMs of the first reading in the window
+    SensorReadings lastReading;     // Most recent reading (status, fallbacks, end timestamp)
+    uint16_t averagingBufferCount;  // Current number of readings in the window
     uint16_t
         publishIntervalSamples;  // Effective length from config (must be <= MAX_PUBLISH_SAMPLES)
+    uint32_t windowAlignMs;      // Wall-clock window length (0 = count-based)
+    uint32_t windowEndMs;        // monotonicMs of the open window's wall-clock end
+    bool windowEndKnown;         // windowEndMs is set: the window closes on time, not count
+
+    // Readings the open window takes before it stops accepting more
+    uint16_t sampleLimit() const;
 
-    // Fixed-size transmission ring buffer (no heap allocation)
-    AveragedData dataBuffer[MAX_DATA_BUFFER_SIZE];
-    uint16_t dataBufferHead;       // Index where next item will be written
-    uint16_t dataBufferTail;       // Index of oldest item
-    uint16_t dataBufferCount;      // Current number of items in buffer
+    // Transmission ring: internal array by default, or a boot-time PSRAM allocation
+    PackedAveragedData internalDataBuffer[MAX_DATA_BUFFER_SIZE];
+    SpscRing<PackedAveragedData> dataRing;
     uint16_t bufferOverflowCount;  // Counter for buffer overflow events
+    uint32_t nextSequence;         // Sequence number for the next averaged window
+    OverflowSink overflowSink;     // Optional destination for evicted windows
+    void* overflowSinkContext;
+
+    // 1-minute display buffer, structure of arrays: every sensor is sampled at the same
+    // instant, so the ring over the timestamp column indexes the value columns too.
+    // Columns point at the internal arrays by default, or into one boot-time PSRAM
+    // allocation
+    uint32_t internalDisplayTimestamps[MAX_DISPLAY_POINTS];
+    float internalDisplayValues[NUM_SENSORS][MAX_DISPLAY_POINTS];
+    DisplayPoint internalLinearBuffer[MAX_DISPLAY_POINTS];
+    SpscRing<uint32_t> displayRing;
+    float* displayValues[NUM_SENSORS];
+    void* externalDisplayStorage;  // PSRAM block backing the columns (nullptr if internal)
+    uint32_t lastDisplayUpdate;    // Timestamp of last display buffer update (ms)
+    bool hasDisplayPoint;        // Whether lastDisplayUpdate is valid
+    uint32_t displayClockOffsetMs;  // Added to reading times (non-zero after a restore)
+
+    // Running min/max of each 1-minute column; deque storage sits with the columns
+    uint16_t internalDisplayExtrema[NUM_SENSORS][2 * MAX_DISPLAY_POINTS];
+    RingExtrema displayExtrema[NUM_SENSORS];
 
-    // Fixed-size display buffer (no heap allocation) - 2D array [sensor][points]
-    DisplayPoint displayBuffer[NUM_SENSORS][MAX_DISPLAY_POINTS];
-    uint16_t displayBufferHead[NUM_SENSORS];   // Head index for each sensor's ring buffer
-    uint16_t displayBufferCount[NUM_SENSORS];  // Current count for each sensor
-    uint32_t lastDisplayUpdate;                // Timestamp of last display buffer update (ms)
+    // Coarse tiers share one set of columns; tier t occupies [coarseOffset(t), + capacity),
+    // and its ring runs over that part of the timestamp column
+    static constexpr uint8_t NUM_COARSE_TIERS = NUM_DISPLAY_TIERS - 1;
+    static constexpr uint16_t COARSE_SLOTS = DISPLAY_QUARTER_HOUR_POINTS + DISPLAY_HOUR_POINTS;
+    // Bucket values are fixed point like PackedAveragedData (toCoarse()/fromCoarse())
+    uint32_t coarseTimestamps[COARSE_SLOTS];
+    int16_t coarseMin[NUM_SENSORS][COARSE_SLOTS];
+    int16_t coarseMean[NUM_SENSORS][COARSE_SLOTS];
+    int16_t coarseMax[NUM_SENSORS][COARSE_SLOTS];
+    SpscRing<uint32_t> coarseRing[NUM_COARSE_TIERS];
+    RunningStats openBucket[NUM_COARSE_TIERS][NUM_SENSORS];  // Bucket still being filled
+    uint32_t openBucketStartMs[NUM_COARSE_TIERS];
 
     // Display buffer interval (1 minute = 60000 ms)
     static constexpr uint32_t DISPLAY_INTERVAL_MS = 60000;
+    static constexpr uint32_t QUARTER_HOUR_MS = 15UL * 60000UL;
+    static constexpr uint32_t HOUR_MS = 60UL * 60000UL;
+
+    // Scratch buffers for ordered display queries (linearBuffer holds getDisplayCapacity()
+    // points)
+    DisplayPoint* linearBuffer;
+    mutable DisplayBucket bucketBuffer[DISPLAY_HOUR_POINTS + 1];
+
+    // Per-sensor cache of the last bounded history query (max 120 points as per
+    // requirements). Rebuilt only after a new display point arrives, so repeated frames
+    // of the same graph are O(1)
+    struct HistoryCache {
+        DisplayPoint points[MAX_GRAPH_POINTS];
+        uint16_t count;
+        uint16_t maxPoints;
+        uint32_t spanMs;
+        uint32_t generation;  // displayGeneration the points were built from
+
+        // Coarse-tier range of the last getDisplayRange() (a few hundred buckets at
+        // most, so it is scanned once per change instead of kept in running extrema)
+        float rangeMin;
+        float rangeMax;
+        bool rangeFound;
+        uint32_t rangeSpanMs;
+        uint32_t rangeGeneration;
+    };
+    mutable HistoryCache historyCache[NUM_SENSORS];
+    uint32_t displayGeneration;  // Bumped whenever the display history changes
+
+    // Return both rings to their internal arrays, freeing any PSRAM allocation
+    void releaseExternalBuffers();
 
-    // Downsampling buffer for getDisplayData (max 120 points as per requirements)
-    mutable DisplayPoint downsampledBuffer[120];
+    // Bind the running extrema to the current rings (discarding what they held)
+    void attachDisplayExtrema(uint16_t* minuteStorage);
 
-    // Batch ID generation
-    void generateBatchId(char* batchId, size_t bufferSize, const AveragedData& data,
-                         bool timeSynced);
+    // Averaging window helper
+    void resetRunningStats();
+    static void fillSpread(SensorSpread& spread, const RunningStats& stats, float fallback);
 
     // Ring buffer helpers
-    void advanceHead();
-    void advanceTail();
+    uint16_t removeBufferedIf(bool (*match)(const PackedAveragedData& entry,
+                                            const void* context),
+                              const void* context);
+    static bool sequenceAtOrBefore(uint32_t sequence, uint32_t watermark);
 
-    // Display buffer helper
-    void downsampleDisplayData(const DisplayPoint* source, uint16_t sourceCount, DisplayPoint* dest,
-                               uint16_t maxPoints) const;
+    // Display buffer helpers
+    void appendDisplayPoint(const float* values, uint32_t timestamp);
+    void rollUpDisplayPoint(const float* values, uint32_t timestamp);
+    void commitOpenBucket(uint8_t coarseIdx);
+    static float coarseScale(uint8_t sensorIdx);
+    static int16_t toCoarse(float value, uint8_t sensorIdx);
+    static float fromCoarse(int16_t value, uint8_t sensorIdx);
+    static uint16_t coarseOffset(uint8_t coarseIdx);
+    static uint16_t coarseCapacity(uint8_t coarseIdx);
+    static uint32_t coarseIntervalMs(uint8_t coarseIdx);
+    // Number of the oldest points of a series older than spanMs before its newest point
+    static uint16_t pointsBeforeSpan(const DisplaySeries& series, uint32_t newestMs,
+                                     uint32_t spanMs);
+    uint16_t linearizeMinuteTier(uint8_t sensorIdx, DisplayPoint* dest) const;
+    uint16_t linearizeBuckets(uint8_t coarseIdx, uint8_t sensorIdx, DisplayBucket* dest) const;
+    // Lowest bucket min and highest bucket max over a span, open bucket included
+    bool scanBucketRange(uint8_t coarseIdx, uint8_t sensorIdx, uint32_t spanMs,
+                         float& minValue, float& maxValue) const;
 };
 
 #endif  // DATA_MANAGER_H
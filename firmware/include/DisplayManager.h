@@ -1,9 +1,6 @@
 #ifndef DISPLAY_MANAGER_H
 #define DISPLAY_MANAGER_H
 
-#include <string>
-#include <vector>
-
 #ifdef UNIT_TEST
 #include "../test/mocks/Arduino.h"
 #else
@@ -13,7 +10,9 @@
 #endif
 
 #include "ConfigFileManager.h"
+#include "RenderScheduler.h"
 #include "TouchDetector.h"
+#include "TouchInput.h"
 #include "models/Config.h"
 #include "models/DisplayPage.h"
 #include "models/DisplayPoint.h"
@@ -30,9 +29,14 @@ class DisplayManager {
     DisplayManager();
     ~DisplayManager();
 
-    bool initialize();
-    void showStartupScreen(const std::string& firmwareVersion);
-    void showCriticalError(const std::string& title, const std::string& message);
+    /**
+     * Bring up the panel
+     * @param glance Glance mode for deep-sleep wakes: no graph sprites or DMA buffers, and
+     *        update() draws nothing, so the wake shows only the showGlance() frame
+     */
+    bool initialize(bool glance = false);
+    void showStartupScreen(const char* firmwareVersion);
+    void showCriticalError(const char* title, const char* message);
     void update(const SensorReadings& current, const SystemStatus& status,
                 DataManager* dataManager = nullptr, const Config* config = nullptr);
     void cyclePage();
@@ -44,18 +48,41 @@ class DisplayManager {
     void setLowPowerMode(bool enabled);
     bool isLowPowerMode() const { return lowPowerMode; }
     void setBacklightBrightness(uint8_t brightness);  // 0-255
+    uint8_t getBacklightBrightness() const { return backlightBrightness; }
     void disableDisplay();
+    bool isDisplayEnabled() const { return displayEnabled; }
     void enableDisplay();
 
-    // Touch enable/disable
+    // Touch enable/disable (navigation: tap = next page, long press = next graph span)
     void setTouchEnabled(bool enabled, TouchControllerType type);
 
     // Config error display
     void showConfigError(ConfigLoadResult errorType);
-    void showConfigValidationError(const std::string& missingFields);
+    void showConfigValidationError(const char* missingFields);
 
     // Provisioning mode display
-    void showProvisioningMode(const std::string& instructions);
+    void showProvisioningMode(const char* instructions);
+
+    /**
+     * Draw the single condensed frame of a glance wake: newest value and graph-span range
+     * per sensor from the restored history, its age, backlog and battery
+     */
+    void showGlance(const DataManager& history, uint8_t batteryPercent);
+    bool isGlanceMode() const { return glanceMode; }
+
+    // Backlight off and panel in sleep mode (before deep sleep; initialize() wakes it)
+    void powerDown();
+
+    // Time span shown on graph pages (picks the display history tier)
+    void setGraphSpanMs(uint32_t spanMs) {
+        graphSpanMs = spanMs ? spanMs : DEFAULT_GRAPH_SPAN_MS;
+        scheduler.requestFrame();
+    }
+    uint32_t getGraphSpanMs() const { return graphSpanMs; }
+
+    // Frame-rate cap of update() (0 = RENDER_DEFAULT_MAX_FPS)
+    void setMaxFps(uint8_t fps) { scheduler.setMaxFps(fps); }
+    uint32_t getFramesRendered() const { return scheduler.getFramesRendered(); }
 
     DisplayPage getCurrentPage() const { return currentPage; }
     bool isInitialized() const { return initialized; }
@@ -63,6 +90,13 @@ class DisplayManager {
    private:
 #ifndef UNIT_TEST
     TFT_eSPI tft;
+    TFT_eSprite graphSprite;  // Off-screen graph plot area (PSRAM), not created without PSRAM
+    TFT_eSprite chromeSprite;  // Static plot background (axes, grid, unit), same size
+    const char* chromeUnit;    // Unit label chromeSprite was rendered for (nullptr = none)
+    TFT_eSPI* canvas;         // Draw target of the text and graph helpers: tft or graphSprite
+    int16_t canvasOriginY;    // Screen row of canvas row 0
+    uint16_t* dmaBands[2];    // Internal DMA bounce buffers for pushing the sprite
+    bool dmaPushPending;      // DMA transfer in flight; tft is held in a write transaction
 #endif
 
     DisplayPage currentPage;
@@ -70,6 +104,7 @@ class DisplayManager {
     unsigned long lastActivity;
     bool debugMode;
     bool initialized;
+    bool glanceMode;
     bool lowPowerMode;
     bool displayEnabled;
     uint8_t backlightBrightness;
@@ -77,38 +112,121 @@ class DisplayManager {
     uint16_t screenHeight;
     bool touchEnabled;
     TouchControllerType touchType;
-
+    TouchInput touchInput;  // Gestures queued from the touch IRQ
+    uint32_t graphSpanMs;
+    RenderScheduler scheduler;  // update() draws only when something changed
+
+    static constexpr uint32_t DEFAULT_GRAPH_SPAN_MS = 4UL * 3600000UL;
+    static constexpr uint16_t GRAPH_MAX_POINTS = 120;
+    DisplayPoint plotScratch[GRAPH_MAX_POINTS];  // Downsampled series when history has more
+
+    /**
+     * Retained-mode cache of what is on screen. Pages draw their static layout once after
+     * a clear and repaint a widget only when its state (text CRC, badge color, ...) changes,
+     * clearing just the rectangle it last covered.
+     */
+    struct Widget {
+        uint32_t state;
+        int16_t x, y, w, h;
+        bool drawn;
+    };
+    static constexpr uint8_t MAX_WIDGETS = 24;
+    Widget widgets[MAX_WIDGETS];
+    bool pageDirty;  // Screen must be cleared and the page layout drawn again
+
+    // Series last drawn into the graph sprite, so a one-point shift can scroll it
+    bool plotValid;
+    uint16_t plotCount;
+    float plotMin;
+    float plotMax;
+    uint32_t plotAllCrc;   // CRC of all points
+    uint32_t plotTailCrc;  // CRC of all points but the oldest
+
+    // Min/max lines cover the graph span when a history is given
     void renderSummaryPage(const SensorReadings& current, const SystemStatus& status,
-                           const Config* config = nullptr);
-    void renderGraphPage(SensorType type, const std::vector<DisplayPoint>& data);
+                           const DataManager* dataManager, const Config* config = nullptr);
+    // Plots the history straight from its buffer (no copy), scaled by its running range
+    void renderGraphPage(SensorType type, const DataManager& history);
     void renderSystemHealthPage(const SystemStatus& status);
 
-    void drawSensorValue(int16_t x, int16_t y, const std::string& label, float value,
-                         const std::string& unit, SensorHealth health);
-    void drawHealthBadge(int16_t x, int16_t y, SensorHealth health);
-    void drawMinMax(int16_t x, int16_t y, float minVal, float maxVal);
-    void drawWiFiIndicator(int16_t x, int16_t y, int8_t rssi);
-    void drawQueueDepth(int16_t x, int16_t y, uint16_t count);
-    void drawTransmissionIndicator(int16_t x, int16_t y, unsigned long lastTransmissionMs);
-    void drawLineGraph(const std::vector<DisplayPoint>& data, uint16_t maxPoints);
-    void drawAxes(float minVal, float maxVal, const std::string& unit);
+    // Act on the gestures queued since the last update (no bus access)
+    void handleTouch();
+    void cycleGraphSpan();  // 4 h -> 24 h -> 7 d -> 4 h
+
+    void drawSensorValue(int16_t x, int16_t y, const char* label, float value, const char* unit,
+                         SensorHealth health);
+    void drawHealthBadge(uint8_t slot, int16_t x, int16_t y, SensorHealth health);
+    void drawMinMax(uint8_t slot, int16_t x, int16_t y, float minVal, float maxVal);
+    void drawWiFiIndicator(uint8_t slot, int16_t x, int16_t y, int8_t rssi);
+    void drawQueueDepth(uint8_t slot, int16_t x, int16_t y, uint16_t count);
+    void drawTransmissionIndicator(uint8_t slot, int16_t x, int16_t y,
+                                   unsigned long lastTransmissionMs);
+    void drawLineGraph(const DisplayPoint* data, uint16_t count, float minVal, float maxVal);
+    // Segment from data[index - 1] to data[index]
+    void drawGraphSegment(const DisplayPoint* data, uint16_t count, uint16_t index, float minVal,
+                          float maxVal);
+    // Static plot background: grid rows, axes and unit label
+    void drawAxes(const char* unit);
+    void drawScaleLabels(float minVal, float maxVal);
+    void drawGridRows(int16_t x, int16_t width);
+    int16_t graphStep() const;  // Pixels between consecutive points
+    // Move the plotted line one point step left in the sprite (no-op on the panel)
     void scrollGraphLeft();
-    std::vector<DisplayPoint> downsample(const std::vector<DisplayPoint>& data,
-                                         uint16_t targetPoints);
+    /**
+     * Reduce data to at most targetPoints (min/max envelope)
+     * @param out Room for targetPoints points
+     * @return Points written to out
+     */
+    uint16_t downsample(const DisplayPoint* data, uint16_t count, DisplayPoint* out,
+                        uint16_t targetPoints);
+
+    void drawThresholdIndicator(uint8_t slot, int16_t x, int16_t y, float value,
+                                float lowThreshold, float highThreshold);
+
+    /**
+     * Clear the screen if the page changed since the last render
+     * @return true when the caller must draw the page's static layout
+     */
+    bool beginPage();
+
+    /**
+     * Claim a widget slot for a repaint
+     * @param state Value identifying what the widget shows
+     * @return true if the widget must be drawn (its old rectangle is already cleared)
+     */
+    bool beginWidget(uint8_t slot, uint32_t state, int16_t x, int16_t y, int16_t w, int16_t h,
+                     bool clearOld = true);
+
+    // Text widget; x is the right edge when rightAligned
+    void drawTextWidget(uint8_t slot, int16_t x, int16_t y, const char* text, uint16_t color,
+                        uint8_t size = 1, bool rightAligned = false);
 
-    void drawThresholdIndicator(int16_t x, int16_t y, float value, float lowThreshold,
-                                float highThreshold);
+#ifndef UNIT_TEST
+    // Redirect drawing of the graph plot area to the sprite (when there is one)
+    void beginGraphCanvas(bool clear);
+    /**
+     * Copy the cached plot background into the graph sprite, rendering it first if the
+     * unit changed
+     * @return false without a chrome sprite (the caller draws the background itself)
+     */
+    bool restoreGraphChrome(const char* unit);
+    // Send the composed plot area to the panel, by DMA when available
+    void pushGraphCanvas();
+    // Finish an in-flight DMA push before the next panel access
+    void waitForGraphPush();
+#endif
 
-    void drawText(int16_t x, int16_t y, const std::string& text, uint16_t color, uint8_t size = 1);
-    void drawRightAlignedText(int16_t x, int16_t y, const std::string& text, uint16_t color,
+    void drawText(int16_t x, int16_t y, const char* text, uint16_t color, uint8_t size = 1);
+    void drawRightAlignedText(int16_t x, int16_t y, const char* text, uint16_t color,
                               uint8_t size = 1);
-    void drawCenteredText(int16_t y, const std::string& text, uint16_t color, uint8_t size = 1);
+    void drawCenteredText(int16_t y, const char* text, uint16_t color, uint8_t size = 1);
 
     uint16_t getHealthColor(SensorHealth health);
     uint16_t getRSSIColor(int8_t rssi);
 
-    std::string formatUptime(unsigned long uptimeMs);
-    std::string formatFloat(float value, uint8_t decimals);
+    // Format into out and return it, so labels are built without heap allocations
+    const char* formatUptime(unsigned long uptimeMs, char* out, size_t size);
+    const char* formatFloat(float value, uint8_t decimals, char* out, size_t size);
 
     // Touch driver initialization (conditional)
     bool initializeTouchDriver();
@@ -0,0 +1,104 @@
+#ifndef DISPLAY_TASK_H
+#define DISPLAY_TASK_H
+
+#include <cstdint>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#endif
+
+#include "DataManager.h"
+#include "DisplayManager.h"
+#include "SpscRing.h"
+#include "models/Config.h"
+#include "models/SensorReadings.h"
+#include "models/SystemStatus.h"
+
+/**
+ * DisplayTask renders the display from its own low-priority FreeRTOS task, so a
+ * slow frame never delays reading processing or an upload step in loop(), and
+ * the screen keeps refreshing while loop() is busy with the network.
+ *
+ * loop() publishes immutable state messages into a small lock-free mailbox
+ * (SpscRing) and notifies the task; the task drains it and renders only the newest
+ * message, never a backlog. A full mailbox (the task stalled for MAILBOX_LENGTH
+ * publishes) skips the new message until the task catches up. The display history in
+ * DataManager is
+ * too large to copy per frame; the task holds a lock while rendering, and other
+ * tasks take the same lock around anything that changes the history or the
+ * DisplayManager.
+ */
+class DisplayTask {
+   public:
+    static constexpr uint32_t STACK_SIZE = 6144;
+    static constexpr uint8_t TASK_PRIORITY = 1;  // Lowest app priority; WiFi/lwIP preempt it
+    static constexpr int8_t TASK_CORE = 1;       // APP_CPU with sensing; PRO_CPU is the network
+    static constexpr uint32_t POLL_MS = 20;      // Touch and clock tick without new messages
+    static constexpr uint8_t MAILBOX_LENGTH = 4;
+
+    /**
+     * State for one frame, copied into the mailbox
+     */
+    struct Message {
+        SensorReadings current;
+        SystemStatus status;
+        bool lowPower;  // Battery mode: dim backlight and fewer frames
+        bool blank;     // Battery very low: turn the panel off
+    };
+
+    DisplayTask(DisplayManager& displayManager, DataManager& dataManager);
+    ~DisplayTask();
+
+    /**
+     * Create the lock and start the display task.
+     * @param config Configuration passed to each frame (must outlive the task)
+     * @return true if the task and lock were created
+     */
+    bool start(const Config* config);
+
+    /**
+     * Stop the task between frames and release the lock. Call
+     * before anything that rewrites the display history or turns the panel off.
+     */
+    void stop();
+
+    /**
+     * Queue a newer state without blocking (skipped if the mailbox is full).
+     * @param message State to render next
+     */
+    void publish(const Message& message);
+
+    /**
+     * Hold off rendering while another task changes the display history or the
+     * DisplayManager. No-op when the task is not running.
+     */
+    void lock();
+    void unlock();
+
+    /**
+     * @return true if the task is running
+     */
+    bool isRunning() const;
+
+   private:
+    DisplayManager& display;
+    DataManager& history;
+    const Config* frameConfig;
+    Message latest;  // Task side copy; kept off the task stack
+
+#ifdef ARDUINO
+    StaticSpscRing<Message, MAILBOX_LENGTH> mailbox;
+    TaskHandle_t taskHandle;
+    SemaphoreHandle_t frameLock;
+
+    static void taskEntry(void* arg);
+    void run();
+    void applyPower(const Message& message);
+#endif
+};
+
+#endif  // DISPLAY_TASK_H
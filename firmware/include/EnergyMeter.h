@@ -0,0 +1,85 @@
+#ifndef ENERGY_METER_H
+#define ENERGY_METER_H
+
+#include <stdint.h>
+
+#include "models/EnergyProfile.h"
+
+// Default current coefficients (mA), ESP32-WROOM typicals; override per board with build
+// flags. WiFi, backlight and sensor figures are drawn on top of the CPU state
+#ifndef ENERGY_MA_CPU_MAX
+#define ENERGY_MA_CPU_MAX 50.0f
+#endif
+#ifndef ENERGY_MA_CPU_MIN
+#define ENERGY_MA_CPU_MIN 20.0f
+#endif
+#ifndef ENERGY_MA_LIGHT_SLEEP
+#define ENERGY_MA_LIGHT_SLEEP 0.8f
+#endif
+#ifndef ENERGY_MA_WIFI_TX
+#define ENERGY_MA_WIFI_TX 170.0f
+#endif
+#ifndef ENERGY_MA_WIFI_RX
+#define ENERGY_MA_WIFI_RX 80.0f
+#endif
+#ifndef ENERGY_MA_WIFI_IDLE
+#define ENERGY_MA_WIFI_IDLE 3.0f
+#endif
+#ifndef ENERGY_MA_BACKLIGHT
+#define ENERGY_MA_BACKLIGHT 40.0f  // At full brightness
+#endif
+#ifndef ENERGY_MA_SENSORS
+#define ENERGY_MA_SENSORS 1.5f
+#endif
+
+/**
+ * EnergyMeter keeps time-in-state totals for the power states in EnergyProfile.h and turns
+ * them into estimated charge per subsystem with per-state current coefficients. It does
+ * no timing itself: callers hand it measured durations, so it runs unchanged on the host.
+ * Comparing mAh per hour of windowMs between builds shows where a change moved energy.
+ */
+class EnergyMeter {
+   public:
+    EnergyMeter();
+
+    /**
+     * Add time spent in a state
+     * @param state State the time was spent in
+     * @param ms Duration in milliseconds
+     */
+    void add(EnergyState state, uint32_t ms);
+
+    /**
+     * Set the current drawn in a state
+     * @param state State to change
+     * @param milliamps Current in mA (negative values are ignored)
+     */
+    void setCoefficient(EnergyState state, float milliamps);
+    float getCoefficient(EnergyState state) const;
+
+    uint32_t getStateMs(EnergyState state) const;
+
+    /**
+     * @return Estimated charge drawn by a subsystem since the last reset (mAh)
+     */
+    float getMah(EnergySubsystem subsystem) const;
+    float getTotalMah() const;
+
+    /**
+     * @return Charge per subsystem, and the accounted CPU time as the window
+     */
+    EnergyReport getReport() const;
+
+    // Clear the totals (coefficients are kept)
+    void reset();
+
+    static EnergySubsystem subsystemOf(EnergyState state);
+    static const char* stateKey(EnergyState state);
+    static const char* subsystemKey(EnergySubsystem subsystem);
+
+   private:
+    uint64_t stateMs[NUM_ENERGY_STATES];
+    float coefficientMa[NUM_ENERGY_STATES];
+};
+
+#endif  // ENERGY_METER_H
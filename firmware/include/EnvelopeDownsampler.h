@@ -0,0 +1,67 @@
+#ifndef ENVELOPE_DOWNSAMPLER_H
+#define ENVELOPE_DOWNSAMPLER_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "models/DisplayPoint.h"
+
+/**
+ * Min/max envelope downsampling for graph series.
+ *
+ * The source is split into maxPoints / 2 equal columns, and each column contributes its
+ * minimum and maximum point in time order. Short spikes (watering events, heater cycles)
+ * therefore survive the reduction, where evenly spaced picks would alias them away.
+ * A flat column (min == max) keeps its first and last point instead.
+ *
+ * @param source Oldest-first points
+ * @param sourceCount Number of source points
+ * @param dest Receives up to maxPoints points (must not alias source)
+ * @param maxPoints Output budget
+ * @return Number of points written (sourceCount if no reduction was needed, otherwise
+ *         maxPoints rounded down to an even number)
+ */
+inline uint16_t downsampleEnvelope(const DisplayPoint* source, uint16_t sourceCount,
+                                   DisplayPoint* dest, uint16_t maxPoints) {
+    if (sourceCount <= maxPoints) {
+        memcpy(dest, source, sourceCount * sizeof(DisplayPoint));
+        return sourceCount;
+    }
+    if (maxPoints < 2) {
+        if (maxPoints == 1) {
+            dest[0] = source[sourceCount - 1];
+        }
+        return maxPoints;
+    }
+
+    uint16_t columns = maxPoints / 2;
+    uint16_t written = 0;
+    for (uint16_t c = 0; c < columns; c++) {
+        uint16_t begin = (uint32_t)c * sourceCount / columns;
+        uint16_t end = (uint32_t)(c + 1) * sourceCount / columns;
+
+        uint16_t minIdx = begin;
+        uint16_t maxIdx = begin;
+        for (uint16_t i = begin + 1; i < end; i++) {
+            if (source[i].value < source[minIdx].value) {
+                minIdx = i;
+            }
+            if (source[i].value > source[maxIdx].value) {
+                maxIdx = i;
+            }
+        }
+        if (minIdx == maxIdx) {
+            // Flat column: span it with its endpoints
+            minIdx = begin;
+            maxIdx = end - 1;
+        }
+
+        uint16_t first = minIdx < maxIdx ? minIdx : maxIdx;
+        uint16_t second = minIdx < maxIdx ? maxIdx : minIdx;
+        dest[written++] = source[first];
+        dest[written++] = source[second];
+    }
+    return written;
+}
+
+#endif  // ENVELOPE_DOWNSAMPLER_H
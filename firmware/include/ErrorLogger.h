@@ -1,20 +1,45 @@
 #ifndef ERROR_LOGGER_H
 #define ERROR_LOGGER_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef UNIT_TEST
 #include "../test/mocks/Arduino.h"
 #else
 #include <Arduino.h>
 #endif
 
+// Numeric levels for the preprocessor (ErrorLevel values)
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO 1
+#define LOG_LEVEL_WARNING 2
+#define LOG_LEVEL_ERROR 3
+#define LOG_LEVEL_CRITICAL 4
+
+// Records below this level are compiled out (override with -D LOG_MIN_LEVEL=...)
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL LOG_LEVEL_INFO
+#endif
+
+#define LOG_RING_SIZE 2048  // Formatted text waiting for the UART
+#define LOG_LINE_MAX 160    // One record, timestamp to line end; longer text is cut
+#define LOG_TASK_STACK 2048
+#define LOG_TASK_PRIORITY 1  // Lowest app priority; only idle time goes to the UART
+#define LOG_TASK_CORE 0      // PRO_CPU, off the sensing and display core
+
+#define POSTMORTEM_ENTRIES 16      // Most recent records kept in RTC memory across resets
+#define POSTMORTEM_TEXT_LENGTH 25  // Message bytes kept per record, terminator included
+
 /**
  * Error severity levels for logging
  */
-enum class ErrorLevel {
-    INFO,     // Informational message
-    WARNING,  // Warning that doesn't prevent operation
-    ERROR,    // Error that affects functionality
-    CRITICAL  // Critical error that may prevent operation
+enum class ErrorLevel : uint8_t {
+    DEBUG = LOG_LEVEL_DEBUG,  // Development detail (compiled out by default)
+    INFO,                     // Informational message
+    WARNING,                  // Warning that doesn't prevent operation
+    ERROR,                    // Error that affects functionality
+    CRITICAL                  // Critical error that may prevent operation
 };
 
 /**
@@ -30,15 +55,59 @@ enum class ErrorType {
     SYSTEM          // General system errors
 };
 
+/**
+ * Why the chip last reset (same numbering as esp_reset_reason_t)
+ */
+enum ResetReason : uint8_t {
+    RESET_UNKNOWN,
+    RESET_POWERON,    // Power-on; RTC memory is garbage
+    RESET_EXT,        // External pin
+    RESET_SW,         // esp_restart()
+    RESET_PANIC,      // Exception or abort
+    RESET_INT_WDT,    // Interrupt watchdog
+    RESET_TASK_WDT,   // Task watchdog (esp_task_wdt)
+    RESET_WDT,        // Other watchdogs
+    RESET_DEEPSLEEP,  // Wake from deep sleep
+    RESET_BROWNOUT,   // Supply dropped out
+    RESET_SDIO,       // SDIO reset
+    NUM_RESET_REASONS
+};
+
+/**
+ * One compact post-mortem record (32 bytes, kept in RTC slow memory)
+ */
+struct PostMortemEntry {
+    uint32_t timeMs;  // millis() in the boot that logged it
+    uint8_t level;    // ErrorLevel
+    uint8_t type;     // ErrorType
+    uint8_t boot;     // Boot sequence while recording; boots before the reset once kept
+    char text[POSTMORTEM_TEXT_LENGTH];  // Start of the message, JSON-safe and terminated
+};
+
 /**
  * ErrorLogger provides centralized error logging with timestamps,
  * error types, and severity levels.
  *
- * All error messages are output to serial console with context information.
+ * Each record is formatted once into a fixed ring and a low-priority task writes the ring
+ * to the serial console, so a log call costs one snprintf and a copy instead of a wait
+ * on the UART. Until begin() starts that task, records are written out immediately.
+ * A full ring drops whole records and counts them.
+ *
+ * Every record is also kept in compact form in a small ring in RTC memory that survives
+ * deep sleep and watchdog or panic resets, so the lines leading up to a stall can be read
+ * on the next boot. After such a reset the ring is kept as the post-mortem log, printed
+ * once and carried by the next upload that gets through; a power-on starts it empty.
+ *
  * Sensitive data (passwords, tokens) should never be logged.
  */
 class ErrorLogger {
    public:
+    /**
+     * Start the drain task (call once Serial is up)
+     * @return true if the task is running
+     */
+    static bool begin();
+
     /**
      * Log an error message with context.
      * @param level Error severity level
@@ -49,13 +118,26 @@ class ErrorLogger {
     static void log(ErrorLevel level, ErrorType type, const char* message,
                     const char* context = nullptr);
 
+    /**
+     * Log a printf-style message (what the LOG_* macros expand to)
+     * @param level Error severity level
+     * @param type Error type/category
+     * @param format printf format string
+     */
+    static void logf(ErrorLevel level, ErrorType type, const char* format, ...)
+        __attribute__((format(printf, 3, 4)));
+
     /**
      * Log an informational message.
      * @param type Error type/category
      * @param message Message text
      * @param context Optional context
      */
-    static void info(ErrorType type, const char* message, const char* context = nullptr);
+    static void info(ErrorType type, const char* message, const char* context = nullptr) {
+        if (LOG_MIN_LEVEL <= LOG_LEVEL_INFO) {
+            log(ErrorLevel::INFO, type, message, context);
+        }
+    }
 
     /**
      * Log a warning message.
@@ -63,7 +145,11 @@ class ErrorLogger {
      * @param message Warning text
      * @param context Optional context
      */
-    static void warning(ErrorType type, const char* message, const char* context = nullptr);
+    static void warning(ErrorType type, const char* message, const char* context = nullptr) {
+        if (LOG_MIN_LEVEL <= LOG_LEVEL_WARNING) {
+            log(ErrorLevel::WARNING, type, message, context);
+        }
+    }
 
     /**
      * Log an error message.
@@ -71,7 +157,11 @@ class ErrorLogger {
      * @param message Error text
      * @param context Optional context
      */
-    static void error(ErrorType type, const char* message, const char* context = nullptr);
+    static void error(ErrorType type, const char* message, const char* context = nullptr) {
+        if (LOG_MIN_LEVEL <= LOG_LEVEL_ERROR) {
+            log(ErrorLevel::ERROR, type, message, context);
+        }
+    }
 
     /**
      * Log a critical error message.
@@ -79,12 +169,81 @@ class ErrorLogger {
      * @param message Critical error text
      * @param context Optional context
      */
-    static void critical(ErrorType type, const char* message, const char* context = nullptr);
+    static void critical(ErrorType type, const char* message, const char* context = nullptr) {
+        log(ErrorLevel::CRITICAL, type, message, context);
+    }
+
+    // Runtime filter on top of LOG_MIN_LEVEL (default INFO)
+    static void setMinLevel(ErrorLevel level) { minLevel = level; }
+    static ErrorLevel getMinLevel() { return minLevel; }
+
+    /**
+     * Write everything buffered to the console now (before a restart or deep sleep)
+     */
+    static void flush();
+
+    /**
+     * Take buffered text out of the ring (the drain task's read side; exposed for tests)
+     * @param out Receives up to capacity bytes (not terminated)
+     * @return Bytes taken
+     */
+    static size_t read(char* out, size_t capacity);
+
+    /**
+     * @return Records dropped because the ring was full
+     */
+    static uint32_t getDroppedCount() { return droppedCount; }
+
+    // Empty the ring and reset the counters and filter (host tests)
+    static void clear();
+
+    /**
+     * Check the RTC ring at boot (call first in setup(); nothing is kept before this).
+     * After a panic, watchdog or brownout reset its records become the post-mortem log.
+     * @param reason Reset reason from esp_reset_reason()
+     * @return true if a new post-mortem log was kept
+     */
+    static bool beginPostMortem(ResetReason reason);
+
+    // Print the post-mortem log kept at this boot (once Serial is up)
+    static void dumpPostMortem();
+
+    // A post-mortem log is waiting to be uploaded
+    static bool hasPostMortem();
+
+    // Reset that ended the recording
+    static ResetReason getPostMortemReason();
+
+    static uint8_t getPostMortemCount();
+
+    /**
+     * @param index 0 is the oldest record
+     */
+    static const PostMortemEntry& getPostMortemEntry(uint8_t index);
+
+    // Drop the post-mortem log (after an upload carried it)
+    static void clearPostMortem();
+
+    // Payload key for a reset reason ("task_wdt", "panic", ...)
+    static const char* resetReasonKey(ResetReason reason);
 
-   private:
     static const char* levelToString(ErrorLevel level);
     static const char* typeToString(ErrorType type);
-    static void printTimestamp();
+
+   private:
+    static ErrorLevel minLevel;
+    static char ring[LOG_RING_SIZE];
+    static size_t ringHead;   // Oldest unread byte
+    static size_t ringCount;  // Unread bytes
+    static uint32_t droppedCount;
+
+    // Format the record prefix; returns its length
+    static size_t formatPrefix(char* out, size_t capacity, ErrorLevel level, ErrorType type);
+
+    // Terminate a record and queue it whole, or drop it; the text after the prefix also
+    // goes to the RTC ring
+    static void commit(char* record, size_t prefixLength, size_t length, ErrorLevel level,
+                       ErrorType type);
 };
 
 #endif  // ERROR_LOGGER_H
@@ -0,0 +1,89 @@
+#ifndef EVENT_DETECTOR_H
+#define EVENT_DETECTOR_H
+
+#include <stdint.h>
+
+#include "models/AveragedData.h"
+#include "models/SensorReadings.h"
+
+#define EVENT_SOIL_HYSTERESIS 3.0f     // Soil moisture % back past a threshold to re-arm it
+#define EVENT_SOIL_FAST_PER_MIN 5.0f   // Soil moisture %/min that counts as a sudden change
+#define EVENT_MIN_INTERVAL_MS 60000UL  // Rate-of-change events closer than this are merged
+
+// Events found in one reading (bitmask)
+enum SoilEvent : uint8_t {
+    SOIL_EVENT_NONE = 0,
+    SOIL_EVENT_LOW = 1 << 0,      // Fell below soilMoistureThresholdLow (too dry)
+    SOIL_EVENT_HIGH = 1 << 1,     // Rose above soilMoistureThresholdHigh (too wet)
+    SOIL_EVENT_NORMAL = 1 << 2,   // Back inside the thresholds, past the hysteresis
+    SOIL_EVENT_FAST = 1 << 3,     // Changed faster than EVENT_SOIL_FAST_PER_MIN
+};
+
+/**
+ * EventDetector checks every reading for soil moisture alerts, so they go out at once
+ * instead of with the next averaging window (and wait behind any backlog):
+ * - threshold crossings: the reading enters the low or high zone, or returns inside
+ *   the thresholds. Leaving a zone takes EVENT_SOIL_HYSTERESIS past the threshold, so
+ *   a value hovering on it raises one event, not one per reading
+ * - rate of change: a fresh value moves faster than EVENT_SOIL_FAST_PER_MIN since the
+ *   previous one (irrigation, a probe pulled out); re-armed once the rate has dropped
+ *   below half that and EVENT_MIN_INTERVAL_MS has passed
+ *
+ * The first reading only sets the zone, unless saveForSleep() kept the zone in RTC memory,
+ * so a crossing that woke the node from deep sleep (SoilUlp) still raises its event.
+ * Stale and unavailable soil values are skipped.
+ * The caller turns an event into a one-reading window (toWindow()) and sends it ahead
+ * of the batched data.
+ */
+class EventDetector {
+   public:
+    EventDetector();
+
+    /**
+     * @param low soilMoistureThresholdLow (%)
+     * @param high soilMoistureThresholdHigh (%)
+     */
+    void configure(float low, float high);
+
+    /**
+     * Fold in a reading
+     * @param readings Reading just taken by the acquisition task
+     * @return SoilEvent bits raised by this reading (SOIL_EVENT_NONE if none)
+     */
+    uint8_t addReading(const SensorReadings& readings);
+
+    // -1 = below low, 0 = inside, 1 = above high
+    int8_t getZone() const { return zone; }
+
+    void reset();
+
+    // Keep the zone in RTC memory for the next wake (no-op before the first reading)
+    void saveForSleep() const;
+
+    /**
+     * Take the zone saveForSleep() kept (used once)
+     * @return true if a zone was restored
+     */
+    bool restoreAfterSleep();
+
+    /**
+     * One-reading window for the event upload (sample start and end at the reading)
+     * @param readings Reading that raised the event
+     * @param window Receives the window; epochs and batch ID are left to the caller
+     */
+    static void toWindow(const SensorReadings& readings, AveragedData& window);
+
+   private:
+    float lowPercent;
+    float highPercent;
+    int8_t zone;
+    bool zoneKnown;
+
+    float lastValue;
+    uint32_t lastTimeMs;
+    bool lastValid;
+    bool fastArmed;
+    uint32_t lastFastMs;
+};
+
+#endif  // EVENT_DETECTOR_H
@@ -0,0 +1,109 @@
+#ifndef GZIP_STREAM_H
+#define GZIP_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Stream.h>
+#endif
+
+#include "PayloadStream.h"
+
+// LZ77 history is 2 * GZIP_DICT_SIZE bytes; matches reach back up to that far
+#define GZIP_DICT_SIZE 2048
+#define GZIP_HASH_BITS 10
+#define GZIP_OUTPUT_SIZE 256
+
+/**
+ * GzipStream compresses a PayloadStream on the fly into a gzip member (RFC 1952) that
+ * HTTPClient::sendRequest() copies to the socket with Content-Encoding: gzip.
+ *
+ * - One final deflate block with the fixed Huffman code (RFC 1951 §3.2.6), so no code
+ *   tables have to be built or sent; JSON keys repeated every reading still shrink to
+ *   a few bytes each through LZ77 matches
+ * - LZ77 over a 4 KB sliding buffer with hash chains capped at GZIP_MAX_CHAIN steps:
+ *   ~10 KB of state in total, allocated with the object
+ * - begin() compresses once without keeping the output to learn the Content-Length,
+ *   then rewinds both streams; rewind() replays the identical body for a retry
+ */
+class GzipStream
+#ifdef ARDUINO
+    : public Stream
+#endif
+{
+   public:
+    static constexpr uint8_t GZIP_MAX_CHAIN = 32;
+
+    GzipStream();
+
+    /**
+     * Wrap a source that has already been begun, and measure the compressed size
+     * @param source Uncompressed body (rewound and read twice)
+     */
+    void begin(PayloadStream& source);
+
+    // Restart the compressed body from the first byte
+    void rewind();
+
+    size_t contentLength() const { return totalLength; }
+    size_t uncompressedLength() const { return inputLength; }
+
+    size_t readBytes(char* buffer, size_t length);
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        return readBytes(reinterpret_cast<char*>(buffer), length);
+    }
+
+    // Stream interface (available() is the buffered output, 0 at the end)
+    int available();
+    int read();
+    int peek();
+    size_t write(uint8_t) { return 0; }
+    void flush() {}
+
+   private:
+    enum class Stage : uint8_t { HEADER, DEFLATE, TRAILER, DONE };
+
+    PayloadStream* source;
+    Stage stage;
+    size_t totalLength;
+    size_t inputLength;  // Uncompressed bytes consumed (ISIZE)
+    uint32_t crc;
+    bool sourceDone;
+
+    // LZ77 state: positions index window; NIL marks an empty slot
+    uint8_t window[2 * GZIP_DICT_SIZE];
+    uint16_t head[1 << GZIP_HASH_BITS];
+    uint16_t prev[GZIP_DICT_SIZE];
+    uint16_t strstart;   // Next position to encode
+    uint16_t lookahead;  // Bytes available from strstart
+
+    // LSB-first bit accumulator
+    uint32_t bitBuffer;
+    uint8_t bitCount;
+
+    uint8_t output[GZIP_OUTPUT_SIZE];
+    size_t outputLength;
+    size_t outputPos;
+
+    void reset();
+
+    /**
+     * Refill the output buffer
+     * @return false once the trailer has been produced
+     */
+    bool produce();
+
+    void fillWindow();
+    void insertHash(uint16_t pos);
+    uint16_t longestMatch(uint16_t& distance);
+
+    void putBits(uint32_t value, uint8_t count);
+    void putCode(uint16_t code, uint8_t length);
+    void putLiteral(uint8_t value);
+    void putMatch(uint16_t length, uint16_t distance);
+    void alignToByte();
+    void putByte(uint8_t value);
+};
+
+#endif  // GZIP_STREAM_H
@@ -0,0 +1,44 @@
+#ifndef HEAP_TRACE_H
+#define HEAP_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * HeapTrace counts heap allocations per loop() pass, to find code that allocates on every
+ * pass and fragments the heap until the TLS handshake can no longer get its buffers.
+ *
+ * Counting needs ESP-IDF's allocation hooks (CONFIG_HEAP_USE_HOOKS), so it is only built
+ * with -D HEAP_TRACE_HOOKS (debug builds); otherwise isEnabled() is false and the counts
+ * stay zero. The hooks run in whatever task or ISR allocates, which is why they only bump
+ * atomic counters.
+ */
+class HeapTrace {
+   public:
+    static bool isEnabled();
+
+    /**
+     * Count one allocation (called from the allocation hook; exposed for host tests)
+     * @param size Bytes requested
+     */
+    static void recordAllocation(size_t size);
+
+    // Count one free (called from the free hook)
+    static void recordFree();
+
+    // Close this loop() pass: its counts become lastPass*(), the maximum is kept
+    static void endPass();
+
+    static uint32_t getLastPassAllocations();
+    static uint32_t getLastPassBytes();
+
+    // Most allocations in a single pass since boot
+    static uint32_t getMaxPassAllocations();
+
+    // Allocations minus frees since boot (a steady climb is a leak)
+    static int32_t getOutstanding();
+
+    static void reset();
+};
+
+#endif  // HEAP_TRACE_H
@@ -2,49 +2,46 @@
 #define LOGGING_MACROS_H
 
 // ============================================================================
-// LOGGING MACROS - DEVELOPMENT ONLY
+// LOGGING MACROS
 // ============================================================================
 //
-// These macros are provided for DEVELOPMENT and DEBUGGING purposes only.
-// They use String concatenation which can cause heap fragmentation on ESP32.
+// printf-style shorthands for ErrorLogger::logf() (type SYSTEM). The text is
+// formatted once, straight into the ErrorLogger ring: no String temporaries, no
+// heap allocation, and no wait on the UART.
 //
-// PRODUCTION CODE SHOULD USE Serial.printf() DIRECTLY
+// Levels below LOG_MIN_LEVEL (ErrorLogger.h, default INFO) expand to nothing, so
+// their arguments are not even evaluated. Build with -D LOG_MIN_LEVEL=0 to keep
+// LOG_DEBUG; ErrorLogger::setMinLevel() filters further at runtime.
 //
-// Example production logging:
-//   Serial.printf("[INFO] Registration successful, confirmation_id: %s\n", id.c_str());
-//   Serial.printf("[ERROR] Invalid MAC address: %02X:%02X:%02X:%02X:%02X:%02X\n",
-//                 mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
-//   Serial.printf("[WARN] Registration failed with status %d, will retry\n", statusCode);
-//
-// Benefits of Serial.printf() over String concatenation:
-// - No heap allocation for temporary String objects
-// - Reduced heap fragmentation
-// - More predictable memory usage
-// - Better performance
-//
-// Only use these macros during development/debugging when you need quick
-// logging without worrying about format strings.
+// Example:
+//   LOG_INFO("Registration successful, confirmation_id: %s", id.c_str());
+//   LOG_WARN("Registration failed with status %d, will retry", statusCode);
 // ============================================================================
 
-#ifdef DEVELOPMENT_MODE
-
-#include <Arduino.h>
+#include "ErrorLogger.h"
 
-// Log levels for development
-#define LOG_ERROR(msg) Serial.println("[ERROR] " + String(msg))
-#define LOG_WARN(msg) Serial.println("[WARN] " + String(msg))
-#define LOG_INFO(msg) Serial.println("[INFO] " + String(msg))
-#define LOG_DEBUG(msg) Serial.println("[DEBUG] " + String(msg))
+#if LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(...) ErrorLogger::logf(ErrorLevel::DEBUG, ErrorType::SYSTEM, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#endif
 
+#if LOG_MIN_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(...) ErrorLogger::logf(ErrorLevel::INFO, ErrorType::SYSTEM, __VA_ARGS__)
 #else
+#define LOG_INFO(...) ((void)0)
+#endif
 
-// In production, these macros do nothing
-// Use Serial.printf() directly instead
-#define LOG_ERROR(msg) ((void)0)
-#define LOG_WARN(msg) ((void)0)
-#define LOG_INFO(msg) ((void)0)
-#define LOG_DEBUG(msg) ((void)0)
+#if LOG_MIN_LEVEL <= LOG_LEVEL_WARNING
+#define LOG_WARN(...) ErrorLogger::logf(ErrorLevel::WARNING, ErrorType::SYSTEM, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#endif
 
+#if LOG_MIN_LEVEL <= LOG_LEVEL_ERROR
+#define LOG_ERROR(...) ErrorLogger::logf(ErrorLevel::ERROR, ErrorType::SYSTEM, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
 #endif
 
 #endif  // LOGGING_MACROS_H
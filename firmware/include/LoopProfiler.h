@@ -0,0 +1,57 @@
+#ifndef LOOP_PROFILER_H
+#define LOOP_PROFILER_H
+
+#include <stdint.h>
+
+#include "models/LoopProfile.h"
+
+/**
+ * LoopProfiler times loop() phase by phase. Time spent in a phase during one pass is added
+ * up (a phase may be entered several times, e.g. once per reading), and endPass() files
+ * each phase that ran into its log-scale histogram. Recording a pass is a few additions,
+ * so it stays on in production; the histograms are read by the `perf` console command
+ * and summarized (p95 and worst case) in the health block.
+ */
+class LoopProfiler {
+   public:
+    /**
+     * Start timing a phase
+     * @param nowUs micros()
+     */
+    static void start(LoopPhase phase, uint32_t nowUs);
+
+    /**
+     * Add the time since start() to this pass (ignored unless the phase is running)
+     * @param nowUs micros()
+     */
+    static void finish(LoopPhase phase, uint32_t nowUs);
+
+    // Record this pass into the histograms and start the next one
+    static void endPass();
+
+    static const LoopPhaseStats& stats(LoopPhase phase);
+
+    /**
+     * @param percent 1-100
+     * @return Upper bound of the bucket holding that percentile, capped at the worst case
+     *         (0 before the phase has run)
+     */
+    static uint32_t percentileUs(LoopPhase phase, uint8_t percent);
+
+    // p95 and worst case of every phase, for SystemStatus
+    static void summarize(LoopPhaseSummary out[NUM_LOOP_PHASES]);
+
+    // Clear all histograms
+    static void reset();
+
+    // Histogram bucket for a duration
+    static uint8_t bucketFor(uint32_t durationUs);
+
+    // Exclusive upper bound of a bucket (UINT32_MAX for the open last bucket)
+    static uint32_t bucketLimitUs(uint8_t bucket);
+
+    // Payload and console key for a phase ("status", "sensors", ...)
+    static const char* phaseKey(LoopPhase phase);
+};
+
+#endif  // LOOP_PROFILER_H
@@ -0,0 +1,76 @@
+#ifndef LOOP_SCHEDULER_H
+#define LOOP_SCHEDULER_H
+
+#include <stdint.h>
+
+// Work loop() runs on a timer (index into LoopScheduler's job table)
+enum LoopJob : uint8_t {
+    LOOP_JOB_SENSING,       // Next reading expected from the acquisition task
+    LOOP_JOB_PUBLISH,       // Connection pre-warm deadline, or upload steps while one runs
+    LOOP_JOB_WIFI_CHECK,    // RSSI refresh
+    LOOP_JOB_RADIO_POLICY,  // Radio state between uploads
+    LOOP_JOB_DISPLAY,       // Latest state handed to the display task
+    LOOP_JOB_STATUS,        // Status update, energy accounting and task statistics
+    LOOP_JOB_CONSOLE,       // Serial console input and the debounced config save
+    NUM_LOOP_JOBS
+};
+
+/**
+ * LoopScheduler keeps loop()'s timers: each job is periodic or a one-shot deadline, and
+ * msUntilNext() tells the bottom of loop() exactly how long it may sleep. A deferrable
+ * job never ends a light sleep; it runs on the first pass after the wake.
+ *
+ * Periodic jobs keep their phase (the next due time advances by whole periods), so a
+ * late pass does not make the schedule drift; a pass more than a period late skips the
+ * missed runs instead of running them back to back.
+ */
+class LoopScheduler {
+   public:
+    LoopScheduler();
+
+    /**
+     * Run a job every periodMs. Re-registering with the same period keeps its phase
+     * @param periodMs Period (0 cancels the job)
+     * @param nowMs millis(); the first run is due one period from now
+     * @param deferrable May wait for the next wake instead of ending a light sleep
+     */
+    void setPeriodic(LoopJob job, uint32_t periodMs, unsigned long nowMs,
+                     bool deferrable = false);
+
+    /**
+     * Run a job once at a deadline (replaces any earlier period or deadline)
+     * @param dueMs millis() value it is due at (in the past = due now)
+     */
+    void setDeadline(LoopJob job, unsigned long dueMs, bool deferrable = false);
+
+    void cancel(LoopJob job);
+
+    bool isScheduled(LoopJob job) const { return jobs[job].scheduled; }
+
+    /**
+     * Check a job; a true return counts as the job having run (a deadline is cleared,
+     * a period moves on)
+     * @param nowMs millis()
+     */
+    bool isDue(LoopJob job, unsigned long nowMs);
+
+    /**
+     * Time until the earliest scheduled job
+     * @param nowMs millis()
+     * @param includeDeferrable false for the longest light sleep allowed
+     * @return 0 if a job is due, UINT32_MAX if nothing is scheduled
+     */
+    uint32_t msUntilNext(unsigned long nowMs, bool includeDeferrable = true) const;
+
+   private:
+    struct Job {
+        bool scheduled;
+        bool deferrable;
+        uint32_t periodMs;  // 0 for a one-shot deadline
+        unsigned long dueMs;
+    };
+
+    Job jobs[NUM_LOOP_JOBS];
+};
+
+#endif  // LOOP_SCHEDULER_H
@@ -0,0 +1,75 @@
+#ifndef MQTT_CLIENT_H
+#define MQTT_CLIENT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+#include "PayloadStream.h"
+
+#define MQTT_KEEPALIVE_SEC 60
+#define MQTT_RESPONSE_TIMEOUT_MS 10000  // CONNACK / PUBACK wait, as the HTTP timeout
+#define MQTT_SCRATCH_SIZE 256           // CONNECT packet, PUBLISH header, copy buffer
+
+/**
+ * Minimal MQTT 3.1.1 publisher for uploads: QoS 1 PUBLISH with a persistent session
+ * (clean session off, client ID = device ID), so the broker keeps an unacknowledged
+ * message across a reconnect and a resend goes out with DUP and the same packet ID.
+ *
+ * The body is copied from a PayloadStream through the scratch buffer, so memory use
+ * does not depend on the payload size. Calls block for at most
+ * MQTT_RESPONSE_TIMEOUT_MS; poll() keeps an idle connection alive.
+ */
+class MqttClient {
+   public:
+    enum class Result : uint8_t {
+        ACKED,         // Broker sent PUBACK for the packet
+        WRITE_FAILED,  // Connection lost while sending
+        TIMEOUT        // No PUBACK in time (the message stays in flight)
+    };
+
+    MqttClient();
+
+    /**
+     * Open the socket (TCP or TLS, per the client passed) and send CONNECT
+     * @return true once the broker accepted the connection
+     */
+    bool connect(WiFiClient& transport, const char* host, uint16_t port, const char* clientId,
+                 const char* username, const char* password);
+
+    bool connected();
+
+    // Broker resumed a stored session on the last connect
+    bool sessionPresent() const { return session; }
+
+    /**
+     * Publish a body and wait for its PUBACK
+     * @param body Begun stream, read from the start
+     * @param resend Resend the in-flight packet ID with DUP set instead of a new one
+     */
+    Result publish(const char* topic, PayloadStream& body, bool resend);
+
+    // Send PINGREQ on an idle connection and drop broker packets; call while idle
+    void poll();
+
+    // Close the socket without DISCONNECT, so the broker keeps the session
+    void stop();
+
+   private:
+    WiFiClient* client;
+    bool session;
+    uint16_t nextPacketId;
+    uint16_t inFlightId;  // Packet ID of the last unacknowledged PUBLISH (0 = none)
+    unsigned long lastSendMs;
+    uint8_t scratch[MQTT_SCRATCH_SIZE];
+
+    bool writeAll(const uint8_t* data, size_t length);
+
+    /**
+     * Read one packet, keeping the first bodySize bytes of its body
+     * @return false on timeout or a lost connection
+     */
+    bool readPacket(uint8_t& header, uint8_t* body, size_t bodySize, unsigned long timeoutMs);
+    int readByte(unsigned long deadline);
+};
+
+#endif  // MQTT_CLIENT_H
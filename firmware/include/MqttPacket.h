@@ -0,0 +1,56 @@
+#ifndef MQTT_PACKET_H
+#define MQTT_PACKET_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * MQTT 3.1.1 control packet encoding for the packets the uploader sends: CONNECT,
+ * QoS 1 PUBLISH headers, PINGREQ and DISCONNECT. Builders write into a caller buffer
+ * and return the encoded size, or 0 if the packet does not fit.
+ */
+namespace MqttPacket {
+
+enum Type : uint8_t {
+    CONNECT = 1,
+    CONNACK = 2,
+    PUBLISH = 3,
+    PUBACK = 4,
+    PINGREQ = 12,
+    PINGRESP = 13,
+    DISCONNECT = 14
+};
+
+constexpr uint32_t MAX_REMAINING_LENGTH = 268435455;  // Four length bytes
+
+/**
+ * Encode the variable-length Remaining Length field
+ * @param out At least 4 bytes
+ * @return Bytes written (1-4), 0 if length exceeds MAX_REMAINING_LENGTH
+ */
+size_t encodeRemainingLength(uint32_t length, uint8_t* out);
+
+/**
+ * Build a CONNECT packet
+ * @param username Omitted when nullptr or empty
+ * @param password Omitted when nullptr or empty (only sent with a username)
+ * @param cleanSession false asks the broker to keep the session (and in-flight QoS 1
+ *                     messages) across disconnects
+ */
+size_t buildConnect(uint8_t* out, size_t size, const char* clientId, const char* username,
+                    const char* password, uint16_t keepAliveSec, bool cleanSession);
+
+/**
+ * Build the fixed header, topic and packet ID of a QoS 1 PUBLISH; the payloadLength
+ * payload bytes follow on the wire
+ * @param dup Set on a resend of an unacknowledged packet ID
+ */
+size_t buildPublishHeader(uint8_t* out, size_t size, const char* topic, uint16_t packetId,
+                          uint32_t payloadLength, bool dup);
+
+// Build a two-byte packet without variable header (PINGREQ, DISCONNECT)
+size_t buildEmpty(uint8_t* out, size_t size, Type type);
+
+}  // namespace MqttPacket
+
+#endif  // MQTT_PACKET_H
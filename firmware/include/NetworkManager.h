@@ -8,10 +8,55 @@
 #include <WiFiClientSecure.h>
 
 #include "ConfigManager.h"
+#include "GzipStream.h"
+#include "MqttClient.h"
+#include "PayloadStream.h"
+#include "ResponseScanner.h"
 #include "SystemStatusManager.h"
 #include "TimeManager.h"
+#include "UploadArena.h"
 #include "models/AveragedData.h"
+#include "models/BufferedBatch.h"
+#include "models/RadioPolicy.h"
+#include <atomic>
+
+#ifdef UNIT_TEST
 #include <vector>
+#endif
+
+// Bodies larger than this are sent gzip-compressed (Content-Encoding: gzip)
+#define GZIP_MIN_PAYLOAD_BYTES 4096
+
+// Uncompressed body size cap: larger backlogs are sent oldest-first over several uploads
+#define UPLOAD_MAX_PAYLOAD_BYTES 8192
+
+// Transient memory of one upload attempt (error text, the logged part of an error body)
+#define UPLOAD_ARENA_SIZE 1024
+
+// Leading bytes of a 4xx response body kept for the log; the rest is read and discarded
+#define RESPONSE_LOG_BYTES 256
+
+/**
+ * Outcome of an upload started with NetworkManager::startUpload()
+ */
+struct UploadResult {
+    bool success;           // Server answered 2xx
+    int httpCode;           // Last HTTP status, or a negative HTTPClient error
+    uint16_t backlogCount;  // Backlog windows in the last body sent (oldest first)
+    uint16_t ackedCount;    // Leading backlog windows the server confirmed (stored or seen)
+    bool currentAcked;      // Server confirmed the newest window
+    const AveragedData* current;  // Copy of the upload's newest window (nullptr if none);
+                                  // valid until the callback returns or starts an upload
+};
+
+/**
+ * Supplies the backlog to send; called again before every attempt because ring views
+ * are invalidated when windows are added or removed
+ */
+typedef BufferedBatch (*BacklogSource)(void* context);
+
+// Receives the result once an upload has succeeded or given up
+typedef void (*UploadCallback)(const UploadResult& result, void* context);
 
 // Registration result structure
 struct RegistrationResult {
@@ -20,18 +65,102 @@ struct RegistrationResult {
     bool shouldRetry;
 };
 
+// Receives the result of a registration sent ahead of an upload (see queueRegistration())
+typedef void (*UploadRegistrationCallback)(const RegistrationResult& result, void* context);
+
 class NetworkManager {
    public:
     NetworkManager(ConfigManager& configMgr, TimeManager& timeMgr, SystemStatusManager& statusMgr);
 
     void initialize();
+
+    /**
+     * Identity written once into columnar upload headers
+     * @param hardwareId MAC-based hardware ID
+     * @param bootId Boot UUID
+     * @param firmwareVersion Version string (must outlive the manager, e.g. a literal)
+     */
+    void setDeviceIdentity(const String& hardwareId, const String& bootId,
+                           const char* firmwareVersion);
+    /**
+     * Start associating with the configured network without waiting for it; progress,
+     * timeouts and reconnects are handled by checkConnection()
+     * @return false if no SSID is configured
+     */
     bool connectWiFi();
+
+    // true between the GOT_IP and DISCONNECTED events
     bool isConnected();
+
+    // Advance the WiFi state machine (connect timeout, reconnect backoff); call every loop()
     void checkConnection();
-    bool sendData(const std::vector<AveragedData>& dataList);
+
+    /**
+     * Set the idle radio state (see models/RadioPolicy.h). OFF drops the link and powers
+     * the radio down until the next connectWiFi(); a running upload holds ACTIVE power
+     * save and the idle state is restored when it finishes.
+     * @param mode MODEM_SLEEP or OFF (ACTIVE keeps the default power save)
+     */
+    void setRadioMode(RadioMode mode);
+    RadioMode getRadioMode() const { return radioMode; }
+
+    /**
+     * Upload the transmission backlog plus the window just closed, blocking until done
+     * @param backlog Oldest-first view of the buffered windows (read in place)
+     * @param current Newest window, sent after the backlog (may be nullptr)
+     * @return true on a 2xx response
+     */
+    bool sendData(const BufferedBatch& backlog, const AveragedData* current);
+
+    /**
+     * Start a non-blocking upload driven by processUpload(): one HTTP attempt per call,
+     * with the retry backoff waited out between calls instead of in delay()
+     * @param source Returns the backlog to send (re-read before each attempt); only the
+     *               oldest windows that fit UPLOAD_MAX_PAYLOAD_BYTES go in the body, see
+     *               UploadResult::backlogCount
+     * @param sourceContext Passed through to source
+     * @param current Newest window, copied and sent after the backlog (may be nullptr)
+     * @param onComplete Called once with the result (may be nullptr)
+     * @param callbackContext Passed through to onComplete
+     * @return false if an upload is already running, there is nothing to send, WiFi is
+     *         down or no endpoint is configured (onComplete is not called)
+     */
+    bool startUpload(BacklogSource source, void* sourceContext, const AveragedData* current,
+                     UploadCallback onComplete, void* callbackContext);
+
+    // Advance the running upload; call from every loop() pass
+    void processUpload();
+
+    /**
+     * Open the upload connection (DNS lookup, TCP and TLS handshake) ahead of a publish,
+     * so the next POST reuses it; blocks for up to PREWARM_CONNECT_TIMEOUT_MS
+     * @return true if a connection is open (already, or now)
+     */
+    bool prewarmConnection();
+
+    // Close the upload connection; the next request repeats the DNS, TCP and TLS setup
+    void closeConnection() { dropConnection(); }
+
+    bool isUploadBusy() const { return uploadState != UploadState::IDLE; }
+
+    // The radio is awake for this module: associating, or an upload is on the air
+    bool isRadioBusy() const {
+        return wifiState == WiFiState::CONNECTING || uploadState == UploadState::SENDING;
+    }
+
+    /**
+     * Check that the internet is reachable beyond the access point. A backend response
+     * within CONNECTIVITY_TTL_MS answers without a request; otherwise a generate_204 GET
+     * (up to 5 s) runs, and its result is cached for CONNECTIVITY_TTL_MS until the link
+     * changes or an upload fails.
+     */
+    bool verifyInternetConnectivity();
 
     // Public for unit testing
+#ifdef UNIT_TEST
     String formatJsonPayload(const std::vector<AveragedData>& dataList);
+#endif
+    String formatJsonPayload(const BufferedBatch& backlog, const AveragedData* current);
 
     // Registration endpoint derivation
     String getRegistrationEndpoint();
@@ -39,27 +168,212 @@ class NetworkManager {
     // Device registration
     RegistrationResult registerDevice(const String& payload);
 
+    /**
+     * Register on the upload path: the request goes out at the start of an upload
+     * attempt, on the keep-alive connection the batch is then posted on, so registration
+     * costs no handshake of its own. Once retryDelayMs has passed it is also sent on its
+     * own from the network task when no upload runs. Either way the caller's task never
+     * blocks on it. Safe from another task while nothing is queued (the call is ignored
+     * otherwise).
+     * @param payload Registration body (RegistrationManager::buildRegistrationPayload())
+     * @param onComplete Called on the network task with every result, retryable or not;
+     *                   the registration is no longer queued by then (may be nullptr)
+     * @param context Passed through to onComplete
+     * @param retryDelayMs 0: wait for the next upload attempt; otherwise the earliest send
+     * @return false if a registration is already queued
+     */
+    bool queueRegistration(const String& payload, UploadRegistrationCallback onComplete,
+                           void* context, unsigned long retryDelayMs = 0);
+    bool isRegistrationQueued() const { return registrationQueued.load(); }
+
    private:
+    static constexpr uint8_t MAX_UPLOAD_ATTEMPTS = 5;
+
+    static constexpr unsigned long WIFI_CONNECT_TIMEOUT_MS = 10000;
+    static constexpr unsigned long WIFI_FAST_CONNECT_TIMEOUT_MS = 5000;
+    static constexpr int32_t PREWARM_CONNECT_TIMEOUT_MS = 5000;
+    static constexpr int32_t HTTP_CONNECT_TIMEOUT_MS = 10000;
+    static constexpr unsigned long CONNECTIVITY_TTL_MS = 60000;
+
+    enum class WiFiState : uint8_t { IDLE, CONNECTING, CONNECTED, WAITING };
+    enum class UploadState : uint8_t { IDLE, SENDING, BACKOFF };
+
+    // Result of one HTTP attempt
+    enum class AttemptOutcome : uint8_t {
+        SUCCESS,
+        RETRY,   // Transport or server error: back off, counts as an attempt
+        RESEND,  // Fallback or reconnect: send again at once
+        FAILED   // Client error: give up
+    };
+
     ConfigManager& config;
     TimeManager& timeManager;
     SystemStatusManager& statusManager;
 
+    // One keep-alive connection serves uploads and registration on the same host
     WiFiClientSecure wifiClient;
+    WiFiClient plainClient;
     HTTPClient httpClient;
+    bool tlsConfigured;  // Trust settings applied to wifiClient
+    bool tlsValidating;  // tlsValidateServer value they were applied for
+
+    // Upload body serializer; a member so its scratch buffer stays off the loop task stack
+    PayloadStream payloadStream;
+    String hardwareId;
+    String bootId;
+    bool formatRejected;  // Server answered a columnar or CBOR upload with 400/415
+    GzipStream gzipStream;
+    bool compressBody;  // Current upload goes through gzipStream
+    bool gzipRejected;  // Server answered a gzip upload with 400/415
+    ResponseScanner responseScanner;  // Fields of the last response body, fixed-size
+
+    // Reset by each attempt; a member, so the block is reserved once with the manager
+    uint8_t uploadArenaStorage[UPLOAD_ARENA_SIZE];
+    UploadArena uploadArena;
+
+    // MQTT transport (Config::uploadTransport); separate sockets from the HTTP ones
+    WiFiClientSecure mqttSecureClient;
+    WiFiClient mqttPlainClient;
+    MqttClient mqttClient;
+
+    // Running upload (see startUpload())
+    UploadState uploadState;
+    BacklogSource uploadSource;
+    void* uploadSourceContext;
+    UploadCallback uploadCallback;
+    void* uploadCallbackContext;
+    AveragedData uploadCurrent;
+    bool uploadHasCurrent;
+    uint8_t uploadAttempt;
+    bool uploadInsecure;  // HTTPS attempts used up, trying the plain HTTP fallback
+    unsigned long uploadWaitStart;
+    unsigned long uploadWaitMs;
+    int uploadHttpCode;
+    uint16_t uploadBacklogCount;
+    uint16_t uploadAckedCount;
+    bool uploadCurrentAcked;
+    SystemStatus uploadStatus;  // Health snapshot the current body is built from
+
+    // Registration riding on the next upload (see queueRegistration()); the payload and
+    // callback belong to the network task while the flag is set
+    String registrationPayload;
+    UploadRegistrationCallback registrationCallback;
+    void* registrationCallbackContext;
+    unsigned long registrationQueuedAt;
+    unsigned long registrationDelayMs;
+    std::atomic<bool> registrationQueued;
 
+    // Queued, and its retry delay (if any) has passed
+    bool registrationDue() const;
+
+    /**
+     * Send the queued registration and hand its result to the callback
+     * @param snap Snapshot the surrounding upload attempt holds
+     */
+    void sendQueuedRegistration(const ConfigSnapshot& snap);
+    RegistrationResult registerDevice(const String& payload, const ConfigSnapshot& snap);
+
+    // Event-driven WiFi link (see checkConnection())
+    WiFiState wifiState;
+    volatile bool linkUp;       // Written by the WiFi event task
+    volatile bool linkDropped;  // Disconnect event since the last association started
+    unsigned long wifiStateSince;
+    unsigned long reconnectDelayMs;
+    unsigned long connectStartMs;  // Start of the current connect, for time-to-connected
+    bool usingFastConnect;         // Current association targets the cached BSSID/channel
     uint8_t reconnectAttempts;
-    unsigned long lastReconnectAttempt;
+    RadioMode radioMode;
 
-    bool verifyInternetConnectivity();
+    // WiFi power save for the idle state, or ACTIVE while an upload runs
+    void applyPowerSave();
+
+    // Cached connectivity verdict (see verifyInternetConnectivity())
+    bool connectivityKnown;
+    bool connectivityOk;
+    unsigned long connectivityAtMs;
+
+    // Record proof of connectivity (backend answered, or the probe's result)
+    void noteConnectivity(bool ok);
+    void invalidateConnectivity() { connectivityKnown = false; }
+    void applyStaticIp(const Config& cfg);
+    void beginAssociation(const Config& cfg);
+    void scheduleReconnect(unsigned long now);
+#ifdef UNIT_TEST
     std::vector<String> parseAcknowledgedBatchIds(const String& response);
+#endif
+
+    /**
+     * Stream the response body of the current request through responseScanner
+     * @return false if the body was over RESPONSE_MAX_BYTES or cut short (the socket
+     *         then has unread data and must not be reused)
+     */
+    bool readResponse();
+
+    /**
+     * Read and discard the response body of the current request, keeping its first
+     * RESPONSE_LOG_BYTES as text in uploadArena
+     * @return The kept text ("" if the arena had no room)
+     */
+    const char* discardResponse();
+
+    // Match the IDs in responseScanner (acknowledged or duplicate) against the body sent
+    void matchAcknowledgements();
     unsigned long calculateBackoffDelay(uint8_t attempt);
+
+    /**
+     * Build the body for the next attempt from the upload's source
+     * @return false if a reading does not fit the scratch buffer
+     */
+    bool beginPayload(const Config& cfg);
+
+    AttemptOutcome attemptUpload(const String& endpoint, bool useHttps,
+                                 const ConfigSnapshot& snap);
+
+    /**
+     * Open the connection to the configured endpoint's host unless the kept-alive one is
+     * still up, timing the DNS lookup and the connect (NET_PHASE_DNS, NET_PHASE_CONNECT)
+     * @param useHttps TLS to the endpoint port, or plain HTTP (fallback or http:// endpoint)
+     * @return true if a connection is open
+     */
+    bool openConnection(bool useHttps, const ConfigSnapshot& snap, int32_t timeoutMs);
+
+    // Send the current body, timing NET_PHASE_REQUEST
+    int timedPost();
+
+    // readResponse() timed as NET_PHASE_RESPONSE, counting the body bytes received
+    bool timedReadResponse();
+
+    // One QoS 1 PUBLISH of the current body; a PUBACK confirms every reading in it
+    AttemptOutcome attemptMqttUpload(const ConfigSnapshot& snap);
+
+    // Go idle and report the result
+    void finishUpload(bool success);
+
+    // Decide on compression for the body just begun in payloadStream
+    void prepareCompression();
+
+    /**
+     * POST the prepared body from its first byte on the request begun by beginRequest()
+     * @return HTTP status code, or a negative HTTPClient error
+     */
+    int postPayload();
     bool sendDataWithProtocol(const String& endpoint, const String& payload, bool useHttps);
 
-    // Derive registration endpoint from configured API endpoint
-    String deriveEndpoint(const String& dataEndpoint);
+    /**
+     * Point httpClient at a URL over the persistent connection (opened on first use or
+     * after dropConnection())
+     * @return false if the URL could not be parsed
+     */
+    bool beginRequest(const String& url, bool useHttps, const Config& cfg);
+
+    // Close the connection after a transport error so the next request reconnects
+    void dropConnection();
+
+    // Apply the trust settings to wifiClient (a change closes the open connection)
+    void configureTls(const Config& cfg);
 
-    // Parse registration response and extract confirmation_id
-    bool parseRegistrationResponse(const String& response, String& confirmationId);
+    // Extract and validate confirmation_id from the response read by readResponse()
+    bool parseRegistrationResponse(String& confirmationId);
 };
 
 #endif  // NETWORK_MANAGER_H
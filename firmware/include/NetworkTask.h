@@ -0,0 +1,156 @@
+#ifndef NETWORK_TASK_H
+#define NETWORK_TASK_H
+
+#include <cstdint>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+#include "NetworkManager.h"
+#include "SpscRing.h"
+#include "models/AveragedData.h"
+#include "models/BufferedBatch.h"
+#include "models/PackedAveragedData.h"
+#include "models/RadioPolicy.h"
+
+/**
+ * NetworkTask runs the upload path in its own FreeRTOS task on PRO_CPU, the core the
+ * WiFi and lwIP tasks already use: upload steps (NetworkManager::processUpload()),
+ * the WiFi state machine, connection pre-warm and radio changes. TLS handshakes, DNS
+ * lookups and socket waits then never take CPU time from sampling and rendering,
+ * which run with loop() on APP_CPU.
+ *
+ * loop() stays the only task that touches DataManager. It copies the page to send
+ * into the task, so the ring may change while the upload runs, posts commands
+ * through one lock-free ring (SpscRing) and takes each upload's result from another;
+ * the task notifies the loop task when a result is queued, ending its idle wait.
+ * Beyond the rings, the two cores only share the config, which the task reads
+ * through published snapshots (SnapshotHold), and SystemStatusManager, which holds a
+ * spinlock around all of its fields.
+ *
+ * Until start() succeeds every command runs inline on the caller and poll() steps
+ * the NetworkManager, as loop() did before.
+ */
+class NetworkTask {
+   public:
+    static constexpr uint32_t STACK_SIZE = 8192;  // mbedTLS handshake and the body encoders
+    static constexpr uint8_t TASK_PRIORITY = 2;   // Below acquisition (3), above loop() (1)
+    static constexpr int8_t TASK_CORE = 0;        // PRO_CPU, with the WiFi stack
+    static constexpr uint32_t UPLOAD_POLL_MS = 10;  // processUpload() steps while one runs
+    static constexpr uint32_t IDLE_POLL_MS = 100;   // WiFi timeouts and reconnect backoff
+    static constexpr uint8_t COMMAND_QUEUE_LENGTH = 8;
+    static constexpr uint16_t PAGE_CAPACITY = 16;  // Windows per upload
+
+    explicit NetworkTask(NetworkManager& networkManager);
+    ~NetworkTask();
+
+    /**
+     * Start the network task. Call from the loop task (setup()): that task is the one
+     * notified of upload results.
+     * @return true if the task was created
+     */
+    bool start();
+
+    /**
+     * Stop the task; a running upload is abandoned without a result.
+     */
+    void stop();
+
+    /**
+     * Queue an upload of a copy of the oldest PAGE_CAPACITY windows of backlog
+     * (plus current); the result arrives through takeResult()
+     * @param backlog Oldest-first windows (only read during this call)
+     * @param current Newest window, sent after the backlog (may be nullptr)
+     * @return false if an upload is already in flight or the command ring is full
+     */
+    bool startUpload(const BufferedBatch& backlog, const AveragedData* current);
+
+    /**
+     * Take the result of the upload in flight without blocking
+     * @param out Receives the result; out.current stays valid until the next call
+     * @return true if the upload has finished (isUploadBusy() is false from here on)
+     */
+    bool takeResult(UploadResult& out);
+
+    /**
+     * @return The windows of the last upload started, oldest first (valid until the
+     *         next startUpload()); UploadResult::ackedCount counts from its start
+     */
+    BufferedBatch getSentPage() const { return {{{page, pageCount}, {nullptr, 0}}}; }
+
+    // Queued for the task: NetworkManager::prewarmConnection(), connectWiFi() and
+    // setRadioMode()
+    void prewarmConnection();
+    void connectWiFi();
+    void setRadioMode(RadioMode mode);
+
+    /**
+     * @return The radio mode last requested (the task applies it shortly after)
+     */
+    RadioMode getRadioMode() const;
+
+    /**
+     * Step the NetworkManager when the task is not running; a no-op otherwise.
+     * Call from every loop() pass.
+     */
+    void poll();
+
+    /**
+     * @return true from startUpload() until its result is taken
+     */
+    bool isUploadBusy() const { return uploadInFlight; }
+
+    /**
+     * @return true if the task is running
+     */
+    bool isRunning() const;
+
+   private:
+    enum class CommandType : uint8_t { START_UPLOAD, PREWARM, CONNECT_WIFI, SET_RADIO_MODE };
+
+    struct Command {
+        CommandType type;
+        RadioMode radioMode;  // SET_RADIO_MODE
+    };
+
+    // An upload's result with its own copy of the newest window
+    struct Completion {
+        UploadResult result;
+        AveragedData current;
+    };
+
+    NetworkManager& network;
+
+    // Upload in flight: written by loop() before START_UPLOAD is queued, then only
+    // read by the task until the result is taken
+    PackedAveragedData page[PAGE_CAPACITY];
+    uint16_t pageCount;
+    AveragedData pageCurrent;
+    bool pageHasCurrent;
+    bool uploadInFlight;
+    AveragedData takenCurrent;  // Loop side copy behind takeResult()'s out.current
+    RadioMode requestedRadioMode;
+
+#ifdef ARDUINO
+    StaticSpscRing<Command, COMMAND_QUEUE_LENGTH> commands;
+    StaticSpscRing<Completion, 2> results;
+    TaskHandle_t taskHandle;
+    TaskHandle_t resultHandle;  // Loop task, notified when a result is queued
+
+    static void taskEntry(void* arg);
+    void run();
+#endif
+
+    // Queue a command for the task, or run it here if the task is not running
+    bool post(const Command& command);
+    void execute(const Command& command);
+
+    static BufferedBatch pageSource(void* context);
+    static void onUploadComplete(const UploadResult& result, void* context);
+};
+
+#endif  // NETWORK_TASK_H
@@ -0,0 +1,112 @@
+#ifndef OUTBOUND_QUEUE_H
+#define OUTBOUND_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "models/OutboundQueueStats.h"
+#include "models/PackedAveragedData.h"
+
+/**
+ * OutboundQueue is an append-only, segment-rotated log of PackedAveragedData records on
+ * the LittleFS partition. The RAM transmission ring spills into it when full, so a long
+ * WiFi outage no longer discards the oldest windows.
+ *
+ * - Appends are staged in RAM and written WRITE_BATCH_RECORDS at a time to limit flash
+ *   wear; flush() forces the partial batch out (e.g. before deep sleep)
+ * - Records live in fixed-size segment files (<root>/<id>.seg); once every record of
+ *   the oldest segment is drained, the file is deleted
+ * - A persisted cursor (<root>/meta) marks the oldest undrained record. peek() reads
+ *   oldest-first from the cursor without consuming; commit() advances it after the
+ *   server accepted the upload
+ * - When all MAX_SEGMENTS are full the oldest segment is dropped
+ *
+ * Staged records that were never flushed are lost on reset.
+ */
+class OutboundQueue {
+   public:
+    static constexpr uint16_t RECORDS_PER_SEGMENT = 256;
+    static constexpr uint8_t MAX_SEGMENTS = 16;  // 4096 windows, ~400 KB
+    static constexpr uint8_t WRITE_BATCH_RECORDS = 8;
+
+    /**
+     * @param rootDir Directory for segment and cursor files (no trailing slash)
+     */
+    explicit OutboundQueue(const char* rootDir = "/outq");
+
+    /**
+     * Mount the filesystem and recover the cursor and segment layout
+     * @return false if the filesystem is unavailable (append() then fails)
+     */
+    bool begin();
+
+    /**
+     * Queue one record (staged; written when a batch fills)
+     * @return false if the queue is not ready or the flash write failed
+     */
+    bool append(const PackedAveragedData& record);
+
+    /**
+     * Write any staged records to flash
+     * @return false if a flash write failed (records stay staged)
+     */
+    bool flush();
+
+    /**
+     * Copy the oldest undrained records without consuming them
+     * @param out Destination array
+     * @param maxRecords Capacity of out
+     * @return Number of records copied (flashed records first, then staged ones)
+     */
+    uint16_t peek(PackedAveragedData* out, uint16_t maxRecords);
+
+    /**
+     * Consume the oldest records after they were uploaded
+     * @param count Number of records returned by the preceding peek()
+     */
+    void commit(uint16_t count);
+
+    uint32_t size() const;
+    bool isEmpty() const { return size() == 0; }
+    bool isReady() const { return ready; }
+    OutboundQueueStats getStats() const;
+
+    /**
+     * OverflowSink adapter for DataManager::setOverflowSink()
+     * @param context OutboundQueue instance
+     */
+    static bool spill(const PackedAveragedData& record, void* context);
+
+   private:
+    char root[24];
+    bool ready;
+
+    // Segment files firstSegment .. firstSegment + segmentCount - 1; all but the last
+    // hold RECORDS_PER_SEGMENT records
+    uint32_t firstSegment;
+    uint16_t segmentCount;
+    uint16_t lastSegmentRecords;
+    uint16_t readOffset;  // Drained records in the first segment
+
+    PackedAveragedData staged[WRITE_BATCH_RECORDS];
+    uint8_t stagedCount;
+
+    OutboundQueueStats stats;
+
+    uint32_t flashedRecords() const;
+    void segmentPath(uint32_t id, char* path, size_t size) const;
+    bool startSegment();
+    void dropFirstSegment();
+    bool saveMeta();
+    void resetLayout();
+
+    // Filesystem primitives (LittleFS on device, stdio on the host)
+    bool mountFs();
+    long fileSize(const char* path) const;
+    bool appendFile(const char* path, const void* data, size_t len);
+    size_t readFile(const char* path, size_t offset, void* data, size_t len) const;
+    bool writeFile(const char* path, const void* data, size_t len);
+    void removeFile(const char* path);
+};
+
+#endif  // OUTBOUND_QUEUE_H
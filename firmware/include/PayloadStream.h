@@ -0,0 +1,144 @@
+#ifndef PAYLOAD_STREAM_H
+#define PAYLOAD_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Stream.h>
+#endif
+
+#include "models/AveragedData.h"
+#include "models/BufferedBatch.h"
+#include "models/PayloadFormat.h"
+#include "models/SystemStatus.h"
+
+// The largest fragment, the health block (~1.7 KB with full latency, loop, task and boot
+// phase figures), must fit
+#define PAYLOAD_SCRATCH_SIZE 2048
+
+/**
+ * PayloadStream serializes an upload body one fragment at a time into a fixed
+ * scratch buffer, so HTTPClient::sendRequest() can copy it straight to the socket:
+ * - fragment 0 is the envelope header, then one fragment per reading (backlog oldest
+ *   first, packed records expanded into a single copy), then the footer
+ * - PayloadFormat::COLUMNAR instead writes the "columnar-v1" schema: device identity
+ *   once, one array per field with one fragment per cell, a sensor_mask column in
+ *   place of per-reading status objects
+ * - PayloadFormat::CBOR writes the same columnar map as CBOR items (float32 values,
+ *   shortest-form integers), so a decoder can reuse the columnar field names
+ * - the health block is a top-level member after the readings, written only while
+ *   SystemStatus::metricsDue is set, so most uploads carry data alone
+ * - contentLength() comes from a dry pass over the same fragments, so the request
+ *   carries a Content-Length instead of a chunked body
+ * - rewind() restarts the body for a retry without re-reading anything else
+ *
+ * Memory use is sizeof(PayloadStream) no matter how many readings are sent. The
+ * backlog view, identity strings and status must stay valid while the stream is read.
+ */
+class PayloadStream
+#ifdef ARDUINO
+    : public Stream
+#endif
+{
+   public:
+    PayloadStream();
+
+    /**
+     * Set the identity fields of the columnar header (kept across begin() calls)
+     * @param hardwareId MAC address (AA:BB:CC:DD:EE:FF)
+     * @param bootId UUID generated at boot
+     * @param firmwareVersion FIRMWARE_VERSION string
+     */
+    void setIdentity(const char* hardwareId, const char* bootId, const char* firmwareVersion);
+
+    /**
+     * Point the stream at a new body and measure it
+     * @param backlog Oldest-first view of the buffered windows (read in place)
+     * @param current Newest window, sent after the backlog (may be nullptr)
+     * @param deviceId Device ID for the envelope and each reading
+     * @param status Health block source (written when metricsDue is set)
+     * @param format Body schema
+     */
+    void begin(const BufferedBatch& backlog, const AveragedData* current, const char* deviceId,
+               const SystemStatus& status, PayloadFormat format = PayloadFormat::ROWS);
+
+    // Restart from the first byte (e.g. before a retry)
+    void rewind();
+
+    size_t contentLength() const { return totalLength; }
+    uint16_t readingCount() const { return total; }
+    PayloadFormat getFormat() const { return format; }
+
+    // Content-Type header for the current format
+    const char* contentType() const {
+        return format == PayloadFormat::CBOR ? "application/cbor" : "application/json";
+    }
+
+    // A fragment did not fit the scratch buffer; the body would be truncated
+    bool overflowed() const { return overflow; }
+
+    /**
+     * Copy the next bytes of the body
+     * @return Bytes copied (0 once the body is complete)
+     */
+    size_t readBytes(char* buffer, size_t length);
+    size_t readBytes(uint8_t* buffer, size_t length) {
+        return readBytes(reinterpret_cast<char*>(buffer), length);
+    }
+
+    // Stream interface (available() is the buffered fragment, 0 at the end)
+    int available();
+    int read();
+    int peek();
+    size_t write(uint8_t) { return 0; }
+    void flush() {}
+
+    /**
+     * Format one reading object (no leading separator)
+     * @return Length written, or capacity if the reading did not fit
+     */
+    static size_t formatReading(char* buffer, size_t capacity, const AveragedData& data,
+                                const char* deviceId);
+
+    /**
+     * Format the health block as a top-level member: ,"health":{...}
+     * @return Length written, or capacity if it did not fit
+     */
+    static size_t formatMetrics(char* buffer, size_t capacity, const SystemStatus& status);
+
+    // {"device_id":"...","readings":[
+    static size_t formatHeader(char* buffer, size_t capacity, const char* deviceId);
+
+   private:
+    BufferedBatch backlog;
+    const AveragedData* current;
+    const char* deviceId;
+    const char* hardwareId;
+    const char* bootId;
+    const char* firmwareVersion;
+    const SystemStatus* status;
+    PayloadFormat format;
+    uint16_t total;  // Readings in the body
+
+    // 0 = header, then readings (rows) or cells (columnar), then the footer
+    uint32_t nextFragment;
+    size_t totalLength;
+    bool overflow;
+
+    char scratch[PAYLOAD_SCRATCH_SIZE];
+    size_t scratchLength;
+    size_t scratchPos;
+    AveragedData unpacked;  // Expanded copy of the backlog record being formatted
+
+    // Backlog record (expanded into unpacked) or the current window
+    const AveragedData& readingAt(uint16_t index);
+
+    /**
+     * Format the next fragment into the scratch buffer
+     * @return false once the footer has been produced
+     */
+    bool fillNext();
+};
+
+#endif  // PAYLOAD_STREAM_H
@@ -52,7 +52,7 @@ static const uint8_t ONEWIRE_PIN = 4;  // GPIO4 - OneWire Data
 static const uint8_t SOIL_MOISTURE_PIN = 32;  // GPIO32 - ADC1_CH4
 
 // Alternative ADC1 pins if GPIO32 is unavailable:
-// GPIO33 (ADC1_CH5), GPIO34 (ADC1_CH6), GPIO35 (ADC1_CH7),
+// GPIO34 (ADC1_CH6), GPIO35 (ADC1_CH7),
 // GPIO36 (ADC1_CH0), GPIO39 (ADC1_CH3)
 
 static const adc_attenuation_t ADC_ATTENUATION = ADC_11db;   // 0-3.3V range
@@ -82,6 +82,10 @@ static const uint8_t TFT_RST_PIN = 15;  // GPIO15 - Reset
 // Optional TFT backlight control
 static const uint8_t TFT_BL_PIN = 27;  // GPIO27 - Backlight (PWM capable)
 
+// Touch controller interrupt (FT6236/CST816/GT911 INT or XPT2046 PENIRQ, active low)
+// Touch input is interrupt driven; the controller bus is never polled while idle
+static const uint8_t TOUCH_IRQ_PIN = 33;  // GPIO33 - Touch IRQ (internal pull-up)
+
 // ============================================================================
 // Pin Usage Summary
 // ============================================================================
@@ -96,6 +100,7 @@ static const uint8_t TFT_BL_PIN = 27;  // GPIO27 - Backlight (PWM capable)
 // GPIO23 - TFT MOSI (SPI)
 // GPIO27 - TFT Backlight
 // GPIO32 - Soil Moisture (ADC1_CH4)
+// GPIO33 - Touch IRQ
 //
 // Reserved/Avoided Pins:
 // GPIO0  - Boot mode (pulled high, avoid)
@@ -107,7 +112,7 @@ static const uint8_t TFT_BL_PIN = 27;  // GPIO27 - Backlight (PWM capable)
 // GPIO25-27 - ADC2 (conflicts with WiFi)
 //
 // Safe for future expansion:
-// GPIO13, GPIO14, GPIO16, GPIO17, GPIO25, GPIO26, GPIO33-39
+// GPIO13, GPIO14, GPIO16, GPIO17, GPIO25, GPIO26, GPIO34-39
 // (Note: GPIO34-39 are input-only, no pull-up/pull-down)
 
 // ============================================================================
@@ -0,0 +1,38 @@
+#ifndef POWER_LOCK_H
+#define POWER_LOCK_H
+
+#include <stdint.h>
+
+/**
+ * PowerLock holds the CPU at full speed and out of automatic light sleep while a
+ * bus transfer or upload is in flight, once PowerManager::configureAutoPowerSave() has
+ * turned on ESP-IDF power management (DVFS, and auto light sleep where the core
+ * supports tickless idle). Light sleep stops the I2C, OneWire and SPI clocks mid-transfer
+ * and TFT_eSPI drives SPI registers directly, so these drivers cannot take IDF's own
+ * locks; WiFi and lwIP manage theirs.
+ *
+ * Acquisitions count, so tasks hold the lock independently; every acquire() needs a
+ * release(). Before power management is configured (and on the host) both are no-ops.
+ */
+class PowerLock {
+   public:
+    /**
+     * Create the locks (called by PowerManager once esp_pm is configured)
+     * @return true if both locks were created
+     */
+    static bool begin();
+
+    static void acquire();
+    static void release();
+
+    // esp_pm is configured and the locks exist
+    static bool isEnabled();
+
+    /**
+     * Time with at least one acquisition outstanding, for energy accounting
+     * @return Milliseconds held since the previous call (0 while not enabled)
+     */
+    static uint32_t takeHeldMs();
+};
+
+#endif  // POWER_LOCK_H
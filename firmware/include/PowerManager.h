@@ -7,33 +7,78 @@
 #include <Arduino.h>
 
 #include <driver/adc.h>
+#include <esp_adc_cal.h>
 #include <esp_sleep.h>
+#include <esp_timer.h>
 #else
 // Mock for unit testing
 #define ADC1_CHANNEL_0 0
 #define ADC_ATTEN_DB_11 0
 #endif
 
+#include "BatteryMonitor.h"
+#include "EnergyMeter.h"
+#include "models/EnergyProfile.h"
+
 class PowerManager {
    public:
     PowerManager();
 
+    /**
+     * Characterize the battery ADC from eFuse, take the first battery sample and start
+     * the background sampling timer (BATTERY_SAMPLE_PERIOD_MS)
+     */
     void initialize();
 
+    /**
+     * Hand idle power to ESP-IDF power management: DVFS between PM_MIN_FREQ_MHZ and
+     * PM_MAX_FREQ_MHZ, plus automatic light sleep in tickless idle when requested and
+     * the core supports it. Bus work holds PowerLock meanwhile.
+     * @param lightSleep Also light sleep whenever every task is idle
+     * @return false if esp_pm is not available (the CPU stays at its boot frequency)
+     */
+    bool configureAutoPowerSave(bool lightSleep);
+
+    // Idle tasks light sleep on their own; no manual enterLightSleep() needed
+    bool isAutoLightSleepEnabled() const;
+
     // Light sleep mode - sleep between sensor readings
     void enterLightSleep(uint32_t durationMs);
 
     // Deep sleep mode - sleep with state persistence
     void enterDeepSleep(uint32_t durationMs);
 
-    // Battery voltage monitoring
+    // This boot is the timer or ULP wakeup of an enterDeepSleep() (not a power-on or reset)
+    bool wokeFromDeepSleep() const;
+
+    // Battery voltage monitoring: cached, filtered estimate (no ADC read per call)
     float readBatteryVoltage();
     bool isBatteryLow();
     uint8_t getBatteryPercentage();
+    BatteryLevel getBatteryLevel();
 
     // Adaptive interval adjustment based on battery level
     uint32_t getAdaptiveReadingInterval(uint32_t baseIntervalMs);
 
+    /**
+     * Charge the time since the previous call to the states sampled now. CPU time splits
+     * into light sleep (measured by enterLightSleep() and accountAutoSleep()), PowerLock
+     * hold time at full speed, and the rest at the DVFS minimum. The first call only
+     * sets the baseline.
+     * @param nowMs millis()
+     * @param sample Radio state, backlight duty and cumulative traffic and sensor time
+     */
+    void accountEnergy(uint32_t nowMs, const EnergySample& sample);
+
+    /**
+     * Count loop() idle time under automatic light sleep as sleep
+     * @param ms Time the loop spent in delay()
+     */
+    void accountAutoSleep(uint32_t ms);
+
+    EnergyMeter& getEnergyMeter() { return energy; }
+    EnergyReport getEnergyReport() const { return energy.getReport(); }
+
     // Display power management
     void setDisplayLowPowerMode(bool enabled);
     bool isDisplayLowPowerMode() const;
@@ -48,16 +93,33 @@ class PowerManager {
    private:
     bool powerManagementEnabled;
     bool displayLowPowerMode;
+    bool autoLightSleep;
 
-    // Battery monitoring
-    static constexpr float BATTERY_LOW_THRESHOLD = 3.3f;       // Volts
-    static constexpr float BATTERY_CRITICAL_THRESHOLD = 3.0f;  // Volts
-    static constexpr float BATTERY_FULL_VOLTAGE = 4.2f;        // Volts (Li-ion)
-    static constexpr float BATTERY_EMPTY_VOLTAGE = 3.0f;       // Volts
+    // DVFS range (APB stays at 80 MHz across it, so bus clocks do not change)
+    static constexpr int PM_MAX_FREQ_MHZ = 240;
+    static constexpr int PM_MIN_FREQ_MHZ = 80;
+    static constexpr int UART_WAKEUP_THRESHOLD = 3;  // RX edges that wake from light sleep
 
     // ADC configuration for battery monitoring
-    static constexpr int BATTERY_ADC_PIN = 35;          // GPIO35 (ADC1_CH7)
-    static constexpr float ADC_VOLTAGE_DIVIDER = 2.0f;  // Voltage divider ratio
+    static constexpr int BATTERY_ADC_PIN = 35;             // GPIO35 (ADC1_CH7)
+    static constexpr float ADC_VOLTAGE_DIVIDER = 2.0f;     // Voltage divider ratio
+    static constexpr uint32_t ADC_DEFAULT_VREF_MV = 1100;  // Used when eFuse holds no Vref
+
+    // Background battery sampling (the cell voltage moves over minutes, not seconds)
+    static constexpr uint32_t BATTERY_SAMPLE_PERIOD_MS = 10000;
+    static constexpr uint8_t BATTERY_SAMPLE_BURST = 16;  // Raw reads averaged per sample
+
+    BatteryMonitor battery;
+
+    // Energy accounting (loop() only)
+    static constexpr uint32_t WIFI_TX_BYTES_PER_MS = 250;  // ~2 Mbit/s effective airtime
+
+    EnergyMeter energy;
+    bool energyStarted;
+    uint32_t lastEnergyMs;
+    uint32_t lastBytesSent;
+    uint32_t lastSensorBusyMs;
+    uint32_t pendingSleepMs;  // Light sleep not yet charged
 
     // Adaptive interval multipliers based on battery level
     static constexpr float INTERVAL_MULTIPLIER_NORMAL = 1.0f;
@@ -65,6 +127,17 @@ class PowerManager {
     static constexpr float INTERVAL_MULTIPLIER_CRITICAL = 4.0f;
 
     float calculateVoltageFromADC(uint16_t adcValue);
+
+#ifdef ARDUINO
+    esp_adc_cal_characteristics_t adcCharacteristics;
+    bool adcCalibrated;
+    esp_timer_handle_t batteryTimer;
+    portMUX_TYPE batteryMux;  // The timer task writes the estimate, loop() reads it
+
+    // Average a burst of raw reads into one calibrated sample for the monitor
+    void sampleBattery();
+    static void batteryTimerCallback(void* arg);
+#endif
 };
 
 #endif  // POWER_MANAGER_H
@@ -29,7 +29,20 @@ class RegistrationManager {
     bool registerDevice(const String& hardwareId, const String& bootId, const String& friendlyName,
                         const String& firmwareVersion);
 
-    // Background retry task (called from main loop or separate FreeRTOS task)
+    /**
+     * Register with the first data upload instead of in an exchange of its own: the
+     * request shares that upload's connection, and its retries follow the upload attempts
+     * (see NetworkManager::queueRegistration())
+     * @return false if a registration is already queued
+     */
+    bool registerWithNextUpload(const String& hardwareId, const String& bootId,
+                                const String& friendlyName, const String& firmwareVersion);
+
+    /**
+     * Hand a scheduled retry to the network task if it could not be queued when it was
+     * scheduled (another registration was queued then). Never blocks: the request itself
+     * runs on the network task, and its result comes back through the upload callback.
+     */
     void processRetries();
 
     // Calculate next retry delay with exponential backoff and jitter (public for testing)
@@ -40,9 +53,10 @@ class RegistrationManager {
     ConfigManager* _config;
 
     // Retry state
+    static constexpr int MAX_RETRIES = 5;
     int _retryCount;
-    unsigned long _nextRetryTime;
-    bool _retryPending;
+    unsigned long _retryDelayMs;  // Backoff of the retry waiting to be queued
+    bool _retryPending;           // A retry is scheduled but not yet queued on the network
 
     // Cached registration payload for retries
     String _cachedRegistrationPayload;
@@ -50,7 +64,13 @@ class RegistrationManager {
     // Validate confirmation ID format (UUID v4)
     bool isValidConfirmationId(const String& confirmationId);
 
-    // Queue a retry attempt
+    // Store the confirmation ID of a 2xx result; false if it is missing or invalid
+    bool acceptConfirmation(const RegistrationResult& result);
+
+    // Result of a registration sent by registerWithNextUpload() (network task)
+    static void onUploadRegistration(const RegistrationResult& result, void* context);
+
+    // Schedule the next retry on the network task, after calculateBackoff()
     void queueRetry();
 };
 
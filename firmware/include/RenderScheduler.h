@@ -0,0 +1,55 @@
+#ifndef RENDER_SCHEDULER_H
+#define RENDER_SCHEDULER_H
+
+#include <stdint.h>
+
+#define RENDER_DEFAULT_MAX_FPS 10
+#define RENDER_MAX_FPS_LIMIT 30
+#define RENDER_CLOCK_TICK_MS 1000             // Uptime and "last update" ages count seconds
+#define RENDER_LOW_POWER_CLOCK_TICK_MS 10000  // Clock-only refreshes in low power mode
+#define RENDER_LOW_POWER_MAX_FPS 1
+
+/**
+ * RenderScheduler decides when the display draws a frame. A frame is due when its inputs
+ * changed (the caller folds the sensor snapshot and status fields into one key), when a
+ * frame was requested (page change, graph span) or when the clock ticks; due frames are
+ * spaced at least 1/maxFps apart. Low power mode caps the rate at
+ * RENDER_LOW_POWER_MAX_FPS and slows the clock tick.
+ */
+class RenderScheduler {
+   public:
+    RenderScheduler();
+
+    /**
+     * Set the frame-rate cap
+     * @param fps Frames per second (0 = RENDER_DEFAULT_MAX_FPS, capped at
+     *            RENDER_MAX_FPS_LIMIT)
+     */
+    void setMaxFps(uint8_t fps);
+    uint8_t getMaxFps() const { return maxFps; }
+
+    void setLowPower(bool enabled) { lowPower = enabled; }
+
+    // Draw the next frame even if the inputs are unchanged
+    void requestFrame() { frameRequested = true; }
+
+    /**
+     * Check whether to draw now; a true return counts as the frame being drawn
+     * @param inputsKey Hash of everything the current page shows
+     * @param nowMs millis()
+     */
+    bool shouldRender(uint32_t inputsKey, unsigned long nowMs);
+
+    uint32_t getFramesRendered() const { return framesRendered; }
+
+   private:
+    uint8_t maxFps;
+    bool lowPower;
+    bool frameRequested;
+    bool rendered;  // lastKey and lastFrameMs are valid
+    uint32_t lastKey;
+    unsigned long lastFrameMs;
+    uint32_t framesRendered;
+};
+
+#endif  // RENDER_SCHEDULER_H
@@ -0,0 +1,52 @@
+#ifndef REPORT_DEADBAND_H
+#define REPORT_DEADBAND_H
+
+#include <stdint.h>
+
+#include "models/AveragedData.h"
+
+/**
+ * Per-sensor tolerances for report-by-exception (same units as the averages).
+ * A tolerance of 0 means any change of that sensor is reported.
+ */
+struct DeadbandTolerances {
+    float temperature;   // C, BME280 and DS18B20
+    float humidity;      // %
+    float pressure;      // hPa
+    float soilMoisture;  // %
+};
+
+/**
+ * ReportDeadband decides whether a closed averaging window is worth an upload. A window
+ * whose averages all stay within tolerance of the last reported window is dropped; the
+ * backend treats the missing windows as a gap in an unchanged series. Every
+ * heartbeatWindows-th window is reported regardless, so a stable node still checks in.
+ *
+ * The reference values and the run of dropped windows live in RTC slow memory, so the
+ * deadband carries across deep sleep; after power loss the first window is reported.
+ */
+class ReportDeadband {
+   public:
+    /**
+     * Apply the configuration (call at boot; keeps the RTC reference)
+     * @param tolerances Per-sensor deadbands; all 0 disables the deadband
+     * @param heartbeatWindows Report at least every this many windows (0 or 1 = every)
+     */
+    static void configure(const DeadbandTolerances& tolerances, uint8_t heartbeatWindows);
+
+    static bool isEnabled();
+
+    /**
+     * Check a closed window against the reference
+     * @return true to report it (it becomes the new reference), false to drop it
+     */
+    static bool shouldReport(const AveragedData& window);
+
+    // Windows dropped since the last reported one
+    static uint16_t getSuppressedRun();
+
+    // Forget the reference, so the next window is reported
+    static void reset();
+};
+
+#endif  // REPORT_DEADBAND_H
@@ -0,0 +1,103 @@
+#ifndef RESPONSE_SCANNER_H
+#define RESPONSE_SCANNER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <Stream.h>
+#endif
+
+// Fixed capacity for the IDs of one response; IDs past it are dropped (and resent later)
+#define RESPONSE_MAX_BATCH_IDS 32
+#define RESPONSE_BATCH_ID_SIZE 64     // Same as AveragedData::batchId
+#define RESPONSE_CONFIRMATION_SIZE 40  // UUID (36 chars) plus terminator
+#define RESPONSE_MAX_BYTES 4096       // Body bytes accepted before the scan gives up
+#define RESPONSE_KEY_SIZE 32
+
+/**
+ * ResponseScanner picks the fields the firmware needs out of a JSON response body as it
+ * streams in, without buffering the body or allocating:
+ * - string items of the top-level acknowledged_batch_ids and duplicate_batch_ids
+ *   arrays go into one fixed table (both mean the server has stored the window)
+ * - the top-level confirmation_id string of a registration response
+ *
+ * Everything else, including nested values, is skipped by a small tokenizer, so the
+ * cost is one pass over at most RESPONSE_MAX_BYTES. HTTPClient::writeToStream() feeds it
+ * the de-chunked body; write() refuses bytes past the cap, which aborts the transfer
+ * (the caller then drops the connection, as its remainder is still unread).
+ */
+class ResponseScanner
+#ifdef ARDUINO
+    : public Stream
+#endif
+{
+   public:
+    ResponseScanner();
+
+    // Forget the previous response
+    void reset();
+
+    /**
+     * Scan the next part of the body
+     * @return Bytes accepted (fewer than length once RESPONSE_MAX_BYTES is reached)
+     */
+    size_t write(const uint8_t* data, size_t length);
+    size_t write(uint8_t value) { return write(&value, 1); }
+
+    // true if the acknowledged_batch_ids key appeared (an empty list still counts)
+    bool hasAckList() const { return ackListSeen; }
+
+    uint16_t batchIdCount() const { return idCount; }
+    const char* batchId(uint16_t index) const { return ids[index]; }
+
+    // Linear search of the ID table
+    bool containsBatchId(const char* batchId) const;
+
+    bool hasConfirmationId() const { return confirmationSeen; }
+    const char* confirmationId() const { return confirmation; }
+
+    // More IDs than fit, an over-long string, or a body over the byte cap
+    bool truncated() const { return overflow; }
+
+    // Body bytes accepted since reset()
+    size_t bytesReceived() const { return bytesSeen; }
+
+    // Stream interface: the scanner is write-only
+    int available() { return 0; }
+    int read() { return -1; }
+    int peek() { return -1; }
+    void flush() {}
+
+   private:
+    enum class Field : uint8_t { NONE, ACKED, DUPLICATE, CONFIRMATION };
+    enum class Target : uint8_t { SKIP, KEY, BATCH_ID, CONFIRMATION };
+
+    char ids[RESPONSE_MAX_BATCH_IDS][RESPONSE_BATCH_ID_SIZE];
+    uint16_t idCount;
+    char confirmation[RESPONSE_CONFIRMATION_SIZE];
+    char key[RESPONSE_KEY_SIZE];
+    bool ackListSeen;
+    bool confirmationSeen;
+    bool overflow;
+    size_t bytesSeen;
+
+    // Tokenizer state
+    uint8_t depth;      // Open objects and arrays
+    bool expectingKey;  // Next string at depth 1 is a key
+    Field keyField;     // Field named by the last key at depth 1
+    Field arrayField;   // ID list the depth-2 strings belong to
+    bool inString;
+    bool escaped;
+    Target target;
+    char* text;         // Destination of the current string (nullptr when skipped)
+    size_t textSize;
+    size_t textLength;
+
+    void scan(char c);
+    void beginString();
+    void endString();
+    Field fieldForKey() const;
+};
+
+#endif  // RESPONSE_SCANNER_H
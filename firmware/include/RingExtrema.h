@@ -0,0 +1,78 @@
+#ifndef RING_EXTREMA_H
+#define RING_EXTREMA_H
+
+#include <stdint.h>
+
+/**
+ * RingExtrema tracks the minimum and maximum of a ring buffer column as entries are
+ * written and overwritten, using two monotonic deques of ring slots:
+ *
+ * - push(): amortized O(1); drops queued slots the new value dominates
+ * - evict(): O(1); call before the ring overwrites its oldest slot
+ * - range(): O(1) for the whole ring, O(log n) for a window ending at the newest entry
+ *
+ * The deques hold slot indices only (the values stay in the ring), in caller-provided
+ * storage of 2 x capacity slots so it can live next to the ring it describes. NaN
+ * values are never queued, so they do not affect the range.
+ */
+class RingExtrema {
+   public:
+    RingExtrema();
+
+    /**
+     * Bind deque storage for a ring and discard all entries
+     * @param storage Room for 2 * capacity slot indices
+     * @param capacity Ring size
+     */
+    void attach(uint16_t* storage, uint16_t capacity);
+
+    // Discard all entries, keeping the storage
+    void reset();
+
+    /**
+     * Queue a newly written ring slot
+     * @param minColumn Ring column the minimum is taken from
+     * @param maxColumn Ring column the maximum is taken from (may equal minColumn)
+     */
+    void push(uint16_t slot, const float* minColumn, const float* maxColumn);
+
+    // Forget a slot that is about to be overwritten (the oldest entry of a full ring)
+    void evict(uint16_t slot);
+
+    // Renumber the queued slots after the ring was rotated so that start became slot 0
+    void rebase(uint16_t start);
+
+    /**
+     * Minimum and maximum of the entries from a given age onwards
+     * @param start Ring slot of the oldest entry
+     * @param fromOffset Skip this many of the oldest entries
+     * @return false if no (non-NaN) entry lies in the window
+     */
+    bool range(const float* minColumn, const float* maxColumn, uint16_t start,
+               uint16_t fromOffset, float& minValue, float& maxValue) const;
+
+   private:
+    struct Deque {
+        uint16_t* slots;
+        uint16_t front;
+        uint16_t size;
+    };
+
+    Deque minQueue;
+    Deque maxQueue;
+    uint16_t capacity;
+
+    uint16_t& at(const Deque& queue, uint16_t i) const {
+        return queue.slots[(queue.front + i) % capacity];
+    }
+    void pushBack(Deque& queue, uint16_t slot, const float* column, bool keepMax);
+    void popFront(Deque& queue, uint16_t slot);
+
+    /**
+     * First queued entry at least fromOffset entries past start
+     * @return Index into the deque, or queue.size if none
+     */
+    uint16_t firstFrom(const Deque& queue, uint16_t start, uint16_t fromOffset) const;
+};
+
+#endif  // RING_EXTREMA_H
@@ -0,0 +1,67 @@
+#ifndef RTC_STATE_STORE_H
+#define RTC_STATE_STORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "models/PackedAveragedData.h"
+#include "models/SensorType.h"
+
+class DataManager;
+
+// RTC slow memory is 8 KB; the image below takes ~4.6 KB of it
+#define RTC_STATE_DATA_RECORDS 32
+#define RTC_STATE_DISPLAY_POINTS 60
+
+/**
+ * RtcStateStore keeps DataManager state in RTC slow memory (RTC_DATA_ATTR) across deep
+ * sleep, so a timer wakeup restores it with a memcpy instead of NVS flash reads and
+ * writes. RTC memory does not survive power loss, so a CRC32 over the image gates
+ * every restore and an invalid image means "fall back to NVS".
+ *
+ * Saved per sleep:
+ * - the newest RTC_STATE_DATA_RECORDS backlog windows plus the sequence and overflow
+ *   counters they continue from
+ * - the newest RTC_STATE_DISPLAY_POINTS 1-minute display points (coarse tiers are rebuilt
+ *   from them on restore; their ~9 KB of buckets do not fit, so 24 h / 7 d graphs need a
+ *   node that stays awake)
+ * - the display clock at sleep and the sleep duration, so restored graphs line up with
+ *   readings taken after millis() restarts
+ */
+class RtcStateStore {
+   public:
+    /**
+     * Write the image just before deep sleep
+     * @param dataManager State to save (its rings are rotated by the snapshot)
+     * @param nowMs Current monotonic time
+     * @param sleepDurationMs Planned timer wakeup
+     * @return false if the backlog did not fit; the windows older than the newest
+     *         RTC_STATE_DATA_RECORDS were left out and must be kept elsewhere
+     */
+    static bool save(DataManager& dataManager, uint32_t nowMs, uint32_t sleepDurationMs);
+
+    // Passed to restore() when the node slept for the full planned duration
+    static constexpr uint32_t SLEPT_AS_PLANNED = 0xFFFFFFFF;
+
+    /**
+     * Load a valid image into an empty DataManager and invalidate it
+     * @param dataManager Destination (call before the first reading)
+     * @param nowMs Current monotonic time
+     * @param sleptMs Time actually spent asleep, if something woke the node early
+     * @return false if there was no valid image (power-on or corrupted RTC memory)
+     */
+    static bool restore(DataManager& dataManager, uint32_t nowMs,
+                        uint32_t sleptMs = SLEPT_AS_PLANNED);
+
+    static bool hasValidImage();
+    static void invalidate();
+
+    // Counts of the last saved or restored image
+    static uint16_t getDataCount();
+    static uint16_t getDisplayCount();
+
+    // CRC-32 (IEEE 802.3)
+    static uint32_t crc32(const void* data, size_t length);
+};
+
+#endif  // RTC_STATE_STORE_H
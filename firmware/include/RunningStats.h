@@ -0,0 +1,99 @@
+#ifndef RUNNING_STATS_H
+#define RUNNING_STATS_H
+
+#include <math.h>
+#include <stdint.h>
+
+/**
+ * RunningStats keeps O(1) streaming aggregates for a single measurement:
+ * count, sum, min, max and Welford's running mean/M2 for the variance.
+ *
+ * The arithmetic mean is reported as sum / count so it matches a plain
+ * batch average exactly; the Welford terms are only used for the spread,
+ * where the naive sum-of-squares form loses precision on large offsets
+ * such as barometric pressure.
+ */
+struct RunningStats {
+    uint16_t count;
+    float sum;
+    float min;
+    float max;
+    float welfordMean;
+    float welfordM2;
+
+    void reset() {
+        count = 0;
+        sum = 0.0f;
+        min = 0.0f;
+        max = 0.0f;
+        welfordMean = 0.0f;
+        welfordM2 = 0.0f;
+    }
+
+    void add(float value) {
+        if (count == 0) {
+            min = value;
+            max = value;
+        } else {
+            if (value < min) {
+                min = value;
+            }
+            if (value > max) {
+                max = value;
+            }
+        }
+        count++;
+        sum += value;
+
+        float delta = value - welfordMean;
+        welfordMean += delta / count;
+        welfordM2 += delta * (value - welfordMean);
+    }
+
+    /**
+     * Fold in the aggregates of a disjoint set of samples (Chan's parallel update)
+     * @param other Stats of the other samples; its M2 may be 0 if only the range is known
+     */
+    void merge(const RunningStats& other) {
+        if (other.count == 0) {
+            return;
+        }
+        if (count == 0) {
+            *this = other;
+            return;
+        }
+        if (other.min < min) {
+            min = other.min;
+        }
+        if (other.max > max) {
+            max = other.max;
+        }
+        float total = (float)count + (float)other.count;
+        float delta = other.welfordMean - welfordMean;
+        welfordMean += delta * other.count / total;
+        welfordM2 += other.welfordM2 + delta * delta * count * other.count / total;
+        count += other.count;
+        sum += other.sum;
+    }
+
+    float mean() const {
+        return count ? sum / count : 0.0f;
+    }
+
+    /**
+     * Population variance of the samples seen since the last reset
+     * @return variance, or 0 when fewer than two samples were added
+     */
+    float variance() const {
+        if (count < 2 || welfordM2 < 0.0f) {
+            return 0.0f;
+        }
+        return welfordM2 / count;
+    }
+
+    float stddev() const {
+        return sqrtf(variance());
+    }
+};
+
+#endif  // RUNNING_STATS_H
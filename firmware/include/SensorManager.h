@@ -7,8 +7,12 @@
 #include <Arduino.h>
 #endif
 
+#include "RunningStats.h"
+#include "SlidingWindowFilter.h"
+#include "models/Bme280Profile.h"
 #include "models/SensorReadings.h"
 #include "models/SensorType.h"
+#include "models/SoilAggregate.h"
 
 // Forward declarations for sensor libraries
 #ifdef UNIT_TEST
@@ -16,13 +20,20 @@
 class Adafruit_BME280 {};
 class DallasTemperature {};
 class OneWire {};
+class SensorTrace;
 #else
 // Real hardware mode
 #include <Adafruit_BME280.h>
 #include <DallasTemperature.h>
 #include <OneWire.h>
+#include <esp_timer.h>
 #endif
 
+// Soil moisture background sampler
+#define SOIL_SAMPLE_RING_SIZE 32      // Raw ADC samples retained by the sampler (filter window cap)
+#define SOIL_SAMPLE_PERIOD_US 10000   // 100 Hz sampling rate
+#define DEFAULT_SOIL_SAMPLE_WINDOW 15  // Samples reduced per reading
+
 /**
  * SensorManager handles initialization and reading from all sensors:
  * - BME280: Temperature, humidity, pressure via I2C
@@ -38,8 +49,12 @@ class SensorManager {
      * Initialize all sensors with retry logic.
      * Attempts to initialize each sensor up to 3 times.
      * Sets sensor status bits for available sensors.
+     * @param warmStart Deep-sleep wake: reuse the probe results kept in RTC memory (BME280
+     *        address, DS18B20 ROM codes, which sensors are absent) instead of bus discovery,
+     *        retries and the test conversion; falls back to full probing if a cached sensor
+     *        no longer answers
      */
-    void initialize();
+    void initialize(bool warmStart = false);
 
     /**
      * Read all sensors and return readings structure.
@@ -50,6 +65,28 @@ class SensorManager {
      */
     SensorReadings readSensors();
 
+    /**
+     * Get the snapshot from the most recent readSensors() call.
+     * Cheap accessor for consumers that only need the latest values
+     * (display, status); does not touch any sensor bus. Safe to call from
+     * a different task than the one running readSensors().
+     * @return Copy of the last completed acquisition (zeroed before the first read)
+     */
+    SensorReadings getLatestReadings() const;
+
+    /**
+     * Check whether a snapshot is available.
+     * @return true once readSensors() has completed at least once
+     */
+    bool hasLatestReadings() const;
+
+    /**
+     * Service the asynchronous DS18B20 conversion.
+     * Collects the probe result once the conversion time has elapsed.
+     * Never blocks; safe to call on every loop iteration.
+     */
+    void update();
+
     /**
      * Check if a specific sensor is available.
      * @param type The sensor type to check
@@ -57,6 +94,12 @@ class SensorManager {
      */
     bool isSensorAvailable(SensorType type);
 
+    /**
+     * Get number of DS18B20 probes enumerated at initialize().
+     * @return Probe count (0..MAX_DS18B20_PROBES)
+     */
+    uint8_t getDS18B20ProbeCount() const;
+
     /**
      * Set calibration values for soil moisture sensor.
      * @param dryAdc ADC value when soil is dry (0% moisture)
@@ -64,6 +107,75 @@ class SensorManager {
      */
     void calibrateSoilMoisture(uint16_t dryAdc, uint16_t wetAdc);
 
+    /**
+     * Map a moisture percentage to the raw ADC reading under the current calibration
+     * (e.g. to give the ULP its threshold levels).
+     * @param percent Moisture in % (clamped to 0-100)
+     * @return Raw 12-bit ADC value
+     */
+    uint16_t soilPercentToRaw(float percent) const;
+
+    /**
+     * Convert a ULP sleep aggregate to moisture stats under the current calibration.
+     * The calibration is linear, so the mean maps directly; the within-sleep spread is
+     * unknown (no sum of squares) and left at 0, with min/max from the raw range.
+     * @param aggregate Raw ULP aggregate
+     * @param stats Receives the percentage stats (count 0 if the aggregate is empty)
+     */
+    void convertSoilAggregate(const SoilAggregate& aggregate, RunningStats& stats);
+
+    /**
+     * Select the BME280 acquisition profile.
+     * Applied immediately if the sensor is up, otherwise on initialize().
+     * @param profile Sampling mode / oversampling profile
+     */
+    void setBme280Profile(Bme280Profile profile);
+
+    /**
+     * Set per-sensor sampling schedules in units of readSensors() calls.
+     * A sensor with divisor N is sampled on every N-th call; in between its
+     * last value is carried forward and flagged in SensorReadings::staleMask.
+     * @param bme280Every Sample BME280 every N reads (0 or 1 = every read)
+     * @param ds18b20Every Sample DS18B20 every N reads
+     * @param soilEvery Sample soil moisture every N reads
+     */
+    void setSampleDivisors(uint16_t bme280Every, uint16_t ds18b20Every, uint16_t soilEvery);
+
+    /**
+     * Convert a per-sensor interval into a divisor of the base reading interval.
+     * @param sensorIntervalMs Desired sensor interval (0 = same as base)
+     * @param baseIntervalMs Base reading interval
+     * @return Divisor, rounded to the nearest whole base interval (minimum 1)
+     */
+    static uint16_t intervalToDivisor(uint32_t sensorIntervalMs, uint32_t baseIntervalMs);
+
+    /**
+     * Set the DS18B20 conversion resolution.
+     * Conversion wait time is derived from the resolution
+     * (9-bit: 94 ms, 10-bit: 188 ms, 11-bit: 375 ms, 12-bit: 750 ms).
+     * @param bits Resolution in bits (clamped to 9..12)
+     */
+    void setDS18B20Resolution(uint8_t bits);
+
+    /**
+     * Set the number of most recent ADC samples reduced into each soil reading.
+     * Samples are reduced with an interquartile (25% trimmed) mean so single
+     * spikes cannot skew the result.
+     * Values are clamped to 1..SOIL_SAMPLE_RING_SIZE.
+     * @param window Filter window in samples
+     */
+    void setSoilSampleWindow(uint8_t window);
+
+#ifdef UNIT_TEST
+    /**
+     * Replay a trace instead of the MockSensor constants (host soak tests).
+     * readSensors() looks values up by millis(); a sensor the trace marks missing reads
+     * as unavailable, as a bus that stopped answering would.
+     * @param trace Source (must outlive its use; nullptr restores the constants)
+     */
+    void setTrace(const SensorTrace* trace) { this->trace = trace; }
+#endif
+
    private:
     // Sensor library instances
     Adafruit_BME280 bme280;
@@ -77,13 +189,68 @@ class SensorManager {
     // Sensor status tracking (bitmask: 1 = available, 0 = unavailable)
     uint8_t sensorStatus;
 
+    // Snapshot of the last completed acquisition
+    SensorReadings latestReadings;
+    bool latestReadingsValid;
+
+    // Per-sensor sampling schedule (sample every N-th read)
+    uint16_t bme280Divisor;
+    uint16_t ds18b20Divisor;
+    uint16_t soilDivisor;
+    uint32_t readCycle;
+    bool isDue(uint16_t divisor, uint8_t cyclesAhead = 0) const;
+
+    // BME280 acquisition profile
+    Bme280Profile bme280Profile;
+
     // Private helper methods for BME280
+    void applyBme280Profile();
+    void readBME280(SensorReadings& readings);
     float readBME280Temperature();
     float readBME280Humidity();
     float readBME280Pressure();
 
+    // DS18B20 resolution and derived conversion time
+    uint8_t ds18b20Resolution;
+    uint16_t ds18b20ConversionTimeMs;
+
+    // DS18B20 probe ROM addresses, enumerated once at initialize()
+    uint8_t ds18b20Addresses[MAX_DS18B20_PROBES][8];
+    uint8_t ds18b20ProbeCount;
+
+    // DS18B20 asynchronous conversion state
+    bool ds18b20ConversionPending;
+    uint32_t ds18b20ConversionStartMs;
+    bool ds18b20HasValue;
+    float ds18b20LastTemps[MAX_DS18B20_PROBES];
+    uint32_t ds18b20LastReadMs;
+
     // Private helper methods for DS18B20
-    float readDS18B20Temperature();
+    void startDS18B20Conversion();
+    bool collectDS18B20Conversion();
+    void enumerateDS18B20Probes();
+
+    // Cold boot: probe the buses with retries, then cache the results in RTC memory
+    void probeSensors();
+    void saveProbes(uint8_t bme280Address);
+
+    // Deep-sleep wake: bring sensors up from the RTC probe cache
+    bool restoreProbes();
+
+    // Soil moisture sample window (filled incrementally from the esp_timer callback)
+    SlidingWindowFilter soilFilter;
+#ifdef UNIT_TEST
+    const SensorTrace* trace;
+#else
+    esp_timer_handle_t soilSampleTimer;
+    portMUX_TYPE soilSampleMux;
+    mutable portMUX_TYPE latestReadingsMux;  // Guards the snapshot across tasks
+#endif
+
+    // Soil sampler control
+    void startSoilSampler();
+    void stopSoilSampler();
+    static void soilSampleCallback(void* arg);
 
     // Private helper methods for soil moisture
     float readSoilMoisture();
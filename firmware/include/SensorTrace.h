@@ -0,0 +1,144 @@
+#ifndef SENSOR_TRACE_H
+#define SENSOR_TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef UNIT_TEST
+#include <vector>
+
+// ============================================================================
+// Trace-Replay Sensor Backend for Host Soak Tests
+// ============================================================================
+// SensorManager::setTrace() makes readSensors() return these values instead of
+// the MockSensor constants, looked up by the virtual clock (mockMillis). A test
+// can then run days of readings through DataManager and the payload encoders in
+// seconds.
+// ============================================================================
+
+#define TRACE_BINARY_MAGIC 0x31525453  // "STR1", little-endian at the start of a .trace file
+#define TRACE_CSV_LINE_MAX 160
+
+/**
+ * One recorded sensor sample
+ */
+struct TraceSample {
+    uint32_t timeMs;  // Offset from the start of the trace
+    float bme280Temp;
+    float humidity;
+    float pressure;
+    float ds18b20Temp;
+    uint16_t soilMoistureRaw;
+    uint8_t missingMask;  // SENSOR_*_BIT set: that sensor did not answer
+};
+
+/**
+ * Generated conditions, as a pure function of time (the same time gives the same
+ * values, so a replay is repeatable)
+ */
+struct SyntheticProfile {
+    float tempMeanC;
+    float tempSwingC;  // Half the day-night difference; warmest at 15:00
+    float humidityMeanPct;
+    float humiditySwingPct;  // Opposite phase to the temperature
+    float pressureMeanHpa;
+    float pressureSwingHpa;  // One weather front every 3 days
+    uint16_t soilWetRaw;     // ADC value straight after irrigation
+    uint16_t soilDryRaw;     // ADC value the soil dries towards
+    uint32_t irrigationIntervalMs;  // 0 = never irrigated (stays dry)
+    uint32_t dryingTimeMs;          // Time constant of the drying curve
+    float noise;                    // Uniform +/- noise on every value
+    uint32_t dropoutIntervalMs;     // BME280 stops answering once per interval (0 = never)
+    uint32_t dropoutMs;             // for this long
+    uint32_t seed;                  // Noise sequence
+};
+
+/**
+ * SensorTrace supplies sensor values by time, from a recorded trace or a synthetic
+ * profile.
+ *
+ * Recorded traces hold each sample until the next one. CSV has one sample per line:
+ *
+ *   time_ms,bme280_temp,humidity,pressure,ds18b20_temp,soil_raw
+ *   0,21.4,48.0,1012.6,19.8,2210
+ *   60000,21.5,,1012.6,19.8,2208
+ *
+ * An empty field marks that sensor as missing at that sample (any of the three BME280
+ * fields marks the BME280). A header line and lines starting with '#' are skipped.
+ * The binary form is TRACE_BINARY_MAGIC, a uint32 sample count and the samples, all
+ * little-endian; saveBinary() writes it from any loaded trace.
+ */
+class SensorTrace {
+   public:
+    SensorTrace();
+
+    /**
+     * Replace the trace with CSV text
+     * @param text Whole file, NUL-terminated
+     * @return false on a malformed line or a time going backwards (trace left empty)
+     */
+    bool loadCsv(const char* text);
+
+    /**
+     * Replace the trace with the binary form
+     * @return false on a bad magic or a truncated sample array (trace left empty)
+     */
+    bool loadBinary(const uint8_t* data, size_t length);
+
+    /**
+     * Load a .trace (binary) or CSV file, told apart by the magic
+     * @return false if the file cannot be read or parsed
+     */
+    bool loadFile(const char* path);
+
+    /**
+     * Write the recorded trace in the binary form
+     * @return false for a synthetic trace or a write error
+     */
+    bool saveBinary(const char* path) const;
+
+    // Generate values from a profile instead of a recording
+    void setSynthetic(const SyntheticProfile& profile);
+
+    // Mild climate, irrigation twice a day, a 10-minute BME280 dropout every 2 days
+    static SyntheticProfile defaultProfile();
+
+    // Start a recorded trace over after its last sample instead of holding it
+    void setLoop(bool loop) { looping = loop; }
+
+    // Virtual clock value that corresponds to trace time 0
+    void setStartMs(uint32_t startMs) { this->startMs = startMs; }
+
+    /**
+     * Values at a virtual time
+     * @param nowMs millis() of the read
+     * @param out Receives the sample (timeMs is the trace time it came from)
+     * @return false before the trace starts or while it is empty
+     */
+    bool sample(uint32_t nowMs, TraceSample& out) const;
+
+    size_t size() const { return samples.size(); }
+    bool isSynthetic() const { return synthetic; }
+
+    // Time of the last recorded sample (0 for a synthetic trace)
+    uint32_t durationMs() const { return samples.empty() ? 0 : samples.back().timeMs; }
+
+   private:
+    std::vector<TraceSample> samples;
+    SyntheticProfile profile;
+    bool synthetic;
+    bool looping;
+    uint32_t startMs;
+
+    void generate(uint32_t traceMs, TraceSample& out) const;
+
+    // Deterministic noise in [-1, 1] for one channel at one second of the trace
+    float noiseAt(uint32_t traceMs, uint8_t channel) const;
+
+    // Parse one CSV line; returns false if it is malformed
+    static bool parseCsvLine(const char* line, TraceSample& out);
+};
+
+#endif  // UNIT_TEST
+
+#endif  // SENSOR_TRACE_H
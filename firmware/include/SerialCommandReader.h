@@ -0,0 +1,76 @@
+#ifndef SERIAL_COMMAND_READER_H
+#define SERIAL_COMMAND_READER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <functional>
+
+#define SERIAL_MAX_COMMANDS 24
+#define SERIAL_LINE_CAPACITY 128  // Longer lines are dropped whole
+#define SERIAL_POLL_BUDGET 64     // Bytes taken from the UART per poll()
+
+// Command handler; args is the rest of the line after the command word (may be empty)
+typedef std::function<void(const char* args)> SerialCommandHandler;
+
+// Sees every line first (including empty ones); return true to consume it
+typedef std::function<bool(const char* line)> SerialLineFilter;
+
+/**
+ * SerialCommandReader is the console's only reader. poll() moves whatever the UART has
+ * received into a fixed line buffer without waiting, so a half-typed line costs nothing.
+ * Each complete line is trimmed and offered to the line filter (prompts, provisioning).
+ * Otherwise its first word selects a handler from the command table.
+ */
+class SerialCommandReader {
+   public:
+    SerialCommandReader();
+
+    /**
+     * Register a command
+     * @param name Command word (static string, matched exactly)
+     * @param handler Called with the arguments after the word
+     * @return false if the table is full
+     */
+    bool addCommand(const char* name, SerialCommandHandler handler);
+
+    void setLineFilter(SerialLineFilter filter) { lineFilter = filter; }
+
+    // Called with the whole line when no command matches
+    void setUnknownHandler(SerialCommandHandler handler) { unknownHandler = handler; }
+
+    // Drain up to SERIAL_POLL_BUDGET received bytes and dispatch complete lines
+    void poll();
+
+    /**
+     * Add one received character (exposed for host tests)
+     * @param c Byte from the UART; CR, LF or CRLF ends a line, backspace edits it
+     */
+    void feed(char c);
+
+    /**
+     * @return Lines dropped for exceeding SERIAL_LINE_CAPACITY
+     */
+    uint32_t getOverflowCount() const { return overflowCount; }
+
+   private:
+    struct Command {
+        const char* name;
+        SerialCommandHandler handler;
+    };
+
+    Command commands[SERIAL_MAX_COMMANDS];
+    uint8_t commandCount;
+    SerialLineFilter lineFilter;
+    SerialCommandHandler unknownHandler;
+
+    char line[SERIAL_LINE_CAPACITY];
+    size_t lineLength;
+    bool overflowed;  // Current line is too long; dropped at its end
+    bool lastWasCr;   // Swallow the LF of a CRLF
+    uint32_t overflowCount;
+
+    void dispatch();
+};
+
+#endif  // SERIAL_COMMAND_READER_H
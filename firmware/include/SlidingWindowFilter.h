@@ -0,0 +1,74 @@
+#ifndef SLIDING_WINDOW_FILTER_H
+#define SLIDING_WINDOW_FILTER_H
+
+#include <cstdint>
+
+/**
+ * SlidingWindowFilter keeps the last N raw samples both in arrival order and
+ * in sorted order, so robust statistics are available without re-sorting.
+ *
+ * - push(): O(log n) binary search plus a bounded shift (n <= MAX_WINDOW)
+ * - median(): O(1)
+ * - trimmedMean(k): O(k) using a running sum of the whole window
+ *
+ * Used on the soil moisture ADC path to reject single-sample spikes
+ * (e.g. from WiFi TX bursts) that would skew a plain mean.
+ */
+class SlidingWindowFilter {
+   public:
+    static constexpr uint8_t MAX_WINDOW = 32;
+
+    SlidingWindowFilter();
+
+    /**
+     * Set the window length and discard all samples.
+     * @param window Number of samples (clamped to 1..MAX_WINDOW)
+     */
+    void setWindow(uint8_t window);
+
+    /**
+     * Discard all samples, keeping the current window length.
+     */
+    void reset();
+
+    /**
+     * Add a sample; evicts the oldest sample once the window is full.
+     * @param sample Raw sample value
+     */
+    void push(uint16_t sample);
+
+    /**
+     * @return Number of samples currently held (0..window)
+     */
+    uint8_t size() const { return count; }
+
+    /**
+     * @return Configured window length
+     */
+    uint8_t getWindow() const { return window; }
+
+    /**
+     * @return Median of the window (mean of the two middle samples for even sizes), 0 if empty
+     */
+    uint16_t median() const;
+
+    /**
+     * Mean after discarding the lowest and highest trimEachSide samples.
+     * Falls back to the median when trimming would leave no samples.
+     * @param trimEachSide Samples dropped from each end of the sorted window
+     * @return Trimmed mean, 0 if empty
+     */
+    uint16_t trimmedMean(uint8_t trimEachSide) const;
+
+   private:
+    uint16_t fifo[MAX_WINDOW];    // Samples in arrival order (circular)
+    uint16_t sorted[MAX_WINDOW];  // Same samples in ascending order
+    uint8_t head;                 // Next FIFO write position (oldest sample when full)
+    uint8_t count;
+    uint8_t window;
+    uint32_t sum;  // Running sum of all samples in the window
+
+    uint8_t lowerBound(uint16_t value) const;
+};
+
+#endif  // SLIDING_WINDOW_FILTER_H
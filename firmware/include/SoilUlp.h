@@ -0,0 +1,45 @@
+#ifndef SOIL_ULP_H
+#define SOIL_ULP_H
+
+#include <stdint.h>
+
+#include "models/SoilAggregate.h"
+
+/**
+ * SoilUlp keeps sampling the soil moisture ADC during deep sleep on the ULP coprocessor,
+ * so a battery node sleeps through whole publish windows instead of waking for each
+ * reading. The ULP program runs from its own timer and accumulates count, a 32-bit sum
+ * and min/max of the raw readings in RTC slow memory. It wakes the main cores when:
+ *
+ * - the window is complete (windowSamples readings taken), or
+ * - a reading crosses soilMoistureThresholdLow/High into a different zone than the
+ *   previous one (low, inside, high), so alerts do not wait for the window
+ *
+ * The program is assembled at start() with the window size and thresholds as
+ * immediates. take() stops the ULP after the wake and hands the aggregate to
+ * DataManager::addSoilSamples() through SensorManager::convertSoilAggregate().
+ * Builds without ULP support (and the host) report start() as unavailable.
+ */
+class SoilUlp {
+   public:
+    /**
+     * Load and start the ULP program and enable ULP wakeup (call right before deep sleep)
+     * @param periodMs Interval between ULP readings
+     * @param windowSamples Readings that complete the window
+     * @param thresholdRawA Raw ADC level of one threshold
+     * @param thresholdRawB Raw ADC level of the other (order does not matter)
+     * @param lastRaw Last awake reading; sets the zone a crossing is measured from
+     * @return false if the ULP is not available or the program did not load
+     */
+    static bool start(uint32_t periodMs, uint16_t windowSamples, uint16_t thresholdRawA,
+                      uint16_t thresholdRawB, uint16_t lastRaw);
+
+    /**
+     * Stop the ULP and collect what it accumulated since start() (one-shot)
+     * @param aggregate Receives the raw aggregate
+     * @return false if the ULP was not started before this boot or took no readings
+     */
+    static bool take(SoilAggregate& aggregate);
+};
+
+#endif  // SOIL_ULP_H
@@ -0,0 +1,187 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+
+/**
+ * SpscRing is a fixed-capacity FIFO over caller-provided storage, safe without a lock
+ * between one producer task and one consumer task: the producer only writes the head,
+ * the consumer only writes the tail, and each publishes its side with a release store
+ * after touching the slot.
+ *
+ * The storage can live anywhere, so the same ring serves internal DRAM (an array
+ * member, see StaticSpscRing), PSRAM (a boot-time heap_caps_malloc block) or RTC slow
+ * memory (an RTC_DATA_ATTR array re-attached with its saved count after a wake). A ring
+ * over one column can index parallel columns through headSlot()/slotOf(), for
+ * structure-of-arrays histories.
+ *
+ * Methods are grouped by side. Those marked "owner only" move both ends and are for
+ * rings that one task produces and consumes, or while the other side is stopped.
+ */
+template <typename T>
+class SpscRing {
+   public:
+    SpscRing() : slots(nullptr), capacity(0), head(0), tail(0) {}
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * Use new storage (owner only)
+     * @param storage Room for capacity items
+     * @param count Items already in storage[0..count), oldest first (a restore)
+     */
+    void attach(T* storage, uint16_t capacity, uint16_t count = 0) {
+        slots = storage;
+        this->capacity = capacity;
+        tail.store(0, std::memory_order_relaxed);
+        head.store(count > capacity ? capacity : count, std::memory_order_release);
+    }
+
+    T* storage() const { return slots; }
+    uint16_t getCapacity() const { return capacity; }
+
+    // Items in the ring (exact on either side; a snapshot from anywhere else)
+    uint16_t size() const {
+        uint32_t count = head.load(std::memory_order_acquire) + 2u * capacity -
+                         tail.load(std::memory_order_acquire);
+        return static_cast<uint16_t>(count >= 2u * capacity ? count - 2u * capacity : count);
+    }
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() == capacity; }
+
+    // ---- Producer ----
+
+    /**
+     * Slot the next push() fills, to write in place before commit()
+     * @return nullptr if the ring is full
+     */
+    T* reserve() { return full() ? nullptr : &slots[headSlot()]; }
+
+    // Publish the slot returned by reserve()
+    void commit() {
+        head.store(advance(head.load(std::memory_order_relaxed), 1), std::memory_order_release);
+    }
+
+    // @return false if the ring is full (the item is not added)
+    bool push(const T& item) {
+        T* slot = reserve();
+        if (!slot) {
+            return false;
+        }
+        *slot = item;
+        commit();
+        return true;
+    }
+
+    // Storage index the next push() writes (for parallel columns)
+    uint16_t headSlot() const { return slotFor(head.load(std::memory_order_relaxed)); }
+
+    // ---- Consumer ----
+
+    // Oldest item, or nullptr when empty
+    T* front() { return empty() ? nullptr : &slots[tailSlot()]; }
+    const T* front() const { return empty() ? nullptr : &slots[tailSlot()]; }
+
+    // @return false when empty
+    bool pop(T& out) {
+        const T* oldest = front();
+        if (!oldest) {
+            return false;
+        }
+        out = *oldest;
+        drop(1);
+        return true;
+    }
+
+    // Discard the oldest items (at most size())
+    void drop(uint16_t count = 1) {
+        uint16_t available = size();
+        uint32_t position = tail.load(std::memory_order_relaxed);
+        tail.store(advance(position, count < available ? count : available),
+                   std::memory_order_release);
+    }
+
+    // Storage index of the oldest item
+    uint16_t tailSlot() const { return slotFor(tail.load(std::memory_order_relaxed)); }
+
+    // Storage index of the index-th oldest item
+    uint16_t slotOf(uint16_t index) const {
+        uint32_t slot = tailSlot() + index;
+        return static_cast<uint16_t>(slot >= capacity ? slot - capacity : slot);
+    }
+
+    // index-th oldest item (index < size())
+    T& at(uint16_t index) { return slots[slotOf(index)]; }
+    const T& at(uint16_t index) const { return slots[slotOf(index)]; }
+
+    // Items from the oldest up to the end of the storage (the first contiguous run)
+    uint16_t frontSpan() const {
+        uint16_t toEnd = capacity - tailSlot();
+        uint16_t count = size();
+        return count < toEnd ? count : toEnd;
+    }
+
+    // ---- Owner only ----
+
+    void clear() {
+        tail.store(0, std::memory_order_relaxed);
+        head.store(0, std::memory_order_release);
+    }
+
+    // Remove the newest items (after compacting survivors toward the tail)
+    void retract(uint16_t count) {
+        uint16_t kept = size() > count ? size() - count : 0;
+        head.store(advance(tail.load(std::memory_order_relaxed), kept), std::memory_order_release);
+    }
+
+    /**
+     * Rotate the storage so the oldest item sits at index 0 and the ring is one
+     * contiguous block
+     * @return Storage index the oldest item was at (0 if nothing moved)
+     */
+    uint16_t linearize() {
+        uint16_t start = tailSlot();
+        uint16_t count = size();
+        if (start != 0) {
+            std::rotate(slots, slots + start, slots + capacity);
+        }
+        tail.store(0, std::memory_order_relaxed);
+        head.store(count, std::memory_order_release);
+        return start;
+    }
+
+   private:
+    T* slots;
+    uint16_t capacity;
+
+    // Positions run over [0, 2 * capacity), so a full ring differs from an empty one
+    // without a spare slot, and the slot is the position modulo capacity
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+
+    // Position count items on (count <= capacity)
+    uint32_t advance(uint32_t position, uint16_t count) const {
+        position += count;
+        return position >= 2u * capacity ? position - 2u * capacity : position;
+    }
+    uint16_t slotFor(uint32_t position) const {
+        return static_cast<uint16_t>(position >= capacity ? position - capacity : position);
+    }
+};
+
+/**
+ * SpscRing with its storage inline (internal DRAM when the owner is a global or member)
+ */
+template <typename T, uint16_t Capacity>
+class StaticSpscRing : public SpscRing<T> {
+   public:
+    StaticSpscRing() : items() { this->attach(items, Capacity); }
+
+   private:
+    T items[Capacity];
+};
+
+#endif  // SPSC_RING_H
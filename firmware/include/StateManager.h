@@ -1,10 +1,12 @@
 #ifndef STATE_MANAGER_H
 #define STATE_MANAGER_H
 
-#include "models/AveragedData.h"
-#include "models/DisplayPoint.h"
+#include "models/DataSnapshot.h"
+#include <cstddef>
 #include <cstdint>
 
+class DataManager;
+
 /**
  * System operational states
  */
@@ -26,13 +28,27 @@ class Preferences {
     size_t getBytes(const char*, void*, size_t) { return 0; }
     bool putUShort(const char*, uint16_t) { return true; }
     uint16_t getUShort(const char*, uint16_t) { return 0; }
+    bool putULong(const char*, uint32_t) { return true; }
+    uint32_t getULong(const char*, uint32_t) { return 0; }
+    size_t getBytesLength(const char*) { return 0; }
+    bool remove(const char*) { return true; }
     bool clear() { return true; }
 };
 #endif
 
 /**
  * StateManager handles persistence of critical system state to NVS
- * for recovery after deep sleep or unexpected resets.
+ * for recovery after power loss or unexpected resets (deep sleep wakeups
+ * restore from the RtcStateStore image first).
+ *
+ * The transmit backlog is kept as a journal so a checkpoint costs flash writes
+ * proportional to the windows added since the last one:
+ * - windows are appended in chunks of JOURNAL_CHUNK_RECORDS under keys jr<slot>
+ * - a meta blob (the commit point) records the chunk range and the tail sequence;
+ *   journaled windows below the tail were acknowledged and are skipped on restore
+ * - chunks that are entirely below the tail are deleted after the commit
+ * - the journal is compacted (rewritten from the snapshot) when it runs out of chunk
+ *   slots or no longer matches the backlog, e.g. after an out-of-order acknowledgement
  * Also manages system operational state (normal, provisioning, error).
  */
 class StateManager {
@@ -48,13 +64,28 @@ class StateManager {
     SystemState getCurrentState() const;
     void setSystemState(SystemState state);
 
-    // Persist critical state before deep sleep
-    bool persistState(const AveragedData* dataBuffer, uint16_t dataBufferCount,
-                      const DisplayPoint* displayBuffer, uint16_t displayBufferCount);
+    /**
+     * Persist a DataManager snapshot to NVS (the power-loss fallback for the RTC image)
+     * @param snapshot Contiguous views from DataManager::snapshot(); the newest
+     *        NVS_MAX_RECORDS windows are journaled and the newest NVS_MAX_DISPLAY_POINTS
+     *        points rewritten
+     * @return false if NVS could not be opened or a write failed
+     */
+    bool persistState(const DataSnapshot& snapshot);
+
+    /**
+     * Restore the NVS copy straight into DataManager's empty rings
+     * @param dataManager Destination (call before the first reading)
+     * @param nowMs Current monotonic time
+     * @return false if there is no valid state or a read failed
+     */
+    bool restoreState(DataManager& dataManager, uint32_t nowMs);
 
-    // Restore state after wakeup from deep sleep
-    bool restoreState(AveragedData* dataBuffer, uint16_t& dataBufferCount,
-                      DisplayPoint* displayBuffer, uint16_t& displayBufferCount);
+    /**
+     * Count one deep sleep and report whether it should also write the NVS copy
+     * (every NVS_CHECKPOINT_SLEEPS sleeps; the counter lives in RTC memory)
+     */
+    bool isCheckpointDue();
 
     // Check if persisted state exists
     bool hasPersistedState();
@@ -70,15 +101,36 @@ class StateManager {
     static constexpr const char* NVS_NAMESPACE = "state";
 
     // NVS keys
-    static constexpr const char* KEY_DATA_BUFFER = "data_buf";
-    static constexpr const char* KEY_DATA_COUNT = "data_cnt";
-    static constexpr const char* KEY_DISPLAY_BUFFER = "disp_buf";
+    static constexpr const char* KEY_JOURNAL_META = "jmeta";
+    static constexpr const char* KEY_JOURNAL_CHUNK_PREFIX = "jr";  // + slot index
+    static constexpr const char* KEY_NEXT_SEQUENCE = "next_seq";
+    static constexpr const char* KEY_OVERFLOW_COUNT = "ovf_cnt";
+    static constexpr const char* KEY_DISPLAY_TIMESTAMPS = "disp_ts";
+    static constexpr const char* KEY_DISPLAY_VALUES_PREFIX = "disp_v";  // + sensor index
     static constexpr const char* KEY_DISPLAY_COUNT = "disp_cnt";
+    static constexpr const char* KEY_DISPLAY_CLOCK = "disp_clk";
     static constexpr const char* KEY_STATE_VALID = "state_valid";
 
+    // KEY_STATE_VALID value of the current layout (1 was the single-sensor display blob,
+    // 2 the single backlog blob)
+    static constexpr uint16_t STATE_LAYOUT_VERSION = 3;
+
     // Maximum sizes for NVS storage
-    static constexpr uint16_t MAX_DATA_BUFFER_SIZE = 50;
-    static constexpr uint16_t MAX_DISPLAY_BUFFER_SIZE = 240;
+    static constexpr uint16_t NVS_MAX_RECORDS = 50;
+    static constexpr uint16_t NVS_MAX_DISPLAY_POINTS = 240;
+
+    // Backlog journal: 8 x 100 B per chunk, 10 slots (live windows stay <= NVS_MAX_RECORDS)
+    static constexpr uint8_t JOURNAL_CHUNK_RECORDS = 8;
+    static constexpr uint8_t JOURNAL_MAX_CHUNKS = 10;
+
+    // Deep sleeps between NVS checkpoints (RTC memory carries state in between)
+    static constexpr uint16_t NVS_CHECKPOINT_SLEEPS = 12;
+
+    // Journal helpers (NVS must already be open)
+    static void chunkKey(uint32_t chunkId, char* key, size_t size);
+    bool journalRecords(const PackedAveragedData* records, uint16_t count,
+                        uint32_t firstChunk, uint16_t& chunksWritten);
+    void removeChunks(uint32_t firstChunk, uint16_t count);
 };
 
 #endif  // STATE_MANAGER_H
@@ -13,11 +13,13 @@
 
 /**
  * SystemStatusManager aggregates system state and metrics for display,
- * networking, and diagnostics.
+ * networking, and diagnostics. loop() and the network task both call it, so every
+ * method runs under one spinlock and getStatus() returns a consistent copy.
  *
  * Tracks:
  * - Uptime since boot
- * - Free heap memory
+ * - Free heap memory, its low watermark and the largest free block
+ * - Heap allocations per loop() pass (HeapTrace builds)
  * - WiFi RSSI
  * - Queue depth (buffered readings)
  * - Error counters (sensor, network, buffer overflow)
@@ -25,6 +27,15 @@
  * - Last successful transmission time
  * - Last error string
  * - Min/max sensor values since boot
+ * - Rolling per-sensor read latency (min/avg/max/p95)
+ * - Rolling per-phase network request latency and bytes transferred
+ * - Flash outbound queue spill/drain/GC counters
+ * - Startup phase durations, reported in one upload per boot
+ * - Per-phase loop() timing (p95 and worst case)
+ * - Whether a post-mortem log from the last abnormal reset still needs uploading
+ * - Whether the next upload should carry the health block: the first one of a boot,
+ *   then once per metrics interval, or sooner once an error or drop counter changes,
+ *   a task runs low on stack or a boot profile or post-mortem log is waiting
  */
 class SystemStatusManager {
    public:
@@ -55,12 +66,78 @@ class SystemStatusManager {
      */
     void setWiFiRSSI(int8_t rssi);
 
+    /**
+     * Record how long the last WiFi connect took.
+     * @param durationMs Association start to IP assignment in milliseconds
+     */
+    void setWiFiConnectTime(uint32_t durationMs);
+
     /**
      * Update queue depth (number of buffered readings).
      * @param depth Number of readings in transmission buffer
      */
     void setQueueDepth(uint16_t depth);
 
+    /**
+     * Update flash outbound queue counters.
+     * @param stats Snapshot from OutboundQueue::getStats()
+     */
+    void setOutboundQueueStats(const OutboundQueueStats& stats);
+
+    /**
+     * Update the startup phase durations.
+     * Marks them pending for the next upload unless one already carried them.
+     * @param profile Snapshot from BootProfiler::current()
+     */
+    void setBootProfile(const BootProfile& profile);
+
+    /**
+     * Record that an upload carrying the boot profile succeeded.
+     */
+    void markBootProfileSent();
+
+    /**
+     * Mark the post-mortem log for the next upload.
+     * @param pending ErrorLogger::hasPostMortem()
+     */
+    void setPostMortemPending(bool pending);
+
+    /**
+     * Record that an upload carrying the post-mortem log succeeded.
+     */
+    void markPostMortemSent();
+
+    /**
+     * Update the per-phase loop() timing.
+     * @param phases Snapshot from LoopProfiler::summarize()
+     */
+    void setLoopProfile(const LoopPhaseSummary phases[NUM_LOOP_PHASES]);
+
+    /**
+     * Update the per-task stack and CPU figures.
+     * @param tasks Snapshot from TaskMonitor::get()
+     * @param count Number of tasks (at most MAX_MONITORED_TASKS)
+     */
+    void setTaskStats(const TaskStats* tasks, uint8_t count);
+
+    /**
+     * Update the estimated charge per subsystem.
+     * @param report Snapshot from PowerManager::getEnergyReport()
+     */
+    void setEnergyReport(const EnergyReport& report);
+
+    /**
+     * Set how often the health block goes out while nothing it tracks has changed.
+     * @param intervalMs Milliseconds between health blocks (0 = in every upload)
+     */
+    void setMetricsInterval(uint32_t intervalMs);
+
+    /**
+     * Record that an upload carrying the health block succeeded.
+     * @param sent Snapshot the body was built from
+     */
+    void markMetricsSent(const SystemStatus& sent);
+
     /**
      * Increment sensor read failure counter.
      */
@@ -100,6 +177,48 @@ class SystemStatusManager {
      */
     void updateMinMax(const SensorReadings& readings);
 
+    /**
+     * Record per-sensor bus latencies from a reading.
+     * Buses with a zero latency (not sampled this cycle) are skipped.
+     * @param readings Sensor readings carrying readLatencyUs
+     */
+    void recordSensorLatencies(const SensorReadings& readings);
+
+    /**
+     * Record one latency sample for a sensor bus.
+     * @param bus Sensor bus index (SENSOR_*_BIT)
+     * @param latencyUs Transaction time in microseconds
+     */
+    void recordSensorLatency(uint8_t bus, uint32_t latencyUs);
+
+    /**
+     * Get rolling latency statistics for a sensor bus.
+     * @param bus Sensor bus index (SENSOR_*_BIT)
+     * @return Statistics over the last LATENCY_WINDOW samples (zeroed if none)
+     */
+    LatencyStats getSensorLatency(uint8_t bus) const;
+
+    /**
+     * Record how long one phase of a network request took.
+     * @param phase NetworkPhase value
+     * @param durationUs Phase time in microseconds
+     */
+    void recordNetworkPhase(uint8_t phase, uint32_t durationUs);
+
+    /**
+     * Get rolling latency statistics for a network request phase.
+     * @param phase NetworkPhase value
+     * @return Statistics over the last LATENCY_WINDOW samples (zeroed if none)
+     */
+    LatencyStats getNetworkLatency(uint8_t phase) const;
+
+    /**
+     * Add request and response body bytes to the transfer totals.
+     * @param sent Bytes sent
+     * @param received Bytes received
+     */
+    void addNetworkBytes(uint32_t sent, uint32_t received);
+
     /**
      * Reset min/max values to current readings.
      * @param readings Current sensor readings
@@ -131,20 +250,78 @@ class SystemStatusManager {
     unsigned long getLastTransmissionTime() const;
 
     /**
-     * Get last error string.
-     * @return Error message (null-terminated)
+     * Get request bytes sent since boot.
+     * @return Bytes passed to addNetworkBytes() as sent
+     */
+    uint32_t getNetBytesSent() const;
+
+    /**
+     * Copy the last error string.
+     * @param out Destination, always null-terminated when size > 0
+     * @param size Size of out in bytes
+     * @return Length of the stored message (longer than the copy if out was too small)
      */
-    const char* getLastError() const;
+    size_t getLastError(char* out, size_t size) const;
+
+    static constexpr uint8_t LATENCY_WINDOW = 32;
 
    private:
     SystemStatus status;
+
+    // Rolling latency windows per sensor bus
+    uint32_t latencySamples[NUM_SENSOR_BUSES][LATENCY_WINDOW];
+    uint8_t latencyHead[NUM_SENSOR_BUSES];
+    uint8_t latencyCount[NUM_SENSOR_BUSES];
+
+    // Rolling latency windows per network request phase
+    uint32_t networkSamples[NUM_NETWORK_PHASES][LATENCY_WINDOW];
+    uint8_t networkHead[NUM_NETWORK_PHASES];
+    uint8_t networkCount[NUM_NETWORK_PHASES];
+
+    // Append to a rolling window and refresh its statistics
+    static void recordSample(uint32_t* samples, uint8_t& head, uint8_t& count,
+                             uint32_t value, LatencyStats& stats);
+    static void computeLatencyStats(const uint32_t* samples, uint8_t n, LatencyStats& stats);
     unsigned long bootTimeMs;
     unsigned long lastSensorReadMs;
     unsigned long lastTransmissionMs;
+#ifdef ARDUINO
+    // Guards every field: loop() and the network task on the other core both update the
+    // status, so each method holds it for its few reads and writes
+    mutable portMUX_TYPE statusMux;
+#endif
     char lastErrorStr[128];
+    bool bootProfileSent;
+    uint32_t metricsIntervalMs;
+    unsigned long metricsSentMs;  // When the last health block was acknowledged
+    uint32_t metricsSentKey;      // metricsKey() of that block
+    bool metricsSent;             // One went out this boot
+
+    struct HeapSample {
+        uint32_t freeHeap;
+        uint32_t minFreeHeap;
+        uint32_t largestFreeBlock;
+        uint32_t loopAllocations;
+        uint32_t maxLoopAllocations;
+        bool allocationsTracked;
+    };
+
+    // Queried outside statusMux: the heap calls take the allocator's own lock
+    static HeapSample sampleHeap();
+
+    // Caller holds statusMux
+    void updateMetricsDue();
+
+#ifdef ARDUINO
+    void lock() const { portENTER_CRITICAL(&statusMux); }
+    void unlock() const { portEXIT_CRITICAL(&statusMux); }
+#else
+    void lock() const {}
+    void unlock() const {}
+#endif
 
-    void updateUptime();
-    void updateHeapMemory();
+    // CRC over the counters whose change makes the health block due
+    static uint32_t metricsKey(const SystemStatus& snapshot);
 };
 
 #endif  // SYSTEM_STATUS_MANAGER_H
@@ -0,0 +1,60 @@
+#ifndef TASK_MONITOR_H
+#define TASK_MONITOR_H
+
+#include <stdint.h>
+
+#include "models/TaskStats.h"
+
+#define TASK_MONITOR_INTERVAL_MS 10000  // Between samples
+#define TASK_STACK_WARN_BYTES 512       // Warn once when free stack drops under this
+
+/**
+ * TaskMonitor samples the stack high-water mark and CPU share of the firmware's own
+ * tasks, so stacks can be sized tightly and a task close to overflowing is reported
+ * (once, as an ErrorLogger warning, which also lands in the post-mortem log) before it
+ * corrupts memory.
+ *
+ * Tasks register when they start and unregister before they are deleted; the handle is
+ * the FreeRTOS TaskHandle_t. CPU shares need FreeRTOS run-time stats
+ * (configGENERATE_RUN_TIME_STATS); without them cpuPercent is TASK_CPU_UNKNOWN.
+ */
+class TaskMonitor {
+   public:
+    /**
+     * Start watching a task
+     * @param name Static name for reports
+     * @param handle TaskHandle_t
+     * @param stackBytes Stack size it was created with
+     * @return false if the table is full
+     */
+    static bool add(const char* name, void* handle, uint32_t stackBytes);
+
+    // Stop watching a task (before vTaskDelete)
+    static void remove(void* handle);
+
+    /**
+     * Sample every task if TASK_MONITOR_INTERVAL_MS has passed
+     * @param nowMs millis()
+     * @return true if a sample was taken
+     */
+    static bool sample(uint32_t nowMs);
+
+    /**
+     * Record one task's sample (what sample() does per task; exposed for host tests)
+     * @param index Task index (0 .. getCount() - 1)
+     * @param minFreeStackBytes High-water mark
+     * @param runTime Run-time counter delta over the period (0 with totalRunTime 0: unknown)
+     * @param totalRunTime Run-time base delta over the period
+     * @return true if this sample newly found the stack low
+     */
+    static bool record(uint8_t index, uint32_t minFreeStackBytes, uint32_t runTime,
+                       uint32_t totalRunTime);
+
+    static uint8_t getCount();
+    static const TaskStats& get(uint8_t index);
+
+    // Forget all tasks (host tests)
+    static void clear();
+};
+
+#endif  // TASK_MONITOR_H
@@ -0,0 +1,100 @@
+#ifndef TEXT_BUFFER_H
+#define TEXT_BUFFER_H
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * TextBuffer builds text in a fixed array of N bytes (terminator included), for the
+ * messages and identifiers that used to be assembled with String or std::string
+ * concatenation. It never allocates, so it is safe on the stack of any task and in
+ * paths that run while TLS holds most of the heap.
+ *
+ * Text that does not fit is cut at the end of the buffer rather than refused;
+ * truncated() reports it, and the content is always terminated.
+ */
+template <size_t N>
+class TextBuffer {
+    static_assert(N > 0, "TextBuffer needs room for the terminator");
+
+   public:
+    TextBuffer() : used(0), cut(false) { text[0] = '\0'; }
+
+    /**
+     * printf onto the end of the text
+     * @return false if the output was truncated
+     */
+    bool appendf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        va_list args;
+        va_start(args, fmt);
+        int written = vsnprintf(text + used, N - used, fmt, args);
+        va_end(args);
+        return advance(written);
+    }
+
+    /**
+     * Append at most length bytes of a string (stops early at its terminator)
+     * @return false if the text was truncated
+     */
+    bool append(const char* value, size_t length = static_cast<size_t>(-1)) {
+        size_t size = strnlen(value, length);
+        size_t room = N - 1 - used;
+        size_t copied = size < room ? size : room;
+        memcpy(text + used, value, copied);
+        used += copied;
+        text[used] = '\0';
+        if (copied < size) {
+            cut = true;
+        }
+        return copied == size;
+    }
+
+    // @return false if the character did not fit
+    bool append(char value) { return append(&value, 1); }
+
+    // Drop the text after the first length bytes
+    void truncate(size_t length) {
+        if (length < used) {
+            used = length;
+            text[used] = '\0';
+        }
+    }
+
+    void clear() {
+        used = 0;
+        cut = false;
+        text[0] = '\0';
+    }
+
+    const char* c_str() const { return text; }
+    size_t length() const { return used; }
+    bool empty() const { return used == 0; }
+    static constexpr size_t capacity() { return N - 1; }
+
+    // Whether any append since the last clear() did not fit
+    bool truncated() const { return cut; }
+
+   private:
+    bool advance(int written) {
+        if (written < 0) {
+            text[used] = '\0';  // Encoding error: drop the partial output
+            cut = true;
+            return false;
+        }
+        size_t wanted = used + static_cast<size_t>(written);
+        used = wanted < N ? wanted : N - 1;
+        if (wanted >= N) {
+            cut = true;
+            return false;
+        }
+        return true;
+    }
+
+    char text[N];
+    size_t used;
+    bool cut;
+};
+
+#endif  // TEXT_BUFFER_H
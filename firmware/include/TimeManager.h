@@ -9,8 +9,41 @@
 
 #include <cstdint>
 
+/**
+ * TimeManager maps the monotonic clock (millis()) to Unix epoch milliseconds.
+ *
+ * SNTP runs in the background (lwIP re-syncs it periodically); tryNtpSync() only starts
+ * it and never waits. Each sync is one (epoch, monotonic) sample. The first one anchors
+ * the mapping. Later ones measure how far the crystal drifted since the last anchor.
+ * They correct the rate, and slew out the offset at SLEW_MAX_PPM so epoch time never
+ * jumps or runs backwards. An offset over STEP_THRESHOLD_MS is stepped instead.
+ *
+ * The mapping holds for any monotonic time of this boot, before or after the sync, so a
+ * window's start and end epochs come from its own monotonic timestamps
+ * (epochAtMonotonicMs()) rather than from the clock at publish time.
+ *
+ * Deep sleep resets millis() but not RTC memory or the RTC timer: saveForSleep() keeps the
+ * epoch and the RTC timer value there, and restoreAfterSleep() re-anchors the mapping on
+ * wake, so a battery node stays synced without SNTP. SNTP is started again only once the
+ * last real sync is older than the staleness bound (setNtpMaxAgeSec(), needsNtpSync()).
+ */
 class TimeManager {
    public:
+    static constexpr int32_t SLEW_MAX_PPM = 500;              // 0.5 ms per second
+    static constexpr int32_t STEP_THRESHOLD_MS = 1000;        // Larger offsets are stepped
+    static constexpr int32_t DRIFT_LIMIT_PPM = 500;           // Crystal tolerance bound
+    static constexpr uint32_t DRIFT_MIN_INTERVAL_MS = 60000;  // Shorter gaps: offset only
+    static constexpr uint32_t DEFAULT_NTP_MAX_AGE_SEC = 21600;  // Re-sync a restored clock
+    static constexpr uint32_t SLEPT_AS_PLANNED = 0xFFFFFFFF;
+
+    /**
+     * Called after each sync, on the task that delivered it (the lwIP task on the
+     * device): keep it short
+     * @param epochMs Epoch time of the sync
+     * @param offsetMs Mapping error the sync found (0 for the first)
+     */
+    typedef void (*SyncCallback)(uint64_t epochMs, int32_t offsetMs, void* context);
+
     TimeManager();
     ~TimeManager();
 
@@ -22,26 +55,94 @@ class TimeManager {
     // Uptime tracking - milliseconds since boot
     uint32_t uptimeMs() const;
 
-    // NTP synchronization
+    // NTP synchronization: starts background SNTP once WiFi is up and returns at once
     void tryNtpSync();
     void onWiFiConnected();
 
-    // Time sync status
+    /**
+     * Register the sync callback (replaces the previous one)
+     */
+    void setSyncCallback(SyncCallback callback, void* context);
+
+    /**
+     * Feed one sync sample (called from the SNTP notification; exposed for host tests)
+     * @param epochMs Epoch time the server reported
+     * @param atMonotonicMs monotonicMs() when it was taken
+     */
+    void recordSync(uint64_t epochMs, uint32_t atMonotonicMs);
+
+    /**
+     * Keep the clock in RTC memory for the next wake (no-op if not synced)
+     * @param nowMs monotonicMs() just before the sleep
+     * @param plannedSleepMs Timer wakeup, used when the sleep cannot be measured (host)
+     */
+    void saveForSleep(uint32_t nowMs, uint32_t plannedSleepMs);
+
+    /**
+     * Re-anchor the mapping from the clock saveForSleep() kept in RTC memory (used once)
+     * @param nowMs monotonicMs() now
+     * @param sleptMs Time spent asleep; SLEPT_AS_PLANNED measures it with the RTC timer
+     * @return true if the clock is synced from the saved one
+     */
+    bool restoreAfterSleep(uint32_t nowMs, uint32_t sleptMs = SLEPT_AS_PLANNED);
+
+    /**
+     * @param seconds Age of the last SNTP sync past which a restored clock re-syncs
+     *                (0: every wake)
+     */
+    void setNtpMaxAgeSec(uint32_t seconds);
+
+    // Time sync status (also true for a clock restored after deep sleep)
     bool timeSynced() const;
 
+    // Not synced, or restored from a sync older than the staleness bound
+    bool needsNtpSync() const;
+
     // Unix epoch milliseconds (0 if not synced)
     uint64_t epochMsOrZero() const;
 
+    /**
+     * @param monotonicMs A monotonicMs() value of this boot (earlier or later than now)
+     * @return Its epoch milliseconds, or 0 if not synced
+     */
+    uint64_t epochAtMonotonicMs(uint32_t monotonicMs) const;
+
     // Get device boot timestamp (0 if not synced)
     uint64_t deviceBootEpochMs() const;
 
+    // Measured crystal rate error in parts per million (positive: millis() runs slow)
+    int32_t getDriftPpm() const;
+
+    // Offset still being slewed out, in ms
+    int32_t getPendingSlewMs() const;
+
+    uint32_t getSyncCount() const;
+
    private:
     bool ntpSynced;
-    uint64_t ntpEpochMs;     // Unix epoch ms when NTP was synced
-    uint32_t ntpSyncMillis;  // millis() value when NTP was synced
+    uint64_t ntpEpochMs;     // Epoch at the anchor, before the pending slew
+    uint32_t ntpSyncMillis;  // millis() at the anchor
     uint32_t bootMillis;     // millis() at boot (should be 0, but tracked for clarity)
+    int32_t driftPpb;        // Rate correction applied from the anchor on
+    int32_t slewMs;          // Offset absorbed from the anchor on, at SLEW_MAX_PPM
+    uint32_t syncCount;
+    bool sntpStarted;
+    SyncCallback syncCallback;
+    void* syncCallbackContext;
+    uint64_t lastNtpEpochMs;  // Epoch of the last SNTP sync, carried across deep sleep
+    uint32_t ntpMaxAgeSec;
+    bool restoredAnchor;      // Anchor came from before a deep sleep, not from SNTP
 
-    bool syncWithNtpServer();
+    // Epoch for monotonicMs on the current mapping (caller holds the lock)
+    uint64_t mapLocked(uint32_t monotonicMs) const;
+
+    // Part of slewMs absorbed elapsedMs after the anchor (caller holds the lock)
+    int64_t slewAbsorbedMs(int64_t elapsedMs) const;
+
+#ifndef UNIT_TEST
+    static TimeManager* sntpOwner;  // SNTP notifies through a plain function
+    static void onSntpSync(struct timeval* tv);
+#endif
 };
 
 #endif  // TIME_MANAGER_H
@@ -39,6 +39,12 @@ struct TouchDetectionResult {
  * 3. Verify stability with 2 consecutive successful reads
  * 4. Total timeout: 500ms maximum
  * 5. Per-probe timeout: 150ms maximum
+ *
+ * The hardware does not change between boots, so detectCached() keeps the result in NVS
+ * with a fingerprint of the board (eFuse MAC and bus pins). A cached controller is
+ * confirmed with one chip ID read; the full sequence runs only without a cache, on a
+ * fingerprint mismatch, when the cached controller no longer answers, or on request.
+ * A cached "no controller" is trusted until then (console "touch detect" re-runs it).
  */
 class TouchDetector {
    public:
@@ -53,6 +59,16 @@ class TouchDetector {
      */
     TouchDetectionResult detect();
 
+    /**
+     * Detection through the NVS cache (see the class comment)
+     * @param force Ignore the cache and run the full sequence
+     * @return TouchDetectionResult with detection status and timing
+     */
+    TouchDetectionResult detectCached(bool force = false);
+
+    // True if the last detectCached() was answered from the cache
+    bool usedCache() const { return cacheHit; }
+
     /**
      * Get the last detection result.
      *
@@ -62,6 +78,17 @@ class TouchDetector {
 
    private:
     TouchDetectionResult lastResult;
+    bool cacheHit;
+
+    // CRC-32 of the eFuse MAC and the touch bus pins
+    static uint32_t boardFingerprint();
+
+    /**
+     * Read the controller's chip ID once (I2C must be started)
+     * @param type Controller type to read
+     * @return true if it answered with the expected ID
+     */
+    bool readControllerId(TouchControllerType type);
 
     /**
      * Probe XPT2046 SPI resistive touch controller.
@@ -101,7 +128,7 @@ class TouchDetector {
 
     /**
      * Verify detection stability by requiring 2 consecutive successful reads.
-     * Adds 10ms delay between reads.
+     * Adds 10ms delay between reads (the second one is readControllerId()).
      *
      * @param type Controller type to verify
      * @return true if both reads succeed
@@ -0,0 +1,123 @@
+#ifndef TOUCH_INPUT_H
+#define TOUCH_INPUT_H
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#else
+#include <cstdint>
+#endif
+
+#include "TouchDetector.h"
+
+/**
+ * TouchGesture is what a touch on the panel means to the display.
+ */
+enum class TouchGesture : uint8_t {
+    TAP,        // Short touch
+    LONG_PRESS  // Held for TouchInput::LONG_PRESS_MS (reported once, while still held)
+};
+
+/**
+ * TouchInput turns the touch controller's IRQ line (FT6236/CST816/GT911 INT, XPT2046
+ * PENIRQ, all active low) into gestures without touching the bus:
+ *
+ * - The ISR only timestamps each edge into a small ring (no I2C/SPI, no allocation)
+ * - poll() decodes the queued edges into taps and long presses on the display side
+ * - With the line idle nothing is queued, so an idle panel costs no bus traffic at all
+ *
+ * Controllers that hold INT low while touched (XPT2046, FT6236 in polling mode) give one
+ * press and one release edge; those that pulse INT once per report (CST816, GT911) are
+ * seen as one touch until the line stays quiet for RELEASE_GAP_MS.
+ */
+class TouchInput {
+   public:
+    static constexpr uint8_t EDGE_QUEUE_LENGTH = 16;
+    static constexpr uint32_t RELEASE_GAP_MS = 80;   // Longer than a report interval
+    static constexpr uint32_t LONG_PRESS_MS = 800;
+
+    TouchInput();
+    ~TouchInput();
+    TouchInput(const TouchInput&) = delete;
+    TouchInput& operator=(const TouchInput&) = delete;
+
+    /**
+     * Attach the IRQ handler for a detected controller
+     * @param type Detected controller (NONE leaves touch input off)
+     * @param irqPin GPIO wired to the controller's INT/PENIRQ output
+     * @return true if the interrupt is attached
+     */
+    bool begin(TouchControllerType type, uint8_t irqPin);
+
+    // Detach the IRQ handler and drop anything queued
+    void end();
+
+    bool isActive() const { return active; }
+
+    /**
+     * Record an IRQ line edge (called from the ISR; exposed for host tests)
+     * @param pressed Line level after the edge is active (low)
+     * @param timeMs millis() at the edge
+     */
+    void onIrqEdge(bool pressed, uint32_t timeMs);
+
+    /**
+     * Queue a synthetic edge if the line level disagrees with the decoded state and
+     * nothing is queued (an edge lost while automatic light sleep gated the GPIO clock)
+     * @param pressed Current line level is active (low)
+     * @param timeMs millis() of the level check
+     */
+    void resyncLevel(bool pressed, uint32_t timeMs);
+
+    /**
+     * Decode the queued edges into the next gesture
+     * @param nowMs Current millis(), to end a touch once the line stays quiet
+     * @param gesture Receives the gesture
+     * @return true if a gesture completed
+     */
+    bool poll(uint32_t nowMs, TouchGesture& gesture);
+
+    /**
+     * @return Edges dropped because the queue was full
+     */
+    uint32_t getDroppedCount() const { return droppedCount; }
+
+   private:
+    struct Edge {
+        uint32_t timeMs;
+        bool pressed;
+    };
+
+    // Edge ring: the ISR is the only producer, poll() the only consumer
+    Edge edges[EDGE_QUEUE_LENGTH];
+    volatile uint8_t edgeHead;
+    volatile uint8_t edgeCount;
+    volatile uint32_t droppedCount;
+#ifdef ARDUINO
+    portMUX_TYPE edgeMux;
+#endif
+
+    bool active;
+    uint8_t irqPin;
+
+    // Decoder state (display side only)
+    bool touching;          // A touch is in progress
+    bool linePressed;       // Level after the last decoded edge
+    bool longReported;      // LONG_PRESS already sent for this touch
+    uint32_t touchStartMs;  // First press edge of the touch
+    uint32_t lastEdgeMs;
+
+    bool peekEdge(Edge& edge);
+    void popEdge();
+
+    /**
+     * Close or promote the current touch at a point in time
+     * @return true if that produced a gesture
+     */
+    bool finishTouch(uint32_t timeMs, TouchGesture& gesture);
+
+#ifdef ARDUINO
+    static void IRAM_ATTR handleIrq(void* arg);
+#endif
+};
+
+#endif  // TOUCH_INPUT_H
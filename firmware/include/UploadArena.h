@@ -0,0 +1,61 @@
+#ifndef UPLOAD_ARENA_H
+#define UPLOAD_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * UploadArena is a bump allocator over a block reserved once at boot, for the transient
+ * memory of one upload attempt: error text and the part of an error response kept for
+ * the log. Nothing is freed on its own; reset() at the start of the next attempt hands
+ * the whole block back, so those cycles never touch the heap that TLS needs.
+ *
+ * Running out of room is not an error for the caller: allocate() returns nullptr and
+ * format() truncates, and both are counted (getFailedCount()) so the block can be sized
+ * from the high-water mark.
+ */
+class UploadArena {
+   public:
+    UploadArena();
+
+    /**
+     * Use new storage and empty the arena
+     * @param storage Block the allocations come from (outlives the arena)
+     * @param capacity Bytes in storage
+     */
+    void attach(uint8_t* storage, size_t capacity);
+
+    // Free everything allocated since the last reset()
+    void reset();
+
+    /**
+     * @param bytes Size of the allocation
+     * @param alignment Power of two the address is a multiple of
+     * @return The allocation, or nullptr if the arena has no room left
+     */
+    void* allocate(size_t bytes, size_t alignment = sizeof(void*));
+
+    /**
+     * printf into the arena
+     * @return The text, truncated to the room left ("" once the arena is full)
+     */
+    const char* format(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+
+    size_t getCapacity() const { return capacity; }
+    size_t getUsed() const { return used; }
+
+    // Most bytes in use at once since boot
+    size_t getHighWater() const { return highWater; }
+
+    // Allocations refused and texts truncated since boot
+    uint32_t getFailedCount() const { return failedCount; }
+
+   private:
+    uint8_t* block;
+    size_t capacity;
+    size_t used;
+    size_t highWater;
+    uint32_t failedCount;
+};
+
+#endif  // UPLOAD_ARENA_H
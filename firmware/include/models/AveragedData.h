@@ -3,6 +3,18 @@
 
 #include <stdint.h>
 
+#include "SensorType.h"
+
+/**
+ * Spread of one sensor field within an averaging window.
+ * stddev is the population standard deviation of the fresh samples.
+ */
+struct SensorSpread {
+    float min;
+    float max;
+    float stddev;
+};
+
 /**
  * Structure representing averaged sensor data over a collection period.
  * Used for network transmission and buffering.
@@ -13,6 +25,7 @@
 struct AveragedData {
     char batchId[64];  // Unique identifier: device_e_epochStart_epochEnd or
                        // device_u_uptimeStart_uptimeEnd
+    uint32_t sequence;  // Monotonic per-boot window number (0 = not yet assigned)
 
     // Averaged sensor values
     float avgBme280Temp;    // Celsius
@@ -21,6 +34,17 @@ struct AveragedData {
     float avgPressure;      // hPa
     float avgSoilMoisture;  // Percent (0-100)
 
+    // Per-window spread (same units as the averages)
+    SensorSpread bme280TempSpread;
+    SensorSpread ds18b20TempSpread;
+    SensorSpread humiditySpread;
+    SensorSpread pressureSpread;
+    SensorSpread soilMoistureSpread;
+
+    // Per-probe DS18B20 averages (avgDs18b20Temp == probe 0)
+    float avgDs18b20Probes[MAX_DS18B20_PROBES];  // Celsius
+    uint8_t ds18b20ProbeCount;
+
     // Epoch timestamps (0 when time not synced)
     uint64_t sampleStartEpochMs;  // Unix epoch milliseconds
     uint64_t sampleEndEpochMs;    // Unix epoch milliseconds
@@ -33,6 +57,11 @@ struct AveragedData {
 
     // Metadata
     uint16_t sampleCount;  // Number of readings averaged
+
+    // Per-sensor sample counts (sensors may be sampled less often than sampleCount)
+    uint16_t bme280SampleCount;
+    uint16_t ds18b20SampleCount;
+    uint16_t soilSampleCount;
     uint8_t sensorStatus;  // Bitmask of available sensors
     bool timeSynced;       // Whether epoch timestamps are valid
 };
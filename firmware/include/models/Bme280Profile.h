@@ -0,0 +1,42 @@
+#ifndef BME280_PROFILE_H
+#define BME280_PROFILE_H
+
+#include <cstdint>
+#include <string.h>
+
+/**
+ * BME280 acquisition profiles.
+ * - WEATHER_STATION: forced mode, x1 oversampling, no IIR filter (lowest current)
+ * - HIGH_PRECISION:  normal mode, x2/x16/x1 (temp/press/hum), IIR x16
+ * - LIBRARY_DEFAULT: normal mode, x16 on all channels, no filter (Adafruit begin() defaults)
+ */
+enum class Bme280Profile : uint8_t { WEATHER_STATION, HIGH_PRECISION, LIBRARY_DEFAULT };
+
+constexpr uint8_t NUM_BME280_PROFILES = 3;
+
+// Config file names for each profile (index = enum value)
+inline const char* bme280ProfileName(Bme280Profile profile) {
+    switch (profile) {
+        case Bme280Profile::WEATHER_STATION:
+            return "weather";
+        case Bme280Profile::HIGH_PRECISION:
+            return "precision";
+        case Bme280Profile::LIBRARY_DEFAULT:
+            return "default";
+        default:
+            return "weather";
+    }
+}
+
+// Parse a config file profile name; unknown names fall back to WEATHER_STATION
+inline Bme280Profile bme280ProfileFromName(const char* name) {
+    if (name && strcmp(name, "precision") == 0) {
+        return Bme280Profile::HIGH_PRECISION;
+    }
+    if (name && strcmp(name, "default") == 0) {
+        return Bme280Profile::LIBRARY_DEFAULT;
+    }
+    return Bme280Profile::WEATHER_STATION;
+}
+
+#endif
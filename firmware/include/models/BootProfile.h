@@ -0,0 +1,27 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <cstdint>
+
+// setup() phases timed by BootProfiler (index into BootProfile::phaseMs)
+enum BootPhase : uint8_t {
+    BOOT_PHASE_CONFIG_FILE,  // Config file load and validation
+    BOOT_PHASE_NVS,          // NVS config fallback and persisted state restore
+    BOOT_PHASE_DISPLAY,      // Panel init (and splash on a cold boot)
+    BOOT_PHASE_TOUCH,        // Touch controller detection
+    BOOT_PHASE_SENSORS,      // Sensor probing and init retries
+    BOOT_PHASE_WIFI,         // connectWiFi() until an IP is assigned
+    BOOT_PHASE_NTP,          // IP assigned until the first NTP sync
+    NUM_BOOT_PHASES
+};
+
+/**
+ * Per-phase startup durations of one boot.
+ */
+struct BootProfile {
+    uint32_t phaseMs[NUM_BOOT_PHASES];
+    uint8_t doneMask;  // Bit per BootPhase that finished (a skipped phase stays clear)
+    uint32_t setupMs;  // setup() entry to exit (0 until it returns)
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef BUFFERED_BATCH_H
+#define BUFFERED_BATCH_H
+
+#include <stdint.h>
+
+#include "PackedAveragedData.h"
+
+/**
+ * @brief Contiguous run of buffered windows inside the transmission ring
+ */
+struct BufferedSegment {
+    const PackedAveragedData* data;
+    uint16_t count;
+};
+
+/**
+ * @brief Zero-copy view of the transmission backlog
+ *
+ * The ring wraps, so the backlog is at most two contiguous segments: tail to the
+ * end of the array, then the start of the array to the head. Index 0 is the oldest
+ * entry. The view is invalidated by any call that adds or removes buffered data.
+ */
+struct BufferedBatch {
+    BufferedSegment segments[2];
+
+    uint16_t count() const { return segments[0].count + segments[1].count; }
+
+    const PackedAveragedData& at(uint16_t i) const {
+        return i < segments[0].count ? segments[0].data[i]
+                                     : segments[1].data[i - segments[0].count];
+    }
+
+    // View of the oldest count entries (all of them if fewer are buffered)
+    BufferedBatch first(uint16_t count) const {
+        BufferedBatch page = *this;
+        if (page.segments[0].count >= count) {
+            page.segments[0].count = count;
+            page.segments[1] = {nullptr, 0};
+        } else if (page.segments[0].count + page.segments[1].count > count) {
+            page.segments[1].count = count - page.segments[0].count;
+        }
+        return page;
+    }
+};
+
+#endif  // BUFFERED_BATCH_H
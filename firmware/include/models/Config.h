@@ -17,14 +17,59 @@ struct Config {
     String apiToken;
     String deviceId;
     uint32_t readingIntervalMs;
+    // Per-sensor sampling intervals (0 = every reading; rounded to whole reading intervals)
+    uint32_t bme280IntervalMs;
+    uint32_t ds18b20IntervalMs;
+    uint32_t soilIntervalMs;
     uint16_t publishIntervalSamples;
+    bool alignWindows;  // Windows on wall-clock multiples of their length once synced
+    bool eventUplink;   // Soil moisture alerts uploaded at once, ahead of the batch
     uint16_t pageCycleIntervalMs;
+    uint8_t displayMaxFps;  // Display frame-rate cap (0 = default)
     uint16_t soilDryAdc;
     uint16_t soilWetAdc;
+    uint8_t soilSampleWindow;   // ADC samples reduced per soil reading (1-32)
+    uint8_t ds18b20Resolution;  // DS18B20 resolution in bits (9-12)
     bool temperatureInFahrenheit;
     uint16_t soilMoistureThresholdLow;
     uint16_t soilMoistureThresholdHigh;
     bool batteryMode;
+    uint8_t bme280Profile;  // Bme280Profile value (default: WEATHER_STATION)
+
+    // Ring sizes (0 = size from free PSRAM at boot)
+    uint16_t dataBufferCapacity;    // Buffered upload windows
+    uint16_t displayHistoryPoints;  // 1-minute graph history points
+
+    uint8_t payloadFormat;  // PayloadFormat value for uploads (default: ROWS)
+
+    // Static IPv4 configuration (empty staticIp = DHCP)
+    String staticIp;
+    String staticGateway;
+    String staticSubnet;  // Empty = 255.255.255.0
+    String staticDns;     // Empty = gateway
+
+    // Upload transport (UploadTransport value, default: HTTP)
+    uint8_t uploadTransport;
+    String mqttUrl;    // mqtt://host[:1883] or mqtts://host[:8883]
+    String mqttTopic;  // Empty = sensors/<deviceId>/readings
+
+    // Upload coalescing (UplinkPolicy value, default: EVERY_WINDOW)
+    uint8_t uplinkPolicy;
+    uint8_t uplinkWindows;       // Windows per upload for EVERY_N and ADAPTIVE
+    uint32_t uplinkIntervalSec;  // Seconds between uploads for INTERVAL
+
+    // Health block cadence: at most once per interval unless a counter changes
+    uint32_t metricsIntervalSec;  // 0 = health block in every upload
+
+    // Age of the last NTP sync past which a clock kept across deep sleep re-syncs
+    uint32_t ntpMaxAgeSec;  // 0 = re-sync every wake
+
+    // Report-by-exception deadbands (0 = report any change; all 0 = off)
+    float deadbandTemp;          // C
+    float deadbandHumidity;      // %
+    float deadbandPressure;      // hPa
+    float deadbandSoil;          // %
+    uint8_t deadbandHeartbeat;   // Report at least every N windows
 
     // TLS/HTTPS configuration
     bool tlsValidateServer;  // Enable certificate validation (default: true)
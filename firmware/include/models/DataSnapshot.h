@@ -0,0 +1,45 @@
+#ifndef DATA_SNAPSHOT_H
+#define DATA_SNAPSHOT_H
+
+#include <stdint.h>
+
+#include "PackedAveragedData.h"
+#include "SensorType.h"
+
+/**
+ * @brief Read-only view of DataManager's rings for persistence
+ *
+ * Both rings are rotated to start at index 0 first, so each array below is one
+ * contiguous oldest-first block that can be written out without a copy. The view is
+ * invalidated by any call that adds or removes data.
+ */
+struct DataSnapshot {
+    const PackedAveragedData* records;
+    uint16_t recordCount;
+
+    // 1-minute display history: shared timestamps, one value column per sensor
+    const uint32_t* displayTimestamps;
+    const float* displayValues[NUM_SENSORS];
+    uint16_t displayCount;
+
+    uint32_t nextSequence;
+    uint16_t bufferOverflowCount;
+    uint32_t displayClockMs;  // Display clock at the time of the snapshot
+};
+
+/**
+ * @brief Writable view of DataManager's empty rings for a bulk restore
+ *
+ * Fill up to the capacities oldest-first, then call DataManager::commitRestore().
+ * All pointers are null when the rings already hold data.
+ */
+struct DataRestoreTarget {
+    PackedAveragedData* records;
+    uint16_t recordCapacity;
+
+    uint32_t* displayTimestamps;
+    float* displayValues[NUM_SENSORS];
+    uint16_t displayCapacity;
+};
+
+#endif  // DATA_SNAPSHOT_H
@@ -0,0 +1,28 @@
+#ifndef DISPLAY_BUCKET_H
+#define DISPLAY_BUCKET_H
+
+#include <stdint.h>
+
+/**
+ * @brief Resolution tiers of the display history
+ *
+ * MINUTE keeps raw 1-minute points; the coarser tiers keep rolled-up buckets.
+ */
+enum class DisplayTier : uint8_t { MINUTE, QUARTER_HOUR, HOUR };
+
+constexpr uint8_t NUM_DISPLAY_TIERS = 3;
+
+/**
+ * @brief Rolled-up display history bucket
+ *
+ * Summarises every 1-minute point that fell into the bucket's interval so
+ * long-span graphs can show the range as well as the trend.
+ */
+struct DisplayBucket {
+    float min;
+    float mean;
+    float max;
+    uint32_t timestamp;  // Bucket start, monotonic milliseconds (interval-aligned)
+};
+
+#endif  // DISPLAY_BUCKET_H
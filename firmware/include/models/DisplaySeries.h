@@ -0,0 +1,35 @@
+#ifndef DISPLAY_SERIES_H
+#define DISPLAY_SERIES_H
+
+#include <math.h>
+#include <stdint.h>
+
+#include "PackedAveragedData.h"
+
+/**
+ * @brief Zero-copy view of one sensor's display history
+ *
+ * Points to a shared timestamp column and one value column of a display ring: float
+ * for the 1-minute tier, fixed point (value x fixedScale) for the coarse tiers.
+ * Index 0 is the oldest point; accessors apply the ring wrap.
+ */
+struct DisplaySeries {
+    const uint32_t* timestamps;
+    const float* values;         // nullptr when the column is fixed point
+    const int16_t* fixedValues;  // FIXED_POINT_NAN when not a number
+    float fixedScale;
+    uint16_t capacity;  // Ring size of the underlying columns
+    uint16_t start;     // Ring index of the oldest point
+    uint16_t count;
+
+    uint32_t timestampAt(uint16_t i) const { return timestamps[(start + i) % capacity]; }
+    float valueAt(uint16_t i) const {
+        uint16_t slot = (start + i) % capacity;
+        if (values) {
+            return values[slot];
+        }
+        return fixedValues[slot] == FIXED_POINT_NAN ? NAN : fixedValues[slot] / fixedScale;
+    }
+};
+
+#endif  // DISPLAY_SERIES_H
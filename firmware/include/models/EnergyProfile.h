@@ -0,0 +1,46 @@
+#ifndef ENERGY_PROFILE_H
+#define ENERGY_PROFILE_H
+
+#include <cstdint>
+
+// Power states EnergyMeter tracks time in (index into its per-state tables)
+enum EnergyState : uint8_t {
+    ENERGY_CPU_MAX,      // CPU awake at the DVFS maximum (or the boot frequency without esp_pm)
+    ENERGY_CPU_MIN,      // CPU awake at the DVFS minimum
+    ENERGY_LIGHT_SLEEP,  // Light sleep, manual or automatic
+    ENERGY_WIFI_TX,      // Radio transmitting (airtime estimated from bytes sent)
+    ENERGY_WIFI_RX,      // Radio awake: connecting, uploading, receiving
+    ENERGY_WIFI_IDLE,    // Associated in modem sleep (DTIM wakeups averaged in)
+    ENERGY_BACKLIGHT,    // Backlight, full-brightness equivalent (time scaled by PWM duty)
+    ENERGY_SENSORS,      // Sensor bus transfers and conversions
+    NUM_ENERGY_STATES
+};
+
+// Subsystems the per-state charge is summed into
+enum EnergySubsystem : uint8_t {
+    ENERGY_SUBSYSTEM_CPU,
+    ENERGY_SUBSYSTEM_WIFI,
+    ENERGY_SUBSYSTEM_DISPLAY,
+    ENERGY_SUBSYSTEM_SENSORS,
+    NUM_ENERGY_SUBSYSTEMS
+};
+
+/**
+ * Estimated charge per subsystem over an accounting window.
+ */
+struct EnergyReport {
+    float subsystemMah[NUM_ENERGY_SUBSYSTEMS];
+    uint32_t windowMs;  // CPU time accounted (awake plus asleep) since the last reset
+};
+
+/**
+ * What PowerManager::accountEnergy() samples from the other subsystems each loop.
+ */
+struct EnergySample {
+    EnergyState radio;      // ENERGY_WIFI_RX or ENERGY_WIFI_IDLE; NUM_ENERGY_STATES = radio off
+    uint8_t backlight;      // Backlight PWM duty (0-255)
+    uint32_t bytesSent;     // Request bytes since boot (SystemStatus::netBytesSent)
+    uint32_t sensorBusyMs;  // Sensor read time since boot (AcquisitionTask::getBusyMs())
+};
+
+#endif
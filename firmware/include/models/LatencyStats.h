@@ -0,0 +1,26 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <cstdint>
+
+/**
+ * Rolling latency statistics over the most recent samples (microseconds).
+ */
+struct LatencyStats {
+    uint32_t minUs;
+    uint32_t avgUs;
+    uint32_t maxUs;
+    uint32_t p95Us;
+    uint16_t count;  // Samples in the rolling window
+};
+
+// Request phases timed by NetworkManager (index into SystemStatus::networkLatency)
+enum NetworkPhase : uint8_t {
+    NET_PHASE_DNS,       // Host name lookup
+    NET_PHASE_CONNECT,   // TCP connect, including the TLS handshake on HTTPS
+    NET_PHASE_REQUEST,   // Request sent until the status line arrives (server processing)
+    NET_PHASE_RESPONSE,  // Response body read
+    NUM_NETWORK_PHASES
+};
+
+#endif
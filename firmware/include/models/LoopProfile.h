@@ -0,0 +1,40 @@
+#ifndef LOOP_PROFILE_H
+#define LOOP_PROFILE_H
+
+#include <cstdint>
+
+// loop() phases timed by LoopProfiler (index into its per-phase tables)
+enum LoopPhase : uint8_t {
+    LOOP_PHASE_STATUS,     // Status update and energy accounting
+    LOOP_PHASE_SENSORS,    // Readings from the acquisition task into the buffers
+    LOOP_PHASE_AVERAGING,  // Closing a publish window: averages, timestamps, batch ID
+    LOOP_PHASE_PUBLISH,    // Upload decision, connection pre-warm and one upload step
+    LOOP_PHASE_WIFI,       // WiFi state machine and RSSI refresh
+    LOOP_PHASE_DISPLAY,    // Handing the latest state to the display task
+    LOOP_PHASE_SERIAL,     // Console input and the debounced config save
+    LOOP_PHASE_SLEEP,      // Light sleep or the idle delay
+    NUM_LOOP_PHASES
+};
+
+// Bucket b counts passes under 16 << (2 * b) us (16 us, 64 us, ... 1 s); the last is open
+constexpr uint8_t LOOP_HISTOGRAM_BUCKETS = 10;
+
+/**
+ * Log-scale time histogram of one loop() phase since boot (or the last reset).
+ */
+struct LoopPhaseStats {
+    uint32_t buckets[LOOP_HISTOGRAM_BUCKETS];
+    uint32_t count;   // Passes the phase ran in
+    uint32_t maxUs;   // Worst case
+    uint32_t lastUs;  // Most recent pass
+};
+
+/**
+ * What the health block reports per phase.
+ */
+struct LoopPhaseSummary {
+    uint32_t p95Us;  // Upper bound of the bucket holding the 95th percentile
+    uint32_t maxUs;
+};
+
+#endif
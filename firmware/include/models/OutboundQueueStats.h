@@ -0,0 +1,19 @@
+#ifndef OUTBOUND_QUEUE_STATS_H
+#define OUTBOUND_QUEUE_STATS_H
+
+#include <cstdint>
+
+/**
+ * Counters for the flash-backed outbound queue (since boot unless noted).
+ */
+struct OutboundQueueStats {
+    uint32_t spilledRecords;     // Windows evicted from the RAM ring into the queue
+    uint32_t drainedRecords;     // Windows uploaded from the queue and committed
+    uint32_t droppedRecords;     // Windows lost because every segment was full
+    uint32_t flushes;            // Batched flash writes
+    uint32_t segmentsCollected;  // Fully drained segment files deleted
+    uint32_t queuedRecords;      // Windows currently queued (flash + staged)
+    uint16_t segmentCount;       // Segment files currently on flash
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef PACKED_AVERAGED_DATA_H
+#define PACKED_AVERAGED_DATA_H
+
+#include <stdint.h>
+
+#include "SensorType.h"
+
+/**
+ * Compact on-device form of AveragedData, used by the transmission ring and
+ * the NVS state blob. Expanded back to AveragedData only for serialization.
+ *
+ * - batchId is not stored; it is re-derived from the timestamps
+ * - epoch times are a 32-bit seconds base plus millisecond offsets
+ * - sensor values are fixed point: hundredths (C, %, hPa -> Pa); stddev unsigned
+ *
+ * Fields are ordered widest-first so the struct has no interior padding.
+ */
+struct PackedAveragedData {
+    uint32_t sequence;
+
+    // Uptime timestamps
+    uint32_t sampleStartUptimeMs;
+    uint32_t sampleDurationMs;  // sampleEndUptimeMs - sampleStartUptimeMs
+    uint32_t uptimeMs;
+
+    // Epoch timestamps (all zero when time not synced)
+    uint32_t epochStartSec;
+    uint32_t epochEndOffsetMs;  // sampleEndEpochMs - sampleStartEpochMs
+    uint32_t bootEpochSec;
+
+    // Pressure in Pa (hPa x 100) does not fit 16 bits
+    int32_t pressure;
+    int32_t pressureMin;
+    int32_t pressureMax;
+
+    uint16_t epochStartMsRem;
+    uint16_t bootEpochMsRem;
+
+    // Hundredths of C / % (FIXED_POINT_NAN when not a number)
+    int16_t bme280Temp;
+    int16_t ds18b20Temp;
+    int16_t humidity;
+    int16_t soilMoisture;
+    int16_t ds18b20Probes[MAX_DS18B20_PROBES];
+
+    // Spread for bme280Temp, ds18b20Temp, humidity, soilMoisture (same units)
+    int16_t spreadMin[4];
+    int16_t spreadMax[4];
+    uint16_t spreadStddev[4];
+    uint16_t pressureStddev;  // Pa
+
+    uint16_t sampleCount;
+    uint16_t bme280SampleCount;
+    uint16_t ds18b20SampleCount;
+    uint16_t soilSampleCount;
+
+    uint8_t ds18b20ProbeCount;
+    uint8_t sensorStatus;
+    uint8_t flags;  // PACKED_FLAG_*
+};
+
+constexpr int16_t FIXED_POINT_NAN = INT16_MIN;
+constexpr int32_t FIXED_POINT_NAN32 = INT32_MIN;
+constexpr uint8_t PACKED_FLAG_TIME_SYNCED = 0x01;
+
+#endif  // PACKED_AVERAGED_DATA_H
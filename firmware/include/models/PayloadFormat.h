@@ -0,0 +1,44 @@
+#ifndef PAYLOAD_FORMAT_H
+#define PAYLOAD_FORMAT_H
+
+#include <cstdint>
+#include <string.h>
+
+/**
+ * Upload body schemas.
+ * - ROWS:     one self-describing JSON object per reading (every key repeated)
+ * - COLUMNAR: "columnar-v1" - shared header, one array per field, a sensor bitmask
+ *             instead of per-reading status objects and a single health block
+ * - CBOR:     the columnar-v1 layout as binary CBOR (application/cbor) with float32
+ *             sensor values, skipping float-to-text conversion
+ */
+enum class PayloadFormat : uint8_t { ROWS, COLUMNAR, CBOR };
+
+constexpr uint8_t NUM_PAYLOAD_FORMATS = 3;
+
+// Config file names for each format (index = enum value)
+inline const char* payloadFormatName(PayloadFormat format) {
+    switch (format) {
+        case PayloadFormat::ROWS:
+            return "rows";
+        case PayloadFormat::COLUMNAR:
+            return "columnar";
+        case PayloadFormat::CBOR:
+            return "cbor";
+        default:
+            return "rows";
+    }
+}
+
+// Parse a config file format name; unknown names fall back to ROWS
+inline PayloadFormat payloadFormatFromName(const char* name) {
+    if (name && strcmp(name, "columnar") == 0) {
+        return PayloadFormat::COLUMNAR;
+    }
+    if (name && strcmp(name, "cbor") == 0) {
+        return PayloadFormat::CBOR;
+    }
+    return PayloadFormat::ROWS;
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef RADIO_POLICY_H
+#define RADIO_POLICY_H
+
+#include <cstdint>
+
+#include "models/UplinkPolicy.h"
+
+/**
+ * WiFi radio state between uploads.
+ * - ACTIVE: default power save (WIFI_PS_MIN_MODEM), held while an upload runs
+ * - MODEM_SLEEP: WIFI_PS_MAX_MODEM, associated but asleep across beacons while idle
+ * - OFF: radio powered down; rejoined RADIO_WAKE_LEAD_MS ahead of the next upload
+ *        through the cached BSSID and channel
+ */
+enum class RadioMode : uint8_t { ACTIVE, MODEM_SLEEP, OFF };
+
+// Rejoin this long before an upload (cached-AP association, DHCP and the TLS prewarm)
+#define RADIO_WAKE_LEAD_MS 15000
+
+// Idle gap that pays for a rejoin: about one reconnect's energy in max modem sleep; a
+// low battery accepts the rejoin sooner, mains power only for long gaps
+#define RADIO_OFF_BATTERY_MS 60000
+#define RADIO_OFF_LOW_BATTERY_MS 30000
+#define RADIO_OFF_MAINS_MS 600000
+
+/**
+ * Estimated time until the next upload goes out
+ * @param samplesLeft Readings still missing from the current window
+ * @param readingIntervalMs Effective reading interval
+ * @param sinceLastReadMs Time since the last reading
+ * @param windowsAfter Whole windows to collect after the current one before the upload
+ * @param windowMs Length of one window
+ */
+inline uint32_t uplinkEtaMs(uint16_t samplesLeft, uint32_t readingIntervalMs,
+                            uint32_t sinceLastReadMs, uint16_t windowsAfter, uint32_t windowMs) {
+    uint32_t eta = (uint32_t)samplesLeft * readingIntervalMs + (uint32_t)windowsAfter * windowMs;
+    uint32_t elapsed = sinceLastReadMs < readingIntervalMs ? sinceLastReadMs : readingIntervalMs;
+    return eta > elapsed ? eta - elapsed : 0;
+}
+
+/**
+ * Pick the idle radio state from the uplink schedule and battery level. A radio that is
+ * off stays off until the wake lead, so the choice does not flap around the threshold.
+ * @param current Radio state now
+ * @param msUntilUplink uplinkEtaMs() of the next upload
+ * @param batteryPercent Battery level; pass 100 on mains power
+ * @param onBattery Battery mode
+ * @return MODEM_SLEEP or OFF
+ */
+inline RadioMode radioModeFor(RadioMode current, uint32_t msUntilUplink, uint8_t batteryPercent,
+                              bool onBattery) {
+    if (msUntilUplink <= RADIO_WAKE_LEAD_MS) {
+        return RadioMode::MODEM_SLEEP;
+    }
+    if (current == RadioMode::OFF) {
+        return RadioMode::OFF;
+    }
+    uint32_t offAfterMs = RADIO_OFF_MAINS_MS;
+    if (onBattery) {
+        offAfterMs = batteryPercent < UPLINK_ADAPTIVE_LOW_PERCENT ? RADIO_OFF_LOW_BATTERY_MS
+                                                                   : RADIO_OFF_BATTERY_MS;
+    }
+    return msUntilUplink >= offAfterMs + RADIO_WAKE_LEAD_MS ? RadioMode::OFF
+                                                             : RadioMode::MODEM_SLEEP;
+}
+
+#endif
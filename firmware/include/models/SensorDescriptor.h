@@ -0,0 +1,64 @@
+#ifndef SENSOR_DESCRIPTOR_H
+#define SENSOR_DESCRIPTOR_H
+
+#include <cstdint>
+
+#include "AveragedData.h"
+#include "SensorReadings.h"
+#include "SensorType.h"
+
+/**
+ * What differs between the sensor fields, one row per SensorType in enum order.
+ * Averaging, the display buffer, upload bodies, the display pages and reading
+ * validation loop over SENSOR_DESCRIPTORS instead of switching on the type, so a new
+ * field is a new row (plus its struct members), not an edit in every consumer.
+ */
+struct SensorDescriptor {
+    SensorType type;
+    const char* label;      // Summary row ("BME280 Temp")
+    const char* title;      // Graph page title ("BME280 Temperature")
+    const char* shortName;  // Glance row ("BME280")
+    const char* unit;       // Display unit ("C")
+    const char* jsonKey;    // Upload field and columnar column ("bme280_temp_c")
+    uint8_t busBit;         // SENSOR_*_BIT of the bus that measures it
+    float minValid;         // Physically possible range (SensorManager::validateReading())
+    float maxValid;
+    float SensorReadings::*reading;      // Field in a reading
+    float AveragedData::*average;        // Window average
+    SensorSpread AveragedData::*spread;  // Window min/max/stddev
+};
+
+constexpr SensorDescriptor SENSOR_DESCRIPTORS[NUM_SENSORS] = {
+    {SensorType::BME280_TEMP, "BME280 Temp", "BME280 Temperature", "BME280", "C",
+     "bme280_temp_c", SENSOR_BME280_BIT, -40.0f, 85.0f, &SensorReadings::bme280Temp,
+     &AveragedData::avgBme280Temp, &AveragedData::bme280TempSpread},
+    {SensorType::DS18B20_TEMP, "DS18B20 Temp", "DS18B20 Temperature", "DS18B20", "C",
+     "ds18b20_temp_c", SENSOR_DS18B20_BIT, -55.0f, 125.0f, &SensorReadings::ds18b20Temp,
+     &AveragedData::avgDs18b20Temp, &AveragedData::ds18b20TempSpread},
+    {SensorType::HUMIDITY, "Humidity", "Humidity", "Humidity", "%", "humidity_pct",
+     SENSOR_BME280_BIT, 0.0f, 100.0f, &SensorReadings::humidity, &AveragedData::avgHumidity,
+     &AveragedData::humiditySpread},
+    {SensorType::PRESSURE, "Pressure", "Pressure", "Pressure", "hPa", "pressure_hpa",
+     SENSOR_BME280_BIT, 300.0f, 1100.0f, &SensorReadings::pressure, &AveragedData::avgPressure,
+     &AveragedData::pressureSpread},
+    {SensorType::SOIL_MOISTURE, "Soil Moisture", "Soil Moisture", "Soil", "%",
+     "soil_moisture_pct", SENSOR_SOIL_BIT, 0.0f, 100.0f, &SensorReadings::soilMoisture,
+     &AveragedData::avgSoilMoisture, &AveragedData::soilMoistureSpread},
+};
+
+// Row for a type (type must be a valid SensorType)
+constexpr const SensorDescriptor& sensorDescriptor(SensorType type) {
+    return SENSOR_DESCRIPTORS[static_cast<uint8_t>(type)];
+}
+
+constexpr bool sensorDescriptorsInEnumOrder() {
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        if (static_cast<uint8_t>(SENSOR_DESCRIPTORS[i].type) != i) {
+            return false;
+        }
+    }
+    return true;
+}
+static_assert(sensorDescriptorsInEnumOrder(), "SENSOR_DESCRIPTORS must follow SensorType order");
+
+#endif  // SENSOR_DESCRIPTOR_H
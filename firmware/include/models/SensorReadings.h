@@ -3,6 +3,16 @@
 
 #include <cstdint>
 
+#include "SensorType.h"
+
+// Sensor status bit positions (sensorStatus / staleMask)
+#define SENSOR_BME280_BIT 0
+#define SENSOR_DS18B20_BIT 1
+#define SENSOR_SOIL_BIT 2
+
+// Physical sensor buses, indexed by status bit (BME280, DS18B20, soil ADC)
+constexpr uint8_t NUM_SENSOR_BUSES = 3;
+
 /**
  * SensorReadings structure holds data from all sensors at a single point in time.
  * This structure is used for collecting raw sensor data before averaging.
@@ -16,6 +26,11 @@ struct SensorReadings {
     uint16_t soilMoistureRaw;  // ADC value (0-4095) - raw soil moisture reading
     uint8_t sensorStatus;      // Bitmask: bit per sensor (1 = available, 0 = unavailable)
     uint32_t monotonicMs;      // millis() - monotonic clock timestamp
+    uint32_t ds18b20AgeMs;     // ms since the probe conversion completed (0 = fresh)
+    float ds18b20Probes[MAX_DS18B20_PROBES];  // Celsius per probe (index 0 == ds18b20Temp)
+    uint8_t ds18b20ProbeCount;                // Probes found on the OneWire bus
+    uint8_t staleMask;  // Bitmask: sensor not due this cycle, value carried over from last sample
+    uint32_t readLatencyUs[NUM_SENSOR_BUSES];  // Bus transaction time per sensor (0 = not sampled)
 };
 
 #endif
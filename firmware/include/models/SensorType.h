@@ -7,4 +7,7 @@ enum class SensorType : uint8_t { BME280_TEMP, DS18B20_TEMP, HUMIDITY, PRESSURE,
 
 constexpr uint8_t NUM_SENSORS = 5;
 
+// Maximum DS18B20 probes on the OneWire bus (e.g. depth probes in one bed)
+constexpr uint8_t MAX_DS18B20_PROBES = 4;
+
 #endif
@@ -0,0 +1,19 @@
+#ifndef SOIL_AGGREGATE_H
+#define SOIL_AGGREGATE_H
+
+#include <cstdint>
+
+/**
+ * Raw soil moisture ADC samples accumulated by the ULP coprocessor during deep sleep.
+ * The ULP has no multiplier, so there is no sum of squares: only count, sum and range.
+ */
+struct SoilAggregate {
+    uint16_t count;   // Samples taken while asleep
+    uint32_t sumRaw;  // Sum of the raw 12-bit readings
+    uint16_t minRaw;
+    uint16_t maxRaw;
+    uint32_t elapsedMs;  // First to last sample
+    bool thresholdWake;  // Woken early by a soilMoistureThresholdLow/High crossing
+};
+
+#endif
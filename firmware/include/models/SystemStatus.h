@@ -1,20 +1,45 @@
 #ifndef SYSTEM_STATUS_H
 #define SYSTEM_STATUS_H
 
+#include "BootProfile.h"
+#include "EnergyProfile.h"
 #include "ErrorCounters.h"
+#include "LatencyStats.h"
+#include "LoopProfile.h"
+#include "OutboundQueueStats.h"
 #include "SensorReadings.h"
+#include "TaskStats.h"
 #include <cstdint>
 
 struct SystemStatus {
     unsigned long uptimeMs;
     uint32_t freeHeap;
+    uint32_t minFreeHeap;         // Lowest free heap since boot
+    uint32_t largestFreeBlock;    // Largest internal block one allocation can get
+    uint32_t loopAllocations;     // Heap allocations in the last loop() pass
+    uint32_t maxLoopAllocations;  // Most allocations in one pass since boot
+    bool allocationsTracked;      // HeapTrace hooks are built in (else the two above are 0)
     int8_t wifiRssi;
     uint16_t queueDepth;
     uint16_t bootCount;
     unsigned long lastTransmissionMs;  // Timestamp of last successful transmission
+    uint32_t wifiConnectMs;            // Association start to IP for the last connect (0 = none)
     ErrorCounters errors;
     SensorReadings minValues;
     SensorReadings maxValues;
+    LatencyStats sensorLatency[NUM_SENSOR_BUSES];  // Indexed by SENSOR_*_BIT
+    OutboundQueueStats outboundQueue;              // Flash spill/drain/GC counters
+    LatencyStats networkLatency[NUM_NETWORK_PHASES];  // Upload/registration request phases
+    uint32_t netBytesSent;                            // Request bodies since boot
+    uint32_t netBytesReceived;                        // Response bodies since boot
+    BootProfile bootProfile;                          // Startup phase durations
+    bool bootProfilePending;  // Not yet in a successful upload (sent once per boot)
+    EnergyReport energy;      // Estimated charge per subsystem since boot (or energy reset)
+    bool postMortemPending;   // ErrorLogger holds a post-mortem log not yet uploaded
+    LoopPhaseSummary loopPhases[NUM_LOOP_PHASES];  // p95 and worst case per loop() phase
+    TaskStats tasks[MAX_MONITORED_TASKS];          // Stack high-water mark and CPU per task
+    uint8_t taskCount;
+    bool metricsDue;  // The next upload carries the health block (see setMetricsInterval())
 };
 
 #endif
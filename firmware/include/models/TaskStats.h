@@ -0,0 +1,22 @@
+#ifndef TASK_STATS_H
+#define TASK_STATS_H
+
+#include <cstdint>
+
+constexpr uint8_t MAX_MONITORED_TASKS = 6;  // loop, acquisition, display, network, log, spare
+
+// cpuPercent when FreeRTOS run-time stats are not built in
+constexpr uint8_t TASK_CPU_UNKNOWN = 0xFF;
+
+/**
+ * Stack and CPU use of one FreeRTOS task, as last sampled by TaskMonitor.
+ */
+struct TaskStats {
+    const char* name;            // Static string
+    uint32_t stackBytes;         // Allocated stack
+    uint32_t minFreeStackBytes;  // uxTaskGetStackHighWaterMark(): least free stack seen
+    uint8_t cpuPercent;          // Share of one core over the last sample period
+    bool stackLow;               // Free stack fell under TASK_STACK_WARN_BYTES
+};
+
+#endif
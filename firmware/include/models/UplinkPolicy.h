@@ -0,0 +1,94 @@
+#ifndef UPLINK_POLICY_H
+#define UPLINK_POLICY_H
+
+#include <cstdint>
+#include <string.h>
+
+/**
+ * When closed averaging windows are sent. Windows that are not sent yet wait in the
+ * transmit backlog and go out together with the next upload.
+ * - EVERY_WINDOW: upload as soon as a window closes (default)
+ * - EVERY_N: upload every uplinkWindows windows
+ * - INTERVAL: upload once uplinkIntervalSec worth of windows has accumulated
+ * - ADAPTIVE: every window with a full battery, every uplinkWindows windows below
+ *             ADAPTIVE_MID_PERCENT and twice that below ADAPTIVE_LOW_PERCENT
+ */
+enum class UplinkPolicy : uint8_t { EVERY_WINDOW, EVERY_N, INTERVAL, ADAPTIVE };
+
+#define UPLINK_ADAPTIVE_MID_PERCENT 60
+#define UPLINK_ADAPTIVE_LOW_PERCENT 30
+
+// Config file names for each policy (index = enum value)
+inline const char* uplinkPolicyName(UplinkPolicy policy) {
+    switch (policy) {
+        case UplinkPolicy::EVERY_WINDOW:
+            return "every_window";
+        case UplinkPolicy::EVERY_N:
+            return "every_n";
+        case UplinkPolicy::INTERVAL:
+            return "interval";
+        case UplinkPolicy::ADAPTIVE:
+            return "adaptive";
+        default:
+            return "every_window";
+    }
+}
+
+// Parse a config file policy name; unknown names fall back to EVERY_WINDOW
+inline UplinkPolicy uplinkPolicyFromName(const char* name) {
+    if (name) {
+        if (strcmp(name, "every_n") == 0) {
+            return UplinkPolicy::EVERY_N;
+        }
+        if (strcmp(name, "interval") == 0) {
+            return UplinkPolicy::INTERVAL;
+        }
+        if (strcmp(name, "adaptive") == 0) {
+            return UplinkPolicy::ADAPTIVE;
+        }
+    }
+    return UplinkPolicy::EVERY_WINDOW;
+}
+
+/**
+ * Number of closed windows per upload under a policy
+ * @param windows uplinkWindows (0 is treated as 1)
+ * @param intervalSec uplinkIntervalSec
+ * @param windowSec Length of one averaging window
+ * @param batteryPercent Battery level; pass 100 on mains power
+ * @param limit Upper bound, the backlog that survives until the upload (at least 1)
+ * @return Windows to accumulate, between 1 and limit
+ */
+inline uint16_t uplinkStride(UplinkPolicy policy, uint8_t windows, uint32_t intervalSec,
+                             uint32_t windowSec, uint8_t batteryPercent, uint16_t limit) {
+    uint32_t stride = 1;
+    uint32_t perUpload = windows > 0 ? windows : 1;
+    switch (policy) {
+        case UplinkPolicy::EVERY_N:
+            stride = perUpload;
+            break;
+        case UplinkPolicy::INTERVAL:
+            if (windowSec > 0) {
+                stride = (intervalSec + windowSec - 1) / windowSec;  // Round up
+            }
+            break;
+        case UplinkPolicy::ADAPTIVE:
+            if (batteryPercent < UPLINK_ADAPTIVE_LOW_PERCENT) {
+                stride = perUpload * 2;
+            } else if (batteryPercent < UPLINK_ADAPTIVE_MID_PERCENT) {
+                stride = perUpload;
+            }
+            break;
+        default:
+            break;
+    }
+    if (stride < 1) {
+        stride = 1;
+    }
+    if (limit < 1) {
+        limit = 1;
+    }
+    return stride > limit ? limit : static_cast<uint16_t>(stride);
+}
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef UPLOAD_TRANSPORT_H
+#define UPLOAD_TRANSPORT_H
+
+#include <cstdint>
+#include <string.h>
+
+/**
+ * How upload bodies reach the backend.
+ * - HTTP: one POST per body to apiEndpoint over a kept-alive HTTP(S) connection
+ * - MQTT: one QoS 1 PUBLISH per body over a long-lived MQTT(S) connection with a
+ *         persistent session; the broker's PUBACK confirms every reading in the body
+ */
+enum class UploadTransport : uint8_t { HTTP, MQTT };
+
+// Config file names for each transport (index = enum value)
+inline const char* uploadTransportName(UploadTransport transport) {
+    switch (transport) {
+        case UploadTransport::HTTP:
+            return "http";
+        case UploadTransport::MQTT:
+            return "mqtt";
+        default:
+            return "http";
+    }
+}
+
+// Parse a config file transport name; unknown names fall back to HTTP
+inline UploadTransport uploadTransportFromName(const char* name) {
+    if (name && strcmp(name, "mqtt") == 0) {
+        return UploadTransport::MQTT;
+    }
+    return UploadTransport::HTTP;
+}
+
+#endif
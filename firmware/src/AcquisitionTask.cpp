@@ -0,0 +1,132 @@
+#ifndef UNIT_TEST
+#include "AcquisitionTask.h"
+
+#include "PowerLock.h"
+#include "TaskMonitor.h"
+
+AcquisitionTask::AcquisitionTask(SensorManager& sensorManager)
+    : sensors(sensorManager),
+      periodMs(5000),
+      droppedCount(0),
+      busyMs(0),
+      sensorsReady(false),
+      sensorInitMs(0),
+      warmStart(false),
+      taskHandle(nullptr),
+      consumerHandle(nullptr) {}
+
+AcquisitionTask::~AcquisitionTask() {
+    stop();
+}
+
+bool AcquisitionTask::start(uint32_t initialPeriodMs, bool warm) {
+    if (taskHandle) {
+        return true;
+    }
+
+    periodMs = initialPeriodMs;
+    warmStart = warm;
+    sensorsReady = false;
+    queue.clear();
+
+    BaseType_t result = xTaskCreatePinnedToCore(&AcquisitionTask::taskEntry, "acquisition",
+                                                STACK_SIZE, this, TASK_PRIORITY, &taskHandle,
+                                                TASK_CORE);
+    if (result != pdPASS) {
+        Serial.println("[ERROR] AcquisitionTask: Failed to create task");
+        taskHandle = nullptr;
+        return false;
+    }
+    TaskMonitor::add("acquisition", taskHandle, STACK_SIZE);
+
+    Serial.printf("[INFO] AcquisitionTask: Started (period %lu ms, core %d, priority %u)\n",
+                  (unsigned long)periodMs, TASK_CORE, TASK_PRIORITY);
+    return true;
+}
+
+void AcquisitionTask::stop() {
+    if (taskHandle) {
+        TaskMonitor::remove(taskHandle);
+        vTaskDelete(taskHandle);
+        taskHandle = nullptr;
+    }
+    queue.clear();
+}
+
+void AcquisitionTask::setPeriodMs(uint32_t newPeriodMs) {
+    if (newPeriodMs > 0) {
+        periodMs = newPeriodMs;
+    }
+}
+
+bool AcquisitionTask::waitForSensors(uint32_t timeoutMs) {
+    uint32_t start = millis();
+    while (taskHandle && !sensorsReady) {
+        if (millis() - start >= timeoutMs) {
+            return false;
+        }
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    return sensorsReady;
+}
+
+bool AcquisitionTask::receive(SensorReadings& out) {
+    return queue.pop(out);
+}
+
+bool AcquisitionTask::waitForReading(uint32_t timeoutMs) {
+    if (!taskHandle) {
+        delay(timeoutMs);
+        return false;
+    }
+
+    // Register before checking, so a reading published in between still notifies
+    consumerHandle = xTaskGetCurrentTaskHandle();
+    if (!queue.empty()) {
+        return true;
+    }
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs));
+    return !queue.empty();
+}
+
+bool AcquisitionTask::isRunning() const {
+    return taskHandle != nullptr;
+}
+
+void AcquisitionTask::taskEntry(void* arg) {
+    static_cast<AcquisitionTask*>(arg)->run();
+}
+
+void AcquisitionTask::run() {
+    // Init retries and conversion waits block only this task
+    uint32_t initStart = millis();
+    PowerLock::acquire();
+    sensors.initialize(warmStart);
+    PowerLock::release();
+    sensorInitMs = millis() - initStart;
+    sensorsReady = true;
+
+    TickType_t lastWake = xTaskGetTickCount();
+
+    for (;;) {
+        uint32_t readStart = millis();
+        PowerLock::acquire();  // I2C and OneWire transfers must not be cut by light sleep
+        SensorReadings readings = sensors.readSensors();
+        PowerLock::release();
+        busyMs = busyMs + (millis() - readStart);
+
+        // Never block on a stalled consumer: a full ring drops this reading
+        if (!queue.push(readings)) {
+            droppedCount++;
+        }
+        TaskHandle_t consumer = consumerHandle;
+        if (consumer) {
+            xTaskNotifyGive(consumer);
+        }
+
+        // Fixed-rate schedule; DS18B20 conversions started by readSensors() complete meanwhile
+        vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(periodMs));
+    }
+}
+
+#endif  // UNIT_TEST
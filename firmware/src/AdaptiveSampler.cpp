@@ -0,0 +1,81 @@
+#include "AdaptiveSampler.h"
+
+#include <math.h>
+
+AdaptiveSampler::AdaptiveSampler() : tracks(), activity(0.0f), paceStep(0), quietReadings(0) {}
+
+void AdaptiveSampler::reset() {
+    for (uint8_t i = 0; i < NUM_SIGNALS; i++) {
+        tracks[i].valid = false;
+    }
+    activity = 0.0f;
+    paceStep = 0;
+    quietReadings = 0;
+}
+
+float AdaptiveSampler::rateOf(Signal signal, float value, uint32_t timeMs, float fastPerMin) {
+    Track& track = tracks[signal];
+    float rate = 0.0f;
+    if (track.valid && timeMs != track.timeMs) {
+        float minutes = (timeMs - track.timeMs) / 60000.0f;
+        rate = fabsf(value - track.value) / minutes / fastPerMin;
+    }
+    track.value = value;
+    track.timeMs = timeMs;
+    track.valid = true;
+    return rate;
+}
+
+void AdaptiveSampler::addReading(const SensorReadings& readings) {
+    uint8_t fresh = readings.sensorStatus & ~readings.staleMask;
+    float peak = 0.0f;
+
+    if (fresh & (1 << SENSOR_SOIL_BIT)) {
+        peak = fmaxf(peak, rateOf(SIGNAL_SOIL, readings.soilMoisture, readings.monotonicMs,
+                                  ADAPTIVE_SOIL_FAST_PER_MIN));
+    }
+    if (fresh & (1 << SENSOR_BME280_BIT)) {
+        peak = fmaxf(peak, rateOf(SIGNAL_BME280_TEMP, readings.bme280Temp, readings.monotonicMs,
+                                  ADAPTIVE_TEMP_FAST_PER_MIN));
+    }
+    if (fresh & (1 << SENSOR_DS18B20_BIT)) {
+        peak = fmaxf(peak, rateOf(SIGNAL_DS18B20_TEMP, readings.ds18b20Temp, readings.monotonicMs,
+                                  ADAPTIVE_TEMP_FAST_PER_MIN));
+    }
+
+    // Fast attack, slow release: one quick change keeps the fast pace for a few readings
+    activity = fmaxf(peak, activity * ADAPTIVE_ACTIVITY_DECAY);
+
+    if (activity >= 1.0f) {
+        paceStep = -1;
+        quietReadings = 0;
+    } else if (activity >= ADAPTIVE_QUIET_ACTIVITY) {
+        paceStep = 0;
+        quietReadings = 0;
+    } else if (paceStep < 0) {
+        paceStep = 0;  // Event over: back to the base before slowing down
+    } else if (++quietReadings >= ADAPTIVE_QUIET_READINGS) {
+        quietReadings = 0;
+        if (paceStep < ADAPTIVE_MAX_SLOW_STEPS) {
+            paceStep++;
+        }
+    }
+}
+
+uint32_t AdaptiveSampler::getIntervalMs(uint32_t baseMs, BatteryLevel level,
+                                        bool slowWhenFlat) const {
+    if (paceStep < 0) {
+        uint32_t speedup = level == BatteryLevel::NORMAL       ? ADAPTIVE_SPEEDUP
+                           : level == BatteryLevel::LOW_CHARGE ? ADAPTIVE_LOW_SPEEDUP
+                                                               : 1;
+        uint32_t fastMs = baseMs / speedup;
+        if (fastMs < ADAPTIVE_MIN_INTERVAL_MS) {
+            fastMs = baseMs < ADAPTIVE_MIN_INTERVAL_MS ? baseMs : ADAPTIVE_MIN_INTERVAL_MS;
+        }
+        return fastMs;
+    }
+    if (paceStep > 0 && slowWhenFlat) {
+        return baseMs << paceStep;
+    }
+    return baseMs;
+}
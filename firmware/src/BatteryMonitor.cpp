@@ -0,0 +1,40 @@
+#include "BatteryMonitor.h"
+
+BatteryMonitor::BatteryMonitor() : filtered(0.0f), seeded(false), level(BatteryLevel::NORMAL) {}
+
+void BatteryMonitor::addSample(float volts) {
+    if (!seeded) {
+        filtered = volts;
+        seeded = true;
+    } else {
+        filtered += BATTERY_FILTER_ALPHA * (volts - filtered);
+    }
+
+    // Falling: enter a lower level at its threshold. Rising: leave it with hysteresis
+    if (filtered < BATTERY_CRITICAL_VOLTAGE) {
+        level = BatteryLevel::CRITICAL;
+    } else if (filtered < BATTERY_LOW_VOLTAGE) {
+        if (level != BatteryLevel::CRITICAL ||
+            filtered >= BATTERY_CRITICAL_VOLTAGE + BATTERY_LEVEL_HYSTERESIS) {
+            level = BatteryLevel::LOW_CHARGE;
+        }
+    } else if (level == BatteryLevel::NORMAL ||
+               filtered >= BATTERY_LOW_VOLTAGE + BATTERY_LEVEL_HYSTERESIS) {
+        level = BatteryLevel::NORMAL;
+    } else if (level == BatteryLevel::CRITICAL &&
+               filtered >= BATTERY_CRITICAL_VOLTAGE + BATTERY_LEVEL_HYSTERESIS) {
+        level = BatteryLevel::LOW_CHARGE;
+    }
+}
+
+uint8_t BatteryMonitor::getPercent() const {
+    if (filtered >= BATTERY_FULL_VOLTAGE) {
+        return 100;
+    }
+    if (filtered <= BATTERY_EMPTY_VOLTAGE) {
+        return 0;
+    }
+    float percentage = (filtered - BATTERY_EMPTY_VOLTAGE) /
+                       (BATTERY_FULL_VOLTAGE - BATTERY_EMPTY_VOLTAGE) * 100.0f;
+    return static_cast<uint8_t>(percentage);
+}
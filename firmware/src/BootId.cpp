@@ -25,21 +25,21 @@ String BootId::generate() {
     // - 4 indicates version 4
     // - y is one of 8, 9, A, or B (variant bits)
 
-    String uuid = "";
+    TextBuffer<UUID_LENGTH + 1> uuid;
 
     // First group: 8 hex characters
-    uuid += randomHex(8);
-    uuid += "-";
+    appendRandomHex(uuid, 8);
+    uuid.append('-');
 
     // Second group: 4 hex characters
-    uuid += randomHex(4);
-    uuid += "-";
+    appendRandomHex(uuid, 4);
+    uuid.append('-');
 
     // Third group: 4 hex characters with version bits
     // First character must be '4' for UUID v4
-    uuid += "4";
-    uuid += randomHex(3);
-    uuid += "-";
+    uuid.append('4');
+    appendRandomHex(uuid, 3);
+    uuid.append('-');
 
     // Fourth group: 4 hex characters with variant bits
     // First character must be 8, 9, A, or B
@@ -50,23 +50,23 @@ String BootId::generate() {
     uint32_t variantValue = rand() % 4;
 #endif
     char variantChars[] = {'8', '9', 'A', 'B'};
-    uuid += variantChars[variantValue];
-    uuid += randomHex(3);
-    uuid += "-";
+    uuid.append(variantChars[variantValue]);
+    appendRandomHex(uuid, 3);
+    uuid.append('-');
 
     // Fifth group: 12 hex characters
-    uuid += randomHex(12);
+    appendRandomHex(uuid, 12);
 
 #ifdef ARDUINO
     Serial.printf("[INFO] Generated Boot ID: %s\n", uuid.c_str());
 #endif
 
-    return uuid;
+    return String(uuid.c_str());
 }
 
 bool BootId::isValidUuid(const String& uuid) {
     // Check length: 8-4-4-4-12 = 36 characters including hyphens
-    if (uuid.length() != 36) {
+    if (uuid.length() != UUID_LENGTH) {
 #ifdef ARDUINO
         Serial.printf("[ERROR] Invalid UUID length: %d (expected 36)\n", uuid.length());
 #endif
@@ -123,23 +123,14 @@ bool BootId::isValidUuid(const String& uuid) {
     return true;
 }
 
-String BootId::randomHex(int length) {
-    String hex = "";
-
+void BootId::appendRandomHex(TextBuffer<UUID_LENGTH + 1>& text, int length) {
+    static const char DIGITS[] = "0123456789ABCDEF";
     for (int i = 0; i < length; i++) {
 #ifdef ARDUINO
         uint32_t randomValue = esp_random() % 16;
 #else
         uint32_t randomValue = rand() % 16;
 #endif
-
-        // Convert to hex character (0-9, A-F)
-        if (randomValue < 10) {
-            hex += (char)('0' + randomValue);
-        } else {
-            hex += (char)('A' + (randomValue - 10));
-        }
+        text.append(DIGITS[randomValue]);
     }
-
-    return hex;
 }
@@ -0,0 +1,99 @@
+#include "BootProfiler.h"
+
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_attr.h>
+#else
+#define RTC_DATA_ATTR  // Plain static storage on the host
+#endif
+
+namespace {
+
+constexpr uint32_t BOOT_PROFILE_MAGIC = 0x31504F42;  // "BOP1"
+
+struct BootProfileImage {
+    uint32_t magic;  // Set once a boot has been profiled; RTC memory is garbage at power-on
+    BootProfile current;
+    BootProfile previous;
+};
+
+RTC_DATA_ATTR BootProfileImage bootImage;
+
+// Start times of the running phases; only meaningful within one boot
+uint32_t phaseStartMs[NUM_BOOT_PHASES];
+uint8_t startedMask = 0;
+uint32_t bootStartMs = 0;
+bool hasPrevious = false;
+
+const char* const PHASE_KEYS[NUM_BOOT_PHASES] = {"config_file", "nvs",  "display", "touch",
+                                                 "sensors",     "wifi", "ntp"};
+
+}  // namespace
+
+void BootProfiler::beginBoot(uint32_t nowMs) {
+    hasPrevious = bootImage.magic == BOOT_PROFILE_MAGIC;
+    if (hasPrevious) {
+        bootImage.previous = bootImage.current;
+    }
+    memset(&bootImage.current, 0, sizeof(bootImage.current));
+    bootImage.magic = BOOT_PROFILE_MAGIC;
+
+    startedMask = 0;
+    bootStartMs = nowMs;
+}
+
+void BootProfiler::start(BootPhase phase, uint32_t nowMs) {
+    if (phase >= NUM_BOOT_PHASES) {
+        return;
+    }
+    phaseStartMs[phase] = nowMs;
+    startedMask |= 1 << phase;
+}
+
+bool BootProfiler::finish(BootPhase phase, uint32_t nowMs) {
+    if (!isStarted(phase)) {
+        return false;
+    }
+    bootImage.current.phaseMs[phase] += nowMs - phaseStartMs[phase];
+    bootImage.current.doneMask |= 1 << phase;
+    startedMask &= ~(1 << phase);
+    return true;
+}
+
+void BootProfiler::record(BootPhase phase, uint32_t durationMs) {
+    if (phase >= NUM_BOOT_PHASES) {
+        return;
+    }
+    bootImage.current.phaseMs[phase] += durationMs;
+    bootImage.current.doneMask |= 1 << phase;
+}
+
+bool BootProfiler::isStarted(BootPhase phase) {
+    return phase < NUM_BOOT_PHASES && (startedMask & (1 << phase));
+}
+
+bool BootProfiler::isFinished(BootPhase phase) {
+    return phase < NUM_BOOT_PHASES && (bootImage.current.doneMask & (1 << phase));
+}
+
+void BootProfiler::endSetup(uint32_t nowMs) {
+    bootImage.current.setupMs = nowMs - bootStartMs;
+}
+
+const BootProfile& BootProfiler::current() {
+    return bootImage.current;
+}
+
+bool BootProfiler::previous(BootProfile& out) {
+    if (!hasPrevious) {
+        return false;
+    }
+    out = bootImage.previous;
+    return true;
+}
+
+const char* BootProfiler::phaseKey(BootPhase phase) {
+    return phase < NUM_BOOT_PHASES ? PHASE_KEYS[phase] : "unknown";
+}
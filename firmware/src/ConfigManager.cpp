@@ -1,21 +1,125 @@
 #include "ConfigManager.h"
 
+#include "HardwareId.h"
+#include "RenderScheduler.h"
+#include "TextBuffer.h"
+
 #ifdef ARDUINO
-#define MAX_PUBLISH_SAMPLES 120
+#include <nvs.h>
+#include <string.h>
+
+#define MAX_PUBLISH_SAMPLES 3600
 #define MIN_READING_INTERVAL_MS 1000
 #define MAX_READING_INTERVAL_MS 3600000
 #define MIN_PUBLISH_INTERVAL_SAMPLES 1
 #define MIN_PAGE_CYCLE_INTERVAL_MS 1000
 #define MAX_PAGE_CYCLE_INTERVAL_MS 60000
 #define MAX_ADC_VALUE 4095
+
+// A save is written once no further save was requested for this long
+#define CONFIG_SAVE_DEBOUNCE_MS 500
+
+namespace {
+
+/**
+ * Writes config keys through one NVS handle and commits once. Keys whose value matches the
+ * copy last written are skipped. The key types match what Preferences uses (bool as u8,
+ * float as a 4-byte blob), so Preferences reads them back unchanged.
+ */
+class NvsBatch {
+   public:
+    NvsBatch(nvs_handle_t nvsHandle, bool haveBaseline)
+        : handle(nvsHandle), compare(haveBaseline), ok(true), written(0) {}
+
+    void putString(const char* key, const String& value, const String& stored) {
+        if (!skip(value == stored)) {
+            check(nvs_set_str(handle, key, value.c_str()));
+        }
+    }
+
+    void putUInt(const char* key, uint32_t value, uint32_t stored) {
+        if (!skip(value == stored)) {
+            check(nvs_set_u32(handle, key, value));
+        }
+    }
+
+    void putUShort(const char* key, uint16_t value, uint16_t stored) {
+        if (!skip(value == stored)) {
+            check(nvs_set_u16(handle, key, value));
+        }
+    }
+
+    void putUChar(const char* key, uint8_t value, uint8_t stored) {
+        if (!skip(value == stored)) {
+            check(nvs_set_u8(handle, key, value));
+        }
+    }
+
+    void putBool(const char* key, bool value, bool stored) {
+        putUChar(key, value ? 1 : 0, stored ? 1 : 0);
+    }
+
+    void putFloat(const char* key, float value, float stored) {
+        if (!skip(memcmp(&value, &stored, sizeof(float)) == 0)) {
+            check(nvs_set_blob(handle, key, &value, sizeof(float)));
+        }
+    }
+
+    /**
+     * Commit the keys written so far (nothing to commit if no key changed)
+     * @return true if every write and the commit succeeded
+     */
+    bool commit() {
+        if (written > 0) {
+            check(nvs_commit(handle));
+        }
+        return ok;
+    }
+
+    uint16_t getWrittenCount() const { return written; }
+
+   private:
+    nvs_handle_t handle;
+    bool compare;
+    bool ok;
+    uint16_t written;
+
+    bool skip(bool unchanged) {
+        if (compare && unchanged) {
+            return true;
+        }
+        written++;
+        return false;
+    }
+
+    void check(esp_err_t result) {
+        if (result != ESP_OK) {
+            ok = false;
+        }
+    }
+};
+
+}  // namespace
 #endif
 
 ConfigManager::ConfigManager()
-    : registrationCallback(nullptr),
+    : configVersion(1),
+      publishedSnapshot(0),
+      snapshotHolds(),
+#ifdef ARDUINO
+      snapshotMux(portMUX_INITIALIZER_UNLOCKED),
+#endif
+      registrationCallback(nullptr),
       bootIdRef(nullptr),
       touchDetected(false),
       touchType(TouchControllerType::NONE),
-      provisioningMode(false) {}
+      provisioningMode(false),
+      prompt(ConfigPrompt::NONE),
+      persisted(),
+      persistedValid(false),
+      savePending(false),
+      saveRequestedMs(0),
+      confirmationIdLoaded(false) {}
 
 ConfigManager::~ConfigManager() {
 #ifdef ARDUINO
@@ -134,21 +238,53 @@ bool ConfigManager::loadConfig() {
         config.deviceId = nvs.getString("deviceId", "");
 
         config.readingIntervalMs = nvs.getUInt("readingInt", 5000);
+        config.bme280IntervalMs = nvs.getUInt("bmeInt", 0);
+        config.ds18b20IntervalMs = nvs.getUInt("dsInt", 0);
+        config.soilIntervalMs = nvs.getUInt("soilInt", 0);
         config.publishIntervalSamples = nvs.getUShort("publishInt", 20);
+        config.alignWindows = nvs.getBool("alignWindows", true);
+        config.eventUplink = nvs.getBool("eventUplink", true);
         config.pageCycleIntervalMs = nvs.getUShort("pageCycle", 10000);
+        config.displayMaxFps = nvs.getUChar("dispFps", RENDER_DEFAULT_MAX_FPS);
 
         config.soilDryAdc = nvs.getUShort("soilDryAdc", 3000);
         config.soilWetAdc = nvs.getUShort("soilWetAdc", 1500);
+        config.soilSampleWindow = nvs.getUChar("soilWindow", 15);
+        config.ds18b20Resolution = nvs.getUChar("dsResolution", 12);
 
         config.temperatureInFahrenheit = nvs.getBool("tempF", false);
         config.soilMoistureThresholdLow = nvs.getUShort("soilThreshLow", 30);
         config.soilMoistureThresholdHigh = nvs.getUShort("soilThreshHigh", 70);
 
         config.batteryMode = nvs.getBool("batteryMode", false);
+        config.bme280Profile = nvs.getUChar("bmeProfile", 0);
+        config.dataBufferCapacity = nvs.getUShort("bufCapacity", 0);
+        config.displayHistoryPoints = nvs.getUShort("histPoints", 0);
+        config.payloadFormat = nvs.getUChar("payloadFmt", 0);
+        config.staticIp = nvs.getString("staticIp", "");
+        config.staticGateway = nvs.getString("staticGw", "");
+        config.staticSubnet = nvs.getString("staticMask", "");
+        config.staticDns = nvs.getString("staticDns", "");
+        config.uploadTransport = nvs.getUChar("transport", 0);
+        config.mqttUrl = nvs.getString("mqttUrl", "");
+        config.mqttTopic = nvs.getString("mqttTopic", "");
+        config.uplinkPolicy = nvs.getUChar("uplinkPolicy", 0);
+        config.uplinkWindows = nvs.getUChar("uplinkWindows", 4);
+        config.uplinkIntervalSec = nvs.getUInt("uplinkIntvl", 900);
+        config.metricsIntervalSec = nvs.getUInt("metricsIntvl", 3600);
+        config.ntpMaxAgeSec = nvs.getUInt("ntpMaxAge", 21600);
+        config.deadbandTemp = nvs.getFloat("dbTemp", 0.0f);
+        config.deadbandHumidity = nvs.getFloat("dbHumidity", 0.0f);
+        config.deadbandPressure = nvs.getFloat("dbPressure", 0.0f);
+        config.deadbandSoil = nvs.getFloat("dbSoil", 0.0f);
+        config.deadbandHeartbeat = nvs.getUChar("dbHeartbeat", 12);
 
         // TLS/HTTPS configuration
         config.tlsValidateServer = nvs.getBool("tlsValidate", true);
         config.allowHttpFallback = nvs.getBool("httpFallback", false);
+        markConfigChanged();
+        persisted = config;  // NVS now holds exactly these values
+        persistedValid = true;
 
         if (validateConfig()) {
             // Migrate NVS config to file for future boots
@@ -169,37 +305,119 @@ bool ConfigManager::loadConfig() {
 }
 
 bool ConfigManager::saveConfig() {
+    markConfigChanged();
 #ifdef ARDUINO
     if (!validateConfig()) {
         Serial.println("Cannot save invalid configuration");
         return false;
     }
 
-    // Save to NVS first (existing behavior)
-    nvs.putString("wifiSsid", config.wifiSsid);
-    nvs.putString("wifiPass", config.wifiPassword);
-    nvs.putString("apiEndpoint", config.apiEndpoint);
-    nvs.putString("apiToken", config.apiToken);
-    nvs.putString("deviceId", config.deviceId);
-
-    nvs.putUInt("readingInt", config.readingIntervalMs);
-    nvs.putUShort("publishInt", config.publishIntervalSamples);
-    nvs.putUShort("pageCycle", config.pageCycleIntervalMs);
+    // Coalesce back-to-back saves; processPendingSave() writes once they stop
+    savePending = true;
+    saveRequestedMs = millis();
+    return true;
+#else
+    return false;
+#endif
+}
 
-    nvs.putUShort("soilDryAdc", config.soilDryAdc);
-    nvs.putUShort("soilWetAdc", config.soilWetAdc);
+void ConfigManager::processPendingSave() {
+    publishSnapshot();  // A change that found the spare copy held
+#ifdef ARDUINO
+    if (savePending && millis() - saveRequestedMs >= CONFIG_SAVE_DEBOUNCE_MS) {
+        flushPendingSave();
+    }
+#endif
+}
 
-    nvs.putBool("tempF", config.temperatureInFahrenheit);
-    nvs.putUShort("soilThreshLow", config.soilMoistureThresholdLow);
-    nvs.putUShort("soilThreshHigh", config.soilMoistureThresholdHigh);
+bool ConfigManager::flushPendingSave() {
+    if (!savePending) {
+        return true;
+    }
+    savePending = false;
+    return writeConfig();
+}
 
-    nvs.putBool("batteryMode", config.batteryMode);
+bool ConfigManager::writeConfig() {
+#ifdef ARDUINO
+    // Save to NVS first (existing behavior), only the keys that changed
+    nvs_handle_t handle;
+    if (nvs_open("config", NVS_READWRITE, &handle) != ESP_OK) {
+        Serial.println("[ERROR] ConfigManager: Failed to open NVS");
+        return false;
+    }
+    NvsBatch batch(handle, persistedValid);
+    batch.putString("wifiSsid", config.wifiSsid, persisted.wifiSsid);
+    batch.putString("wifiPass", config.wifiPassword, persisted.wifiPassword);
+    batch.putString("apiEndpoint", config.apiEndpoint, persisted.apiEndpoint);
+    batch.putString("apiToken", config.apiToken, persisted.apiToken);
+    batch.putString("deviceId", config.deviceId, persisted.deviceId);
+
+    batch.putUInt("readingInt", config.readingIntervalMs, persisted.readingIntervalMs);
+    batch.putUInt("bmeInt", config.bme280IntervalMs, persisted.bme280IntervalMs);
+    batch.putUInt("dsInt", config.ds18b20IntervalMs, persisted.ds18b20IntervalMs);
+    batch.putUInt("soilInt", config.soilIntervalMs, persisted.soilIntervalMs);
+    batch.putUShort("publishInt", config.publishIntervalSamples, persisted.publishIntervalSamples);
+    batch.putBool("alignWindows", config.alignWindows, persisted.alignWindows);
+    batch.putBool("eventUplink", config.eventUplink, persisted.eventUplink);
+    batch.putUShort("pageCycle", config.pageCycleIntervalMs, persisted.pageCycleIntervalMs);
+    batch.putUChar("dispFps", config.displayMaxFps, persisted.displayMaxFps);
+
+    batch.putUShort("soilDryAdc", config.soilDryAdc, persisted.soilDryAdc);
+    batch.putUShort("soilWetAdc", config.soilWetAdc, persisted.soilWetAdc);
+    batch.putUChar("soilWindow", config.soilSampleWindow, persisted.soilSampleWindow);
+    batch.putUChar("dsResolution", config.ds18b20Resolution, persisted.ds18b20Resolution);
+
+    batch.putBool("tempF", config.temperatureInFahrenheit, persisted.temperatureInFahrenheit);
+    batch.putUShort("soilThreshLow", config.soilMoistureThresholdLow,
+                    persisted.soilMoistureThresholdLow);
+    batch.putUShort("soilThreshHigh", config.soilMoistureThresholdHigh,
+                    persisted.soilMoistureThresholdHigh);
+
+    batch.putBool("batteryMode", config.batteryMode, persisted.batteryMode);
+    batch.putUChar("bmeProfile", config.bme280Profile, persisted.bme280Profile);
+    batch.putUShort("bufCapacity", config.dataBufferCapacity, persisted.dataBufferCapacity);
+    batch.putUShort("histPoints", config.displayHistoryPoints, persisted.displayHistoryPoints);
+    batch.putUChar("payloadFmt", config.payloadFormat, persisted.payloadFormat);
+    batch.putString("staticIp", config.staticIp, persisted.staticIp);
+    batch.putString("staticGw", config.staticGateway, persisted.staticGateway);
+    batch.putString("staticMask", config.staticSubnet, persisted.staticSubnet);
+    batch.putString("staticDns", config.staticDns, persisted.staticDns);
+    batch.putUChar("transport", config.uploadTransport, persisted.uploadTransport);
+    batch.putString("mqttUrl", config.mqttUrl, persisted.mqttUrl);
+    batch.putString("mqttTopic", config.mqttTopic, persisted.mqttTopic);
+    batch.putUChar("uplinkPolicy", config.uplinkPolicy, persisted.uplinkPolicy);
+    batch.putUChar("uplinkWindows", config.uplinkWindows, persisted.uplinkWindows);
+    batch.putUInt("uplinkIntvl", config.uplinkIntervalSec, persisted.uplinkIntervalSec);
+    batch.putUInt("metricsIntvl", config.metricsIntervalSec, persisted.metricsIntervalSec);
+    batch.putUInt("ntpMaxAge", config.ntpMaxAgeSec, persisted.ntpMaxAgeSec);
+    batch.putFloat("dbTemp", config.deadbandTemp, persisted.deadbandTemp);
+    batch.putFloat("dbHumidity", config.deadbandHumidity, persisted.deadbandHumidity);
+    batch.putFloat("dbPressure", config.deadbandPressure, persisted.deadbandPressure);
+    batch.putFloat("dbSoil", config.deadbandSoil, persisted.deadbandSoil);
+    batch.putUChar("dbHeartbeat", config.deadbandHeartbeat, persisted.deadbandHeartbeat);
 
     // TLS/HTTPS configuration
-    nvs.putBool("tlsValidate", config.tlsValidateServer);
-    nvs.putBool("httpFallback", config.allowHttpFallback);
+    batch.putBool("tlsValidate", config.tlsValidateServer, persisted.tlsValidateServer);
+    batch.putBool("httpFallback", config.allowHttpFallback, persisted.allowHttpFallback);
+
+    batch.putBool("initialized", true, persistedValid);
 
-    nvs.putBool("initialized", true);
+    if (!batch.commit()) {
+        nvs_close(handle);
+        Serial.println("[ERROR] ConfigManager: NVS write failed");
+        return false;
+    }
+    nvs_close(handle);
+
+    uint16_t writtenKeys = batch.getWrittenCount();
+    if (writtenKeys == 0) {
+        Serial.println("[INFO] ConfigManager: Configuration unchanged, nothing written");
+        return true;
+    }
+    persisted = config;
+    persistedValid = true;
+    Serial.printf("[INFO] ConfigManager: %u NVS key(s) written, one commit\n", writtenKeys);
 
     // Also save to config file (atomic write)
     ConfigFileData fileData;
@@ -215,6 +433,8 @@ bool ConfigManager::saveConfig() {
     // Calculate upload interval from publish samples and reading interval
     uint32_t uploadIntervalMs = config.publishIntervalSamples * config.readingIntervalMs;
     fileData.dataUploadInterval = uploadIntervalMs / 1000;  // ms to seconds
+    fileData.alignWindows = config.alignWindows;
+    fileData.eventUplink = config.eventUplink;
 
     // Display brightness - use default since not in Config struct
     fileData.displayBrightness = 128;
@@ -222,6 +442,26 @@ bool ConfigManager::saveConfig() {
     // Battery mode maps to enableDeepSleep
     fileData.enableDeepSleep = config.batteryMode;
 
+    fileData.bme280Profile = bme280ProfileName(static_cast<Bme280Profile>(config.bme280Profile));
+    fileData.payloadFormat = payloadFormatName(static_cast<PayloadFormat>(config.payloadFormat));
+    fileData.staticIp = config.staticIp;
+    fileData.staticGateway = config.staticGateway;
+    fileData.staticSubnet = config.staticSubnet;
+    fileData.staticDns = config.staticDns;
+    fileData.transport = uploadTransportName(static_cast<UploadTransport>(config.uploadTransport));
+    fileData.mqttUrl = config.mqttUrl;
+    fileData.mqttTopic = config.mqttTopic;
+    fileData.uplinkPolicy = uplinkPolicyName(static_cast<UplinkPolicy>(config.uplinkPolicy));
+    fileData.uplinkWindows = config.uplinkWindows;
+    fileData.uplinkInterval = config.uplinkIntervalSec;
+    fileData.metricsInterval = config.metricsIntervalSec;
+    fileData.ntpMaxAge = config.ntpMaxAgeSec;
+    fileData.deadbandTemp = config.deadbandTemp;
+    fileData.deadbandHumidity = config.deadbandHumidity;
+    fileData.deadbandPressure = config.deadbandPressure;
+    fileData.deadbandSoil = config.deadbandSoil;
+    fileData.deadbandHeartbeat = config.deadbandHeartbeat;
+
     // Save to file
     if (fileManager.saveConfig(fileData)) {
         Serial.println("[INFO] Configuration saved to both NVS and file");
@@ -246,21 +486,51 @@ void ConfigManager::setDefaults() {
     config.deviceId = "esp32-sensor-001";
 
     config.readingIntervalMs = 5000;
+    config.bme280IntervalMs = 0;
+    config.ds18b20IntervalMs = 0;
+    config.soilIntervalMs = 0;
     config.publishIntervalSamples = 20;
+    config.alignWindows = true;
+    config.eventUplink = true;
     config.pageCycleIntervalMs = 10000;
+    config.displayMaxFps = RENDER_DEFAULT_MAX_FPS;
 
     config.soilDryAdc = 3000;
     config.soilWetAdc = 1500;
+    config.soilSampleWindow = 15;
+    config.ds18b20Resolution = 12;
 
     config.temperatureInFahrenheit = false;
     config.soilMoistureThresholdLow = 30;
     config.soilMoistureThresholdHigh = 70;
 
     config.batteryMode = false;
+    config.bme280Profile = static_cast<uint8_t>(Bme280Profile::WEATHER_STATION);
+    config.dataBufferCapacity = 0;    // Auto (PSRAM)
+    config.displayHistoryPoints = 0;  // Auto (PSRAM)
+    config.payloadFormat = static_cast<uint8_t>(PayloadFormat::ROWS);
+    config.staticIp = "";  // DHCP
+    config.staticGateway = "";
+    config.staticSubnet = "";
+    config.staticDns = "";
+    config.uploadTransport = static_cast<uint8_t>(UploadTransport::HTTP);
+    config.mqttUrl = "";
+    config.mqttTopic = "";
+    config.uplinkPolicy = static_cast<uint8_t>(UplinkPolicy::EVERY_WINDOW);
+    config.uplinkWindows = 4;
+    config.uplinkIntervalSec = 900;
+    config.metricsIntervalSec = 3600;
+    config.ntpMaxAgeSec = 21600;
+    config.deadbandTemp = 0.0f;  // Report-by-exception off
+    config.deadbandHumidity = 0.0f;
+    config.deadbandPressure = 0.0f;
+    config.deadbandSoil = 0.0f;
+    config.deadbandHeartbeat = 12;
 
     // TLS/HTTPS defaults
     config.tlsValidateServer = true;   // Enable certificate validation by default
     config.allowHttpFallback = false;  // Disable HTTP fallback by default
+    markConfigChanged();
 }
 
 bool ConfigManager::validateConfig() {
@@ -348,54 +618,37 @@ bool ConfigManager::validateCalibration() {
         return false;
     }
 
-    return true;
-}
-
-void ConfigManager::handleSerialConfig() {
-#ifdef ARDUINO
-    if (!Serial.available()) {
-        return;
+    if (config.soilSampleWindow < 1 || config.soilSampleWindow > 32) {
+        return false;
     }
 
-    // If in provisioning mode, handle provisioning commands
-    if (provisioningMode) {
-        handleProvisioningSerialInput();
-        return;
+    if (config.ds18b20Resolution < 9 || config.ds18b20Resolution > 12) {
+        return false;
     }
 
-    String command = Serial.readStringUntil('\n');
-    command.trim();
-
-    if (command == "config") {
-        printConfigMenu();
-    } else if (command == "show") {
-        printCurrentConfig();
-    } else if (command == "wifi") {
-        updateWiFiCredentials();
-    } else if (command == "api") {
-        updateApiEndpoint();
-    } else if (command == "intervals") {
-        updateIntervals();
-    } else if (command == "calibrate") {
-        updateCalibration();
-    } else if (command == "deviceid") {
-        updateDeviceId();
-    } else if (command == "save") {
-        if (validateConfig()) {
-            if (saveConfig()) {
-                Serial.println("Configuration saved successfully");
-            } else {
-                Serial.println("Failed to save configuration");
-            }
-        } else {
-            Serial.println("Invalid configuration - cannot save");
-        }
-    } else if (command == "defaults") {
+    return true;
+}
+
+void ConfigManager::registerSerialCommands(SerialCommandReader& reader) {
+    reader.setLineFilter([this](const char* line) { return filterSerialLine(line); });
+
+    reader.addCommand("config", [this](const char*) { printConfigMenu(); });
+    reader.addCommand("help", [this](const char*) { printConfigMenu(); });
+    reader.addCommand("show", [this](const char*) { printCurrentConfig(); });
+    reader.addCommand("wifi", [this](const char*) { updateWiFiCredentials(); });
+    reader.addCommand("api", [this](const char*) { updateApiEndpoint(); });
+    reader.addCommand("intervals", [this](const char*) { updateIntervals(); });
+    reader.addCommand("calibrate", [this](const char*) { updateCalibration(); });
+    reader.addCommand("deviceid", [this](const char*) { updateDeviceId(); });
+    reader.addCommand("save", [this](const char*) { handleSaveCommand(); });
+    reader.addCommand("defaults", [this](const char*) {
         setDefaults();
+#ifdef ARDUINO
         Serial.println("Configuration reset to defaults");
-    } else if (command == "help") {
-        printConfigMenu();
-    } else if (command == "register") {
+#endif
+    });
+    reader.addCommand("register", [this](const char*) {
+#ifdef ARDUINO
         // Trigger manual registration via callback
         Serial.println("Triggering manual registration...");
         if (registrationCallback) {
@@ -403,12 +656,17 @@ void ConfigManager::handleSerialConfig() {
         } else {
             Serial.println("ERROR: Registration callback not set");
         }
-    } else if (command == "hwid") {
-// Display hardware ID (MAC address)
-#include "HardwareId.h"
+#endif
+    });
+    reader.addCommand("hwid", [](const char*) {
+#ifdef ARDUINO
+        // Display hardware ID (MAC address)
         Serial.print("Hardware ID: ");
         Serial.println(HardwareId::getHardwareId());
-    } else if (command == "bootid") {
+#endif
+    });
+    reader.addCommand("bootid", [this](const char*) {
+#ifdef ARDUINO
         // Display current Boot ID
         if (bootIdRef) {
             Serial.print("Boot ID: ");
@@ -416,6 +674,35 @@ void ConfigManager::handleSerialConfig() {
         } else {
             Serial.println("ERROR: Boot ID not available");
         }
+#endif
+    });
+}
+
+bool ConfigManager::filterSerialLine(const char* line) {
+    if (prompt != ConfigPrompt::NONE) {
+        handlePromptLine(String(line));
+        return true;
+    }
+    // In provisioning mode only provisioning commands are accepted
+    if (provisioningMode) {
+        if (*line != '\0') {
+            handleProvisioningCommand(String(line));
+        }
+        return true;
+    }
+    return false;
+}
+
+void ConfigManager::handleSaveCommand() {
+#ifdef ARDUINO
+    if (validateConfig()) {
+        if (saveConfig()) {
+            Serial.println("Configuration save scheduled");
+        } else {
+            Serial.println("Failed to save configuration");
+        }
+    } else {
+        Serial.println("Invalid configuration - cannot save");
     }
 #endif
 }
@@ -433,6 +720,9 @@ void ConfigManager::printConfigMenu() {
     Serial.println("save      - Save configuration to NVS");
     Serial.println("defaults  - Reset to default configuration");
     Serial.println("diag      - Show system diagnostics");
+    Serial.println("graph     - Set graph span (graph 4h | 24h | 7d)");
+    Serial.println("energy    - Energy per subsystem (energy reset | energy <state> <mA>)");
+    Serial.println("touch     - Re-detect the touch controller (touch detect)");
     Serial.println("register  - Manually trigger device registration");
     Serial.println("hwid      - Display hardware ID (MAC address)");
     Serial.println("bootid    - Display current boot ID");
@@ -456,14 +746,27 @@ void ConfigManager::printCurrentConfig() {
     Serial.println(config.deviceId);
     Serial.print("Reading Interval (ms): ");
     Serial.println(config.readingIntervalMs);
+    Serial.print("BME280/DS18B20/Soil Interval (ms, 0 = every reading): ");
+    Serial.printf("%lu/%lu/%lu\n", (unsigned long)config.bme280IntervalMs,
+                  (unsigned long)config.ds18b20IntervalMs, (unsigned long)config.soilIntervalMs);
     Serial.print("Publish Interval (samples): ");
     Serial.println(config.publishIntervalSamples);
+    Serial.print("Align Windows: ");
+    Serial.println(config.alignWindows ? "Yes" : "No");
+    Serial.print("Event Uplink: ");
+    Serial.println(config.eventUplink ? "Yes" : "No");
     Serial.print("Page Cycle Interval (ms): ");
     Serial.println(config.pageCycleIntervalMs);
+    Serial.print("Display Max FPS: ");
+    Serial.println(config.displayMaxFps);
     Serial.print("Soil Dry ADC: ");
     Serial.println(config.soilDryAdc);
     Serial.print("Soil Wet ADC: ");
     Serial.println(config.soilWetAdc);
+    Serial.print("Soil Sample Window: ");
+    Serial.println(config.soilSampleWindow);
+    Serial.print("DS18B20 Resolution (bits): ");
+    Serial.println(config.ds18b20Resolution);
     Serial.print("Temperature in Fahrenheit: ");
     Serial.println(config.temperatureInFahrenheit ? "Yes" : "No");
     Serial.print("Soil Moisture Threshold Low: ");
@@ -472,6 +775,28 @@ void ConfigManager::printCurrentConfig() {
     Serial.println(config.soilMoistureThresholdHigh);
     Serial.print("Battery Mode: ");
     Serial.println(config.batteryMode ? "Yes" : "No");
+    Serial.print("BME280 Profile: ");
+    Serial.println(bme280ProfileName(static_cast<Bme280Profile>(config.bme280Profile)));
+    Serial.print("Buffer Capacity / History Points (0 = auto): ");
+    Serial.printf("%u/%u\n", config.dataBufferCapacity, config.displayHistoryPoints);
+    Serial.print("Payload Format: ");
+    Serial.println(payloadFormatName(static_cast<PayloadFormat>(config.payloadFormat)));
+    Serial.print("Static IP: ");
+    Serial.println(config.staticIp.length() > 0 ? config.staticIp : String("DHCP"));
+    Serial.print("Upload Transport: ");
+    Serial.println(uploadTransportName(static_cast<UploadTransport>(config.uploadTransport)));
+    Serial.print("Uplink Policy: ");
+    Serial.printf("%s (%u windows / %lu s)\n",
+                  uplinkPolicyName(static_cast<UplinkPolicy>(config.uplinkPolicy)),
+                  config.uplinkWindows, (unsigned long)config.uplinkIntervalSec);
+    Serial.print("Metrics Interval: ");
+    Serial.printf("%lu s\n", (unsigned long)config.metricsIntervalSec);
+    Serial.print("NTP Max Age: ");
+    Serial.printf("%lu s\n", (unsigned long)config.ntpMaxAgeSec);
+    Serial.print("Deadband (C/%/hPa/%, heartbeat): ");
+    Serial.printf("%.2f/%.2f/%.2f/%.2f, %u windows\n", config.deadbandTemp,
+                  config.deadbandHumidity, config.deadbandPressure, config.deadbandSoil,
+                  config.deadbandHeartbeat);
     Serial.println("============================\n");
 #endif
 }
@@ -480,124 +805,130 @@ void ConfigManager::updateWiFiCredentials() {
 #ifdef ARDUINO
     Serial.println("\n=== Update WiFi Credentials ===");
     Serial.print("Enter WiFi SSID: ");
-    while (!Serial.available()) {
-    }
-    config.wifiSsid = Serial.readStringUntil('\n');
-    config.wifiSsid.trim();
-
-    Serial.print("Enter WiFi Password: ");
-    while (!Serial.available()) {
-    }
-    config.wifiPassword = Serial.readStringUntil('\n');
-    config.wifiPassword.trim();
-
-    if (validateWiFiCredentials()) {
-        Serial.println("WiFi credentials updated");
-    } else {
-        Serial.println("Invalid WiFi credentials");
-    }
 #endif
+    prompt = ConfigPrompt::WIFI_SSID;
 }
 
 void ConfigManager::updateApiEndpoint() {
 #ifdef ARDUINO
     Serial.println("\n=== Update API Configuration ===");
     Serial.print("Enter API Endpoint URL: ");
-    while (!Serial.available()) {
-    }
-    config.apiEndpoint = Serial.readStringUntil('\n');
-    config.apiEndpoint.trim();
-
-    Serial.print("Enter API Token: ");
-    while (!Serial.available()) {
-    }
-    config.apiToken = Serial.readStringUntil('\n');
-    config.apiToken.trim();
-
-    if (validateApiEndpoint()) {
-        Serial.println("API configuration updated");
-    } else {
-        Serial.println("Invalid API endpoint");
-    }
 #endif
+    prompt = ConfigPrompt::API_ENDPOINT;
 }
 
 void ConfigManager::updateIntervals() {
 #ifdef ARDUINO
     Serial.println("\n=== Update Intervals ===");
     Serial.print("Enter Reading Interval (ms, 1000-3600000): ");
-    while (!Serial.available()) {
-    }
-    config.readingIntervalMs = Serial.readStringUntil('\n').toInt();
-
-    Serial.print("Enter Publish Interval (samples, 1-120): ");
-    while (!Serial.available()) {
-    }
-    config.publishIntervalSamples = Serial.readStringUntil('\n').toInt();
-
-    Serial.print("Enter Page Cycle Interval (ms, 1000-60000): ");
-    while (!Serial.available()) {
-    }
-    config.pageCycleIntervalMs = Serial.readStringUntil('\n').toInt();
-
-    if (validateIntervals()) {
-        Serial.println("Intervals updated");
-    } else {
-        Serial.println("Invalid interval values");
-    }
 #endif
+    prompt = ConfigPrompt::READING_INTERVAL;
 }
 
 void ConfigManager::updateCalibration() {
 #ifdef ARDUINO
     Serial.println("\n=== Update Soil Moisture Calibration ===");
     Serial.println("Place sensor in DRY soil and press Enter");
-    while (!Serial.available()) {
-    }
-    Serial.readStringUntil('\n');
-
-    Serial.print("Enter Dry ADC value (0-4095): ");
-    while (!Serial.available()) {
-    }
-    config.soilDryAdc = Serial.readStringUntil('\n').toInt();
-
-    Serial.println("Place sensor in WET soil and press Enter");
-    while (!Serial.available()) {
-    }
-    Serial.readStringUntil('\n');
-
-    Serial.print("Enter Wet ADC value (0-4095): ");
-    while (!Serial.available()) {
-    }
-    config.soilWetAdc = Serial.readStringUntil('\n').toInt();
-
-    if (validateCalibration()) {
-        Serial.println("Calibration updated");
-        Serial.print("Dry ADC: ");
-        Serial.println(config.soilDryAdc);
-        Serial.print("Wet ADC: ");
-        Serial.println(config.soilWetAdc);
-    } else {
-        Serial.println("Invalid calibration values (Dry must be > Wet, both 0-4095)");
-    }
 #endif
+    prompt = ConfigPrompt::SOIL_DRY_READY;
 }
 
 void ConfigManager::updateDeviceId() {
 #ifdef ARDUINO
     Serial.println("\n=== Update Device ID ===");
     Serial.print("Enter Device ID: ");
-    while (!Serial.available()) {
-    }
-    config.deviceId = Serial.readStringUntil('\n');
-    config.deviceId.trim();
+#endif
+    prompt = ConfigPrompt::DEVICE_ID;
+}
 
-    if (config.deviceId.length() > 0) {
-        Serial.println("Device ID updated");
-    } else {
-        Serial.println("Invalid Device ID");
-        config.deviceId = "esp32-sensor-001";
+void ConfigManager::handlePromptLine(const String& value) {
+#ifdef ARDUINO
+    // Each answer stores its value and asks the next question; the last one validates
+    ConfigPrompt answered = prompt;
+    prompt = ConfigPrompt::NONE;
+    switch (answered) {
+        case ConfigPrompt::WIFI_SSID:
+            config.wifiSsid = value;
+            Serial.print("Enter WiFi Password: ");
+            prompt = ConfigPrompt::WIFI_PASSWORD;
+            break;
+        case ConfigPrompt::WIFI_PASSWORD:
+            config.wifiPassword = value;
+            if (validateWiFiCredentials()) {
+                Serial.println("WiFi credentials updated");
+            } else {
+                Serial.println("Invalid WiFi credentials");
+            }
+            break;
+        case ConfigPrompt::API_ENDPOINT:
+            config.apiEndpoint = value;
+            Serial.print("Enter API Token: ");
+            prompt = ConfigPrompt::API_TOKEN;
+            break;
+        case ConfigPrompt::API_TOKEN:
+            config.apiToken = value;
+            if (validateApiEndpoint()) {
+                Serial.println("API configuration updated");
+            } else {
+                Serial.println("Invalid API endpoint");
+            }
+            break;
+        case ConfigPrompt::READING_INTERVAL:
+            config.readingIntervalMs = value.toInt();
+            Serial.print("Enter Publish Interval (samples, 1-3600): ");
+            prompt = ConfigPrompt::PUBLISH_INTERVAL;
+            break;
+        case ConfigPrompt::PUBLISH_INTERVAL:
+            config.publishIntervalSamples = value.toInt();
+            Serial.print("Enter Page Cycle Interval (ms, 1000-60000): ");
+            prompt = ConfigPrompt::PAGE_CYCLE_INTERVAL;
+            break;
+        case ConfigPrompt::PAGE_CYCLE_INTERVAL:
+            config.pageCycleIntervalMs = value.toInt();
+            if (validateIntervals()) {
+                Serial.println("Intervals updated");
+            } else {
+                Serial.println("Invalid interval values");
+            }
+            break;
+        case ConfigPrompt::SOIL_DRY_READY:
+            Serial.print("Enter Dry ADC value (0-4095): ");
+            prompt = ConfigPrompt::SOIL_DRY_ADC;
+            break;
+        case ConfigPrompt::SOIL_DRY_ADC:
+            config.soilDryAdc = value.toInt();
+            Serial.println("Place sensor in WET soil and press Enter");
+            prompt = ConfigPrompt::SOIL_WET_READY;
+            break;
+        case ConfigPrompt::SOIL_WET_READY:
+            Serial.print("Enter Wet ADC value (0-4095): ");
+            prompt = ConfigPrompt::SOIL_WET_ADC;
+            break;
+        case ConfigPrompt::SOIL_WET_ADC:
+            config.soilWetAdc = value.toInt();
+            if (validateCalibration()) {
+                Serial.println("Calibration updated");
+                Serial.print("Dry ADC: ");
+                Serial.println(config.soilDryAdc);
+                Serial.print("Wet ADC: ");
+                Serial.println(config.soilWetAdc);
+            } else {
+                Serial.println("Invalid calibration values (Dry must be > Wet, both 0-4095)");
+            }
+            break;
+        case ConfigPrompt::DEVICE_ID:
+            config.deviceId = value;
+            if (config.deviceId.length() > 0) {
+                Serial.println("Device ID updated");
+            } else {
+                Serial.println("Invalid Device ID");
+                config.deviceId = "esp32-sensor-001";
+            }
+            break;
+        case ConfigPrompt::NONE:
+            break;
     }
+    markConfigChanged();
 #endif
 }
 
@@ -630,9 +961,66 @@ Config& ConfigManager::getConfig() {
     return config;
 }
 
+const ConfigSnapshot& ConfigManager::acquireSnapshot() {
+#ifdef ARDUINO
+    portENTER_CRITICAL(&snapshotMux);
+#endif
+    uint8_t index = publishedSnapshot;
+    snapshotHolds[index]++;
+#ifdef ARDUINO
+    portEXIT_CRITICAL(&snapshotMux);
+#endif
+    return snapshots[index];
+}
+
+void ConfigManager::releaseSnapshot(const ConfigSnapshot& held) {
+    uint8_t index = &held == &snapshots[1] ? 1 : 0;
+#ifdef ARDUINO
+    portENTER_CRITICAL(&snapshotMux);
+#endif
+    if (snapshotHolds[index] > 0) {
+        snapshotHolds[index]--;
+    }
+#ifdef ARDUINO
+    portEXIT_CRITICAL(&snapshotMux);
+#endif
+}
+
+void ConfigManager::publishSnapshot() {
+    // Only this task writes publishedSnapshot, so reading it needs no lock
+    uint8_t spare = publishedSnapshot ^ 1;
+    if (snapshots[publishedSnapshot].getVersion() == configVersion) {
+        return;
+    }
+#ifdef ARDUINO
+    portENTER_CRITICAL(&snapshotMux);
+#endif
+    bool held = snapshotHolds[spare] > 0;
+#ifdef ARDUINO
+    portEXIT_CRITICAL(&snapshotMux);
+#endif
+    if (held) {
+        return;  // A reader still has the previous snapshot; retried from the loop
+    }
+
+    // Unpublished, so no other task can acquire it while it is rebuilt
+    snapshots[spare].rebuild(config, configVersion);
+#ifdef ARDUINO
+    portENTER_CRITICAL(&snapshotMux);
+#endif
+    publishedSnapshot = spare;
+#ifdef ARDUINO
+    portEXIT_CRITICAL(&snapshotMux);
+#endif
+}
+
 String ConfigManager::getConfirmationId() {
 #ifdef ARDUINO
-    return nvs.getString("dev.confirm_id", "");
+    if (!confirmationIdLoaded) {
+        confirmationIdCache = nvs.getString("dev.confirm_id", "");
+        confirmationIdLoaded = true;
+    }
+    return confirmationIdCache;
 #else
     return "";
 #endif
@@ -640,7 +1028,15 @@ String ConfigManager::getConfirmationId() {
 
 void ConfigManager::setConfirmationId(const String& confirmationId) {
 #ifdef ARDUINO
-    nvs.putString("dev.confirm_id", confirmationId);
+    // Re-registration usually returns the same ID; skip the write and commit then
+    if (getConfirmationId() == confirmationId) {
+        return;
+    }
+    if (nvs.putString("dev.confirm_id", confirmationId) > 0 || confirmationId.length() == 0) {
+        confirmationIdCache = confirmationId;
+    } else {
+        confirmationIdLoaded = false;  // Unknown what NVS holds; re-read next time
+    }
 #endif
 }
 
@@ -726,6 +1122,8 @@ void ConfigManager::applyConfigFileData(const ConfigFileData& fileData) {
     config.wifiPassword = fileData.wifiPassword;
     config.apiEndpoint = fileData.backendUrl;
     config.deviceId = fileData.friendlyName;
+    config.alignWindows = fileData.alignWindows;
+    config.eventUplink = fileData.eventUplink;
 
     // Convert intervals
     // dataUploadInterval (seconds) -> publishIntervalSamples
@@ -751,9 +1149,34 @@ void ConfigManager::applyConfigFileData(const ConfigFileData& fileData) {
     // Battery mode maps to enableDeepSleep
     config.batteryMode = fileData.enableDeepSleep;
 
+    config.bme280Profile =
+        static_cast<uint8_t>(bme280ProfileFromName(fileData.bme280Profile.c_str()));
+    config.payloadFormat =
+        static_cast<uint8_t>(payloadFormatFromName(fileData.payloadFormat.c_str()));
+    config.staticIp = fileData.staticIp;
+    config.staticGateway = fileData.staticGateway;
+    config.staticSubnet = fileData.staticSubnet;
+    config.staticDns = fileData.staticDns;
+    config.uploadTransport =
+        static_cast<uint8_t>(uploadTransportFromName(fileData.transport.c_str()));
+    config.mqttUrl = fileData.mqttUrl;
+    config.mqttTopic = fileData.mqttTopic;
+    config.uplinkPolicy =
+        static_cast<uint8_t>(uplinkPolicyFromName(fileData.uplinkPolicy.c_str()));
+    config.uplinkWindows = fileData.uplinkWindows;
+    config.uplinkIntervalSec = fileData.uplinkInterval;
+    config.metricsIntervalSec = fileData.metricsInterval;
+    config.ntpMaxAgeSec = fileData.ntpMaxAge;
+    config.deadbandTemp = fileData.deadbandTemp;
+    config.deadbandHumidity = fileData.deadbandHumidity;
+    config.deadbandPressure = fileData.deadbandPressure;
+    config.deadbandSoil = fileData.deadbandSoil;
+    config.deadbandHeartbeat = fileData.deadbandHeartbeat;
+
     // Keep existing values for fields not in ConfigFileData
     // (soilDryAdc, soilWetAdc, temperatureInFahrenheit, thresholds, pageCycleIntervalMs, etc.)
     // These will be loaded from NVS or use defaults
+    markConfigChanged();
 }
 
 void ConfigManager::migrateNvsToFile() {
@@ -775,6 +1198,8 @@ void ConfigManager::migrateNvsToFile() {
     // Calculate upload interval from publish samples and reading interval
     uint32_t uploadIntervalMs = config.publishIntervalSamples * config.readingIntervalMs;
     fileData.dataUploadInterval = uploadIntervalMs / 1000;  // ms to seconds
+    fileData.alignWindows = config.alignWindows;
+    fileData.eventUplink = config.eventUplink;
 
     // Display brightness - use default since not in Config struct
     fileData.displayBrightness = 128;
@@ -782,6 +1207,26 @@ void ConfigManager::migrateNvsToFile() {
     // Battery mode maps to enableDeepSleep
     fileData.enableDeepSleep = config.batteryMode;
 
+    fileData.bme280Profile = bme280ProfileName(static_cast<Bme280Profile>(config.bme280Profile));
+    fileData.payloadFormat = payloadFormatName(static_cast<PayloadFormat>(config.payloadFormat));
+    fileData.staticIp = config.staticIp;
+    fileData.staticGateway = config.staticGateway;
+    fileData.staticSubnet = config.staticSubnet;
+    fileData.staticDns = config.staticDns;
+    fileData.transport = uploadTransportName(static_cast<UploadTransport>(config.uploadTransport));
+    fileData.mqttUrl = config.mqttUrl;
+    fileData.mqttTopic = config.mqttTopic;
+    fileData.uplinkPolicy = uplinkPolicyName(static_cast<UplinkPolicy>(config.uplinkPolicy));
+    fileData.uplinkWindows = config.uplinkWindows;
+    fileData.uplinkInterval = config.uplinkIntervalSec;
+    fileData.metricsInterval = config.metricsIntervalSec;
+    fileData.ntpMaxAge = config.ntpMaxAgeSec;
+    fileData.deadbandTemp = config.deadbandTemp;
+    fileData.deadbandHumidity = config.deadbandHumidity;
+    fileData.deadbandPressure = config.deadbandPressure;
+    fileData.deadbandSoil = config.deadbandSoil;
+    fileData.deadbandHeartbeat = config.deadbandHeartbeat;
+
     Serial.printf("[INFO] ConfigManager: NVS config values:\n");
     Serial.printf("[INFO]   wifi_ssid: %s\n", fileData.wifiSsid.c_str());
     Serial.printf("[INFO]   backend_url: %s\n", fileData.backendUrl.c_str());
@@ -819,21 +1264,17 @@ bool ConfigManager::hasRequiredFields() {
 }
 
 String ConfigManager::getMissingRequiredFields() {
-    String missing = "";
+    TextBuffer<64> missing;
 
     if (config.wifiSsid.length() == 0) {
-        if (missing.length() > 0)
-            missing += ", ";
-        missing += "wifi_ssid";
+        missing.append("wifi_ssid");
     }
 
     if (config.apiEndpoint.length() == 0) {
-        if (missing.length() > 0)
-            missing += ", ";
-        missing += "backend_url";
+        missing.appendf("%sbackend_url", missing.empty() ? "" : ", ");
     }
 
-    return missing;
+    return String(missing.c_str());
 }
 
 void ConfigManager::setTouchDetected(bool detected, TouchControllerType type) {
@@ -905,15 +1346,8 @@ void ConfigManager::enterProvisioningMode() {
 #endif
 }
 
-void ConfigManager::handleProvisioningSerialInput() {
+void ConfigManager::handleProvisioningCommand(const String& command) {
 #ifdef ARDUINO
-    if (!Serial.available()) {
-        return;
-    }
-
-    String command = Serial.readStringUntil('\n');
-    command.trim();
-
     if (command.startsWith("provision_wifi ")) {
         // Parse: provision_wifi <ssid> <password>
         String params = command.substring(15);  // Skip "provision_wifi "
@@ -987,31 +1421,31 @@ void ConfigManager::handleProvisioningSerialInput() {
     } else if (command == "provision_save") {
         // Validate all required fields
         bool valid = true;
-        String errors = "";
+        TextBuffer<160> errors;
 
         if (provisioningWifiSsid.length() == 0) {
             valid = false;
-            errors += "  - WiFi SSID is required\n";
+            errors.append("  - WiFi SSID is required\n");
         } else if (provisioningWifiSsid.length() > 128) {
             valid = false;
-            errors += "  - WiFi SSID too long (max 128 characters)\n";
+            errors.append("  - WiFi SSID too long (max 128 characters)\n");
         }
 
         if (provisioningBackendUrl.length() == 0) {
             valid = false;
-            errors += "  - Backend URL is required\n";
+            errors.append("  - Backend URL is required\n");
         } else if (!provisioningBackendUrl.startsWith("http://") &&
                    !provisioningBackendUrl.startsWith("https://")) {
             valid = false;
-            errors += "  - Backend URL must start with http:// or https://\n";
+            errors.append("  - Backend URL must start with http:// or https://\n");
         } else if (provisioningBackendUrl.length() > 128) {
             valid = false;
-            errors += "  - Backend URL too long (max 128 characters)\n";
+            errors.append("  - Backend URL too long (max 128 characters)\n");
         }
 
         if (!valid) {
             Serial.println("[ERROR] Cannot save configuration:");
-            Serial.print(errors);
+            Serial.print(errors.c_str());
             Serial.println("Use 'provision_status' to check current values");
             Serial.printf("[ERROR] ConfigManager: Provisioning save failed - validation errors\n");
             return;
@@ -1025,8 +1459,8 @@ void ConfigManager::handleProvisioningSerialInput() {
         config.wifiPassword = provisioningWifiPassword;
         config.apiEndpoint = provisioningBackendUrl;
 
-        // Save to both NVS and config file
-        bool nvsSuccess = saveConfig();
+        // Save to both NVS and config file; written now, the device reboots next
+        bool nvsSuccess = saveConfig() && flushPendingSave();
         bool fileSuccess = false;
 
         // Save to config file
@@ -0,0 +1,135 @@
+#include "ConfigSnapshot.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+const char HTTPS_PREFIX[] = "https://";
+const size_t HTTPS_PREFIX_LENGTH = sizeof(HTTPS_PREFIX) - 1;
+const char MQTTS_PREFIX[] = "mqtts://";
+
+}  // namespace
+
+ConfigSnapshot::ConfigSnapshot()
+    : config(), version(0), https(false), explicitPort(0), mqttPort(0), mqttTls(false) {}
+
+void ConfigSnapshot::rebuild(const Config& source, uint32_t changeCount) {
+    config = source;
+    version = changeCount;
+
+    const char* endpoint = config.apiEndpoint.c_str();
+    https = strncmp(endpoint, HTTPS_PREFIX, HTTPS_PREFIX_LENGTH) == 0;
+    const char* pathStart = parseAuthority(endpoint, host, explicitPort);
+    path = pathStart ? pathStart : "/";
+
+    if (https) {
+        insecureEndpoint = "http://";
+        insecureEndpoint += endpoint + HTTPS_PREFIX_LENGTH;
+    } else {
+        insecureEndpoint = config.apiEndpoint;
+    }
+
+    authHeader = "";
+    if (config.apiToken.length() > 0) {
+        authHeader = "Bearer ";
+        authHeader += config.apiToken;
+    }
+
+    registrationUrl = deriveRegistrationUrl(endpoint);
+
+    const char* broker = config.mqttUrl.c_str();
+    mqttTls = strncmp(broker, MQTTS_PREFIX, sizeof(MQTTS_PREFIX) - 1) == 0;
+    parseAuthority(broker, mqttHost, mqttPort);
+    if (mqttPort == 0) {
+        mqttPort = mqttTls ? 8883 : 1883;
+    }
+    mqttTopic = config.mqttTopic;
+    if (mqttTopic.length() == 0) {
+        mqttTopic = "sensors/";
+        mqttTopic += config.deviceId;
+        mqttTopic += "/readings";
+    }
+}
+
+uint16_t ConfigSnapshot::getPort(bool secure) const {
+    if (explicitPort != 0) {
+        return explicitPort;
+    }
+    return secure ? 443 : 80;
+}
+
+String ConfigSnapshot::deriveRegistrationUrl(const char* endpoint) {
+    size_t length = strlen(endpoint);
+
+    // Strip trailing slashes, then the query string and fragment at the earliest of the two
+    while (length > 0 && endpoint[length - 1] == '/') {
+        length--;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (endpoint[i] == '?' || endpoint[i] == '#') {
+            length = i;
+            break;
+        }
+    }
+
+    // A last '/' inside the scheme ("http://") means there is no path to replace
+    size_t lastSlash = length;
+    for (size_t i = length; i > 0; i--) {
+        if (endpoint[i - 1] == '/') {
+            lastSlash = i - 1;
+            break;
+        }
+    }
+    if (lastSlash == length || lastSlash < 8) {
+        String url = copyRange(endpoint, length);
+        url += "/register";
+        return url;
+    }
+
+    String url = copyRange(endpoint, lastSlash + 1);
+    url += "register";
+    return url;
+}
+
+const char* ConfigSnapshot::parseAuthority(const char* url, String& host, uint16_t& port) {
+    host = "";
+    port = 0;
+    const char* schemeEnd = strstr(url, "://");
+    if (!schemeEnd) {
+        return nullptr;
+    }
+
+    const char* authority = schemeEnd + 3;
+    const char* pathStart = strchr(authority, '/');
+    size_t authorityLength = pathStart ? pathStart - authority : strlen(authority);
+
+    const char* hostStart = authority;
+    for (size_t i = 0; i < authorityLength; i++) {
+        if (authority[i] == '@') {
+            hostStart = authority + i + 1;
+        }
+    }
+    size_t hostLength = authorityLength - (hostStart - authority);
+    const char* colon = static_cast<const char*>(memchr(hostStart, ':', hostLength));
+    bool portValid = true;
+    if (colon) {
+        long explicitPort = strtol(colon + 1, nullptr, 10);
+        portValid = explicitPort > 0 && explicitPort <= 65535;
+        port = portValid ? static_cast<uint16_t>(explicitPort) : 0;
+        hostLength = colon - hostStart;
+    }
+    if (portValid) {
+        host = copyRange(hostStart, hostLength);
+    }
+    return pathStart;
+}
+
+String ConfigSnapshot::copyRange(const char* begin, size_t length) {
+    String copy;
+    copy.reserve(length);
+    for (size_t i = 0; i < length; i++) {
+        copy += begin[i];
+    }
+    return copy;
+}
@@ -1,27 +1,196 @@
 #include "DataManager.h"
 
+#include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+
+#include "EnvelopeDownsampler.h"
+#include "models/SensorDescriptor.h"
+
+#ifdef ARDUINO
+#include <esp_heap_caps.h>
+#endif
+
+namespace {
+
+// Boot-time ring storage: PSRAM on device, plain heap on the host
+void* allocateExternal(size_t bytes) {
+#ifdef ARDUINO
+    return heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+#else
+    return malloc(bytes);
+#endif
+}
+
+void freeExternal(void* block) {
+#ifdef ARDUINO
+    heap_caps_free(block);
+#else
+    free(block);
+#endif
+}
+
+// Bytes per 1-minute history point: timestamp, one value per sensor, linearization scratch,
+// and a min and a max deque slot per sensor
+constexpr size_t DISPLAY_POINT_BYTES = sizeof(uint32_t) + NUM_SENSORS * sizeof(float) +
+                                       sizeof(DisplayPoint) + NUM_SENSORS * 2 * sizeof(uint16_t);
+
+}  // namespace
+
 DataManager::DataManager()
-    : averagingBufferCount(0),
+    : windowStartMs(0),
+      averagingBufferCount(0),
       publishIntervalSamples(20)  // Default value, will be set from config
       ,
-      dataBufferHead(0),
-      dataBufferTail(0),
-      dataBufferCount(0),
+      windowAlignMs(0),
+      windowEndMs(0),
+      windowEndKnown(false),
       bufferOverflowCount(0),
-      lastDisplayUpdate(0) {
+      nextSequence(1),
+      overflowSink(nullptr),
+      overflowSinkContext(nullptr),
+      externalDisplayStorage(nullptr),
+      lastDisplayUpdate(0),
+      hasDisplayPoint(false),
+      displayClockOffsetMs(0),
+      displayGeneration(1) {
     // Initialize buffers to zero
-    memset(averagingBuffer, 0, sizeof(averagingBuffer));
-    memset(dataBuffer, 0, sizeof(dataBuffer));
-    memset(displayBuffer, 0, sizeof(displayBuffer));
+    memset(&lastReading, 0, sizeof(lastReading));
+    resetRunningStats();
+    memset(internalDataBuffer, 0, sizeof(internalDataBuffer));
+    dataRing.attach(internalDataBuffer, MAX_DATA_BUFFER_SIZE);
+    memset(internalDisplayTimestamps, 0, sizeof(internalDisplayTimestamps));
+    memset(internalDisplayValues, 0, sizeof(internalDisplayValues));
+    displayRing.attach(internalDisplayTimestamps, MAX_DISPLAY_POINTS);
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        displayValues[i] = internalDisplayValues[i];
+    }
+    linearBuffer = internalLinearBuffer;
+    memset(coarseTimestamps, 0, sizeof(coarseTimestamps));
+    memset(coarseMin, 0, sizeof(coarseMin));
+    memset(coarseMean, 0, sizeof(coarseMean));
+    memset(coarseMax, 0, sizeof(coarseMax));
+    memset(historyCache, 0, sizeof(historyCache));  // generation 0 = never built
+    attachDisplayExtrema(&internalDisplayExtrema[0][0]);
+
+    // Initialize the coarse tiers
+    for (uint8_t t = 0; t < NUM_COARSE_TIERS; t++) {
+        coarseRing[t].attach(&coarseTimestamps[coarseOffset(t)], coarseCapacity(t));
+        openBucketStartMs[t] = 0;
+        for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+            openBucket[t][i].reset();
+        }
+    }
+}
+
+DataManager::~DataManager() {
+    releaseExternalBuffers();
+}
+
+void DataManager::releaseExternalBuffers() {
+    if (dataRing.storage() != internalDataBuffer) {
+        freeExternal(dataRing.storage());
+        dataRing.attach(internalDataBuffer, MAX_DATA_BUFFER_SIZE);
+    }
+    if (externalDisplayStorage) {
+        freeExternal(externalDisplayStorage);
+        externalDisplayStorage = nullptr;
+        displayRing.attach(internalDisplayTimestamps, MAX_DISPLAY_POINTS);
+        for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+            displayValues[i] = internalDisplayValues[i];
+        }
+        linearBuffer = internalLinearBuffer;
+    }
+}
+
+bool DataManager::configureBuffers(uint16_t dataCapacity, uint16_t displayPoints) {
+    // Rings can only be resized while empty
+    if (!dataRing.empty() || hasDisplayPoint) {
+        return false;
+    }
+
+    if (dataCapacity > PSRAM_DATA_BUFFER_SIZE) {
+        dataCapacity = PSRAM_DATA_BUFFER_SIZE;
+    }
+    if (displayPoints > PSRAM_DISPLAY_POINTS) {
+        displayPoints = PSRAM_DISPLAY_POINTS;
+    }
+
+    releaseExternalBuffers();
+    bool allocated = true;
+
+    if (dataCapacity > MAX_DATA_BUFFER_SIZE) {
+        size_t bytes = dataCapacity * sizeof(PackedAveragedData);
+        void* block = allocateExternal(bytes);
+        if (block) {
+            memset(block, 0, bytes);
+            dataRing.attach(static_cast<PackedAveragedData*>(block), dataCapacity);
+        } else {
+            allocated = false;
+        }
+    }
+    dataRing.clear();
+
+    if (displayPoints > MAX_DISPLAY_POINTS) {
+        // One block: timestamp column, value columns, the linearization scratch, then the
+        // extrema deques
+        size_t bytes = displayPoints * DISPLAY_POINT_BYTES;
+        uint8_t* block = static_cast<uint8_t*>(allocateExternal(bytes));
+        if (block) {
+            memset(block, 0, bytes);
+            externalDisplayStorage = block;
+            displayRing.attach(reinterpret_cast<uint32_t*>(block), displayPoints);
+            block += displayPoints * sizeof(uint32_t);
+            for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+                displayValues[i] = reinterpret_cast<float*>(block);
+                block += displayPoints * sizeof(float);
+            }
+            linearBuffer = reinterpret_cast<DisplayPoint*>(block);
+            block += displayPoints * sizeof(DisplayPoint);
+            attachDisplayExtrema(reinterpret_cast<uint16_t*>(block));
+        } else {
+            allocated = false;
+        }
+    }
+    displayRing.clear();
+    displayGeneration++;
+    if (!externalDisplayStorage) {
+        attachDisplayExtrema(&internalDisplayExtrema[0][0]);
+    }
+
+    return allocated;
+}
 
-    // Initialize display buffer indices
+void DataManager::attachDisplayExtrema(uint16_t* minuteStorage) {
     for (uint8_t i = 0; i < NUM_SENSORS; i++) {
-        displayBufferHead[i] = 0;
-        displayBufferCount[i] = 0;
+        displayExtrema[i].attach(minuteStorage + i * 2 * displayRing.getCapacity(),
+                                   displayRing.getCapacity());
+    }
+}
+
+void DataManager::recommendBufferSizes(size_t psramFreeBytes, uint16_t& dataCapacity,
+                                       uint16_t& displayPoints) {
+    // A quarter of free PSRAM: two thirds to the backlog, one third to graph history
+    size_t budget = psramFreeBytes / 4;
+    size_t dataFit = (budget * 2 / 3) / sizeof(PackedAveragedData);
+    size_t displayFit = (budget / 3) / DISPLAY_POINT_BYTES;
+
+    if (dataFit < MAX_DATA_BUFFER_SIZE) {
+        dataFit = MAX_DATA_BUFFER_SIZE;
+    } else if (dataFit > PSRAM_DATA_BUFFER_SIZE) {
+        dataFit = PSRAM_DATA_BUFFER_SIZE;
+    }
+    if (displayFit < MAX_DISPLAY_POINTS) {
+        displayFit = MAX_DISPLAY_POINTS;
+    } else if (displayFit > PSRAM_DISPLAY_POINTS) {
+        displayFit = PSRAM_DISPLAY_POINTS;
     }
+
+    dataCapacity = dataFit;
+    displayPoints = displayFit;
 }
 
 void DataManager::setPublishIntervalSamples(uint16_t samples) {
@@ -45,13 +214,91 @@ uint16_t DataManager::getCurrentSampleCount() const {
 
 void DataManager::addReading(const SensorReadings& reading) {
     // Only add if we haven't reached the publish interval
-    if (averagingBufferCount < publishIntervalSamples) {
-        averagingBuffer[averagingBufferCount] = reading;
-        averagingBufferCount++;
+    if (averagingBufferCount >= sampleLimit()) {
+        return;
+    }
+
+    if (averagingBufferCount == 0) {
+        windowStartMs = reading.monotonicMs;
+    }
+
+    // Only fresh samples contribute; carried-over values (staleMask) are skipped
+    for (const SensorDescriptor& sensor : SENSOR_DESCRIPTORS) {
+        if (!(reading.staleMask & (1 << sensor.busBit))) {
+            sensorStats[static_cast<uint8_t>(sensor.type)].add(reading.*sensor.reading);
+        }
     }
+    if (!(reading.staleMask & (1 << SENSOR_DS18B20_BIT))) {
+        uint8_t probeCount = reading.ds18b20ProbeCount;
+        if (probeCount > MAX_DS18B20_PROBES) {
+            probeCount = MAX_DS18B20_PROBES;
+        }
+        for (uint8_t p = 0; p < probeCount; p++) {
+            ds18b20ProbeStats[p].add(reading.ds18b20Probes[p]);
+        }
+    }
+
+    lastReading = reading;
+    averagingBufferCount++;
+}
+
+void DataManager::addSoilSamples(const RunningStats& samples, uint32_t nowMs) {
+    if (samples.count == 0 || averagingBufferCount >= publishIntervalSamples) {
+        return;
+    }
+
+    if (averagingBufferCount == 0) {
+        windowStartMs = nowMs;
+    }
+    sensorStats[static_cast<uint8_t>(SensorType::SOIL_MOISTURE)].merge(samples);
+
+    uint16_t room = publishIntervalSamples - averagingBufferCount - 1;
+    averagingBufferCount += samples.count < room ? samples.count : room;
+}
+
+void DataManager::setWindowAlignment(uint32_t windowMs) {
+    windowAlignMs = windowMs;
+    windowEndKnown = false;
+}
+
+bool DataManager::closesAlignedWindow(uint32_t monotonicMs, uint64_t epochMs) {
+    if (windowAlignMs == 0 || epochMs == 0) {
+        return false;
+    }
+    uint32_t endMs = monotonicMs + msToWindowBoundary(epochMs, windowAlignMs);
+    if (averagingBufferCount == 0 || !windowEndKnown) {
+        // First synced reading of the window: earlier unsynced ones share its interval
+        windowEndMs = endMs;
+        windowEndKnown = true;
+        return false;
+    }
+    if (static_cast<int32_t>(monotonicMs - windowEndMs) < 0) {
+        return false;
+    }
+    windowEndMs = endMs;  // The reading opens the next window
+    return true;
+}
+
+bool DataManager::windowClosesAt(uint32_t monotonicMs) const {
+    if (windowAlignMs != 0 && windowEndKnown && averagingBufferCount > 0) {
+        return static_cast<int32_t>(monotonicMs - windowEndMs) >= 0;
+    }
+    return averagingBufferCount + 1u >= publishIntervalSamples;
+}
+
+uint32_t DataManager::msToWindowBoundary(uint64_t epochMs, uint32_t windowMs) {
+    return windowMs - static_cast<uint32_t>(epochMs % windowMs);
+}
+
+uint16_t DataManager::sampleLimit() const {
+    // An aligned window takes every reading until its end, however fast they come
+    return windowAlignMs != 0 && windowEndKnown ? 0xFFFF : publishIntervalSamples;
 }
 
 bool DataManager::shouldPublish() {
+    if (windowAlignMs != 0 && windowEndKnown) {
+        return false;  // Closed by closesAlignedWindow() instead
+    }
     return averagingBufferCount >= publishIntervalSamples;
 }
 
@@ -62,31 +309,32 @@ AveragedData DataManager::calculateAverages() {
         return avg;
     }
 
-    // Accumulate sums
-    float sumBme280Temp = 0;
-    float sumDs18b20Temp = 0;
-    float sumHumidity = 0;
-    float sumPressure = 0;
-    float sumSoilMoisture = 0;
-
-    for (uint16_t i = 0; i < averagingBufferCount; i++) {
-        sumBme280Temp += averagingBuffer[i].bme280Temp;
-        sumDs18b20Temp += averagingBuffer[i].ds18b20Temp;
-        sumHumidity += averagingBuffer[i].humidity;
-        sumPressure += averagingBuffer[i].pressure;
-        sumSoilMoisture += averagingBuffer[i].soilMoisture;
+    // Probe set is fixed at boot; use the latest reading's count
+    uint8_t probeCount = lastReading.ds18b20ProbeCount;
+    if (probeCount > MAX_DS18B20_PROBES) {
+        probeCount = MAX_DS18B20_PROBES;
     }
 
-    // Calculate averages
-    avg.avgBme280Temp = sumBme280Temp / averagingBufferCount;
-    avg.avgDs18b20Temp = sumDs18b20Temp / averagingBufferCount;
-    avg.avgHumidity = sumHumidity / averagingBufferCount;
-    avg.avgPressure = sumPressure / averagingBufferCount;
-    avg.avgSoilMoisture = sumSoilMoisture / averagingBufferCount;
+    // Calculate averages (fall back to the latest carried value if never sampled)
+    const SensorReadings& last = lastReading;
+    for (const SensorDescriptor& sensor : SENSOR_DESCRIPTORS) {
+        const RunningStats& stats = sensorStats[static_cast<uint8_t>(sensor.type)];
+        float fallback = last.*sensor.reading;
+        avg.*sensor.average = stats.count ? stats.mean() : fallback;
+        fillSpread(avg.*sensor.spread, stats, fallback);
+    }
+    avg.ds18b20ProbeCount = probeCount;
+    for (uint8_t p = 0; p < probeCount; p++) {
+        avg.avgDs18b20Probes[p] =
+            ds18b20ProbeStats[p].count ? ds18b20ProbeStats[p].mean() : last.ds18b20Probes[p];
+    }
+    avg.bme280SampleCount = sensorStats[static_cast<uint8_t>(SensorType::BME280_TEMP)].count;
+    avg.ds18b20SampleCount = sensorStats[static_cast<uint8_t>(SensorType::DS18B20_TEMP)].count;
+    avg.soilSampleCount = sensorStats[static_cast<uint8_t>(SensorType::SOIL_MOISTURE)].count;
 
     // Set timestamps from first and last readings
-    avg.sampleStartUptimeMs = averagingBuffer[0].monotonicMs;
-    avg.sampleEndUptimeMs = averagingBuffer[averagingBufferCount - 1].monotonicMs;
+    avg.sampleStartUptimeMs = windowStartMs;
+    avg.sampleEndUptimeMs = last.monotonicMs;
 
     // Epoch timestamps will be set to 0 for now (time sync in Task 7)
     avg.sampleStartEpochMs = 0;
@@ -95,29 +343,52 @@ AveragedData DataManager::calculateAverages() {
 
     // Set metadata
     avg.sampleCount = averagingBufferCount;
-    avg.sensorStatus = averagingBuffer[averagingBufferCount - 1].sensorStatus;
+    avg.sensorStatus = last.sensorStatus;
     avg.timeSynced = false;  // Will be updated when time sync is implemented
 
     // Get current uptime (use last reading's timestamp as approximation)
-    avg.uptimeMs = averagingBuffer[averagingBufferCount - 1].monotonicMs;
+    avg.uptimeMs = last.monotonicMs;
 
     // Generate batch ID
-    generateBatchId(avg.batchId, sizeof(avg.batchId), avg, avg.timeSynced);
+    formatBatchId(avg.batchId, sizeof(avg.batchId), avg);
+    avg.sequence = nextSequence++;
 
     return avg;
 }
 
 void DataManager::clearAveragingBuffer() {
     averagingBufferCount = 0;
-    // No need to zero memory, we track count
+    resetRunningStats();
+}
+
+void DataManager::fillSpread(SensorSpread& spread, const RunningStats& stats,
+                             float fallback) {
+    if (stats.count == 0) {
+        // Never sampled this window: report the carried value with no spread
+        spread.min = fallback;
+        spread.max = fallback;
+        spread.stddev = 0.0f;
+        return;
+    }
+    spread.min = stats.min;
+    spread.max = stats.max;
+    spread.stddev = stats.stddev();
+}
+
+void DataManager::resetRunningStats() {
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        sensorStats[i].reset();
+    }
+    for (uint8_t p = 0; p < MAX_DS18B20_PROBES; p++) {
+        ds18b20ProbeStats[p].reset();
+    }
 }
 
-void DataManager::generateBatchId(char* batchId, size_t bufferSize, const AveragedData& data,
-                                  bool timeSynced) {
+void DataManager::formatBatchId(char* batchId, size_t bufferSize, const AveragedData& data) {
     // Format: device_e_epochStart_epochEnd (synced) or device_u_uptimeStart_uptimeEnd (unsynced)
     // For now, use "device" as placeholder until device_id is available from config
 
-    if (timeSynced && data.sampleStartEpochMs > 0) {
+    if (data.timeSynced && data.sampleStartEpochMs > 0) {
         // Use epoch timestamps
         snprintf(batchId, bufferSize, "device_e_%llu_%llu",
                  (unsigned long long)data.sampleStartEpochMs,
@@ -129,104 +400,307 @@ void DataManager::generateBatchId(char* batchId, size_t bufferSize, const Averag
     }
 }
 
+// ============================================================================
+// Packed Record Conversion
+// ============================================================================
+
+namespace {
+
+int16_t toFixed16(float value, float scale = 100.0f) {
+    if (isnan(value)) {
+        return FIXED_POINT_NAN;
+    }
+    float scaled = roundf(value * scale);
+    if (scaled > INT16_MAX) {
+        return INT16_MAX;
+    }
+    if (scaled <= INT16_MIN) {
+        return INT16_MIN + 1;  // INT16_MIN is reserved for NaN
+    }
+    return static_cast<int16_t>(scaled);
+}
+
+int32_t toFixed32(float value) {
+    if (isnan(value)) {
+        return FIXED_POINT_NAN32;
+    }
+    return static_cast<int32_t>(lroundf(value * 100.0f));
+}
+
+uint16_t toFixedStddev(float value) {
+    if (isnan(value) || value <= 0.0f) {
+        return 0;
+    }
+    float scaled = roundf(value * 100.0f);
+    return scaled > UINT16_MAX ? UINT16_MAX : static_cast<uint16_t>(scaled);
+}
+
+float fromFixed16(int16_t value, float scale = 100.0f) {
+    return value == FIXED_POINT_NAN ? NAN : value / scale;
+}
+
+float fromFixed32(int32_t value) {
+    return value == FIXED_POINT_NAN32 ? NAN : value / 100.0f;
+}
+
+void packSpread(const SensorSpread& spread, PackedAveragedData& packed, uint8_t slot) {
+    packed.spreadMin[slot] = toFixed16(spread.min);
+    packed.spreadMax[slot] = toFixed16(spread.max);
+    packed.spreadStddev[slot] = toFixedStddev(spread.stddev);
+}
+
+void unpackSpread(const PackedAveragedData& packed, uint8_t slot, SensorSpread& spread) {
+    spread.min = fromFixed16(packed.spreadMin[slot]);
+    spread.max = fromFixed16(packed.spreadMax[slot]);
+    spread.stddev = packed.spreadStddev[slot] / 100.0f;
+}
+
+}  // namespace
+
+void DataManager::packAveragedData(const AveragedData& data, PackedAveragedData& packed) {
+    memset(&packed, 0, sizeof(packed));
+
+    packed.sequence = data.sequence;
+    packed.sampleStartUptimeMs = data.sampleStartUptimeMs;
+    packed.sampleDurationMs = data.sampleEndUptimeMs - data.sampleStartUptimeMs;
+    packed.uptimeMs = data.uptimeMs;
+
+    packed.epochStartSec = static_cast<uint32_t>(data.sampleStartEpochMs / 1000ULL);
+    packed.epochStartMsRem = static_cast<uint16_t>(data.sampleStartEpochMs % 1000ULL);
+    packed.epochEndOffsetMs =
+        data.sampleEndEpochMs > data.sampleStartEpochMs
+            ? static_cast<uint32_t>(data.sampleEndEpochMs - data.sampleStartEpochMs)
+            : 0;
+    packed.bootEpochSec = static_cast<uint32_t>(data.deviceBootEpochMs / 1000ULL);
+    packed.bootEpochMsRem = static_cast<uint16_t>(data.deviceBootEpochMs % 1000ULL);
+
+    packed.bme280Temp = toFixed16(data.avgBme280Temp);
+    packed.ds18b20Temp = toFixed16(data.avgDs18b20Temp);
+    packed.humidity = toFixed16(data.avgHumidity);
+    packed.soilMoisture = toFixed16(data.avgSoilMoisture);
+    packed.pressure = toFixed32(data.avgPressure);
+    for (uint8_t p = 0; p < MAX_DS18B20_PROBES; p++) {
+        packed.ds18b20Probes[p] = toFixed16(data.avgDs18b20Probes[p]);
+    }
+
+    packSpread(data.bme280TempSpread, packed, 0);
+    packSpread(data.ds18b20TempSpread, packed, 1);
+    packSpread(data.humiditySpread, packed, 2);
+    packSpread(data.soilMoistureSpread, packed, 3);
+    packed.pressureMin = toFixed32(data.pressureSpread.min);
+    packed.pressureMax = toFixed32(data.pressureSpread.max);
+    packed.pressureStddev = toFixedStddev(data.pressureSpread.stddev);
+
+    packed.sampleCount = data.sampleCount;
+    packed.bme280SampleCount = data.bme280SampleCount;
+    packed.ds18b20SampleCount = data.ds18b20SampleCount;
+    packed.soilSampleCount = data.soilSampleCount;
+    packed.ds18b20ProbeCount = data.ds18b20ProbeCount;
+    packed.sensorStatus = data.sensorStatus;
+    packed.flags = data.timeSynced ? PACKED_FLAG_TIME_SYNCED : 0;
+}
+
+void DataManager::unpackAveragedData(const PackedAveragedData& packed, AveragedData& data) {
+    memset(&data, 0, sizeof(data));
+
+    data.sequence = packed.sequence;
+    data.sampleStartUptimeMs = packed.sampleStartUptimeMs;
+    data.sampleEndUptimeMs = packed.sampleStartUptimeMs + packed.sampleDurationMs;
+    data.uptimeMs = packed.uptimeMs;
+
+    data.sampleStartEpochMs = packed.epochStartSec * 1000ULL + packed.epochStartMsRem;
+    data.sampleEndEpochMs =
+        data.sampleStartEpochMs > 0 ? data.sampleStartEpochMs + packed.epochEndOffsetMs : 0;
+    data.deviceBootEpochMs = packed.bootEpochSec * 1000ULL + packed.bootEpochMsRem;
+
+    data.avgBme280Temp = fromFixed16(packed.bme280Temp);
+    data.avgDs18b20Temp = fromFixed16(packed.ds18b20Temp);
+    data.avgHumidity = fromFixed16(packed.humidity);
+    data.avgSoilMoisture = fromFixed16(packed.soilMoisture);
+    data.avgPressure = fromFixed32(packed.pressure);
+    for (uint8_t p = 0; p < MAX_DS18B20_PROBES; p++) {
+        data.avgDs18b20Probes[p] = fromFixed16(packed.ds18b20Probes[p]);
+    }
+
+    unpackSpread(packed, 0, data.bme280TempSpread);
+    unpackSpread(packed, 1, data.ds18b20TempSpread);
+    unpackSpread(packed, 2, data.humiditySpread);
+    unpackSpread(packed, 3, data.soilMoistureSpread);
+    data.pressureSpread.min = fromFixed32(packed.pressureMin);
+    data.pressureSpread.max = fromFixed32(packed.pressureMax);
+    data.pressureSpread.stddev = packed.pressureStddev / 100.0f;
+
+    data.sampleCount = packed.sampleCount;
+    data.bme280SampleCount = packed.bme280SampleCount;
+    data.ds18b20SampleCount = packed.ds18b20SampleCount;
+    data.soilSampleCount = packed.soilSampleCount;
+    data.ds18b20ProbeCount = packed.ds18b20ProbeCount;
+    data.sensorStatus = packed.sensorStatus;
+    data.timeSynced = (packed.flags & PACKED_FLAG_TIME_SYNCED) != 0;
+
+    formatBatchId(data.batchId, sizeof(data.batchId), data);
+}
+
 // ============================================================================
 // Transmission Ring Buffer Operations (Task 10)
 // ============================================================================
 
 void DataManager::bufferForTransmission(const AveragedData& data) {
     // Check if buffer is at 90% capacity (45 out of 50)
-    const uint16_t OVERFLOW_THRESHOLD = (MAX_DATA_BUFFER_SIZE * 9) / 10;  // 90%
-
-    if (dataBufferCount >= OVERFLOW_THRESHOLD) {
-        // Buffer is at or above 90% - discard oldest entry
-        if (dataBufferCount > 0) {
-            advanceTail();  // Remove oldest
-            dataBufferCount--;
-            bufferOverflowCount++;  // Increment overflow counter
+    const uint16_t OVERFLOW_THRESHOLD = (dataRing.getCapacity() * 9) / 10;  // 90%
+
+    if (dataRing.size() >= OVERFLOW_THRESHOLD) {
+        // Buffer is at or above 90% - evict oldest entry (spilled if a sink takes it)
+        const PackedAveragedData* oldest = dataRing.front();
+        if (oldest) {
+            bool kept = overflowSink && overflowSink(*oldest, overflowSinkContext);
+            dataRing.drop();  // Remove oldest
+            if (!kept) {
+                bufferOverflowCount++;  // Increment overflow counter
+            }
         }
     }
 
-    // Add new data at head position
-    dataBuffer[dataBufferHead] = data;
-    advanceHead();
-
-    // Increment count if not at max capacity
-    if (dataBufferCount < MAX_DATA_BUFFER_SIZE) {
-        dataBufferCount++;
+    // Add new data in the head slot (packed; batchId is re-derived on expansion)
+    PackedAveragedData* slot = dataRing.reserve();
+    if (!slot) {
+        return;
     }
+    packAveragedData(data, *slot);
+    if (slot->sequence == 0) {
+        slot->sequence = nextSequence++;
+    }
+    dataRing.commit();
 }
 
 uint16_t DataManager::getBufferedDataCount() const {
-    return dataBufferCount;
+    return dataRing.size();
 }
 
-const AveragedData* DataManager::getBufferedData(uint16_t& count) const {
-    count = dataBufferCount;
+BufferedBatch DataManager::getBufferedBatch() const {
+    BufferedBatch batch = {};
+
+    // First segment runs from the tail to the end of the array, the second (if the
+    // backlog wraps) from the start of the array up to the head
+    uint16_t firstCount = dataRing.frontSpan();
+    batch.segments[0].data = &dataRing.storage()[dataRing.tailSlot()];
+    batch.segments[0].count = firstCount;
+    batch.segments[1].data = dataRing.storage();
+    batch.segments[1].count = dataRing.size() - firstCount;
+    return batch;
+}
 
-    // If buffer is empty, return nullptr
-    if (dataBufferCount == 0) {
-        return nullptr;
+bool DataManager::getBufferedEntry(uint16_t index, AveragedData& out) const {
+    if (index >= dataRing.size()) {
+        return false;
+    }
+    unpackAveragedData(dataRing.at(index), out);
+    return true;
+}
+
+namespace {
+
+struct BatchIdList {
+    const char** ids;
+    uint16_t count;
+};
+
+struct SequenceRange {
+    uint32_t first;
+    uint32_t last;
+};
+
+bool matchesBatchId(const PackedAveragedData& entry, const void* context) {
+    const BatchIdList* list = static_cast<const BatchIdList*>(context);
+    AveragedData expanded;
+    DataManager::unpackAveragedData(entry, expanded);
+    for (uint16_t j = 0; j < list->count; j++) {
+        if (strcmp(expanded.batchId, list->ids[j]) == 0) {
+            return true;
+        }
     }
+    return false;
+}
 
-    // Return pointer to the tail (oldest entry)
-    // Caller must iterate through the ring buffer properly
-    return &dataBuffer[dataBufferTail];
+bool matchesSequenceRange(const PackedAveragedData& entry, const void* context) {
+    const SequenceRange* range = static_cast<const SequenceRange*>(context);
+    return (entry.sequence - range->first) <= (range->last - range->first);
 }
 
+}  // namespace
+
 void DataManager::clearAcknowledgedData(const char* batchIds[], uint16_t batchIdCount) {
-    if (batchIdCount == 0 || dataBufferCount == 0) {
+    if (batchIdCount == 0 || dataRing.empty()) {
         return;
     }
 
-    // We need to remove entries that match any of the acknowledged batch IDs
-    // Since this is a ring buffer, we'll compact it by keeping only unacknowledged entries
-
-    // Create a temporary buffer to hold unacknowledged entries
-    AveragedData tempBuffer[MAX_DATA_BUFFER_SIZE];
-    uint16_t tempCount = 0;
-
-    // Iterate through current buffer
-    uint16_t currentIndex = dataBufferTail;
-    for (uint16_t i = 0; i < dataBufferCount; i++) {
-        bool isAcknowledged = false;
+    // Legacy batch-ID acks: match by string, compact the ring in place
+    BatchIdList list = {batchIds, batchIdCount};
+    removeBufferedIf(matchesBatchId, &list);
+}
 
-        // Check if this entry's batch ID matches any acknowledged ID
-        for (uint16_t j = 0; j < batchIdCount; j++) {
-            if (strcmp(dataBuffer[currentIndex].batchId, batchIds[j]) == 0) {
-                isAcknowledged = true;
-                break;
-            }
-        }
+uint16_t DataManager::acknowledgeThrough(uint32_t sequence) {
+    // Entries are in sequence order, so a cumulative ack only ever trims the tail
+    uint16_t removed = 0;
+    const PackedAveragedData* oldest = dataRing.front();
+    while (oldest && sequenceAtOrBefore(oldest->sequence, sequence)) {
+        dataRing.drop();
+        removed++;
+        oldest = dataRing.front();
+    }
+    return removed;
+}
 
-        // If not acknowledged, keep it
-        if (!isAcknowledged) {
-            tempBuffer[tempCount] = dataBuffer[currentIndex];
-            tempCount++;
-        }
+uint16_t DataManager::acknowledgeRange(uint32_t firstSequence, uint32_t lastSequence) {
+    if (dataRing.empty() || !sequenceAtOrBefore(firstSequence, lastSequence)) {
+        return 0;
+    }
 
-        // Move to next entry in ring buffer
-        currentIndex = (currentIndex + 1) % MAX_DATA_BUFFER_SIZE;
+    // Common case: the range starts at or before the oldest entry
+    if (sequenceAtOrBefore(firstSequence, dataRing.front()->sequence)) {
+        return acknowledgeThrough(lastSequence);
     }
 
-    // Copy unacknowledged entries back to main buffer
-    dataBufferHead = 0;
-    dataBufferTail = 0;
-    dataBufferCount = tempCount;
+    // A hole in the middle of the backlog: compact in place
+    SequenceRange range = {firstSequence, lastSequence};
+    return removeBufferedIf(matchesSequenceRange, &range);
+}
 
-    for (uint16_t i = 0; i < tempCount; i++) {
-        dataBuffer[i] = tempBuffer[i];
+uint16_t DataManager::removeBufferedIf(bool (*match)(const PackedAveragedData& entry,
+                                                     const void* context),
+                                       const void* context) {
+    // Single pass: survivors slide toward the tail, keeping FIFO order and no temp buffer
+    uint16_t count = dataRing.size();
+    uint16_t kept = 0;
+
+    for (uint16_t i = 0; i < count; i++) {
+        if (!match(dataRing.at(i), context)) {
+            if (kept != i) {
+                dataRing.at(kept) = dataRing.at(i);
+            }
+            kept++;
+        }
     }
 
-    // Update head to point after last entry
-    if (tempCount > 0) {
-        dataBufferHead = tempCount % MAX_DATA_BUFFER_SIZE;
-    }
+    uint16_t removed = count - kept;
+    dataRing.retract(removed);
+    return removed;
+}
+
+bool DataManager::sequenceAtOrBefore(uint32_t sequence, uint32_t watermark) {
+    // Wrap-safe comparison (serial number arithmetic)
+    return static_cast<int32_t>(sequence - watermark) <= 0;
 }
 
 bool DataManager::isBufferNearFull() const {
     // Return true if buffer is > 80% full (warning threshold)
-    const uint16_t WARNING_THRESHOLD = (MAX_DATA_BUFFER_SIZE * 8) / 10;  // 80%
-    return dataBufferCount > WARNING_THRESHOLD;
+    const uint16_t WARNING_THRESHOLD = (dataRing.getCapacity() * 8) / 10;  // 80%
+    return dataRing.size() > WARNING_THRESHOLD;
+}
+
+void DataManager::setOverflowSink(OverflowSink sink, void* context) {
+    overflowSink = sink;
+    overflowSinkContext = context;
 }
 
 uint16_t DataManager::getBufferOverflowCount() const {
@@ -234,15 +708,84 @@ uint16_t DataManager::getBufferOverflowCount() const {
 }
 
 // ============================================================================
-// Ring Buffer Helper Methods
+// Snapshot and Bulk Restore (deep sleep / power loss persistence)
 // ============================================================================
 
-void DataManager::advanceHead() {
-    dataBufferHead = (dataBufferHead + 1) % MAX_DATA_BUFFER_SIZE;
+DataSnapshot DataManager::snapshot(uint32_t nowMs) {
+    // Rotate each ring so its oldest entry sits at index 0; the views are then
+    // single contiguous blocks
+    dataRing.linearize();
+    uint16_t displayStart = displayRing.linearize();
+    if (displayStart != 0) {
+        // The value columns follow the timestamp column
+        uint16_t capacity = displayRing.getCapacity();
+        for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+            std::rotate(displayValues[i], displayValues[i] + displayStart,
+                        displayValues[i] + capacity);
+            displayExtrema[i].rebase(displayStart);
+        }
+    }
+
+    DataSnapshot view = {};
+    view.records = dataRing.storage();
+    view.recordCount = dataRing.size();
+    view.displayTimestamps = displayRing.storage();
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        view.displayValues[i] = displayValues[i];
+    }
+    view.displayCount = displayRing.size();
+    view.nextSequence = nextSequence;
+    view.bufferOverflowCount = bufferOverflowCount;
+    view.displayClockMs = displayClockMs(nowMs);
+    return view;
+}
+
+DataRestoreTarget DataManager::beginRestore() {
+    DataRestoreTarget target = {};
+    if (!dataRing.empty() || hasDisplayPoint) {
+        return target;
+    }
+
+    target.records = dataRing.storage();
+    target.recordCapacity = dataRing.getCapacity();
+    target.displayTimestamps = displayRing.storage();
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        target.displayValues[i] = displayValues[i];
+    }
+    target.displayCapacity = displayRing.getCapacity();
+    return target;
 }
 
-void DataManager::advanceTail() {
-    dataBufferTail = (dataBufferTail + 1) % MAX_DATA_BUFFER_SIZE;
+bool DataManager::commitRestore(uint16_t recordCount, uint32_t resumeSequence,
+                                uint16_t overflowCount, uint16_t displayCount,
+                                uint32_t clockNowMs, uint32_t nowMs) {
+    if (!dataRing.empty() || hasDisplayPoint || recordCount > dataRing.getCapacity() ||
+        displayCount > displayRing.getCapacity()) {
+        return false;
+    }
+
+    dataRing.attach(dataRing.storage(), dataRing.getCapacity(), recordCount);
+    nextSequence = resumeSequence;
+    bufferOverflowCount = overflowCount;
+
+    // Keep the saved clock running so the restored points stay in the past
+    displayClockOffsetMs = clockNowMs - nowMs;
+    displayRing.attach(displayRing.storage(), displayRing.getCapacity(), displayCount);
+    const uint32_t* timestamps = displayRing.storage();
+    float values[NUM_SENSORS];
+    for (uint16_t p = 0; p < displayCount; p++) {
+        for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+            values[i] = displayValues[i][p];
+            displayExtrema[i].push(p, displayValues[i], displayValues[i]);
+        }
+        rollUpDisplayPoint(values, timestamps[p]);
+    }
+    if (displayCount > 0) {
+        lastDisplayUpdate = timestamps[displayCount - 1];
+        hasDisplayPoint = true;
+    }
+    displayGeneration++;
+    return true;
 }
 
 // ============================================================================
@@ -251,58 +794,288 @@ void DataManager::advanceTail() {
 
 void DataManager::addToDisplayBuffer(const SensorReadings& reading) {
     // Check if enough time has elapsed since last display update (1 minute)
-    uint32_t currentTime = reading.monotonicMs;
+    uint32_t currentTime = displayClockMs(reading.monotonicMs);
 
-    if (lastDisplayUpdate == 0 || (currentTime - lastDisplayUpdate) >= DISPLAY_INTERVAL_MS) {
+    if (!hasDisplayPoint || (currentTime - lastDisplayUpdate) >= DISPLAY_INTERVAL_MS) {
         // Update timestamp
         lastDisplayUpdate = currentTime;
+        hasDisplayPoint = true;
 
-        // Add data point for each sensor type
-        // BME280 Temperature
-        uint8_t sensorIdx = static_cast<uint8_t>(SensorType::BME280_TEMP);
-        displayBuffer[sensorIdx][displayBufferHead[sensorIdx]].value = reading.bme280Temp;
-        displayBuffer[sensorIdx][displayBufferHead[sensorIdx]].timestamp = currentTime;
-        displayBufferHead[sensorIdx] = (displayBufferHead[sensorIdx] + 1) % MAX_DISPLAY_POINTS;
-        if (displayBufferCount[sensorIdx] < MAX_DISPLAY_POINTS) {
-            displayBufferCount[sensorIdx]++;
+        // One value per sensor, indexed by SensorType
+        float values[NUM_SENSORS];
+        for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+            values[i] = reading.*SENSOR_DESCRIPTORS[i].reading;
         }
 
-        // DS18B20 Temperature
-        sensorIdx = static_cast<uint8_t>(SensorType::DS18B20_TEMP);
-        displayBuffer[sensorIdx][displayBufferHead[sensorIdx]].value = reading.ds18b20Temp;
-        displayBuffer[sensorIdx][displayBufferHead[sensorIdx]].timestamp = currentTime;
-        displayBufferHead[sensorIdx] = (displayBufferHead[sensorIdx] + 1) % MAX_DISPLAY_POINTS;
-        if (displayBufferCount[sensorIdx] < MAX_DISPLAY_POINTS) {
-            displayBufferCount[sensorIdx]++;
+        appendDisplayPoint(values, currentTime);
+    }
+}
+
+void DataManager::appendDisplayPoint(const float* values, uint32_t timestamp) {
+    // Shared timestamp column (the ring), one value column per sensor indexed by the
+    // same slot; a full ring drops its oldest point from the extrema before reusing it
+    if (displayRing.full()) {
+        for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+            displayExtrema[i].evict(displayRing.tailSlot());
         }
+        displayRing.drop();
+    }
+    uint16_t slot = displayRing.headSlot();
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        displayValues[i][slot] = values[i];
+        displayExtrema[i].push(slot, displayValues[i], displayValues[i]);
+    }
+    displayRing.push(timestamp);
 
-        // Humidity
-        sensorIdx = static_cast<uint8_t>(SensorType::HUMIDITY);
-        displayBuffer[sensorIdx][displayBufferHead[sensorIdx]].value = reading.humidity;
-        displayBuffer[sensorIdx][displayBufferHead[sensorIdx]].timestamp = currentTime;
-        displayBufferHead[sensorIdx] = (displayBufferHead[sensorIdx] + 1) % MAX_DISPLAY_POINTS;
-        if (displayBufferCount[sensorIdx] < MAX_DISPLAY_POINTS) {
-            displayBufferCount[sensorIdx]++;
+    // Fold the new point into the coarse tiers
+    rollUpDisplayPoint(values, timestamp);
+    displayGeneration++;
+}
+
+void DataManager::rollUpDisplayPoint(const float* values, uint32_t timestamp) {
+    for (uint8_t t = 0; t < NUM_COARSE_TIERS; t++) {
+        uint32_t interval = coarseIntervalMs(t);
+        bool open = openBucket[t][0].count > 0;
+
+        // Close the open bucket once a point lands past its interval
+        if (open && (timestamp - openBucketStartMs[t]) >= interval) {
+            commitOpenBucket(t);
+            open = false;
+        }
+        if (!open) {
+            openBucketStartMs[t] = timestamp - (timestamp % interval);
         }
+        for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+            openBucket[t][i].add(values[i]);
+        }
+    }
+}
+
+void DataManager::commitOpenBucket(uint8_t coarseIdx) {
+    SpscRing<uint32_t>& ring = coarseRing[coarseIdx];
+    uint16_t offset = coarseOffset(coarseIdx);
+    if (ring.full()) {
+        ring.drop();
+    }
+
+    uint16_t slot = offset + ring.headSlot();
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        RunningStats& stats = openBucket[coarseIdx][i];
+        coarseMin[i][slot] = toCoarse(stats.min, i);
+        coarseMean[i][slot] = toCoarse(stats.mean(), i);
+        coarseMax[i][slot] = toCoarse(stats.max, i);
+        stats.reset();
+    }
+    ring.push(openBucketStartMs[coarseIdx]);
+}
+
+float DataManager::coarseScale(uint8_t sensorIdx) {
+    // Hundredths, as in PackedAveragedData; hundredths of hPa do not fit 16 bits, so
+    // pressure buckets keep tenths
+    return sensorIdx == static_cast<uint8_t>(SensorType::PRESSURE) ? 10.0f : 100.0f;
+}
+
+int16_t DataManager::toCoarse(float value, uint8_t sensorIdx) {
+    return toFixed16(value, coarseScale(sensorIdx));
+}
+
+float DataManager::fromCoarse(int16_t value, uint8_t sensorIdx) {
+    return fromFixed16(value, coarseScale(sensorIdx));
+}
 
-        // Pressure
-        sensorIdx = static_cast<uint8_t>(SensorType::PRESSURE);
-        displayBuffer[sensorIdx][displayBufferHead[sensorIdx]].value = reading.pressure;
-        displayBuffer[sensorIdx][displayBufferHead[sensorIdx]].timestamp = currentTime;
-        displayBufferHead[sensorIdx] = (displayBufferHead[sensorIdx] + 1) % MAX_DISPLAY_POINTS;
-        if (displayBufferCount[sensorIdx] < MAX_DISPLAY_POINTS) {
-            displayBufferCount[sensorIdx]++;
+uint16_t DataManager::coarseOffset(uint8_t coarseIdx) {
+    return coarseIdx == 0 ? 0 : DISPLAY_QUARTER_HOUR_POINTS;
+}
+
+uint16_t DataManager::coarseCapacity(uint8_t coarseIdx) {
+    return coarseIdx == 0 ? DISPLAY_QUARTER_HOUR_POINTS : DISPLAY_HOUR_POINTS;
+}
+
+uint32_t DataManager::coarseIntervalMs(uint8_t coarseIdx) {
+    return coarseIdx == 0 ? QUARTER_HOUR_MS : HOUR_MS;
+}
+
+DisplayTier DataManager::selectDisplayTier(uint32_t spanMs) const {
+    if (spanMs <= getDisplayTierSpanMs(DisplayTier::MINUTE)) {
+        return DisplayTier::MINUTE;
+    }
+    if (spanMs <= getDisplayTierSpanMs(DisplayTier::QUARTER_HOUR)) {
+        return DisplayTier::QUARTER_HOUR;
+    }
+    return DisplayTier::HOUR;
+}
+
+uint32_t DataManager::getDisplayTierSpanMs(DisplayTier tier) const {
+    switch (tier) {
+        case DisplayTier::MINUTE:
+            return displayRing.getCapacity() * DISPLAY_INTERVAL_MS;
+        case DisplayTier::QUARTER_HOUR:
+            return DISPLAY_QUARTER_HOUR_POINTS * QUARTER_HOUR_MS;
+        case DisplayTier::HOUR:
+        default:
+            return DISPLAY_HOUR_POINTS * HOUR_MS;
+    }
+}
+
+bool DataManager::getDisplayRange(SensorType type, uint32_t spanMs, float& minValue,
+                                  float& maxValue) const {
+    uint8_t sensorIdx = static_cast<uint8_t>(type);
+    if (sensorIdx >= NUM_SENSORS) {
+        return false;
+    }
+
+    DisplayTier tier = selectDisplayTier(spanMs);
+    DisplaySeries series = getDisplaySeries(type, tier);
+    if (tier == DisplayTier::MINUTE) {
+        if (series.count == 0) {
+            return false;
         }
+        uint16_t skip =
+            pointsBeforeSpan(series, series.timestampAt(series.count - 1), spanMs);
+        return displayExtrema[sensorIdx].range(displayValues[sensorIdx], displayValues[sensorIdx],
+                                               series.start, skip, minValue, maxValue);
+    }
+
+    // Coarse tiers: scanned once per history change, then served from the cache
+    HistoryCache& cache = historyCache[sensorIdx];
+    if (cache.rangeGeneration != displayGeneration || cache.rangeSpanMs != spanMs) {
+        cache.rangeFound = scanBucketRange(static_cast<uint8_t>(tier) - 1, sensorIdx, spanMs,
+                                           cache.rangeMin, cache.rangeMax);
+        cache.rangeSpanMs = spanMs;
+        cache.rangeGeneration = displayGeneration;
+    }
+    if (cache.rangeFound) {
+        minValue = cache.rangeMin;
+        maxValue = cache.rangeMax;
+    }
+    return cache.rangeFound;
+}
+
+bool DataManager::scanBucketRange(uint8_t coarseIdx, uint8_t sensorIdx, uint32_t spanMs,
+                                  float& minValue, float& maxValue) const {
+    // Closed buckets in the span, then the open bucket (always the newest)
+    DisplayTier tier = static_cast<DisplayTier>(coarseIdx + 1);
+    DisplaySeries series = getDisplaySeries(static_cast<SensorType>(sensorIdx), tier);
+    const RunningStats& open = openBucket[coarseIdx][sensorIdx];
+    bool found = false;
+    if (series.count > 0) {
+        uint32_t newest =
+            open.count > 0 ? openBucketStartMs[coarseIdx] : series.timestampAt(series.count - 1);
+        uint16_t offset = coarseOffset(coarseIdx);
+        for (uint16_t i = pointsBeforeSpan(series, newest, spanMs); i < series.count; i++) {
+            uint16_t slot = offset + (series.start + i) % series.capacity;
+            float low = fromCoarse(coarseMin[sensorIdx][slot], sensorIdx);
+            float high = fromCoarse(coarseMax[sensorIdx][slot], sensorIdx);
+            if (isnan(low) || isnan(high)) {
+                continue;
+            }
+            minValue = found ? std::min(minValue, low) : low;
+            maxValue = found ? std::max(maxValue, high) : high;
+            found = true;
+        }
+    }
+    if (open.count > 0 && !isnan(open.min) && !isnan(open.max)) {
+        minValue = found ? std::min(minValue, open.min) : open.min;
+        maxValue = found ? std::max(maxValue, open.max) : open.max;
+        found = true;
+    }
+    return found;
+}
+
+uint16_t DataManager::pointsBeforeSpan(const DisplaySeries& series, uint32_t newestMs,
+                                       uint32_t spanMs) {
+    if (spanMs == 0) {
+        return 0;
+    }
 
-        // Soil Moisture
-        sensorIdx = static_cast<uint8_t>(SensorType::SOIL_MOISTURE);
-        displayBuffer[sensorIdx][displayBufferHead[sensorIdx]].value = reading.soilMoisture;
-        displayBuffer[sensorIdx][displayBufferHead[sensorIdx]].timestamp = currentTime;
-        displayBufferHead[sensorIdx] = (displayBufferHead[sensorIdx] + 1) % MAX_DISPLAY_POINTS;
-        if (displayBufferCount[sensorIdx] < MAX_DISPLAY_POINTS) {
-            displayBufferCount[sensorIdx]++;
+    // Timestamps increase along the series, so the span start is a binary search away
+    uint32_t cutoff = newestMs > spanMs ? newestMs - spanMs : 0;
+    uint16_t low = 0;
+    uint16_t high = series.count;
+    while (low < high) {
+        uint16_t mid = low + (high - low) / 2;
+        if (series.timestampAt(mid) < cutoff) {
+            low = mid + 1;
+        } else {
+            high = mid;
         }
     }
+    return low;
+}
+
+uint16_t DataManager::linearizeMinuteTier(uint8_t sensorIdx, DisplayPoint* dest) const {
+    DisplaySeries series = getDisplaySeries(static_cast<SensorType>(sensorIdx));
+    for (uint16_t i = 0; i < series.count; i++) {
+        dest[i].value = series.valueAt(i);
+        dest[i].timestamp = series.timestampAt(i);
+    }
+    return series.count;
+}
+
+uint16_t DataManager::linearizeBuckets(uint8_t coarseIdx, uint8_t sensorIdx,
+                                       DisplayBucket* dest) const {
+    const SpscRing<uint32_t>& ring = coarseRing[coarseIdx];
+    uint16_t offset = coarseOffset(coarseIdx);
+    uint16_t count = ring.size();
+
+    for (uint16_t i = 0; i < count; i++) {
+        uint16_t slot = offset + ring.slotOf(i);
+        dest[i].min = fromCoarse(coarseMin[sensorIdx][slot], sensorIdx);
+        dest[i].mean = fromCoarse(coarseMean[sensorIdx][slot], sensorIdx);
+        dest[i].max = fromCoarse(coarseMax[sensorIdx][slot], sensorIdx);
+        dest[i].timestamp = coarseTimestamps[slot];
+    }
+
+    // The open bucket keeps coarse graphs current between bucket boundaries
+    const RunningStats& open = openBucket[coarseIdx][sensorIdx];
+    if (open.count > 0) {
+        dest[count].min = open.min;
+        dest[count].mean = open.mean();
+        dest[count].max = open.max;
+        dest[count].timestamp = openBucketStartMs[coarseIdx];
+        count++;
+    }
+    return count;
+}
+
+DisplaySeries DataManager::getDisplaySeries(SensorType type, DisplayTier tier) const {
+    DisplaySeries series = {};
+    uint8_t sensorIdx = static_cast<uint8_t>(type);
+    if (sensorIdx >= NUM_SENSORS) {
+        series.capacity = 1;
+        return series;
+    }
+
+    if (tier == DisplayTier::MINUTE) {
+        series.timestamps = displayRing.storage();
+        series.values = displayValues[sensorIdx];
+        series.capacity = displayRing.getCapacity();
+        series.count = displayRing.size();
+        series.start = displayRing.tailSlot();
+        return series;
+    }
+
+    uint8_t coarseIdx = static_cast<uint8_t>(tier) - 1;
+    uint16_t offset = coarseOffset(coarseIdx);
+    series.timestamps = &coarseTimestamps[offset];
+    series.fixedValues = &coarseMean[sensorIdx][offset];
+    series.fixedScale = coarseScale(sensorIdx);
+    series.capacity = coarseCapacity(coarseIdx);
+    series.count = coarseRing[coarseIdx].size();
+    series.start = coarseRing[coarseIdx].tailSlot();
+    return series;
+}
+
+const DisplayBucket* DataManager::getDisplayBuckets(SensorType type, DisplayTier tier,
+                                                    uint16_t& count) const {
+    uint8_t sensorIdx = static_cast<uint8_t>(type);
+    count = 0;
+    if (sensorIdx >= NUM_SENSORS || tier == DisplayTier::MINUTE) {
+        return nullptr;
+    }
+
+    count = linearizeBuckets(static_cast<uint8_t>(tier) - 1, sensorIdx, bucketBuffer);
+    return count > 0 ? bucketBuffer : nullptr;
 }
 
 uint16_t DataManager::getDisplayDataCount(SensorType type) const {
@@ -310,68 +1083,72 @@ uint16_t DataManager::getDisplayDataCount(SensorType type) const {
     if (sensorIdx >= NUM_SENSORS) {
         return 0;
     }
-    return displayBufferCount[sensorIdx];
+    return displayRing.size();
 }
 
 const DisplayPoint* DataManager::getDisplayData(SensorType type, uint16_t& count,
                                                 uint16_t maxPoints) const {
+    return getDisplayHistory(type, 0, count, maxPoints);
+}
+
+const DisplayPoint* DataManager::getDisplayHistory(SensorType type, uint32_t spanMs,
+                                                   uint16_t& count, uint16_t maxPoints) const {
     uint8_t sensorIdx = static_cast<uint8_t>(type);
+    count = 0;
     if (sensorIdx >= NUM_SENSORS) {
-        count = 0;
         return nullptr;
     }
 
-    uint16_t availableCount = displayBufferCount[sensorIdx];
-
-    if (availableCount == 0) {
-        count = 0;
-        return nullptr;
+    if (maxPoints > MAX_GRAPH_POINTS) {
+        maxPoints = MAX_GRAPH_POINTS;
     }
 
-    // If maxPoints is 0 or >= available count, return all data without downsampling
-    if (maxPoints == 0 || maxPoints >= availableCount) {
-        count = availableCount;
-        return displayBuffer[sensorIdx];
+    // Bounded queries are served from the cache until the history changes
+    HistoryCache& cache = historyCache[sensorIdx];
+    if (maxPoints > 0 && cache.generation == displayGeneration && cache.spanMs == spanMs &&
+        cache.maxPoints == maxPoints) {
+        count = cache.count;
+        return count > 0 ? cache.points : nullptr;
     }
 
-    // Need to downsample - copy to linear buffer first, then downsample
-    // For ring buffer, we need to copy in correct order
-    DisplayPoint linearBuffer[MAX_DISPLAY_POINTS];
-    uint16_t head = displayBufferHead[sensorIdx];
-
-    if (availableCount < MAX_DISPLAY_POINTS) {
-        // Buffer not full yet, data is from index 0 to head-1
-        memcpy(linearBuffer, displayBuffer[sensorIdx], availableCount * sizeof(DisplayPoint));
+    // Copy the chosen tier into linear (oldest-first) order
+    DisplayTier tier = selectDisplayTier(spanMs);
+    uint16_t availableCount = 0;
+    if (tier == DisplayTier::MINUTE) {
+        availableCount = linearizeMinuteTier(sensorIdx, linearBuffer);
     } else {
-        // Buffer is full, need to copy in ring order: from head to end, then from 0 to head-1
-        uint16_t firstPartSize = MAX_DISPLAY_POINTS - head;
-        memcpy(linearBuffer, &displayBuffer[sensorIdx][head], firstPartSize * sizeof(DisplayPoint));
-        memcpy(&linearBuffer[firstPartSize], displayBuffer[sensorIdx], head * sizeof(DisplayPoint));
+        availableCount =
+            linearizeBuckets(static_cast<uint8_t>(tier) - 1, sensorIdx, bucketBuffer);
+        for (uint16_t i = 0; i < availableCount; i++) {
+            linearBuffer[i].value = bucketBuffer[i].mean;
+            linearBuffer[i].timestamp = bucketBuffer[i].timestamp;
+        }
     }
 
-    // Downsample to maxPoints
-    downsampleDisplayData(linearBuffer, availableCount, downsampledBuffer, maxPoints);
-    count = maxPoints;
-    return downsampledBuffer;
-}
+    // Trim to the requested span, measured back from the newest point
+    uint16_t first = 0;
+    if (spanMs > 0 && availableCount > 0) {
+        uint32_t newest = linearBuffer[availableCount - 1].timestamp;
+        uint32_t cutoff = newest > spanMs ? newest - spanMs : 0;
+        while (first < availableCount - 1 && linearBuffer[first].timestamp < cutoff) {
+            first++;
+        }
+    }
+    const DisplayPoint* source = &linearBuffer[first];
+    uint16_t sourceCount = availableCount - first;
 
-void DataManager::downsampleDisplayData(const DisplayPoint* source, uint16_t sourceCount,
-                                        DisplayPoint* dest, uint16_t maxPoints) const {
-    if (sourceCount <= maxPoints) {
-        // No downsampling needed
-        memcpy(dest, source, sourceCount * sizeof(DisplayPoint));
-        return;
+    // Unbounded queries return the linearized tier as is
+    if (maxPoints == 0) {
+        count = sourceCount;
+        return count > 0 ? source : nullptr;
     }
 
-    // Simple downsampling: pick evenly spaced points
-    // Always include first and last points
-    dest[0] = source[0];
-    dest[maxPoints - 1] = source[sourceCount - 1];
+    // Min/max envelope keeps spikes that evenly spaced picks would skip
+    cache.count = downsampleEnvelope(source, sourceCount, cache.points, maxPoints);
+    cache.maxPoints = maxPoints;
+    cache.spanMs = spanMs;
+    cache.generation = displayGeneration;
 
-    // Fill in intermediate points
-    for (uint16_t i = 1; i < maxPoints - 1; i++) {
-        // Calculate source index for this destination point
-        uint16_t sourceIdx = (i * (sourceCount - 1)) / (maxPoints - 1);
-        dest[i] = source[sourceIdx];
-    }
+    count = cache.count;
+    return count > 0 ? cache.points : nullptr;
 }
@@ -1,9 +1,17 @@
 #include "DisplayManager.h"
 
+#include "Crc32.h"
 #include "DataManager.h"
+#include "EnvelopeDownsampler.h"
 #include "PinConfig.h"
-#include <iomanip>
-#include <sstream>
+#include "TextBuffer.h"
+#include "models/SensorDescriptor.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifndef UNIT_TEST
+#include <esp_heap_caps.h>
+#endif
 
 #define COLOR_BLACK 0x0000
 #define COLOR_WHITE 0xFFFF
@@ -15,26 +23,92 @@
 #define COLOR_CYAN 0x07FF
 #define COLOR_MAGENTA 0xF81F
 #define COLOR_GRAY 0x8410
+#define COLOR_LIGHT_GRAY 0xC618
 #define COLOR_DARK_GRAY 0x4208
 #define DISPLAY_ROTATION 1
 
+namespace {
+
+// Widget slots of the summary page (slots are reset whenever the page is cleared)
+enum SummaryWidget : uint8_t {
+    SUMMARY_WIFI,
+    SUMMARY_QUEUE,
+    SUMMARY_TRANSMIT,
+    SUMMARY_VALUE,                        // One per sensor row
+    SUMMARY_BADGE = SUMMARY_VALUE + 5,    // One per sensor row
+    SUMMARY_MINMAX = SUMMARY_BADGE + 5,   // One per sensor row
+    SUMMARY_THRESHOLD = SUMMARY_MINMAX + 5,
+    SUMMARY_UPTIME,
+    SUMMARY_HEAP,
+    SUMMARY_LAST_UPDATE
+};
+
+enum GraphWidget : uint8_t { GRAPH_SPAN, GRAPH_PLOT };
+
+const int16_t GRAPH_PLOT_TOP = 22;        // Plot area (axes, labels, line) starts below the title
+const int16_t GRAPH_DMA_BAND_LINES = 10;  // Rows per DMA bounce buffer
+
+// Graph axes; the right and bottom edges are margins from the screen size
+const int16_t GRAPH_X_START = 40;
+const int16_t GRAPH_Y_START = 40;
+const int16_t GRAPH_RIGHT_MARGIN = 10;
+const int16_t GRAPH_BOTTOM_MARGIN = 30;
+
+// Scratch size of a formatted label; a size 1 line holds 53 characters
+const size_t TEXT_BUFFER_SIZE = 64;
+
+}  // namespace
+
 DisplayManager::DisplayManager()
-    : currentPage(DisplayPage::SUMMARY),
+    :
+#ifndef UNIT_TEST
+      graphSprite(&tft),
+      chromeSprite(&tft),
+      chromeUnit(nullptr),
+      canvas(&tft),
+      canvasOriginY(0),
+      dmaPushPending(false),
+#endif
+      currentPage(DisplayPage::SUMMARY),
       lastPageChange(0),
       lastActivity(0),
       debugMode(false),
       initialized(false),
+      glanceMode(false),
       lowPowerMode(false),
       displayEnabled(true),
       backlightBrightness(255),
       screenWidth(0),
       screenHeight(0),
       touchEnabled(false),
-      touchType(TouchControllerType::NONE) {}
+      touchType(TouchControllerType::NONE),
+      graphSpanMs(DEFAULT_GRAPH_SPAN_MS),
+      pageDirty(true),
+      plotValid(false),
+      plotCount(0),
+      plotMin(0),
+      plotMax(0),
+      plotAllCrc(0),
+      plotTailCrc(0) {
+    memset(widgets, 0, sizeof(widgets));
+#ifndef UNIT_TEST
+    dmaBands[0] = nullptr;
+    dmaBands[1] = nullptr;
+#endif
+}
 
-DisplayManager::~DisplayManager() {}
+DisplayManager::~DisplayManager() {
+#ifndef UNIT_TEST
+    waitForGraphPush();
+    heap_caps_free(dmaBands[0]);
+    heap_caps_free(dmaBands[1]);
+    graphSprite.deleteSprite();
+    chromeSprite.deleteSprite();
+#endif
+}
 
-bool DisplayManager::initialize() {
+bool DisplayManager::initialize(bool glance) {
+    glanceMode = glance;
 #ifndef UNIT_TEST
     tft.init();
     tft.setRotation(DISPLAY_ROTATION);
@@ -43,6 +117,36 @@ bool DisplayManager::initialize() {
     tft.fillScreen(COLOR_BLACK);
     tft.setTextColor(COLOR_WHITE);
     tft.setTextSize(1);
+
+    // Graph plot area is composed off-screen, in PSRAM only: it does not fit the internal heap.
+    // A glance wake draws no graph, so it skips the allocations
+    if (!glance && psramFound()) {
+        graphSprite.setColorDepth(16);
+        graphSprite.createSprite(screenWidth, screenHeight - GRAPH_PLOT_TOP);
+    }
+    // Pre-rendered axes, grid and unit label that each full plot redraw starts from
+    if (graphSprite.created()) {
+        chromeSprite.setColorDepth(16);
+        chromeSprite.createSprite(screenWidth, screenHeight - GRAPH_PLOT_TOP);
+    }
+    // PSRAM is not DMA-capable on the ESP32, so the sprite goes out through internal bounce
+    // buffers; without them it is pushed as one blocking transfer
+    if (graphSprite.created() && tft.initDMA()) {
+        size_t bandBytes = screenWidth * GRAPH_DMA_BAND_LINES * sizeof(uint16_t);
+        dmaBands[0] = static_cast<uint16_t*>(heap_caps_malloc(bandBytes, MALLOC_CAP_DMA));
+        dmaBands[1] = static_cast<uint16_t*>(heap_caps_malloc(bandBytes, MALLOC_CAP_DMA));
+        if (!dmaBands[0] || !dmaBands[1]) {
+            heap_caps_free(dmaBands[0]);
+            heap_caps_free(dmaBands[1]);
+            dmaBands[0] = nullptr;
+            dmaBands[1] = nullptr;
+        }
+    }
+    Serial.printf("[INFO] Display: graph sprite %s, chrome cache %s, DMA push %s\n",
+                  graphSprite.created() ? "in PSRAM" : "unavailable",
+                  chromeSprite.created() ? "enabled" : "disabled",
+                  dmaBands[0] ? "enabled" : "disabled");
+
     initialized = true;
     lastActivity = millis();
     return true;
@@ -55,10 +159,14 @@ bool DisplayManager::initialize() {
 #endif
 }
 
-void DisplayManager::showStartupScreen(const std::string& firmwareVersion) {
+void DisplayManager::showStartupScreen(const char* firmwareVersion) {
+#ifndef UNIT_TEST
+    waitForGraphPush();
+#endif
     if (!initialized) {
         return;
     }
+    pageDirty = true;  // Drawn over by the first page
 #ifndef UNIT_TEST
     tft.fillScreen(COLOR_BLACK);
     drawCenteredText(screenHeight / 2 - 40, "ESP32 Sensor Firmware", COLOR_CYAN, 2);
@@ -71,10 +179,14 @@ void DisplayManager::showStartupScreen(const std::string& firmwareVersion) {
     lastActivity = millis();
 }
 
-void DisplayManager::showCriticalError(const std::string& title, const std::string& message) {
+void DisplayManager::showCriticalError(const char* title, const char* message) {
+#ifndef UNIT_TEST
+    waitForGraphPush();
+#endif
     if (!initialized) {
         return;
     }
+    pageDirty = true;
 #ifndef UNIT_TEST
     tft.fillScreen(COLOR_BLACK);
 
@@ -94,11 +206,15 @@ void DisplayManager::showCriticalError(const std::string& title, const std::stri
 
     // Draw message (handle multi-line)
     int16_t messageY = iconY + 70;
-    std::string line;
-    std::istringstream stream(message);
-    while (std::getline(stream, line, '\n')) {
-        drawCenteredText(messageY, line, COLOR_WHITE, 1);
+    const char* start = message;
+    while (*start != '\0') {
+        const char* end = strchr(start, '\n');
+        size_t length = end ? static_cast<size_t>(end - start) : strlen(start);
+        TextBuffer<TEXT_BUFFER_SIZE> line;
+        line.append(start, length);
+        drawCenteredText(messageY, line.c_str(), COLOR_WHITE, 1);
         messageY += 15;
+        start += end ? length + 1 : length;
     }
 
     // Draw instruction
@@ -109,56 +225,41 @@ void DisplayManager::showCriticalError(const std::string& title, const std::stri
 
 void DisplayManager::update(const SensorReadings& current, const SystemStatus& status,
                             DataManager* dataManager, const Config* config) {
-    if (!initialized) {
+    if (!initialized || glanceMode) {
+        return;  // A glance wake keeps its one frame until powerDown()
+    }
+    handleTouch();
+
+    // Everything the pages show besides the clock (which the scheduler ticks itself)
+    uint32_t inputsKey = static_cast<uint32_t>(current.monotonicMs);
+    inputsKey = crc32Update(&status.wifiRssi, sizeof(status.wifiRssi), inputsKey);
+    inputsKey = crc32Update(&status.queueDepth, sizeof(status.queueDepth), inputsKey);
+    inputsKey =
+        crc32Update(&status.lastTransmissionMs, sizeof(status.lastTransmissionMs), inputsKey);
+    if (pageDirty) {
+        scheduler.requestFrame();
+    }
+    if (!scheduler.shouldRender(inputsKey, millis())) {
         return;
     }
+
+#ifndef UNIT_TEST
+    waitForGraphPush();  // The previous frame's plot may still be going out
+#endif
     switch (currentPage) {
         case DisplayPage::SUMMARY:
-            renderSummaryPage(current, status, config);
+            renderSummaryPage(current, status, dataManager, config);
             break;
         case DisplayPage::GRAPH_BME280_TEMP:
-            if (dataManager) {
-                uint16_t count = 0;
-                const DisplayPoint* data =
-                    dataManager->getDisplayData(SensorType::BME280_TEMP, count, 120);
-                std::vector<DisplayPoint> dataVec(data, data + count);
-                renderGraphPage(SensorType::BME280_TEMP, dataVec);
-            }
-            break;
         case DisplayPage::GRAPH_DS18B20_TEMP:
-            if (dataManager) {
-                uint16_t count = 0;
-                const DisplayPoint* data =
-                    dataManager->getDisplayData(SensorType::DS18B20_TEMP, count, 120);
-                std::vector<DisplayPoint> dataVec(data, data + count);
-                renderGraphPage(SensorType::DS18B20_TEMP, dataVec);
-            }
-            break;
         case DisplayPage::GRAPH_HUMIDITY:
-            if (dataManager) {
-                uint16_t count = 0;
-                const DisplayPoint* data =
-                    dataManager->getDisplayData(SensorType::HUMIDITY, count, 120);
-                std::vector<DisplayPoint> dataVec(data, data + count);
-                renderGraphPage(SensorType::HUMIDITY, dataVec);
-            }
-            break;
         case DisplayPage::GRAPH_PRESSURE:
-            if (dataManager) {
-                uint16_t count = 0;
-                const DisplayPoint* data =
-                    dataManager->getDisplayData(SensorType::PRESSURE, count, 120);
-                std::vector<DisplayPoint> dataVec(data, data + count);
-                renderGraphPage(SensorType::PRESSURE, dataVec);
-            }
-            break;
         case DisplayPage::GRAPH_SOIL_MOISTURE:
+            // Graph pages follow SensorType order
             if (dataManager) {
-                uint16_t count = 0;
-                const DisplayPoint* data =
-                    dataManager->getDisplayData(SensorType::SOIL_MOISTURE, count, 120);
-                std::vector<DisplayPoint> dataVec(data, data + count);
-                renderGraphPage(SensorType::SOIL_MOISTURE, dataVec);
+                uint8_t index = static_cast<uint8_t>(currentPage) -
+                                static_cast<uint8_t>(DisplayPage::GRAPH_BME280_TEMP);
+                renderGraphPage(static_cast<SensorType>(index), *dataManager);
             }
             break;
         case DisplayPage::SYSTEM_HEALTH:
@@ -199,6 +300,34 @@ void DisplayManager::cyclePage() {
             break;
     }
     lastPageChange = millis();
+    pageDirty = true;
+}
+
+void DisplayManager::handleTouch() {
+    TouchGesture gesture;
+    while (touchInput.poll(millis(), gesture)) {
+        lastActivity = millis();  // A touch also counts against the burn-in dimming
+        switch (gesture) {
+            case TouchGesture::TAP:
+                cyclePage();
+                break;
+            case TouchGesture::LONG_PRESS:
+                cycleGraphSpan();
+                break;
+        }
+    }
+}
+
+void DisplayManager::cycleGraphSpan() {
+    static const uint32_t SPANS_MS[] = {4UL * 3600000UL, 24UL * 3600000UL, 7UL * 86400000UL};
+    uint32_t next = SPANS_MS[0];
+    for (uint32_t span : SPANS_MS) {
+        if (span > graphSpanMs) {
+            next = span;
+            break;
+        }
+    }
+    setGraphSpanMs(next);
 }
 
 void DisplayManager::checkAndCyclePage(uint16_t intervalMs) {
@@ -214,6 +343,7 @@ void DisplayManager::checkAndCyclePage(uint16_t intervalMs) {
 
 void DisplayManager::setDebugMode(bool enabled) {
     debugMode = enabled;
+    scheduler.requestFrame();
 }
 
 void DisplayManager::checkBurnInProtection() {
@@ -234,191 +364,181 @@ void DisplayManager::checkBurnInProtection() {
 }
 
 void DisplayManager::renderSummaryPage(const SensorReadings& current, const SystemStatus& status,
-                                       const Config* config) {
+                                       const DataManager* dataManager, const Config* config) {
 #ifndef UNIT_TEST
-    tft.fillScreen(COLOR_BLACK);
-
-    // Header
-    drawText(5, 5, "Sensor Summary", COLOR_CYAN, 2);
-
-    // WiFi and Queue indicators in top right
-    drawWiFiIndicator(screenWidth - 40, 5, status.wifiRssi);
-    drawQueueDepth(screenWidth - 40, 25, status.queueDepth);
-    drawTransmissionIndicator(screenWidth - 40, 45, status.lastTransmissionMs);
+    // Min/max over the graph span, as the graph pages scale to; the lifetime extremes in
+    // the status only stand in until the history has a point
+    float minValues[NUM_SENSORS];
+    float maxValues[NUM_SENSORS];
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        const SensorDescriptor& sensor = SENSOR_DESCRIPTORS[i];
+        minValues[i] = status.minValues.*sensor.reading;
+        maxValues[i] = status.maxValues.*sensor.reading;
+        if (dataManager) {
+            dataManager->getDisplayRange(sensor.type, graphSpanMs, minValues[i], maxValues[i]);
+        }
+    }
 
     int16_t yPos = 35;
     int16_t lineHeight = 28;
     const int16_t labelX = 10;
     const int16_t valueX = screenWidth - 80;
+    char text[TEXT_BUFFER_SIZE];
+    char number[16];
+
+    // Header and labels only change with the page
+    if (beginPage()) {
+        drawText(5, 5, "Sensor Summary", COLOR_CYAN, 2);
+        for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+            snprintf(text, sizeof(text), "%s:", SENSOR_DESCRIPTORS[i].label);
+            drawText(labelX, yPos + i * lineHeight, text, COLOR_WHITE, 1);
+        }
+    }
 
-    // BME280 Temperature
-    SensorHealth bme280Health =
-        (current.sensorStatus & (1 << static_cast<uint8_t>(SensorType::BME280_TEMP)))
-            ? SensorHealth::GREEN
-            : SensorHealth::RED;
-    drawText(labelX, yPos, "BME280 Temp:", COLOR_WHITE, 1);
-    drawRightAlignedText(valueX, yPos, formatFloat(current.bme280Temp, 1) + " C", COLOR_WHITE, 1);
-    drawHealthBadge(screenWidth - 20, yPos, bme280Health);
-    yPos += 12;
-    drawMinMax(labelX + 10, yPos, status.minValues.bme280Temp, status.maxValues.bme280Temp);
-    yPos += lineHeight - 12;
-
-    // DS18B20 Temperature
-    SensorHealth ds18b20Health =
-        (current.sensorStatus & (1 << static_cast<uint8_t>(SensorType::DS18B20_TEMP)))
-            ? SensorHealth::GREEN
-            : SensorHealth::RED;
-    drawText(labelX, yPos, "DS18B20 Temp:", COLOR_WHITE, 1);
-    drawRightAlignedText(valueX, yPos, formatFloat(current.ds18b20Temp, 1) + " C", COLOR_WHITE, 1);
-    drawHealthBadge(screenWidth - 20, yPos, ds18b20Health);
-    yPos += 12;
-    drawMinMax(labelX + 10, yPos, status.minValues.ds18b20Temp, status.maxValues.ds18b20Temp);
-    yPos += lineHeight - 12;
-
-    // Humidity
-    SensorHealth humidityHealth =
-        (current.sensorStatus & (1 << static_cast<uint8_t>(SensorType::HUMIDITY)))
-            ? SensorHealth::GREEN
-            : SensorHealth::RED;
-    drawText(labelX, yPos, "Humidity:", COLOR_WHITE, 1);
-    drawRightAlignedText(valueX, yPos, formatFloat(current.humidity, 1) + " %", COLOR_WHITE, 1);
-    drawHealthBadge(screenWidth - 20, yPos, humidityHealth);
-    yPos += 12;
-    drawMinMax(labelX + 10, yPos, status.minValues.humidity, status.maxValues.humidity);
-    yPos += lineHeight - 12;
-
-    // Pressure
-    SensorHealth pressureHealth =
-        (current.sensorStatus & (1 << static_cast<uint8_t>(SensorType::PRESSURE)))
-            ? SensorHealth::GREEN
-            : SensorHealth::RED;
-    drawText(labelX, yPos, "Pressure:", COLOR_WHITE, 1);
-    drawRightAlignedText(valueX, yPos, formatFloat(current.pressure, 1) + " hPa", COLOR_WHITE, 1);
-    drawHealthBadge(screenWidth - 20, yPos, pressureHealth);
-    yPos += 12;
-    drawMinMax(labelX + 10, yPos, status.minValues.pressure, status.maxValues.pressure);
-    yPos += lineHeight - 12;
-
-    // Soil Moisture
-    SensorHealth soilHealth =
-        (current.sensorStatus & (1 << static_cast<uint8_t>(SensorType::SOIL_MOISTURE)))
-            ? SensorHealth::GREEN
-            : SensorHealth::RED;
-    drawText(labelX, yPos, "Soil Moisture:", COLOR_WHITE, 1);
-    drawRightAlignedText(valueX, yPos, formatFloat(current.soilMoisture, 1) + " %", COLOR_WHITE, 1);
-    drawHealthBadge(screenWidth - 20, yPos, soilHealth);
-    yPos += 12;
-    drawMinMax(labelX + 10, yPos, status.minValues.soilMoisture, status.maxValues.soilMoisture);
+    // WiFi and Queue indicators in top right
+    drawWiFiIndicator(SUMMARY_WIFI, screenWidth - 40, 5, status.wifiRssi);
+    drawQueueDepth(SUMMARY_QUEUE, screenWidth - 40, 25, status.queueDepth);
+    drawTransmissionIndicator(SUMMARY_TRANSMIT, screenWidth - 40, 45, status.lastTransmissionMs);
+
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        const SensorDescriptor& sensor = SENSOR_DESCRIPTORS[i];
+        SensorHealth health = (current.sensorStatus & (1 << sensor.busBit)) ? SensorHealth::GREEN
+                                                                           : SensorHealth::RED;
+        formatFloat(current.*sensor.reading, 1, number, sizeof(number));
+        snprintf(text, sizeof(text), "%s %s", number, sensor.unit);
+        drawTextWidget(SUMMARY_VALUE + i, valueX, yPos, text, COLOR_WHITE, 1, true);
+        drawHealthBadge(SUMMARY_BADGE + i, screenWidth - 20, yPos, health);
+        yPos += 12;
+        drawMinMax(SUMMARY_MINMAX + i, labelX + 10, yPos, minValues[i], maxValues[i]);
+        yPos += lineHeight - 12;
+    }
 
     // Draw threshold indicator if config is provided
     if (config) {
-        yPos += 12;
-        drawThresholdIndicator(labelX + 10, yPos, current.soilMoisture,
+        yPos -= lineHeight - 24;  // Directly below the last min/max line
+        drawThresholdIndicator(SUMMARY_THRESHOLD, labelX + 10, yPos, current.soilMoisture,
                                static_cast<float>(config->soilMoistureThresholdLow),
                                static_cast<float>(config->soilMoistureThresholdHigh));
     }
 
     // Footer with system info
     yPos = screenHeight - 40;
-    drawText(5, yPos, "Uptime: " + formatUptime(status.uptimeMs), COLOR_GRAY, 1);
+    snprintf(text, sizeof(text), "Uptime: %s",
+             formatUptime(status.uptimeMs, number, sizeof(number)));
+    drawTextWidget(SUMMARY_UPTIME, 5, yPos, text, COLOR_GRAY, 1);
     yPos += 12;
-    drawText(5, yPos, "Heap: " + std::to_string(status.freeHeap) + " bytes", COLOR_GRAY, 1);
+    snprintf(text, sizeof(text), "Heap: %lu bytes", (unsigned long)status.freeHeap);
+    drawTextWidget(SUMMARY_HEAP, 5, yPos, text, COLOR_GRAY, 1);
     yPos += 12;
 
     // Time since last sensor update
     unsigned long timeSinceUpdate = (millis() - current.monotonicMs) / 1000;
-    std::string updateText = "Last update: " + std::to_string(timeSinceUpdate) + "s ago";
-    drawText(5, yPos, updateText, COLOR_GRAY, 1);
+    snprintf(text, sizeof(text), "Last update: %lus ago", timeSinceUpdate);
+    drawTextWidget(SUMMARY_LAST_UPDATE, 5, yPos, text, COLOR_GRAY, 1);
 #else
     (void)current;
     (void)status;
+    (void)dataManager;
 #endif
 }
 
 void DisplayManager::renderSystemHealthPage(const SystemStatus& status) {
 #ifndef UNIT_TEST
-    tft.fillScreen(COLOR_BLACK);
-    drawText(5, 5, "System Health", COLOR_CYAN, 2);
     int16_t yPos = 35;
     int16_t lineHeight = 15;
-    drawText(10, yPos, "Uptime: " + formatUptime(status.uptimeMs), COLOR_WHITE, 1);
+    if (beginPage()) {
+        drawText(5, 5, "System Health", COLOR_CYAN, 2);
+        drawText(10, yPos + 5 * lineHeight + 5, "Error Counters:", COLOR_YELLOW, 1);
+    }
+
+    char text[TEXT_BUFFER_SIZE];
+    char uptime[16];
+    uint8_t slot = 0;
+    formatUptime(status.uptimeMs, uptime, sizeof(uptime));
+    snprintf(text, sizeof(text), "Uptime: %s", uptime);
+    drawTextWidget(slot++, 10, yPos, text, COLOR_WHITE, 1);
     yPos += lineHeight;
-    drawText(10, yPos, "Free Heap: " + std::to_string(status.freeHeap) + " bytes", COLOR_WHITE, 1);
+    snprintf(text, sizeof(text), "Free Heap: %lu bytes", (unsigned long)status.freeHeap);
+    drawTextWidget(slot++, 10, yPos, text, COLOR_WHITE, 1);
     yPos += lineHeight;
-    drawText(10, yPos, "WiFi RSSI: " + std::to_string(status.wifiRssi) + " dBm", COLOR_WHITE, 1);
+    snprintf(text, sizeof(text), "WiFi RSSI: %d dBm", status.wifiRssi);
+    drawTextWidget(slot++, 10, yPos, text, COLOR_WHITE, 1);
     yPos += lineHeight;
-    drawText(10, yPos, "Queue Depth: " + std::to_string(status.queueDepth), COLOR_WHITE, 1);
+    snprintf(text, sizeof(text), "Queue Depth: %u", (unsigned)status.queueDepth);
+    drawTextWidget(slot++, 10, yPos, text, COLOR_WHITE, 1);
     yPos += lineHeight;
-    drawText(10, yPos, "Boot Count: " + std::to_string(status.bootCount), COLOR_WHITE, 1);
+    snprintf(text, sizeof(text), "Boot Count: %lu", (unsigned long)status.bootCount);
+    drawTextWidget(slot++, 10, yPos, text, COLOR_WHITE, 1);
     yPos += lineHeight + 5;
-    drawText(10, yPos, "Error Counters:", COLOR_YELLOW, 1);
-    yPos += lineHeight;
-    drawText(15, yPos, "Sensor: " + std::to_string(status.errors.sensorReadFailures), COLOR_WHITE,
-             1);
+    yPos += lineHeight;  // "Error Counters:" label
+    snprintf(text, sizeof(text), "Sensor: %lu", (unsigned long)status.errors.sensorReadFailures);
+    drawTextWidget(slot++, 15, yPos, text, COLOR_WHITE, 1);
     yPos += lineHeight;
-    drawText(15, yPos, "Network: " + std::to_string(status.errors.networkFailures), COLOR_WHITE, 1);
+    snprintf(text, sizeof(text), "Network: %lu", (unsigned long)status.errors.networkFailures);
+    drawTextWidget(slot++, 15, yPos, text, COLOR_WHITE, 1);
     yPos += lineHeight;
-    drawText(15, yPos, "Buffer: " + std::to_string(status.errors.bufferOverflows), COLOR_WHITE, 1);
+    snprintf(text, sizeof(text), "Buffer: %lu", (unsigned long)status.errors.bufferOverflows);
+    drawTextWidget(slot++, 15, yPos, text, COLOR_WHITE, 1);
 #else
     (void)status;
 #endif
 }
 
-void DisplayManager::renderGraphPage(SensorType type, const std::vector<DisplayPoint>& data) {
+void DisplayManager::renderGraphPage(SensorType type, const DataManager& history) {
 #ifndef UNIT_TEST
-    tft.fillScreen(COLOR_BLACK);
+    uint16_t count = 0;
+    const DisplayPoint* data =
+        history.getDisplayHistory(type, graphSpanMs, count, GRAPH_MAX_POINTS);
+
+    // Scale from the running extrema of the span (no pass over the points); a span of
+    // nothing but NaN readings has no scale and shows as empty
+    float minVal = 0.0f;
+    float maxVal = 0.0f;
+    if (!history.getDisplayRange(type, graphSpanMs, minVal, maxVal)) {
+        count = 0;
+    }
 
-    // Draw title based on sensor type
-    std::string title;
-    std::string unit;
-    switch (type) {
-        case SensorType::BME280_TEMP:
-            title = "BME280 Temperature";
-            unit = "C";
-            break;
-        case SensorType::DS18B20_TEMP:
-            title = "DS18B20 Temperature";
-            unit = "C";
-            break;
-        case SensorType::HUMIDITY:
-            title = "Humidity";
-            unit = "%";
-            break;
-        case SensorType::PRESSURE:
-            title = "Pressure";
-            unit = "hPa";
-            break;
-        case SensorType::SOIL_MOISTURE:
-            title = "Soil Moisture";
-            unit = "%";
-            break;
-        default:
-            title = "Unknown Sensor";
-            unit = "";
-            break;
+    bool cleared = beginPage();
+
+    // Title and axis unit from the sensor's descriptor
+    const SensorDescriptor& sensor = sensorDescriptor(type);
+    const char* unit = sensor.unit;
+
+    if (cleared) {
+        drawText(5, 5, sensor.title, COLOR_CYAN, 2);
     }
 
-    drawText(5, 5, title, COLOR_CYAN, 2);
+    // Graph span label ("4h", "24h", "7d")
+    uint32_t spanHours = graphSpanMs / 3600000UL;
+    char spanLabel[12];
+    if (spanHours >= 48) {
+        snprintf(spanLabel, sizeof(spanLabel), "%lud", (unsigned long)(spanHours / 24));
+    } else {
+        snprintf(spanLabel, sizeof(spanLabel), "%luh", (unsigned long)spanHours);
+    }
+    drawTextWidget(GRAPH_SPAN, screenWidth - 5, 5, spanLabel, COLOR_GRAY, 1, true);
 
-    if (data.empty()) {
-        drawCenteredText(screenHeight / 2, "No data available", COLOR_GRAY, 1);
+    // The plot (axes, labels and line) is redrawn only when its points change; the sprite
+    // covers the whole plot rectangle, so it needs no clearing first
+    uint32_t plotState = crc32Update(data, count * sizeof(DisplayPoint));
+    if (!beginWidget(GRAPH_PLOT, plotState, 0, GRAPH_PLOT_TOP, screenWidth,
+                     screenHeight - GRAPH_PLOT_TOP, !graphSprite.created())) {
         return;
     }
 
-    // Downsample if needed
-    std::vector<DisplayPoint> plotData = data;
-    if (data.size() > 120) {
-        plotData = downsample(data, 120);
+    if (count == 0) {
+        plotValid = false;
+        beginGraphCanvas(true);
+        drawCenteredText(screenHeight / 2, "No data available", COLOR_GRAY, 1);
+        pushGraphCanvas();
+        return;
     }
 
-    // Find min/max for scaling
-    float minVal = plotData[0].value;
-    float maxVal = plotData[0].value;
-    for (const auto& point : plotData) {
-        if (point.value < minVal)
-            minVal = point.value;
-        if (point.value > maxVal)
-            maxVal = point.value;
+    // Downsample if needed (into plotScratch; the history buffer is read in place otherwise)
+    const DisplayPoint* plotData = data;
+    if (count > GRAPH_MAX_POINTS) {
+        count = downsample(data, count, plotScratch, GRAPH_MAX_POINTS);
+        plotData = plotScratch;
     }
 
     // Add some padding to min/max
@@ -428,24 +548,54 @@ void DisplayManager::renderGraphPage(SensorType type, const std::vector<DisplayP
     minVal -= range * 0.1f;
     maxVal += range * 0.1f;
 
-    // Draw axes
-    drawAxes(minVal, maxVal, unit);
-
-    // Draw line graph
-    drawLineGraph(plotData, 120);
+    // One new point on an unchanged scale: the series either grew by one or dropped its
+    // oldest point, so everything already plotted moves one step left
+    const size_t pointBytes = sizeof(DisplayPoint);
+    uint32_t headCrc = crc32Update(plotData, (count - 1) * pointBytes);
+    bool shifted = (count == plotCount && headCrc == plotTailCrc) ||
+                   (count == plotCount + 1 && headCrc == plotAllCrc);
+    bool incremental = graphSprite.created() && plotValid && count >= 2 && shifted &&
+                       minVal == plotMin && maxVal == plotMax;
+
+    if (incremental) {
+        beginGraphCanvas(false);
+        scrollGraphLeft();
+        drawGraphSegment(plotData, count, count - 1, minVal, maxVal);
+    } else {
+        // Start from the cached chrome when there is one; draw it otherwise
+        bool chromeRestored = restoreGraphChrome(unit);
+        beginGraphCanvas(!chromeRestored);
+        if (!chromeRestored) {
+            drawAxes(unit);
+        }
+        drawScaleLabels(minVal, maxVal);
+        drawLineGraph(plotData, count, minVal, maxVal);
+    }
+    pushGraphCanvas();
+
+    // What the sprite now holds, to recognize the next shift
+    plotValid = true;
+    plotCount = count;
+    plotMin = minVal;
+    plotMax = maxVal;
+    plotAllCrc = crc32Update(plotData, count * pointBytes);
+    plotTailCrc = crc32Update(plotData + 1, (count - 1) * pointBytes);
 #else
     (void)type;
-    (void)data;
+    (void)history;
 #endif
 }
 
-void DisplayManager::drawSensorValue(int16_t x, int16_t y, const std::string& label, float value,
-                                     const std::string& unit, SensorHealth health) {
+void DisplayManager::drawSensorValue(int16_t x, int16_t y, const char* label, float value,
+                                     const char* unit, SensorHealth health) {
 #ifndef UNIT_TEST
     drawText(x, y, label, COLOR_WHITE, 1);
-    std::string valueStr = formatFloat(value, 1) + " " + unit;
+    char number[16];
+    char valueStr[TEXT_BUFFER_SIZE];
+    snprintf(valueStr, sizeof(valueStr), "%s %s", formatFloat(value, 1, number, sizeof(number)),
+             unit);
     drawRightAlignedText(screenWidth - 50, y, valueStr, COLOR_WHITE, 1);
-    drawHealthBadge(screenWidth - 35, y, health);
+    drawHealthBadge(MAX_WIDGETS, screenWidth - 35, y, health);  // Untracked
 #else
     (void)x;
     (void)y;
@@ -456,22 +606,32 @@ void DisplayManager::drawSensorValue(int16_t x, int16_t y, const std::string& la
 #endif
 }
 
-void DisplayManager::drawHealthBadge(int16_t x, int16_t y, SensorHealth health) {
+void DisplayManager::drawHealthBadge(uint8_t slot, int16_t x, int16_t y, SensorHealth health) {
 #ifndef UNIT_TEST
+    if (!beginWidget(slot, static_cast<uint32_t>(health), x - 4, y, 9, 9)) {
+        return;
+    }
     uint16_t color = getHealthColor(health);
     tft.fillCircle(x, y + 4, 4, color);
 #else
+    (void)slot;
     (void)x;
     (void)y;
     (void)health;
 #endif
 }
 
-void DisplayManager::drawMinMax(int16_t x, int16_t y, float minVal, float maxVal) {
+void DisplayManager::drawMinMax(uint8_t slot, int16_t x, int16_t y, float minVal, float maxVal) {
 #ifndef UNIT_TEST
-    std::string text = "Min: " + formatFloat(minVal, 1) + " Max: " + formatFloat(maxVal, 1);
-    drawText(x, y, text, COLOR_GRAY, 1);
+    char minText[16];
+    char maxText[16];
+    char text[TEXT_BUFFER_SIZE];
+    formatFloat(minVal, 1, minText, sizeof(minText));
+    formatFloat(maxVal, 1, maxText, sizeof(maxText));
+    snprintf(text, sizeof(text), "Min: %s Max: %s", minText, maxText);
+    drawTextWidget(slot, x, y, text, COLOR_GRAY, 1);
 #else
+    (void)slot;
     (void)x;
     (void)y;
     (void)minVal;
@@ -479,9 +639,14 @@ void DisplayManager::drawMinMax(int16_t x, int16_t y, float minVal, float maxVal
 #endif
 }
 
-void DisplayManager::drawWiFiIndicator(int16_t x, int16_t y, int8_t rssi) {
+void DisplayManager::drawWiFiIndicator(uint8_t slot, int16_t x, int16_t y, int8_t rssi) {
 #ifndef UNIT_TEST
     uint16_t color = getRSSIColor(rssi);
+    // Bars only change with the color band and the -70 dBm step
+    uint32_t state = (static_cast<uint32_t>(color) << 1) | (rssi > -70 ? 1 : 0);
+    if (!beginWidget(slot, state, x, y, 11, 9)) {
+        return;
+    }
     for (int i = 0; i < 3; i++) {
         int barHeight = (i + 1) * 3;
         if (rssi > -70 || i == 0) {
@@ -491,30 +656,39 @@ void DisplayManager::drawWiFiIndicator(int16_t x, int16_t y, int8_t rssi) {
         }
     }
 #else
+    (void)slot;
     (void)x;
     (void)y;
     (void)rssi;
 #endif
 }
 
-void DisplayManager::drawQueueDepth(int16_t x, int16_t y, uint16_t count) {
+void DisplayManager::drawQueueDepth(uint8_t slot, int16_t x, int16_t y, uint16_t count) {
 #ifndef UNIT_TEST
-    std::string text = "Q:" + std::to_string(count);
-    drawText(x - 10, y, text, count > 0 ? COLOR_YELLOW : COLOR_GREEN, 1);
+    char text[12];
+    snprintf(text, sizeof(text), "Q:%u", (unsigned)count);
+    drawTextWidget(slot, x - 10, y, text, count > 0 ? COLOR_YELLOW : COLOR_GREEN, 1);
 #else
+    (void)slot;
     (void)x;
     (void)y;
     (void)count;
 #endif
 }
 
-void DisplayManager::drawTransmissionIndicator(int16_t x, int16_t y,
+void DisplayManager::drawTransmissionIndicator(uint8_t slot, int16_t x, int16_t y,
                                                unsigned long lastTransmissionMs) {
 #ifndef UNIT_TEST
     unsigned long now = millis();
     const unsigned long FLASH_DURATION = 2000;  // Show indicator for 2 seconds after transmission
 
-    if (lastTransmissionMs > 0 && (now - lastTransmissionMs) < FLASH_DURATION) {
+    bool flashing = lastTransmissionMs > 0 && (now - lastTransmissionMs) < FLASH_DURATION;
+    uint32_t state = flashing ? 1 : (lastTransmissionMs == 0 ? 2 : 0);
+    if (!beginWidget(slot, state, x - 5, y - 1, 11, 11)) {
+        return;  // Unchanged; the idle state is the cleared rectangle
+    }
+
+    if (flashing) {
         // Draw a green checkmark or success indicator
         tft.fillCircle(x, y + 4, 5, COLOR_GREEN);
         tft.drawLine(x - 2, y + 4, x, y + 6, COLOR_BLACK);
@@ -524,21 +698,22 @@ void DisplayManager::drawTransmissionIndicator(int16_t x, int16_t y,
         tft.fillCircle(x, y + 4, 5, COLOR_GRAY);
     }
 #else
+    (void)slot;
     (void)x;
     (void)y;
     (void)lastTransmissionMs;
 #endif
 }
 
-void DisplayManager::drawThresholdIndicator(int16_t x, int16_t y, float value, float lowThreshold,
-                                            float highThreshold) {
+void DisplayManager::drawThresholdIndicator(uint8_t slot, int16_t x, int16_t y, float value,
+                                            float lowThreshold, float highThreshold) {
 #ifndef UNIT_TEST
     // Only draw if thresholds are configured (non-zero)
     if (lowThreshold == 0 && highThreshold == 0) {
         return;
     }
 
-    std::string indicator;
+    const char* indicator;
     uint16_t color;
 
     if (highThreshold > 0 && value >= highThreshold) {
@@ -552,8 +727,9 @@ void DisplayManager::drawThresholdIndicator(int16_t x, int16_t y, float value, f
         color = COLOR_GREEN;
     }
 
-    drawText(x, y, indicator, color, 1);
+    drawTextWidget(slot, x, y, indicator, color, 1);
 #else
+    (void)slot;
     (void)x;
     (void)y;
     (void)value;
@@ -562,110 +738,122 @@ void DisplayManager::drawThresholdIndicator(int16_t x, int16_t y, float value, f
 #endif
 }
 
-void DisplayManager::drawLineGraph(const std::vector<DisplayPoint>& data, uint16_t maxPoints) {
+void DisplayManager::drawLineGraph(const DisplayPoint* data, uint16_t count, float minVal,
+                                   float maxVal) {
 #ifndef UNIT_TEST
-    if (data.empty())
-        return;
-
-    // Define graph area
-    const int16_t GRAPH_X_START = 40;
-    const int16_t GRAPH_X_END = screenWidth - 10;
-    const int16_t GRAPH_Y_START = 40;
-    const int16_t GRAPH_Y_END = screenHeight - 30;
-
-    // Find min/max for scaling
-    float minVal = data[0].value;
-    float maxVal = data[0].value;
-    for (const auto& point : data) {
-        if (point.value < minVal)
-            minVal = point.value;
-        if (point.value > maxVal)
-            maxVal = point.value;
+    for (uint16_t i = 1; i < count; i++) {
+        drawGraphSegment(data, count, i, minVal, maxVal);
     }
+#else
+    (void)data;
+    (void)count;
+    (void)minVal;
+    (void)maxVal;
+#endif
+}
 
-    // Add padding
-    float range = maxVal - minVal;
-    if (range < 0.1f)
-        range = 0.1f;
-    minVal -= range * 0.1f;
-    maxVal += range * 0.1f;
+void DisplayManager::drawGraphSegment(const DisplayPoint* data, uint16_t count, uint16_t index,
+                                      float minVal, float maxVal) {
+#ifndef UNIT_TEST
+    const int16_t xEnd = screenWidth - GRAPH_RIGHT_MARGIN;
+    const int16_t yEnd = screenHeight - GRAPH_BOTTOM_MARGIN;
+
+    // Points sit a fixed step apart, newest at the right edge, so a new point moves the
+    // rest by exactly one step
+    int16_t x2 = xEnd - (count - 1 - index) * graphStep();
+    int16_t x1 = x2 - graphStep();
+
+    int16_t y1 = yEnd - ((data[index - 1].value - minVal) * (yEnd - GRAPH_Y_START)) /
+                            (maxVal - minVal);
+    int16_t y2 =
+        yEnd - ((data[index].value - minVal) * (yEnd - GRAPH_Y_START)) / (maxVal - minVal);
+
+    // Clamp to graph area
+    if (y1 < GRAPH_Y_START)
+        y1 = GRAPH_Y_START;
+    if (y1 > yEnd)
+        y1 = yEnd;
+    if (y2 < GRAPH_Y_START)
+        y2 = GRAPH_Y_START;
+    if (y2 > yEnd)
+        y2 = yEnd;
+
+    canvas->drawLine(x1, y1 - canvasOriginY, x2, y2 - canvasOriginY, COLOR_CYAN);
+#else
+    (void)data;
+    (void)count;
+    (void)index;
+    (void)minVal;
+    (void)maxVal;
+#endif
+}
+
+int16_t DisplayManager::graphStep() const {
+    int16_t width = screenWidth - GRAPH_RIGHT_MARGIN - GRAPH_X_START;
+    int16_t step = width / (GRAPH_MAX_POINTS - 1);
+    return step > 0 ? step : 1;
+}
 
-    // Draw line graph
-    for (size_t i = 1; i < data.size() && i < maxPoints; i++) {
-        // Map data points to screen coordinates
-        int16_t x1 = GRAPH_X_START + ((i - 1) * (GRAPH_X_END - GRAPH_X_START)) / (data.size() - 1);
-        int16_t y1 = GRAPH_Y_END - ((data[i - 1].value - minVal) * (GRAPH_Y_END - GRAPH_Y_START)) /
-                                       (maxVal - minVal);
-
-        int16_t x2 = GRAPH_X_START + (i * (GRAPH_X_END - GRAPH_X_START)) / (data.size() - 1);
-        int16_t y2 = GRAPH_Y_END -
-                     ((data[i].value - minVal) * (GRAPH_Y_END - GRAPH_Y_START)) / (maxVal - minVal);
-
-        // Clamp to graph area
-        if (y1 < GRAPH_Y_START)
-            y1 = GRAPH_Y_START;
-        if (y1 > GRAPH_Y_END)
-            y1 = GRAPH_Y_END;
-        if (y2 < GRAPH_Y_START)
-            y2 = GRAPH_Y_START;
-        if (y2 > GRAPH_Y_END)
-            y2 = GRAPH_Y_END;
-
-        tft.drawLine(x1, y1, x2, y2, COLOR_CYAN);
+void DisplayManager::drawGridRows(int16_t x, int16_t width) {
+#ifndef UNIT_TEST
+    // Solid rows, so scrolling the plot keeps them intact
+    const int16_t top = GRAPH_Y_START - canvasOriginY;
+    const int16_t bottom = screenHeight - GRAPH_BOTTOM_MARGIN - canvasOriginY;
+    for (int i = 1; i < 4; i++) {
+        canvas->drawFastHLine(x, top + (i * (bottom - top) / 4), width, COLOR_DARK_GRAY);
     }
 #else
-    (void)data;
-    (void)maxPoints;
+    (void)x;
+    (void)width;
 #endif
 }
 
-void DisplayManager::drawAxes(float minVal, float maxVal, const std::string& unit) {
+void DisplayManager::drawAxes(const char* unit) {
 #ifndef UNIT_TEST
-    const int16_t GRAPH_X_START = 40;
-    const int16_t GRAPH_X_END = screenWidth - 10;
-    const int16_t GRAPH_Y_START = 40;
-    const int16_t GRAPH_Y_END = screenHeight - 30;
+    const int16_t GRAPH_X_END = screenWidth - GRAPH_RIGHT_MARGIN;
+    const int16_t GRAPH_Y_END = screenHeight - GRAPH_BOTTOM_MARGIN;
 
-    // Draw Y axis
-    tft.drawLine(GRAPH_X_START, GRAPH_Y_START, GRAPH_X_START, GRAPH_Y_END, COLOR_WHITE);
+    const int16_t top = GRAPH_Y_START - canvasOriginY;
+    const int16_t bottom = GRAPH_Y_END - canvasOriginY;
 
-    // Draw X axis
-    tft.drawLine(GRAPH_X_START, GRAPH_Y_END, GRAPH_X_END, GRAPH_Y_END, COLOR_WHITE);
+    // Draw grid lines first, so the line graph is drawn over them
+    drawGridRows(GRAPH_X_START + 1, GRAPH_X_END - GRAPH_X_START);
 
-    // Draw min label
-    std::string minLabel = formatFloat(minVal, 1);
-    drawText(5, GRAPH_Y_END - 4, minLabel, COLOR_GRAY, 1);
+    // Draw Y axis
+    canvas->drawFastVLine(GRAPH_X_START, top, bottom - top + 1, COLOR_WHITE);
 
-    // Draw max label
-    std::string maxLabel = formatFloat(maxVal, 1);
-    drawText(5, GRAPH_Y_START - 4, maxLabel, COLOR_GRAY, 1);
+    // Draw X axis
+    canvas->drawFastHLine(GRAPH_X_START, bottom, GRAPH_X_END - GRAPH_X_START + 1, COLOR_WHITE);
 
     // Draw unit label
-    if (!unit.empty()) {
+    if (unit[0] != '\0') {
         drawText(5, GRAPH_Y_START + ((GRAPH_Y_END - GRAPH_Y_START) / 2), unit, COLOR_GRAY, 1);
     }
+#else
+    (void)unit;
+#endif
+}
 
-    // Draw grid lines (optional)
-    for (int i = 1; i < 4; i++) {
-        int16_t y = GRAPH_Y_START + (i * (GRAPH_Y_END - GRAPH_Y_START) / 4);
-        for (int16_t x = GRAPH_X_START; x < GRAPH_X_END; x += 4) {
-            tft.drawPixel(x, y, COLOR_DARK_GRAY);
-        }
-    }
+void DisplayManager::drawScaleLabels(float minVal, float maxVal) {
+#ifndef UNIT_TEST
+    char label[16];
+    formatFloat(minVal, 1, label, sizeof(label));
+    drawText(5, screenHeight - GRAPH_BOTTOM_MARGIN - 4, label, COLOR_GRAY, 1);
+    formatFloat(maxVal, 1, label, sizeof(label));
+    drawText(5, GRAPH_Y_START - 4, label, COLOR_GRAY, 1);
 #else
     (void)minVal;
     (void)maxVal;
-    (void)unit;
 #endif
 }
 
-void DisplayManager::drawText(int16_t x, int16_t y, const std::string& text, uint16_t color,
+void DisplayManager::drawText(int16_t x, int16_t y, const char* text, uint16_t color,
                               uint8_t size) {
 #ifndef UNIT_TEST
-    tft.setTextColor(color);
-    tft.setTextSize(size);
-    tft.setCursor(x, y);
-    tft.print(text.c_str());
+    canvas->setTextColor(color);
+    canvas->setTextSize(size);
+    canvas->setCursor(x, y - canvasOriginY);
+    canvas->print(text);
 #else
     (void)x;
     (void)y;
@@ -675,14 +863,14 @@ void DisplayManager::drawText(int16_t x, int16_t y, const std::string& text, uin
 #endif
 }
 
-void DisplayManager::drawRightAlignedText(int16_t x, int16_t y, const std::string& text,
+void DisplayManager::drawRightAlignedText(int16_t x, int16_t y, const char* text,
                                           uint16_t color, uint8_t size) {
 #ifndef UNIT_TEST
     tft.setTextColor(color);
     tft.setTextSize(size);
-    int16_t textWidth = text.length() * 6 * size;
+    int16_t textWidth = strlen(text) * 6 * size;
     tft.setCursor(x - textWidth, y);
-    tft.print(text.c_str());
+    tft.print(text);
 #else
     (void)x;
     (void)y;
@@ -692,15 +880,15 @@ void DisplayManager::drawRightAlignedText(int16_t x, int16_t y, const std::strin
 #endif
 }
 
-void DisplayManager::drawCenteredText(int16_t y, const std::string& text, uint16_t color,
+void DisplayManager::drawCenteredText(int16_t y, const char* text, uint16_t color,
                                       uint8_t size) {
 #ifndef UNIT_TEST
-    tft.setTextColor(color);
-    tft.setTextSize(size);
-    int16_t textWidth = text.length() * 6 * size;
+    canvas->setTextColor(color);
+    canvas->setTextSize(size);
+    int16_t textWidth = strlen(text) * 6 * size;
     int16_t x = (screenWidth - textWidth) / 2;
-    tft.setCursor(x, y);
-    tft.print(text.c_str());
+    canvas->setCursor(x, y - canvasOriginY);
+    canvas->print(text);
 #else
     (void)y;
     (void)text;
@@ -709,6 +897,129 @@ void DisplayManager::drawCenteredText(int16_t y, const std::string& text, uint16
 #endif
 }
 
+bool DisplayManager::beginPage() {
+    if (!pageDirty) {
+        return false;
+    }
+    pageDirty = false;
+    plotValid = false;
+    for (uint8_t i = 0; i < MAX_WIDGETS; i++) {
+        widgets[i].drawn = false;
+    }
+#ifndef UNIT_TEST
+    tft.fillScreen(COLOR_BLACK);
+#endif
+    return true;
+}
+
+bool DisplayManager::beginWidget(uint8_t slot, uint32_t state, int16_t x, int16_t y, int16_t w,
+                                 int16_t h, bool clearOld) {
+    if (slot >= MAX_WIDGETS) {
+        return true;  // Untracked: always draw
+    }
+    Widget& widget = widgets[slot];
+    if (widget.drawn && widget.state == state) {
+        return false;
+    }
+#ifndef UNIT_TEST
+    if (widget.drawn && clearOld) {
+        tft.fillRect(widget.x, widget.y, widget.w, widget.h, COLOR_BLACK);
+    }
+#endif
+    widget.state = state;
+    widget.x = x;
+    widget.y = y;
+    widget.w = w;
+    widget.h = h;
+    widget.drawn = true;
+    return true;
+}
+
+void DisplayManager::drawTextWidget(uint8_t slot, int16_t x, int16_t y, const char* text,
+                                    uint16_t color, uint8_t size, bool rightAligned) {
+    // Built-in font: 6x8 pixels per character at size 1
+    size_t length = strlen(text);
+    int16_t width = static_cast<int16_t>(length * 6 * size);
+    int16_t left = rightAligned ? x - width : x;
+    uint32_t state = crc32Update(text, length, color);
+    if (beginWidget(slot, state, left, y, width, 8 * size)) {
+        drawText(left, y, text, color, size);
+    }
+}
+
+#ifndef UNIT_TEST
+void DisplayManager::beginGraphCanvas(bool clear) {
+    if (!graphSprite.created()) {
+        return;  // Draw straight to the panel
+    }
+    if (clear) {
+        graphSprite.fillSprite(COLOR_BLACK);
+    }
+    canvas = &graphSprite;
+    canvasOriginY = GRAPH_PLOT_TOP;
+}
+
+bool DisplayManager::restoreGraphChrome(const char* unit) {
+    if (!chromeSprite.created()) {
+        return false;
+    }
+
+    // Render the chrome once per unit (graph pages of the same unit share it)
+    if (!chromeUnit || strcmp(chromeUnit, unit) != 0) {
+        TFT_eSPI* target = canvas;
+        int16_t originY = canvasOriginY;
+        chromeSprite.fillSprite(COLOR_BLACK);
+        canvas = &chromeSprite;
+        canvasOriginY = GRAPH_PLOT_TOP;
+        drawAxes(unit);
+        canvas = target;
+        canvasOriginY = originY;
+        chromeUnit = unit;
+    }
+
+    size_t bytes = size_t(graphSprite.width()) * graphSprite.height() * sizeof(uint16_t);
+    memcpy(graphSprite.getPointer(), chromeSprite.getPointer(), bytes);
+    return true;
+}
+
+void DisplayManager::pushGraphCanvas() {
+    if (canvas != &graphSprite) {
+        return;
+    }
+    canvas = &tft;
+    canvasOriginY = 0;
+
+    if (!dmaBands[0]) {
+        graphSprite.pushSprite(0, GRAPH_PLOT_TOP);
+        return;
+    }
+
+    // pushImageDMA() copies a band into its bounce buffer before waiting for the previous
+    // band, so alternating buffers overlaps the copy with the transfer
+    const int16_t width = graphSprite.width();
+    const int16_t height = graphSprite.height();
+    uint16_t* pixels = static_cast<uint16_t*>(graphSprite.getPointer());
+    tft.startWrite();
+    uint8_t band = 0;
+    for (int16_t row = 0; row < height; row += GRAPH_DMA_BAND_LINES) {
+        int16_t lines = height - row < GRAPH_DMA_BAND_LINES ? height - row : GRAPH_DMA_BAND_LINES;
+        tft.pushImageDMA(0, GRAPH_PLOT_TOP + row, width, lines, pixels + row * width,
+                         dmaBands[band]);
+        band ^= 1;
+    }
+    dmaPushPending = true;  // The last band finishes in the background
+}
+
+void DisplayManager::waitForGraphPush() {
+    if (!dmaPushPending) {
+        return;
+    }
+    tft.dmaWait();
+    tft.endWrite();
+    dmaPushPending = false;
+}
+#endif
+
 uint16_t DisplayManager::getHealthColor(SensorHealth health) {
     switch (health) {
         case SensorHealth::GREEN:
@@ -732,66 +1043,60 @@ uint16_t DisplayManager::getRSSIColor(int8_t rssi) {
     }
 }
 
-std::string DisplayManager::formatUptime(unsigned long uptimeMs) {
+const char* DisplayManager::formatUptime(unsigned long uptimeMs, char* out, size_t size) {
     unsigned long seconds = uptimeMs / 1000;
     unsigned long minutes = seconds / 60;
     unsigned long hours = minutes / 60;
     unsigned long days = hours / 24;
     if (days > 0) {
-        return std::to_string(days) + "d " + std::to_string(hours % 24) + "h";
+        snprintf(out, size, "%lud %luh", days, hours % 24);
     } else if (hours > 0) {
-        return std::to_string(hours) + "h " + std::to_string(minutes % 60) + "m";
+        snprintf(out, size, "%luh %lum", hours, minutes % 60);
     } else {
-        return std::to_string(minutes) + "m " + std::to_string(seconds % 60) + "s";
+        snprintf(out, size, "%lum %lus", minutes, seconds % 60);
     }
+    return out;
 }
 
-std::string DisplayManager::formatFloat(float value, uint8_t decimals) {
-    std::ostringstream oss;
-    oss << std::fixed << std::setprecision(decimals) << value;
-    return oss.str();
+const char* DisplayManager::formatFloat(float value, uint8_t decimals, char* out, size_t size) {
+    snprintf(out, size, "%.*f", decimals, value);
+    return out;
 }
 
-std::vector<DisplayPoint> DisplayManager::downsample(const std::vector<DisplayPoint>& data,
-                                                     uint16_t targetPoints) {
-    if (data.size() <= targetPoints) {
-        return data;
+uint16_t DisplayManager::downsample(const DisplayPoint* data, uint16_t count, DisplayPoint* out,
+                                    uint16_t targetPoints) {
+    if (count <= targetPoints) {
+        memcpy(out, data, count * sizeof(DisplayPoint));
+        return count;
     }
 
-    std::vector<DisplayPoint> result;
-    result.reserve(targetPoints);
-
-    // Always include first point
-    result.push_back(data[0]);
-
-    // Calculate step size
-    float step = static_cast<float>(data.size() - 1) / (targetPoints - 1);
-
-    // Sample intermediate points
-    for (uint16_t i = 1; i < targetPoints - 1; i++) {
-        size_t index = static_cast<size_t>(i * step);
-        if (index < data.size()) {
-            result.push_back(data[index]);
-        }
-    }
-
-    // Always include last point
-    result.push_back(data[data.size() - 1]);
-
-    return result;
+    // Same min/max envelope as DataManager's bounded history queries
+    return downsampleEnvelope(data, count, out, targetPoints);
 }
 
 void DisplayManager::scrollGraphLeft() {
 #ifndef UNIT_TEST
-    // This method would be used for smooth scrolling animation
-    // by shifting the graph area left by one pixel
-    // For now, we'll implement full redraw in renderGraphPage
-    // Future optimization: use sprite or partial screen updates
+    // Only the sprite can scroll; the panel is redrawn in full instead
+    if (canvas != &graphSprite) {
+        return;
+    }
+
+    // Shift everything between the axes one point step left; the freed columns clear to
+    // black and get their grid rows back
+    const int16_t step = graphStep();
+    const int16_t left = GRAPH_X_START + 1;
+    const int16_t right = screenWidth - GRAPH_RIGHT_MARGIN;
+    const int16_t top = GRAPH_Y_START - canvasOriginY;
+    const int16_t height = screenHeight - GRAPH_BOTTOM_MARGIN - GRAPH_Y_START;
+    graphSprite.setScrollRect(left, top, right - left + 1, height, COLOR_BLACK);
+    graphSprite.scroll(-step, 0);
+    drawGridRows(right - step + 1, step);
 #endif
 }
 
 void DisplayManager::setLowPowerMode(bool enabled) {
     lowPowerMode = enabled;
+    scheduler.setLowPower(enabled);  // Fewer frames as well as a dimmer backlight
 
     if (lowPowerMode) {
         // In low power mode, reduce backlight and update frequency
@@ -825,6 +1130,7 @@ void DisplayManager::disableDisplay() {
     setBacklightBrightness(0);
 
     // Clear screen to save power
+    waitForGraphPush();
     tft.fillScreen(COLOR_BLACK);
 
 // Put display in sleep mode if supported
@@ -836,6 +1142,7 @@ void DisplayManager::disableDisplay() {
 
 void DisplayManager::enableDisplay() {
     displayEnabled = true;
+    pageDirty = true;  // Screen was cleared by disableDisplay()
 
 #ifndef UNIT_TEST
 // Wake up display
@@ -859,10 +1166,10 @@ void DisplayManager::setTouchEnabled(bool enabled, TouchControllerType type) {
     if (touchEnabled) {
         // Initialize touch driver only if enabled
         initializeTouchDriver();
+    } else {
+        // No touch IRQ handler stays attached and nothing polls the controller
+        touchInput.end();
     }
-    // If disabled, touch driver resources are not allocated
-    // Touch polling task is not created
-    // Touch IRQ handlers are not attached
 }
 
 bool DisplayManager::initializeTouchDriver() {
@@ -872,45 +1179,9 @@ bool DisplayManager::initializeTouchDriver() {
     }
 
 #ifndef UNIT_TEST
-    // Initialize touch driver based on detected controller type
-    // This is a placeholder for actual touch driver initialization
-    // The actual implementation would depend on the specific touch library used
-
-    switch (touchType) {
-        case TouchControllerType::XPT2046:
-            // Initialize XPT2046 SPI touch driver
-            // Example: touchDriver = new XPT2046_Touchscreen(CS_PIN);
-            // touchDriver->begin();
-            break;
-
-        case TouchControllerType::FT6236:
-            // Initialize FT6236 I2C touch driver
-            // Example: touchDriver = new FT6236(I2C_ADDRESS);
-            // touchDriver->begin();
-            break;
-
-        case TouchControllerType::CST816:
-            // Initialize CST816 I2C touch driver
-            // Example: touchDriver = new CST816(I2C_ADDRESS);
-            // touchDriver->begin();
-            break;
-
-        case TouchControllerType::GT911:
-            // Initialize GT911 I2C touch driver
-            // Example: touchDriver = new GT911(I2C_ADDRESS);
-            // touchDriver->begin();
-            break;
-
-        case TouchControllerType::NONE:
-        default:
-            return false;
-    }
-
-    // Note: Touch polling task creation would happen here if needed
-    // Note: Touch IRQ handler attachment would happen here if needed
-    // These are skipped when touchEnabled is false
-
-    return true;
+    // Page navigation only needs touch/no-touch timing, which the IRQ line carries on
+    // every supported controller; coordinates (and a bus driver) are not needed for it
+    return touchInput.begin(touchType, TOUCH_IRQ_PIN);
 #else
     return true;  // Mock success in unit tests
 #endif
@@ -922,7 +1193,7 @@ void DisplayManager::showConfigError(ConfigLoadResult errorType) {
     }
 
 #ifndef UNIT_TEST
-    std::string message;
+    const char* message = "";
     switch (errorType) {
         case ConfigLoadResult::FILE_NOT_FOUND:
             message = "Config: file missing";
@@ -957,36 +1228,39 @@ void DisplayManager::showConfigError(ConfigLoadResult errorType) {
 #endif
 }
 
-void DisplayManager::showConfigValidationError(const std::string& missingFields) {
+void DisplayManager::showConfigValidationError(const char* missingFields) {
     if (!initialized) {
         return;
     }
 
 #ifndef UNIT_TEST
-    std::string message = "Config: missing required";
-
     // Display one-line message at bottom of screen in yellow
-    drawText(5, screenHeight - 16, message, COLOR_YELLOW, 1);
+    drawText(5, screenHeight - 16, "Config: missing required", COLOR_YELLOW, 1);
 
     // Optionally display the missing fields on the next line if there's space
-    if (!missingFields.empty() && screenHeight > 32) {
-        std::string fieldsMsg = "Fields: " + missingFields;
+    if (missingFields[0] != '\0' && screenHeight > 32) {
+        TextBuffer<41> fieldsMsg;
         // Truncate if too long
-        if (fieldsMsg.length() > 40) {
-            fieldsMsg = fieldsMsg.substr(0, 37) + "...";
+        if (!fieldsMsg.appendf("Fields: %s", missingFields)) {
+            fieldsMsg.truncate(fieldsMsg.capacity() - 3);
+            fieldsMsg.append("...");
         }
-        drawText(5, screenHeight - 4, fieldsMsg, COLOR_YELLOW, 1);
+        drawText(5, screenHeight - 4, fieldsMsg.c_str(), COLOR_YELLOW, 1);
     }
 #else
     (void)missingFields;
 #endif
 }
 
-void DisplayManager::showProvisioningMode(const std::string& instructions) {
+void DisplayManager::showProvisioningMode(const char* instructions) {
+#ifndef UNIT_TEST
+    waitForGraphPush();
+#endif
     if (!initialized) {
         return;
     }
 
+    pageDirty = true;
 #ifndef UNIT_TEST
     // Clear screen
     tft.fillScreen(COLOR_BLACK);
@@ -1017,29 +1291,31 @@ void DisplayManager::showProvisioningMode(const std::string& instructions) {
     yPos += 25;
 
     // Draw additional instructions if provided
-    if (!instructions.empty()) {
+    if (instructions[0] != '\0') {
         // Word wrap the instructions
-        std::string remaining = instructions;
-        while (!remaining.empty() && yPos < screenHeight - 30) {
-            size_t maxLen = 35;  // Approximate characters per line
-            std::string line;
-
-            if (remaining.length() <= maxLen) {
-                line = remaining;
-                remaining = "";
-            } else {
-                // Find last space before maxLen
-                size_t spacePos = remaining.rfind(' ', maxLen);
-                if (spacePos != std::string::npos && spacePos > 0) {
-                    line = remaining.substr(0, spacePos);
-                    remaining = remaining.substr(spacePos + 1);
+        const size_t maxLen = 35;  // Approximate characters per line
+        const char* remaining = instructions;
+        while (*remaining != '\0' && yPos < screenHeight - 30) {
+            size_t length = strnlen(remaining, maxLen + 1);
+            size_t next = length;
+            if (length > maxLen) {
+                // Break at the last space before maxLen
+                length = maxLen;
+                while (length > 0 && remaining[length] != ' ') {
+                    length--;
+                }
+                if (length > 0) {
+                    next = length + 1;  // Drop the space
                 } else {
-                    line = remaining.substr(0, maxLen);
-                    remaining = remaining.substr(maxLen);
+                    length = maxLen;
+                    next = maxLen;
                 }
             }
 
-            drawText(10, yPos, line, COLOR_LIGHT_GRAY, 1);
+            TextBuffer<maxLen + 1> line;
+            line.append(remaining, length);
+            drawText(10, yPos, line.c_str(), COLOR_LIGHT_GRAY, 1);
+            remaining += next;
             yPos += 12;
         }
     }
@@ -1054,3 +1330,78 @@ void DisplayManager::showProvisioningMode(const std::string& instructions) {
     (void)instructions;
 #endif
 }
+
+void DisplayManager::showGlance(const DataManager& history, uint8_t batteryPercent) {
+    if (!initialized) {
+        return;
+    }
+    pageDirty = true;
+#ifndef UNIT_TEST
+    char text[TEXT_BUFFER_SIZE];
+    char value[16];
+    char low[16];
+    char high[16];
+
+    tft.fillScreen(COLOR_BLACK);
+    drawText(5, 5, "Sensor Glance", COLOR_CYAN, 2);
+
+    int16_t yPos = 35;
+    for (const SensorDescriptor& sensor : SENSOR_DESCRIPTORS) {
+        DisplaySeries series = history.getDisplaySeries(sensor.type);
+        float minVal = 0.0f;
+        float maxVal = 0.0f;
+        drawText(10, yPos, sensor.shortName, COLOR_WHITE, 1);
+        if (series.count == 0) {
+            drawText(screenWidth / 2 - 40, yPos, "--", COLOR_GRAY, 2);
+        } else {
+            formatFloat(series.valueAt(series.count - 1), 1, value, sizeof(value));
+            snprintf(text, sizeof(text), "%s %s", value, sensor.unit);
+            drawText(screenWidth / 2 - 40, yPos, text, COLOR_WHITE, 2);
+        }
+        if (history.getDisplayRange(sensor.type, graphSpanMs, minVal, maxVal)) {
+            formatFloat(minVal, 1, low, sizeof(low));
+            formatFloat(maxVal, 1, high, sizeof(high));
+            snprintf(text, sizeof(text), "%s..%s", low, high);
+            drawText(screenWidth / 2 - 40, yPos + 17, text, COLOR_GRAY, 1);
+        }
+        yPos += 30;
+    }
+
+    // Age of the newest restored point on the display clock (it kept running in sleep)
+    DisplaySeries newest = history.getDisplaySeries(SensorType::BME280_TEMP);
+    if (newest.count > 0) {
+        uint32_t ageMs = history.displayClockMs(millis()) - newest.timestampAt(newest.count - 1);
+        snprintf(text, sizeof(text), "Updated %s ago   Backlog %u   Battery %u%%",
+                 formatUptime(ageMs, value, sizeof(value)), history.getBufferedDataCount(),
+                 batteryPercent);
+    } else {
+        snprintf(text, sizeof(text), "No history yet   Battery %u%%", batteryPercent);
+    }
+    drawText(5, screenHeight - 20, text, COLOR_GRAY, 1);
+#else
+    (void)history;
+    (void)batteryPercent;
+#endif
+    lastActivity = millis();
+}
+
+void DisplayManager::powerDown() {
+    if (!initialized) {
+        return;
+    }
+#ifndef UNIT_TEST
+    waitForGraphPush();
+    setBacklightBrightness(0);
+#ifdef TFT_BL
+    digitalWrite(TFT_BL, LOW);
+#endif
+    // The controller keeps its frame memory in sleep mode at a few microamps
+#ifdef TFT_DISPOFF
+    tft.writecommand(TFT_DISPOFF);
+#endif
+#ifdef TFT_SLPIN
+    tft.writecommand(TFT_SLPIN);
+#endif
+#endif
+    displayEnabled = false;
+}
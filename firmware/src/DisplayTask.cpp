@@ -0,0 +1,126 @@
+#ifndef UNIT_TEST
+#include "DisplayTask.h"
+
+#include "PowerLock.h"
+#include "TaskMonitor.h"
+
+DisplayTask::DisplayTask(DisplayManager& displayManager, DataManager& dataManager)
+    : display(displayManager),
+      history(dataManager),
+      frameConfig(nullptr),
+      latest(),
+      taskHandle(nullptr),
+      frameLock(nullptr) {}
+
+DisplayTask::~DisplayTask() {
+    stop();
+}
+
+bool DisplayTask::start(const Config* config) {
+    if (taskHandle) {
+        return true;
+    }
+
+    frameConfig = config;
+
+    mailbox.clear();
+    frameLock = xSemaphoreCreateMutex();
+    if (!frameLock) {
+        Serial.println("[ERROR] DisplayTask: Failed to create lock");
+        stop();
+        return false;
+    }
+
+    BaseType_t result = xTaskCreatePinnedToCore(&DisplayTask::taskEntry, "display", STACK_SIZE,
+                                                this, TASK_PRIORITY, &taskHandle, TASK_CORE);
+    if (result != pdPASS) {
+        Serial.println("[ERROR] DisplayTask: Failed to create task");
+        taskHandle = nullptr;
+        stop();
+        return false;
+    }
+    TaskMonitor::add("display", taskHandle, STACK_SIZE);
+
+    Serial.printf("[INFO] DisplayTask: Started (core %d, priority %u)\n", TASK_CORE,
+                  TASK_PRIORITY);
+    return true;
+}
+
+void DisplayTask::stop() {
+    if (taskHandle) {
+        // The task only touches the panel while holding the lock, so with the lock
+        // held here it is parked between frames and safe to delete
+        xSemaphoreTake(frameLock, portMAX_DELAY);
+        TaskMonitor::remove(taskHandle);
+        vTaskDelete(taskHandle);
+        taskHandle = nullptr;
+        xSemaphoreGive(frameLock);
+    }
+    if (frameLock) {
+        vSemaphoreDelete(frameLock);
+        frameLock = nullptr;
+    }
+}
+
+void DisplayTask::publish(const Message& message) {
+    if (!taskHandle) {
+        return;
+    }
+    mailbox.push(message);
+    xTaskNotifyGive(taskHandle);
+}
+
+void DisplayTask::lock() {
+    if (taskHandle) {
+        xSemaphoreTake(frameLock, portMAX_DELAY);
+    }
+}
+
+void DisplayTask::unlock() {
+    if (taskHandle) {
+        xSemaphoreGive(frameLock);
+    }
+}
+
+bool DisplayTask::isRunning() const {
+    return taskHandle != nullptr;
+}
+
+void DisplayTask::taskEntry(void* arg) {
+    static_cast<DisplayTask*>(arg)->run();
+}
+
+void DisplayTask::run() {
+    bool haveState = false;
+
+    for (;;) {
+        // Wake on new state, or after POLL_MS for touch and the clock; only the
+        // newest queued message is rendered
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(POLL_MS));
+        while (mailbox.pop(latest)) {
+            haveState = true;
+        }
+        if (!haveState) {
+            continue;  // Nothing to show before the first message
+        }
+
+        xSemaphoreTake(frameLock, portMAX_DELAY);
+        PowerLock::acquire();  // SPI frame and touch bus reads
+        applyPower(latest);
+        display.update(latest.current, latest.status, &history, frameConfig);
+        PowerLock::release();
+        xSemaphoreGive(frameLock);
+    }
+}
+
+void DisplayTask::applyPower(const Message& message) {
+    if (message.lowPower && !display.isLowPowerMode()) {
+        display.setLowPowerMode(true);
+        Serial.println("Display low power mode enabled");
+    }
+    if (message.blank && display.isDisplayEnabled()) {
+        display.disableDisplay();
+    }
+}
+
+#endif  // UNIT_TEST
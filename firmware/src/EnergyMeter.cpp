@@ -0,0 +1,103 @@
+#include "EnergyMeter.h"
+
+namespace {
+
+const float DEFAULT_COEFFICIENTS_MA[NUM_ENERGY_STATES] = {
+    ENERGY_MA_CPU_MAX, ENERGY_MA_CPU_MIN, ENERGY_MA_LIGHT_SLEEP, ENERGY_MA_WIFI_TX,
+    ENERGY_MA_WIFI_RX, ENERGY_MA_WIFI_IDLE, ENERGY_MA_BACKLIGHT, ENERGY_MA_SENSORS};
+
+const char* const STATE_KEYS[NUM_ENERGY_STATES] = {"cpu_max", "cpu_min", "light_sleep",
+                                                   "wifi_tx", "wifi_rx", "wifi_idle",
+                                                   "backlight", "sensors"};
+
+const char* const SUBSYSTEM_KEYS[NUM_ENERGY_SUBSYSTEMS] = {"cpu", "wifi", "display", "sensors"};
+
+const float MS_PER_HOUR = 3600000.0f;
+
+}  // namespace
+
+EnergyMeter::EnergyMeter() : stateMs(), coefficientMa() {
+    for (uint8_t i = 0; i < NUM_ENERGY_STATES; i++) {
+        coefficientMa[i] = DEFAULT_COEFFICIENTS_MA[i];
+    }
+}
+
+void EnergyMeter::add(EnergyState state, uint32_t ms) {
+    if (state >= NUM_ENERGY_STATES) {
+        return;
+    }
+    stateMs[state] += ms;
+}
+
+void EnergyMeter::setCoefficient(EnergyState state, float milliamps) {
+    if (state >= NUM_ENERGY_STATES || milliamps < 0.0f) {
+        return;
+    }
+    coefficientMa[state] = milliamps;
+}
+
+float EnergyMeter::getCoefficient(EnergyState state) const {
+    return state < NUM_ENERGY_STATES ? coefficientMa[state] : 0.0f;
+}
+
+uint32_t EnergyMeter::getStateMs(EnergyState state) const {
+    return state < NUM_ENERGY_STATES ? static_cast<uint32_t>(stateMs[state]) : 0;
+}
+
+float EnergyMeter::getMah(EnergySubsystem subsystem) const {
+    float mah = 0.0f;
+    for (uint8_t i = 0; i < NUM_ENERGY_STATES; i++) {
+        EnergyState state = static_cast<EnergyState>(i);
+        if (subsystemOf(state) == subsystem) {
+            mah += coefficientMa[i] * static_cast<float>(stateMs[i]) / MS_PER_HOUR;
+        }
+    }
+    return mah;
+}
+
+float EnergyMeter::getTotalMah() const {
+    float mah = 0.0f;
+    for (uint8_t i = 0; i < NUM_ENERGY_SUBSYSTEMS; i++) {
+        mah += getMah(static_cast<EnergySubsystem>(i));
+    }
+    return mah;
+}
+
+EnergyReport EnergyMeter::getReport() const {
+    EnergyReport report = {};
+    for (uint8_t i = 0; i < NUM_ENERGY_SUBSYSTEMS; i++) {
+        report.subsystemMah[i] = getMah(static_cast<EnergySubsystem>(i));
+    }
+    report.windowMs = static_cast<uint32_t>(stateMs[ENERGY_CPU_MAX] + stateMs[ENERGY_CPU_MIN] +
+                                            stateMs[ENERGY_LIGHT_SLEEP]);
+    return report;
+}
+
+void EnergyMeter::reset() {
+    for (uint8_t i = 0; i < NUM_ENERGY_STATES; i++) {
+        stateMs[i] = 0;
+    }
+}
+
+EnergySubsystem EnergyMeter::subsystemOf(EnergyState state) {
+    switch (state) {
+        case ENERGY_WIFI_TX:
+        case ENERGY_WIFI_RX:
+        case ENERGY_WIFI_IDLE:
+            return ENERGY_SUBSYSTEM_WIFI;
+        case ENERGY_BACKLIGHT:
+            return ENERGY_SUBSYSTEM_DISPLAY;
+        case ENERGY_SENSORS:
+            return ENERGY_SUBSYSTEM_SENSORS;
+        default:
+            return ENERGY_SUBSYSTEM_CPU;
+    }
+}
+
+const char* EnergyMeter::stateKey(EnergyState state) {
+    return state < NUM_ENERGY_STATES ? STATE_KEYS[state] : "unknown";
+}
+
+const char* EnergyMeter::subsystemKey(EnergySubsystem subsystem) {
+    return subsystem < NUM_ENERGY_SUBSYSTEMS ? SUBSYSTEM_KEYS[subsystem] : "unknown";
+}
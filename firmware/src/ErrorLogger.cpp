@@ -1,50 +1,353 @@
 #include "ErrorLogger.h"
 
-void ErrorLogger::log(ErrorLevel level, ErrorType type, const char* message, const char* context) {
-    // Print timestamp
-    printTimestamp();
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <esp_attr.h>
+#include <esp_system.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include "TaskMonitor.h"
+
+static_assert(int(RESET_TASK_WDT) == int(ESP_RST_TASK_WDT) &&
+                  int(RESET_BROWNOUT) == int(ESP_RST_BROWNOUT),
+              "ResetReason must follow esp_reset_reason_t");
+#else
+#define RTC_NOINIT_ATTR  // Plain static storage on the host
+#endif
+
+ErrorLevel ErrorLogger::minLevel = ErrorLevel::INFO;
+char ErrorLogger::ring[LOG_RING_SIZE];
+size_t ErrorLogger::ringHead = 0;
+size_t ErrorLogger::ringCount = 0;
+uint32_t ErrorLogger::droppedCount = 0;
+
+namespace {
+
+constexpr uint32_t POSTMORTEM_MAGIC = 0x314D5450;  // "PTM1"
+
+// RTC_NOINIT survives panic and watchdog resets as well as deep sleep (RTC_DATA_ATTR is
+// reloaded on every reset except a deep-sleep wake); it is garbage after power-on
+struct PostMortemImage {
+    uint32_t magic;
+    uint8_t head;         // Next live slot
+    uint8_t count;        // Live records
+    uint8_t boot;         // Boot sequence (low byte)
+    uint8_t keptCount;    // Records kept from before the last abnormal reset (0 = none)
+    uint8_t keptReason;   // ResetReason that ended them
+    PostMortemEntry live[POSTMORTEM_ENTRIES];
+    PostMortemEntry kept[POSTMORTEM_ENTRIES];  // Oldest first
+};
+
+RTC_NOINIT_ATTR PostMortemImage postMortem;
+bool postMortemReady = false;  // Image checked this boot; records go to the live ring
+bool postMortemNew = false;    // Kept at this boot, not yet printed
+
+const char* const RESET_REASON_KEYS[NUM_RESET_REASONS] = {
+    "unknown",  "poweron",   "ext",      "sw",       "panic", "int_wdt",
+    "task_wdt", "other_wdt", "deepsleep", "brownout", "sdio"};
+
+bool isAbnormalReset(ResetReason reason) {
+    switch (reason) {
+        case RESET_PANIC:
+        case RESET_INT_WDT:
+        case RESET_TASK_WDT:
+        case RESET_WDT:
+        case RESET_BROWNOUT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Copy the message start, with quotes, backslashes and control bytes replaced
+void copyPostMortemText(char* out, const char* text, size_t length) {
+    size_t i = 0;
+    for (; i < length && i < POSTMORTEM_TEXT_LENGTH - 1; i++) {
+        char ch = text[i];
+        if (ch == '"') {
+            ch = '\'';
+        } else if (ch == '\\') {
+            ch = '/';
+        } else if (ch < 0x20 || ch > 0x7E) {
+            ch = ' ';
+        }
+        out[i] = ch;
+    }
+    memset(out + i, 0, POSTMORTEM_TEXT_LENGTH - i);
+}
+
+#ifdef ARDUINO
+portMUX_TYPE ringMux = portMUX_INITIALIZER_UNLOCKED;  // Ring indices
+SemaphoreHandle_t drainLock = nullptr;                // One writer to the UART at a time
+TaskHandle_t drainTask = nullptr;
+
+// Move ring text to the UART; the UART write is the only part that waits
+void drainToSerial() {
+    char chunk[64];
+    size_t length;
+    while ((length = ErrorLogger::read(chunk, sizeof(chunk))) > 0) {
+        Serial.write(reinterpret_cast<const uint8_t*>(chunk), length);
+    }
+}
 
-    // Print severity level
-    Serial.print("[");
-    Serial.print(levelToString(level));
-    Serial.print("] ");
+void drainTaskEntry(void*) {
+    for (;;) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        xSemaphoreTake(drainLock, portMAX_DELAY);
+        drainToSerial();
+        xSemaphoreGive(drainLock);
+    }
+}
+#endif
 
-    // Print error type
-    Serial.print("[");
-    Serial.print(typeToString(type));
-    Serial.print("] ");
+}  // namespace
 
-    // Print message
-    Serial.print(message);
+bool ErrorLogger::begin() {
+#ifdef ARDUINO
+    if (drainTask) {
+        return true;
+    }
+    drainLock = xSemaphoreCreateMutex();
+    if (!drainLock) {
+        return false;
+    }
+    if (xTaskCreatePinnedToCore(drainTaskEntry, "log", LOG_TASK_STACK, nullptr, LOG_TASK_PRIORITY,
+                                &drainTask, LOG_TASK_CORE) != pdPASS) {
+        drainTask = nullptr;
+        return false;
+    }
+    TaskMonitor::add("log", drainTask, LOG_TASK_STACK);
+    xTaskNotifyGive(drainTask);  // Anything logged before begin()
+    return true;
+#else
+    return false;
+#endif
+}
 
-    // Print context if provided
+void ErrorLogger::log(ErrorLevel level, ErrorType type, const char* message, const char* context) {
+    if (level < minLevel) {
+        return;
+    }
+
+    char record[LOG_LINE_MAX];
+    size_t length = formatPrefix(record, sizeof(record), level, type);
+    int written;
     if (context != nullptr && context[0] != '\0') {
-        Serial.print(" (");
-        Serial.print(context);
-        Serial.print(")");
+        written = snprintf(record + length, sizeof(record) - length, "%s (%s)", message, context);
+    } else {
+        written = snprintf(record + length, sizeof(record) - length, "%s", message);
+    }
+    size_t prefixLength = length;
+    length += written > 0 ? written : 0;
+    commit(record, prefixLength, length, level, type);
+}
+
+void ErrorLogger::logf(ErrorLevel level, ErrorType type, const char* format, ...) {
+    if (level < minLevel) {
+        return;
+    }
+
+    char record[LOG_LINE_MAX];
+    size_t length = formatPrefix(record, sizeof(record), level, type);
+    va_list args;
+    va_start(args, format);
+    int written = vsnprintf(record + length, sizeof(record) - length, format, args);
+    va_end(args);
+    size_t prefixLength = length;
+    length += written > 0 ? written : 0;
+    commit(record, prefixLength, length, level, type);
+}
+
+size_t ErrorLogger::formatPrefix(char* out, size_t capacity, ErrorLevel level, ErrorType type) {
+    // Format: [HH:MM:SS.mmm] [LEVEL] [TYPE]
+    unsigned long ms = millis();
+    unsigned long seconds = ms / 1000;
+    unsigned long minutes = seconds / 60;
+    unsigned long hours = minutes / 60;
+    int written = snprintf(out, capacity, "[%02lu:%02lu:%02lu.%03lu] [%s] [%s] ", hours,
+                           minutes % 60, seconds % 60, ms % 1000, levelToString(level),
+                           typeToString(type));
+    return written > 0 ? written : 0;
+}
+
+void ErrorLogger::commit(char* record, size_t prefixLength, size_t length, ErrorLevel level,
+                         ErrorType type) {
+    // Cut text that did not fit, keeping room for the line end
+    if (length > LOG_LINE_MAX - 3) {
+        length = LOG_LINE_MAX - 3;
+    }
+    if (prefixLength > length) {
+        prefixLength = length;
+    }
+
+    PostMortemEntry entry;
+    if (postMortemReady) {
+        entry.timeMs = millis();
+        entry.level = static_cast<uint8_t>(level);
+        entry.type = static_cast<uint8_t>(type);
+        entry.boot = postMortem.boot;
+        copyPostMortemText(entry.text, record + prefixLength, length - prefixLength);
+    }
+    record[length++] = '\r';
+    record[length++] = '\n';
+
+    bool queued = false;
+#ifdef ARDUINO
+    portENTER_CRITICAL(&ringMux);
+#endif
+    if (ringCount + length <= LOG_RING_SIZE) {
+        size_t tail = (ringHead + ringCount) % LOG_RING_SIZE;
+        size_t first = length < LOG_RING_SIZE - tail ? length : LOG_RING_SIZE - tail;
+        memcpy(ring + tail, record, first);
+        memcpy(ring, record + first, length - first);
+        ringCount += length;
+        queued = true;
+    } else {
+        droppedCount++;
+    }
+    if (postMortemReady) {
+        postMortem.live[postMortem.head] = entry;
+        postMortem.head = (postMortem.head + 1) % POSTMORTEM_ENTRIES;
+        if (postMortem.count < POSTMORTEM_ENTRIES) {
+            postMortem.count++;
+        }
+    }
+#ifdef ARDUINO
+    portEXIT_CRITICAL(&ringMux);
+
+    if (drainTask) {
+        if (queued) {
+            xTaskNotifyGive(drainTask);
+        }
+    } else {
+        drainToSerial();  // Early boot: no task yet, write as before
+    }
+#else
+    (void)queued;
+#endif
+}
+
+size_t ErrorLogger::read(char* out, size_t capacity) {
+#ifdef ARDUINO
+    portENTER_CRITICAL(&ringMux);
+#endif
+    size_t length = ringCount < capacity ? ringCount : capacity;
+    size_t first = length < LOG_RING_SIZE - ringHead ? length : LOG_RING_SIZE - ringHead;
+    memcpy(out, ring + ringHead, first);
+    memcpy(out + first, ring, length - first);
+    ringHead = (ringHead + length) % LOG_RING_SIZE;
+    ringCount -= length;
+#ifdef ARDUINO
+    portEXIT_CRITICAL(&ringMux);
+#endif
+    return length;
+}
+
+void ErrorLogger::flush() {
+#ifdef ARDUINO
+    if (drainLock) {
+        xSemaphoreTake(drainLock, portMAX_DELAY);
+    }
+    drainToSerial();
+    Serial.flush();
+    if (drainLock) {
+        xSemaphoreGive(drainLock);
+    }
+#endif
+}
+
+void ErrorLogger::clear() {
+    ringHead = 0;
+    ringCount = 0;
+    droppedCount = 0;
+    minLevel = ErrorLevel::INFO;
+}
+
+bool ErrorLogger::beginPostMortem(ResetReason reason) {
+    bool valid = postMortem.magic == POSTMORTEM_MAGIC && postMortem.head < POSTMORTEM_ENTRIES &&
+                 postMortem.count <= POSTMORTEM_ENTRIES &&
+                 postMortem.keptCount <= POSTMORTEM_ENTRIES &&
+                 postMortem.keptReason < NUM_RESET_REASONS;
+    if (!valid || reason == RESET_POWERON) {
+        memset(&postMortem, 0, sizeof(postMortem));
+        postMortem.magic = POSTMORTEM_MAGIC;
+    }
+
+    postMortemNew = valid && isAbnormalReset(reason) && postMortem.count > 0;
+    if (postMortemNew) {
+        // Oldest first, each tagged with how many boots before the reset it was logged
+        uint8_t start = (postMortem.head + POSTMORTEM_ENTRIES - postMortem.count) %
+                        POSTMORTEM_ENTRIES;
+        for (uint8_t i = 0; i < postMortem.count; i++) {
+            PostMortemEntry& entry = postMortem.kept[i];
+            entry = postMortem.live[(start + i) % POSTMORTEM_ENTRIES];
+            entry.boot = postMortem.boot - entry.boot;
+            entry.text[POSTMORTEM_TEXT_LENGTH - 1] = '\0';
+        }
+        postMortem.keptCount = postMortem.count;
+        postMortem.keptReason = reason;
+        postMortem.head = 0;
+        postMortem.count = 0;
     }
 
-    Serial.println();
+    postMortem.boot++;
+    postMortemReady = true;
+    return postMortemNew;
+}
+
+void ErrorLogger::dumpPostMortem() {
+    if (!postMortemNew) {
+        return;
+    }
+    postMortemNew = false;
+#ifdef ARDUINO
+    flush();  // Keep the dump in one piece
+    Serial.printf("[WARN] Post-mortem log before the %s reset (%u records):\n",
+                  resetReasonKey(getPostMortemReason()), postMortem.keptCount);
+    for (uint8_t i = 0; i < postMortem.keptCount; i++) {
+        const PostMortemEntry& entry = postMortem.kept[i];
+        Serial.printf("  boot -%u %lu ms [%s] [%s] %s\n", entry.boot,
+                      static_cast<unsigned long>(entry.timeMs),
+                      levelToString(static_cast<ErrorLevel>(entry.level)),
+                      typeToString(static_cast<ErrorType>(entry.type)), entry.text);
+    }
+#endif
 }
 
-void ErrorLogger::info(ErrorType type, const char* message, const char* context) {
-    log(ErrorLevel::INFO, type, message, context);
+bool ErrorLogger::hasPostMortem() {
+    return postMortemReady && postMortem.keptCount > 0;
 }
 
-void ErrorLogger::warning(ErrorType type, const char* message, const char* context) {
-    log(ErrorLevel::WARNING, type, message, context);
+ResetReason ErrorLogger::getPostMortemReason() {
+    return static_cast<ResetReason>(postMortem.keptReason);
 }
 
-void ErrorLogger::error(ErrorType type, const char* message, const char* context) {
-    log(ErrorLevel::ERROR, type, message, context);
+uint8_t ErrorLogger::getPostMortemCount() {
+    return postMortemReady ? postMortem.keptCount : 0;
 }
 
-void ErrorLogger::critical(ErrorType type, const char* message, const char* context) {
-    log(ErrorLevel::CRITICAL, type, message, context);
+const PostMortemEntry& ErrorLogger::getPostMortemEntry(uint8_t index) {
+    return postMortem.kept[index < POSTMORTEM_ENTRIES ? index : 0];
+}
+
+void ErrorLogger::clearPostMortem() {
+    postMortem.keptCount = 0;
+    postMortemNew = false;
+}
+
+const char* ErrorLogger::resetReasonKey(ResetReason reason) {
+    return reason < NUM_RESET_REASONS ? RESET_REASON_KEYS[reason] : "unknown";
 }
 
 const char* ErrorLogger::levelToString(ErrorLevel level) {
     switch (level) {
+        case ErrorLevel::DEBUG:
+            return "DEBUG";
         case ErrorLevel::INFO:
             return "INFO";
         case ErrorLevel::WARNING:
@@ -78,37 +381,3 @@ const char* ErrorLogger::typeToString(ErrorType type) {
             return "UNKNOWN";
     }
 }
-
-void ErrorLogger::printTimestamp() {
-    unsigned long ms = millis();
-    unsigned long seconds = ms / 1000;
-    unsigned long minutes = seconds / 60;
-    unsigned long hours = minutes / 60;
-
-    // Format: [HH:MM:SS.mmm]
-    Serial.print("[");
-
-    if (hours < 10)
-        Serial.print("0");
-    Serial.print(hours);
-    Serial.print(":");
-
-    if ((minutes % 60) < 10)
-        Serial.print("0");
-    Serial.print(minutes % 60);
-    Serial.print(":");
-
-    if ((seconds % 60) < 10)
-        Serial.print("0");
-    Serial.print(seconds % 60);
-    Serial.print(".");
-
-    unsigned long milliseconds = ms % 1000;
-    if (milliseconds < 100)
-        Serial.print("0");
-    if (milliseconds < 10)
-        Serial.print("0");
-    Serial.print(milliseconds);
-
-    Serial.print("] ");
-}
@@ -0,0 +1,142 @@
+#include "EventDetector.h"
+
+#include <math.h>
+
+#include "models/SensorDescriptor.h"
+
+#ifdef ARDUINO
+#include <esp_attr.h>
+#else
+#define RTC_DATA_ATTR  // Plain static storage on the host
+#endif
+
+namespace {
+
+constexpr uint32_t ZONE_MAGIC = 0x31545645;  // "EVT1"
+
+// Zone of the last reading before deep sleep; zeroed at power-on
+struct SleepZone {
+    uint32_t magic;
+    int8_t zone;
+};
+
+RTC_DATA_ATTR SleepZone sleepZone;
+
+}  // namespace
+
+EventDetector::EventDetector()
+    : lowPercent(30.0f),
+      highPercent(70.0f),
+      zone(0),
+      zoneKnown(false),
+      lastValue(0.0f),
+      lastTimeMs(0),
+      lastValid(false),
+      fastArmed(true),
+      lastFastMs(0) {}
+
+void EventDetector::configure(float low, float high) {
+    lowPercent = low;
+    highPercent = high;
+}
+
+void EventDetector::reset() {
+    zone = 0;
+    zoneKnown = false;
+    lastValid = false;
+    fastArmed = true;
+    lastFastMs = 0;
+}
+
+void EventDetector::saveForSleep() const {
+    if (zoneKnown) {
+        sleepZone.zone = zone;
+        sleepZone.magic = ZONE_MAGIC;
+    }
+}
+
+bool EventDetector::restoreAfterSleep() {
+    if (sleepZone.magic != ZONE_MAGIC) {
+        return false;
+    }
+    sleepZone.magic = 0;
+    zone = sleepZone.zone;
+    zoneKnown = true;
+    return true;
+}
+
+uint8_t EventDetector::addReading(const SensorReadings& readings) {
+    uint8_t fresh = readings.sensorStatus & ~readings.staleMask;
+    if (!(fresh & (1 << SENSOR_SOIL_BIT))) {
+        return SOIL_EVENT_NONE;
+    }
+    float value = readings.soilMoisture;
+    uint32_t timeMs = readings.monotonicMs;
+    uint8_t events = SOIL_EVENT_NONE;
+
+    // Zones: entered on the threshold, left only past it by the hysteresis
+    int8_t next = zone;
+    if (value < lowPercent) {
+        next = -1;
+    } else if (value > highPercent) {
+        next = 1;
+    } else if (zone < 0 && value >= lowPercent + EVENT_SOIL_HYSTERESIS) {
+        next = 0;
+    } else if (zone > 0 && value <= highPercent - EVENT_SOIL_HYSTERESIS) {
+        next = 0;
+    }
+    if (!zoneKnown) {
+        zoneKnown = true;  // The first reading sets the zone without an event
+    } else if (next != zone) {
+        events |= next < 0 ? SOIL_EVENT_LOW : next > 0 ? SOIL_EVENT_HIGH : SOIL_EVENT_NORMAL;
+    }
+    zone = next;
+
+    // Rate of change against the previous fresh value
+    if (lastValid && timeMs != lastTimeMs) {
+        float minutes = (timeMs - lastTimeMs) / 60000.0f;
+        float perMin = fabsf(value - lastValue) / minutes;
+        if (perMin < EVENT_SOIL_FAST_PER_MIN / 2.0f) {
+            fastArmed = true;
+        } else if (perMin >= EVENT_SOIL_FAST_PER_MIN && fastArmed &&
+                   (lastFastMs == 0 || timeMs - lastFastMs >= EVENT_MIN_INTERVAL_MS)) {
+            events |= SOIL_EVENT_FAST;
+            fastArmed = false;
+            lastFastMs = timeMs;
+        }
+    }
+    lastValue = value;
+    lastTimeMs = timeMs;
+    lastValid = true;
+    return events;
+}
+
+void EventDetector::toWindow(const SensorReadings& readings, AveragedData& window) {
+    window = {};
+    for (const SensorDescriptor& sensor : SENSOR_DESCRIPTORS) {
+        float value = readings.*sensor.reading;
+        window.*sensor.average = value;
+        SensorSpread& spread = window.*sensor.spread;
+        spread.min = value;
+        spread.max = value;
+        spread.stddev = 0.0f;
+    }
+    uint8_t probeCount = readings.ds18b20ProbeCount;
+    if (probeCount > MAX_DS18B20_PROBES) {
+        probeCount = MAX_DS18B20_PROBES;
+    }
+    window.ds18b20ProbeCount = probeCount;
+    for (uint8_t p = 0; p < probeCount; p++) {
+        window.avgDs18b20Probes[p] = readings.ds18b20Probes[p];
+    }
+
+    uint8_t fresh = readings.sensorStatus & ~readings.staleMask;
+    window.sampleCount = 1;
+    window.bme280SampleCount = (fresh >> SENSOR_BME280_BIT) & 1;
+    window.ds18b20SampleCount = (fresh >> SENSOR_DS18B20_BIT) & 1;
+    window.soilSampleCount = (fresh >> SENSOR_SOIL_BIT) & 1;
+    window.sensorStatus = readings.sensorStatus;
+    window.sampleStartUptimeMs = readings.monotonicMs;
+    window.sampleEndUptimeMs = readings.monotonicMs;
+    window.uptimeMs = readings.monotonicMs;
+}
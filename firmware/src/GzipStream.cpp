@@ -0,0 +1,299 @@
+#include "GzipStream.h"
+
+#include <string.h>
+
+#include "Crc32.h"
+
+namespace {
+
+constexpr uint16_t NIL = 0xFFFF;
+constexpr uint16_t MIN_MATCH = 3;
+constexpr uint16_t MAX_MATCH = 258;
+constexpr uint16_t MIN_LOOKAHEAD = MAX_MATCH + MIN_MATCH + 1;
+constexpr uint16_t WINDOW_BYTES = 2 * GZIP_DICT_SIZE;
+
+// RFC 1951 §3.2.5 length (codes 257..285) and distance (codes 0..29) bases
+const uint16_t lengthBase[29] = {3,  4,  5,  6,  7,  8,  9,  10, 11,  13,  15,  17,  19,  23, 27,
+                                 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+const uint8_t lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+const uint16_t distanceBase[30] = {1,    2,    3,    4,    5,    7,     9,     13,    17,  25,
+                                   33,   49,   65,   97,   129,  193,   257,   385,   513, 769,
+                                   1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+const uint8_t distanceExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2,  3,  3,  4,  4,  5,  5,  6,
+                                   6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+
+// Largest index whose base does not exceed value
+uint8_t findCode(const uint16_t* base, uint8_t count, uint16_t value) {
+    uint8_t code = count - 1;
+    while (base[code] > value) {
+        code--;
+    }
+    return code;
+}
+
+uint16_t hash3(const uint8_t* bytes) {
+    uint32_t key = (uint32_t(bytes[0]) << 16) | (uint32_t(bytes[1]) << 8) | bytes[2];
+    return (key * 2654435761u) >> (32 - GZIP_HASH_BITS);
+}
+
+}  // namespace
+
+GzipStream::GzipStream() : source(nullptr), totalLength(0) {
+    reset();
+}
+
+void GzipStream::begin(PayloadStream& payload) {
+    source = &payload;
+
+    // Dry pass: compress everything once, keeping only the length
+    rewind();
+    totalLength = 0;
+    while (produce()) {
+        totalLength += outputLength;
+    }
+    rewind();
+}
+
+void GzipStream::rewind() {
+    if (source) {
+        source->rewind();
+    }
+    reset();
+}
+
+void GzipStream::reset() {
+    stage = Stage::HEADER;
+    inputLength = 0;
+    crc = 0;
+    sourceDone = false;
+    memset(head, 0xFF, sizeof(head));
+    memset(prev, 0xFF, sizeof(prev));
+    strstart = 0;
+    lookahead = 0;
+    bitBuffer = 0;
+    bitCount = 0;
+    outputLength = 0;
+    outputPos = 0;
+}
+
+void GzipStream::fillWindow() {
+    while (lookahead < MIN_LOOKAHEAD && !sourceDone) {
+        if (strstart + lookahead >= WINDOW_BYTES) {
+            // Slide the upper half down; strstart is past GZIP_DICT_SIZE here
+            memmove(window, window + GZIP_DICT_SIZE, GZIP_DICT_SIZE);
+            strstart -= GZIP_DICT_SIZE;
+            for (uint16_t& pos : head) {
+                pos = (pos != NIL && pos >= GZIP_DICT_SIZE) ? pos - GZIP_DICT_SIZE : NIL;
+            }
+            for (uint16_t& pos : prev) {
+                pos = (pos != NIL && pos >= GZIP_DICT_SIZE) ? pos - GZIP_DICT_SIZE : NIL;
+            }
+        }
+
+        uint8_t* end = window + strstart + lookahead;
+        size_t read =
+            source ? source->readBytes(reinterpret_cast<char*>(end), WINDOW_BYTES - strstart -
+                                                                         lookahead)
+                   : 0;
+        if (read == 0) {
+            sourceDone = true;
+            break;
+        }
+        crc = crc32Update(end, read, crc);
+        inputLength += read;
+        lookahead += read;
+    }
+}
+
+void GzipStream::insertHash(uint16_t pos) {
+    uint16_t h = hash3(window + pos);
+    prev[pos & (GZIP_DICT_SIZE - 1)] = head[h];
+    head[h] = pos;
+}
+
+uint16_t GzipStream::longestMatch(uint16_t& distance) {
+    if (lookahead < MIN_MATCH) {
+        return 0;
+    }
+    uint16_t maxLength = lookahead < MAX_MATCH ? lookahead : MAX_MATCH;
+    const uint8_t* current = window + strstart;
+
+    uint16_t best = 0;
+    uint16_t candidate = head[hash3(current)];
+    for (uint8_t chain = 0; chain < GZIP_MAX_CHAIN && candidate < strstart; chain++) {
+        // Chains can hold stale or colliding entries; the byte compare decides
+        const uint8_t* match = window + candidate;
+        uint16_t length = 0;
+        while (length < maxLength && match[length] == current[length]) {
+            length++;
+        }
+        if (length > best) {
+            best = length;
+            distance = strstart - candidate;
+            if (best == maxLength) {
+                break;
+            }
+        }
+
+        uint16_t next = prev[candidate & (GZIP_DICT_SIZE - 1)];
+        if (next == NIL || next >= candidate) {
+            break;
+        }
+        candidate = next;
+    }
+    return best;
+}
+
+bool GzipStream::produce() {
+    outputLength = 0;
+    outputPos = 0;
+    if (stage == Stage::DONE) {
+        return false;
+    }
+
+    if (stage == Stage::HEADER) {
+        // ID1 ID2, CM = deflate, no flags, no mtime, XFL 0, OS unknown
+        static const uint8_t header[10] = {0x1F, 0x8B, 8, 0, 0, 0, 0, 0, 0, 0xFF};
+        memcpy(output, header, sizeof(header));
+        outputLength = sizeof(header);
+        putBits(1, 1);  // BFINAL: the whole body is one block
+        putBits(1, 2);  // BTYPE 01: fixed Huffman codes
+        stage = Stage::DEFLATE;
+    }
+
+    // Each symbol adds at most 31 bits, so 8 free bytes always suffice
+    while (stage == Stage::DEFLATE && outputLength + 8 <= sizeof(output)) {
+        fillWindow();
+        if (lookahead == 0) {
+            putCode(0, 7);  // End of block (symbol 256)
+            alignToByte();
+            stage = Stage::TRAILER;
+            break;
+        }
+
+        uint16_t distance = 0;
+        uint16_t length = longestMatch(distance);
+        if (length >= MIN_MATCH) {
+            putMatch(length, distance);
+            for (uint16_t i = 0; i < length; i++) {
+                if (lookahead - i >= MIN_MATCH) {
+                    insertHash(strstart + i);
+                }
+            }
+            strstart += length;
+            lookahead -= length;
+        } else {
+            if (lookahead >= MIN_MATCH) {
+                insertHash(strstart);
+            }
+            putLiteral(window[strstart]);
+            strstart++;
+            lookahead--;
+        }
+    }
+
+    if (stage == Stage::TRAILER && outputLength + 8 <= sizeof(output)) {
+        // CRC32 and ISIZE of the uncompressed body, little-endian
+        for (uint8_t i = 0; i < 4; i++) {
+            putByte(crc >> (8 * i));
+        }
+        for (uint8_t i = 0; i < 4; i++) {
+            putByte(inputLength >> (8 * i));
+        }
+        stage = Stage::DONE;
+    }
+    return outputLength > 0;
+}
+
+void GzipStream::putBits(uint32_t value, uint8_t count) {
+    bitBuffer |= value << bitCount;
+    bitCount += count;
+    while (bitCount >= 8) {
+        putByte(bitBuffer & 0xFF);
+        bitBuffer >>= 8;
+        bitCount -= 8;
+    }
+}
+
+void GzipStream::putCode(uint16_t code, uint8_t length) {
+    // Huffman codes are defined MSB-first but packed into an LSB-first stream
+    uint16_t reversed = 0;
+    for (uint8_t i = 0; i < length; i++) {
+        reversed = (reversed << 1) | ((code >> i) & 1);
+    }
+    putBits(reversed, length);
+}
+
+void GzipStream::putLiteral(uint8_t value) {
+    if (value < 144) {
+        putCode(0x30 + value, 8);
+    } else {
+        putCode(0x190 + (value - 144), 9);
+    }
+}
+
+void GzipStream::putMatch(uint16_t length, uint16_t distance) {
+    uint8_t lengthCode = findCode(lengthBase, 29, length);
+    uint16_t symbol = 257 + lengthCode;
+    if (symbol < 280) {
+        putCode(symbol - 256, 7);
+    } else {
+        putCode(0xC0 + (symbol - 280), 8);
+    }
+    putBits(length - lengthBase[lengthCode], lengthExtra[lengthCode]);
+
+    uint8_t distanceCode = findCode(distanceBase, 30, distance);
+    putCode(distanceCode, 5);
+    putBits(distance - distanceBase[distanceCode], distanceExtra[distanceCode]);
+}
+
+void GzipStream::alignToByte() {
+    if (bitCount > 0) {
+        putByte(bitBuffer & 0xFF);
+        bitBuffer = 0;
+        bitCount = 0;
+    }
+}
+
+void GzipStream::putByte(uint8_t value) {
+    output[outputLength++] = value;
+}
+
+size_t GzipStream::readBytes(char* buffer, size_t length) {
+    size_t copied = 0;
+    while (copied < length) {
+        if (outputPos == outputLength && !produce()) {
+            break;
+        }
+        size_t chunk = outputLength - outputPos;
+        if (chunk > length - copied) {
+            chunk = length - copied;
+        }
+        memcpy(buffer + copied, output + outputPos, chunk);
+        outputPos += chunk;
+        copied += chunk;
+    }
+    return copied;
+}
+
+int GzipStream::available() {
+    if (outputPos == outputLength && !produce()) {
+        return 0;
+    }
+    return static_cast<int>(outputLength - outputPos);
+}
+
+int GzipStream::read() {
+    if (available() == 0) {
+        return -1;
+    }
+    return output[outputPos++];
+}
+
+int GzipStream::peek() {
+    if (available() == 0) {
+        return -1;
+    }
+    return output[outputPos];
+}
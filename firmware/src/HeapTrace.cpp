@@ -0,0 +1,92 @@
+#include "HeapTrace.h"
+
+#ifdef ARDUINO
+#include <esp_attr.h>
+#else
+#define IRAM_ATTR
+#endif
+
+namespace {
+
+// Written by the hooks from any core; read once per pass by loop()
+volatile uint32_t allocations = 0;
+volatile uint32_t allocatedBytes = 0;
+volatile uint32_t frees = 0;
+
+uint32_t passStartAllocations = 0;
+uint32_t passStartBytes = 0;
+uint32_t lastPassAllocations = 0;
+uint32_t lastPassBytes = 0;
+uint32_t maxPassAllocations = 0;
+
+}  // namespace
+
+#ifdef HEAP_TRACE_HOOKS
+// ESP-IDF calls these after every successful heap_caps_* allocation and free
+extern "C" IRAM_ATTR void esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps) {
+    (void)ptr;
+    (void)caps;
+    HeapTrace::recordAllocation(size);
+}
+
+extern "C" IRAM_ATTR void esp_heap_trace_free_hook(void* ptr) {
+    (void)ptr;
+    HeapTrace::recordFree();
+}
+#endif
+
+bool HeapTrace::isEnabled() {
+#ifdef HEAP_TRACE_HOOKS
+    return true;
+#else
+    return false;
+#endif
+}
+
+IRAM_ATTR void HeapTrace::recordAllocation(size_t size) {
+    __atomic_fetch_add(&allocations, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&allocatedBytes, static_cast<uint32_t>(size), __ATOMIC_RELAXED);
+}
+
+IRAM_ATTR void HeapTrace::recordFree() {
+    __atomic_fetch_add(&frees, 1, __ATOMIC_RELAXED);
+}
+
+void HeapTrace::endPass() {
+    uint32_t nowAllocations = allocations;
+    uint32_t nowBytes = allocatedBytes;
+    lastPassAllocations = nowAllocations - passStartAllocations;
+    lastPassBytes = nowBytes - passStartBytes;
+    passStartAllocations = nowAllocations;
+    passStartBytes = nowBytes;
+    if (lastPassAllocations > maxPassAllocations) {
+        maxPassAllocations = lastPassAllocations;
+    }
+}
+
+uint32_t HeapTrace::getLastPassAllocations() {
+    return lastPassAllocations;
+}
+
+uint32_t HeapTrace::getLastPassBytes() {
+    return lastPassBytes;
+}
+
+uint32_t HeapTrace::getMaxPassAllocations() {
+    return maxPassAllocations;
+}
+
+int32_t HeapTrace::getOutstanding() {
+    return static_cast<int32_t>(allocations - frees);
+}
+
+void HeapTrace::reset() {
+    allocations = 0;
+    allocatedBytes = 0;
+    frees = 0;
+    passStartAllocations = 0;
+    passStartBytes = 0;
+    lastPassAllocations = 0;
+    lastPassBytes = 0;
+    maxPassAllocations = 0;
+}
@@ -0,0 +1,108 @@
+#include "LoopProfiler.h"
+
+#include <string.h>
+
+namespace {
+
+LoopPhaseStats phaseStats[NUM_LOOP_PHASES];
+
+// This pass only
+uint32_t phaseStartUs[NUM_LOOP_PHASES];
+uint32_t passUs[NUM_LOOP_PHASES];
+uint8_t startedMask = 0;
+uint8_t ranMask = 0;
+
+const char* const PHASE_KEYS[NUM_LOOP_PHASES] = {"status",  "sensors", "averaging", "publish",
+                                                 "wifi",    "display", "serial",    "sleep"};
+
+}  // namespace
+
+void LoopProfiler::start(LoopPhase phase, uint32_t nowUs) {
+    if (phase >= NUM_LOOP_PHASES) {
+        return;
+    }
+    phaseStartUs[phase] = nowUs;
+    startedMask |= 1 << phase;
+}
+
+void LoopProfiler::finish(LoopPhase phase, uint32_t nowUs) {
+    if (phase >= NUM_LOOP_PHASES || !(startedMask & (1 << phase))) {
+        return;
+    }
+    passUs[phase] += nowUs - phaseStartUs[phase];  // Unsigned: fine across micros() wrap
+    startedMask &= ~(1 << phase);
+    ranMask |= 1 << phase;
+}
+
+void LoopProfiler::endPass() {
+    for (uint8_t i = 0; i < NUM_LOOP_PHASES; i++) {
+        if (!(ranMask & (1 << i))) {
+            continue;
+        }
+        LoopPhaseStats& stats = phaseStats[i];
+        stats.buckets[bucketFor(passUs[i])]++;
+        stats.count++;
+        stats.lastUs = passUs[i];
+        if (passUs[i] > stats.maxUs) {
+            stats.maxUs = passUs[i];
+        }
+        passUs[i] = 0;
+    }
+    ranMask = 0;
+}
+
+const LoopPhaseStats& LoopProfiler::stats(LoopPhase phase) {
+    return phaseStats[phase < NUM_LOOP_PHASES ? phase : 0];
+}
+
+uint32_t LoopProfiler::percentileUs(LoopPhase phase, uint8_t percent) {
+    const LoopPhaseStats& phaseData = stats(phase);
+    if (phaseData.count == 0) {
+        return 0;
+    }
+    // Smallest bucket with at least percent% of the passes at or below it
+    uint64_t needed = (static_cast<uint64_t>(phaseData.count) * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (uint8_t b = 0; b < LOOP_HISTOGRAM_BUCKETS; b++) {
+        seen += phaseData.buckets[b];
+        if (seen >= needed) {
+            uint32_t limit = bucketLimitUs(b);
+            return limit < phaseData.maxUs ? limit : phaseData.maxUs;
+        }
+    }
+    return phaseData.maxUs;
+}
+
+void LoopProfiler::summarize(LoopPhaseSummary out[NUM_LOOP_PHASES]) {
+    for (uint8_t i = 0; i < NUM_LOOP_PHASES; i++) {
+        LoopPhase phase = static_cast<LoopPhase>(i);
+        out[i].p95Us = percentileUs(phase, 95);
+        out[i].maxUs = phaseStats[i].maxUs;
+    }
+}
+
+void LoopProfiler::reset() {
+    memset(phaseStats, 0, sizeof(phaseStats));
+    memset(passUs, 0, sizeof(passUs));
+    startedMask = 0;
+    ranMask = 0;
+}
+
+uint8_t LoopProfiler::bucketFor(uint32_t durationUs) {
+    uint8_t bucket = 0;
+    while (bucket < LOOP_HISTOGRAM_BUCKETS - 1 && durationUs >= bucketLimitUs(bucket)) {
+        bucket++;
+    }
+    return bucket;
+}
+
+uint32_t LoopProfiler::bucketLimitUs(uint8_t bucket) {
+    if (bucket >= LOOP_HISTOGRAM_BUCKETS - 1) {
+        return UINT32_MAX;
+    }
+    return 16u << (2 * bucket);
+}
+
+const char* LoopProfiler::phaseKey(LoopPhase phase) {
+    return phase < NUM_LOOP_PHASES ? PHASE_KEYS[phase] : "unknown";
+}
@@ -0,0 +1,70 @@
+#include "LoopScheduler.h"
+
+LoopScheduler::LoopScheduler() : jobs() {}
+
+void LoopScheduler::setPeriodic(LoopJob job, uint32_t periodMs, unsigned long nowMs,
+                                bool deferrable) {
+    Job& entry = jobs[job];
+    if (periodMs == 0) {
+        cancel(job);
+        return;
+    }
+    entry.deferrable = deferrable;
+    if (entry.scheduled && entry.periodMs == periodMs) {
+        return;  // Same period: keep the phase
+    }
+
+    // A new period counts from the last run if the job had one, else from now
+    unsigned long lastRunMs =
+        entry.scheduled && entry.periodMs > 0 ? entry.dueMs - entry.periodMs : nowMs;
+    entry.scheduled = true;
+    entry.periodMs = periodMs;
+    entry.dueMs = lastRunMs + periodMs;
+}
+
+void LoopScheduler::setDeadline(LoopJob job, unsigned long dueMs, bool deferrable) {
+    Job& entry = jobs[job];
+    entry.scheduled = true;
+    entry.deferrable = deferrable;
+    entry.periodMs = 0;
+    entry.dueMs = dueMs;
+}
+
+void LoopScheduler::cancel(LoopJob job) {
+    jobs[job] = {};
+}
+
+bool LoopScheduler::isDue(LoopJob job, unsigned long nowMs) {
+    Job& entry = jobs[job];
+    if (!entry.scheduled || static_cast<long>(nowMs - entry.dueMs) < 0) {
+        return false;
+    }
+
+    if (entry.periodMs == 0) {
+        entry.scheduled = false;
+        return true;
+    }
+    entry.dueMs += entry.periodMs;
+    if (static_cast<long>(nowMs - entry.dueMs) >= 0) {
+        entry.dueMs = nowMs + entry.periodMs;  // Over a period late: skip the missed runs
+    }
+    return true;
+}
+
+uint32_t LoopScheduler::msUntilNext(unsigned long nowMs, bool includeDeferrable) const {
+    uint32_t soonest = UINT32_MAX;
+    for (uint8_t i = 0; i < NUM_LOOP_JOBS; i++) {
+        const Job& entry = jobs[i];
+        if (!entry.scheduled || (entry.deferrable && !includeDeferrable)) {
+            continue;
+        }
+        long remaining = static_cast<long>(entry.dueMs - nowMs);
+        if (remaining <= 0) {
+            return 0;
+        }
+        if (static_cast<uint32_t>(remaining) < soonest) {
+            soonest = static_cast<uint32_t>(remaining);
+        }
+    }
+    return soonest;
+}
@@ -0,0 +1,169 @@
+#include "MqttClient.h"
+
+#include "MqttPacket.h"
+
+MqttClient::MqttClient()
+    : client(nullptr), session(false), nextPacketId(1), inFlightId(0), lastSendMs(0) {}
+
+bool MqttClient::connect(WiFiClient& transport, const char* host, uint16_t port,
+                         const char* clientId, const char* username, const char* password) {
+    client = &transport;
+    client->stop();
+    if (!client->connect(host, port, MQTT_RESPONSE_TIMEOUT_MS)) {
+        Serial.printf("[MqttClient] Connect to %s:%u failed\n", host, port);
+        return false;
+    }
+
+    size_t length = MqttPacket::buildConnect(scratch, sizeof(scratch), clientId, username,
+                                             password, MQTT_KEEPALIVE_SEC, false);
+    if (length == 0 || !writeAll(scratch, length)) {
+        Serial.println("[MqttClient] Could not send CONNECT");
+        stop();
+        return false;
+    }
+
+    // CONNACK: session present flag, then the return code
+    uint8_t header = 0;
+    uint8_t body[2] = {0, 0xFF};
+    if (!readPacket(header, body, sizeof(body), MQTT_RESPONSE_TIMEOUT_MS) ||
+        (header >> 4) != MqttPacket::CONNACK || body[1] != 0) {
+        Serial.printf("[MqttClient] Broker refused connection (code %u)\n", body[1]);
+        stop();
+        return false;
+    }
+
+    session = (body[0] & 0x01) != 0;
+    if (!session) {
+        inFlightId = 0;  // A new session holds no in-flight message to resend
+    }
+    Serial.printf("[MqttClient] Connected to %s:%u (%s session)\n", host, port,
+                  session ? "resumed" : "new");
+    return true;
+}
+
+bool MqttClient::connected() {
+    return client && client->connected();
+}
+
+MqttClient::Result MqttClient::publish(const char* topic, PayloadStream& body, bool resend) {
+    bool dup = resend && inFlightId != 0;
+    if (!dup) {
+        inFlightId = nextPacketId;
+        nextPacketId = nextPacketId == 0xFFFF ? 1 : nextPacketId + 1;  // 0 is not valid
+    }
+
+    size_t length = MqttPacket::buildPublishHeader(scratch, sizeof(scratch), topic, inFlightId,
+                                                   body.contentLength(), dup);
+    if (length == 0 || !writeAll(scratch, length)) {
+        return Result::WRITE_FAILED;
+    }
+
+    body.rewind();
+    size_t chunk;
+    while ((chunk = body.readBytes(reinterpret_cast<char*>(scratch), sizeof(scratch))) > 0) {
+        if (!writeAll(scratch, chunk)) {
+            return Result::WRITE_FAILED;
+        }
+    }
+
+    // Skip PINGRESP and anything else until our PUBACK arrives
+    unsigned long start = millis();
+    while (millis() - start < MQTT_RESPONSE_TIMEOUT_MS) {
+        uint8_t header = 0;
+        uint8_t ack[2] = {0, 0};
+        if (!readPacket(header, ack, sizeof(ack), MQTT_RESPONSE_TIMEOUT_MS - (millis() - start))) {
+            break;
+        }
+        uint16_t ackedId = (ack[0] << 8) | ack[1];
+        if ((header >> 4) == MqttPacket::PUBACK && ackedId == inFlightId) {
+            inFlightId = 0;
+            return Result::ACKED;
+        }
+    }
+    return connected() ? Result::TIMEOUT : Result::WRITE_FAILED;
+}
+
+void MqttClient::poll() {
+    if (!connected()) {
+        return;
+    }
+
+    // Drain whatever the broker sent (PINGRESP, late PUBACKs)
+    while (client->available() > 0) {
+        uint8_t header = 0;
+        if (!readPacket(header, nullptr, 0, MQTT_RESPONSE_TIMEOUT_MS)) {
+            break;
+        }
+    }
+
+    if (millis() - lastSendMs >= MQTT_KEEPALIVE_SEC * 1000UL / 2) {
+        size_t length = MqttPacket::buildEmpty(scratch, sizeof(scratch), MqttPacket::PINGREQ);
+        writeAll(scratch, length);
+    }
+}
+
+void MqttClient::stop() {
+    if (client) {
+        client->stop();
+    }
+}
+
+bool MqttClient::writeAll(const uint8_t* data, size_t length) {
+    size_t written = 0;
+    while (written < length && client->connected()) {
+        size_t sent = client->write(data + written, length - written);
+        if (sent == 0) {
+            break;
+        }
+        written += sent;
+    }
+    if (written < length) {
+        return false;
+    }
+    lastSendMs = millis();
+    return true;
+}
+
+bool MqttClient::readPacket(uint8_t& header, uint8_t* body, size_t bodySize,
+                            unsigned long timeoutMs) {
+    unsigned long deadline = millis() + timeoutMs;
+    int value = readByte(deadline);
+    if (value < 0) {
+        return false;
+    }
+    header = static_cast<uint8_t>(value);
+
+    // Remaining Length: up to four 7-bit digits, least significant first
+    uint32_t remaining = 0;
+    for (uint8_t shift = 0; shift < 28; shift += 7) {
+        value = readByte(deadline);
+        if (value < 0) {
+            return false;
+        }
+        remaining |= uint32_t(value & 0x7F) << shift;
+        if ((value & 0x80) == 0) {
+            break;
+        }
+    }
+
+    for (uint32_t i = 0; i < remaining; i++) {
+        value = readByte(deadline);
+        if (value < 0) {
+            return false;
+        }
+        if (i < bodySize) {
+            body[i] = static_cast<uint8_t>(value);
+        }
+    }
+    return true;
+}
+
+int MqttClient::readByte(unsigned long deadline) {
+    while (client->available() == 0) {
+        if (!client->connected() || static_cast<long>(millis() - deadline) >= 0) {
+            return -1;
+        }
+        delay(1);
+    }
+    return client->read();
+}
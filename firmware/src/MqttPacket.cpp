@@ -0,0 +1,125 @@
+#include "MqttPacket.h"
+
+#include <string.h>
+
+namespace MqttPacket {
+
+namespace {
+
+// Appends a 2-byte length prefixed UTF-8 string
+bool putString(uint8_t* out, size_t size, size_t& pos, const char* text) {
+    size_t length = strlen(text);
+    if (length > 0xFFFF || pos + 2 + length > size) {
+        return false;
+    }
+    out[pos++] = length >> 8;
+    out[pos++] = length & 0xFF;
+    memcpy(out + pos, text, length);
+    pos += length;
+    return true;
+}
+
+bool present(const char* text) {
+    return text && text[0] != '\0';
+}
+
+}  // namespace
+
+size_t encodeRemainingLength(uint32_t length, uint8_t* out) {
+    if (length > MAX_REMAINING_LENGTH) {
+        return 0;
+    }
+    size_t count = 0;
+    do {
+        uint8_t digit = length % 128;
+        length /= 128;
+        if (length > 0) {
+            digit |= 0x80;  // More digits follow
+        }
+        out[count++] = digit;
+    } while (length > 0);
+    return count;
+}
+
+size_t buildConnect(uint8_t* out, size_t size, const char* clientId, const char* username,
+                    const char* password, uint16_t keepAliveSec, bool cleanSession) {
+    bool hasUsername = present(username);
+    bool hasPassword = hasUsername && present(password);
+
+    // Variable header: protocol name, level 4 (3.1.1), flags, keep alive
+    static const uint8_t protocol[7] = {0, 4, 'M', 'Q', 'T', 'T', 4};
+    uint8_t flags = cleanSession ? 0x02 : 0x00;
+    if (hasUsername) {
+        flags |= 0x80;
+    }
+    if (hasPassword) {
+        flags |= 0x40;
+    }
+
+    uint32_t remaining = sizeof(protocol) + 3 + 2 + strlen(clientId);
+    if (hasUsername) {
+        remaining += 2 + strlen(username);
+    }
+    if (hasPassword) {
+        remaining += 2 + strlen(password);
+    }
+
+    uint8_t lengthBytes[4];
+    size_t lengthSize = encodeRemainingLength(remaining, lengthBytes);
+    if (lengthSize == 0 || 1 + lengthSize + remaining > size) {
+        return 0;
+    }
+
+    size_t pos = 0;
+    out[pos++] = CONNECT << 4;
+    memcpy(out + pos, lengthBytes, lengthSize);
+    pos += lengthSize;
+    memcpy(out + pos, protocol, sizeof(protocol));
+    pos += sizeof(protocol);
+    out[pos++] = flags;
+    out[pos++] = keepAliveSec >> 8;
+    out[pos++] = keepAliveSec & 0xFF;
+
+    // Payload in the order the flags list them
+    if (!putString(out, size, pos, clientId) ||
+        (hasUsername && !putString(out, size, pos, username)) ||
+        (hasPassword && !putString(out, size, pos, password))) {
+        return 0;
+    }
+    return pos;
+}
+
+size_t buildPublishHeader(uint8_t* out, size_t size, const char* topic, uint16_t packetId,
+                          uint32_t payloadLength, bool dup) {
+    size_t topicLength = strlen(topic);
+    uint64_t remaining = 2ULL + topicLength + 2 + payloadLength;
+    if (remaining > MAX_REMAINING_LENGTH) {
+        return 0;
+    }
+
+    uint8_t lengthBytes[4];
+    size_t lengthSize = encodeRemainingLength(static_cast<uint32_t>(remaining), lengthBytes);
+    if (1 + lengthSize + 2 + topicLength + 2 > size) {
+        return 0;
+    }
+
+    size_t pos = 0;
+    out[pos++] = (PUBLISH << 4) | (dup ? 0x08 : 0x00) | (1 << 1);  // QoS 1, no retain
+    memcpy(out + pos, lengthBytes, lengthSize);
+    pos += lengthSize;
+    putString(out, size, pos, topic);
+    out[pos++] = packetId >> 8;
+    out[pos++] = packetId & 0xFF;
+    return pos;
+}
+
+size_t buildEmpty(uint8_t* out, size_t size, Type type) {
+    if (size < 2) {
+        return 0;
+    }
+    out[0] = type << 4;
+    out[1] = 0;
+    return 2;
+}
+
+}  // namespace MqttPacket
@@ -1,30 +1,162 @@
 #include "NetworkManager.h"
 
 #include "BootId.h"
+#include "Crc32.h"
+#include "DataManager.h"
+#include "ErrorLogger.h"
+#include "PowerLock.h"
+#include "TextBuffer.h"
 #include "models/SensorType.h"
 
 #ifndef UNIT_TEST
+#include <esp_attr.h>
 #include <esp_task_wdt.h>
+#else
+#define RTC_DATA_ATTR  // Plain static storage on the host
 #endif
 
+namespace {
+
+constexpr uint32_t FAST_CONNECT_MAGIC = 0x31434657;  // "WFC1"
+
+// Access point of the last successful connect; kept across deep sleep, zeroed at power-on
+struct FastConnectCache {
+    uint32_t magic;
+    uint32_t ssidCrc;  // Only reused for the same network
+    uint8_t bssid[6];
+    int32_t channel;
+};
+
+RTC_DATA_ATTR FastConnectCache fastConnect;
+
+uint32_t ssidCrc(const String& ssid) {
+    return crc32Update(ssid.c_str(), ssid.length());
+}
+
+// HTTPClient::errorToString() texts, without the String it returns
+const char* httpErrorName(int code) {
+    static const char* const NAMES[] = {
+        "connection refused", "send header failed", "send payload failed",
+        "not connected",      "connection lost",    "no stream",
+        "no HTTP server",     "too less ram",       "Transfer-Encoding not supported",
+        "Stream write error", "read Timeout"};
+    const int count = sizeof(NAMES) / sizeof(NAMES[0]);
+    return code < 0 && code >= -count ? NAMES[-code - 1] : "unknown error";
+}
+
+// Stream sink for HTTPClient::writeToStream() that keeps the first bytes of a body as
+// text and accepts (drops) the rest, so the whole body is consumed
+class BodyCapture : public Stream {
+   public:
+    BodyCapture(char* buffer, size_t capacity) : text(buffer), room(capacity), length(0) {
+        if (room > 0) {
+            text[0] = '\0';
+        }
+    }
+
+    size_t write(const uint8_t* data, size_t size) override {
+        size_t kept = length + 1 < room ? room - 1 - length : 0;
+        kept = size < kept ? size : kept;
+        memcpy(text + length, data, kept);
+        length += kept;
+        if (room > 0) {
+            text[length] = '\0';
+        }
+        return size;
+    }
+    size_t write(uint8_t value) override { return write(&value, 1); }
+
+    int available() override { return 0; }
+    int read() override { return -1; }
+    int peek() override { return -1; }
+    void flush() override {}
+
+   private:
+    char* text;
+    size_t room;
+    size_t length;
+};
+
+}  // namespace
+
 NetworkManager::NetworkManager(ConfigManager& configMgr, TimeManager& timeMgr,
                                SystemStatusManager& statusMgr)
     : config(configMgr),
       timeManager(timeMgr),
       statusManager(statusMgr),
+      tlsConfigured(false),
+      tlsValidating(false),
+      formatRejected(false),
+      compressBody(false),
+      gzipRejected(false),
+      uploadArenaStorage(),
+      uploadState(UploadState::IDLE),
+      uploadSource(nullptr),
+      uploadSourceContext(nullptr),
+      uploadCallback(nullptr),
+      uploadCallbackContext(nullptr),
+      uploadHasCurrent(false),
+      uploadAttempt(0),
+      uploadInsecure(false),
+      uploadWaitStart(0),
+      uploadWaitMs(0),
+      uploadHttpCode(0),
+      uploadBacklogCount(0),
+      uploadAckedCount(0),
+      uploadCurrentAcked(false),
+      registrationCallback(nullptr),
+      registrationCallbackContext(nullptr),
+      registrationQueuedAt(0),
+      registrationDelayMs(0),
+      registrationQueued(false),
+      wifiState(WiFiState::IDLE),
+      linkUp(false),
+      linkDropped(false),
+      wifiStateSince(0),
+      reconnectDelayMs(0),
+      connectStartMs(0),
+      usingFastConnect(false),
       reconnectAttempts(0),
-      lastReconnectAttempt(0) {}
+      radioMode(RadioMode::ACTIVE),
+      connectivityKnown(false),
+      connectivityOk(false),
+      connectivityAtMs(0) {
+    uploadArena.attach(uploadArenaStorage, sizeof(uploadArenaStorage));
+}
 
 void NetworkManager::initialize() {
-    // WiFi initialization will be done in connectWiFi()
+    // Link state follows WiFi events (raised on the WiFi event task); the rest of the
+    // state machine runs in checkConnection() on the loop task
+    WiFi.onEvent([this](WiFiEvent_t event, WiFiEventInfo_t) {
+        switch (event) {
+            case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+                linkUp = true;
+                break;
+            case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            case ARDUINO_EVENT_WIFI_STA_LOST_IP:
+                linkUp = false;
+                linkDropped = true;
+                break;
+            default:
+                break;
+        }
+    });
     Serial.println("[NetworkManager] Initialized");
 }
 
+void NetworkManager::setDeviceIdentity(const String& hwId, const String& boot,
+                                       const char* firmwareVersion) {
+    hardwareId = hwId;
+    bootId = boot;
+    payloadStream.setIdentity(hardwareId.c_str(), bootId.c_str(), firmwareVersion);
+}
+
 bool NetworkManager::connectWiFi() {
-    Config cfg = config.getConfig();
+    SnapshotHold hold(config);
+    const Config& cfg = hold.getConfig();
 
     // Check if already connected
-    if (WiFi.status() == WL_CONNECTED) {
+    if (isConnected()) {
         Serial.println("[NetworkManager] Already connected to WiFi");
         return true;
     }
@@ -35,163 +167,243 @@ bool NetworkManager::connectWiFi() {
         return false;
     }
 
-    Serial.print("[NetworkManager] Connecting to WiFi: ");
-    Serial.println(cfg.wifiSsid);
-
-    // Set WiFi mode to station
+    // Set WiFi mode to station; reconnects are scheduled by checkConnection()
+    if (radioMode == RadioMode::OFF) {
+        radioMode = RadioMode::MODEM_SLEEP;
+    }
     WiFi.mode(WIFI_STA);
-    WiFi.begin(cfg.wifiSsid, cfg.wifiPassword);
-
-    // Retry with exponential backoff (up to 5 attempts)
-    const uint8_t MAX_ATTEMPTS = 5;
+    WiFi.setAutoReconnect(false);
+    applyStaticIp(cfg);
     reconnectAttempts = 0;
+    connectStartMs = millis();
+    beginAssociation(cfg);
+    return true;
+}
 
-    while (reconnectAttempts < MAX_ATTEMPTS) {
-        // Feed watchdog before connection attempt
-#ifndef UNIT_TEST
-        esp_task_wdt_reset();
-#endif
+void NetworkManager::applyStaticIp(const Config& cfg) {
+    IPAddress none(0, 0, 0, 0);
+    if (cfg.staticIp.length() == 0) {
+        WiFi.config(none, none, none);  // DHCP
+        return;
+    }
 
-        // Wait for connection with timeout
-        unsigned long startAttempt = millis();
-        const unsigned long CONNECT_TIMEOUT = 10000;  // 10 seconds per attempt
+    IPAddress ip;
+    IPAddress gateway;
+    IPAddress subnet(255, 255, 255, 0);
+    bool valid = ip.fromString(cfg.staticIp) && gateway.fromString(cfg.staticGateway);
+    if (valid && cfg.staticSubnet.length() > 0) {
+        valid = subnet.fromString(cfg.staticSubnet);
+    }
+    IPAddress dns = gateway;
+    if (valid && cfg.staticDns.length() > 0) {
+        valid = dns.fromString(cfg.staticDns);
+    }
 
-        while (WiFi.status() != WL_CONNECTED && (millis() - startAttempt) < CONNECT_TIMEOUT) {
-            delay(100);
-            // Feed watchdog during connection wait
-#ifndef UNIT_TEST
-            if ((millis() - startAttempt) % 1000 == 0) {
-                esp_task_wdt_reset();
-            }
-#endif
-            Serial.print(".");
+    if (!valid) {
+        Serial.println("[WARN] NetworkManager: Invalid static IP configuration, using DHCP");
+        WiFi.config(none, none, none);
+        return;
+    }
+    Serial.printf("[INFO] NetworkManager: Static IP %s (no DHCP)\n", cfg.staticIp.c_str());
+    WiFi.config(ip, gateway, subnet, dns);
+}
+
+bool NetworkManager::isConnected() {
+    return linkUp;
+}
+
+void NetworkManager::checkConnection() {
+    unsigned long now = millis();
+
+    if (linkUp && wifiState != WiFiState::CONNECTED) {
+        wifiState = WiFiState::CONNECTED;
+        invalidateConnectivity();  // New association, possibly another AP
+        uint32_t connectMs = now - connectStartMs;
+        Serial.print("[NetworkManager] Connected! IP: ");
+        Serial.println(WiFi.localIP());
+        Serial.print("[NetworkManager] RSSI: ");
+        Serial.print(WiFi.RSSI());
+        Serial.println(" dBm");
+        Serial.printf("[INFO] NetworkManager: Connected in %lu ms (%s)\n",
+                      static_cast<unsigned long>(connectMs),
+                      usingFastConnect ? "cached AP" : "scan");
+
+        // Update system status with WiFi RSSI and time-to-connected
+        statusManager.setWiFiRSSI(WiFi.RSSI());
+        statusManager.setWiFiConnectTime(connectMs);
+
+        // Remember the access point so the next wake can skip the scan
+        const uint8_t* bssid = WiFi.BSSID();
+        if (bssid) {
+            fastConnect.magic = FAST_CONNECT_MAGIC;
+            SnapshotHold hold(config);
+            fastConnect.ssidCrc = ssidCrc(hold.getConfig().wifiSsid);
+            memcpy(fastConnect.bssid, bssid, sizeof(fastConnect.bssid));
+            fastConnect.channel = WiFi.channel();
         }
 
-        if (WiFi.status() == WL_CONNECTED) {
-            Serial.println();
-            Serial.print("[NetworkManager] Connected! IP: ");
-            Serial.println(WiFi.localIP());
-            Serial.print("[NetworkManager] RSSI: ");
-            Serial.print(WiFi.RSSI());
-            Serial.println(" dBm");
+        applyPowerSave();
+
+        // Trigger NTP sync when WiFi connects
+        timeManager.onWiFiConnected();
 
-            // Update system status with WiFi RSSI
-            statusManager.setWiFiRSSI(WiFi.RSSI());
+        reconnectAttempts = 0;
+        return;
+    }
 
-            // Trigger NTP sync when WiFi connects
-            timeManager.onWiFiConnected();
+    if (!linkUp && wifiState == WiFiState::CONNECTED) {
+        // The kept-alive socket died with the link
+        Serial.println("[NetworkManager] WiFi disconnected, reconnecting...");
+        dropConnection();
+        invalidateConnectivity();
+        statusManager.setWiFiRSSI(-100);  // Disconnected indicator
+        scheduleReconnect(now);
+        return;
+    }
 
-            reconnectAttempts = 0;
-            return true;
+    unsigned long timeoutMs =
+        usingFastConnect ? WIFI_FAST_CONNECT_TIMEOUT_MS : WIFI_CONNECT_TIMEOUT_MS;
+    if (wifiState == WiFiState::CONNECTING &&
+        (linkDropped || now - wifiStateSince >= timeoutMs)) {
+        if (usingFastConnect) {
+            // The cached AP is gone or moved channel: forget it and scan at once
+            Serial.println("[NetworkManager] Cached access point failed, scanning");
+            fastConnect.magic = 0;
+            WiFi.disconnect();
+            SnapshotHold hold(config);
+            beginAssociation(hold.getConfig());
+            return;
         }
 
-        // Connection failed, increment attempt counter
+        // Association or DHCP failed (reported by a disconnect event, or timed out)
         reconnectAttempts++;
-        Serial.println();
         Serial.print("[NetworkManager] Connection attempt ");
         Serial.print(reconnectAttempts);
         Serial.print(" failed. Status: ");
         Serial.println(WiFi.status());
 
-        if (reconnectAttempts < MAX_ATTEMPTS) {
-            unsigned long backoffDelay = calculateBackoffDelay(reconnectAttempts - 1);
-            Serial.print("[NetworkManager] Retrying in ");
-            Serial.print(backoffDelay / 1000);
-            Serial.println(" seconds...");
-
-            lastReconnectAttempt = millis();
-
-            // Feed watchdog during backoff delay
-            unsigned long backoffStart = millis();
-            while (millis() - backoffStart < backoffDelay) {
-                delay(100);
-#ifndef UNIT_TEST
-                if ((millis() - backoffStart) % 1000 == 0) {
-                    esp_task_wdt_reset();
-                }
-#endif
-            }
+        // Cap reconnect attempts to prevent overflow
+        if (reconnectAttempts > 10) {
+            reconnectAttempts = 5;  // Reset to moderate backoff
         }
+
+        statusManager.incrementNetworkFailures();
+        WiFi.disconnect();
+        scheduleReconnect(now);
+        return;
     }
 
-    Serial.println("[NetworkManager] Failed to connect after maximum attempts");
-    statusManager.incrementNetworkFailures();
-    return false;
+    if (wifiState == WiFiState::WAITING && now - wifiStateSince >= reconnectDelayMs) {
+        connectStartMs = now;
+        SnapshotHold hold(config);
+        beginAssociation(hold.getConfig());
+    }
 }
 
-bool NetworkManager::isConnected() {
-    return WiFi.status() == WL_CONNECTED;
+void NetworkManager::beginAssociation(const Config& cfg) {
+    Serial.print("[NetworkManager] Connecting to WiFi: ");
+    Serial.println(cfg.wifiSsid);
+
+    linkDropped = false;
+    usingFastConnect =
+        fastConnect.magic == FAST_CONNECT_MAGIC && fastConnect.ssidCrc == ssidCrc(cfg.wifiSsid);
+    if (usingFastConnect) {
+        // Join the known BSSID on its channel directly, skipping the scan
+        WiFi.begin(cfg.wifiSsid, cfg.wifiPassword, fastConnect.channel, fastConnect.bssid);
+    } else {
+        WiFi.begin(cfg.wifiSsid, cfg.wifiPassword);
+    }
+    wifiState = WiFiState::CONNECTING;
+    wifiStateSince = millis();
 }
 
-void NetworkManager::checkConnection() {
-    // Check if WiFi is still connected
-    if (WiFi.status() == WL_CONNECTED) {
-        // Update RSSI in system status
-        statusManager.setWiFiRSSI(WiFi.RSSI());
+void NetworkManager::setRadioMode(RadioMode mode) {
+    if (mode == radioMode) {
         return;
     }
+    radioMode = mode;
 
-    // WiFi disconnected - attempt reconnection with backoff
-    unsigned long now = millis();
-    unsigned long backoffDelay = calculateBackoffDelay(reconnectAttempts);
-
-    // Check if enough time has passed since last reconnect attempt
-    if (lastReconnectAttempt > 0 && (now - lastReconnectAttempt) < backoffDelay) {
-        return;  // Still in backoff period
+    if (mode != RadioMode::OFF) {
+        applyPowerSave();
+        return;
     }
 
-    Serial.println("[NetworkManager] WiFi disconnected, attempting reconnection...");
-    lastReconnectAttempt = now;
-
-    // Try to reconnect (single attempt, not full retry loop)
-    Config cfg = config.getConfig();
-    WiFi.begin(cfg.wifiSsid, cfg.wifiPassword);
-
-    // Wait briefly for connection
-    unsigned long startAttempt = millis();
-    const unsigned long CONNECT_TIMEOUT = 10000;  // 10 seconds
+    // No reconnect from checkConnection() until connectWiFi() turns the radio back on
+    Serial.println("[INFO] NetworkManager: Radio off until the next uplink");
+    dropConnection();
+    mqttClient.stop();
+    invalidateConnectivity();
+    wifiState = WiFiState::IDLE;
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+    linkUp = false;
+    statusManager.setWiFiRSSI(-100);  // Disconnected indicator
+}
 
-    while (WiFi.status() != WL_CONNECTED && (millis() - startAttempt) < CONNECT_TIMEOUT) {
-        delay(100);
-        // Feed watchdog during connection wait
-#ifndef UNIT_TEST
-        if ((millis() - startAttempt) % 1000 == 0) {
-            esp_task_wdt_reset();
-        }
-#endif
+void NetworkManager::applyPowerSave() {
+    if (wifiState != WiFiState::CONNECTED) {
+        return;  // Applied once the link is up
     }
+    bool idleSleep = radioMode == RadioMode::MODEM_SLEEP && !isUploadBusy();
+    WiFi.setSleep(idleSleep ? WIFI_PS_MAX_MODEM : WIFI_PS_MIN_MODEM);
+}
 
-    if (WiFi.status() == WL_CONNECTED) {
-        Serial.println("[NetworkManager] Reconnected successfully");
-        Serial.print("[NetworkManager] IP: ");
-        Serial.println(WiFi.localIP());
+void NetworkManager::scheduleReconnect(unsigned long now) {
+    reconnectDelayMs = calculateBackoffDelay(reconnectAttempts);
+    Serial.print("[NetworkManager] Retrying in ");
+    Serial.print(reconnectDelayMs / 1000);
+    Serial.println(" seconds...");
+    wifiState = WiFiState::WAITING;
+    wifiStateSince = now;
+}
 
-        // Update system status
-        statusManager.setWiFiRSSI(WiFi.RSSI());
+namespace {
 
-        // Trigger NTP sync
-        timeManager.onWiFiConnected();
+// sendData(): the caller's view stays valid for the whole blocking upload
+BufferedBatch fixedBacklog(void* context) {
+    return *static_cast<const BufferedBatch*>(context);
+}
 
-        // Reset reconnect attempts on success
-        reconnectAttempts = 0;
-    } else {
-        reconnectAttempts++;
-        Serial.print("[NetworkManager] Reconnection failed. Attempt ");
-        Serial.println(reconnectAttempts);
+void storeUploadResult(const UploadResult& result, void* context) {
+    *static_cast<bool*>(context) = result.success;
+}
 
-        // Cap reconnect attempts to prevent overflow
-        if (reconnectAttempts > 10) {
-            reconnectAttempts = 5;  // Reset to moderate backoff
-        }
+}  // namespace
 
-        statusManager.incrementNetworkFailures();
+bool NetworkManager::sendData(const BufferedBatch& backlog, const AveragedData* current) {
+    if (backlog.count() + (current ? 1 : 0) == 0) {
+        Serial.println("[NetworkManager] No data to send");
+        return true;  // Not an error, just nothing to do
+    }
+
+    // Blocking form: drive the upload state machine to completion
+    BufferedBatch view = backlog;
+    bool success = false;
+    if (!startUpload(&fixedBacklog, &view, current, &storeUploadResult, &success)) {
+        return false;
+    }
+    while (isUploadBusy()) {
+        processUpload();
+        delay(10);
+#ifndef UNIT_TEST
+        esp_task_wdt_reset();
+#endif
     }
+    return success;
 }
 
-bool NetworkManager::sendData(const std::vector<AveragedData>& dataList) {
-    if (dataList.empty()) {
+bool NetworkManager::startUpload(BacklogSource source, void* sourceContext,
+                                 const AveragedData* current, UploadCallback onComplete,
+                                 void* callbackContext) {
+    if (uploadState != UploadState::IDLE) {
+        Serial.println("[NetworkManager] Upload already in progress");
+        return false;
+    }
+
+    uint16_t readingCount = source(sourceContext).count() + (current ? 1 : 0);
+    if (readingCount == 0) {
         Serial.println("[NetworkManager] No data to send");
-        return true;  // Not an error, just nothing to do
+        return false;
     }
 
     if (!isConnected()) {
@@ -200,252 +412,566 @@ bool NetworkManager::sendData(const std::vector<AveragedData>& dataList) {
         return false;
     }
 
-    Config cfg = config.getConfig();
+    SnapshotHold hold(config);
+    const Config& cfg = hold.getConfig();
+    bool useMqtt = static_cast<UploadTransport>(cfg.uploadTransport) == UploadTransport::MQTT;
 
     // Validate API endpoint
-    if (strlen(cfg.apiEndpoint) == 0) {
+    if (useMqtt ? cfg.mqttUrl.length() == 0 : strlen(cfg.apiEndpoint) == 0) {
         Serial.println("[NetworkManager] ERROR: API endpoint not configured");
         statusManager.incrementNetworkFailures();
         return false;
     }
 
     Serial.print("[NetworkManager] Sending ");
-    Serial.print(dataList.size());
+    Serial.print(readingCount);
     Serial.println(" reading(s) to API...");
 
-    // Format JSON payload
-    String payload = formatJsonPayload(dataList);
-
-    Serial.print("[NetworkManager] Payload size: ");
-    Serial.print(payload.length());
-    Serial.println(" bytes");
-
-    // Determine if endpoint is HTTPS
-    bool useHttps = String(cfg.apiEndpoint).startsWith("https://");
-
-    if (useHttps) {
+    if (useMqtt) {
+        Serial.printf("[NetworkManager] Using MQTT%s\n",
+                      cfg.mqttUrl.startsWith("mqtts://") ? " with TLS" : "");
+    } else if (hold.get().isHttps()) {
         Serial.println("[NetworkManager] Using HTTPS with TLS");
     } else {
         Serial.println("[NetworkManager] Using plain HTTP");
     }
 
-    // Retry with exponential backoff (up to 5 attempts)
-    const uint8_t MAX_ATTEMPTS = 5;
-    uint8_t attempt = 0;
-    bool success = false;
+    uploadSource = source;
+    uploadSourceContext = sourceContext;
+    uploadHasCurrent = current != nullptr;
+    if (current) {
+        uploadCurrent = *current;
+    }
+    uploadCallback = onComplete;
+    uploadCallbackContext = callbackContext;
+    uploadAttempt = 0;
+    uploadInsecure = false;
+    uploadHttpCode = 0;
+    uploadState = UploadState::SENDING;
+    PowerLock::acquire();  // Full speed for TLS; released in finishUpload()
+    applyPowerSave();
+    return true;
+}
 
-    while (attempt < MAX_ATTEMPTS && !success) {
-        // Feed watchdog before HTTP attempt
-#ifndef UNIT_TEST
-        esp_task_wdt_reset();
-#endif
+void NetworkManager::processUpload() {
+    if (uploadState == UploadState::IDLE) {
+        // A registration retry that has no upload to ride on goes out on its own
+        if (registrationDelayMs > 0 && registrationDue() && isConnected()) {
+            SnapshotHold hold(config);
+            PowerLock::acquire();
+            sendQueuedRegistration(hold.get());
+            PowerLock::release();
+        }
+        mqttClient.poll();  // Keep an idle broker connection alive
+        return;
+    }
+    if (uploadState == UploadState::BACKOFF) {
+        if (millis() - uploadWaitStart < uploadWaitMs) {
+            return;
+        }
+        uploadState = UploadState::SENDING;
+    }
 
-        if (attempt > 0) {
-            unsigned long backoffDelay = calculateBackoffDelay(attempt - 1);
-            Serial.print("[NetworkManager] Retrying in ");
-            Serial.print(backoffDelay / 1000);
-            Serial.println(" seconds...");
+    // Held for the whole attempt: the payload stream and the requests point into it
+    SnapshotHold hold(config);
+    const ConfigSnapshot& snap = hold.get();
+    const Config& cfg = snap.getConfig();
+    bool useMqtt = static_cast<UploadTransport>(cfg.uploadTransport) == UploadTransport::MQTT;
+    bool useHttps = !useMqtt && snap.isHttps() && !uploadInsecure;
+    const String& endpoint = uploadInsecure ? snap.getInsecureEndpoint() : cfg.apiEndpoint;
+
+    // Re-take the backlog view: the ring may have changed since the last attempt
+    if (!beginPayload(cfg)) {
+        finishUpload(false);
+        return;
+    }
 
-            // Feed watchdog during backoff delay
-            unsigned long backoffStart = millis();
-            while (millis() - backoffStart < backoffDelay) {
-                delay(100);
+    // Feed watchdog before HTTP attempt
 #ifndef UNIT_TEST
-                if ((millis() - backoffStart) % 1000 == 0) {
-                    esp_task_wdt_reset();
-                }
+    esp_task_wdt_reset();
 #endif
-            }
-        }
 
+    if (registrationDue()) {
+        sendQueuedRegistration(snap);
+    }
+
+    if (!uploadInsecure) {
         Serial.print("[NetworkManager] Attempt ");
-        Serial.print(attempt + 1);
+        Serial.print(uploadAttempt + 1);
         Serial.print("/");
-        Serial.println(MAX_ATTEMPTS);
+        Serial.println(MAX_UPLOAD_ATTEMPTS);
+    }
 
-        // Initialize HTTP client with appropriate transport
-        if (useHttps) {
-            // Configure WiFiClientSecure for HTTPS
-            if (cfg.tlsValidateServer) {
-                // Use certificate validation with root CA bundle
-                // ESP32 Arduino core includes a root CA bundle
-                Serial.println("[NetworkManager] TLS: Certificate validation enabled");
-                wifiClient.setCACert(NULL);  // Use built-in root CA bundle
-            } else {
-                // Skip certificate validation (insecure, for development only)
-                Serial.println("[NetworkManager] TLS: Certificate validation DISABLED (insecure)");
-                wifiClient.setInsecure();
+    AttemptOutcome outcome =
+        useMqtt ? attemptMqttUpload(snap) : attemptUpload(endpoint, useHttps, snap);
+    switch (outcome) {
+        case AttemptOutcome::SUCCESS:
+            if (uploadInsecure) {
+                Serial.println("[NetworkManager] HTTP fallback successful");
             }
+            finishUpload(true);
+            break;
 
-            httpClient.begin(wifiClient, cfg.apiEndpoint);
-        } else {
-            // Use plain HTTP
-            httpClient.begin(cfg.apiEndpoint);
-        }
+        case AttemptOutcome::RESEND:
+            // Resent on the next call, without backoff or using up an attempt
+            break;
 
-        // Set headers
-        httpClient.addHeader("Content-Type", "application/json");
+        case AttemptOutcome::FAILED:
+            finishUpload(false);
+            break;
 
-        // Add API token if configured
-        if (strlen(cfg.apiToken) > 0) {
-            httpClient.addHeader("Authorization", "Bearer " + String(cfg.apiToken));
-        }
+        case AttemptOutcome::RETRY:
+            if (uploadInsecure) {
+                Serial.print("[NetworkManager] HTTP fallback also failed: ");
+                Serial.println(uploadHttpCode);
+                dropConnection();
+                Serial.println("[NetworkManager] Failed to send data after maximum attempts");
+                finishUpload(false);
+                break;
+            }
 
-        // Set timeout
-        httpClient.setTimeout(10000);  // 10 seconds
+            uploadAttempt++;
+            if (uploadAttempt < MAX_UPLOAD_ATTEMPTS) {
+                // Exponential backoff, waited out by later calls instead of delay()
+                uploadWaitMs = calculateBackoffDelay(uploadAttempt - 1);
+                uploadWaitStart = millis();
+                uploadState = UploadState::BACKOFF;
+                Serial.print("[NetworkManager] Retrying in ");
+                Serial.print(uploadWaitMs / 1000);
+                Serial.println(" seconds...");
+            } else if (useHttps && cfg.allowHttpFallback) {
+                // If HTTPS failed and HTTP fallback is allowed, try once with HTTP
+                Serial.println("[NetworkManager] HTTPS failed all attempts");
+                Serial.println(
+                    "[NetworkManager] Attempting HTTP fallback (INSECURE - development only)");
+                uploadInsecure = true;
+            } else {
+                Serial.println("[NetworkManager] Failed to send data after maximum attempts");
+                finishUpload(false);
+            }
+            break;
+    }
+}
 
-        // Send POST request
-        int httpCode = httpClient.POST(payload);
+bool NetworkManager::beginPayload(const Config& cfg) {
+    uploadArena.reset();  // Nothing from the previous attempt is still referenced
 
-        // Check response
-        if (httpCode > 0) {
-            Serial.print("[NetworkManager] HTTP Response code: ");
-            Serial.println(httpCode);
+    // Stream the body straight from the ring through a fixed scratch buffer
+    BufferedBatch backlog = uploadSource(uploadSourceContext);
+    uploadStatus = statusManager.getStatus();
+    PayloadFormat format = static_cast<PayloadFormat>(cfg.payloadFormat);
+    if (formatRejected) {
+        format = PayloadFormat::ROWS;
+    }
+    payloadStream.begin(backlog, uploadHasCurrent ? &uploadCurrent : nullptr,
+                        cfg.deviceId.c_str(), uploadStatus, format);
+
+    // Bound the body (and the TLS write): halve the page until it fits, newer windows
+    // wait for the next upload
+    while (payloadStream.contentLength() > UPLOAD_MAX_PAYLOAD_BYTES && backlog.count() > 1) {
+        backlog = backlog.first(backlog.count() / 2);
+        payloadStream.begin(backlog, uploadHasCurrent ? &uploadCurrent : nullptr,
+                            cfg.deviceId.c_str(), uploadStatus, format);
+    }
+    uploadBacklogCount = backlog.count();
+    if (payloadStream.overflowed()) {
+        Serial.println("[NetworkManager] ERROR: Reading does not fit the payload scratch buffer");
+        statusManager.setLastError("Payload too large");
+        return false;
+    }
 
-            if (httpCode == 200 || httpCode == 201 || httpCode == 204) {
-                // Success
-                String response = httpClient.getString();
-                Serial.println("[NetworkManager] Transmission successful");
+    // MQTT has no Content-Encoding, so only HTTP bodies are compressed
+    if (static_cast<UploadTransport>(cfg.uploadTransport) == UploadTransport::MQTT) {
+        compressBody = false;
+    } else {
+        prepareCompression();
+    }
 
-                // Parse acknowledged batch IDs from response
-                std::vector<String> acknowledgedIds = parseAcknowledgedBatchIds(response);
+    Serial.print("[NetworkManager] Payload size: ");
+    Serial.print(payloadStream.contentLength());
+    Serial.print(" bytes (");
+    Serial.print(payloadFormatName(format));
+    Serial.println(")");
+    if (compressBody) {
+        Serial.printf("[NetworkManager] Compressed to %u bytes (gzip)\n",
+                      static_cast<unsigned>(gzipStream.contentLength()));
+    }
+    return true;
+}
 
-                if (!acknowledgedIds.empty()) {
-                    Serial.print("[NetworkManager] Server acknowledged ");
-                    Serial.print(acknowledgedIds.size());
-                    Serial.println(" batch(es)");
-                }
+NetworkManager::AttemptOutcome NetworkManager::attemptUpload(const String& endpoint,
+                                                             bool useHttps,
+                                                             const ConfigSnapshot& snap) {
+    const Config& cfg = snap.getConfig();
 
-                // Update system status
-                statusManager.setLastTransmitTime(timeManager.monotonicMs());
+    // Reuses the open keep-alive connection when there is one
+    beginRequest(endpoint, useHttps, cfg);
 
-                success = true;
-            } else if (httpCode >= 400 && httpCode < 500) {
-                // Client error (4xx) - don't retry, log and fail
-                Serial.print("[NetworkManager] Client error (4xx): ");
-                Serial.println(httpCode);
-                String response = httpClient.getString();
-                Serial.print("[NetworkManager] Response: ");
-                Serial.println(response);
+    // Set headers
+    httpClient.addHeader("Content-Type", payloadStream.contentType());
 
-                statusManager.incrementNetworkFailures();
-                statusManager.setLastError("HTTP " + String(httpCode));
+    // Add API token if configured
+    if (snap.getAuthHeader().length() > 0) {
+        httpClient.addHeader("Authorization", snap.getAuthHeader());
+    }
 
-                httpClient.end();
-                return false;  // Don't retry client errors
-            } else if (httpCode >= 500) {
-                // Server error (5xx) - retry with backoff
-                Serial.print("[NetworkManager] Server error (5xx): ");
-                Serial.println(httpCode);
+    // Send POST request (Content-Length from the stream's dry pass); a fresh connection
+    // is opened here first so DNS and the handshake are timed apart from the request
+    bool reusedConnection = httpClient.connected();
+    int httpCode = HTTPC_ERROR_CONNECTION_REFUSED;
+    if (reusedConnection || openConnection(useHttps, snap, HTTP_CONNECT_TIMEOUT_MS)) {
+        httpCode = timedPost();
+    }
+    uploadHttpCode = httpCode;
 
-                statusManager.incrementNetworkFailures();
-                statusManager.setLastError("HTTP " + String(httpCode));
+    if (httpCode < 0 && reusedConnection) {
+        // The server closed the idle connection: reconnect at once, no backoff
+        Serial.println("[NetworkManager] Kept-alive connection closed, reconnecting");
+        dropConnection();
+        return AttemptOutcome::RESEND;
+    }
 
-                attempt++;
-            } else {
-                // Other HTTP codes - retry
-                Serial.print("[NetworkManager] Unexpected HTTP code: ");
-                Serial.println(httpCode);
+    if (httpCode <= 0) {
+        // HTTP request failed
+        const char* errorMsg = httpErrorName(httpCode);
+        Serial.print("[NetworkManager] HTTP request failed: ");
+        Serial.println(errorMsg);
 
-                statusManager.incrementNetworkFailures();
-                attempt++;
-            }
-        } else {
-            // HTTP request failed
-            String errorMsg = httpClient.errorToString(httpCode);
-            Serial.print("[NetworkManager] HTTP request failed: ");
-            Serial.println(errorMsg);
-
-            // Check for TLS-specific errors
-            if (useHttps) {
-                if (httpCode == HTTPC_ERROR_CONNECTION_FAILED) {
-                    Serial.println("[NetworkManager] TLS: Connection failed - possible causes:");
-                    Serial.println("  - Certificate validation failed");
-                    Serial.println("  - Server unreachable");
-                    Serial.println("  - TLS handshake timeout");
-
-                    if (cfg.tlsValidateServer) {
-                        Serial.println(
-                            "[NetworkManager] TLS: Try setting tlsValidateServer=false for "
-                            "testing");
-                    }
-
-                    statusManager.setLastError("TLS connection failed");
-                } else if (httpCode == HTTPC_ERROR_READ_TIMEOUT) {
-                    Serial.println("[NetworkManager] TLS: Read timeout during handshake");
-                    statusManager.setLastError("TLS timeout");
-                } else {
-                    statusManager.setLastError("TLS error: " + errorMsg);
+        // Check for TLS-specific errors
+        if (useHttps) {
+            if (httpCode == HTTPC_ERROR_CONNECTION_FAILED) {
+                Serial.println("[NetworkManager] TLS: Connection failed - possible causes:");
+                Serial.println("  - Certificate validation failed");
+                Serial.println("  - Server unreachable");
+                Serial.println("  - TLS handshake timeout");
+
+                if (cfg.tlsValidateServer) {
+                    Serial.println(
+                        "[NetworkManager] TLS: Try setting tlsValidateServer=false for testing");
                 }
+
+                statusManager.setLastError("TLS connection failed");
+            } else if (httpCode == HTTPC_ERROR_READ_TIMEOUT) {
+                Serial.println("[NetworkManager] TLS: Read timeout during handshake");
+                statusManager.setLastError("TLS timeout");
             } else {
-                statusManager.setLastError("HTTP error: " + errorMsg);
+                statusManager.setLastError(uploadArena.format("TLS error: %s", errorMsg));
             }
-
-            statusManager.incrementNetworkFailures();
-            attempt++;
+        } else {
+            statusManager.setLastError(uploadArena.format("HTTP error: %s", errorMsg));
         }
 
-        httpClient.end();
+        statusManager.incrementNetworkFailures();
+
+        // Transport failure: the next attempt opens a fresh connection
+        dropConnection();
+        return AttemptOutcome::RETRY;
     }
 
-    if (!success) {
-        // If HTTPS failed and HTTP fallback is allowed, try once with HTTP
-        if (useHttps && cfg.allowHttpFallback) {
-            Serial.println("[NetworkManager] HTTPS failed all attempts");
+    // Check response
+    Serial.print("[NetworkManager] HTTP Response code: ");
+    Serial.println(httpCode);
+
+    AttemptOutcome outcome = AttemptOutcome::RETRY;
+    bool keepConnection = true;
+    if (httpCode == 200 || httpCode == 201 || httpCode == 204) {
+        // Success
+        Serial.println("[NetworkManager] Transmission successful");
+
+        // Scan the acknowledged and duplicate batch IDs as the body streams in
+        if (!timedReadResponse()) {
+            keepConnection = false;
+        }
+
+        if (responseScanner.batchIdCount() > 0) {
+            Serial.print("[NetworkManager] Server acknowledged ");
+            Serial.print(responseScanner.batchIdCount());
+            Serial.println(" batch(es)");
+        }
+
+        if (!responseScanner.hasAckList()) {
+            // No ID lists (empty or older server): the status code confirms the body
             Serial.println(
-                "[NetworkManager] Attempting HTTP fallback (INSECURE - development only)");
+                "[NetworkManager] No acknowledged_batch_ids in response, assuming success");
+            uploadAckedCount = uploadBacklogCount;
+            uploadCurrentAcked = uploadHasCurrent;
+        } else {
+            // Duplicates were stored by an earlier upload, so they count as confirmed
+            matchAcknowledgements();
+        }
 
-            // Convert https:// to http://
-            String httpEndpoint = cfg.apiEndpoint;
-            httpEndpoint.replace("https://", "http://");
+        // Update system status
+        statusManager.setLastTransmitTime(timeManager.monotonicMs());
+
+        outcome = AttemptOutcome::SUCCESS;
+    } else if ((httpCode == 400 || httpCode == 415) && compressBody) {
+        // Servers without gzip support fail to parse the body: send uncompressed
+        // until the next reboot (a format rejection then shows on the resend)
+        Serial.println("[NetworkManager] gzip body rejected, resending uncompressed");
+        discardResponse();
+        gzipRejected = true;
+        outcome = AttemptOutcome::RESEND;
+    } else if ((httpCode == 400 || httpCode == 415) &&
+               payloadStream.getFormat() != PayloadFormat::ROWS) {
+        // Server does not accept this format: use rows until the next reboot
+        Serial.printf("[NetworkManager] %s payload rejected, resending as rows\n",
+                      payloadFormatName(payloadStream.getFormat()));
+        discardResponse();
+        formatRejected = true;
+        outcome = AttemptOutcome::RESEND;
+    } else if (httpCode >= 400 && httpCode < 500) {
+        // Client error (4xx) - don't retry, log and fail
+        Serial.print("[NetworkManager] Client error (4xx): ");
+        Serial.println(httpCode);
+        const char* response = discardResponse();
+        Serial.print("[NetworkManager] Response: ");
+        Serial.println(response);
 
-            // Try HTTP once
-            httpClient.begin(httpEndpoint);
-            httpClient.addHeader("Content-Type", "application/json");
+        statusManager.incrementNetworkFailures();
+        statusManager.setLastError(uploadArena.format("HTTP %d", httpCode));
 
-            if (strlen(cfg.apiToken) > 0) {
-                httpClient.addHeader("Authorization", "Bearer " + String(cfg.apiToken));
-            }
+        outcome = AttemptOutcome::FAILED;  // Don't retry client errors
+    } else if (httpCode >= 500) {
+        // Server error (5xx) - retry with backoff
+        Serial.print("[NetworkManager] Server error (5xx): ");
+        Serial.println(httpCode);
 
-            httpClient.setTimeout(10000);
-            int httpCode = httpClient.POST(payload);
+        statusManager.incrementNetworkFailures();
+        statusManager.setLastError(uploadArena.format("HTTP %d", httpCode));
+    } else {
+        // Other HTTP codes - retry
+        Serial.print("[NetworkManager] Unexpected HTTP code: ");
+        Serial.println(httpCode);
 
-            if (httpCode == 200 || httpCode == 201 || httpCode == 204) {
-                Serial.println("[NetworkManager] HTTP fallback successful");
-                String response = httpClient.getString();
+        statusManager.incrementNetworkFailures();
+    }
 
-                std::vector<String> acknowledgedIds = parseAcknowledgedBatchIds(response);
-                if (!acknowledgedIds.empty()) {
-                    Serial.print("[NetworkManager] Server acknowledged ");
-                    Serial.print(acknowledgedIds.size());
-                    Serial.println(" batch(es)");
-                }
+    if (keepConnection) {
+        httpClient.end();  // Keeps the socket open for reuse
+    } else {
+        dropConnection();  // Part of the body is still unread
+    }
+    return outcome;
+}
 
-                statusManager.setLastTransmitTime(timeManager.monotonicMs());
-                httpClient.end();
-                return true;
+NetworkManager::AttemptOutcome NetworkManager::attemptMqttUpload(const ConfigSnapshot& snap) {
+    const Config& cfg = snap.getConfig();
+    if (snap.getMqttHost().length() == 0) {
+        Serial.println("[NetworkManager] ERROR: Invalid MQTT URL");
+        statusManager.setLastError("Invalid MQTT URL");
+        return AttemptOutcome::FAILED;
+    }
+
+    if (!mqttClient.connected()) {
+        // Own clients: the HTTP connection stays free for registration
+        bool useTls = snap.isMqttTls();
+        if (useTls) {
+            if (cfg.tlsValidateServer) {
+                mqttSecureClient.setCACert(NULL);  // Use built-in root CA bundle
             } else {
-                Serial.print("[NetworkManager] HTTP fallback also failed: ");
-                Serial.println(httpCode);
-                httpClient.end();
+                mqttSecureClient.setInsecure();
             }
         }
+        WiFiClient& transport = useTls ? mqttSecureClient : mqttPlainClient;
+
+        // Same credentials as HTTP: device ID as user name, API token as password
+        if (!mqttClient.connect(transport, snap.getMqttHost().c_str(), snap.getMqttPort(),
+                                cfg.deviceId.c_str(), cfg.deviceId.c_str(),
+                                cfg.apiToken.c_str())) {
+            statusManager.incrementNetworkFailures();
+            statusManager.setLastError("MQTT connect failed");
+            return AttemptOutcome::RETRY;
+        }
+    }
+
+    // A retry of this upload resends the same packet ID, so the broker can drop it
+    MqttClient::Result result =
+        mqttClient.publish(snap.getMqttTopic().c_str(), payloadStream, uploadAttempt > 0);
+    uploadHttpCode = 0;
+    if (result == MqttClient::Result::ACKED) {
+        // PUBACK covers the whole message
+        Serial.println("[NetworkManager] Transmission successful (PUBACK)");
+        uploadAckedCount = uploadBacklogCount;
+        uploadCurrentAcked = uploadHasCurrent;
+        return AttemptOutcome::SUCCESS;
+    }
+
+    Serial.println(result == MqttClient::Result::TIMEOUT
+                       ? "[NetworkManager] MQTT: No PUBACK before timeout"
+                       : "[NetworkManager] MQTT: Connection lost while publishing");
+    statusManager.incrementNetworkFailures();
+    statusManager.setLastError("MQTT publish failed");
+    mqttClient.stop();  // Reconnect; the persistent session keeps the message in flight
+    return AttemptOutcome::RETRY;
+}
+
+void NetworkManager::finishUpload(bool success) {
+    if (uploadState != UploadState::IDLE) {
+        PowerLock::release();
+    }
+    uploadState = UploadState::IDLE;
+    applyPowerSave();
+    if (success) {
+        noteConnectivity(true);  // Real traffic got through: no probe needed
+        if (uploadStatus.bootProfilePending) {
+            statusManager.markBootProfileSent();
+        }
+        if (uploadStatus.postMortemPending) {
+            statusManager.markPostMortemSent();
+            ErrorLogger::clearPostMortem();
+        }
+        if (uploadStatus.metricsDue) {
+            statusManager.markMetricsSent(uploadStatus);
+        }
+    } else {
+        invalidateConnectivity();
+    }
+
+    UploadResult result;
+    result.success = success;
+    result.httpCode = uploadHttpCode;
+    result.backlogCount = uploadBacklogCount;
+    result.ackedCount = success ? uploadAckedCount : 0;
+    result.currentAcked = success && uploadCurrentAcked;
+    result.current = uploadHasCurrent ? &uploadCurrent : nullptr;
+    if (uploadCallback) {
+        // The callback may start the next upload
+        uploadCallback(result, uploadCallbackContext);
+    }
+}
+
+bool NetworkManager::prewarmConnection() {
+    if (!isConnected() || uploadState != UploadState::IDLE) {
+        return false;
+    }
+
+    SnapshotHold hold(config);
+    const ConfigSnapshot& snap = hold.get();
+    unsigned long start = millis();
+    if (!openConnection(snap.isHttps(), snap, PREWARM_CONNECT_TIMEOUT_MS)) {
+        Serial.println("[NetworkManager] Pre-warm connect failed");
+        return false;
+    }
+    Serial.printf("[NetworkManager] Connection pre-warmed in %lu ms\n", millis() - start);
+    return true;
+}
+
+bool NetworkManager::openConnection(bool useHttps, const ConfigSnapshot& snap,
+                                    int32_t timeoutMs) {
+    WiFiClient& client = useHttps ? wifiClient : plainClient;
+    if (client.connected()) {
+        return true;  // Kept-alive connection still open
+    }
+
+    if (!snap.hasEndpoint()) {
+        return false;
+    }
+    const String& host = snap.getHost();
+    uint16_t port = snap.getPort(useHttps);
+    if (useHttps) {
+        configureTls(snap.getConfig());
+    }
+
+    // Feed watchdog before the DNS lookup and handshake
+#ifndef UNIT_TEST
+    esp_task_wdt_reset();
+#endif
 
-        Serial.println("[NetworkManager] Failed to send data after maximum attempts");
+    // Resolve first so the lookup is timed on its own; connect() below then hits the
+    // lwIP DNS cache (and still gets the host name for SNI and certificate checks)
+    IPAddress address;
+    unsigned long start = micros();
+    if (!WiFi.hostByName(host.c_str(), address)) {
+        Serial.printf("[NetworkManager] DNS lookup of %s failed\n", host.c_str());
         return false;
     }
+    statusManager.recordNetworkPhase(NET_PHASE_DNS, micros() - start);
 
+    // HTTPClient::sendRequest() finds the client connected and reuses it
+    start = micros();
+    if (!client.connect(host.c_str(), port, timeoutMs)) {
+        Serial.printf("[NetworkManager] Connect to %s:%u failed\n", host.c_str(), port);
+        client.stop();
+        return false;
+    }
+    statusManager.recordNetworkPhase(NET_PHASE_CONNECT, micros() - start);
     return true;
 }
 
+int NetworkManager::timedPost() {
+    unsigned long start = micros();
+    int httpCode = postPayload();
+    statusManager.recordNetworkPhase(NET_PHASE_REQUEST, micros() - start);
+    statusManager.addNetworkBytes(compressBody ? gzipStream.contentLength()
+                                               : payloadStream.contentLength(),
+                                  0);
+    return httpCode;
+}
+
+bool NetworkManager::timedReadResponse() {
+    unsigned long start = micros();
+    bool complete = readResponse();
+    statusManager.recordNetworkPhase(NET_PHASE_RESPONSE, micros() - start);
+    statusManager.addNetworkBytes(0, responseScanner.bytesReceived());
+    return complete;
+}
+
+void NetworkManager::configureTls(const Config& cfg) {
+    if (!tlsConfigured || tlsValidating != cfg.tlsValidateServer) {
+        // Trust settings are applied once; changing them forces a fresh handshake
+        wifiClient.stop();
+        if (cfg.tlsValidateServer) {
+            // Use certificate validation with root CA bundle
+            Serial.println("[NetworkManager] TLS: Certificate validation enabled");
+            wifiClient.setCACert(NULL);  // Use built-in root CA bundle
+        } else {
+            // Skip certificate validation (insecure, for development only)
+            Serial.println("[NetworkManager] TLS: Certificate validation DISABLED (insecure)");
+            wifiClient.setInsecure();
+        }
+        tlsConfigured = true;
+        tlsValidating = cfg.tlsValidateServer;
+    }
+}
+
+bool NetworkManager::beginRequest(const String& url, bool useHttps, const Config& cfg) {
+    if (useHttps) {
+        configureTls(cfg);
+    }
+
+    // Keep-alive: end() leaves the socket (and its TLS session) open, and begin() on the
+    // same host and port picks it up again without a new handshake
+    httpClient.setReuse(true);
+    bool ok = useHttps ? httpClient.begin(wifiClient, url) : httpClient.begin(plainClient, url);
+    httpClient.setTimeout(10000);  // 10 seconds
+    return ok;
+}
+
+void NetworkManager::dropConnection() {
+    httpClient.end();
+    wifiClient.stop();
+    plainClient.stop();
+}
+
+void NetworkManager::noteConnectivity(bool ok) {
+    connectivityKnown = true;
+    connectivityOk = ok;
+    connectivityAtMs = millis();
+}
+
 bool NetworkManager::verifyInternetConnectivity() {
     // Optional verification - WiFi connected is sufficient
     // This method can be used for additional verification if needed
 
-    if (WiFi.status() != WL_CONNECTED) {
+    if (!isConnected()) {
         return false;
     }
 
+    // Verdict from the probe or a backend response a moment ago
+    if (connectivityKnown && millis() - connectivityAtMs < CONNECTIVITY_TTL_MS) {
+        return connectivityOk;
+    }
+
     Serial.println("[NetworkManager] Verifying internet connectivity...");
 
     HTTPClient http;
@@ -455,7 +981,8 @@ bool NetworkManager::verifyInternetConnectivity() {
     int httpCode = http.GET();
     http.end();
 
-    if (httpCode == 204 || httpCode == 200) {
+    noteConnectivity(httpCode == 204 || httpCode == 200);
+    if (connectivityOk) {
         Serial.println("[NetworkManager] Internet connectivity verified");
         return true;
     } else {
@@ -465,209 +992,123 @@ bool NetworkManager::verifyInternetConnectivity() {
     }
 }
 
+#ifdef UNIT_TEST
 String NetworkManager::formatJsonPayload(const std::vector<AveragedData>& dataList) {
     if (dataList.empty()) {
         return "{}";
     }
 
-    Config cfg = config.getConfig();
+    SnapshotHold hold(config);
+    const Config& cfg = hold.getConfig();
     SystemStatus status = statusManager.getStatus();
 
-    String json = "{";
-    json += "\"device_id\":\"" + String(cfg.deviceId) + "\",";
-    json += "\"readings\":[";
+    // Same fragments the upload stream produces, collected into one String
+    std::vector<char> scratch(PAYLOAD_SCRATCH_SIZE);
+    PayloadStream::formatHeader(scratch.data(), scratch.size(), cfg.deviceId.c_str());
+    String json = scratch.data();
 
     for (size_t i = 0; i < dataList.size(); i++) {
-        const AveragedData& data = dataList[i];
-
         if (i > 0)
             json += ",";
-        json += "{";
-
-        // Batch ID
-        json += "\"batch_id\":\"" + String(data.batchId) + "\",";
-
-        // Device ID
-        json += "\"device_id\":\"" + String(cfg.deviceId) + "\",";
-
-        // Epoch timestamps (nullable when not synced)
-        if (data.timeSynced && data.sampleStartEpochMs > 0) {
-            json +=
-                "\"sample_start_epoch_ms\":" + String((unsigned long long)data.sampleStartEpochMs) +
-                ",";
-            json += "\"sample_end_epoch_ms\":" + String((unsigned long long)data.sampleEndEpochMs) +
-                    ",";
-            json +=
-                "\"device_boot_epoch_ms\":" + String((unsigned long long)data.deviceBootEpochMs) +
-                ",";
-        } else {
-            json += "\"sample_start_epoch_ms\":0,";
-            json += "\"sample_end_epoch_ms\":0,";
-            json += "\"device_boot_epoch_ms\":0,";
-        }
-
-        // Uptime timestamps (always present)
-        json += "\"sample_start_uptime_ms\":" + String(data.sampleStartUptimeMs) + ",";
-        json += "\"sample_end_uptime_ms\":" + String(data.sampleEndUptimeMs) + ",";
-        json += "\"uptime_ms\":" + String(data.uptimeMs) + ",";
-
-        // Metadata
-        json += "\"sample_count\":" + String(data.sampleCount) + ",";
-        json += "\"time_synced\":" + String(data.timeSynced ? "true" : "false") + ",";
-
-        // Sensor readings (null if sensor unavailable)
-        json += "\"sensors\":{";
-
-        // BME280 temperature
-        if (data.sensorStatus & (1 << static_cast<uint8_t>(SensorType::BME280_TEMP))) {
-            json += "\"bme280_temp_c\":" + String(data.avgBme280Temp, 2);
-        } else {
-            json += "\"bme280_temp_c\":null";
-        }
-        json += ",";
-
-        // DS18B20 temperature
-        if (data.sensorStatus & (1 << static_cast<uint8_t>(SensorType::DS18B20_TEMP))) {
-            json += "\"ds18b20_temp_c\":" + String(data.avgDs18b20Temp, 2);
-        } else {
-            json += "\"ds18b20_temp_c\":null";
-        }
-        json += ",";
-
-        // Humidity
-        if (data.sensorStatus & (1 << static_cast<uint8_t>(SensorType::HUMIDITY))) {
-            json += "\"humidity_pct\":" + String(data.avgHumidity, 2);
-        } else {
-            json += "\"humidity_pct\":null";
-        }
-        json += ",";
-
-        // Pressure
-        if (data.sensorStatus & (1 << static_cast<uint8_t>(SensorType::PRESSURE))) {
-            json += "\"pressure_hpa\":" + String(data.avgPressure, 2);
-        } else {
-            json += "\"pressure_hpa\":null";
-        }
-        json += ",";
+        PayloadStream::formatReading(scratch.data(), scratch.size(), dataList[i],
+                                     cfg.deviceId.c_str());
+        json += scratch.data();
+    }
 
-        // Soil moisture
-        if (data.sensorStatus & (1 << static_cast<uint8_t>(SensorType::SOIL_MOISTURE))) {
-            json += "\"soil_moisture_pct\":" + String(data.avgSoilMoisture, 2);
-        } else {
-            json += "\"soil_moisture_pct\":null";
-        }
+    json += "]";
+    if (status.metricsDue) {
+        PayloadStream::formatMetrics(scratch.data(), scratch.size(), status);
+        json += scratch.data();
+    }
+    json += "}";
+    return json;
+}
 
-        json += "},";  // End sensors
-
-        // Sensor status flags
-        json += "\"sensor_status\":{";
-        json += "\"bme280\":\"" +
-                String((data.sensorStatus & (1 << static_cast<uint8_t>(SensorType::BME280_TEMP)))
-                           ? "ok"
-                           : "unavailable") +
-                "\",";
-        json += "\"ds18b20\":\"" +
-                String((data.sensorStatus & (1 << static_cast<uint8_t>(SensorType::DS18B20_TEMP)))
-                           ? "ok"
-                           : "unavailable") +
-                "\",";
-        json += "\"soil_moisture\":\"" +
-                String((data.sensorStatus & (1 << static_cast<uint8_t>(SensorType::SOIL_MOISTURE)))
-                           ? "ok"
-                           : "unavailable") +
-                "\"";
-        json += "},";  // End sensor_status
-
-        // Health metrics (only include in last reading to avoid duplication)
-        if (i == dataList.size() - 1) {
-            json += "\"health\":{";
-            json += "\"uptime_ms\":" + String(status.uptimeMs) + ",";
-            json += "\"free_heap_bytes\":" + String(status.freeHeap) + ",";
-            json += "\"wifi_rssi_dbm\":" + String(status.wifiRssi) + ",";
-            json += "\"error_counters\":{";
-            json += "\"sensor_read_failures\":" + String(status.errors.sensorReadFailures) + ",";
-            json += "\"network_failures\":" + String(status.errors.networkFailures) + ",";
-            json += "\"buffer_overflows\":" + String(status.errors.bufferOverflows);
-            json += "}";  // End error_counters
-            json += "}";  // End health
-        } else {
-            // For non-last readings, include minimal health info
-            json += "\"health\":{";
-            json += "\"uptime_ms\":" + String(data.uptimeMs);
-            json += "}";
-        }
+#endif
 
-        json += "}";  // End reading
+String NetworkManager::formatJsonPayload(const BufferedBatch& backlog,
+                                         const AveragedData* current) {
+    if (backlog.count() == 0 && !current) {
+        return "{}";
     }
 
-    json += "]";  // End readings
-    json += "}";  // End root
-
+    SnapshotHold hold(config);
+    const Config& cfg = hold.getConfig();
+    SystemStatus status = statusManager.getStatus();
+    payloadStream.begin(backlog, current, cfg.deviceId.c_str(), status);
+
+    String json;
+    json.reserve(payloadStream.contentLength());
+    char chunk[128];
+    size_t length;
+    while ((length = payloadStream.readBytes(chunk, sizeof(chunk) - 1)) > 0) {
+        chunk[length] = '\0';
+        json += chunk;
+    }
     return json;
 }
 
+#ifdef UNIT_TEST
 std::vector<String> NetworkManager::parseAcknowledgedBatchIds(const String& response) {
-    std::vector<String> batchIds;
+    // Feeds a complete body through the streaming scanner, for tests and diagnostics
+    responseScanner.reset();
+    responseScanner.write(reinterpret_cast<const uint8_t*>(response.c_str()), response.length());
 
-    if (response.length() == 0) {
-        return batchIds;
+    std::vector<String> batchIds;
+    for (uint16_t i = 0; i < responseScanner.batchIdCount(); i++) {
+        batchIds.push_back(String(responseScanner.batchId(i)));
     }
+    return batchIds;
+}
 
-    // Look for "acknowledged_batch_ids" array in JSON response
-    // Simple parsing without full JSON library to save memory
-    int arrayStart = response.indexOf("\"acknowledged_batch_ids\"");
-    if (arrayStart == -1) {
-        // No acknowledged_batch_ids field - assume all sent data was acknowledged
-        Serial.println("[NetworkManager] No acknowledged_batch_ids in response, assuming success");
-        return batchIds;
-    }
+#endif
 
-    // Find the opening bracket of the array
-    int bracketStart = response.indexOf('[', arrayStart);
-    if (bracketStart == -1) {
-        Serial.println("[NetworkManager] Malformed acknowledged_batch_ids array");
-        return batchIds;
+bool NetworkManager::readResponse() {
+    responseScanner.reset();
+    if (httpClient.getSize() == 0) {
+        return true;  // 204 or an empty body
     }
 
-    // Find the closing bracket of the array
-    int bracketEnd = response.indexOf(']', bracketStart);
-    if (bracketEnd == -1) {
-        Serial.println(
-            "[NetworkManager] Malformed acknowledged_batch_ids array (no closing bracket)");
-        return batchIds;
+    // writeToStream() undoes chunked encoding; the scanner refuses bytes past its cap
+    int written = httpClient.writeToStream(&responseScanner);
+    if (written < 0 || responseScanner.truncated()) {
+        Serial.println("[NetworkManager] Response too large or cut short, parsed in part");
+        return false;
     }
+    return true;
+}
 
-    // Extract the array content
-    String arrayContent = response.substring(bracketStart + 1, bracketEnd);
-    arrayContent.trim();
-
-    if (arrayContent.length() == 0) {
-        // Empty array
-        return batchIds;
+const char* NetworkManager::discardResponse() {
+    char* text = static_cast<char*>(uploadArena.allocate(RESPONSE_LOG_BYTES + 1, 1));
+    BodyCapture capture(text, text ? RESPONSE_LOG_BYTES + 1 : 0);
+    if (httpClient.getSize() != 0) {
+        httpClient.writeToStream(&capture);
     }
+    return text ? text : "";
+}
 
-    // Parse individual batch IDs (quoted strings separated by commas)
-    int pos = 0;
-    while (pos < arrayContent.length()) {
-        // Find opening quote
-        int quoteStart = arrayContent.indexOf('"', pos);
-        if (quoteStart == -1)
-            break;
-
-        // Find closing quote
-        int quoteEnd = arrayContent.indexOf('"', quoteStart + 1);
-        if (quoteEnd == -1)
+void NetworkManager::matchAcknowledgements() {
+    // Count the confirmed prefix only: the caller acks by sequence watermark, so
+    // anything after the first gap is resent (and reported as a duplicate if stored)
+    BufferedBatch sent = uploadSource(uploadSourceContext).first(uploadBacklogCount);
+    AveragedData entry;
+    uploadAckedCount = 0;
+    while (uploadAckedCount < sent.count()) {
+        DataManager::unpackAveragedData(sent.at(uploadAckedCount), entry);
+        if (!responseScanner.containsBatchId(entry.batchId)) {
             break;
-
-        // Extract batch ID
-        String batchId = arrayContent.substring(quoteStart + 1, quoteEnd);
-        batchIds.push_back(batchId);
-
-        // Move to next potential batch ID
-        pos = quoteEnd + 1;
+        }
+        uploadAckedCount++;
+    }
+    uploadCurrentAcked =
+        uploadHasCurrent && responseScanner.containsBatchId(uploadCurrent.batchId);
+
+    if (uploadAckedCount < uploadBacklogCount ||
+        (uploadHasCurrent && !uploadCurrentAcked)) {
+        Serial.printf("[NetworkManager] Server confirmed %u of %u reading(s)\n",
+                      uploadAckedCount + (uploadCurrentAcked ? 1 : 0),
+                      uploadBacklogCount + (uploadHasCurrent ? 1 : 0));
     }
-
-    return batchIds;
 }
 
 unsigned long NetworkManager::calculateBackoffDelay(uint8_t attempt) {
@@ -679,55 +1120,35 @@ unsigned long NetworkManager::calculateBackoffDelay(uint8_t attempt) {
     return 1000 * (1 << attempt);  // 2^attempt seconds in milliseconds
 }
 
-String NetworkManager::getRegistrationEndpoint() {
-    Config cfg = config.getConfig();
-    return deriveEndpoint(String(cfg.apiEndpoint));
-}
-
-String NetworkManager::deriveEndpoint(const String& dataEndpoint) {
-    String endpoint = dataEndpoint;
-
-    // Strip trailing slashes
-    while (endpoint.endsWith("/")) {
-        endpoint = endpoint.substring(0, endpoint.length() - 1);
-    }
-
-    // Remove query string and fragment at earliest occurrence
-    int queryPos = endpoint.indexOf('?');
-    int fragmentPos = endpoint.indexOf('#');
-    int cutPos = -1;
-
-    if (queryPos != -1 && fragmentPos != -1) {
-        cutPos = min(queryPos, fragmentPos);
-    } else if (queryPos != -1) {
-        cutPos = queryPos;
-    } else if (fragmentPos != -1) {
-        cutPos = fragmentPos;
-    }
-
-    if (cutPos != -1) {
-        endpoint = endpoint.substring(0, cutPos);
-    }
-
-    // Find the last '/' in the path
-    int lastSlash = endpoint.lastIndexOf('/');
-
-    if (lastSlash == -1) {
-        // No path, append /register
-        return endpoint + "/register";
+void NetworkManager::prepareCompression() {
+    compressBody = !gzipRejected && payloadStream.contentLength() > GZIP_MIN_PAYLOAD_BYTES;
+    if (compressBody) {
+        gzipStream.begin(payloadStream);
     }
+}
 
-    // Check if last slash is part of protocol (http://)
-    if (lastSlash < 8) {
-        // No path after domain, append /register
-        return endpoint + "/register";
+int NetworkManager::postPayload() {
+    if (compressBody) {
+        httpClient.addHeader("Content-Encoding", "gzip");
+        gzipStream.rewind();  // Rewinds payloadStream too
+        return httpClient.sendRequest("POST", &gzipStream, gzipStream.contentLength());
     }
+    payloadStream.rewind();
+    return httpClient.sendRequest("POST", &payloadStream, payloadStream.contentLength());
+}
 
-    // Replace last segment with "register"
-    return endpoint.substring(0, lastSlash + 1) + "register";
+String NetworkManager::getRegistrationEndpoint() {
+    SnapshotHold hold(config);
+    return hold.get().getRegistrationUrl();
 }
 
 RegistrationResult NetworkManager::registerDevice(const String& payload) {
+    SnapshotHold hold(config);
+    return registerDevice(payload, hold.get());
+}
+
+RegistrationResult NetworkManager::registerDevice(const String& payload,
+                                                  const ConfigSnapshot& snap) {
     RegistrationResult result;
     result.statusCode = 0;
     result.confirmationId = "";
@@ -739,7 +1160,7 @@ RegistrationResult NetworkManager::registerDevice(const String& payload) {
         return result;
     }
 
-    Config cfg = config.getConfig();
+    const Config& cfg = snap.getConfig();
 
     // Validate API endpoint
     if (strlen(cfg.apiEndpoint) == 0) {
@@ -748,13 +1169,13 @@ RegistrationResult NetworkManager::registerDevice(const String& payload) {
     }
 
     // Get registration endpoint
-    String registrationEndpoint = getRegistrationEndpoint();
+    const String& registrationEndpoint = snap.getRegistrationUrl();
 
     Serial.printf("[NetworkManager] Registering device at: %s\n", registrationEndpoint.c_str());
     Serial.printf("[NetworkManager] Payload size: %d bytes\n", payload.length());
 
     // Determine if endpoint is HTTPS
-    bool useHttps = registrationEndpoint.startsWith("https://");
+    bool useHttps = snap.isHttps();
 
     if (useHttps) {
         Serial.printf("[NetworkManager] Using HTTPS with TLS\n");
@@ -767,22 +1188,8 @@ RegistrationResult NetworkManager::registerDevice(const String& payload) {
     esp_task_wdt_reset();
 #endif
 
-    // Initialize HTTP client with appropriate transport
-    if (useHttps) {
-        // Configure WiFiClientSecure for HTTPS
-        if (cfg.tlsValidateServer) {
-            Serial.printf("[NetworkManager] TLS: Certificate validation enabled\n");
-            wifiClient.setCACert(NULL);  // Use built-in root CA bundle
-        } else {
-            Serial.printf("[NetworkManager] TLS: Certificate validation DISABLED (insecure)\n");
-            wifiClient.setInsecure();
-        }
-
-        httpClient.begin(wifiClient, registrationEndpoint);
-    } else {
-        // Use plain HTTP
-        httpClient.begin(registrationEndpoint);
-    }
+    // Same host as the data endpoint, so the upload connection is reused
+    beginRequest(registrationEndpoint, useHttps, cfg);
 
     // Set headers
     httpClient.addHeader("Content-Type", "application/json");
@@ -792,16 +1199,20 @@ RegistrationResult NetworkManager::registerDevice(const String& payload) {
         httpClient.addHeader("X-API-Key", String(cfg.apiToken));
     }
 
-    // Set timeout to 10 seconds for registration
-    httpClient.setTimeout(10000);
-
     // Send POST request
-    int httpCode = httpClient.POST(payload);
+    int httpCode = HTTPC_ERROR_CONNECTION_REFUSED;
+    if (openConnection(useHttps, snap, HTTP_CONNECT_TIMEOUT_MS)) {
+        unsigned long start = micros();
+        httpCode = httpClient.POST(payload);
+        statusManager.recordNetworkPhase(NET_PHASE_REQUEST, micros() - start);
+        statusManager.addNetworkBytes(payload.length(), 0);
+    }
 
     result.statusCode = httpCode;
 
     // Check response
     if (httpCode > 0) {
+        noteConnectivity(true);  // The backend answered
         Serial.printf("[NetworkManager] Registration HTTP Response code: %d\n", httpCode);
 
         // Determine if we should retry based on status code BEFORE parsing response
@@ -811,10 +1222,12 @@ RegistrationResult NetworkManager::registerDevice(const String& payload) {
         }
 
         if (httpCode == 200 || httpCode == 201) {
-            // Success - try to parse response
-            String response = httpClient.getString();
+            // Success - scan the body for confirmation_id as it streams in
+            if (!timedReadResponse()) {
+                dropConnection();
+            }
 
-            if (parseRegistrationResponse(response, result.confirmationId)) {
+            if (parseRegistrationResponse(result.confirmationId)) {
                 Serial.printf("[NetworkManager] Registration successful. Confirmation ID: %s\n",
                               result.confirmationId.c_str());
             } else {
@@ -828,20 +1241,25 @@ RegistrationResult NetworkManager::registerDevice(const String& payload) {
             Serial.printf("[NetworkManager] Response: %s\n", response.c_str());
 
             statusManager.incrementNetworkFailures();
-            statusManager.setLastError("Registration HTTP " + String(httpCode));
+            TextBuffer<32> error;
+            error.appendf("Registration HTTP %d", httpCode);
+            statusManager.setLastError(error.c_str());
         } else if (httpCode >= 500) {
             // Server error (5xx) - retry with backoff
             Serial.printf("[NetworkManager] Registration server error (5xx): %d\n", httpCode);
 
             statusManager.incrementNetworkFailures();
-            statusManager.setLastError("Registration HTTP " + String(httpCode));
+            TextBuffer<32> error;
+            error.appendf("Registration HTTP %d", httpCode);
+            statusManager.setLastError(error.c_str());
         }
     } else {
         // HTTP request failed - network error, should retry
         result.shouldRetry = true;
+        invalidateConnectivity();
 
-        String errorMsg = httpClient.errorToString(httpCode);
-        Serial.printf("[NetworkManager] Registration HTTP request failed: %s\n", errorMsg.c_str());
+        const char* errorMsg = httpErrorName(httpCode);
+        Serial.printf("[NetworkManager] Registration HTTP request failed: %s\n", errorMsg);
 
         // Check for TLS-specific errors
         if (useHttps) {
@@ -852,60 +1270,74 @@ RegistrationResult NetworkManager::registerDevice(const String& payload) {
                 Serial.printf("[NetworkManager] TLS: Read timeout during registration\n");
                 statusManager.setLastError("Registration TLS timeout");
             } else {
-                statusManager.setLastError("Registration TLS error: " + errorMsg);
+                TextBuffer<64> error;
+                error.appendf("Registration TLS error: %s", errorMsg);
+                statusManager.setLastError(error.c_str());
             }
         } else {
-            statusManager.setLastError("Registration HTTP error: " + errorMsg);
+            TextBuffer<64> error;
+            error.appendf("Registration HTTP error: %s", errorMsg);
+            statusManager.setLastError(error.c_str());
         }
 
         statusManager.incrementNetworkFailures();
+        dropConnection();
+        return result;
     }
 
-    httpClient.end();
+    httpClient.end();  // Keeps the socket open for reuse
 
     return result;
 }
 
-bool NetworkManager::parseRegistrationResponse(const String& response, String& confirmationId) {
-    confirmationId = "";
-
-    if (response.length() == 0) {
-        Serial.printf("[NetworkManager] Empty registration response\n");
+bool NetworkManager::queueRegistration(const String& payload,
+                                       UploadRegistrationCallback onComplete, void* context,
+                                       unsigned long retryDelayMs) {
+    if (registrationQueued.load(std::memory_order_acquire)) {
         return false;
     }
-
-    // Look for "confirmation_id" field in JSON response
-    int fieldStart = response.indexOf("\"confirmation_id\"");
-    if (fieldStart == -1) {
-        Serial.printf("[NetworkManager] Missing confirmation_id field in response\n");
-        return false;
+    registrationPayload = payload;
+    registrationCallback = onComplete;
+    registrationCallbackContext = context;
+    registrationQueuedAt = millis();
+    registrationDelayMs = retryDelayMs;
+    registrationQueued.store(true, std::memory_order_release);
+    if (retryDelayMs > 0) {
+        Serial.printf("[NetworkManager] Registration retry scheduled in %lu ms\n", retryDelayMs);
+    } else {
+        Serial.println("[NetworkManager] Registration queued for the next upload");
     }
+    return true;
+}
 
-    // Find the colon after the field name
-    int colonPos = response.indexOf(':', fieldStart);
-    if (colonPos == -1) {
-        Serial.printf("[NetworkManager] Malformed JSON: missing colon after confirmation_id\n");
-        return false;
-    }
+bool NetworkManager::registrationDue() const {
+    return registrationQueued.load(std::memory_order_acquire) &&
+           millis() - registrationQueuedAt >= registrationDelayMs;
+}
 
-    // Find the opening quote of the value
-    int quoteStart = response.indexOf('"', colonPos);
-    if (quoteStart == -1) {
-        Serial.printf(
-            "[NetworkManager] Malformed JSON: missing opening quote for confirmation_id value\n");
-        return false;
+void NetworkManager::sendQueuedRegistration(const ConfigSnapshot& snap) {
+    // Opens (or reuses) the connection an upload attempt right after posts on
+    RegistrationResult result = registerDevice(registrationPayload, snap);
+
+    // Unqueue first: the callback may schedule the retry
+    UploadRegistrationCallback callback = registrationCallback;
+    void* context = registrationCallbackContext;
+    registrationPayload = "";
+    registrationQueued.store(false, std::memory_order_release);
+    if (callback) {
+        callback(result, context);
     }
+}
 
-    // Find the closing quote of the value
-    int quoteEnd = response.indexOf('"', quoteStart + 1);
-    if (quoteEnd == -1) {
-        Serial.printf(
-            "[NetworkManager] Malformed JSON: missing closing quote for confirmation_id value\n");
+bool NetworkManager::parseRegistrationResponse(String& confirmationId) {
+    confirmationId = "";
+
+    if (!responseScanner.hasConfirmationId()) {
+        Serial.printf("[NetworkManager] Missing confirmation_id field in response\n");
         return false;
     }
 
-    // Extract confirmation_id
-    String extractedId = response.substring(quoteStart + 1, quoteEnd);
+    String extractedId = responseScanner.confirmationId();
 
     // Validate as UUID v4 using BootId utility
     if (!BootId::isValidUuid(extractedId)) {
@@ -0,0 +1,208 @@
+#ifndef UNIT_TEST
+#include "NetworkTask.h"
+
+#include <esp_task_wdt.h>
+
+#include "TaskMonitor.h"
+
+NetworkTask::NetworkTask(NetworkManager& networkManager)
+    : network(networkManager),
+      page(),
+      pageCount(0),
+      pageCurrent(),
+      pageHasCurrent(false),
+      uploadInFlight(false),
+      takenCurrent(),
+      requestedRadioMode(RadioMode::ACTIVE),
+      taskHandle(nullptr),
+      resultHandle(nullptr) {}
+
+NetworkTask::~NetworkTask() {
+    stop();
+}
+
+bool NetworkTask::start() {
+    if (taskHandle) {
+        return true;
+    }
+
+    requestedRadioMode = network.getRadioMode();
+    resultHandle = xTaskGetCurrentTaskHandle();
+    BaseType_t result = xTaskCreatePinnedToCore(&NetworkTask::taskEntry, "network", STACK_SIZE,
+                                                this, TASK_PRIORITY, &taskHandle, TASK_CORE);
+    if (result != pdPASS) {
+        Serial.println("[ERROR] NetworkTask: Failed to create task");
+        taskHandle = nullptr;
+        return false;
+    }
+    TaskMonitor::add("network", taskHandle, STACK_SIZE);
+
+    Serial.printf("[INFO] NetworkTask: Started (core %d, priority %u)\n", TASK_CORE,
+                  TASK_PRIORITY);
+    return true;
+}
+
+void NetworkTask::stop() {
+    if (taskHandle) {
+        TaskMonitor::remove(taskHandle);
+        esp_task_wdt_delete(taskHandle);
+        vTaskDelete(taskHandle);
+        taskHandle = nullptr;
+    }
+    commands.clear();
+    results.clear();
+    uploadInFlight = false;
+}
+
+bool NetworkTask::startUpload(const BufferedBatch& backlog, const AveragedData* current) {
+    if (uploadInFlight) {
+        return false;
+    }
+
+    // The task reads only this copy, so loop() may add to or trim the ring meanwhile
+    BufferedBatch sent = backlog.first(PAGE_CAPACITY);
+    pageCount = sent.count();
+    for (uint16_t i = 0; i < pageCount; i++) {
+        page[i] = sent.at(i);
+    }
+    pageHasCurrent = current != nullptr;
+    if (current) {
+        pageCurrent = *current;
+    }
+
+    uploadInFlight = true;
+    Command command = {CommandType::START_UPLOAD, RadioMode::ACTIVE};
+    if (!post(command)) {
+        uploadInFlight = false;
+        return false;
+    }
+    return true;
+}
+
+bool NetworkTask::takeResult(UploadResult& out) {
+    const Completion* completion = results.front();
+    if (!completion) {
+        return false;
+    }
+    out = completion->result;
+    if (out.current) {
+        takenCurrent = completion->current;
+        out.current = &takenCurrent;
+    }
+    results.drop();
+    uploadInFlight = false;
+    return true;
+}
+
+void NetworkTask::prewarmConnection() {
+    post({CommandType::PREWARM, RadioMode::ACTIVE});
+}
+
+void NetworkTask::connectWiFi() {
+    post({CommandType::CONNECT_WIFI, RadioMode::ACTIVE});
+}
+
+void NetworkTask::setRadioMode(RadioMode mode) {
+    requestedRadioMode = mode;
+    post({CommandType::SET_RADIO_MODE, mode});
+}
+
+RadioMode NetworkTask::getRadioMode() const {
+    return taskHandle ? requestedRadioMode : network.getRadioMode();
+}
+
+void NetworkTask::poll() {
+    if (taskHandle) {
+        return;
+    }
+    network.processUpload();
+    network.checkConnection();
+}
+
+bool NetworkTask::isRunning() const {
+    return taskHandle != nullptr;
+}
+
+bool NetworkTask::post(const Command& command) {
+    if (!taskHandle) {
+        execute(command);
+        return true;
+    }
+    if (!commands.push(command)) {
+        Serial.println("[WARN] NetworkTask: Command queue full");
+        return false;
+    }
+    xTaskNotifyGive(taskHandle);
+    return true;
+}
+
+void NetworkTask::execute(const Command& command) {
+    switch (command.type) {
+        case CommandType::START_UPLOAD:
+            if (!network.startUpload(&NetworkTask::pageSource, this,
+                                     pageHasCurrent ? &pageCurrent : nullptr,
+                                     &NetworkTask::onUploadComplete, this)) {
+                // Not started (WiFi down, nothing to send): report it like a failure
+                UploadResult failed = {};
+                failed.current = pageHasCurrent ? &pageCurrent : nullptr;
+                onUploadComplete(failed, this);
+            }
+            break;
+        case CommandType::PREWARM:
+            network.prewarmConnection();
+            break;
+        case CommandType::CONNECT_WIFI:
+            network.connectWiFi();
+            break;
+        case CommandType::SET_RADIO_MODE:
+            network.setRadioMode(command.radioMode);
+            break;
+    }
+}
+
+BufferedBatch NetworkTask::pageSource(void* context) {
+    return static_cast<NetworkTask*>(context)->getSentPage();
+}
+
+void NetworkTask::onUploadComplete(const UploadResult& result, void* context) {
+    NetworkTask* self = static_cast<NetworkTask*>(context);
+    Completion* completion = self->results.reserve();
+    if (!completion) {
+        return;  // One upload in flight at a time, so there is always room
+    }
+    completion->result = result;
+    if (result.current) {
+        completion->current = *result.current;
+    }
+    self->results.commit();
+
+    TaskHandle_t waiting = self->resultHandle;
+    if (self->taskHandle && waiting) {
+        xTaskNotifyGive(waiting);
+    }
+}
+
+void NetworkTask::taskEntry(void* arg) {
+    static_cast<NetworkTask*>(arg)->run();
+}
+
+void NetworkTask::run() {
+    // Long TLS waits feed the watchdog from NetworkManager, now on this task
+    esp_task_wdt_add(nullptr);
+
+    for (;;) {
+        // Wake on a command, or on the next upload or WiFi state machine step
+        uint32_t pollMs = network.isUploadBusy() ? UPLOAD_POLL_MS : IDLE_POLL_MS;
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(pollMs));
+        esp_task_wdt_reset();
+
+        Command command;
+        while (commands.pop(command)) {
+            execute(command);
+        }
+        network.processUpload();
+        network.checkConnection();
+    }
+}
+
+#endif  // UNIT_TEST
@@ -0,0 +1,398 @@
+#include "OutboundQueue.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <LittleFS.h>
+#else
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+constexpr uint32_t META_MAGIC = 0x3130514F;  // "OQ01"
+
+struct QueueMeta {
+    uint32_t magic;
+    uint32_t firstSegment;
+    uint16_t segmentCount;
+    uint16_t readOffset;
+};
+
+constexpr size_t RECORD_SIZE = sizeof(PackedAveragedData);
+
+}  // namespace
+
+OutboundQueue::OutboundQueue(const char* rootDir) : ready(false), stagedCount(0), stats() {
+    strncpy(root, rootDir, sizeof(root) - 1);
+    root[sizeof(root) - 1] = '\0';
+    resetLayout();
+}
+
+bool OutboundQueue::begin() {
+    ready = mountFs();
+    if (!ready) {
+#ifdef ARDUINO
+        Serial.printf("[ERROR] OutboundQueue: filesystem unavailable, spill disabled\n");
+#endif
+        return false;
+    }
+
+    resetLayout();
+
+    char path[40];
+    snprintf(path, sizeof(path), "%s/meta", root);
+    QueueMeta meta;
+    if (readFile(path, 0, &meta, sizeof(meta)) == sizeof(meta) && meta.magic == META_MAGIC &&
+        meta.segmentCount <= MAX_SEGMENTS) {
+        firstSegment = meta.firstSegment;
+        segmentCount = meta.segmentCount;
+        readOffset = meta.readOffset;
+
+        if (segmentCount > 0) {
+            segmentPath(firstSegment + segmentCount - 1, path, sizeof(path));
+            long bytes = fileSize(path);
+            if (bytes < 0) {
+                bytes = 0;  // Segment started but never written
+            }
+            if (bytes % RECORD_SIZE != 0 || bytes / RECORD_SIZE > RECORDS_PER_SEGMENT) {
+                // Torn tail (LittleFS commits on close, so this should not happen);
+                // discard the segment rather than append misaligned records to it
+                removeFile(path);
+                segmentCount--;
+                bytes = segmentCount > 0 ? (long)(RECORDS_PER_SEGMENT * RECORD_SIZE) : 0;
+            }
+            lastSegmentRecords = bytes / RECORD_SIZE;
+        }
+
+        uint16_t firstRecords = segmentCount == 1 ? lastSegmentRecords : RECORDS_PER_SEGMENT;
+        if (segmentCount == 0 || readOffset > firstRecords) {
+            readOffset = 0;
+        }
+    }
+
+    stats.segmentCount = segmentCount;
+    stats.queuedRecords = size();
+#ifdef ARDUINO
+    Serial.printf("[INFO] OutboundQueue: %lu record(s) in %u segment(s)\n",
+                  (unsigned long)stats.queuedRecords, segmentCount);
+#endif
+    return true;
+}
+
+bool OutboundQueue::append(const PackedAveragedData& record) {
+    if (!ready || stagedCount >= WRITE_BATCH_RECORDS) {
+        // Not mounted, or the previous batch could not be written
+        stats.droppedRecords++;
+        return false;
+    }
+
+    staged[stagedCount++] = record;
+    stats.spilledRecords++;
+    stats.queuedRecords = size();
+
+    if (stagedCount == WRITE_BATCH_RECORDS) {
+        flush();
+    }
+    return true;
+}
+
+bool OutboundQueue::flush() {
+    if (!ready || stagedCount == 0) {
+        return stagedCount == 0;
+    }
+
+    uint8_t written = 0;
+    char path[40];
+    while (written < stagedCount) {
+        if (segmentCount == 0 || lastSegmentRecords >= RECORDS_PER_SEGMENT) {
+            if (!startSegment()) {
+                break;
+            }
+        }
+
+        uint16_t room = RECORDS_PER_SEGMENT - lastSegmentRecords;
+        uint8_t n = stagedCount - written;
+        if (n > room) {
+            n = room;
+        }
+
+        segmentPath(firstSegment + segmentCount - 1, path, sizeof(path));
+        if (!appendFile(path, &staged[written], n * RECORD_SIZE)) {
+            break;
+        }
+        lastSegmentRecords += n;
+        written += n;
+    }
+
+    // Keep whatever could not be written staged for the next attempt
+    if (written > 0) {
+        memmove(staged, &staged[written], (stagedCount - written) * RECORD_SIZE);
+        stagedCount -= written;
+        stats.flushes++;
+    }
+    stats.segmentCount = segmentCount;
+    stats.queuedRecords = size();
+    return stagedCount == 0;
+}
+
+uint16_t OutboundQueue::peek(PackedAveragedData* out, uint16_t maxRecords) {
+    uint16_t copied = 0;
+    char path[40];
+
+    for (uint16_t s = 0; s < segmentCount && copied < maxRecords; s++) {
+        uint16_t records = (s == segmentCount - 1) ? lastSegmentRecords : RECORDS_PER_SEGMENT;
+        uint16_t start = (s == 0) ? readOffset : 0;
+        if (start >= records) {
+            continue;
+        }
+
+        uint16_t n = records - start;
+        if (n > maxRecords - copied) {
+            n = maxRecords - copied;
+        }
+
+        segmentPath(firstSegment + s, path, sizeof(path));
+        size_t bytes = readFile(path, start * RECORD_SIZE, &out[copied], n * RECORD_SIZE);
+        copied += bytes / RECORD_SIZE;
+        if (bytes != n * RECORD_SIZE) {
+            // Short read: stop so the result stays a contiguous oldest-first prefix
+            return copied;
+        }
+    }
+
+    for (uint8_t i = 0; i < stagedCount && copied < maxRecords; i++) {
+        out[copied++] = staged[i];
+    }
+    return copied;
+}
+
+void OutboundQueue::commit(uint16_t count) {
+    uint32_t queued = size();
+    if (count > queued) {
+        count = queued;
+    }
+    stats.drainedRecords += count;
+
+    uint32_t fromFlash = flashedRecords();
+    if (fromFlash > count) {
+        fromFlash = count;
+    }
+    uint16_t fromStaged = count - fromFlash;
+
+    char path[40];
+    while (fromFlash > 0 && segmentCount > 0) {
+        uint16_t records = segmentCount == 1 ? lastSegmentRecords : RECORDS_PER_SEGMENT;
+        uint16_t n = records - readOffset;
+        if (n > fromFlash) {
+            n = fromFlash;
+        }
+        readOffset += n;
+        fromFlash -= n;
+
+        if (readOffset >= records) {
+            // Segment fully drained: garbage-collect it
+            segmentPath(firstSegment, path, sizeof(path));
+            removeFile(path);
+            firstSegment++;
+            segmentCount--;
+            readOffset = 0;
+            lastSegmentRecords = segmentCount > 0 ? lastSegmentRecords : 0;
+            stats.segmentsCollected++;
+        }
+    }
+
+    if (fromStaged > 0) {
+        memmove(staged, &staged[fromStaged], (stagedCount - fromStaged) * RECORD_SIZE);
+        stagedCount -= fromStaged;
+    }
+
+    saveMeta();
+    stats.segmentCount = segmentCount;
+    stats.queuedRecords = size();
+}
+
+uint32_t OutboundQueue::size() const {
+    return flashedRecords() + stagedCount;
+}
+
+OutboundQueueStats OutboundQueue::getStats() const {
+    return stats;
+}
+
+bool OutboundQueue::spill(const PackedAveragedData& record, void* context) {
+    return static_cast<OutboundQueue*>(context)->append(record);
+}
+
+uint32_t OutboundQueue::flashedRecords() const {
+    if (segmentCount == 0) {
+        return 0;
+    }
+    return (uint32_t)(segmentCount - 1) * RECORDS_PER_SEGMENT + lastSegmentRecords - readOffset;
+}
+
+void OutboundQueue::segmentPath(uint32_t id, char* path, size_t size) const {
+    snprintf(path, size, "%s/%lu.seg", root, (unsigned long)id);
+}
+
+bool OutboundQueue::startSegment() {
+    if (segmentCount >= MAX_SEGMENTS) {
+        dropFirstSegment();
+    }
+
+    // Ids only grow, but clear any stale file left behind by a lost cursor
+    char path[40];
+    segmentPath(firstSegment + segmentCount, path, sizeof(path));
+    removeFile(path);
+
+    segmentCount++;
+    lastSegmentRecords = 0;
+    return saveMeta();
+}
+
+void OutboundQueue::dropFirstSegment() {
+    uint16_t records = segmentCount == 1 ? lastSegmentRecords : RECORDS_PER_SEGMENT;
+    uint16_t dropped = records - readOffset;
+    stats.droppedRecords += dropped;
+
+    char path[40];
+    segmentPath(firstSegment, path, sizeof(path));
+    removeFile(path);
+    firstSegment++;
+    segmentCount--;
+    readOffset = 0;
+#ifdef ARDUINO
+    Serial.printf("[WARN] OutboundQueue: full, dropped %u oldest record(s)\n", dropped);
+#endif
+}
+
+bool OutboundQueue::saveMeta() {
+    QueueMeta meta = {META_MAGIC, firstSegment, segmentCount, readOffset};
+    char path[40];
+    snprintf(path, sizeof(path), "%s/meta", root);
+    return writeFile(path, &meta, sizeof(meta));
+}
+
+void OutboundQueue::resetLayout() {
+    firstSegment = 0;
+    segmentCount = 0;
+    lastSegmentRecords = 0;
+    readOffset = 0;
+}
+
+// ============================================================================
+// Filesystem primitives
+// ============================================================================
+
+#ifdef ARDUINO
+
+bool OutboundQueue::mountFs() {
+    if (!LittleFS.begin(true)) {  // true = format on mount failure
+        return false;
+    }
+    return LittleFS.exists(root) || LittleFS.mkdir(root);
+}
+
+long OutboundQueue::fileSize(const char* path) const {
+    if (!LittleFS.exists(path)) {
+        return -1;
+    }
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        return -1;
+    }
+    long bytes = file.size();
+    file.close();
+    return bytes;
+}
+
+bool OutboundQueue::appendFile(const char* path, const void* data, size_t len) {
+    File file = LittleFS.open(path, "a");
+    if (!file) {
+        return false;
+    }
+    size_t written = file.write(static_cast<const uint8_t*>(data), len);
+    file.close();
+    return written == len;
+}
+
+size_t OutboundQueue::readFile(const char* path, size_t offset, void* data, size_t len) const {
+    if (!LittleFS.exists(path)) {
+        return 0;
+    }
+    File file = LittleFS.open(path, "r");
+    if (!file) {
+        return 0;
+    }
+    size_t bytes = file.seek(offset) ? file.read(static_cast<uint8_t*>(data), len) : 0;
+    file.close();
+    return bytes;
+}
+
+bool OutboundQueue::writeFile(const char* path, const void* data, size_t len) {
+    File file = LittleFS.open(path, "w");
+    if (!file) {
+        return false;
+    }
+    size_t written = file.write(static_cast<const uint8_t*>(data), len);
+    file.close();
+    return written == len;
+}
+
+void OutboundQueue::removeFile(const char* path) {
+    if (LittleFS.exists(path)) {
+        LittleFS.remove(path);
+    }
+}
+
+#else
+
+// Host build: plain stdio under rootDir so the queue logic can be unit tested
+
+bool OutboundQueue::mountFs() {
+    struct stat st;
+    return stat(root, &st) == 0 || mkdir(root, 0755) == 0;
+}
+
+long OutboundQueue::fileSize(const char* path) const {
+    struct stat st;
+    return stat(path, &st) == 0 ? (long)st.st_size : -1;
+}
+
+bool OutboundQueue::appendFile(const char* path, const void* data, size_t len) {
+    FILE* file = fopen(path, "ab");
+    if (!file) {
+        return false;
+    }
+    size_t written = fwrite(data, 1, len, file);
+    fclose(file);
+    return written == len;
+}
+
+size_t OutboundQueue::readFile(const char* path, size_t offset, void* data, size_t len) const {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+    size_t bytes = fseek(file, (long)offset, SEEK_SET) == 0 ? fread(data, 1, len, file) : 0;
+    fclose(file);
+    return bytes;
+}
+
+bool OutboundQueue::writeFile(const char* path, const void* data, size_t len) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    size_t written = fwrite(data, 1, len, file);
+    fclose(file);
+    return written == len;
+}
+
+void OutboundQueue::removeFile(const char* path) {
+    remove(path);
+}
+
+#endif
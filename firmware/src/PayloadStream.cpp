@@ -0,0 +1,769 @@
+#include "PayloadStream.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "BootProfiler.h"
+#include "DataManager.h"
+#include "EnergyMeter.h"
+#include "ErrorLogger.h"
+#include "LoopProfiler.h"
+#include "models/SensorDescriptor.h"
+#include "models/SensorType.h"
+
+namespace {
+
+// snprintf appender over a fixed buffer; once full, further appends are dropped
+struct FragmentWriter {
+    char* buffer;
+    size_t capacity;
+    size_t length;
+    bool full;
+
+    FragmentWriter(char* buf, size_t cap) : buffer(buf), capacity(cap), length(0), full(false) {}
+
+    void appendf(const char* format, ...) {
+        if (full) {
+            return;
+        }
+        va_list args;
+        va_start(args, format);
+        int written = vsnprintf(buffer + length, capacity - length, format, args);
+        va_end(args);
+        if (written < 0 || static_cast<size_t>(written) >= capacity - length) {
+            full = true;
+            length = capacity;
+            return;
+        }
+        length += written;
+    }
+
+    void append(const char* text) { appendf("%s", text); }
+
+    void bytes(const void* data, size_t count) {
+        if (full) {
+            return;
+        }
+        if (count > capacity - length) {
+            full = true;
+            length = capacity;
+            return;
+        }
+        memcpy(buffer + length, data, count);
+        length += count;
+    }
+};
+
+// CBOR (RFC 8949) items; integers use the shortest head, floats are always float32
+enum CborMajor : uint8_t {
+    CBOR_UINT = 0,
+    CBOR_NEGINT = 1,
+    CBOR_TEXT = 3,
+    CBOR_ARRAY = 4,
+    CBOR_MAP = 5
+};
+
+void cborHead(FragmentWriter& out, uint8_t major, uint64_t value) {
+    uint8_t head[9];
+    uint8_t extra;
+    if (value < 24) {
+        head[0] = (major << 5) | value;
+        extra = 0;
+    } else if (value <= 0xFF) {
+        head[0] = (major << 5) | 24;
+        extra = 1;
+    } else if (value <= 0xFFFF) {
+        head[0] = (major << 5) | 25;
+        extra = 2;
+    } else if (value <= 0xFFFFFFFF) {
+        head[0] = (major << 5) | 26;
+        extra = 4;
+    } else {
+        head[0] = (major << 5) | 27;
+        extra = 8;
+    }
+    for (uint8_t i = 0; i < extra; i++) {
+        head[1 + i] = value >> (8 * (extra - 1 - i));  // Big-endian
+    }
+    out.bytes(head, 1 + extra);
+}
+
+void cborInt(FragmentWriter& out, int32_t value) {
+    if (value < 0) {
+        cborHead(out, CBOR_NEGINT, static_cast<uint64_t>(-1 - static_cast<int64_t>(value)));
+    } else {
+        cborHead(out, CBOR_UINT, value);
+    }
+}
+
+void cborText(FragmentWriter& out, const char* text) {
+    size_t length = strlen(text);
+    cborHead(out, CBOR_TEXT, length);
+    out.bytes(text, length);
+}
+
+void cborFloat(FragmentWriter& out, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint8_t item[5] = {0xFA, uint8_t(bits >> 24), uint8_t(bits >> 16), uint8_t(bits >> 8),
+                       uint8_t(bits)};
+    out.bytes(item, sizeof(item));
+}
+
+void cborKeyUint(FragmentWriter& out, const char* key, uint64_t value) {
+    cborText(out, key);
+    cborHead(out, CBOR_UINT, value);
+}
+
+void cborNull(FragmentWriter& out) {
+    uint8_t item = 0xF6;  // Simple value 22
+    out.bytes(&item, 1);
+}
+
+bool hasSensor(const AveragedData& data, SensorType type) {
+    return data.sensorStatus & (1 << static_cast<uint8_t>(type));
+}
+
+void appendValue(FragmentWriter& out, const char* key, float value, bool available) {
+    if (available) {
+        out.appendf("\"%s\":%.2f", key, value);
+    } else {
+        out.appendf("\"%s\":null", key);
+    }
+}
+
+void appendSpread(FragmentWriter& out, const char* key, const SensorSpread& spread,
+                  bool available) {
+    if (!available) {
+        out.appendf("\"%s\":null", key);
+        return;
+    }
+    out.appendf("\"%s\":{\"min\":%.2f,\"max\":%.2f,\"stddev\":%.3f}", key, spread.min,
+                spread.max, spread.stddev);
+}
+
+// Rolling latency statistics as {"<key>":{"min":..,"avg":..,"p95":..,"max":..},...}
+void appendLatencyMap(FragmentWriter& out, const char* key, const char* const* names,
+                      const LatencyStats* stats, uint8_t count) {
+    out.appendf("\"%s\":{", key);
+    for (uint8_t i = 0; i < count; i++) {
+        const LatencyStats& lat = stats[i];
+        out.appendf("%s\"%s\":{\"min\":%lu,\"avg\":%lu,\"p95\":%lu,\"max\":%lu}",
+                    i > 0 ? "," : "", names[i], static_cast<unsigned long>(lat.minUs),
+                    static_cast<unsigned long>(lat.avgUs), static_cast<unsigned long>(lat.p95Us),
+                    static_cast<unsigned long>(lat.maxUs));
+    }
+    out.append("}");
+}
+
+const char* const SENSOR_LATENCY_KEYS[NUM_SENSOR_BUSES] = {"bme280", "ds18b20",
+                                                           "soil_moisture"};
+const char* const NETWORK_LATENCY_KEYS[NUM_NETWORK_PHASES] = {"dns", "connect", "request",
+                                                              "response"};
+
+// Finished startup phases plus setup() total as {"config_file":..,...,"setup":..}
+void appendBootProfile(FragmentWriter& out, const BootProfile& profile) {
+    out.append("\"boot_phases_ms\":{");
+    for (uint8_t i = 0; i < NUM_BOOT_PHASES; i++) {
+        if (profile.doneMask & (1 << i)) {
+            out.appendf("\"%s\":%lu,", BootProfiler::phaseKey(static_cast<BootPhase>(i)),
+                        static_cast<unsigned long>(profile.phaseMs[i]));
+        }
+    }
+    out.appendf("\"setup\":%lu}", static_cast<unsigned long>(profile.setupMs));
+}
+
+void appendHealth(FragmentWriter& out, const SystemStatus& status) {
+    out.appendf("\"health\":{\"uptime_ms\":%lu,\"free_heap_bytes\":%lu,",
+                static_cast<unsigned long>(status.uptimeMs),
+                static_cast<unsigned long>(status.freeHeap));
+    out.appendf("\"min_free_heap_bytes\":%lu,\"largest_free_block_bytes\":%lu,",
+                static_cast<unsigned long>(status.minFreeHeap),
+                static_cast<unsigned long>(status.largestFreeBlock));
+    if (status.allocationsTracked) {
+        // [last pass, busiest pass]
+        out.appendf("\"loop_allocs\":[%lu,%lu],",
+                    static_cast<unsigned long>(status.loopAllocations),
+                    static_cast<unsigned long>(status.maxLoopAllocations));
+    }
+    out.appendf("\"wifi_rssi_dbm\":%d,", status.wifiRssi);
+    out.appendf("\"wifi_connect_ms\":%lu,", static_cast<unsigned long>(status.wifiConnectMs));
+    out.appendf(
+        "\"error_counters\":{\"sensor_read_failures\":%u,\"network_failures\":%u,"
+        "\"buffer_overflows\":%u},",
+        status.errors.sensorReadFailures, status.errors.networkFailures,
+        status.errors.bufferOverflows);
+
+    // Rolling per-sensor read and per-phase network request latency
+    appendLatencyMap(out, "sensor_latency_us", SENSOR_LATENCY_KEYS, status.sensorLatency,
+                     NUM_SENSOR_BUSES);
+    out.append(",");
+    appendLatencyMap(out, "network_latency_us", NETWORK_LATENCY_KEYS, status.networkLatency,
+                     NUM_NETWORK_PHASES);
+    out.appendf(",\"net_bytes_sent\":%lu,\"net_bytes_received\":%lu",
+                static_cast<unsigned long>(status.netBytesSent),
+                static_cast<unsigned long>(status.netBytesReceived));
+
+    // Estimated charge per subsystem over energy_window_ms
+    out.append(",\"energy_mah\":{");
+    for (uint8_t i = 0; i < NUM_ENERGY_SUBSYSTEMS; i++) {
+        out.appendf("%s\"%s\":%.3f", i > 0 ? "," : "",
+                    EnergyMeter::subsystemKey(static_cast<EnergySubsystem>(i)),
+                    status.energy.subsystemMah[i]);
+    }
+    out.appendf("},\"energy_window_ms\":%lu", static_cast<unsigned long>(status.energy.windowMs));
+
+    // Per loop() phase [p95, worst case] in microseconds
+    out.append(",\"loop_us\":{");
+    for (uint8_t i = 0; i < NUM_LOOP_PHASES; i++) {
+        out.appendf("%s\"%s\":[%lu,%lu]", i > 0 ? "," : "",
+                    LoopProfiler::phaseKey(static_cast<LoopPhase>(i)),
+                    static_cast<unsigned long>(status.loopPhases[i].p95Us),
+                    static_cast<unsigned long>(status.loopPhases[i].maxUs));
+    }
+    out.append("}");
+
+    // Per task [least free stack bytes, CPU %] (CPU null without run-time stats)
+    if (status.taskCount > 0) {
+        out.append(",\"tasks\":{");
+        for (uint8_t i = 0; i < status.taskCount; i++) {
+            const TaskStats& task = status.tasks[i];
+            out.appendf("%s\"%s\":[%lu,", i > 0 ? "," : "", task.name,
+                        static_cast<unsigned long>(task.minFreeStackBytes));
+            if (task.cpuPercent == TASK_CPU_UNKNOWN) {
+                out.append("null]");
+            } else {
+                out.appendf("%u]", task.cpuPercent);
+            }
+        }
+        out.append("}");
+    }
+
+    // Once per boot, in the first upload that gets through
+    if (status.bootProfilePending) {
+        out.append(",");
+        appendBootProfile(out, status.bootProfile);
+    }
+    out.append("}");
+}
+
+// ,"post_mortem":{"reset_reason":"task_wdt","log":[[boots_before,t_ms,level,type,msg],...]}
+// and the closing brace; its own fragment, as the health block nearly fills one
+void appendPostMortem(FragmentWriter& out) {
+    out.appendf(",\"post_mortem\":{\"reset_reason\":\"%s\",\"log\":[",
+                ErrorLogger::resetReasonKey(ErrorLogger::getPostMortemReason()));
+    for (uint8_t i = 0; i < ErrorLogger::getPostMortemCount(); i++) {
+        const PostMortemEntry& entry = ErrorLogger::getPostMortemEntry(i);
+        out.appendf("%s[%u,%lu,\"%s\",\"%s\",\"%s\"]", i > 0 ? "," : "", entry.boot,
+                    static_cast<unsigned long>(entry.timeMs),
+                    ErrorLogger::levelToString(static_cast<ErrorLevel>(entry.level)),
+                    ErrorLogger::typeToString(static_cast<ErrorType>(entry.type)), entry.text);
+    }
+    out.append("]}}");
+}
+
+// Schema tag the ingestion handler dispatches on
+const char* const COLUMNAR_SCHEMA = "columnar-v1";
+
+// Columnar field order; each becomes one JSON array with a value per reading
+enum ColumnId : uint8_t {
+    COL_BATCH_ID,
+    COL_SEQ,
+    COL_TIMESTAMP,
+    COL_SAMPLE_COUNT,
+    COL_SENSOR_MASK,
+    COL_FIRST_SENSOR,  // One column per SensorType, in enum order
+    NUM_COLUMNS = COL_FIRST_SENSOR + NUM_SENSORS
+};
+
+const char* const headerColumnKeys[COL_FIRST_SENSOR] = {"batch_id", "seq", "timestamp_ms",
+                                                        "sample_count", "sensor_mask"};
+
+const char* columnKey(uint8_t column) {
+    return column < COL_FIRST_SENSOR ? headerColumnKeys[column]
+                                     : SENSOR_DESCRIPTORS[column - COL_FIRST_SENSOR].jsonKey;
+}
+
+// Sensor value columns write 0 for sensors missing from sensor_mask
+void appendMaskedValue(FragmentWriter& out, const AveragedData& data,
+                       const SensorDescriptor& sensor) {
+    if (hasSensor(data, sensor.type)) {
+        out.appendf("%.2f", data.*sensor.average);
+    } else {
+        out.append("0");
+    }
+}
+
+void appendCell(FragmentWriter& out, uint8_t column, const AveragedData& data) {
+    switch (column) {
+        case COL_BATCH_ID:
+            out.appendf("\"%s\"", data.batchId);
+            break;
+        case COL_SEQ:
+            out.appendf("%lu", static_cast<unsigned long>(data.sequence));
+            break;
+        case COL_TIMESTAMP:
+            // Sample end epoch; 0 when the window was taken before the first NTP sync
+            out.appendf("%llu", data.timeSynced ? static_cast<unsigned long long>(
+                                                      data.sampleEndEpochMs)
+                                                : 0ULL);
+            break;
+        case COL_SAMPLE_COUNT:
+            out.appendf("%u", data.sampleCount);
+            break;
+        case COL_SENSOR_MASK:
+            out.appendf("%u", data.sensorStatus);
+            break;
+        default:
+            appendMaskedValue(out, data, SENSOR_DESCRIPTORS[column - COL_FIRST_SENSOR]);
+            break;
+    }
+}
+
+// Same structure as appendLatencyMap()
+void cborLatencyMap(FragmentWriter& out, const char* key, const char* const* names,
+                    const LatencyStats* stats, uint8_t count) {
+    cborText(out, key);
+    cborHead(out, CBOR_MAP, count);
+    for (uint8_t i = 0; i < count; i++) {
+        const LatencyStats& lat = stats[i];
+        cborText(out, names[i]);
+        cborHead(out, CBOR_MAP, 4);
+        cborKeyUint(out, "min", lat.minUs);
+        cborKeyUint(out, "avg", lat.avgUs);
+        cborKeyUint(out, "p95", lat.p95Us);
+        cborKeyUint(out, "max", lat.maxUs);
+    }
+}
+
+// Same structure as appendBootProfile()
+void cborBootProfile(FragmentWriter& out, const BootProfile& profile) {
+    uint8_t done = 0;
+    for (uint8_t i = 0; i < NUM_BOOT_PHASES; i++) {
+        done += (profile.doneMask >> i) & 1;
+    }
+    cborText(out, "boot_phases_ms");
+    cborHead(out, CBOR_MAP, done + 1);
+    for (uint8_t i = 0; i < NUM_BOOT_PHASES; i++) {
+        if (profile.doneMask & (1 << i)) {
+            cborKeyUint(out, BootProfiler::phaseKey(static_cast<BootPhase>(i)),
+                        profile.phaseMs[i]);
+        }
+    }
+    cborKeyUint(out, "setup", profile.setupMs);
+}
+
+// Same structure as appendHealth()
+void cborHealth(FragmentWriter& out, const SystemStatus& status) {
+    cborText(out, "health");
+    cborHead(out, CBOR_MAP, 14 + (status.bootProfilePending ? 1 : 0) +
+                                (status.allocationsTracked ? 1 : 0) +
+                                (status.taskCount > 0 ? 1 : 0));
+    cborKeyUint(out, "uptime_ms", status.uptimeMs);
+    cborKeyUint(out, "free_heap_bytes", status.freeHeap);
+    cborKeyUint(out, "min_free_heap_bytes", status.minFreeHeap);
+    cborKeyUint(out, "largest_free_block_bytes", status.largestFreeBlock);
+    if (status.allocationsTracked) {
+        cborText(out, "loop_allocs");
+        cborHead(out, CBOR_ARRAY, 2);
+        cborHead(out, CBOR_UINT, status.loopAllocations);
+        cborHead(out, CBOR_UINT, status.maxLoopAllocations);
+    }
+    cborText(out, "wifi_rssi_dbm");
+    cborInt(out, status.wifiRssi);
+    cborKeyUint(out, "wifi_connect_ms", status.wifiConnectMs);
+
+    cborText(out, "error_counters");
+    cborHead(out, CBOR_MAP, 3);
+    cborKeyUint(out, "sensor_read_failures", status.errors.sensorReadFailures);
+    cborKeyUint(out, "network_failures", status.errors.networkFailures);
+    cborKeyUint(out, "buffer_overflows", status.errors.bufferOverflows);
+
+    cborLatencyMap(out, "sensor_latency_us", SENSOR_LATENCY_KEYS, status.sensorLatency,
+                   NUM_SENSOR_BUSES);
+    cborLatencyMap(out, "network_latency_us", NETWORK_LATENCY_KEYS, status.networkLatency,
+                   NUM_NETWORK_PHASES);
+    cborKeyUint(out, "net_bytes_sent", status.netBytesSent);
+    cborKeyUint(out, "net_bytes_received", status.netBytesReceived);
+
+    cborText(out, "energy_mah");
+    cborHead(out, CBOR_MAP, NUM_ENERGY_SUBSYSTEMS);
+    for (uint8_t i = 0; i < NUM_ENERGY_SUBSYSTEMS; i++) {
+        cborText(out, EnergyMeter::subsystemKey(static_cast<EnergySubsystem>(i)));
+        cborFloat(out, status.energy.subsystemMah[i]);
+    }
+    cborKeyUint(out, "energy_window_ms", status.energy.windowMs);
+
+    cborText(out, "loop_us");
+    cborHead(out, CBOR_MAP, NUM_LOOP_PHASES);
+    for (uint8_t i = 0; i < NUM_LOOP_PHASES; i++) {
+        cborText(out, LoopProfiler::phaseKey(static_cast<LoopPhase>(i)));
+        cborHead(out, CBOR_ARRAY, 2);
+        cborHead(out, CBOR_UINT, status.loopPhases[i].p95Us);
+        cborHead(out, CBOR_UINT, status.loopPhases[i].maxUs);
+    }
+    if (status.taskCount > 0) {
+        cborText(out, "tasks");
+        cborHead(out, CBOR_MAP, status.taskCount);
+        for (uint8_t i = 0; i < status.taskCount; i++) {
+            cborText(out, status.tasks[i].name);
+            cborHead(out, CBOR_ARRAY, 2);
+            cborHead(out, CBOR_UINT, status.tasks[i].minFreeStackBytes);
+            if (status.tasks[i].cpuPercent == TASK_CPU_UNKNOWN) {
+                cborNull(out);
+            } else {
+                cborHead(out, CBOR_UINT, status.tasks[i].cpuPercent);
+            }
+        }
+    }
+    if (status.bootProfilePending) {
+        cborBootProfile(out, status.bootProfile);
+    }
+}
+
+// Same structure as appendPostMortem()
+void cborPostMortem(FragmentWriter& out) {
+    cborText(out, "post_mortem");
+    cborHead(out, CBOR_MAP, 2);
+    cborText(out, "reset_reason");
+    cborText(out, ErrorLogger::resetReasonKey(ErrorLogger::getPostMortemReason()));
+    cborText(out, "log");
+    cborHead(out, CBOR_ARRAY, ErrorLogger::getPostMortemCount());
+    for (uint8_t i = 0; i < ErrorLogger::getPostMortemCount(); i++) {
+        const PostMortemEntry& entry = ErrorLogger::getPostMortemEntry(i);
+        cborHead(out, CBOR_ARRAY, 5);
+        cborHead(out, CBOR_UINT, entry.boot);
+        cborHead(out, CBOR_UINT, entry.timeMs);
+        cborText(out, ErrorLogger::levelToString(static_cast<ErrorLevel>(entry.level)));
+        cborText(out, ErrorLogger::typeToString(static_cast<ErrorType>(entry.type)));
+        cborText(out, entry.text);
+    }
+}
+
+// Sensor columns are float32, or uint 0 for sensors missing from sensor_mask
+void cborMaskedValue(FragmentWriter& out, const AveragedData& data,
+                     const SensorDescriptor& sensor) {
+    if (hasSensor(data, sensor.type)) {
+        cborFloat(out, data.*sensor.average);
+    } else {
+        cborHead(out, CBOR_UINT, 0);
+    }
+}
+
+void cborCell(FragmentWriter& out, uint8_t column, const AveragedData& data) {
+    switch (column) {
+        case COL_BATCH_ID:
+            cborText(out, data.batchId);
+            break;
+        case COL_SEQ:
+            cborHead(out, CBOR_UINT, data.sequence);
+            break;
+        case COL_TIMESTAMP:
+            cborHead(out, CBOR_UINT, data.timeSynced ? data.sampleEndEpochMs : 0);
+            break;
+        case COL_SAMPLE_COUNT:
+            cborHead(out, CBOR_UINT, data.sampleCount);
+            break;
+        case COL_SENSOR_MASK:
+            cborHead(out, CBOR_UINT, data.sensorStatus);
+            break;
+        default:
+            cborMaskedValue(out, data, SENSOR_DESCRIPTORS[column - COL_FIRST_SENSOR]);
+            break;
+    }
+}
+
+// Top-level map: 6 header pairs and one pair per column, then health and post_mortem when
+// they are due
+constexpr uint8_t CBOR_ROOT_PAIRS = 6 + NUM_COLUMNS;
+
+}  // namespace
+
+PayloadStream::PayloadStream()
+    : backlog(),
+      current(nullptr),
+      deviceId(""),
+      hardwareId(""),
+      bootId(""),
+      firmwareVersion(""),
+      status(nullptr),
+      format(PayloadFormat::ROWS),
+      total(0),
+      nextFragment(0),
+      totalLength(0),
+      overflow(false),
+      scratchLength(0),
+      scratchPos(0) {}
+
+void PayloadStream::setIdentity(const char* hwId, const char* boot, const char* version) {
+    hardwareId = hwId;
+    bootId = boot;
+    firmwareVersion = version;
+}
+
+void PayloadStream::begin(const BufferedBatch& batch, const AveragedData* currentData,
+                              const char* id, const SystemStatus& systemStatus,
+                              PayloadFormat payloadFormat) {
+    backlog = batch;
+    current = currentData;
+    deviceId = id;
+    status = &systemStatus;
+    format = payloadFormat;
+    total = backlog.count() + (current ? 1 : 0);
+    overflow = false;
+
+    // Dry pass: same fragments, only their lengths are kept
+    rewind();
+    totalLength = 0;
+    while (fillNext()) {
+        totalLength += scratchLength;
+    }
+    rewind();
+}
+
+void PayloadStream::rewind() {
+    nextFragment = 0;
+    scratchLength = 0;
+    scratchPos = 0;
+}
+
+const AveragedData& PayloadStream::readingAt(uint16_t index) {
+    if (index < backlog.count()) {
+        DataManager::unpackAveragedData(backlog.at(index), unpacked);
+        return unpacked;
+    }
+    return *current;
+}
+
+bool PayloadStream::fillNext() {
+    scratchPos = 0;
+    scratchLength = 0;
+
+    // Rows: header, one fragment per reading, footer
+    // Columnar/CBOR: header, one fragment per cell (column-major), footer
+    // The footer carries the health block when it is due, and the post-mortem log
+    // follows while one is pending
+    bool columns = format != PayloadFormat::ROWS;
+    bool cbor = format == PayloadFormat::CBOR;
+    bool metrics = status->metricsDue;
+    bool postMortem = status->postMortemPending;
+    uint32_t cells = columns ? uint32_t(NUM_COLUMNS) * total : total;
+    if (nextFragment > cells + (postMortem ? 2 : 1)) {
+        return false;
+    }
+
+    uint32_t fragment = nextFragment++;
+    FragmentWriter out(scratch, sizeof(scratch));
+    if (fragment == 0) {
+        if (cbor) {
+            cborHead(out, CBOR_MAP, CBOR_ROOT_PAIRS + (metrics ? 1 : 0) + (postMortem ? 1 : 0));
+            const char* const header[][2] = {{"schema", COLUMNAR_SCHEMA},
+                                             {"device_id", deviceId},
+                                             {"hardware_id", hardwareId},
+                                             {"boot_id", bootId},
+                                             {"firmware_version", firmwareVersion}};
+            for (const auto& pair : header) {
+                cborText(out, pair[0]);
+                cborText(out, pair[1]);
+            }
+            cborKeyUint(out, "count", total);
+        } else if (columns) {
+            out.appendf(
+                "{\"schema\":\"%s\",\"device_id\":\"%s\",\"hardware_id\":\"%s\","
+                "\"boot_id\":\"%s\",\"firmware_version\":\"%s\",\"count\":%u",
+                COLUMNAR_SCHEMA, deviceId, hardwareId, bootId, firmwareVersion, total);
+        } else {
+            out.length = formatHeader(scratch, sizeof(scratch), deviceId);
+            out.full = out.length >= sizeof(scratch);
+        }
+    } else if (fragment == cells + 1) {
+        if (cbor) {
+            if (metrics) {
+                cborHealth(out, *status);
+            }
+        } else {
+            if (!columns) {
+                out.append("]");
+            }
+            if (metrics) {
+                out.append(",");
+                appendHealth(out, *status);
+            }
+            if (!postMortem) {
+                out.append("}");
+            }
+        }
+    } else if (fragment == cells + 2) {
+        if (cbor) {
+            cborPostMortem(out);
+        } else {
+            appendPostMortem(out);
+        }
+    } else if (columns) {
+        uint32_t cell = fragment - 1;
+        uint8_t column = cell / total;
+        uint16_t row = cell % total;
+        const AveragedData& data = readingAt(row);
+        if (cbor) {
+            if (row == 0) {
+                cborText(out, columnKey(column));
+                cborHead(out, CBOR_ARRAY, total);
+            }
+            cborCell(out, column, data);
+        } else {
+            if (row == 0) {
+                out.appendf(",\"%s\":[", columnKey(column));
+            } else {
+                out.append(",");
+            }
+            appendCell(out, column, data);
+            if (row == total - 1) {
+                out.append("]");
+            }
+        }
+    } else {
+        uint16_t index = fragment - 1;
+        if (index > 0) {
+            out.append(",");
+        }
+        out.length += formatReading(scratch + out.length, sizeof(scratch) - out.length,
+                                    readingAt(index), deviceId);
+        out.full = out.length >= sizeof(scratch);
+    }
+
+    overflow = overflow || out.full;
+    scratchLength = out.full ? sizeof(scratch) : out.length;
+    return true;
+}
+
+size_t PayloadStream::readBytes(char* buffer, size_t length) {
+    size_t copied = 0;
+    while (copied < length) {
+        if (scratchPos == scratchLength && !fillNext()) {
+            break;
+        }
+        size_t chunk = scratchLength - scratchPos;
+        if (chunk > length - copied) {
+            chunk = length - copied;
+        }
+        memcpy(buffer + copied, scratch + scratchPos, chunk);
+        scratchPos += chunk;
+        copied += chunk;
+    }
+    return copied;
+}
+
+int PayloadStream::available() {
+    // Skip empty fragments so 0 only ever means "body complete"
+    while (scratchPos == scratchLength) {
+        if (!fillNext()) {
+            return 0;
+        }
+    }
+    return static_cast<int>(scratchLength - scratchPos);
+}
+
+int PayloadStream::read() {
+    if (available() == 0) {
+        return -1;
+    }
+    return static_cast<uint8_t>(scratch[scratchPos++]);
+}
+
+int PayloadStream::peek() {
+    if (available() == 0) {
+        return -1;
+    }
+    return static_cast<uint8_t>(scratch[scratchPos]);
+}
+
+size_t PayloadStream::formatHeader(char* buffer, size_t capacity, const char* deviceId) {
+    FragmentWriter out(buffer, capacity);
+    out.appendf("{\"device_id\":\"%s\",\"readings\":[", deviceId);
+    return out.length;
+}
+
+size_t PayloadStream::formatMetrics(char* buffer, size_t capacity, const SystemStatus& status) {
+    FragmentWriter out(buffer, capacity);
+    out.append(",");
+    appendHealth(out, status);
+    return out.length;
+}
+
+size_t PayloadStream::formatReading(char* buffer, size_t capacity, const AveragedData& data,
+                                    const char* deviceId) {
+    FragmentWriter out(buffer, capacity);
+
+    out.appendf("{\"batch_id\":\"%s\",\"seq\":%lu,", data.batchId,
+                static_cast<unsigned long>(data.sequence));
+    out.appendf("\"device_id\":\"%s\",", deviceId);
+
+    // Epoch timestamps (zero when not synced)
+    if (data.timeSynced && data.sampleStartEpochMs > 0) {
+        out.appendf(
+            "\"sample_start_epoch_ms\":%llu,\"sample_end_epoch_ms\":%llu,"
+            "\"device_boot_epoch_ms\":%llu,",
+            static_cast<unsigned long long>(data.sampleStartEpochMs),
+            static_cast<unsigned long long>(data.sampleEndEpochMs),
+            static_cast<unsigned long long>(data.deviceBootEpochMs));
+    } else {
+        out.append(
+            "\"sample_start_epoch_ms\":0,\"sample_end_epoch_ms\":0,\"device_boot_epoch_ms\":0,");
+    }
+
+    // Uptime timestamps (always present)
+    out.appendf("\"sample_start_uptime_ms\":%lu,\"sample_end_uptime_ms\":%lu,\"uptime_ms\":%lu,",
+                static_cast<unsigned long>(data.sampleStartUptimeMs),
+                static_cast<unsigned long>(data.sampleEndUptimeMs),
+                static_cast<unsigned long>(data.uptimeMs));
+
+    // Metadata
+    out.appendf(
+        "\"sample_count\":%u,\"sensor_sample_counts\":{\"bme280\":%u,\"ds18b20\":%u,"
+        "\"soil_moisture\":%u},\"time_synced\":%s,",
+        data.sampleCount, data.bme280SampleCount, data.ds18b20SampleCount, data.soilSampleCount,
+        data.timeSynced ? "true" : "false");
+
+    // Sensor readings (null if sensor unavailable)
+    bool bme280 = hasSensor(data, SensorType::BME280_TEMP);
+    bool ds18b20 = hasSensor(data, SensorType::DS18B20_TEMP);
+    bool soil = hasSensor(data, SensorType::SOIL_MOISTURE);
+
+    out.append("\"sensors\":{");
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        const SensorDescriptor& sensor = SENSOR_DESCRIPTORS[i];
+        if (i > 0) {
+            out.append(",");
+        }
+        appendValue(out, sensor.jsonKey, data.*sensor.average, hasSensor(data, sensor.type));
+        // Per-probe values only when more than one probe is on the bus
+        if (sensor.type == SensorType::DS18B20_TEMP && ds18b20 && data.ds18b20ProbeCount > 1) {
+            out.append(",\"ds18b20_probes_c\":[");
+            for (uint8_t p = 0; p < data.ds18b20ProbeCount && p < MAX_DS18B20_PROBES; p++) {
+                out.appendf(p > 0 ? ",%.2f" : "%.2f", data.avgDs18b20Probes[p]);
+            }
+            out.append("]");
+        }
+    }
+    out.append("},");
+
+    // Per-window spread (min/max/stddev), null for unavailable sensors
+    out.append("\"sensor_spread\":{");
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        const SensorDescriptor& sensor = SENSOR_DESCRIPTORS[i];
+        if (i > 0) {
+            out.append(",");
+        }
+        appendSpread(out, sensor.jsonKey, data.*sensor.spread, hasSensor(data, sensor.type));
+    }
+    out.append("},");
+
+    // Sensor status flags
+    out.appendf(
+        "\"sensor_status\":{\"bme280\":\"%s\",\"ds18b20\":\"%s\",\"soil_moisture\":\"%s\"}",
+        bme280 ? "ok" : "unavailable", ds18b20 ? "ok" : "unavailable", soil ? "ok" : "unavailable");
+
+    out.append("}");  // End reading
+    return out.length;
+}
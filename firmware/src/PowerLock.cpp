@@ -0,0 +1,89 @@
+#include "PowerLock.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#if defined(CONFIG_PM_ENABLE) && CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#define POWER_LOCK_SUPPORTED
+#endif
+#endif
+
+namespace {
+
+#ifdef POWER_LOCK_SUPPORTED
+esp_pm_lock_handle_t cpuLock = nullptr;    // ESP_PM_CPU_FREQ_MAX
+esp_pm_lock_handle_t sleepLock = nullptr;  // ESP_PM_NO_LIGHT_SLEEP
+portMUX_TYPE holdMux = portMUX_INITIALIZER_UNLOCKED;
+uint16_t holders = 0;
+uint32_t heldSinceMs = 0;
+uint32_t heldMs = 0;  // Closed hold time not yet taken
+#endif
+bool enabled = false;
+
+}  // namespace
+
+bool PowerLock::begin() {
+#ifdef POWER_LOCK_SUPPORTED
+    if (enabled) {
+        return true;
+    }
+    if (esp_pm_lock_create(ESP_PM_CPU_FREQ_MAX, 0, "bus_cpu", &cpuLock) != ESP_OK ||
+        esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "bus_sleep", &sleepLock) != ESP_OK) {
+        Serial.println("[ERROR] PowerLock: Failed to create PM locks");
+        return false;
+    }
+    enabled = true;
+    return true;
+#else
+    return false;
+#endif
+}
+
+void PowerLock::acquire() {
+#ifdef POWER_LOCK_SUPPORTED
+    if (enabled) {
+        esp_pm_lock_acquire(cpuLock);
+        esp_pm_lock_acquire(sleepLock);
+        portENTER_CRITICAL(&holdMux);
+        if (holders++ == 0) {
+            heldSinceMs = millis();
+        }
+        portEXIT_CRITICAL(&holdMux);
+    }
+#endif
+}
+
+void PowerLock::release() {
+#ifdef POWER_LOCK_SUPPORTED
+    if (enabled) {
+        portENTER_CRITICAL(&holdMux);
+        if (holders > 0 && --holders == 0) {
+            heldMs += millis() - heldSinceMs;
+        }
+        portEXIT_CRITICAL(&holdMux);
+        esp_pm_lock_release(sleepLock);
+        esp_pm_lock_release(cpuLock);
+    }
+#endif
+}
+
+bool PowerLock::isEnabled() {
+    return enabled;
+}
+
+uint32_t PowerLock::takeHeldMs() {
+#ifdef POWER_LOCK_SUPPORTED
+    portENTER_CRITICAL(&holdMux);
+    uint32_t nowMs = millis();
+    if (holders > 0) {
+        heldMs += nowMs - heldSinceMs;  // Split an open hold at this call
+        heldSinceMs = nowMs;
+    }
+    uint32_t taken = heldMs;
+    heldMs = 0;
+    portEXIT_CRITICAL(&holdMux);
+    return taken;
+#else
+    return 0;
+#endif
+}
@@ -1,16 +1,126 @@
 #ifndef UNIT_TEST
 #include "PowerManager.h"
 
-PowerManager::PowerManager() : powerManagementEnabled(false), displayLowPowerMode(false) {}
+#include "PowerLock.h"
+
+#if defined(ARDUINO) && defined(CONFIG_PM_ENABLE) && CONFIG_PM_ENABLE
+#include <driver/uart.h>
+#include <esp_pm.h>
+#define AUTO_POWER_SAVE_SUPPORTED
+#endif
+
+PowerManager::PowerManager()
+    : powerManagementEnabled(false),
+      displayLowPowerMode(false),
+      autoLightSleep(false),
+      battery(),
+      energy(),
+      energyStarted(false),
+      lastEnergyMs(0),
+      lastBytesSent(0),
+      lastSensorBusyMs(0),
+      pendingSleepMs(0)
+#ifdef ARDUINO
+      ,
+      adcCharacteristics(),
+      adcCalibrated(false),
+      batteryTimer(nullptr),
+      batteryMux(portMUX_INITIALIZER_UNLOCKED)
+#endif
+{
+}
 
 void PowerManager::initialize() {
 #ifdef ARDUINO
     // Configure ADC for battery voltage monitoring
     adc1_config_width(ADC_WIDTH_BIT_12);
     adc1_config_channel_atten(ADC1_CHANNEL_7, ADC_ATTEN_DB_11);  // GPIO35
+
+    // Per-chip gain and offset from eFuse (two-point or Vref); the default Vref otherwise
+    esp_adc_cal_value_t source = esp_adc_cal_characterize(
+        ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, ADC_DEFAULT_VREF_MV, &adcCharacteristics);
+    adcCalibrated = true;
+    Serial.printf("[INFO] PowerManager: Battery ADC calibrated from %s\n",
+                  source == ESP_ADC_CAL_VAL_EFUSE_TP     ? "eFuse two-point"
+                  : source == ESP_ADC_CAL_VAL_EFUSE_VREF ? "eFuse Vref"
+                                                         : "default Vref");
+
+    sampleBattery();  // Accessors have a value from the start
+
+    if (!batteryTimer) {
+        esp_timer_create_args_t timerArgs = {};
+        timerArgs.callback = &PowerManager::batteryTimerCallback;
+        timerArgs.arg = this;
+        timerArgs.name = "battery";
+        if (esp_timer_create(&timerArgs, &batteryTimer) != ESP_OK ||
+            esp_timer_start_periodic(batteryTimer, BATTERY_SAMPLE_PERIOD_MS * 1000ULL) != ESP_OK) {
+            Serial.println("[WARN] PowerManager: Battery timer not started, voltage frozen");
+        }
+    }
+#endif
+}
+
+#ifdef ARDUINO
+void PowerManager::batteryTimerCallback(void* arg) {
+    static_cast<PowerManager*>(arg)->sampleBattery();
+}
+
+void PowerManager::sampleBattery() {
+    uint32_t rawSum = 0;
+    for (uint8_t i = 0; i < BATTERY_SAMPLE_BURST; i++) {
+        rawSum += adc1_get_raw(ADC1_CHANNEL_7);
+    }
+    uint32_t raw = rawSum / BATTERY_SAMPLE_BURST;
+
+    float volts = adcCalibrated
+                      ? esp_adc_cal_raw_to_voltage(raw, &adcCharacteristics) / 1000.0f *
+                            ADC_VOLTAGE_DIVIDER
+                      : calculateVoltageFromADC(raw);
+
+    portENTER_CRITICAL(&batteryMux);
+    battery.addSample(volts);
+    portEXIT_CRITICAL(&batteryMux);
+}
+#endif
+
+bool PowerManager::configureAutoPowerSave(bool lightSleep) {
+#ifdef AUTO_POWER_SAVE_SUPPORTED
+    esp_pm_config_esp32_t pmConfig = {};
+    pmConfig.max_freq_mhz = PM_MAX_FREQ_MHZ;
+    pmConfig.min_freq_mhz = PM_MIN_FREQ_MHZ;
+    pmConfig.light_sleep_enable = lightSleep;
+
+    esp_err_t err = esp_pm_configure(&pmConfig);
+    if (err == ESP_ERR_NOT_SUPPORTED && lightSleep) {
+        // Core built without tickless idle: frequency scaling only
+        Serial.println("[WARN] PowerManager: Auto light sleep not supported, DVFS only");
+        pmConfig.light_sleep_enable = false;
+        err = esp_pm_configure(&pmConfig);
+    }
+    if (err != ESP_OK || !PowerLock::begin()) {
+        Serial.printf("[WARN] PowerManager: Power management not configured (%d)\n", err);
+        return false;
+    }
+
+    autoLightSleep = pmConfig.light_sleep_enable;
+    if (autoLightSleep) {
+        // Console input wakes the chip (the first characters are lost)
+        uart_set_wakeup_threshold(UART_NUM_0, UART_WAKEUP_THRESHOLD);
+        esp_sleep_enable_uart_wakeup(UART_NUM_0);
+    }
+    Serial.printf("[INFO] PowerManager: DVFS %d-%d MHz, auto light sleep %s\n",
+                  PM_MIN_FREQ_MHZ, PM_MAX_FREQ_MHZ, autoLightSleep ? "on" : "off");
+    return true;
+#else
+    (void)lightSleep;
+    return false;
 #endif
 }
 
+bool PowerManager::isAutoLightSleepEnabled() const {
+    return autoLightSleep;
+}
+
 void PowerManager::enterLightSleep(uint32_t durationMs) {
     if (!powerManagementEnabled) {
         // If power management is disabled, just delay
@@ -24,7 +134,9 @@ void PowerManager::enterLightSleep(uint32_t durationMs) {
 
     // Enter light sleep mode
     // Light sleep maintains RAM and WiFi connection state
+    uint32_t sleepStart = millis();
     esp_light_sleep_start();
+    pendingSleepMs += millis() - sleepStart;
 #else
     // Mock implementation for unit testing
     delay(durationMs);
@@ -40,7 +152,7 @@ void PowerManager::enterDeepSleep(uint32_t durationMs) {
     // Configure timer wakeup
     esp_sleep_enable_timer_wakeup(durationMs * 1000ULL);  // Convert ms to microseconds
 
-    // Note: Before calling this, the caller should persist critical state to NVS
+    // Note: Before calling this, the caller should save critical state (RtcStateStore)
     // Deep sleep will reset the ESP32 and lose all RAM contents
 
     // Enter deep sleep mode
@@ -50,13 +162,22 @@ void PowerManager::enterDeepSleep(uint32_t durationMs) {
 #endif
 }
 
-float PowerManager::readBatteryVoltage() {
+bool PowerManager::wokeFromDeepSleep() const {
 #ifdef ARDUINO
-    // Read ADC value (12-bit: 0-4095)
-    uint16_t adcValue = adc1_get_raw(ADC1_CHANNEL_7);
+    // ULP: the soil sampler finished its window or saw a threshold crossing
+    esp_sleep_wakeup_cause_t cause = esp_sleep_get_wakeup_cause();
+    return cause == ESP_SLEEP_WAKEUP_TIMER || cause == ESP_SLEEP_WAKEUP_ULP;
+#else
+    return false;
+#endif
+}
 
-    // Convert ADC value to voltage
-    return calculateVoltageFromADC(adcValue);
+float PowerManager::readBatteryVoltage() {
+#ifdef ARDUINO
+    portENTER_CRITICAL(&batteryMux);
+    float voltage = battery.hasSample() ? battery.getVoltage() : 0.0f;
+    portEXIT_CRITICAL(&batteryMux);
+    return voltage;
 #else
     // Mock implementation for unit testing
     return 3.7f;  // Return nominal voltage
@@ -64,27 +185,29 @@ float PowerManager::readBatteryVoltage() {
 }
 
 bool PowerManager::isBatteryLow() {
-    float voltage = readBatteryVoltage();
-    return voltage < BATTERY_LOW_THRESHOLD;
+    return getBatteryLevel() != BatteryLevel::NORMAL;
 }
 
-uint8_t PowerManager::getBatteryPercentage() {
-    float voltage = readBatteryVoltage();
-
-    // Clamp voltage to valid range
-    if (voltage >= BATTERY_FULL_VOLTAGE) {
-        return 100;
-    }
-    if (voltage <= BATTERY_EMPTY_VOLTAGE) {
-        return 0;
-    }
-
-    // Linear interpolation between empty and full
-    float percentage =
-        ((voltage - BATTERY_EMPTY_VOLTAGE) / (BATTERY_FULL_VOLTAGE - BATTERY_EMPTY_VOLTAGE)) *
-        100.0f;
+BatteryLevel PowerManager::getBatteryLevel() {
+#ifdef ARDUINO
+    portENTER_CRITICAL(&batteryMux);
+    BatteryLevel level = battery.getLevel();
+    portEXIT_CRITICAL(&batteryMux);
+    return level;
+#else
+    return BatteryLevel::NORMAL;
+#endif
+}
 
-    return static_cast<uint8_t>(percentage);
+uint8_t PowerManager::getBatteryPercentage() {
+#ifdef ARDUINO
+    portENTER_CRITICAL(&batteryMux);
+    uint8_t percentage = battery.getPercent();
+    portEXIT_CRITICAL(&batteryMux);
+    return percentage;
+#else
+    return 58;  // Nominal voltage
+#endif
 }
 
 uint32_t PowerManager::getAdaptiveReadingInterval(uint32_t baseIntervalMs) {
@@ -92,13 +215,13 @@ uint32_t PowerManager::getAdaptiveReadingInterval(uint32_t baseIntervalMs) {
         return baseIntervalMs;
     }
 
-    float voltage = readBatteryVoltage();
+    BatteryLevel level = getBatteryLevel();
 
     // Adjust interval based on battery level
-    if (voltage < BATTERY_CRITICAL_THRESHOLD) {
+    if (level == BatteryLevel::CRITICAL) {
         // Critical battery: 4x interval
         return baseIntervalMs * INTERVAL_MULTIPLIER_CRITICAL;
-    } else if (voltage < BATTERY_LOW_THRESHOLD) {
+    } else if (level == BatteryLevel::LOW_CHARGE) {
         // Low battery: 2x interval
         return baseIntervalMs * INTERVAL_MULTIPLIER_LOW;
     } else {
@@ -107,6 +230,60 @@ uint32_t PowerManager::getAdaptiveReadingInterval(uint32_t baseIntervalMs) {
     }
 }
 
+void PowerManager::accountEnergy(uint32_t nowMs, const EnergySample& sample) {
+    uint32_t heldMs = PowerLock::takeHeldMs();
+    if (!energyStarted) {
+        energyStarted = true;
+        lastEnergyMs = nowMs;
+        lastBytesSent = sample.bytesSent;
+        lastSensorBusyMs = sample.sensorBusyMs;
+        pendingSleepMs = 0;
+        return;
+    }
+
+    uint32_t elapsedMs = nowMs - lastEnergyMs;
+    lastEnergyMs = nowMs;
+
+    // CPU: sleep, then time held at full speed, the rest at the minimum (or all at the
+    // boot frequency without DVFS). Other tasks holding the lock cut a loop delay short
+    if (heldMs > elapsedMs) {
+        heldMs = elapsedMs;
+    }
+    uint32_t sleepMs = pendingSleepMs;
+    pendingSleepMs = 0;
+    if (sleepMs > elapsedMs - heldMs) {
+        sleepMs = elapsedMs - heldMs;
+    }
+    uint32_t awakeMs = elapsedMs - sleepMs;
+    energy.add(ENERGY_LIGHT_SLEEP, sleepMs);
+    if (PowerLock::isEnabled()) {
+        energy.add(ENERGY_CPU_MAX, heldMs);
+        energy.add(ENERGY_CPU_MIN, awakeMs - heldMs);
+    } else {
+        energy.add(ENERGY_CPU_MAX, awakeMs);
+    }
+
+    // WiFi: airtime for the bytes sent, the rest of the interval in the sampled state
+    uint32_t txMs = (sample.bytesSent - lastBytesSent) / WIFI_TX_BYTES_PER_MS;
+    lastBytesSent = sample.bytesSent;
+    if (txMs > elapsedMs) {
+        txMs = elapsedMs;
+    }
+    energy.add(ENERGY_WIFI_TX, txMs);
+    if (sample.radio < NUM_ENERGY_STATES) {
+        energy.add(sample.radio, elapsedMs - txMs);
+    }
+
+    energy.add(ENERGY_BACKLIGHT,
+               static_cast<uint32_t>(static_cast<uint64_t>(elapsedMs) * sample.backlight / 255));
+    energy.add(ENERGY_SENSORS, sample.sensorBusyMs - lastSensorBusyMs);
+    lastSensorBusyMs = sample.sensorBusyMs;
+}
+
+void PowerManager::accountAutoSleep(uint32_t ms) {
+    pendingSleepMs += ms;
+}
+
 void PowerManager::setDisplayLowPowerMode(bool enabled) {
     displayLowPowerMode = enabled;
 }
@@ -7,14 +7,13 @@
 #include "Version.h"
 #else
 #include <cstdlib>
-#include <ctime>
 #endif
 
 RegistrationManager::RegistrationManager(NetworkManager* network, ConfigManager* config)
     : _network(network),
       _config(config),
       _retryCount(0),
-      _nextRetryTime(0),
+      _retryDelayMs(0),
       _retryPending(false),
       _cachedRegistrationPayload("") {}
 
@@ -77,22 +76,7 @@ bool RegistrationManager::registerDevice(const String& hardwareId, const String&
 
     // Handle the result
     if (result.statusCode >= 200 && result.statusCode < 300) {
-        // Success - check if we got a valid confirmation_id
-        if (result.confirmationId.length() > 0 && isValidConfirmationId(result.confirmationId)) {
-            // Store confirmation_id in NVS
-            _config->setConfirmationId(result.confirmationId);
-
-            // Clear retry state
-            _retryPending = false;
-            _retryCount = 0;
-
-            Serial.printf("[INFO] Registration successful, confirmation_id: %s\n",
-                          result.confirmationId.c_str());
-            return true;
-        } else {
-            Serial.printf("[ERROR] Registration response missing or invalid confirmation_id\n");
-            return false;
-        }
+        return acceptConfirmation(result);
     } else if (result.shouldRetry) {
         // Retryable error - queue retry
         Serial.printf("[WARN] Registration failed with status %d, will retry\n", result.statusCode);
@@ -106,65 +90,60 @@ bool RegistrationManager::registerDevice(const String& hardwareId, const String&
     }
 }
 
-void RegistrationManager::processRetries() {
-    // Check if we have a pending retry
-    if (!_retryPending) {
-        return;
+bool RegistrationManager::registerWithNextUpload(const String& hardwareId, const String& bootId,
+                                                 const String& friendlyName,
+                                                 const String& firmwareVersion) {
+    if (_network->isRegistrationQueued()) {
+        return false;
     }
+    String payload = buildRegistrationPayload(hardwareId, bootId, friendlyName, firmwareVersion);
+    _retryCount = 0;
+    _retryPending = false;
+    return _network->queueRegistration(payload, &RegistrationManager::onUploadRegistration, this);
+}
 
-    // Check if it's time to retry
-#ifdef ARDUINO
-    unsigned long currentTime = millis();
-#else
-    unsigned long currentTime = (unsigned long)(clock() * 1000 / CLOCKS_PER_SEC);
-#endif
-
-    if (currentTime < _nextRetryTime) {
-        return;  // Not time yet
+void RegistrationManager::onUploadRegistration(const RegistrationResult& result, void* context) {
+    RegistrationManager* self = static_cast<RegistrationManager*>(context);
+    if (result.statusCode >= 200 && result.statusCode < 300) {
+        self->acceptConfirmation(result);
+    } else if (!result.shouldRetry) {
+        Serial.printf("[ERROR] Registration failed with non-retryable status %d\n",
+                      result.statusCode);
+    } else if (self->_retryCount >= MAX_RETRIES) {
+        Serial.printf("[ERROR] Max registration retries (%d) exceeded after status %d\n",
+                      MAX_RETRIES, result.statusCode);
+    } else {
+        Serial.printf("[WARN] Registration failed with status %d, will retry\n",
+                      result.statusCode);
+        self->queueRetry();
     }
+}
 
-    // Check if we've exceeded max retries
-    if (_retryCount >= 5) {
-        Serial.printf("[ERROR] Max registration retries (5) exceeded, giving up\n");
-        _retryPending = false;
-        return;
-    }
+bool RegistrationManager::acceptConfirmation(const RegistrationResult& result) {
+    // Success - check if we got a valid confirmation_id
+    if (result.confirmationId.length() > 0 && isValidConfirmationId(result.confirmationId)) {
+        // Store confirmation_id in NVS
+        _config->setConfirmationId(result.confirmationId);
 
-    // Attempt retry using cached payload
-    Serial.printf("[INFO] Attempting registration retry %d/5\n", _retryCount + 1);
+        // Clear retry state
+        _retryPending = false;
+        _retryCount = 0;
 
-    RegistrationResult result = _network->registerDevice(_cachedRegistrationPayload);
+        Serial.printf("[INFO] Registration successful, confirmation_id: %s\n",
+                      result.confirmationId.c_str());
+        return true;
+    }
+    Serial.printf("[ERROR] Registration response missing or invalid confirmation_id\n");
+    return false;
+}
 
-    // Handle the result
-    if (result.statusCode >= 200 && result.statusCode < 300) {
-        // Success
-        if (result.confirmationId.length() > 0 && isValidConfirmationId(result.confirmationId)) {
-            _config->setConfirmationId(result.confirmationId);
-            _retryPending = false;
-            _retryCount = 0;
-            Serial.printf("[INFO] Registration retry successful, confirmation_id: %s\n",
-                          result.confirmationId.c_str());
-        } else {
-            Serial.printf(
-                "[ERROR] Registration retry response missing or invalid confirmation_id\n");
-            _retryPending = false;
-        }
-    } else if (result.shouldRetry) {
-        // Still retryable - queue another retry
-        _retryCount++;
-        if (_retryCount < 5) {
-            queueRetry();
-            Serial.printf("[WARN] Registration retry %d failed with status %d, will retry again\n",
-                          _retryCount, result.statusCode);
-        } else {
-            Serial.printf("[ERROR] Max registration retries (5) exceeded after status %d\n",
-                          result.statusCode);
-            _retryPending = false;
-        }
-    } else {
-        // Non-retryable error
-        Serial.printf("[ERROR] Registration retry failed with non-retryable status %d\n",
-                      result.statusCode);
+void RegistrationManager::processRetries() {
+    if (!_retryPending) {
+        return;
+    }
+    if (_network->queueRegistration(_cachedRegistrationPayload,
+                                    &RegistrationManager::onUploadRegistration, this,
+                                    _retryDelayMs)) {
         _retryPending = false;
     }
 }
@@ -198,17 +177,13 @@ bool RegistrationManager::isValidConfirmationId(const String& confirmationId) {
 }
 
 void RegistrationManager::queueRetry() {
-    _retryPending = true;
+    _retryDelayMs = calculateBackoff(_retryCount);
+    _retryCount++;
+    Serial.printf("[INFO] Registration retry %d/%d queued, will retry in %lu ms\n", _retryCount,
+                  MAX_RETRIES, _retryDelayMs);
 
-    // Calculate backoff delay
-    unsigned long backoffDelay = calculateBackoff(_retryCount);
-
-    // Set next retry time
-#ifdef ARDUINO
-    _nextRetryTime = millis() + backoffDelay;
-#else
-    _nextRetryTime = (unsigned long)(clock() * 1000 / CLOCKS_PER_SEC) + backoffDelay;
-#endif
-
-    Serial.printf("[INFO] Registration retry queued, will retry in %lu ms\n", backoffDelay);
+    // Sent by the network task once the delay has passed. If another registration holds
+    // the queue now, that one's result decides; processRetries() can still hand this over
+    _retryPending = true;
+    processRetries();
 }
@@ -0,0 +1,40 @@
+#include "RenderScheduler.h"
+
+RenderScheduler::RenderScheduler()
+    : maxFps(RENDER_DEFAULT_MAX_FPS),
+      lowPower(false),
+      frameRequested(true),
+      rendered(false),
+      lastKey(0),
+      lastFrameMs(0),
+      framesRendered(0) {}
+
+void RenderScheduler::setMaxFps(uint8_t fps) {
+    if (fps == 0) {
+        fps = RENDER_DEFAULT_MAX_FPS;
+    }
+    maxFps = fps > RENDER_MAX_FPS_LIMIT ? RENDER_MAX_FPS_LIMIT : fps;
+}
+
+bool RenderScheduler::shouldRender(uint32_t inputsKey, unsigned long nowMs) {
+    if (rendered) {
+        unsigned long elapsed = nowMs - lastFrameMs;
+        uint8_t fps = lowPower && maxFps > RENDER_LOW_POWER_MAX_FPS ? RENDER_LOW_POWER_MAX_FPS
+                                                                     : maxFps;
+        if (elapsed < 1000UL / fps) {
+            return false;  // Too soon; a pending change is still seen on a later call
+        }
+
+        unsigned long tickMs = lowPower ? RENDER_LOW_POWER_CLOCK_TICK_MS : RENDER_CLOCK_TICK_MS;
+        if (!frameRequested && inputsKey == lastKey && elapsed < tickMs) {
+            return false;
+        }
+    }
+
+    rendered = true;
+    frameRequested = false;
+    lastKey = inputsKey;
+    lastFrameMs = nowMs;
+    framesRendered++;
+    return true;
+}
@@ -0,0 +1,106 @@
+#include "ReportDeadband.h"
+
+#include <math.h>
+
+#include "models/SensorDescriptor.h"
+#include "models/SensorType.h"
+
+#ifdef ARDUINO
+#include <esp_attr.h>
+#else
+#define RTC_DATA_ATTR  // Plain static storage on the host
+#endif
+
+namespace {
+
+constexpr uint32_t DEADBAND_MAGIC = 0x31424452;  // "RDB1"
+
+// Averages of the last reported window; zeroed at power-on, kept across deep sleep
+struct DeadbandReference {
+    uint32_t magic;
+    float values[NUM_SENSORS];  // Indexed by SensorType
+    uint8_t sensorStatus;
+    uint16_t suppressedRun;
+};
+
+RTC_DATA_ATTR DeadbandReference reference;
+
+// Configuration, re-applied every boot
+DeadbandTolerances tolerances = {0.0f, 0.0f, 0.0f, 0.0f};
+uint8_t heartbeat = 1;
+bool enabled = false;
+
+float windowValue(const AveragedData& window, SensorType type) {
+    return window.*sensorDescriptor(type).average;
+}
+
+float tolerance(SensorType type) {
+    switch (type) {
+        case SensorType::BME280_TEMP:
+        case SensorType::DS18B20_TEMP:
+            return tolerances.temperature;
+        case SensorType::HUMIDITY:
+            return tolerances.humidity;
+        case SensorType::PRESSURE:
+            return tolerances.pressure;
+        case SensorType::SOIL_MOISTURE:
+            return tolerances.soilMoisture;
+    }
+    return 0.0f;
+}
+
+bool withinTolerance(const AveragedData& window) {
+    if (reference.magic != DEADBAND_MAGIC || window.sensorStatus != reference.sensorStatus) {
+        return false;  // No reference, or a sensor came or went
+    }
+
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        if (!(window.sensorStatus & (1 << i))) {
+            continue;
+        }
+        SensorType type = static_cast<SensorType>(i);
+        float value = windowValue(window, type);
+        if (isnan(value) || isnan(reference.values[i]) ||
+            fabsf(value - reference.values[i]) > tolerance(type)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+void ReportDeadband::configure(const DeadbandTolerances& config, uint8_t heartbeatWindows) {
+    tolerances = config;
+    heartbeat = heartbeatWindows > 1 ? heartbeatWindows : 1;
+    enabled = tolerances.temperature > 0.0f || tolerances.humidity > 0.0f ||
+              tolerances.pressure > 0.0f || tolerances.soilMoisture > 0.0f;
+}
+
+bool ReportDeadband::isEnabled() {
+    return enabled;
+}
+
+bool ReportDeadband::shouldReport(const AveragedData& window) {
+    if (enabled && reference.suppressedRun + 1u < heartbeat && withinTolerance(window)) {
+        reference.suppressedRun++;
+        return false;
+    }
+
+    reference.magic = DEADBAND_MAGIC;
+    for (uint8_t i = 0; i < NUM_SENSORS; i++) {
+        reference.values[i] = windowValue(window, static_cast<SensorType>(i));
+    }
+    reference.sensorStatus = window.sensorStatus;
+    reference.suppressedRun = 0;
+    return true;
+}
+
+uint16_t ReportDeadband::getSuppressedRun() {
+    return reference.magic == DEADBAND_MAGIC ? reference.suppressedRun : 0;
+}
+
+void ReportDeadband::reset() {
+    reference.magic = 0;
+    reference.suppressedRun = 0;
+}
@@ -0,0 +1,186 @@
+#include "ResponseScanner.h"
+
+#include <string.h>
+
+ResponseScanner::ResponseScanner() {
+    reset();
+}
+
+void ResponseScanner::reset() {
+    idCount = 0;
+    confirmation[0] = '\0';
+    key[0] = '\0';
+    ackListSeen = false;
+    confirmationSeen = false;
+    overflow = false;
+    bytesSeen = 0;
+
+    depth = 0;
+    expectingKey = false;
+    keyField = Field::NONE;
+    arrayField = Field::NONE;
+    inString = false;
+    escaped = false;
+    target = Target::SKIP;
+    text = nullptr;
+    textSize = 0;
+    textLength = 0;
+}
+
+size_t ResponseScanner::write(const uint8_t* data, size_t length) {
+    size_t accepted = RESPONSE_MAX_BYTES - bytesSeen;
+    if (accepted > length) {
+        accepted = length;
+    } else if (accepted < length) {
+        overflow = true;
+    }
+    for (size_t i = 0; i < accepted; i++) {
+        scan(static_cast<char>(data[i]));
+    }
+    bytesSeen += accepted;
+    return accepted;
+}
+
+bool ResponseScanner::containsBatchId(const char* batchId) const {
+    for (uint16_t i = 0; i < idCount; i++) {
+        if (strcmp(ids[i], batchId) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ResponseScanner::scan(char c) {
+    if (inString) {
+        if (escaped) {
+            escaped = false;  // Kept verbatim: IDs and UUIDs never contain escapes
+        } else if (c == '\\') {
+            escaped = true;
+            return;
+        } else if (c == '"') {
+            endString();
+            return;
+        }
+
+        if (text) {
+            if (textLength + 1 < textSize) {
+                text[textLength++] = c;
+            } else {
+                text = nullptr;  // Too long for its slot: dropped in endString()
+            }
+        }
+        return;
+    }
+
+    // Only depth 1 (the top-level object) and depth 2 (its arrays) carry fields we want
+    switch (c) {
+        case '"':
+            beginString();
+            break;
+        case '{':
+            depth++;
+            if (depth == 1) {
+                expectingKey = true;
+            }
+            break;
+        case '[':
+            depth++;
+            if (depth == 2 && (keyField == Field::ACKED || keyField == Field::DUPLICATE)) {
+                arrayField = keyField;
+            }
+            break;
+        case '}':
+        case ']':
+            if (depth > 0) {
+                depth--;
+            }
+            if (depth <= 1) {
+                arrayField = Field::NONE;
+            }
+            break;
+        case ',':
+            if (depth == 1) {
+                expectingKey = true;
+                keyField = Field::NONE;
+            }
+            break;
+        default:
+            break;  // Whitespace, ':' and scalar values
+    }
+}
+
+void ResponseScanner::beginString() {
+    inString = true;
+    escaped = false;
+    textLength = 0;
+    text = nullptr;
+    textSize = 0;
+    target = Target::SKIP;
+
+    if (depth == 1 && expectingKey) {
+        target = Target::KEY;
+        text = key;
+        textSize = sizeof(key);
+    } else if (depth == 2 && arrayField != Field::NONE) {
+        if (idCount < RESPONSE_MAX_BATCH_IDS) {
+            target = Target::BATCH_ID;
+            text = ids[idCount];
+            textSize = sizeof(ids[idCount]);
+        } else {
+            overflow = true;
+        }
+    } else if (depth == 1 && keyField == Field::CONFIRMATION) {
+        target = Target::CONFIRMATION;
+        text = confirmation;
+        textSize = sizeof(confirmation);
+    }
+}
+
+void ResponseScanner::endString() {
+    inString = false;
+    bool complete = text != nullptr;
+    if (complete) {
+        text[textLength] = '\0';
+    }
+
+    switch (target) {
+        case Target::KEY:
+            expectingKey = false;
+            keyField = complete ? fieldForKey() : Field::NONE;
+            if (keyField == Field::ACKED) {
+                ackListSeen = true;
+            }
+            break;
+        case Target::BATCH_ID:
+            if (complete) {
+                idCount++;
+            } else {
+                overflow = true;
+            }
+            break;
+        case Target::CONFIRMATION:
+            if (complete) {
+                confirmationSeen = true;
+            } else {
+                confirmation[0] = '\0';
+                overflow = true;
+            }
+            break;
+        case Target::SKIP:
+            break;
+    }
+    text = nullptr;
+}
+
+ResponseScanner::Field ResponseScanner::fieldForKey() const {
+    if (strcmp(key, "acknowledged_batch_ids") == 0) {
+        return Field::ACKED;
+    }
+    if (strcmp(key, "duplicate_batch_ids") == 0) {
+        return Field::DUPLICATE;
+    }
+    if (strcmp(key, "confirmation_id") == 0) {
+        return Field::CONFIRMATION;
+    }
+    return Field::NONE;
+}
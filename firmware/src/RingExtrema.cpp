@@ -0,0 +1,98 @@
+#include "RingExtrema.h"
+
+#include <math.h>
+
+RingExtrema::RingExtrema() : minQueue(), maxQueue(), capacity(0) {}
+
+void RingExtrema::attach(uint16_t* storage, uint16_t ringCapacity) {
+    capacity = ringCapacity;
+    minQueue.slots = storage;
+    maxQueue.slots = storage + ringCapacity;
+    reset();
+}
+
+void RingExtrema::reset() {
+    minQueue.front = 0;
+    minQueue.size = 0;
+    maxQueue.front = 0;
+    maxQueue.size = 0;
+}
+
+void RingExtrema::push(uint16_t slot, const float* minColumn, const float* maxColumn) {
+    if (capacity == 0) {
+        return;
+    }
+    pushBack(minQueue, slot, minColumn, false);
+    pushBack(maxQueue, slot, maxColumn, true);
+}
+
+void RingExtrema::evict(uint16_t slot) {
+    popFront(minQueue, slot);
+    popFront(maxQueue, slot);
+}
+
+void RingExtrema::rebase(uint16_t start) {
+    Deque* queues[2] = {&minQueue, &maxQueue};
+    for (Deque* queue : queues) {
+        for (uint16_t i = 0; i < queue->size; i++) {
+            uint16_t& slot = at(*queue, i);
+            slot = (slot + capacity - start) % capacity;
+        }
+    }
+}
+
+bool RingExtrema::range(const float* minColumn, const float* maxColumn, uint16_t start,
+                        uint16_t fromOffset, float& minValue, float& maxValue) const {
+    uint16_t minIdx = firstFrom(minQueue, start, fromOffset);
+    uint16_t maxIdx = firstFrom(maxQueue, start, fromOffset);
+    if (minIdx == minQueue.size || maxIdx == maxQueue.size) {
+        return false;
+    }
+
+    // The oldest queued entry inside the window dominates everything after it
+    minValue = minColumn[at(minQueue, minIdx)];
+    maxValue = maxColumn[at(maxQueue, maxIdx)];
+    return true;
+}
+
+void RingExtrema::pushBack(Deque& queue, uint16_t slot, const float* column, bool keepMax) {
+    float value = column[slot];
+    if (isnan(value)) {
+        return;
+    }
+
+    // Queued values that the new one beats can never be the extreme again
+    while (queue.size > 0) {
+        float back = column[at(queue, queue.size - 1)];
+        if (keepMax ? back > value : back < value) {
+            break;
+        }
+        queue.size--;
+    }
+    at(queue, queue.size) = slot;
+    queue.size++;
+}
+
+void RingExtrema::popFront(Deque& queue, uint16_t slot) {
+    // Only the oldest queued slot can be the ring's oldest entry
+    if (queue.size > 0 && at(queue, 0) == slot) {
+        queue.front = (queue.front + 1) % capacity;
+        queue.size--;
+    }
+}
+
+uint16_t RingExtrema::firstFrom(const Deque& queue, uint16_t start, uint16_t fromOffset) const {
+    // Queued slots are in ring order, so their ages relative to start are increasing
+    uint16_t low = 0;
+    uint16_t high = queue.size;
+    while (low < high) {
+        uint16_t mid = low + (high - low) / 2;
+        uint16_t age = (at(queue, mid) + capacity - start) % capacity;
+        if (age < fromOffset) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
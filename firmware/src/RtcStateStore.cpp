@@ -0,0 +1,134 @@
+#include "RtcStateStore.h"
+
+#include <string.h>
+
+#include "Crc32.h"
+#include "DataManager.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_attr.h>
+#else
+#define RTC_DATA_ATTR  // Plain static storage on the host
+#endif
+
+namespace {
+
+constexpr uint32_t RTC_IMAGE_MAGIC = 0x31305352;  // "RS01"
+
+struct RtcStateImage {
+    uint32_t magic;
+    uint32_t crc;  // Over every byte after this field
+
+    uint32_t nextSequence;
+    uint32_t clockAtSleepMs;  // Display clock when the image was saved
+    uint32_t sleepDurationMs;
+    uint16_t bufferOverflowCount;
+    uint16_t dataCount;
+    uint16_t displayCount;
+    uint16_t reserved;
+
+    PackedAveragedData data[RTC_STATE_DATA_RECORDS];
+    uint32_t displayTimestamps[RTC_STATE_DISPLAY_POINTS];
+    float displayValues[NUM_SENSORS][RTC_STATE_DISPLAY_POINTS];
+};
+
+// Zeroed at power-on and kept across deep sleep; the CRC also rejects brown-out damage
+RTC_DATA_ATTR RtcStateImage rtcImage;
+
+constexpr size_t CRC_OFFSET = offsetof(RtcStateImage, crc) + sizeof(uint32_t);
+
+uint32_t imageCrc() {
+    return RtcStateStore::crc32(reinterpret_cast<const uint8_t*>(&rtcImage) + CRC_OFFSET,
+                                sizeof(rtcImage) - CRC_OFFSET);
+}
+
+}  // namespace
+
+uint32_t RtcStateStore::crc32(const void* data, size_t length) {
+    return crc32Update(data, length);
+}
+
+bool RtcStateStore::save(DataManager& dataManager, uint32_t nowMs, uint32_t sleepDurationMs) {
+    DataSnapshot view = dataManager.snapshot(nowMs);
+
+    // Newest backlog windows, oldest first
+    uint16_t skipped =
+        view.recordCount > RTC_STATE_DATA_RECORDS ? view.recordCount - RTC_STATE_DATA_RECORDS : 0;
+    rtcImage.dataCount = view.recordCount - skipped;
+    memcpy(rtcImage.data, view.records + skipped, rtcImage.dataCount * sizeof(PackedAveragedData));
+    rtcImage.nextSequence = view.nextSequence;
+    rtcImage.bufferOverflowCount = view.bufferOverflowCount;
+
+    // Newest 1-minute display points
+    uint16_t first = view.displayCount > RTC_STATE_DISPLAY_POINTS
+                         ? view.displayCount - RTC_STATE_DISPLAY_POINTS
+                         : 0;
+    rtcImage.displayCount = view.displayCount - first;
+    memcpy(rtcImage.displayTimestamps, view.displayTimestamps + first,
+           rtcImage.displayCount * sizeof(uint32_t));
+    for (uint8_t s = 0; s < NUM_SENSORS; s++) {
+        memcpy(rtcImage.displayValues[s], view.displayValues[s] + first,
+               rtcImage.displayCount * sizeof(float));
+    }
+
+    rtcImage.clockAtSleepMs = view.displayClockMs;
+    rtcImage.sleepDurationMs = sleepDurationMs;
+    rtcImage.reserved = 0;
+    rtcImage.magic = RTC_IMAGE_MAGIC;
+    rtcImage.crc = imageCrc();
+    return skipped == 0;
+}
+
+bool RtcStateStore::restore(DataManager& dataManager, uint32_t nowMs, uint32_t sleptMs) {
+    if (!hasValidImage()) {
+        return false;
+    }
+    // One-shot: a later reset without a fresh save must not replay the same windows
+    invalidate();
+
+    DataRestoreTarget target = dataManager.beginRestore();
+    if (!target.records) {
+        return false;
+    }
+
+    // Newest entries win if the rings are smaller than the image
+    uint16_t records = rtcImage.dataCount;
+    uint16_t dropped = records > target.recordCapacity ? records - target.recordCapacity : 0;
+    records -= dropped;
+    memcpy(target.records, rtcImage.data + dropped, records * sizeof(PackedAveragedData));
+
+    uint16_t points = rtcImage.displayCount;
+    uint16_t first = points > target.displayCapacity ? points - target.displayCapacity : 0;
+    points -= first;
+    memcpy(target.displayTimestamps, rtcImage.displayTimestamps + first,
+           points * sizeof(uint32_t));
+    for (uint8_t s = 0; s < NUM_SENSORS; s++) {
+        memcpy(target.displayValues[s], rtcImage.displayValues[s] + first,
+               points * sizeof(float));
+    }
+
+    if (sleptMs == SLEPT_AS_PLANNED) {
+        sleptMs = rtcImage.sleepDurationMs;
+    }
+    return dataManager.commitRestore(records, rtcImage.nextSequence,
+                                     rtcImage.bufferOverflowCount + dropped, points,
+                                     rtcImage.clockAtSleepMs + sleptMs, nowMs);
+}
+
+bool RtcStateStore::hasValidImage() {
+    return rtcImage.magic == RTC_IMAGE_MAGIC && rtcImage.dataCount <= RTC_STATE_DATA_RECORDS &&
+           rtcImage.displayCount <= RTC_STATE_DISPLAY_POINTS && rtcImage.crc == imageCrc();
+}
+
+void RtcStateStore::invalidate() {
+    rtcImage.magic = 0;
+}
+
+uint16_t RtcStateStore::getDataCount() {
+    return rtcImage.dataCount;
+}
+
+uint16_t RtcStateStore::getDisplayCount() {
+    return rtcImage.displayCount;
+}
@@ -1,39 +1,87 @@
 #include "SensorManager.h"
 
 #include "PinConfig.h"
+#include "models/SensorDescriptor.h"
 
 #ifdef UNIT_TEST
 #include "MockSensor.h"
+#include "SensorTrace.h"
 #endif
 
-// Sensor status bit positions
-#define SENSOR_BME280_BIT 0
-#define SENSOR_DS18B20_BIT 1
-#define SENSOR_SOIL_BIT 2
-
 // Default calibration values (uncalibrated state)
 #define DEFAULT_SOIL_DRY_ADC 3000
 #define DEFAULT_SOIL_WET_ADC 1500
 
-// Physical range constants for validation
-#define BME280_TEMP_MIN -40.0f
-#define BME280_TEMP_MAX 85.0f
-#define BME280_HUMIDITY_MIN 0.0f
-#define BME280_HUMIDITY_MAX 100.0f
-#define BME280_PRESSURE_MIN 300.0f
-#define BME280_PRESSURE_MAX 1100.0f
-#define DS18B20_TEMP_MIN -55.0f
-#define DS18B20_TEMP_MAX 125.0f
+// DallasTemperature's value for a probe that did not answer (physical ranges are in
+// SENSOR_DESCRIPTORS)
 #define DEVICE_DISCONNECTED_C -127.0f
 
+// DS18B20 resolution limits and conversion time at 12-bit resolution
+#define DS18B20_MIN_RESOLUTION 9
+#define DS18B20_MAX_RESOLUTION 12
+#define DS18B20_CONVERSION_TIME_12BIT_MS 750
+
+#ifndef UNIT_TEST
+// Set once a cold boot has probed the buses; RTC memory is garbage after power loss
+#define PROBE_CACHE_MAGIC 0x50524F42  // "PROB"
+
+namespace {
+
+// Probe results kept in RTC slow memory across deep sleep
+struct ProbeCache {
+    uint32_t magic;
+    uint8_t sensorStatus;  // BME280 and DS18B20 bits found at the last cold boot
+    uint8_t bme280Address;
+    uint8_t ds18b20ProbeCount;
+    uint8_t ds18b20Addresses[MAX_DS18B20_PROBES][8];
+};
+
+RTC_DATA_ATTR ProbeCache probeCache;
+
+}  // namespace
+#endif
+
 SensorManager::SensorManager()
     : oneWire(nullptr),
       ds18b20(nullptr),
       soilDryAdc(DEFAULT_SOIL_DRY_ADC),
       soilWetAdc(DEFAULT_SOIL_WET_ADC),
-      sensorStatus(0) {}
+      sensorStatus(0),
+      latestReadings(),
+      latestReadingsValid(false),
+      bme280Divisor(1),
+      ds18b20Divisor(1),
+      soilDivisor(1),
+      readCycle(0),
+      bme280Profile(Bme280Profile::WEATHER_STATION),
+      ds18b20Resolution(DS18B20_MAX_RESOLUTION),
+      ds18b20ConversionTimeMs(DS18B20_CONVERSION_TIME_12BIT_MS),
+      ds18b20Addresses(),
+      ds18b20ProbeCount(0),
+      ds18b20ConversionPending(false),
+      ds18b20ConversionStartMs(0),
+      ds18b20HasValue(false),
+      ds18b20LastTemps(),
+      ds18b20LastReadMs(0),
+      soilFilter()
+#ifdef UNIT_TEST
+      ,
+      trace(nullptr)
+#else
+      ,
+      soilSampleTimer(nullptr),
+      soilSampleMux(portMUX_INITIALIZER_UNLOCKED),
+      latestReadingsMux(portMUX_INITIALIZER_UNLOCKED)
+#endif
+{
+    soilFilter.setWindow(DEFAULT_SOIL_SAMPLE_WINDOW);
+    for (uint8_t i = 0; i < MAX_DS18B20_PROBES; i++) {
+        ds18b20LastTemps[i] = DEVICE_DISCONNECTED_C;
+    }
+}
 
 SensorManager::~SensorManager() {
+    stopSoilSampler();
     if (ds18b20) {
         delete ds18b20;
         ds18b20 = nullptr;
@@ -44,30 +92,61 @@ SensorManager::~SensorManager() {
     }
 }
 
-void SensorManager::initialize() {
+void SensorManager::initialize(bool warmStart) {
     sensorStatus = 0;
 
 #ifdef UNIT_TEST
     // Mock mode - all sensors available
+    (void)warmStart;
     sensorStatus = (1 << SENSOR_BME280_BIT) | (1 << SENSOR_DS18B20_BIT) | (1 << SENSOR_SOIL_BIT);
+    ds18b20ProbeCount = 1;
     return;
 #else
-    // Real hardware mode - initialize sensors with retry logic
+    // Real hardware mode. A wake from deep sleep skips bus discovery when the
+    // cached sensors still answer
+    if (!warmStart || !restoreProbes()) {
+        probeSensors();
+    }
+
+    // Configure ADC for soil moisture (no retry needed for ADC configuration)
+    analogSetAttenuation(ADC_ATTENUATION);
+    analogSetWidth(ADC_WIDTH);
+
+    // Test ADC by reading once
+    uint16_t testAdc = analogRead(SOIL_MOISTURE_PIN);
+    if (testAdc >= 0 && testAdc <= 4095) {
+        sensorStatus |= (1 << SENSOR_SOIL_BIT);
 
+        // Fill the sample ring in the background so reads never block
+        startSoilSampler();
+    }
+#endif
+}
+
+#ifndef UNIT_TEST
+void SensorManager::probeSensors() {
     // Initialize BME280 via I2C (3 retry attempts)
     bool bme280Success = false;
+    uint8_t bme280Address = 0;
     for (int attempt = 0; attempt < 3 && !bme280Success; attempt++) {
         if (bme280.begin(0x76)) {  // Try default address 0x76
             bme280Success = true;
+            bme280Address = 0x76;
             sensorStatus |= (1 << SENSOR_BME280_BIT);
         } else if (bme280.begin(0x77)) {  // Try alternate address 0x77
             bme280Success = true;
+            bme280Address = 0x77;
             sensorStatus |= (1 << SENSOR_BME280_BIT);
         } else {
             delay(1000);  // Wait 1 second before retry
         }
     }
 
+    // Replace begin() defaults with the configured acquisition profile
+    if (bme280Success) {
+        applyBme280Profile();
+    }
+
     // Initialize DS18B20 via OneWire (3 retry attempts)
     bool ds18b20Success = false;
     for (int attempt = 0; attempt < 3 && !ds18b20Success; attempt++) {
@@ -80,13 +159,19 @@ void SensorManager::initialize() {
 
         ds18b20->begin();
         delay(100);  // Give sensor time to initialize
+        ds18b20->setResolution(ds18b20Resolution);
+
+        // Walk the bus once and cache every probe's ROM address
+        enumerateDS18B20Probes();
 
-        // Test if sensor responds
+        // Test if sensors respond (one broadcast conversion, fetched by address)
         ds18b20->requestTemperatures();
-        delay(750);  // Wait for conversion (750ms for 12-bit resolution)
-        float testTemp = ds18b20->getTempCByIndex(0);
+        delay(ds18b20ConversionTimeMs);  // Wait for conversion at configured resolution
+        ds18b20ConversionPending = true;
+        ds18b20ConversionStartMs = millis() - ds18b20ConversionTimeMs;
 
-        if (testTemp != DEVICE_DISCONNECTED_C) {
+        // Seeds the cache with the test conversion on success
+        if (ds18b20ProbeCount > 0 && collectDS18B20Conversion()) {
             ds18b20Success = true;
             sensorStatus |= (1 << SENSOR_DS18B20_BIT);
         } else {
@@ -94,17 +179,69 @@ void SensorManager::initialize() {
         }
     }
 
-    // Configure ADC for soil moisture (no retry needed for ADC configuration)
-    analogSetAttenuation(ADC_ATTENUATION);
-    analogSetWidth(ADC_WIDTH);
+    // Switch to asynchronous conversions and start the first one
+    if (ds18b20Success) {
+        ds18b20->setWaitForConversion(false);
+        startDS18B20Conversion();
+    }
 
-    // Test ADC by reading once
-    uint16_t testAdc = analogRead(SOIL_MOISTURE_PIN);
-    if (testAdc >= 0 && testAdc <= 4095) {
-        sensorStatus |= (1 << SENSOR_SOIL_BIT);
+    saveProbes(bme280Address);
+}
+
+bool SensorManager::restoreProbes() {
+    if (probeCache.magic != PROBE_CACHE_MAGIC) {
+        return false;  // First boot after power loss
     }
-#endif
+
+    // Sensors absent at the last cold boot are not probed again until the next one
+    if (probeCache.sensorStatus & (1 << SENSOR_BME280_BIT)) {
+        if (!bme280.begin(probeCache.bme280Address)) {
+            return false;
+        }
+        sensorStatus |= (1 << SENSOR_BME280_BIT);
+        applyBme280Profile();
+    }
+
+    if (probeCache.sensorStatus & (1 << SENSOR_DS18B20_BIT)) {
+        if (!oneWire) {
+            oneWire = new OneWire(ONEWIRE_PIN);
+        }
+        if (!ds18b20) {
+            ds18b20 = new DallasTemperature(oneWire);
+        }
+
+        // Cached ROM codes replace the bus search; one scratchpad read confirms the bus
+        ds18b20ProbeCount = probeCache.ds18b20ProbeCount;
+        memcpy(ds18b20Addresses, probeCache.ds18b20Addresses, sizeof(ds18b20Addresses));
+        if (ds18b20ProbeCount == 0 || !ds18b20->isConnected(ds18b20Addresses[0])) {
+            sensorStatus = 0;
+            ds18b20ProbeCount = 0;
+            return false;
+        }
+        for (uint8_t i = 0; i < ds18b20ProbeCount; i++) {
+            ds18b20->setResolution(ds18b20Addresses[i], ds18b20Resolution);
+        }
+        sensorStatus |= (1 << SENSOR_DS18B20_BIT);
+
+        // No test conversion: the first read waits for whatever is left of this one
+        ds18b20->setWaitForConversion(false);
+        startDS18B20Conversion();
+    }
+
+    Serial.printf("[INFO] SensorManager: Warm start from RTC probe cache (%u DS18B20)\n",
+                  ds18b20ProbeCount);
+    return true;
+}
+
+void SensorManager::saveProbes(uint8_t bme280Address) {
+    probeCache.sensorStatus =
+        sensorStatus & ((1 << SENSOR_BME280_BIT) | (1 << SENSOR_DS18B20_BIT));
+    probeCache.bme280Address = bme280Address;
+    probeCache.ds18b20ProbeCount = ds18b20ProbeCount;
+    memcpy(probeCache.ds18b20Addresses, ds18b20Addresses, sizeof(ds18b20Addresses));
+    probeCache.magic = PROBE_CACHE_MAGIC;
 }
+#endif
 
 SensorReadings SensorManager::readSensors() {
     SensorReadings readings = {};
@@ -117,18 +254,58 @@ SensorReadings SensorManager::readSensors() {
     readings.humidity = MockSensor::BME280_HUMIDITY_PCT;
     readings.pressure = MockSensor::BME280_PRESSURE_HPA;
     readings.ds18b20Temp = MockSensor::DS18B20_TEMP_C;
+    readings.ds18b20AgeMs = 0;
+    readings.ds18b20ProbeCount = 1;
+    readings.ds18b20Probes[0] = MockSensor::DS18B20_TEMP_C;
     readings.soilMoistureRaw = MockSensor::SOIL_MOISTURE_RAW;
     readings.soilMoisture = convertSoilMoistureToPercent(readings.soilMoistureRaw);
     readings.sensorStatus = sensorStatus;  // Use initialized sensor status
+
+    TraceSample sample;
+    if (trace && trace->sample(readings.monotonicMs, sample)) {
+        readings.bme280Temp = sample.bme280Temp;
+        readings.humidity = sample.humidity;
+        readings.pressure = sample.pressure;
+        readings.ds18b20Temp = sample.ds18b20Temp;
+        readings.ds18b20Probes[0] = sample.ds18b20Temp;
+        readings.soilMoistureRaw = sample.soilMoistureRaw;
+        readings.soilMoisture = convertSoilMoistureToPercent(sample.soilMoistureRaw);
+        readings.sensorStatus &= ~sample.missingMask;
+
+        // A sensor that did not answer leaves its fields zeroed, as on hardware
+        if (sample.missingMask & (1 << SENSOR_BME280_BIT)) {
+            readings.bme280Temp = readings.humidity = readings.pressure = 0.0f;
+        }
+        if (sample.missingMask & (1 << SENSOR_DS18B20_BIT)) {
+            readings.ds18b20Temp = readings.ds18b20Probes[0] = 0.0f;
+            readings.ds18b20ProbeCount = 0;
+        }
+        if (sample.missingMask & (1 << SENSOR_SOIL_BIT)) {
+            readings.soilMoistureRaw = 0;
+            readings.soilMoisture = 0.0f;
+        }
+    }
+
+    latestReadings = readings;
+    latestReadingsValid = true;
     return readings;
 #else
     // Real hardware mode - read from actual sensors
 
+    // Sensors not due this cycle carry their last sample forward (see setSampleDivisors)
+    const SensorReadings& previous = latestReadings;
+
     // Read BME280 (temperature, humidity, pressure)
-    if (sensorStatus & (1 << SENSOR_BME280_BIT)) {
-        readings.bme280Temp = readBME280Temperature();
-        readings.humidity = readBME280Humidity();
-        readings.pressure = readBME280Pressure();
+    if ((sensorStatus & (1 << SENSOR_BME280_BIT)) && !isDue(bme280Divisor)) {
+        readings.bme280Temp = previous.bme280Temp;
+        readings.humidity = previous.humidity;
+        readings.pressure = previous.pressure;
+        readings.sensorStatus |= previous.sensorStatus & (1 << SENSOR_BME280_BIT);
+        readings.staleMask |= (1 << SENSOR_BME280_BIT);
+    } else if (sensorStatus & (1 << SENSOR_BME280_BIT)) {
+        uint32_t startUs = micros();
+        readBME280(readings);
+        readings.readLatencyUs[SENSOR_BME280_BIT] = micros() - startUs;
 
         // Validate readings
         if (validateReading(SensorType::BME280_TEMP, readings.bme280Temp) &&
@@ -138,19 +315,67 @@ SensorReadings SensorManager::readSensors() {
         }
     }
 
-    // Read DS18B20 (temperature)
-    if (sensorStatus & (1 << SENSOR_DS18B20_BIT)) {
-        readings.ds18b20Temp = readDS18B20Temperature();
+    // Read DS18B20 (temperature) - last completed conversion, never blocks
+    if ((sensorStatus & (1 << SENSOR_DS18B20_BIT)) && !isDue(ds18b20Divisor)) {
+        readings.ds18b20Temp = previous.ds18b20Temp;
+        readings.ds18b20ProbeCount = previous.ds18b20ProbeCount;
+        for (uint8_t i = 0; i < MAX_DS18B20_PROBES; i++) {
+            readings.ds18b20Probes[i] = previous.ds18b20Probes[i];
+        }
+        readings.ds18b20AgeMs = readings.monotonicMs - ds18b20LastReadMs;
+        readings.sensorStatus |= previous.sensorStatus & (1 << SENSOR_DS18B20_BIT);
+        readings.staleMask |= (1 << SENSOR_DS18B20_BIT);
+
+        // Start the conversion one cycle ahead of the next due read
+        if (!ds18b20ConversionPending && isDue(ds18b20Divisor, 1)) {
+            startDS18B20Conversion();
+        }
+    } else if (sensorStatus & (1 << SENSOR_DS18B20_BIT)) {
+        // First read after a warm start: wait out the rest of the seed conversion
+        if (!ds18b20HasValue && ds18b20ConversionPending) {
+            uint32_t elapsedMs = millis() - ds18b20ConversionStartMs;
+            if (elapsedMs < ds18b20ConversionTimeMs) {
+                delay(ds18b20ConversionTimeMs - elapsedMs);
+            }
+        }
+
+        // Scratchpad fetch time only; the conversion itself runs in the background
+        uint32_t startUs = micros();
+        collectDS18B20Conversion();
+        readings.readLatencyUs[SENSOR_DS18B20_BIT] = micros() - startUs;
+
+        if (ds18b20HasValue) {
+            readings.ds18b20ProbeCount = ds18b20ProbeCount;
+            for (uint8_t i = 0; i < ds18b20ProbeCount; i++) {
+                readings.ds18b20Probes[i] = ds18b20LastTemps[i];
+            }
+            readings.ds18b20Temp = ds18b20LastTemps[0];
+            readings.ds18b20AgeMs = readings.monotonicMs - ds18b20LastReadMs;
+
+            // Validate reading
+            if (validateReading(SensorType::DS18B20_TEMP, readings.ds18b20Temp)) {
+                readings.sensorStatus |= (1 << SENSOR_DS18B20_BIT);
+            }
+        } else {
+            readings.ds18b20Temp = DEVICE_DISCONNECTED_C;
+        }
 
-        // Validate reading
-        if (validateReading(SensorType::DS18B20_TEMP, readings.ds18b20Temp)) {
-            readings.sensorStatus |= (1 << SENSOR_DS18B20_BIT);
+        // Kick off the next conversion so it is ready by the following read
+        if (!ds18b20ConversionPending && isDue(ds18b20Divisor, 1)) {
+            startDS18B20Conversion();
         }
     }
 
     // Read soil moisture with ADC averaging
-    if (sensorStatus & (1 << SENSOR_SOIL_BIT)) {
+    if ((sensorStatus & (1 << SENSOR_SOIL_BIT)) && !isDue(soilDivisor)) {
+        readings.soilMoistureRaw = previous.soilMoistureRaw;
+        readings.soilMoisture = previous.soilMoisture;
+        readings.sensorStatus |= previous.sensorStatus & (1 << SENSOR_SOIL_BIT);
+        readings.staleMask |= (1 << SENSOR_SOIL_BIT);
+    } else if (sensorStatus & (1 << SENSOR_SOIL_BIT)) {
+        uint32_t startUs = micros();
         readings.soilMoistureRaw = readSoilMoistureRaw();
+        readings.readLatencyUs[SENSOR_SOIL_BIT] = micros() - startUs;
         readings.soilMoisture = convertSoilMoistureToPercent(readings.soilMoistureRaw);
 
         // Validate reading (ADC should be in valid range)
@@ -159,24 +384,49 @@ SensorReadings SensorManager::readSensors() {
         }
     }
 
+    readCycle++;
+
+    portENTER_CRITICAL(&latestReadingsMux);
+    latestReadings = readings;
+    latestReadingsValid = true;
+    portEXIT_CRITICAL(&latestReadingsMux);
     return readings;
 #endif
 }
 
+SensorReadings SensorManager::getLatestReadings() const {
+#ifndef UNIT_TEST
+    portENTER_CRITICAL(&latestReadingsMux);
+    SensorReadings copy = latestReadings;
+    portEXIT_CRITICAL(&latestReadingsMux);
+    return copy;
+#else
+    return latestReadings;
+#endif
+}
+
+bool SensorManager::hasLatestReadings() const {
+    return latestReadingsValid;
+}
+
+void SensorManager::update() {
+#ifndef UNIT_TEST
+    if (sensorStatus & (1 << SENSOR_DS18B20_BIT)) {
+        collectDS18B20Conversion();
+    }
+#endif
+}
+
+uint8_t SensorManager::getDS18B20ProbeCount() const {
+    return ds18b20ProbeCount;
+}
+
 bool SensorManager::isSensorAvailable(SensorType type) {
-    // Check sensor status bitmask for the given sensor type
-    switch (type) {
-        case SensorType::BME280_TEMP:
-        case SensorType::HUMIDITY:
-        case SensorType::PRESSURE:
-            return (sensorStatus & (1 << SENSOR_BME280_BIT)) != 0;
-        case SensorType::DS18B20_TEMP:
-            return (sensorStatus & (1 << SENSOR_DS18B20_BIT)) != 0;
-        case SensorType::SOIL_MOISTURE:
-            return (sensorStatus & (1 << SENSOR_SOIL_BIT)) != 0;
-        default:
-            return false;
+    // Check the status bit of the bus that measures the given sensor type
+    if (static_cast<uint8_t>(type) >= NUM_SENSORS) {
+        return false;
     }
+    return (sensorStatus & (1 << sensorDescriptor(type).busBit)) != 0;
 }
 
 void SensorManager::calibrateSoilMoisture(uint16_t dryAdc, uint16_t wetAdc) {
@@ -197,8 +447,184 @@ void SensorManager::calibrateSoilMoisture(uint16_t dryAdc, uint16_t wetAdc) {
     soilWetAdc = wetAdc;
 }
 
+uint16_t SensorManager::soilPercentToRaw(float percent) const {
+    if (percent < 0.0f) {
+        percent = 0.0f;
+    }
+    if (percent > 100.0f) {
+        percent = 100.0f;
+    }
+    float raw = soilDryAdc + ((float)soilWetAdc - (float)soilDryAdc) * percent / 100.0f;
+    return (uint16_t)(raw + 0.5f);
+}
+
+void SensorManager::convertSoilAggregate(const SoilAggregate& aggregate, RunningStats& stats) {
+    stats.reset();
+    if (aggregate.count == 0) {
+        return;
+    }
+
+    // Wet reads lower than dry on capacitive probes, so the raw extremes may swap
+    float rawMean = (float)aggregate.sumRaw / aggregate.count;
+    float mean = convertSoilMoistureToPercent((uint16_t)(rawMean + 0.5f));
+    float fromMin = convertSoilMoistureToPercent(aggregate.minRaw);
+    float fromMax = convertSoilMoistureToPercent(aggregate.maxRaw);
+
+    stats.count = aggregate.count;
+    stats.sum = mean * aggregate.count;
+    stats.min = fromMin < fromMax ? fromMin : fromMax;
+    stats.max = fromMin < fromMax ? fromMax : fromMin;
+    stats.welfordMean = mean;
+}
+
+void SensorManager::setDS18B20Resolution(uint8_t bits) {
+    if (bits < DS18B20_MIN_RESOLUTION) {
+        bits = DS18B20_MIN_RESOLUTION;
+    }
+    if (bits > DS18B20_MAX_RESOLUTION) {
+        bits = DS18B20_MAX_RESOLUTION;
+    }
+
+    ds18b20Resolution = bits;
+    // Conversion time halves with each bit removed
+    ds18b20ConversionTimeMs = DS18B20_CONVERSION_TIME_12BIT_MS >> (DS18B20_MAX_RESOLUTION - bits);
+
+#ifndef UNIT_TEST
+    if (ds18b20) {
+        ds18b20->setResolution(bits);
+    }
+#endif
+}
+
+void SensorManager::setSampleDivisors(uint16_t bme280Every, uint16_t ds18b20Every,
+                                      uint16_t soilEvery) {
+    bme280Divisor = bme280Every > 0 ? bme280Every : 1;
+    ds18b20Divisor = ds18b20Every > 0 ? ds18b20Every : 1;
+    soilDivisor = soilEvery > 0 ? soilEvery : 1;
+}
+
+uint16_t SensorManager::intervalToDivisor(uint32_t sensorIntervalMs, uint32_t baseIntervalMs) {
+    if (sensorIntervalMs == 0 || baseIntervalMs == 0 || sensorIntervalMs <= baseIntervalMs) {
+        return 1;
+    }
+    // Round to the nearest whole number of base reading intervals
+    uint32_t divisor = (sensorIntervalMs + baseIntervalMs / 2) / baseIntervalMs;
+    return divisor > 0xFFFF ? 0xFFFF : (uint16_t)divisor;
+}
+
+bool SensorManager::isDue(uint16_t divisor, uint8_t cyclesAhead) const {
+    // The first read always samples every sensor
+    if (divisor <= 1 || (readCycle == 0 && cyclesAhead == 0)) {
+        return true;
+    }
+    return (readCycle + cyclesAhead) % divisor == 0;
+}
+
+void SensorManager::setSoilSampleWindow(uint8_t window) {
+    if (window < 1) {
+        window = 1;
+    }
+    if (window > SOIL_SAMPLE_RING_SIZE) {
+        window = SOIL_SAMPLE_RING_SIZE;
+    }
+
+#ifndef UNIT_TEST
+    portENTER_CRITICAL(&soilSampleMux);
+    soilFilter.setWindow(window);
+    portEXIT_CRITICAL(&soilSampleMux);
+#else
+    soilFilter.setWindow(window);
+#endif
+}
+
+void SensorManager::setBme280Profile(Bme280Profile profile) {
+    bme280Profile = profile;
+    if (sensorStatus & (1 << SENSOR_BME280_BIT)) {
+        applyBme280Profile();
+    }
+}
+
+// Soil moisture background sampler
+
+void SensorManager::startSoilSampler() {
+#ifndef UNIT_TEST
+    if (soilSampleTimer) {
+        return;
+    }
+
+    esp_timer_create_args_t args = {};
+    args.callback = &SensorManager::soilSampleCallback;
+    args.arg = this;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "soil_adc";
+
+    if (esp_timer_create(&args, &soilSampleTimer) != ESP_OK) {
+        soilSampleTimer = nullptr;
+        return;
+    }
+    esp_timer_start_periodic(soilSampleTimer, SOIL_SAMPLE_PERIOD_US);
+#endif
+}
+
+void SensorManager::stopSoilSampler() {
+#ifndef UNIT_TEST
+    if (soilSampleTimer) {
+        esp_timer_stop(soilSampleTimer);
+        esp_timer_delete(soilSampleTimer);
+        soilSampleTimer = nullptr;
+    }
+#endif
+}
+
+void SensorManager::soilSampleCallback(void* arg) {
+#ifndef UNIT_TEST
+    SensorManager* self = static_cast<SensorManager*>(arg);
+    uint16_t sample = analogRead(SOIL_MOISTURE_PIN);
+
+    portENTER_CRITICAL(&self->soilSampleMux);
+    self->soilFilter.push(sample);
+    portEXIT_CRITICAL(&self->soilSampleMux);
+#else
+    (void)arg;
+#endif
+}
+
 // Private helper methods
 
+void SensorManager::applyBme280Profile() {
+#ifndef UNIT_TEST
+    switch (bme280Profile) {
+        case Bme280Profile::WEATHER_STATION:
+            // Bosch "weather monitoring" recommendation: one forced conversion per read
+            bme280.setSampling(Adafruit_BME280::MODE_FORCED, Adafruit_BME280::SAMPLING_X1,
+                               Adafruit_BME280::SAMPLING_X1, Adafruit_BME280::SAMPLING_X1,
+                               Adafruit_BME280::FILTER_OFF);
+            break;
+        case Bme280Profile::HIGH_PRECISION:
+            bme280.setSampling(Adafruit_BME280::MODE_NORMAL, Adafruit_BME280::SAMPLING_X2,
+                               Adafruit_BME280::SAMPLING_X16, Adafruit_BME280::SAMPLING_X1,
+                               Adafruit_BME280::FILTER_X16, Adafruit_BME280::STANDBY_MS_0_5);
+            break;
+        case Bme280Profile::LIBRARY_DEFAULT:
+        default:
+            bme280.setSampling();
+            break;
+    }
+#endif
+}
+
+void SensorManager::readBME280(SensorReadings& readings) {
+#ifndef UNIT_TEST
+    // Forced mode: trigger a single conversion covering all three channels
+    if (bme280Profile == Bme280Profile::WEATHER_STATION) {
+        bme280.takeForcedMeasurement();
+    }
+#endif
+    readings.bme280Temp = readBME280Temperature();
+    readings.humidity = readBME280Humidity();
+    readings.pressure = readBME280Pressure();
+}
+
 float SensorManager::readBME280Temperature() {
 #ifdef UNIT_TEST
     return MockSensor::BME280_TEMP_C;
@@ -224,22 +650,76 @@ float SensorManager::readBME280Pressure() {
 #endif
 }
 
-float SensorManager::readDS18B20Temperature() {
-#ifdef UNIT_TEST
-    return MockSensor::DS18B20_TEMP_C;
-#else
+void SensorManager::startDS18B20Conversion() {
+#ifndef UNIT_TEST
     if (!ds18b20) {
-        return DEVICE_DISCONNECTED_C;
+        return;
     }
 
-    // Request temperature conversion
+    // Broadcast conversion request; returns immediately with waitForConversion disabled
     ds18b20->requestTemperatures();
+#endif
+    ds18b20ConversionPending = true;
+    ds18b20ConversionStartMs = millis();
+}
+
+bool SensorManager::collectDS18B20Conversion() {
+    if (!ds18b20ConversionPending) {
+        return false;
+    }
+
+    // Conversion still in progress
+    if (millis() - ds18b20ConversionStartMs < ds18b20ConversionTimeMs) {
+        return false;
+    }
+
+    ds18b20ConversionPending = false;
+
+#ifndef UNIT_TEST
+    if (!ds18b20) {
+        return false;
+    }
+#endif
+
+    // Fetch each probe by cached address (no bus search per read)
+    bool anyValid = false;
+    for (uint8_t i = 0; i < ds18b20ProbeCount; i++) {
+#ifdef UNIT_TEST
+        float temp = MockSensor::DS18B20_TEMP_C;
+#else
+        float temp = ds18b20->getTempC(ds18b20Addresses[i]);
+#endif
+
+        // Keep the previous value if the probe dropped off the bus
+        if (temp != DEVICE_DISCONNECTED_C) {
+            ds18b20LastTemps[i] = temp;
+            anyValid = true;
+        }
+    }
+
+    if (!anyValid) {
+        return false;
+    }
 
-    // Wait for conversion (750ms for 12-bit resolution)
-    delay(750);
+    ds18b20HasValue = true;
+    ds18b20LastReadMs = millis();
+    return true;
+}
+
+void SensorManager::enumerateDS18B20Probes() {
+    ds18b20ProbeCount = 0;
+
+#ifndef UNIT_TEST
+    if (!ds18b20) {
+        return;
+    }
 
-    // Read temperature
-    return ds18b20->getTempCByIndex(0);
+    uint8_t found = ds18b20->getDeviceCount();
+    for (uint8_t i = 0; i < found && ds18b20ProbeCount < MAX_DS18B20_PROBES; i++) {
+        if (ds18b20->getAddress(ds18b20Addresses[ds18b20ProbeCount], i)) {
+            ds18b20ProbeCount++;
+        }
+    }
 #endif
 }
 
@@ -252,18 +732,18 @@ uint16_t SensorManager::readSoilMoistureRaw() {
 #ifdef UNIT_TEST
     return MockSensor::SOIL_MOISTURE_RAW;
 #else
-    // Multi-sample averaging to reduce noise (15 samples)
-    const int NUM_SAMPLES = 15;
-    uint32_t sum = 0;
-
-    for (int i = 0; i < NUM_SAMPLES; i++) {
-        sum += analogRead(SOIL_MOISTURE_PIN);
-        delay(10);  // Small delay between samples
+    // Reduce the incrementally maintained sample window (no bus wait)
+    portENTER_CRITICAL(&soilSampleMux);
+    uint8_t n = soilFilter.size();
+    uint16_t value = soilFilter.trimmedMean(n / 4);
+    portEXIT_CRITICAL(&soilSampleMux);
+
+    // Sampler not running yet - fall back to a single direct conversion
+    if (n == 0) {
+        return analogRead(SOIL_MOISTURE_PIN);
     }
 
-    // Calculate average
-    uint16_t average = sum / NUM_SAMPLES;
-    return average;
+    return value;
 #endif
 }
 
@@ -288,19 +768,12 @@ float SensorManager::convertSoilMoistureToPercent(uint16_t rawAdc) {
 
 bool SensorManager::validateReading(SensorType type, float value) {
     // Check if value is within physically possible range for sensor type
-    switch (type) {
-        case SensorType::BME280_TEMP:
-            return (value >= BME280_TEMP_MIN && value <= BME280_TEMP_MAX);
-        case SensorType::DS18B20_TEMP:
-            return (value >= DS18B20_TEMP_MIN && value <= DS18B20_TEMP_MAX &&
-                    value != DEVICE_DISCONNECTED_C);
-        case SensorType::HUMIDITY:
-            return (value >= BME280_HUMIDITY_MIN && value <= BME280_HUMIDITY_MAX);
-        case SensorType::PRESSURE:
-            return (value >= BME280_PRESSURE_MIN && value <= BME280_PRESSURE_MAX);
-        case SensorType::SOIL_MOISTURE:
-            return (value >= 0.0f && value <= 100.0f);
-        default:
-            return false;
+    if (static_cast<uint8_t>(type) >= NUM_SENSORS) {
+        return false;
+    }
+    const SensorDescriptor& sensor = sensorDescriptor(type);
+    if (type == SensorType::DS18B20_TEMP && value == DEVICE_DISCONNECTED_C) {
+        return false;
     }
+    return value >= sensor.minValid && value <= sensor.maxValid;
 }
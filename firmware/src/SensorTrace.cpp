@@ -0,0 +1,272 @@
+#include "SensorTrace.h"
+
+#ifdef UNIT_TEST
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "models/SensorReadings.h"
+
+#define TRACE_DAY_MS 86400000UL
+#define TRACE_WARMEST_MS (15UL * 3600000UL)  // 15:00
+#define TRACE_PROBE_LAG_MS (3UL * 3600000UL)  // Soil warms and cools 3 h behind the air
+#define TRACE_FRONT_PERIOD_MS (3UL * TRACE_DAY_MS)
+#define TRACE_CSV_FIELDS 6
+#define TRACE_TWO_PI 6.28318530718f
+
+namespace {
+
+uint32_t readLe32(const uint8_t* bytes) {
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+// Phase of a daily cycle that peaks at peakMs, in [-1, 1]
+float dailyWave(uint32_t traceMs, uint32_t peakMs) {
+    uint32_t offset = (traceMs + TRACE_DAY_MS - peakMs % TRACE_DAY_MS) % TRACE_DAY_MS;
+    return cosf(TRACE_TWO_PI * offset / TRACE_DAY_MS);
+}
+
+}  // namespace
+
+SensorTrace::SensorTrace() : samples(), profile(), synthetic(false), looping(false), startMs(0) {}
+
+bool SensorTrace::parseCsvLine(const char* line, TraceSample& out) {
+    out = {};
+    const char* cursor = line;
+    for (uint8_t field = 0; field < TRACE_CSV_FIELDS; field++) {
+        const char* end = strchr(cursor, ',');
+        size_t length = end ? static_cast<size_t>(end - cursor) : strlen(cursor);
+        if ((end == nullptr) != (field == TRACE_CSV_FIELDS - 1)) {
+            return false;  // Wrong number of fields
+        }
+
+        char text[32];
+        if (length >= sizeof(text)) {
+            return false;
+        }
+        memcpy(text, cursor, length);
+        text[length] = '\0';
+
+        char* parsedEnd = text;
+        bool empty = length == 0;
+        if (field == 0) {
+            out.timeMs = static_cast<uint32_t>(strtoul(text, &parsedEnd, 10));
+            if (empty) {
+                return false;  // Every sample needs a time
+            }
+        } else if (field == 5) {
+            out.soilMoistureRaw = static_cast<uint16_t>(strtoul(text, &parsedEnd, 10));
+            if (empty) {
+                out.missingMask |= (1 << SENSOR_SOIL_BIT);
+            }
+        } else {
+            float value = strtof(text, &parsedEnd);
+            float* targets[] = {&out.bme280Temp, &out.humidity, &out.pressure, &out.ds18b20Temp};
+            *targets[field - 1] = value;
+            if (empty) {
+                out.missingMask |=
+                    field == 4 ? (1 << SENSOR_DS18B20_BIT) : (1 << SENSOR_BME280_BIT);
+            }
+        }
+        if (!empty && *parsedEnd != '\0') {
+            return false;  // Trailing junk in the field
+        }
+        cursor = end ? end + 1 : cursor + length;
+    }
+    return true;
+}
+
+bool SensorTrace::loadCsv(const char* text) {
+    samples.clear();
+    synthetic = false;
+
+    bool firstLine = true;
+    const char* cursor = text;
+    while (*cursor != '\0') {
+        const char* end = strchr(cursor, '\n');
+        size_t length = end ? static_cast<size_t>(end - cursor) : strlen(cursor);
+        char line[TRACE_CSV_LINE_MAX];
+        if (length >= sizeof(line)) {
+            samples.clear();
+            return false;
+        }
+        memcpy(line, cursor, length);
+        while (length > 0 && (line[length - 1] == '\r' || line[length - 1] == ' ')) {
+            length--;
+        }
+        line[length] = '\0';
+        cursor = end ? end + 1 : cursor + strlen(cursor);
+
+        // Blank lines, comments and a leading header carry no sample
+        bool header = firstLine && length > 0 && (line[0] < '0' || line[0] > '9');
+        firstLine = false;
+        if (length == 0 || line[0] == '#' || header) {
+            continue;
+        }
+
+        TraceSample sample;
+        if (!parseCsvLine(line, sample) ||
+            (!samples.empty() && sample.timeMs < samples.back().timeMs)) {
+            samples.clear();
+            return false;
+        }
+        samples.push_back(sample);
+    }
+    return !samples.empty();
+}
+
+bool SensorTrace::loadBinary(const uint8_t* data, size_t length) {
+    samples.clear();
+    synthetic = false;
+
+    const size_t headerSize = 2 * sizeof(uint32_t);
+    if (length < headerSize || readLe32(data) != TRACE_BINARY_MAGIC) {
+        return false;
+    }
+    uint32_t count = readLe32(data + sizeof(uint32_t));
+    if (count == 0 || (length - headerSize) / sizeof(TraceSample) < count) {
+        return false;
+    }
+
+    // Host-only: the in-memory layout is the file layout
+    samples.resize(count);
+    memcpy(samples.data(), data + headerSize, count * sizeof(TraceSample));
+    return true;
+}
+
+bool SensorTrace::loadFile(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    std::vector<uint8_t> contents;
+    uint8_t chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        contents.insert(contents.end(), chunk, chunk + read);
+    }
+    fclose(file);
+
+    if (contents.size() >= sizeof(uint32_t) && readLe32(contents.data()) == TRACE_BINARY_MAGIC) {
+        return loadBinary(contents.data(), contents.size());
+    }
+    contents.push_back('\0');
+    return loadCsv(reinterpret_cast<const char*>(contents.data()));
+}
+
+bool SensorTrace::saveBinary(const char* path) const {
+    if (synthetic || samples.empty()) {
+        return false;
+    }
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        return false;
+    }
+    uint32_t header[2] = {TRACE_BINARY_MAGIC, static_cast<uint32_t>(samples.size())};
+    bool ok = fwrite(header, sizeof(header), 1, file) == 1 &&
+              fwrite(samples.data(), sizeof(TraceSample), samples.size(), file) == samples.size();
+    return fclose(file) == 0 && ok;
+}
+
+void SensorTrace::setSynthetic(const SyntheticProfile& profile) {
+    samples.clear();
+    this->profile = profile;
+    synthetic = true;
+}
+
+SyntheticProfile SensorTrace::defaultProfile() {
+    SyntheticProfile profile = {};
+    profile.tempMeanC = 18.0f;
+    profile.tempSwingC = 6.0f;
+    profile.humidityMeanPct = 60.0f;
+    profile.humiditySwingPct = 15.0f;
+    profile.pressureMeanHpa = 1013.0f;
+    profile.pressureSwingHpa = 8.0f;
+    profile.soilWetRaw = 1400;
+    profile.soilDryRaw = 2900;
+    profile.irrigationIntervalMs = TRACE_DAY_MS / 2;
+    profile.dryingTimeMs = 8UL * 3600000UL;
+    profile.noise = 0.1f;
+    profile.dropoutIntervalMs = 2 * TRACE_DAY_MS;
+    profile.dropoutMs = 10UL * 60000UL;
+    profile.seed = 1;
+    return profile;
+}
+
+float SensorTrace::noiseAt(uint32_t traceMs, uint8_t channel) const {
+    // xorshift-multiply hash of (second, channel, seed)
+    uint32_t x = (traceMs / 1000) * 0x9E3779B1u ^ (channel + 1) * 0x85EBCA77u ^ profile.seed;
+    x ^= x >> 16;
+    x *= 0x7FEB352Du;
+    x ^= x >> 15;
+    x *= 0x846CA68Bu;
+    x ^= x >> 16;
+    return static_cast<float>(x) / 2147483647.5f - 1.0f;
+}
+
+void SensorTrace::generate(uint32_t traceMs, TraceSample& out) const {
+    out = {};
+    out.timeMs = traceMs;
+
+    float air = dailyWave(traceMs, TRACE_WARMEST_MS);
+    float soil = dailyWave(traceMs, TRACE_WARMEST_MS + TRACE_PROBE_LAG_MS);
+    float front = sinf(TRACE_TWO_PI * (traceMs % TRACE_FRONT_PERIOD_MS) / TRACE_FRONT_PERIOD_MS);
+    float noise = profile.noise;
+    out.bme280Temp = profile.tempMeanC + profile.tempSwingC * air + noise * noiseAt(traceMs, 0);
+    out.humidity =
+        profile.humidityMeanPct - profile.humiditySwingPct * air + noise * noiseAt(traceMs, 1);
+    out.pressure =
+        profile.pressureMeanHpa + profile.pressureSwingHpa * front + noise * noiseAt(traceMs, 2);
+    out.ds18b20Temp =
+        profile.tempMeanC + profile.tempSwingC / 3 * soil + noise * noiseAt(traceMs, 3);
+
+    // Exponential drying from the wet value since the last irrigation
+    float wetness = 0.0f;
+    if (profile.irrigationIntervalMs > 0 && profile.dryingTimeMs > 0) {
+        uint32_t sinceIrrigation = traceMs % profile.irrigationIntervalMs;
+        wetness = expf(-static_cast<float>(sinceIrrigation) / profile.dryingTimeMs);
+    }
+    float raw = profile.soilDryRaw + (profile.soilWetRaw - profile.soilDryRaw) * wetness +
+                noise * 10 * noiseAt(traceMs, 4);
+    out.soilMoistureRaw = static_cast<uint16_t>(raw < 0 ? 0 : (raw > 4095 ? 4095 : raw));
+
+    if (profile.dropoutIntervalMs > 0 &&
+        traceMs % profile.dropoutIntervalMs >= profile.dropoutIntervalMs - profile.dropoutMs) {
+        out.missingMask |= (1 << SENSOR_BME280_BIT);
+    }
+}
+
+bool SensorTrace::sample(uint32_t nowMs, TraceSample& out) const {
+    if (nowMs < startMs) {
+        return false;
+    }
+    uint32_t traceMs = nowMs - startMs;
+    if (synthetic) {
+        generate(traceMs, out);
+        return true;
+    }
+    if (samples.empty() || traceMs < samples.front().timeMs) {
+        return false;
+    }
+    if (looping && durationMs() > 0) {
+        traceMs %= durationMs();
+    }
+
+    // Last sample at or before traceMs
+    size_t low = 0;
+    size_t high = samples.size();
+    while (high - low > 1) {
+        size_t mid = (low + high) / 2;
+        if (samples[mid].timeMs <= traceMs) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    out = samples[low];
+    return true;
+}
+
+#endif  // UNIT_TEST
@@ -0,0 +1,112 @@
+#include "SerialCommandReader.h"
+
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+
+SerialCommandReader::SerialCommandReader()
+    : commands(),
+      commandCount(0),
+      lineFilter(nullptr),
+      unknownHandler(nullptr),
+      line(),
+      lineLength(0),
+      overflowed(false),
+      lastWasCr(false),
+      overflowCount(0) {}
+
+bool SerialCommandReader::addCommand(const char* name, SerialCommandHandler handler) {
+    if (commandCount >= SERIAL_MAX_COMMANDS) {
+        return false;
+    }
+    commands[commandCount].name = name;
+    commands[commandCount].handler = handler;
+    commandCount++;
+    return true;
+}
+
+void SerialCommandReader::poll() {
+#ifdef ARDUINO
+    for (int budget = SERIAL_POLL_BUDGET; budget > 0 && Serial.available() > 0; budget--) {
+        feed(static_cast<char>(Serial.read()));
+    }
+#endif
+}
+
+void SerialCommandReader::feed(char c) {
+    if (c == '\n' && lastWasCr) {
+        lastWasCr = false;
+        return;
+    }
+    lastWasCr = c == '\r';
+
+    if (c == '\r' || c == '\n') {
+        if (overflowed) {
+            overflowCount++;
+#ifdef ARDUINO
+            Serial.printf("[WARN] SerialCommandReader: Line over %u characters dropped\n",
+                          SERIAL_LINE_CAPACITY - 1);
+#endif
+        } else {
+            line[lineLength] = '\0';
+            dispatch();
+        }
+        lineLength = 0;
+        overflowed = false;
+        return;
+    }
+
+    if (c == '\b' || c == 0x7F) {
+        if (lineLength > 0) {
+            lineLength--;
+        }
+        return;
+    }
+    if (lineLength + 1 < SERIAL_LINE_CAPACITY) {
+        line[lineLength++] = c;
+    } else {
+        overflowed = true;
+    }
+}
+
+void SerialCommandReader::dispatch() {
+    // Trim both ends in place
+    char* start = line;
+    while (*start == ' ' || *start == '\t') {
+        start++;
+    }
+    char* end = start + strlen(start);
+    while (end > start && (end[-1] == ' ' || end[-1] == '\t')) {
+        *--end = '\0';
+    }
+
+    if (lineFilter && lineFilter(start)) {
+        return;
+    }
+    if (*start == '\0') {
+        return;
+    }
+
+    // Split off the command word
+    char* args = start;
+    while (*args != '\0' && *args != ' ' && *args != '\t') {
+        args++;
+    }
+    size_t wordLength = args - start;
+    while (*args == ' ' || *args == '\t') {
+        args++;
+    }
+
+    for (uint8_t i = 0; i < commandCount; i++) {
+        const char* name = commands[i].name;
+        if (strncmp(name, start, wordLength) == 0 && name[wordLength] == '\0') {
+            commands[i].handler(args);
+            return;
+        }
+    }
+    if (unknownHandler) {
+        unknownHandler(start);
+    }
+}
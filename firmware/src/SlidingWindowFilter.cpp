@@ -0,0 +1,84 @@
+#include "SlidingWindowFilter.h"
+
+#include <string.h>
+
+SlidingWindowFilter::SlidingWindowFilter()
+    : fifo(), sorted(), head(0), count(0), window(MAX_WINDOW), sum(0) {}
+
+void SlidingWindowFilter::setWindow(uint8_t newWindow) {
+    if (newWindow < 1) {
+        newWindow = 1;
+    }
+    if (newWindow > MAX_WINDOW) {
+        newWindow = MAX_WINDOW;
+    }
+    window = newWindow;
+    reset();
+}
+
+void SlidingWindowFilter::reset() {
+    head = 0;
+    count = 0;
+    sum = 0;
+}
+
+void SlidingWindowFilter::push(uint16_t sample) {
+    // Evict the oldest sample from the sorted view once the window is full
+    if (count == window) {
+        uint16_t oldest = fifo[head];
+        uint8_t idx = lowerBound(oldest);
+        memmove(&sorted[idx], &sorted[idx + 1], (count - idx - 1) * sizeof(uint16_t));
+        count--;
+        sum -= oldest;
+    }
+
+    // Insert the new sample at its sorted position
+    uint8_t pos = lowerBound(sample);
+    memmove(&sorted[pos + 1], &sorted[pos], (count - pos) * sizeof(uint16_t));
+    sorted[pos] = sample;
+    count++;
+    sum += sample;
+
+    fifo[head] = sample;
+    head = (head + 1) % window;
+}
+
+uint16_t SlidingWindowFilter::median() const {
+    if (count == 0) {
+        return 0;
+    }
+    if (count & 1) {
+        return sorted[count / 2];
+    }
+    return (uint16_t)(((uint32_t)sorted[count / 2 - 1] + sorted[count / 2]) / 2);
+}
+
+uint16_t SlidingWindowFilter::trimmedMean(uint8_t trimEachSide) const {
+    if (count == 0) {
+        return 0;
+    }
+    if ((uint16_t)trimEachSide * 2 >= count) {
+        return median();
+    }
+
+    uint32_t trimmedSum = sum;
+    for (uint8_t i = 0; i < trimEachSide; i++) {
+        trimmedSum -= sorted[i];
+        trimmedSum -= sorted[count - 1 - i];
+    }
+    return (uint16_t)(trimmedSum / (count - 2 * trimEachSide));
+}
+
+uint8_t SlidingWindowFilter::lowerBound(uint16_t value) const {
+    uint8_t lo = 0;
+    uint8_t hi = count;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi) / 2;
+        if (sorted[mid] < value) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
@@ -0,0 +1,226 @@
+#include "SoilUlp.h"
+
+#ifdef ARDUINO
+#include <Arduino.h>
+#include <esp_attr.h>
+#include <esp_sleep.h>
+#if defined(CONFIG_ESP32_ULP_COPROC_ENABLED) && CONFIG_ESP32_ULP_COPROC_ENABLED
+#include <driver/adc.h>
+#include <esp32/ulp.h>
+#include <soc/rtc_cntl_reg.h>
+
+#include "PinConfig.h"
+#define SOIL_ULP_SUPPORTED
+#endif
+#else
+#define RTC_DATA_ATTR  // Plain static storage on the host
+#endif
+
+namespace {
+
+constexpr uint32_t ULP_STATE_MAGIC = 0x53554C50;  // "SULP"
+
+// Armed by start(); zeroed at power-on, so a cold boot never reads stale ULP words
+struct UlpState {
+    uint32_t magic;
+    uint32_t periodMs;
+};
+
+RTC_DATA_ATTR UlpState ulpState;
+
+#ifdef SOIL_ULP_SUPPORTED
+// Data words at the end of the ULP reserved area; the program is loaded below them
+constexpr uint32_t ULP_RESERVED_WORDS = CONFIG_ESP32_ULP_COPROC_RESERVE_MEM / 4;
+
+enum UlpWord : uint16_t {
+    WORD_COUNT,
+    WORD_SUM_LO,
+    WORD_SUM_HI,
+    WORD_MIN,
+    WORD_MAX,
+    WORD_ZONE,
+    WORD_CROSSED,
+    NUM_ULP_WORDS
+};
+
+constexpr uint32_t ULP_DATA_BASE = ULP_RESERVED_WORDS - NUM_ULP_WORDS;
+
+enum UlpZone : uint16_t { ZONE_LOW, ZONE_INSIDE, ZONE_HIGH };
+
+enum UlpLabel : uint8_t {
+    LABEL_CARRY,
+    LABEL_MIN,
+    LABEL_NEW_MIN,
+    LABEL_MAX,
+    LABEL_NEW_MAX,
+    LABEL_ZONE,
+    LABEL_BELOW,
+    LABEL_ABOVE,
+    LABEL_COUNT,
+    LABEL_WINDOW,
+    LABEL_WAKE,
+    LABEL_HALT
+};
+
+uint16_t ulpWord(UlpWord word) {
+    return RTC_SLOW_MEM[ULP_DATA_BASE + word] & 0xFFFF;  // ST keeps its PC in the upper half
+}
+
+void setUlpWord(UlpWord word, uint16_t value) {
+    RTC_SLOW_MEM[ULP_DATA_BASE + word] = value;
+}
+#endif
+
+}  // namespace
+
+bool SoilUlp::start(uint32_t periodMs, uint16_t windowSamples, uint16_t thresholdRawA,
+                    uint16_t thresholdRawB, uint16_t lastRaw) {
+    ulpState.magic = 0;
+    if (periodMs == 0 || windowSamples == 0) {
+        return false;
+    }
+
+#ifdef SOIL_ULP_SUPPORTED
+    uint16_t lowRaw = thresholdRawA < thresholdRawB ? thresholdRawA : thresholdRawB;
+    uint16_t highRaw = thresholdRawA < thresholdRawB ? thresholdRawB : thresholdRawA;
+    uint16_t channel = digitalPinToAnalogChannel(SOIL_MOISTURE_PIN);
+
+    // One reading per ULP timer wakeup. R0 = reading, R3 = data base, R1/R2 scratch; ST
+    // leaves the ALU flags alone, and SUB sets the overflow flag when it borrows
+    const ulp_insn_t program[] = {
+        I_MOVI(R3, ULP_DATA_BASE),
+        I_ADC(R0, 0, channel),
+
+        // 32-bit sum: carry out of the low word into the high word
+        I_LD(R1, R3, WORD_SUM_LO),
+        I_ADDR(R1, R1, R0),
+        I_ST(R1, R3, WORD_SUM_LO),
+        M_BXF(LABEL_CARRY),
+        M_BX(LABEL_MIN),
+        M_LABEL(LABEL_CARRY),
+        I_LD(R1, R3, WORD_SUM_HI),
+        I_ADDI(R1, R1, 1),
+        I_ST(R1, R3, WORD_SUM_HI),
+
+        // Range (start() seeds min with 0xFFFF and max with 0)
+        M_LABEL(LABEL_MIN),
+        I_LD(R1, R3, WORD_MIN),
+        I_SUBR(R2, R0, R1),
+        M_BXF(LABEL_NEW_MIN),
+        M_BX(LABEL_MAX),
+        M_LABEL(LABEL_NEW_MIN),
+        I_ST(R0, R3, WORD_MIN),
+        M_LABEL(LABEL_MAX),
+        I_LD(R1, R3, WORD_MAX),
+        I_SUBR(R2, R1, R0),
+        M_BXF(LABEL_NEW_MAX),
+        M_BX(LABEL_ZONE),
+        M_LABEL(LABEL_NEW_MAX),
+        I_ST(R0, R3, WORD_MAX),
+
+        // Zone of this reading into R2
+        M_LABEL(LABEL_ZONE),
+        I_MOVI(R2, ZONE_INSIDE),
+        M_BL(LABEL_BELOW, lowRaw),
+        M_BGE(LABEL_ABOVE, highRaw + 1),
+        M_BX(LABEL_COUNT),
+        M_LABEL(LABEL_BELOW),
+        I_MOVI(R2, ZONE_LOW),
+        M_BX(LABEL_COUNT),
+        M_LABEL(LABEL_ABOVE),
+        I_MOVI(R2, ZONE_HIGH),
+
+        // Count the reading, then wake on a zone change or a full window
+        M_LABEL(LABEL_COUNT),
+        I_LD(R1, R3, WORD_COUNT),
+        I_ADDI(R1, R1, 1),
+        I_ST(R1, R3, WORD_COUNT),
+        I_LD(R0, R3, WORD_ZONE),
+        I_SUBR(R0, R0, R2),
+        M_BXZ(LABEL_WINDOW),
+        I_ST(R2, R3, WORD_ZONE),
+        I_MOVI(R0, 1),
+        I_ST(R0, R3, WORD_CROSSED),
+        M_BX(LABEL_WAKE),
+        M_LABEL(LABEL_WINDOW),
+        I_MOVR(R0, R1),
+        M_BL(LABEL_HALT, windowSamples),
+
+        // Wait until the SoC can take a wakeup, then stop the ULP timer for good
+        M_LABEL(LABEL_WAKE),
+        I_RD_REG(RTC_CNTL_LOW_POWER_ST_REG, RTC_CNTL_RDY_FOR_WAKEUP_S,
+                 RTC_CNTL_RDY_FOR_WAKEUP_S),
+        M_BL(LABEL_WAKE, 1),
+        I_WAKE(),
+        I_END(),
+        M_LABEL(LABEL_HALT),
+        I_HALT(),
+    };
+
+    uint16_t startZone = ZONE_INSIDE;
+    if (lastRaw < lowRaw) {
+        startZone = ZONE_LOW;
+    } else if (lastRaw > highRaw) {
+        startZone = ZONE_HIGH;
+    }
+    setUlpWord(WORD_COUNT, 0);
+    setUlpWord(WORD_SUM_LO, 0);
+    setUlpWord(WORD_SUM_HI, 0);
+    setUlpWord(WORD_MIN, 0xFFFF);
+    setUlpWord(WORD_MAX, 0);
+    setUlpWord(WORD_ZONE, startZone);
+    setUlpWord(WORD_CROSSED, 0);
+
+    // Hand ADC1 to the ULP with the same attenuation the awake sampler uses
+    adc1_config_width(ADC_WIDTH_BIT_12);
+    adc1_config_channel_atten(static_cast<adc1_channel_t>(channel), ADC_ATTEN_DB_11);
+    adc1_ulp_enable();
+
+    size_t size = sizeof(program) / sizeof(ulp_insn_t);
+    esp_err_t err = ulp_process_macros_and_load(0, program, &size);
+    if (err != ESP_OK || size > ULP_DATA_BASE) {
+        Serial.printf("[ERROR] SoilUlp: Program load failed (%d, %u words)\n", err,
+                      (unsigned)size);
+        return false;
+    }
+    ulp_set_wakeup_period(0, periodMs * 1000);
+    if (esp_sleep_enable_ulp_wakeup() != ESP_OK || ulp_run(0) != ESP_OK) {
+        Serial.println("[ERROR] SoilUlp: Failed to start the ULP");
+        return false;
+    }
+
+    ulpState.periodMs = periodMs;
+    ulpState.magic = ULP_STATE_MAGIC;
+    Serial.printf("[INFO] SoilUlp: Sampling every %lu ms, %u per window (raw %u-%u)\n",
+                  (unsigned long)periodMs, windowSamples, lowRaw, highRaw);
+    return true;
+#else
+    (void)thresholdRawA;
+    (void)thresholdRawB;
+    (void)lastRaw;
+    return false;
+#endif
+}
+
+bool SoilUlp::take(SoilAggregate& aggregate) {
+    aggregate = SoilAggregate();
+    if (ulpState.magic != ULP_STATE_MAGIC) {
+        return false;
+    }
+    ulpState.magic = 0;
+
+#ifdef SOIL_ULP_SUPPORTED
+    // A timer wakeup (or a reset) leaves the ULP running; it must not keep counting
+    CLEAR_PERI_REG_MASK(RTC_CNTL_STATE0_REG, RTC_CNTL_ULP_CP_SLP_TIMER_EN);
+
+    aggregate.count = ulpWord(WORD_COUNT);
+    aggregate.sumRaw = ((uint32_t)ulpWord(WORD_SUM_HI) << 16) | ulpWord(WORD_SUM_LO);
+    aggregate.minRaw = ulpWord(WORD_MIN);
+    aggregate.maxRaw = ulpWord(WORD_MAX);
+    aggregate.thresholdWake = ulpWord(WORD_CROSSED) != 0;
+    if (aggregate.count > 0) {
+        aggregate.elapsedMs = (uint32_t)(aggregate.count - 1) * ulpState.periodMs;
+    }
+#endif
+    return aggregate.count > 0;
+}
@@ -1,8 +1,27 @@
 #ifndef UNIT_TEST
 #include "StateManager.h"
 
+#include <esp_attr.h>
+
+#include "DataManager.h"
 #include "ErrorLogger.h"
 
+namespace {
+
+// Deep sleeps since the last NVS checkpoint (zeroed at power-on, kept across deep sleep)
+RTC_DATA_ATTR uint16_t sleepsSinceCheckpoint = 0;
+
+// Commit point of the backlog journal: chunks firstChunk .. firstChunk + chunkCount - 1
+// hold the journaled windows, oldest first; those below tailSequence were acknowledged
+struct JournalMeta {
+    uint32_t firstChunk;
+    uint32_t tailSequence;
+    uint16_t chunkCount;
+    uint16_t reserved;
+};
+
+}  // namespace
+
 StateManager::StateManager() : currentState(SystemState::NORMAL) {}
 
 void StateManager::initialize() {
@@ -42,71 +61,133 @@ void StateManager::setSystemState(SystemState state) {
             stateName = "ERROR";
             break;
     }
-    ErrorLogger::info(ErrorType::SYSTEM, String("System state changed to: ") + stateName,
-                      "StateManager");
+    ErrorLogger::logf(ErrorLevel::INFO, ErrorType::SYSTEM,
+                      "System state changed to: %s (StateManager)", stateName);
 }
 
-bool StateManager::persistState(const AveragedData* dataBuffer, uint16_t dataBufferCount,
-                                const DisplayPoint* displayBuffer, uint16_t displayBufferCount) {
+bool StateManager::persistState(const DataSnapshot& snapshot) {
     if (!nvs.begin(NVS_NAMESPACE, false)) {
         ErrorLogger::error(ErrorType::SYSTEM, "Failed to open NVS for state persistence",
                            "StateManager::persistState");
         return false;
     }
 
-    // Validate buffer sizes
-    if (dataBufferCount > MAX_DATA_BUFFER_SIZE) {
-        ErrorLogger::warning(ErrorType::SYSTEM, "Data buffer count exceeds maximum, truncating",
-                             "StateManager::persistState");
-        dataBufferCount = MAX_DATA_BUFFER_SIZE;
+    // Keep the newest entries; the snapshot views are contiguous, so no copy is needed
+    uint16_t dataSkip =
+        snapshot.recordCount > NVS_MAX_RECORDS ? snapshot.recordCount - NVS_MAX_RECORDS : 0;
+    const PackedAveragedData* records = snapshot.records + dataSkip;
+    uint16_t dataCount = snapshot.recordCount - dataSkip;
+    uint32_t tailSequence = dataCount > 0 ? records[0].sequence : snapshot.nextSequence;
+    uint16_t displayCount = snapshot.displayCount;
+    uint16_t displaySkip =
+        displayCount > NVS_MAX_DISPLAY_POINTS ? displayCount - NVS_MAX_DISPLAY_POINTS : 0;
+    displayCount -= displaySkip;
+
+    // Walk the journal: the windows at or above the new tail must be exactly the oldest
+    // windows of the snapshot, otherwise the journal is rewritten
+    JournalMeta meta = {};
+    bool compact = nvs.getUShort(KEY_STATE_VALID, 0) != STATE_LAYOUT_VERSION ||
+                   nvs.getBytes(KEY_JOURNAL_META, &meta, sizeof(meta)) != sizeof(meta) ||
+                   meta.chunkCount > JOURNAL_MAX_CHUNKS;
+    uint16_t journaled = 0;
+    uint16_t deadChunks = 0;
+    PackedAveragedData chunk[JOURNAL_CHUNK_RECORDS];
+    char key[12];
+    for (uint16_t c = 0; !compact && c < meta.chunkCount; c++) {
+        chunkKey(meta.firstChunk + c, key, sizeof(key));
+        size_t bytes = nvs.getBytes(key, chunk, sizeof(chunk));
+        if (bytes == 0 || bytes % sizeof(PackedAveragedData) != 0) {
+            compact = true;
+            break;
+        }
+        uint16_t live = 0;
+        for (uint16_t r = 0; r < bytes / sizeof(PackedAveragedData); r++) {
+            if (chunk[r].sequence < tailSequence) {
+                continue;
+            }
+            if (journaled >= dataCount || records[journaled].sequence != chunk[r].sequence) {
+                compact = true;
+                break;
+            }
+            journaled++;
+            live++;
+        }
+        if (live == 0 && deadChunks == c) {
+            deadChunks++;  // Leading chunk with only acknowledged windows
+        }
     }
 
-    if (displayBufferCount > MAX_DISPLAY_BUFFER_SIZE) {
-        ErrorLogger::warning(ErrorType::SYSTEM, "Display buffer count exceeds maximum, truncating",
-                             "StateManager::persistState");
-        displayBufferCount = MAX_DISPLAY_BUFFER_SIZE;
+    if (!compact && deadChunks > 0) {
+        // Commit the advanced tail before freeing the slots of acknowledged chunks
+        meta.firstChunk += deadChunks;
+        meta.chunkCount -= deadChunks;
+        meta.tailSequence = tailSequence;
+        nvs.putBytes(KEY_JOURNAL_META, &meta, sizeof(meta));
+        removeChunks(meta.firstChunk - deadChunks, deadChunks);
     }
 
-    // Persist data buffer
-    if (dataBufferCount > 0 && dataBuffer != nullptr) {
-        size_t dataSize = dataBufferCount * sizeof(AveragedData);
-        if (!nvs.putBytes(KEY_DATA_BUFFER, dataBuffer, dataSize)) {
-            ErrorLogger::error(ErrorType::SYSTEM, "Failed to persist data buffer",
-                               "StateManager::persistState");
-            nvs.end();
-            return false;
-        }
-        nvs.putUShort(KEY_DATA_COUNT, dataBufferCount);
+    uint16_t newRecords = dataCount - journaled;
+    uint16_t chunksNeeded = (newRecords + JOURNAL_CHUNK_RECORDS - 1) / JOURNAL_CHUNK_RECORDS;
+    if (!compact && meta.chunkCount + chunksNeeded > JOURNAL_MAX_CHUNKS) {
+        compact = true;  // Out of slots: fold the partial chunks together
+    }
+
+    bool ok = true;
+    uint16_t written = 0;
+    if (compact) {
+        // Invalidate first so a reset mid-rewrite never restores a half-written journal
+        nvs.putUShort(KEY_STATE_VALID, 0);
+        removeChunks(0, JOURNAL_MAX_CHUNKS);
+        meta.firstChunk = 0;
+        ok = journalRecords(records, dataCount, meta.firstChunk, written);
+        meta.chunkCount = written;
     } else {
-        nvs.putUShort(KEY_DATA_COUNT, 0);
+        // Append only the windows added since the last checkpoint, in unused slots
+        ok = journalRecords(records + journaled, newRecords, meta.firstChunk + meta.chunkCount,
+                            written);
+        meta.chunkCount += written;
     }
+    meta.tailSequence = tailSequence;
+    meta.reserved = 0;
 
-    // Persist display buffer
-    if (displayBufferCount > 0 && displayBuffer != nullptr) {
-        size_t displaySize = displayBufferCount * sizeof(DisplayPoint);
-        if (!nvs.putBytes(KEY_DISPLAY_BUFFER, displayBuffer, displaySize)) {
-            ErrorLogger::error(ErrorType::SYSTEM, "Failed to persist display buffer",
-                               "StateManager::persistState");
-            nvs.end();
-            return false;
+    if (ok && displayCount > 0) {
+        size_t tsSize = displayCount * sizeof(uint32_t);
+        ok = nvs.putBytes(KEY_DISPLAY_TIMESTAMPS, snapshot.displayTimestamps + displaySkip,
+                          tsSize) == tsSize;
+        size_t valueSize = displayCount * sizeof(float);
+        for (uint8_t i = 0; ok && i < NUM_SENSORS; i++) {
+            snprintf(key, sizeof(key), "%s%u", KEY_DISPLAY_VALUES_PREFIX, i);
+            ok = nvs.putBytes(key, snapshot.displayValues[i] + displaySkip, valueSize) ==
+                 valueSize;
         }
-        nvs.putUShort(KEY_DISPLAY_COUNT, displayBufferCount);
-    } else {
-        nvs.putUShort(KEY_DISPLAY_COUNT, 0);
+    }
+    if (!ok) {
+        ErrorLogger::error(ErrorType::SYSTEM, "Failed to persist state buffers",
+                           "StateManager::persistState");
+        nvs.end();
+        return false;
     }
 
+    // Single-blob commit of the journal, then the counters
+    nvs.putBytes(KEY_JOURNAL_META, &meta, sizeof(meta));
+    nvs.putUShort(KEY_DISPLAY_COUNT, displayCount);
+    nvs.putULong(KEY_NEXT_SEQUENCE, snapshot.nextSequence);
+    nvs.putUShort(KEY_OVERFLOW_COUNT, snapshot.bufferOverflowCount + dataSkip);
+    nvs.putULong(KEY_DISPLAY_CLOCK, snapshot.displayClockMs);
+
     // Mark state as valid
-    nvs.putUShort(KEY_STATE_VALID, 1);
+    nvs.putUShort(KEY_STATE_VALID, STATE_LAYOUT_VERSION);
 
     nvs.end();
 
-    ErrorLogger::info(ErrorType::SYSTEM, "State persisted successfully",
-                      "StateManager::persistState");
+    char message[48];
+    snprintf(message, sizeof(message), "State %s: %u window(s) written",
+             compact ? "compacted" : "journaled", compact ? dataCount : newRecords);
+    ErrorLogger::info(ErrorType::SYSTEM, message, "StateManager::persistState");
     return true;
 }
 
-bool StateManager::restoreState(AveragedData* dataBuffer, uint16_t& dataBufferCount,
-                                DisplayPoint* displayBuffer, uint16_t& displayBufferCount) {
+bool StateManager::restoreState(DataManager& dataManager, uint32_t nowMs) {
     if (!nvs.begin(NVS_NAMESPACE, true)) {  // Read-only mode
         ErrorLogger::error(ErrorType::SYSTEM, "Failed to open NVS for state restore",
                            "StateManager::restoreState");
@@ -115,59 +196,117 @@ bool StateManager::restoreState(AveragedData* dataBuffer, uint16_t& dataBufferCo
 
     // Check if state is valid
     uint16_t stateValid = nvs.getUShort(KEY_STATE_VALID, 0);
-    if (stateValid != 1) {
+    JournalMeta meta = {};
+    if (stateValid != STATE_LAYOUT_VERSION ||
+        nvs.getBytes(KEY_JOURNAL_META, &meta, sizeof(meta)) != sizeof(meta) ||
+        meta.chunkCount > JOURNAL_MAX_CHUNKS) {
         ErrorLogger::info(ErrorType::SYSTEM, "No valid persisted state found",
                           "StateManager::restoreState");
         nvs.end();
         return false;
     }
 
-    // Restore data buffer
-    dataBufferCount = nvs.getUShort(KEY_DATA_COUNT, 0);
-    if (dataBufferCount > 0 && dataBuffer != nullptr) {
-        if (dataBufferCount > MAX_DATA_BUFFER_SIZE) {
-            ErrorLogger::warning(ErrorType::SYSTEM, "Persisted data buffer count exceeds maximum",
-                                 "StateManager::restoreState");
-            dataBufferCount = MAX_DATA_BUFFER_SIZE;
-        }
+    // Read the blobs straight into DataManager's rings
+    DataRestoreTarget target = dataManager.beginRestore();
+    if (!target.records) {
+        ErrorLogger::warning(ErrorType::SYSTEM, "DataManager already holds data",
+                             "StateManager::restoreState");
+        nvs.end();
+        return false;
+    }
 
-        size_t dataSize = dataBufferCount * sizeof(AveragedData);
-        size_t bytesRead = nvs.getBytes(KEY_DATA_BUFFER, dataBuffer, dataSize);
-        if (bytesRead != dataSize) {
-            ErrorLogger::error(ErrorType::SYSTEM, "Failed to restore data buffer",
-                               "StateManager::restoreState");
-            nvs.end();
-            return false;
-        }
+    uint16_t displayCount = nvs.getUShort(KEY_DISPLAY_COUNT, 0);
+    if (displayCount > NVS_MAX_DISPLAY_POINTS || displayCount > target.displayCapacity) {
+        ErrorLogger::warning(ErrorType::SYSTEM, "Persisted buffer count exceeds maximum",
+                             "StateManager::restoreState");
+        nvs.end();
+        return false;
     }
 
-    // Restore display buffer
-    displayBufferCount = nvs.getUShort(KEY_DISPLAY_COUNT, 0);
-    if (displayBufferCount > 0 && displayBuffer != nullptr) {
-        if (displayBufferCount > MAX_DISPLAY_BUFFER_SIZE) {
-            ErrorLogger::warning(ErrorType::SYSTEM,
-                                 "Persisted display buffer count exceeds maximum",
-                                 "StateManager::restoreState");
-            displayBufferCount = MAX_DISPLAY_BUFFER_SIZE;
+    // Replay the journal oldest-first, dropping acknowledged windows in place
+    bool ok = true;
+    uint16_t dataCount = 0;
+    char key[12];
+    for (uint16_t c = 0; ok && c < meta.chunkCount; c++) {
+        chunkKey(meta.firstChunk + c, key, sizeof(key));
+        size_t bytes = nvs.getBytesLength(key);
+        uint16_t chunkRecords = bytes / sizeof(PackedAveragedData);
+        PackedAveragedData* chunk = target.records + dataCount;
+        ok = bytes > 0 && bytes % sizeof(PackedAveragedData) == 0 &&
+             chunkRecords <= JOURNAL_CHUNK_RECORDS &&
+             dataCount + chunkRecords <= target.recordCapacity &&
+             nvs.getBytes(key, chunk, bytes) == bytes;
+        for (uint16_t r = 0; ok && r < chunkRecords; r++) {
+            if (chunk[r].sequence >= meta.tailSequence) {
+                target.records[dataCount++] = chunk[r];
+            }
         }
-
-        size_t displaySize = displayBufferCount * sizeof(DisplayPoint);
-        size_t bytesRead = nvs.getBytes(KEY_DISPLAY_BUFFER, displayBuffer, displaySize);
-        if (bytesRead != displaySize) {
-            ErrorLogger::error(ErrorType::SYSTEM, "Failed to restore display buffer",
-                               "StateManager::restoreState");
-            nvs.end();
-            return false;
+    }
+    if (ok && displayCount > 0) {
+        size_t tsSize = displayCount * sizeof(uint32_t);
+        ok = nvs.getBytes(KEY_DISPLAY_TIMESTAMPS, target.displayTimestamps, tsSize) == tsSize;
+        size_t valueSize = displayCount * sizeof(float);
+        for (uint8_t i = 0; ok && i < NUM_SENSORS; i++) {
+            snprintf(key, sizeof(key), "%s%u", KEY_DISPLAY_VALUES_PREFIX, i);
+            ok = nvs.getBytes(key, target.displayValues[i], valueSize) == valueSize;
         }
     }
-
+    uint32_t nextSequence = nvs.getULong(KEY_NEXT_SEQUENCE, 1);
+    uint16_t overflowCount = nvs.getUShort(KEY_OVERFLOW_COUNT, 0);
+    uint32_t displayClock = nvs.getULong(KEY_DISPLAY_CLOCK, 0);
     nvs.end();
 
+    // Time off power is unknown, so new display points follow straight on
+    if (!ok || !dataManager.commitRestore(dataCount, nextSequence, overflowCount,
+                                          displayCount, displayClock, nowMs)) {
+        ErrorLogger::error(ErrorType::SYSTEM, "Failed to restore state buffers",
+                           "StateManager::restoreState");
+        return false;
+    }
+
     ErrorLogger::info(ErrorType::SYSTEM, "State restored successfully",
                       "StateManager::restoreState");
     return true;
 }
 
+void StateManager::chunkKey(uint32_t chunkId, char* key, size_t size) {
+    snprintf(key, size, "%s%u", KEY_JOURNAL_CHUNK_PREFIX,
+             (unsigned)(chunkId % JOURNAL_MAX_CHUNKS));
+}
+
+bool StateManager::journalRecords(const PackedAveragedData* records, uint16_t count,
+                                  uint32_t firstChunk, uint16_t& chunksWritten) {
+    char key[12];
+    chunksWritten = 0;
+    for (uint16_t offset = 0; offset < count; offset += JOURNAL_CHUNK_RECORDS) {
+        uint16_t n = count - offset;
+        if (n > JOURNAL_CHUNK_RECORDS) {
+            n = JOURNAL_CHUNK_RECORDS;
+        }
+        size_t bytes = n * sizeof(PackedAveragedData);
+        chunkKey(firstChunk + chunksWritten, key, sizeof(key));
+        if (nvs.putBytes(key, records + offset, bytes) != bytes) {
+            return false;
+        }
+        chunksWritten++;
+    }
+    return true;
+}
+
+void StateManager::removeChunks(uint32_t firstChunk, uint16_t count) {
+    char key[12];
+    for (uint16_t c = 0; c < count; c++) {
+        chunkKey(firstChunk + c, key, sizeof(key));
+        nvs.remove(key);
+    }
+}
+
+bool StateManager::isCheckpointDue() {
+    bool due = sleepsSinceCheckpoint == 0;
+    sleepsSinceCheckpoint = (sleepsSinceCheckpoint + 1) % NVS_CHECKPOINT_SLEEPS;
+    return due;
+}
+
 bool StateManager::hasPersistedState() {
     if (!nvs.begin(NVS_NAMESPACE, true)) {  // Read-only mode
         return false;
@@ -176,7 +315,7 @@ bool StateManager::hasPersistedState() {
     uint16_t stateValid = nvs.getUShort(KEY_STATE_VALID, 0);
     nvs.end();
 
-    return (stateValid == 1);
+    return (stateValid == STATE_LAYOUT_VERSION);
 }
 
 void StateManager::clearPersistedState() {
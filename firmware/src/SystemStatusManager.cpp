@@ -1,22 +1,52 @@
 #include "SystemStatusManager.h"
 
+#include <algorithm>
 #include <cstring>
 
+#include "Crc32.h"
+#include "HeapTrace.h"
+
+#ifdef ARDUINO
+#include <esp_heap_caps.h>
+#endif
+
 SystemStatusManager::SystemStatusManager()
-    : bootTimeMs(0), lastSensorReadMs(0), lastTransmissionMs(0) {
+    : bootTimeMs(0),
+      lastSensorReadMs(0),
+      lastTransmissionMs(0),
+#ifdef ARDUINO
+      statusMux(portMUX_INITIALIZER_UNLOCKED),
+#endif
+      bootProfileSent(false),
+      metricsIntervalMs(0),
+      metricsSentMs(0),
+      metricsSentKey(0),
+      metricsSent(false) {
     memset(&status, 0, sizeof(SystemStatus));
+    status.metricsDue = true;  // Nothing sent yet
     memset(lastErrorStr, 0, sizeof(lastErrorStr));
+    memset(latencySamples, 0, sizeof(latencySamples));
+    memset(latencyHead, 0, sizeof(latencyHead));
+    memset(latencyCount, 0, sizeof(latencyCount));
+    memset(networkSamples, 0, sizeof(networkSamples));
+    memset(networkHead, 0, sizeof(networkHead));
+    memset(networkCount, 0, sizeof(networkCount));
 }
 
 SystemStatusManager::~SystemStatusManager() {}
 
 void SystemStatusManager::initialize() {
+    // Runs in setup() before the network task exists, so nothing else touches the status
     bootTimeMs = millis();
     status.uptimeMs = 0;
     status.freeHeap = 0;
     status.wifiRssi = -127;  // Invalid RSSI (not connected)
+    status.wifiConnectMs = 0;
     status.queueDepth = 0;
     status.bootCount = 0;  // TODO: Load from NVS in future
+    status.outboundQueue = OutboundQueueStats();
+    status.netBytesSent = 0;
+    status.netBytesReceived = 0;
 
     // Initialize error counters
     status.errors.sensorReadFailures = 0;
@@ -49,54 +79,158 @@ void SystemStatusManager::initialize() {
 }
 
 void SystemStatusManager::update() {
-    updateUptime();
-    updateHeapMemory();
+    unsigned long nowMs = millis();
+    HeapSample heap = sampleHeap();
+
+    lock();
+    status.uptimeMs = nowMs - bootTimeMs;
+    status.freeHeap = heap.freeHeap;
+    status.minFreeHeap = heap.minFreeHeap;
+    status.largestFreeBlock = heap.largestFreeBlock;
+    status.allocationsTracked = heap.allocationsTracked;
+    status.loopAllocations = heap.loopAllocations;
+    status.maxLoopAllocations = heap.maxLoopAllocations;
+    updateMetricsDue();
+    unlock();
 }
 
 SystemStatus SystemStatusManager::getStatus() const {
-    return status;
+    lock();
+    SystemStatus copy = status;
+    unlock();
+    return copy;
 }
 
 void SystemStatusManager::setWiFiRSSI(int8_t rssi) {
+    lock();
     status.wifiRssi = rssi;
+    unlock();
+}
+
+void SystemStatusManager::setWiFiConnectTime(uint32_t durationMs) {
+    lock();
+    status.wifiConnectMs = durationMs;
+    unlock();
 }
 
 void SystemStatusManager::setQueueDepth(uint16_t depth) {
+    lock();
     status.queueDepth = depth;
+    unlock();
+}
+
+void SystemStatusManager::setOutboundQueueStats(const OutboundQueueStats& stats) {
+    lock();
+    status.outboundQueue = stats;
+    unlock();
+}
+
+void SystemStatusManager::setBootProfile(const BootProfile& profile) {
+    lock();
+    status.bootProfile = profile;
+    status.bootProfilePending = !bootProfileSent;
+    unlock();
+}
+
+void SystemStatusManager::markBootProfileSent() {
+    lock();
+    bootProfileSent = true;
+    status.bootProfilePending = false;
+    unlock();
+}
+
+void SystemStatusManager::setPostMortemPending(bool pending) {
+    lock();
+    status.postMortemPending = pending;
+    unlock();
+}
+
+void SystemStatusManager::markPostMortemSent() {
+    lock();
+    status.postMortemPending = false;
+    unlock();
+}
+
+void SystemStatusManager::setLoopProfile(const LoopPhaseSummary phases[NUM_LOOP_PHASES]) {
+    lock();
+    memcpy(status.loopPhases, phases, sizeof(status.loopPhases));
+    unlock();
+}
+
+void SystemStatusManager::setTaskStats(const TaskStats* tasks, uint8_t count) {
+    lock();
+    status.taskCount = std::min<uint8_t>(count, MAX_MONITORED_TASKS);
+    memcpy(status.tasks, tasks, status.taskCount * sizeof(TaskStats));
+    unlock();
+}
+
+void SystemStatusManager::setMetricsInterval(uint32_t intervalMs) {
+    lock();
+    metricsIntervalMs = intervalMs;
+    updateMetricsDue();
+    unlock();
+}
+
+void SystemStatusManager::markMetricsSent(const SystemStatus& sent) {
+    uint32_t sentKey = metricsKey(sent);
+    lock();
+    metricsSent = true;
+    metricsSentMs = millis();
+    metricsSentKey = sentKey;
+    updateMetricsDue();
+    unlock();
+}
+
+void SystemStatusManager::setEnergyReport(const EnergyReport& report) {
+    lock();
+    status.energy = report;
+    unlock();
 }
 
 void SystemStatusManager::incrementSensorFailures() {
+    lock();
     status.errors.sensorReadFailures++;
+    unlock();
 }
 
 void SystemStatusManager::incrementNetworkFailures() {
+    lock();
     status.errors.networkFailures++;
+    unlock();
 }
 
 void SystemStatusManager::incrementBufferOverflows() {
+    lock();
     status.errors.bufferOverflows++;
+    unlock();
 }
 
 void SystemStatusManager::setLastSensorReadTime(unsigned long timestampMs) {
+    lock();
     lastSensorReadMs = timestampMs;
+    unlock();
 }
 
 void SystemStatusManager::setLastTransmissionTime(unsigned long timestampMs) {
+    lock();
     lastTransmissionMs = timestampMs;
+    unlock();
 }
 
 void SystemStatusManager::setLastError(const char* error) {
+    lock();
     if (error == nullptr) {
         lastErrorStr[0] = '\0';
-        return;
+    } else {
+        // Copy error string with bounds checking
+        strncpy(lastErrorStr, error, sizeof(lastErrorStr) - 1);
+        lastErrorStr[sizeof(lastErrorStr) - 1] = '\0';  // Ensure null termination
     }
-
-    // Copy error string with bounds checking
-    strncpy(lastErrorStr, error, sizeof(lastErrorStr) - 1);
-    lastErrorStr[sizeof(lastErrorStr) - 1] = '\0';  // Ensure null termination
+    unlock();
 }
 
 void SystemStatusManager::updateMinMax(const SensorReadings& readings) {
+    lock();
     // Update BME280 temperature min/max
     if (readings.bme280Temp < status.minValues.bme280Temp && readings.bme280Temp > -100.0f) {
         status.minValues.bme280Temp = readings.bme280Temp;
@@ -144,45 +278,193 @@ void SystemStatusManager::updateMinMax(const SensorReadings& readings) {
     if (readings.soilMoistureRaw > status.maxValues.soilMoistureRaw) {
         status.maxValues.soilMoistureRaw = readings.soilMoistureRaw;
     }
+    unlock();
+}
+
+void SystemStatusManager::recordSensorLatencies(const SensorReadings& readings) {
+    for (uint8_t bus = 0; bus < NUM_SENSOR_BUSES; bus++) {
+        if (readings.readLatencyUs[bus] > 0) {
+            recordSensorLatency(bus, readings.readLatencyUs[bus]);
+        }
+    }
+}
+
+void SystemStatusManager::recordSensorLatency(uint8_t bus, uint32_t latencyUs) {
+    if (bus >= NUM_SENSOR_BUSES) {
+        return;
+    }
+
+    lock();
+    recordSample(latencySamples[bus], latencyHead[bus], latencyCount[bus], latencyUs,
+                 status.sensorLatency[bus]);
+    unlock();
+}
+
+LatencyStats SystemStatusManager::getSensorLatency(uint8_t bus) const {
+    if (bus >= NUM_SENSOR_BUSES) {
+        LatencyStats empty = {};
+        return empty;
+    }
+    lock();
+    LatencyStats stats = status.sensorLatency[bus];
+    unlock();
+    return stats;
+}
+
+void SystemStatusManager::recordNetworkPhase(uint8_t phase, uint32_t durationUs) {
+    if (phase >= NUM_NETWORK_PHASES) {
+        return;
+    }
+
+    lock();
+    recordSample(networkSamples[phase], networkHead[phase], networkCount[phase], durationUs,
+                 status.networkLatency[phase]);
+    unlock();
+}
+
+LatencyStats SystemStatusManager::getNetworkLatency(uint8_t phase) const {
+    if (phase >= NUM_NETWORK_PHASES) {
+        LatencyStats empty = {};
+        return empty;
+    }
+    lock();
+    LatencyStats stats = status.networkLatency[phase];
+    unlock();
+    return stats;
+}
+
+void SystemStatusManager::addNetworkBytes(uint32_t sent, uint32_t received) {
+    lock();
+    status.netBytesSent += sent;
+    status.netBytesReceived += received;
+    unlock();
 }
 
 void SystemStatusManager::resetMinMax(const SensorReadings& readings) {
+    lock();
     status.minValues = readings;
     status.maxValues = readings;
+    unlock();
 }
 
 unsigned long SystemStatusManager::getUptimeMs() const {
-    return status.uptimeMs;
+    lock();
+    unsigned long value = status.uptimeMs;
+    unlock();
+    return value;
 }
 
 uint32_t SystemStatusManager::getFreeHeap() const {
-    return status.freeHeap;
+    lock();
+    uint32_t value = status.freeHeap;
+    unlock();
+    return value;
+}
+
+uint32_t SystemStatusManager::getNetBytesSent() const {
+    lock();
+    uint32_t value = status.netBytesSent;
+    unlock();
+    return value;
 }
 
 unsigned long SystemStatusManager::getLastSensorReadTime() const {
-    return lastSensorReadMs;
+    lock();
+    unsigned long value = lastSensorReadMs;
+    unlock();
+    return value;
 }
 
 unsigned long SystemStatusManager::getLastTransmissionTime() const {
-    return lastTransmissionMs;
+    lock();
+    unsigned long value = lastTransmissionMs;
+    unlock();
+    return value;
 }
 
-const char* SystemStatusManager::getLastError() const {
-    return lastErrorStr;
+size_t SystemStatusManager::getLastError(char* out, size_t size) const {
+    lock();
+    size_t length = strnlen(lastErrorStr, sizeof(lastErrorStr) - 1);
+    if (size > 0) {
+        size_t copied = std::min(length, size - 1);
+        memcpy(out, lastErrorStr, copied);
+        out[copied] = '\0';
+    }
+    unlock();
+    return length;
 }
 
 // Private helper methods
 
-void SystemStatusManager::updateUptime() {
-    unsigned long currentMs = millis();
-    status.uptimeMs = currentMs - bootTimeMs;
+void SystemStatusManager::recordSample(uint32_t* samples, uint8_t& head, uint8_t& count,
+                                       uint32_t value, LatencyStats& stats) {
+    samples[head] = value;
+    head = (head + 1) % LATENCY_WINDOW;
+    if (count < LATENCY_WINDOW) {
+        count++;
+    }
+
+    computeLatencyStats(samples, count, stats);
+}
+
+void SystemStatusManager::computeLatencyStats(const uint32_t* samples, uint8_t n,
+                                              LatencyStats& stats) {
+    // Sort a copy of the window (at most LATENCY_WINDOW entries, once per sample)
+    uint32_t sorted[LATENCY_WINDOW];
+    memcpy(sorted, samples, n * sizeof(uint32_t));
+    std::sort(sorted, sorted + n);
+
+    uint64_t sum = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        sum += sorted[i];
+    }
+
+    // Nearest-rank 95th percentile
+    uint8_t p95Index = (uint8_t)((n * 95 + 99) / 100) - 1;
+
+    stats.minUs = sorted[0];
+    stats.maxUs = sorted[n - 1];
+    stats.avgUs = (uint32_t)(sum / n);
+    stats.p95Us = sorted[p95Index];
+    stats.count = n;
 }
 
-void SystemStatusManager::updateHeapMemory() {
+SystemStatusManager::HeapSample SystemStatusManager::sampleHeap() {
+    HeapSample heap;
 #ifdef ARDUINO
-    status.freeHeap = ESP.getFreeHeap();
+    heap.freeHeap = ESP.getFreeHeap();
+    heap.minFreeHeap = ESP.getMinFreeHeap();
+    // Free heap can look healthy while no single block fits a TLS record buffer
+    heap.largestFreeBlock =
+        heap_caps_get_largest_free_block(MALLOC_CAP_8BIT | MALLOC_CAP_INTERNAL);
 #else
     // Mock value for native testing
-    status.freeHeap = 200000;  // 200 KB
+    heap.freeHeap = 200000;  // 200 KB
+    heap.minFreeHeap = heap.freeHeap;
+    heap.largestFreeBlock = heap.freeHeap;
 #endif
+    heap.allocationsTracked = HeapTrace::isEnabled();
+    heap.loopAllocations = HeapTrace::getLastPassAllocations();
+    heap.maxLoopAllocations = HeapTrace::getMaxPassAllocations();
+    return heap;
+}
+
+void SystemStatusManager::updateMetricsDue() {
+    status.metricsDue = !metricsSent || metricsIntervalMs == 0 ||
+                        millis() - metricsSentMs >= metricsIntervalMs ||
+                        status.bootProfilePending || status.postMortemPending ||
+                        metricsKey(status) != metricsSentKey;
+}
+
+uint32_t SystemStatusManager::metricsKey(const SystemStatus& snapshot) {
+    // Discrete events only: heap, latency and energy figures move every pass and wait
+    // for the interval
+    uint32_t stackLowMask = 0;
+    for (uint8_t i = 0; i < snapshot.taskCount; i++) {
+        stackLowMask |= (snapshot.tasks[i].stackLow ? 1u : 0u) << i;
+    }
+    uint32_t key = crc32Update(&snapshot.errors, sizeof(snapshot.errors));
+    key = crc32Update(&snapshot.outboundQueue.droppedRecords,
+                      sizeof(snapshot.outboundQueue.droppedRecords), key);
+    return crc32Update(&stackLowMask, sizeof(stackLowMask), key);
 }
@@ -0,0 +1,137 @@
+#include "TaskMonitor.h"
+
+#include <string.h>
+
+#include "ErrorLogger.h"
+
+#ifdef ARDUINO
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#endif
+
+namespace {
+
+TaskStats tasks[MAX_MONITORED_TASKS];
+void* handles[MAX_MONITORED_TASKS];
+uint8_t taskCount = 0;
+uint32_t lastSampleMs = 0;
+bool sampled = false;
+
+#if defined(ARDUINO) && configGENERATE_RUN_TIME_STATS == 1
+// Run-time counters at the previous sample, per watched task
+uint32_t lastRunTime[MAX_MONITORED_TASKS];
+uint32_t lastTotalRunTime = 0;
+#define TASK_STATUS_SLOTS 24  // All tasks in the system, IDF ones included
+#endif
+
+}  // namespace
+
+bool TaskMonitor::add(const char* name, void* handle, uint32_t stackBytes) {
+    if (taskCount >= MAX_MONITORED_TASKS || handle == nullptr) {
+        return false;
+    }
+    TaskStats& stats = tasks[taskCount];
+    stats.name = name;
+    stats.stackBytes = stackBytes;
+    stats.minFreeStackBytes = stackBytes;
+    stats.cpuPercent = TASK_CPU_UNKNOWN;
+    stats.stackLow = false;
+    handles[taskCount] = handle;
+#if defined(ARDUINO) && configGENERATE_RUN_TIME_STATS == 1
+    lastRunTime[taskCount] = 0;
+#endif
+    taskCount++;
+    return true;
+}
+
+void TaskMonitor::remove(void* handle) {
+    for (uint8_t i = 0; i < taskCount; i++) {
+        if (handles[i] == handle) {
+            // Keep the table packed; order only matters for reports
+            taskCount--;
+            tasks[i] = tasks[taskCount];
+            handles[i] = handles[taskCount];
+#if defined(ARDUINO) && configGENERATE_RUN_TIME_STATS == 1
+            lastRunTime[i] = lastRunTime[taskCount];
+#endif
+            return;
+        }
+    }
+}
+
+bool TaskMonitor::sample(uint32_t nowMs) {
+    if (sampled && nowMs - lastSampleMs < TASK_MONITOR_INTERVAL_MS) {
+        return false;
+    }
+    sampled = true;
+    lastSampleMs = nowMs;
+
+#ifdef ARDUINO
+#if configGENERATE_RUN_TIME_STATS == 1
+    static TaskStatus_t status[TASK_STATUS_SLOTS];
+    uint32_t totalRunTime = 0;
+    UBaseType_t reported = uxTaskGetSystemState(status, TASK_STATUS_SLOTS, &totalRunTime);
+    uint32_t totalDelta = totalRunTime - lastTotalRunTime;
+    lastTotalRunTime = totalRunTime;
+#endif
+    for (uint8_t i = 0; i < taskCount; i++) {
+        // ESP-IDF stacks are byte-addressed, so the high-water mark is already in bytes
+        uint32_t freeBytes = uxTaskGetStackHighWaterMark(static_cast<TaskHandle_t>(handles[i]));
+        uint32_t runDelta = 0;
+        uint32_t baseDelta = 0;
+#if configGENERATE_RUN_TIME_STATS == 1
+        for (UBaseType_t t = 0; t < reported; t++) {
+            if (status[t].xHandle == handles[i]) {
+                runDelta = status[t].ulRunTimeCounter - lastRunTime[i];
+                lastRunTime[i] = status[t].ulRunTimeCounter;
+                baseDelta = totalDelta;
+                break;
+            }
+        }
+#endif
+        if (record(i, freeBytes, runDelta, baseDelta)) {
+            ErrorLogger::logf(ErrorLevel::WARNING, ErrorType::MEMORY,
+                              "Task %s stack low: %lu of %lu bytes free", tasks[i].name,
+                              static_cast<unsigned long>(freeBytes),
+                              static_cast<unsigned long>(tasks[i].stackBytes));
+        }
+    }
+#endif
+    return true;
+}
+
+bool TaskMonitor::record(uint8_t index, uint32_t minFreeStackBytes, uint32_t runTime,
+                         uint32_t totalRunTime) {
+    if (index >= taskCount) {
+        return false;
+    }
+    TaskStats& stats = tasks[index];
+    stats.minFreeStackBytes = minFreeStackBytes;
+    if (totalRunTime > 0) {
+        uint64_t percent = static_cast<uint64_t>(runTime) * 100 / totalRunTime;
+        stats.cpuPercent = percent > 100 ? 100 : static_cast<uint8_t>(percent);
+    } else {
+        stats.cpuPercent = TASK_CPU_UNKNOWN;
+    }
+
+    // The high-water mark never recovers, so one warning per task is enough
+    bool low = minFreeStackBytes < TASK_STACK_WARN_BYTES;
+    bool newlyLow = low && !stats.stackLow;
+    stats.stackLow = low;
+    return newlyLow;
+}
+
+uint8_t TaskMonitor::getCount() {
+    return taskCount;
+}
+
+const TaskStats& TaskMonitor::get(uint8_t index) {
+    return tasks[index < taskCount ? index : 0];
+}
+
+void TaskMonitor::clear() {
+    memset(tasks, 0, sizeof(tasks));
+    taskCount = 0;
+    sampled = false;
+    lastSampleMs = 0;
+}
@@ -2,7 +2,13 @@
 
 #ifndef UNIT_TEST
 #include <WiFi.h>
+#include <esp_attr.h>
+#include <esp_private/esp_clk.h>
+#include <esp_sntp.h>
+#include <sys/time.h>
 #include <time.h>
+#else
+#define RTC_DATA_ATTR  // Plain static storage on the host
 #endif
 
 // NTP server configuration
@@ -10,15 +16,72 @@ static const char* NTP_SERVER = "pool.ntp.org";
 static const long GMT_OFFSET_SEC = 0;  // UTC
 static const int DAYLIGHT_OFFSET_SEC = 0;
 
-TimeManager::TimeManager() : ntpSynced(false), ntpEpochMs(0), ntpSyncMillis(0), bootMillis(0) {}
+namespace {
+
+constexpr uint32_t SLEEP_CLOCK_MAGIC = 0x31434c53;  // "SLC1"
+
+// The clock at the last saveForSleep(); zeroed at power-on, kept across deep sleep
+struct SleepClock {
+    uint32_t magic;
+    uint64_t epochMs;         // Epoch when it was saved
+    uint64_t rtcUs;           // RTC timer then (keeps counting in deep sleep)
+    uint64_t lastNtpEpochMs;  // Epoch of the last SNTP sync
+    uint32_t plannedSleepMs;
+    int32_t driftPpb;
+    int32_t pendingSlewMs;
+};
+
+RTC_DATA_ATTR SleepClock sleepClock;
+
+}  // namespace
+
+#ifndef UNIT_TEST
+// The SNTP notification writes the mapping from the lwIP task; readers copy it out
+static portMUX_TYPE timeMux = portMUX_INITIALIZER_UNLOCKED;
+#define TIME_LOCK() portENTER_CRITICAL(&timeMux)
+#define TIME_UNLOCK() portEXIT_CRITICAL(&timeMux)
+
+TimeManager* TimeManager::sntpOwner = nullptr;
+#else
+#define TIME_LOCK()
+#define TIME_UNLOCK()
+#endif
 
-TimeManager::~TimeManager() {}
+TimeManager::TimeManager()
+    : ntpSynced(false),
+      ntpEpochMs(0),
+      ntpSyncMillis(0),
+      bootMillis(0),
+      driftPpb(0),
+      slewMs(0),
+      syncCount(0),
+      sntpStarted(false),
+      syncCallback(nullptr),
+      syncCallbackContext(nullptr),
+      lastNtpEpochMs(0),
+      ntpMaxAgeSec(DEFAULT_NTP_MAX_AGE_SEC),
+      restoredAnchor(false) {}
+
+TimeManager::~TimeManager() {
+#ifndef UNIT_TEST
+    if (sntpOwner == this) {
+        sntpOwner = nullptr;
+    }
+#endif
+}
 
 void TimeManager::initialize() {
     bootMillis = millis();
+    TIME_LOCK();
     ntpSynced = false;
     ntpEpochMs = 0;
     ntpSyncMillis = 0;
+    driftPpb = 0;
+    slewMs = 0;
+    syncCount = 0;
+    lastNtpEpochMs = 0;
+    restoredAnchor = false;
+    TIME_UNLOCK();
 }
 
 uint32_t TimeManager::monotonicMs() const {
@@ -30,12 +93,26 @@ uint32_t TimeManager::uptimeMs() const {
 }
 
 void TimeManager::tryNtpSync() {
+    if (!needsNtpSync()) {
+        return;  // Restored after deep sleep and still fresh: no round trip this wake
+    }
 #ifndef UNIT_TEST
-    if (WiFi.status() == WL_CONNECTED) {
-        if (syncWithNtpServer()) {
-            ntpSynced = true;
-        }
+    if (WiFi.status() != WL_CONNECTED) {
+        return;
     }
+    if (!sntpStarted) {
+        // configTime() starts lwIP's SNTP client and returns; the result arrives in
+        // onSntpSync(), and the client re-syncs on its own from then on
+        sntpOwner = this;
+        sntp_set_time_sync_notification_cb(onSntpSync);
+        configTime(GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC, NTP_SERVER);
+        sntpStarted = true;
+    } else {
+        sntp_restart();  // Link came back before the first answer: ask again now
+    }
+#else
+    // In unit test mode, simulate a sync that completes at once
+    recordSync(1704067200000ULL, millis());  // 2024-01-01 00:00:00 UTC
 #endif
 }
 
@@ -44,67 +121,198 @@ void TimeManager::onWiFiConnected() {
     tryNtpSync();
 }
 
-bool TimeManager::timeSynced() const {
-    return ntpSynced;
+void TimeManager::setSyncCallback(SyncCallback callback, void* context) {
+    syncCallback = callback;
+    syncCallbackContext = context;
 }
 
-uint64_t TimeManager::epochMsOrZero() const {
+void TimeManager::recordSync(uint64_t epochMs, uint32_t atMonotonicMs) {
+    int64_t offsetMs = 0;
+
+    TIME_LOCK();
     if (!ntpSynced) {
-        return 0;
+        ntpEpochMs = epochMs;
+        ntpSyncMillis = atMonotonicMs;
+        driftPpb = 0;
+        slewMs = 0;
+        ntpSynced = true;
+    } else {
+        uint64_t predicted = mapLocked(atMonotonicMs);
+        offsetMs = static_cast<int64_t>(epochMs - predicted);
+        uint32_t elapsedMs = atMonotonicMs - ntpSyncMillis;
+
+        // The rate error is what accumulated on top of the offset known at the anchor;
+        // half of each measurement is taken, so one noisy sync cannot swing the rate.
+        // A restored anchor's offset is mostly the RTC timer's error over the sleep
+        if (!restoredAnchor && elapsedMs >= DRIFT_MIN_INTERVAL_MS &&
+            offsetMs > -STEP_THRESHOLD_MS && offsetMs < STEP_THRESHOLD_MS) {
+            int64_t rateErrorMs = offsetMs + slewAbsorbedMs(elapsedMs) - slewMs;
+            int64_t ppb = driftPpb + (rateErrorMs * 1000000000LL / elapsedMs) / 2;
+            const int64_t limit = static_cast<int64_t>(DRIFT_LIMIT_PPM) * 1000;
+            driftPpb = static_cast<int32_t>(ppb > limit ? limit : (ppb < -limit ? -limit : ppb));
+        }
+
+        // Re-anchor where the mapping is now, so epoch time stays continuous, and slew
+        // the offset out from here; a large one is a step (first fix after a bad one)
+        ntpSyncMillis = atMonotonicMs;
+        if (offsetMs >= STEP_THRESHOLD_MS || offsetMs <= -STEP_THRESHOLD_MS) {
+            ntpEpochMs = epochMs;
+            slewMs = 0;
+        } else {
+            ntpEpochMs = predicted;
+            slewMs = static_cast<int32_t>(offsetMs);
+        }
     }
+    lastNtpEpochMs = epochMs;
+    restoredAnchor = false;
+    syncCount++;
+    TIME_UNLOCK();
 
-    // Calculate current epoch time based on NTP sync point
-    uint32_t millisSinceSync = millis() - ntpSyncMillis;
-    return ntpEpochMs + millisSinceSync;
+    if (syncCallback) {
+        syncCallback(epochMs, static_cast<int32_t>(offsetMs), syncCallbackContext);
+    }
 }
 
-uint64_t TimeManager::deviceBootEpochMs() const {
+void TimeManager::saveForSleep(uint32_t nowMs, uint32_t plannedSleepMs) {
+    TIME_LOCK();
     if (!ntpSynced) {
-        return 0;
+        TIME_UNLOCK();
+        sleepClock.magic = 0;
+        return;
+    }
+    int64_t elapsedMs = static_cast<int32_t>(nowMs - ntpSyncMillis);
+    sleepClock.epochMs = mapLocked(nowMs);
+    sleepClock.lastNtpEpochMs = lastNtpEpochMs;
+    sleepClock.driftPpb = driftPpb;
+    sleepClock.pendingSlewMs = static_cast<int32_t>(slewMs - slewAbsorbedMs(elapsedMs));
+    TIME_UNLOCK();
+
+#ifndef UNIT_TEST
+    sleepClock.rtcUs = esp_clk_rtc_time();
+#else
+    sleepClock.rtcUs = 0;
+#endif
+    sleepClock.plannedSleepMs = plannedSleepMs;
+    sleepClock.magic = SLEEP_CLOCK_MAGIC;
+}
+
+bool TimeManager::restoreAfterSleep(uint32_t nowMs, uint32_t sleptMs) {
+    if (sleepClock.magic != SLEEP_CLOCK_MAGIC) {
+        return false;
+    }
+    sleepClock.magic = 0;  // One wake per save: a later reset must not replay it
+
+    // Time from the save to now: the sleep plus this boot so far
+    uint64_t sinceSaveMs;
+#ifndef UNIT_TEST
+    uint64_t rtcNowUs = esp_clk_rtc_time();
+    if (sleptMs == SLEPT_AS_PLANNED && rtcNowUs > sleepClock.rtcUs) {
+        sinceSaveMs = (rtcNowUs - sleepClock.rtcUs) / 1000ULL;
+    } else
+#endif
+    {
+        sinceSaveMs =
+            static_cast<uint64_t>(sleptMs == SLEPT_AS_PLANNED ? sleepClock.plannedSleepMs
+                                                              : sleptMs) +
+            nowMs;
     }
 
-    // Calculate boot time by subtracting uptime from current epoch
-    uint64_t currentEpoch = epochMsOrZero();
-    uint32_t uptime = uptimeMs();
+    TIME_LOCK();
+    ntpEpochMs = sleepClock.epochMs + sinceSaveMs;
+    ntpSyncMillis = nowMs;
+    driftPpb = sleepClock.driftPpb;
+    slewMs = sleepClock.pendingSlewMs;
+    lastNtpEpochMs = sleepClock.lastNtpEpochMs;
+    restoredAnchor = true;
+    ntpSynced = true;
+    TIME_UNLOCK();
+    return true;
+}
 
-    if (currentEpoch >= uptime) {
-        return currentEpoch - uptime;
+void TimeManager::setNtpMaxAgeSec(uint32_t seconds) {
+    ntpMaxAgeSec = seconds;
+}
+
+bool TimeManager::timeSynced() const {
+    return ntpSynced;
+}
+
+bool TimeManager::needsNtpSync() const {
+    if (!ntpSynced) {
+        return true;
+    }
+    if (!restoredAnchor) {
+        return false;  // SNTP runs this boot and keeps the clock up to date
     }
+    uint64_t nowEpochMs = epochMsOrZero();
+    return nowEpochMs < lastNtpEpochMs ||
+           nowEpochMs - lastNtpEpochMs >= static_cast<uint64_t>(ntpMaxAgeSec) * 1000ULL;
+}
 
-    return 0;
+uint64_t TimeManager::epochMsOrZero() const {
+    return epochAtMonotonicMs(millis());
 }
 
-bool TimeManager::syncWithNtpServer() {
-#ifndef UNIT_TEST
-    // Configure NTP
-    configTime(GMT_OFFSET_SEC, DAYLIGHT_OFFSET_SEC, NTP_SERVER);
+uint64_t TimeManager::epochAtMonotonicMs(uint32_t monotonicMs) const {
+    TIME_LOCK();
+    uint64_t epochMs = ntpSynced ? mapLocked(monotonicMs) : 0;
+    TIME_UNLOCK();
+    return epochMs;
+}
 
-    // Wait for time to be set (with timeout)
-    int retries = 0;
-    const int MAX_RETRIES = 10;
+uint64_t TimeManager::deviceBootEpochMs() const {
+    // The mapping reaches back to boot: millis() is continuous within one boot
+    return epochAtMonotonicMs(bootMillis);
+}
 
-    while (retries < MAX_RETRIES) {
-        time_t now = time(nullptr);
-        if (now > 1000000000) {  // Valid timestamp (after year 2001)
-            // Get current time in milliseconds
-            struct timeval tv;
-            gettimeofday(&tv, nullptr);
+int32_t TimeManager::getDriftPpm() const {
+    return driftPpb / 1000;
+}
 
-            ntpEpochMs = (uint64_t)tv.tv_sec * 1000ULL + (uint64_t)tv.tv_usec / 1000ULL;
-            ntpSyncMillis = millis();
+int32_t TimeManager::getPendingSlewMs() const {
+    TIME_LOCK();
+    int32_t pending = 0;
+    if (ntpSynced) {
+        int64_t elapsedMs = static_cast<int32_t>(millis() - ntpSyncMillis);
+        pending = static_cast<int32_t>(slewMs - slewAbsorbedMs(elapsedMs));
+    }
+    TIME_UNLOCK();
+    return pending;
+}
 
-            return true;
-        }
+uint32_t TimeManager::getSyncCount() const {
+    return syncCount;
+}
+
+uint64_t TimeManager::mapLocked(uint32_t monotonicMs) const {
+    // Signed distance from the anchor: valid for about 24 days either side, and SNTP
+    // re-anchors every hour
+    int64_t elapsedMs = static_cast<int32_t>(monotonicMs - ntpSyncMillis);
+    int64_t epochMs = static_cast<int64_t>(ntpEpochMs) + elapsedMs +
+                      (elapsedMs * driftPpb) / 1000000000LL + slewAbsorbedMs(elapsedMs);
+    return epochMs > 0 ? static_cast<uint64_t>(epochMs) : 0;
+}
 
-        delay(500);
-        retries++;
+int64_t TimeManager::slewAbsorbedMs(int64_t elapsedMs) const {
+    // The offset is absorbed after the anchor only, at SLEW_MAX_PPM
+    if (slewMs == 0 || elapsedMs <= 0) {
+        return 0;
+    }
+    int64_t absorbed = elapsedMs * SLEW_MAX_PPM / 1000000;
+    int64_t magnitude = slewMs > 0 ? slewMs : -slewMs;
+    if (absorbed > magnitude) {
+        absorbed = magnitude;
     }
+    return slewMs > 0 ? absorbed : -absorbed;
+}
 
-    return false;
-#else
-    // In unit test mode, simulate successful sync
-    ntpEpochMs = 1704067200000ULL;  // Example: 2024-01-01 00:00:00 UTC
-    ntpSyncMillis = millis();
-    return true;
-#endif
+#ifndef UNIT_TEST
+void TimeManager::onSntpSync(struct timeval* tv) {
+    if (!sntpOwner || !tv) {
+        return;
+    }
+    uint64_t epochMs =
+        static_cast<uint64_t>(tv->tv_sec) * 1000ULL + static_cast<uint64_t>(tv->tv_usec) / 1000ULL;
+    sntpOwner->recordSync(epochMs, millis());
 }
+#endif
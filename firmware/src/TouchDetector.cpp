@@ -1,9 +1,11 @@
 #include "TouchDetector.h"
 
 #ifdef ARDUINO
+#include <Preferences.h>
 #include <SPI.h>
 #include <Wire.h>
 
+#include "Crc32.h"
 #include "LoggingMacros.h"
 #include "PinConfig.h"
 #else
@@ -31,7 +33,22 @@
 #define STABILITY_DELAY_MS 10
 #define TOTAL_TIMEOUT_MS 500
 
-TouchDetector::TouchDetector() {
+// Detection cache (detectCached())
+#define TOUCH_NVS_NAMESPACE "touch"
+#define TOUCH_CACHE_KEY "cache"
+#define TOUCH_CACHE_VERSION 1
+
+namespace {
+
+struct TouchCache {
+    uint8_t version;
+    uint8_t type;  // TouchControllerType
+    uint32_t fingerprint;
+};
+
+}  // namespace
+
+TouchDetector::TouchDetector() : cacheHit(false) {
     lastResult.detected = false;
     lastResult.type = TouchControllerType::NONE;
     lastResult.detectionTimeMs = 0;
@@ -67,8 +84,9 @@ TouchDetectionResult TouchDetector::detect() {
         return lastResult;
     }
 
-    // Priority 2: Probe I2C controllers
+    // Priority 2: Probe I2C controllers (the bus is started once for all of them)
     Serial.printf("[INFO] TouchDetector: Probing I2C controllers\n");
+    Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQUENCY);
 
     if (probeFT6236(PROBE_TIMEOUT_MS)) {
         lastResult.detected = true;
@@ -131,6 +149,68 @@ TouchDetectionResult TouchDetector::detect() {
     return lastResult;
 }
 
+TouchDetectionResult TouchDetector::detectCached(bool force) {
+    cacheHit = false;
+#ifdef ARDUINO
+    uint32_t startTime = millis();
+    uint32_t fingerprint = boardFingerprint();
+
+    TouchCache cache = {};
+    Preferences nvs;
+    bool cached = false;
+    if (!force && nvs.begin(TOUCH_NVS_NAMESPACE, true)) {
+        cached = nvs.getBytes(TOUCH_CACHE_KEY, &cache, sizeof(cache)) == sizeof(cache) &&
+                 cache.version == TOUCH_CACHE_VERSION && cache.fingerprint == fingerprint;
+        nvs.end();
+    }
+
+    if (cached) {
+        // One ID read instead of the whole sequence; a cached "none" has nothing to read
+        TouchControllerType type = static_cast<TouchControllerType>(cache.type);
+        bool confirmed = type == TouchControllerType::NONE;
+        if (!confirmed) {
+            Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQUENCY);
+            confirmed = readControllerId(type);
+        }
+        if (confirmed) {
+            lastResult.detected = type != TouchControllerType::NONE;
+            lastResult.type = type;
+            lastResult.detectionTimeMs = millis() - startTime;
+            cacheHit = true;
+            Serial.printf("[INFO] TouchDetector: Cached controller type %d confirmed in %u ms\n",
+                          (int)type, lastResult.detectionTimeMs);
+            return lastResult;
+        }
+        Serial.printf("[WARN] TouchDetector: Cached controller type %d not answering\n",
+                      (int)type);
+    }
+
+    detect();
+
+    TouchCache fresh = {TOUCH_CACHE_VERSION, static_cast<uint8_t>(lastResult.type), fingerprint};
+    if ((!cached || fresh.type != cache.type) && nvs.begin(TOUCH_NVS_NAMESPACE, false)) {
+        nvs.putBytes(TOUCH_CACHE_KEY, &fresh, sizeof(fresh));
+        nvs.end();
+    }
+    return lastResult;
+#else
+    (void)force;
+    return detect();
+#endif
+}
+
+uint32_t TouchDetector::boardFingerprint() {
+#ifdef ARDUINO
+    uint64_t mac = ESP.getEfuseMac();
+    const uint8_t pins[] = {I2C_SDA_PIN,  I2C_SCL_PIN,  TFT_SCLK_PIN,
+                            TFT_MISO_PIN, TFT_MOSI_PIN, TOUCH_IRQ_PIN};
+    uint32_t crc = crc32Update(&mac, sizeof(mac));
+    return crc32Update(pins, sizeof(pins), crc);
+#else
+    return 0;
+#endif
+}
+
 TouchDetectionResult TouchDetector::getLastResult() const {
     return lastResult;
 }
@@ -182,9 +262,6 @@ bool TouchDetector::probeFT6236(uint32_t timeoutMs) {
     Serial.printf("[INFO] TouchDetector: Probing FT6236 at 0x%02X with %u ms timeout\n",
                   FT6236_I2C_ADDR, timeoutMs);
 
-    // Initialize I2C if not already done
-    Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQUENCY);
-
     // Try to read chip ID register
     Wire.beginTransmission(FT6236_I2C_ADDR);
     Wire.write(FT6236_REG_CHIPID);
@@ -254,9 +331,6 @@ bool TouchDetector::probeCST816(uint32_t timeoutMs) {
     Serial.printf("[INFO] TouchDetector: Probing CST816 at 0x%02X with %u ms timeout\n",
                   CST816_I2C_ADDR, timeoutMs);
 
-    // Initialize I2C if not already done
-    Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQUENCY);
-
     // Try to read chip ID register
     Wire.beginTransmission(CST816_I2C_ADDR);
     Wire.write(CST816_REG_CHIPID);
@@ -325,9 +399,6 @@ bool TouchDetector::probeGT911(uint32_t timeoutMs) {
     uint32_t startTime = millis();
     Serial.printf("[INFO] TouchDetector: Probing GT911 with %u ms timeout\n", timeoutMs);
 
-    // Initialize I2C if not already done
-    Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQUENCY);
-
     // GT911 can be at two addresses: 0x5D or 0x14
     // Try both addresses
     uint8_t addresses[] = {GT911_I2C_ADDR_1, GT911_I2C_ADDR_2};
@@ -419,7 +490,21 @@ bool TouchDetector::verifyStability(TouchControllerType type) {
     delay(STABILITY_DELAY_MS);
 
     // Perform second read based on controller type
-    bool secondReadSuccess = false;
+    if (readControllerId(type)) {
+        Serial.printf("[INFO] TouchDetector: Stability verified successfully\n");
+        return true;
+    } else {
+        Serial.printf("[WARN] TouchDetector: Stability check failed\n");
+        return false;
+    }
+#else
+    return false;
+#endif
+}
+
+bool TouchDetector::readControllerId(TouchControllerType type) {
+#ifdef ARDUINO
+    bool success = false;
 
     switch (type) {
         case TouchControllerType::FT6236: {
@@ -430,17 +515,17 @@ bool TouchDetector::verifyStability(TouchControllerType type) {
                 uint8_t bytesRead = Wire.requestFrom(FT6236_I2C_ADDR, (uint8_t)1);
                 if (bytesRead == 1) {
                     uint8_t chipId = Wire.read();
-                    secondReadSuccess = (chipId == 0x36 || chipId == 0x64);
+                    success = (chipId == 0x36 || chipId == 0x64);
                     Serial.printf(
-                        "[INFO] TouchDetector: FT6236 stability check - chip ID: 0x%02X, success: "
+                        "[INFO] TouchDetector: FT6236 ID check - chip ID: 0x%02X, success: "
                         "%d\n",
-                        chipId, secondReadSuccess);
+                        chipId, success);
                 } else {
                     Serial.printf(
-                        "[WARN] TouchDetector: FT6236 stability check - failed to read chip ID\n");
+                        "[WARN] TouchDetector: FT6236 ID check - failed to read chip ID\n");
                 }
             } else {
-                Serial.printf("[WARN] TouchDetector: FT6236 stability check - I2C error: %u\n",
+                Serial.printf("[WARN] TouchDetector: FT6236 ID check - I2C error: %u\n",
                               error);
             }
             break;
@@ -454,17 +539,17 @@ bool TouchDetector::verifyStability(TouchControllerType type) {
                 uint8_t bytesRead = Wire.requestFrom(CST816_I2C_ADDR, (uint8_t)1);
                 if (bytesRead == 1) {
                     uint8_t chipId = Wire.read();
-                    secondReadSuccess = (chipId == 0xB4);
+                    success = (chipId == 0xB4);
                     Serial.printf(
-                        "[INFO] TouchDetector: CST816 stability check - chip ID: 0x%02X, success: "
+                        "[INFO] TouchDetector: CST816 ID check - chip ID: 0x%02X, success: "
                         "%d\n",
-                        chipId, secondReadSuccess);
+                        chipId, success);
                 } else {
                     Serial.printf(
-                        "[WARN] TouchDetector: CST816 stability check - failed to read chip ID\n");
+                        "[WARN] TouchDetector: CST816 ID check - failed to read chip ID\n");
                 }
             } else {
-                Serial.printf("[WARN] TouchDetector: CST816 stability check - I2C error: %u\n",
+                Serial.printf("[WARN] TouchDetector: CST816 ID check - I2C error: %u\n",
                               error);
             }
             break;
@@ -486,27 +571,27 @@ bool TouchDetector::verifyStability(TouchControllerType type) {
                             productId[i] = Wire.read();
                         }
                         if (strncmp(productId, "911", 3) == 0) {
-                            secondReadSuccess = true;
+                            success = true;
                             Serial.printf(
-                                "[INFO] TouchDetector: GT911 stability check at 0x%02X - product "
+                                "[INFO] TouchDetector: GT911 ID check at 0x%02X - product "
                                 "ID: %s, success: %d\n",
-                                addr, productId, secondReadSuccess);
+                                addr, productId, success);
                             break;
                         } else {
                             Serial.printf(
-                                "[WARN] TouchDetector: GT911 stability check at 0x%02X - invalid "
+                                "[WARN] TouchDetector: GT911 ID check at 0x%02X - invalid "
                                 "product ID: %s\n",
                                 addr, productId);
                         }
                     } else {
                         Serial.printf(
-                            "[WARN] TouchDetector: GT911 stability check at 0x%02X - failed to "
+                            "[WARN] TouchDetector: GT911 ID check at 0x%02X - failed to "
                             "read product ID\n",
                             addr);
                     }
                 } else {
                     Serial.printf(
-                        "[WARN] TouchDetector: GT911 stability check at 0x%02X - I2C error: %u\n",
+                        "[WARN] TouchDetector: GT911 ID check at 0x%02X - I2C error: %u\n",
                         addr, error);
                 }
             }
@@ -514,26 +599,21 @@ bool TouchDetector::verifyStability(TouchControllerType type) {
         }
 
         case TouchControllerType::XPT2046:
-            // SPI controller stability check
+            // SPI controller ID check
             // For now, assume stable if first read succeeded
-            secondReadSuccess = true;
-            Serial.printf("[INFO] TouchDetector: XPT2046 stability check - assumed stable\n");
+            success = true;
+            Serial.printf("[INFO] TouchDetector: XPT2046 ID check - assumed stable\n");
             break;
 
         default:
-            secondReadSuccess = false;
-            Serial.printf("[WARN] TouchDetector: Stability check - unknown controller type\n");
+            success = false;
+            Serial.printf("[WARN] TouchDetector: ID check - unknown controller type\n");
             break;
     }
 
-    if (secondReadSuccess) {
-        Serial.printf("[INFO] TouchDetector: Stability verified successfully\n");
-        return true;
-    } else {
-        Serial.printf("[WARN] TouchDetector: Stability check failed\n");
-        return false;
-    }
+    return success;
 #else
+    (void)type;
     return false;
 #endif
 }
@@ -0,0 +1,180 @@
+#include "TouchInput.h"
+
+#ifdef ARDUINO
+#include <Wire.h>
+#endif
+
+// FT6236 interrupt mode register: 0 = INT held low while touched, 1 = one pulse per report
+#define FT6236_I2C_ADDR 0x38
+#define FT6236_REG_G_MODE 0xA4
+
+TouchInput::TouchInput()
+    : edges(),
+      edgeHead(0),
+      edgeCount(0),
+      droppedCount(0),
+#ifdef ARDUINO
+      edgeMux(portMUX_INITIALIZER_UNLOCKED),
+#endif
+      active(false),
+      irqPin(0),
+      touching(false),
+      linePressed(false),
+      longReported(false),
+      touchStartMs(0),
+      lastEdgeMs(0) {
+}
+
+TouchInput::~TouchInput() {
+    end();
+}
+
+bool TouchInput::begin(TouchControllerType type, uint8_t pin) {
+    end();
+    if (type == TouchControllerType::NONE) {
+        return false;
+    }
+    irqPin = pin;
+
+#ifdef ARDUINO
+    if (type == TouchControllerType::FT6236) {
+        // Level mode gives exactly one edge per press and per release
+        Wire.beginTransmission(FT6236_I2C_ADDR);
+        Wire.write(FT6236_REG_G_MODE);
+        Wire.write(0x00);
+        Wire.endTransmission();
+    }
+
+    pinMode(irqPin, INPUT_PULLUP);  // XPT2046 PENIRQ is open drain
+    attachInterruptArg(digitalPinToInterrupt(irqPin), handleIrq, this, CHANGE);
+    Serial.printf("[INFO] TouchInput: IRQ attached on GPIO%u\n", irqPin);
+#endif
+    active = true;
+    return true;
+}
+
+void TouchInput::end() {
+    if (!active) {
+        return;
+    }
+#ifdef ARDUINO
+    detachInterrupt(digitalPinToInterrupt(irqPin));
+#endif
+    active = false;
+    edgeHead = 0;
+    edgeCount = 0;
+    touching = false;
+}
+
+#ifdef ARDUINO
+void IRAM_ATTR TouchInput::handleIrq(void* arg) {
+    TouchInput* self = static_cast<TouchInput*>(arg);
+    self->onIrqEdge(digitalRead(self->irqPin) == LOW, millis());
+}
+#endif
+
+void TouchInput::onIrqEdge(bool pressed, uint32_t timeMs) {
+#ifdef ARDUINO
+    portENTER_CRITICAL_ISR(&edgeMux);
+#endif
+    if (edgeCount < EDGE_QUEUE_LENGTH) {
+        Edge& edge = edges[(edgeHead + edgeCount) % EDGE_QUEUE_LENGTH];
+        edge.timeMs = timeMs;
+        edge.pressed = pressed;
+        edgeCount = edgeCount + 1;
+    } else {
+        droppedCount = droppedCount + 1;  // Keep the oldest edges; they start the touch
+    }
+#ifdef ARDUINO
+    portEXIT_CRITICAL_ISR(&edgeMux);
+#endif
+}
+
+void TouchInput::resyncLevel(bool pressed, uint32_t timeMs) {
+    Edge edge;
+    if (!active || peekEdge(edge) || pressed == linePressed) {
+        return;
+    }
+    onIrqEdge(pressed, timeMs);
+}
+
+bool TouchInput::poll(uint32_t nowMs, TouchGesture& gesture) {
+#ifdef ARDUINO
+    if (active) {
+        resyncLevel(digitalRead(irqPin) == LOW, nowMs);
+    }
+#endif
+
+    Edge edge;
+    while (peekEdge(edge)) {
+        // A touch that ended before this edge is reported first
+        if (finishTouch(edge.timeMs, gesture)) {
+            return true;
+        }
+        popEdge();
+
+        if (edge.pressed && !touching) {
+            touching = true;
+            longReported = false;
+            touchStartMs = edge.timeMs;
+        }
+        linePressed = edge.pressed;
+        lastEdgeMs = edge.timeMs;
+    }
+    return finishTouch(nowMs, gesture);
+}
+
+bool TouchInput::peekEdge(Edge& edge) {
+    bool available = false;
+#ifdef ARDUINO
+    portENTER_CRITICAL(&edgeMux);
+#endif
+    if (edgeCount > 0) {
+        edge = edges[edgeHead];
+        available = true;
+    }
+#ifdef ARDUINO
+    portEXIT_CRITICAL(&edgeMux);
+#endif
+    return available;
+}
+
+void TouchInput::popEdge() {
+#ifdef ARDUINO
+    portENTER_CRITICAL(&edgeMux);
+#endif
+    if (edgeCount > 0) {
+        edgeHead = (edgeHead + 1) % EDGE_QUEUE_LENGTH;
+        edgeCount = edgeCount - 1;
+    }
+#ifdef ARDUINO
+    portEXIT_CRITICAL(&edgeMux);
+#endif
+}
+
+bool TouchInput::finishTouch(uint32_t timeMs, TouchGesture& gesture) {
+    if (!touching) {
+        return false;
+    }
+
+    // Released and quiet long enough: the touch is over
+    if (!linePressed && timeMs - lastEdgeMs >= RELEASE_GAP_MS) {
+        touching = false;
+        if (longReported) {
+            return false;
+        }
+        bool held = lastEdgeMs - touchStartMs >= LONG_PRESS_MS;
+        gesture = held ? TouchGesture::LONG_PRESS : TouchGesture::TAP;
+        return true;
+    }
+
+    // Still held (or pulsing): report a long press without waiting for the release. A
+    // released line only counts up to its last edge
+    uint32_t heldUntilMs = linePressed ? timeMs : lastEdgeMs;
+    if (!longReported && heldUntilMs - touchStartMs >= LONG_PRESS_MS) {
+        longReported = true;
+        gesture = TouchGesture::LONG_PRESS;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,60 @@
+#include "UploadArena.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+UploadArena::UploadArena()
+    : block(nullptr), capacity(0), used(0), highWater(0), failedCount(0) {}
+
+void UploadArena::attach(uint8_t* storage, size_t capacity) {
+    block = storage;
+    this->capacity = storage ? capacity : 0;
+    used = 0;
+}
+
+void UploadArena::reset() {
+    used = 0;
+}
+
+void* UploadArena::allocate(size_t bytes, size_t alignment) {
+    uintptr_t base = reinterpret_cast<uintptr_t>(block);
+    size_t start = ((base + used + alignment - 1) & ~(alignment - 1)) - base;
+    if (start > capacity || bytes > capacity - start) {
+        failedCount++;
+        return nullptr;
+    }
+    used = start + bytes;
+    if (used > highWater) {
+        highWater = used;
+    }
+    return block + start;
+}
+
+const char* UploadArena::format(const char* fmt, ...) {
+    if (used >= capacity) {
+        failedCount++;
+        return "";
+    }
+
+    // Write into all the room left, then keep only what the text took
+    char* text = reinterpret_cast<char*>(block + used);
+    size_t room = capacity - used;
+    va_list args;
+    va_start(args, fmt);
+    int length = vsnprintf(text, room, fmt, args);
+    va_end(args);
+    if (length < 0) {
+        text[0] = '\0';
+        length = 0;
+    }
+    if (static_cast<size_t>(length) >= room) {
+        failedCount++;
+        length = room - 1;
+    }
+
+    used += length + 1;
+    if (used > highWater) {
+        highWater = used;
+    }
+    return text;
+}
@@ -1,23 +1,43 @@
 #ifndef UNIT_TEST
 #include <Arduino.h>
 
+#include <esp_system.h>
 #include <esp_task_wdt.h>
 
+#include "AcquisitionTask.h"
+#include "AdaptiveSampler.h"
 #include "BootId.h"
+#include "BootProfiler.h"
 #include "ConfigManager.h"
 #include "DataManager.h"
 #include "DisplayManager.h"
+#include "DisplayTask.h"
 #include "ErrorLogger.h"
+#include "EventDetector.h"
 #include "HardwareId.h"
+#include "HeapTrace.h"
+#include "LoopProfiler.h"
+#include "LoopScheduler.h"
 #include "NetworkManager.h"
+#include "NetworkTask.h"
+#include "OutboundQueue.h"
+#include "PowerLock.h"
 #include "PowerManager.h"
+#include "RegistrationManager.h"
+#include "RenderScheduler.h"
+#include "ReportDeadband.h"
+#include "RtcStateStore.h"
 #include "SensorManager.h"
+#include "SerialCommandReader.h"
+#include "SoilUlp.h"
 #include "StateManager.h"
 #include "SystemStatusManager.h"
+#include "TaskMonitor.h"
 #include "TimeManager.h"
 #include "TouchDetector.h"
 #include "Version.h"
 #include "models/AveragedData.h"
+#include "models/RadioPolicy.h"
 #include "models/SensorReadings.h"
 #include "models/SystemStatus.h"
 
@@ -27,6 +47,13 @@
 // Watchdog timeout (30 seconds)
 #define WDT_TIMEOUT 30
 
+// Longest wait in setup() for the acquisition task's sensor init (3 retries per bus)
+#define SENSOR_INIT_TIMEOUT_MS 15000
+
+// Console poll period under automatic light sleep; long enough for the chip to settle in
+// sleep between passes, short enough for serial commands
+#define AUTO_SLEEP_LOOP_MS 100
+
 // Critical error state flag
 bool criticalErrorState = false;
 
@@ -37,9 +64,17 @@ SystemStatusManager systemStatusManager;
 DataManager dataManager;
 DisplayManager displayManager;
 SensorManager sensorManager;
+AcquisitionTask acquisitionTask(sensorManager);
+AdaptiveSampler adaptiveSampler;
+EventDetector eventDetector;
+DisplayTask displayTask(displayManager, dataManager);
 NetworkManager networkManager(configManager, timeManager, systemStatusManager);
+NetworkTask networkTask(networkManager);
+RegistrationManager registrationManager(&networkManager, &configManager);
 PowerManager powerManager;
 StateManager stateManager;
+OutboundQueue outboundQueue;
+SerialCommandReader serialConsole;
 
 // Global Boot ID (generated once in setup())
 String g_bootId;
@@ -47,15 +82,641 @@ String g_bootId;
 // Registration callback function (to be called from ConfigManager)
 void triggerManualRegistration() {
     Serial.println("Manual registration triggered via serial console");
-    // TODO: When RegistrationManager is integrated (Task 9), call:
-    // registrationManager.registerDevice(hardwareId, g_bootId, friendlyName, firmwareVersion);
-    Serial.println("Note: Full registration implementation pending Task 9 integration");
+    if (!registrationManager.registerWithNextUpload(HardwareId::getHardwareId(), g_bootId,
+                                                    configManager.getConfig().deviceId,
+                                                    FIRMWARE_VERSION)) {
+        Serial.println("Registration already waiting for the next upload");
+    }
 }
 
 // Timing variables
 unsigned long lastSensorRead = 0;
-unsigned long lastWiFiCheck = 0;
-const unsigned long WIFI_CHECK_INTERVAL = 60000;  // Check WiFi every 60 seconds
+const unsigned long WIFI_CHECK_INTERVAL = 60000;  // Refresh RSSI every 60 seconds
+
+// loop() timers (see LoopScheduler); the bottom of loop() waits for the earliest
+LoopScheduler loopScheduler;
+const uint32_t STATUS_UPDATE_INTERVAL_MS = 1000;
+const uint32_t DISPLAY_TICK_MS = 1000 / RENDER_DEFAULT_MAX_FPS;
+const uint32_t LOW_POWER_DISPLAY_TICK_MS = 1000 / RENDER_LOW_POWER_MAX_FPS;
+const uint32_t CONSOLE_POLL_MS = 50;
+const uint32_t UPLOAD_POLL_MS = 10;  // processUpload() steps while an upload runs inline
+// Result check while the network task uploads; each result also wakes loop(). Not above
+// LIGHT_SLEEP_MIN_MS, so a running upload never ends in a light sleep
+const uint32_t UPLOAD_RESULT_POLL_MS = 1000;
+
+// A reading overdue by this long (or the first one) is waited for in short steps
+const uint32_t READING_GRACE_MS = 1000;
+
+// Light sleep only pays off beyond this; shorter idle times wait on the reading queue
+const uint32_t LIGHT_SLEEP_MIN_MS = 1000;
+
+// Flash outbound queue drain: records per upload and uploads per publish cycle
+const uint16_t OUTBOUND_DRAIN_PAGE = NetworkTask::PAGE_CAPACITY;
+const uint8_t OUTBOUND_DRAIN_PAGES_PER_CYCLE = 4;
+
+// Open the upload connection this long before the reading that closes a window
+const uint32_t PREWARM_LEAD_MS = 2000;
+bool connectionPrewarmed = false;  // Tried for the window being averaged
+
+// RAM backlog drain: windows per upload (the byte cap in NetworkManager may cut it further)
+const uint16_t BACKLOG_PAGE = NetworkTask::PAGE_CAPACITY;
+
+// Radio policy (models/RadioPolicy.h) between uploads, re-evaluated this often
+const uint32_t RADIO_CHECK_INTERVAL_MS = 1000;
+
+// Deferred boot work: touch detection runs after the first sample
+bool touchDetectionPending = false;
+bool uplinkWaiting = false;  // An upload came due while WiFi was down
+
+// Upload pipeline: flash pages first, then RAM backlog pages (the first one carrying the
+// window just closed), back-to-back over the kept-alive connection
+PackedAveragedData drainPage[OUTBOUND_DRAIN_PAGE];
+uint16_t drainPageCount = 0;
+uint8_t drainPagesLeft = 0;
+AveragedData pendingWindow;
+bool windowPending = false;
+bool uploadingPage = false;
+
+// Soil moisture alert (EventDetector): a one-reading upload that goes ahead of the
+// pipeline above, which resumes once it is done
+AveragedData eventWindow;
+bool eventPending = false;
+bool uploadingEvent = false;
+bool eventResumesPipeline = false;
+
+BufferedBatch drainPageSource(void*) {
+    return {{{drainPage, drainPageCount}, {nullptr, 0}}};
+}
+
+BufferedBatch noBacklogSource(void*) {
+    return {};
+}
+
+BufferedBatch backlogSource(void*) {
+    return dataManager.getBufferedBatch().first(BACKLOG_PAGE);
+}
+
+void onUploadComplete(const UploadResult& result, void*);
+
+/**
+ * Windows per upload under the configured policy. On battery the stride is capped at
+ * the backlog copy that survives deep sleep in RTC memory.
+ */
+uint16_t currentUplinkStride() {
+    Config& config = configManager.getConfig();
+    uint32_t windowSec = config.publishIntervalSamples * (config.readingIntervalMs / 1000);
+    uint8_t battery = config.batteryMode ? powerManager.getBatteryPercentage() : 100;
+    uint16_t limit =
+        config.batteryMode ? RTC_STATE_DATA_RECORDS : dataManager.getDataBufferCapacity();
+    return uplinkStride(static_cast<UplinkPolicy>(config.uplinkPolicy), config.uplinkWindows,
+                        config.uplinkIntervalSec, windowSec, battery, limit);
+}
+
+// An upload is due once the window being averaged completes the stride
+bool uplinkDueWithNextWindow() {
+    return dataManager.getBufferedDataCount() + 1u >= currentUplinkStride() ||
+           dataManager.isBufferNearFull();
+}
+
+/**
+ * Interval until the next reading: signal dynamics within battery-derived bounds. On
+ * mains, readings only speed up for events; flat signals stretch it in battery mode.
+ */
+uint32_t currentReadingIntervalMs() {
+    Config& config = configManager.getConfig();
+    if (!powerManager.isPowerManagementEnabled()) {
+        return adaptiveSampler.getIntervalMs(config.readingIntervalMs, BatteryLevel::NORMAL,
+                                             false);
+    }
+    return adaptiveSampler.getIntervalMs(
+        powerManager.getAdaptiveReadingInterval(config.readingIntervalMs),
+        powerManager.getBatteryLevel(), true);
+}
+
+// Time until the next upload, from the window being averaged and the uplink stride
+uint32_t msUntilUplink() {
+    uint32_t intervalMs = currentReadingIntervalMs();
+    uint16_t publish = dataManager.getPublishIntervalSamples();
+    uint16_t collected = dataManager.getCurrentSampleCount();
+    uint16_t samplesLeft = collected < publish ? publish - collected : 0;
+    uint16_t windowsAfter = 0;
+    if (!uplinkDueWithNextWindow()) {
+        windowsAfter = currentUplinkStride() - (dataManager.getBufferedDataCount() + 1);
+    }
+    uint32_t sinceReadMs = lastSensorRead ? timeManager.monotonicMs() - lastSensorRead : 0;
+    return uplinkEtaMs(samplesLeft, intervalMs, sinceReadMs, windowsAfter,
+                       (uint32_t)publish * intervalMs);
+}
+
+/**
+ * Pick the radio state between uploads: max modem sleep while idle, off when the next
+ * upload is far enough out for a rejoin to pay off. The radio comes back
+ * RADIO_WAKE_LEAD_MS ahead, or during the last reading interval before an upload (a
+ * light-sleeping loop may not see the lead), and whenever an upload is waiting for it.
+ * @param windowClosesNext The next reading closes the window being averaged
+ */
+void updateRadioPolicy(bool windowClosesNext) {
+    if (networkTask.isUploadBusy()) {
+        return;
+    }
+
+    Config& config = configManager.getConfig();
+    RadioMode current = networkTask.getRadioMode();
+    uint8_t battery = config.batteryMode ? powerManager.getBatteryPercentage() : 100;
+    RadioMode mode = radioModeFor(current, msUntilUplink(), battery, config.batteryMode);
+    if (mode == RadioMode::OFF && current != RadioMode::OFF && timeManager.needsNtpSync()) {
+        mode = RadioMode::MODEM_SLEEP;  // Keep the first association until NTP syncs
+    }
+    if (uplinkWaiting || eventPending || (windowClosesNext && uplinkDueWithNextWindow())) {
+        mode = RadioMode::MODEM_SLEEP;
+    }
+    if (mode == current) {
+        return;
+    }
+
+    if (current == RadioMode::OFF) {
+        if (!BootProfiler::isFinished(BOOT_PHASE_WIFI)) {
+            BootProfiler::start(BOOT_PHASE_WIFI, millis());
+        }
+        networkTask.connectWiFi();
+    }
+    networkTask.setRadioMode(mode);
+}
+
+void updateQueueStatus() {
+    systemStatusManager.setQueueDepth(dataManager.getBufferedDataCount());
+    systemStatusManager.setOutboundQueueStats(outboundQueue.getStats());
+
+    // Check for buffer overflow warning
+    if (dataManager.isBufferNearFull()) {
+        Serial.println("WARNING: Transmission buffer > 80% full!");
+    }
+}
+
+// Charge the time since the previous loop to what each subsystem is doing now
+void updateEnergyAccounting() {
+    EnergySample sample;
+    if (networkManager.getRadioMode() != RadioMode::OFF && networkManager.isRadioBusy()) {
+        sample.radio = ENERGY_WIFI_RX;
+    } else if (networkManager.getRadioMode() != RadioMode::OFF && networkManager.isConnected()) {
+        sample.radio = ENERGY_WIFI_IDLE;
+    } else {
+        sample.radio = NUM_ENERGY_STATES;  // Radio off
+    }
+    sample.backlight =
+        displayManager.isDisplayEnabled() ? displayManager.getBacklightBrightness() : 0;
+    sample.bytesSent = systemStatusManager.getNetBytesSent();
+    sample.sensorBusyMs = acquisitionTask.getBusyMs();
+
+    powerManager.accountEnergy(millis(), sample);
+    systemStatusManager.setEnergyReport(powerManager.getEnergyReport());
+}
+
+// Estimated charge per subsystem and time per state (battery, diag and energy commands)
+void printEnergy() {
+    EnergyMeter& meter = powerManager.getEnergyMeter();
+    EnergyReport report = meter.getReport();
+    float hours = report.windowMs / 3600000.0f;
+
+    Serial.printf("Energy (mAh over %lu s):\n", (unsigned long)(report.windowMs / 1000));
+    for (uint8_t i = 0; i < NUM_ENERGY_SUBSYSTEMS; i++) {
+        EnergySubsystem subsystem = static_cast<EnergySubsystem>(i);
+        Serial.printf("  %-9s %.3f\n", EnergyMeter::subsystemKey(subsystem),
+                      report.subsystemMah[i]);
+    }
+    float total = meter.getTotalMah();
+    Serial.printf("  %-9s %.3f (%.2f mA average)\n", "total", total,
+                  hours > 0.0f ? total / hours : 0.0f);
+
+    Serial.println("Time in state (s, coefficient mA):");
+    for (uint8_t i = 0; i < NUM_ENERGY_STATES; i++) {
+        EnergyState state = static_cast<EnergyState>(i);
+        Serial.printf("  %-11s %lu (%.1f)\n", EnergyMeter::stateKey(state),
+                      (unsigned long)(meter.getStateMs(state) / 1000), meter.getCoefficient(state));
+    }
+}
+
+// "energy", "energy reset" or "energy <state> <mA>"
+void handleEnergyCommand(String arg) {
+    arg.trim();
+    EnergyMeter& meter = powerManager.getEnergyMeter();
+    if (arg == "reset") {
+        meter.reset();
+        Serial.println("[INFO] Energy totals reset");
+        return;
+    }
+    if (arg.length() > 0) {
+        int split = arg.indexOf(' ');
+        String key = split > 0 ? arg.substring(0, split) : arg;
+        float milliamps = split > 0 ? arg.substring(split + 1).toFloat() : -1.0f;
+        for (uint8_t i = 0; i < NUM_ENERGY_STATES; i++) {
+            EnergyState state = static_cast<EnergyState>(i);
+            if (key == EnergyMeter::stateKey(state) && milliamps >= 0.0f) {
+                meter.setCoefficient(state, milliamps);
+                Serial.printf("[INFO] Energy coefficient %s = %.1f mA\n", key.c_str(), milliamps);
+                return;
+            }
+        }
+        Serial.println("[WARN] Usage: energy | energy reset | energy <state> <mA>");
+        return;
+    }
+    printEnergy();
+}
+
+// Keep the closed window for a later upload
+void bufferPendingWindow() {
+    if (windowPending) {
+        dataManager.bufferForTransmission(pendingWindow);
+        windowPending = false;
+    }
+    updateQueueStatus();
+}
+
+// Send the pending alert on its own, ahead of any batched data
+bool startEventUpload() {
+    uploadingEvent = networkTask.startUpload(noBacklogSource(nullptr), &eventWindow);
+    if (uploadingEvent) {
+        eventPending = false;
+    }
+    return uploadingEvent;
+}
+
+/**
+ * Start the next upload of the pipeline: a pending alert first, then a page spilled to
+ * flash (oldest first), or once those are done for this cycle, the next RAM backlog
+ * page (plus the pending window)
+ */
+void startNextUpload() {
+    if (eventPending && startEventUpload()) {
+        eventResumesPipeline = true;
+        return;
+    }
+    uploadingPage = false;
+    if (drainPagesLeft > 0 && !outboundQueue.isEmpty()) {
+        drainPagesLeft--;
+        drainPageCount = outboundQueue.peek(drainPage, OUTBOUND_DRAIN_PAGE);
+        uploadingPage = drainPageCount > 0;
+    }
+
+    if (uploadingPage) {
+        Serial.printf("[INFO] Draining %u spilled reading(s) (%lu queued on flash)\n",
+                      drainPageCount, (unsigned long)outboundQueue.size());
+        if (networkTask.startUpload(drainPageSource(nullptr), nullptr)) {
+            return;
+        }
+        Serial.println("Spilled data upload failed, buffering data...");
+    } else {
+        Serial.print("Sending ");
+        Serial.print(backlogSource(nullptr).count() + (windowPending ? 1 : 0));
+        Serial.print(" of ");
+        Serial.print(dataManager.getBufferedDataCount() + (windowPending ? 1 : 0));
+        Serial.println(" reading(s)...");
+
+        // The network task keeps its own copy of the page and the window
+        if (networkTask.startUpload(backlogSource(nullptr),
+                                    windowPending ? &pendingWindow : nullptr)) {
+            windowPending = false;
+            return;
+        }
+        Serial.println("Transmission failed, buffering data...");
+    }
+    bufferPendingWindow();
+}
+
+/**
+ * Hand soil sampling to the ULP for the coming deep sleep. The window it accumulates is
+ * folded into the next averaging window on wake, so that window closes on its first
+ * full reading; a threshold crossing wakes the node early and the window then finishes
+ * awake at the normal rate.
+ * @param config Current configuration
+ * @param sleepMs Planned sleep
+ * @return ULP reading interval, or 0 if the ULP was not started
+ */
+uint32_t startSoilUlp(const Config& config, uint32_t sleepMs) {
+    if (!sensorManager.isSensorAvailable(SensorType::SOIL_MOISTURE)) {
+        return 0;
+    }
+    uint32_t periodMs =
+        config.readingIntervalMs *
+        SensorManager::intervalToDivisor(config.soilIntervalMs, config.readingIntervalMs);
+    uint32_t windowSamples = periodMs ? sleepMs / periodMs : 0;
+    if (windowSamples > 0xFFFF) {
+        windowSamples = 0xFFFF;
+    }
+    if (!SoilUlp::start(periodMs, windowSamples,
+                        sensorManager.soilPercentToRaw(config.soilMoistureThresholdLow),
+                        sensorManager.soilPercentToRaw(config.soilMoistureThresholdHigh),
+                        sensorManager.getLatestReadings().soilMoistureRaw)) {
+        return 0;
+    }
+    return periodMs;
+}
+
+/**
+ * End of a wake cycle: after a successful upload, or a window buffered for a later one.
+ * Deep sleep (battery mode only) lasts one averaging window, or ends on the next wall-clock
+ * window boundary once the clock is synced (align_windows).
+ */
+void sleepUntilNextWindow() {
+    Config& config = configManager.getConfig();
+    uint32_t sleepSeconds = config.publishIntervalSamples * (config.readingIntervalMs / 1000);
+    if (config.alignWindows && sleepSeconds > 0 && timeManager.timeSynced()) {
+        // Wake on the next wall-clock multiple of the window, so each wake closes one
+        uint32_t boundaryMs =
+            DataManager::msToWindowBoundary(timeManager.epochMsOrZero(), sleepSeconds * 1000);
+        sleepSeconds = boundaryMs > 1000 ? (boundaryMs + 999) / 1000 : 1;
+    }
+    if (config.batteryMode) {
+        // The snapshot rotates the display history and the panel goes off next
+        displayTask.stop();
+        // RAM is lost in deep sleep: the newest windows and graph history
+        // go to RTC memory, anything older to the flash queue
+        if (!RtcStateStore::save(dataManager, millis(), sleepSeconds * 1000)) {
+            BufferedBatch older = dataManager.getBufferedBatch();
+            for (uint16_t i = 0; i + RTC_STATE_DATA_RECORDS < older.count(); i++) {
+                outboundQueue.append(older.at(i));
+            }
+        }
+        // The RTC timer keeps counting while asleep: the next wake starts synced
+        timeManager.saveForSleep(millis(), sleepSeconds * 1000);
+        // A threshold wake (SoilUlp) is measured against the zone before the sleep
+        eventDetector.saveForSleep();
+        // Occasional NVS copy in case power is lost while asleep
+        if (stateManager.isCheckpointDue()) {
+            stateManager.persistState(dataManager.snapshot(millis()));
+        }
+        // No backlight or panel current while asleep
+        if (displayManager.isInitialized()) {
+            displayManager.powerDown();
+        }
+    }
+    // Staged spill records and a scheduled config save would not survive deep sleep
+    outboundQueue.flush();
+    configManager.flushPendingSave();
+    ErrorLogger::flush();  // Buffered log text is lost in deep sleep too
+
+    // With the ULP sampling, the timer only backs up its window-complete wakeup
+    uint32_t timerSeconds = sleepSeconds;
+    if (config.batteryMode) {
+        uint32_t ulpPeriodMs = startSoilUlp(config, sleepSeconds * 1000);
+        if (ulpPeriodMs > 0) {
+            timerSeconds += ulpPeriodMs / 1000 + 1;
+        }
+    }
+    powerManager.checkAndTriggerDeepSleep(config.batteryMode, timerSeconds);
+}
+
+/**
+ * Close the window being averaged: stamp its epochs, then report, defer or upload it
+ */
+void publishWindow() {
+    Serial.println("=== Publishing Averaged Data ===");
+    connectionPrewarmed = false;
+    LoopProfiler::start(LOOP_PHASE_AVERAGING, micros());
+
+    // Calculate averages
+    AveragedData avgData = dataManager.calculateAverages();
+
+    // Epochs of the window's own first and last samples, mapped from their
+    // monotonic timestamps (also right for a window that began before the sync)
+    avgData.timeSynced = timeManager.timeSynced();
+    avgData.sampleStartEpochMs = timeManager.epochAtMonotonicMs(avgData.sampleStartUptimeMs);
+    avgData.sampleEndEpochMs = timeManager.epochAtMonotonicMs(avgData.sampleEndUptimeMs);
+    avgData.deviceBootEpochMs = timeManager.deviceBootEpochMs();
+    avgData.uptimeMs = timeManager.uptimeMs();
+
+    // Re-derive the batch ID now that the epoch fields are known, so buffered
+    // (packed) copies expand to the same ID
+    DataManager::formatBatchId(avgData.batchId, sizeof(avgData.batchId), avgData);
+
+    // Clear averaging buffer
+    dataManager.clearAveragingBuffer();
+    LoopProfiler::finish(LOOP_PHASE_AVERAGING, micros());
+
+    // Uploads run in the network task on the other core, so sampling and the
+    // display keep going through TLS handshakes, retries and backoff
+    LoopProfiler::start(LOOP_PHASE_PUBLISH, micros());
+    uint16_t stride = currentUplinkStride();
+    if (!ReportDeadband::shouldReport(avgData)) {
+        // Report by exception: an unchanged window is not sent at all
+        Serial.printf("Window within deadband, not reported (%u in a row)\n",
+                      ReportDeadband::getSuppressedRun());
+        if (configManager.getConfig().batteryMode && !networkTask.isUploadBusy()) {
+            sleepUntilNextWindow();
+        }
+    } else if (dataManager.getBufferedDataCount() + 1u < stride &&
+               !dataManager.isBufferNearFull()) {
+        Serial.printf("Uplink deferred (%u of %u windows collected)\n",
+                      dataManager.getBufferedDataCount() + 1, stride);
+        dataManager.bufferForTransmission(avgData);
+        updateQueueStatus();
+        // Nothing to send this cycle: sleep without waking the radio
+        if (configManager.getConfig().batteryMode && !networkTask.isUploadBusy()) {
+            sleepUntilNextWindow();
+        }
+    } else if (!networkManager.isConnected()) {
+        Serial.println("WiFi not connected, buffering data...");
+        dataManager.bufferForTransmission(avgData);
+        updateQueueStatus();
+        uplinkWaiting = true;
+    } else if (networkTask.isUploadBusy()) {
+        Serial.println("Upload in progress, buffering data...");
+        dataManager.bufferForTransmission(avgData);
+        updateQueueStatus();
+        // An alert upload does not carry the batch: send it once that one is done
+        uplinkWaiting = uplinkWaiting || uploadingEvent;
+    } else {
+        Serial.println("WiFi connected, attempting transmission...");
+        pendingWindow = avgData;
+        windowPending = true;
+        drainPagesLeft = OUTBOUND_DRAIN_PAGES_PER_CYCLE;
+        startNextUpload();
+    }
+    LoopProfiler::finish(LOOP_PHASE_PUBLISH, micros());
+
+    Serial.println("================================\n");
+}
+
+/**
+ * A reading raised a soil moisture alert: send it as a one-reading window right away, or
+ * as soon as the link and the running upload allow (a newer alert replaces a waiting one)
+ * @param readings Reading that raised it
+ * @param events SoilEvent bits
+ */
+void onSoilEvent(const SensorReadings& readings, uint8_t events) {
+    EventDetector::toWindow(readings, eventWindow);
+    eventWindow.timeSynced = timeManager.timeSynced();
+    eventWindow.sampleStartEpochMs = timeManager.epochAtMonotonicMs(readings.monotonicMs);
+    eventWindow.sampleEndEpochMs = eventWindow.sampleStartEpochMs;
+    eventWindow.deviceBootEpochMs = timeManager.deviceBootEpochMs();
+    DataManager::formatBatchId(eventWindow.batchId, sizeof(eventWindow.batchId), eventWindow);
+    eventPending = true;
+
+    Serial.printf("[INFO] Soil moisture event 0x%02x at %.1f%%, uploading ahead of the batch\n",
+                  events, readings.soilMoisture);
+    if (networkManager.isConnected() && !networkTask.isUploadBusy()) {
+        startEventUpload();
+    }
+}
+
+// SNTP result, delivered on the lwIP task: log only
+void onTimeSync(uint64_t epochMs, int32_t offsetMs, void*) {
+    Serial.printf("[INFO] NTP sync #%lu: epoch %llu ms, offset %ld ms, drift %ld ppm\n",
+                  (unsigned long)timeManager.getSyncCount(), (unsigned long long)epochMs,
+                  (long)offsetMs, (long)timeManager.getDriftPpm());
+}
+
+void onUploadComplete(const UploadResult& result, void*) {
+    if (uploadingEvent) {
+        uploadingEvent = false;
+        // The reading is in the window being averaged as well, so a lost alert is not resent
+        if (result.success) {
+            Serial.println("Event upload successful");
+        } else {
+            Serial.println("Event upload failed");
+            systemStatusManager.incrementNetworkFailures();
+        }
+        if (eventResumesPipeline) {
+            eventResumesPipeline = false;
+            startNextUpload();
+        }
+        return;
+    }
+
+    if (uploadingPage) {
+        if (result.success) {
+            // Records the server did not confirm stay queued for the next cycle
+            outboundQueue.commit(result.ackedCount);
+            if (result.ackedCount < drainPageCount) {
+                drainPagesLeft = 0;
+            }
+            startNextUpload();
+        } else {
+            // The cursor stays on the unsent page
+            Serial.println("Spilled data upload failed, buffering data...");
+            systemStatusManager.incrementNetworkFailures();
+            bufferPendingWindow();
+        }
+        return;
+    }
+
+    if (!result.success) {
+        Serial.println("Transmission failed, buffering data...");
+        if (result.current) {
+            dataManager.bufferForTransmission(*result.current);
+        }
+        systemStatusManager.incrementNetworkFailures();
+        updateQueueStatus();
+        return;
+    }
+
+    Serial.println("Transmission successful!");
+    systemStatusManager.setLastTransmissionTime(timeManager.monotonicMs());
+
+    // Per-page commit up to the server's ack watermark, by the sequence of the last
+    // confirmed window in the task's copy: windows buffered meanwhile are newer and stay
+    if (result.ackedCount > 0) {
+        BufferedBatch sent = networkTask.getSentPage();
+        dataManager.acknowledgeThrough(sent.at(result.ackedCount - 1).sequence);
+    }
+    if (result.current && !result.currentAcked) {
+        dataManager.bufferForTransmission(*result.current);  // Resent with the backlog
+    }
+    updateQueueStatus();
+    // Keep draining only while the server confirms whole pages
+    bool pageConfirmed =
+        result.ackedCount == result.backlogCount && (!result.current || result.currentAcked);
+    if (pageConfirmed && dataManager.getBufferedDataCount() > 0) {
+        startNextUpload();
+        return;
+    }
+
+    sleepUntilNextWindow();
+}
+
+/**
+ * "graph" console command: show the graph span, or set it ("graph 4h", "graph 24h",
+ * "graph 7d")
+ */
+void handleGraphCommand(const char* args) {
+    String arg = args;
+    uint32_t amount = arg.toInt();
+    if (amount == 0) {
+        Serial.printf("[INFO] Graph span: %lu h\n",
+                      (unsigned long)(displayManager.getGraphSpanMs() / 3600000UL));
+    } else {
+        uint32_t unitMs = arg.endsWith("d") ? 86400000UL : 3600000UL;
+        displayTask.lock();
+        displayManager.setGraphSpanMs(amount * unitMs);
+        displayTask.unlock();
+        Serial.printf("[INFO] Graph span set to %s\n", arg.c_str());
+    }
+}
+
+// "perf" console command: per-phase loop() histograms since boot (or "perf reset")
+void handlePerfCommand(const char* args) {
+    if (strcmp(args, "reset") == 0) {
+        LoopProfiler::reset();
+        Serial.println("[INFO] Loop phase histograms reset");
+        return;
+    }
+
+    Serial.println("\n=== Loop Phases (us) ===");
+    Serial.printf("  %-9s %8s %8s %8s %8s %8s\n", "Phase", "Passes", "Last", "p50", "p95",
+                  "Max");
+    for (uint8_t i = 0; i < NUM_LOOP_PHASES; i++) {
+        LoopPhase phase = static_cast<LoopPhase>(i);
+        const LoopPhaseStats& stats = LoopProfiler::stats(phase);
+        Serial.printf("  %-9s %8lu %8lu %8lu %8lu %8lu\n", LoopProfiler::phaseKey(phase),
+                      (unsigned long)stats.count, (unsigned long)stats.lastUs,
+                      (unsigned long)LoopProfiler::percentileUs(phase, 50),
+                      (unsigned long)LoopProfiler::percentileUs(phase, 95),
+                      (unsigned long)stats.maxUs);
+    }
+
+    // Bucket b: under 16 << 2b us; the last bucket is everything from ~1 s up
+    Serial.print("\nHistogram (passes per bucket, upper bound in us):\n  Phase    ");
+    for (uint8_t b = 0; b < LOOP_HISTOGRAM_BUCKETS - 1; b++) {
+        Serial.printf(" <%-7lu", (unsigned long)LoopProfiler::bucketLimitUs(b));
+    }
+    Serial.println(" more");
+    for (uint8_t i = 0; i < NUM_LOOP_PHASES; i++) {
+        LoopPhase phase = static_cast<LoopPhase>(i);
+        const LoopPhaseStats& stats = LoopProfiler::stats(phase);
+        Serial.printf("  %-9s", LoopProfiler::phaseKey(phase));
+        for (uint8_t b = 0; b < LOOP_HISTOGRAM_BUCKETS; b++) {
+            Serial.printf(" %8lu", (unsigned long)stats.buckets[b]);
+        }
+        Serial.println();
+    }
+    Serial.println("========================\n");
+}
+
+// "battery" console command
+void printBatteryStatus() {
+    if (!powerManager.isPowerManagementEnabled()) {
+        Serial.println("Battery mode not enabled");
+        return;
+    }
+    Serial.println("\n=== Battery Status ===");
+    Serial.print("Voltage: ");
+    Serial.print(powerManager.readBatteryVoltage(), 2);
+    Serial.println(" V");
+    Serial.print("Percentage: ");
+    Serial.print(powerManager.getBatteryPercentage());
+    Serial.println(" %");
+    Serial.print("Status: ");
+    if (powerManager.isBatteryLow()) {
+        Serial.println("LOW");
+    } else {
+        Serial.println("OK");
+    }
+    Serial.print("Adaptive Interval: ");
+    Serial.print(currentReadingIntervalMs() / 1000);
+    Serial.println(" seconds");
+    printEnergy();
+    Serial.println("======================\n");
+}
 
 // Diagnostic function
 void printDiagnostics() {
@@ -71,11 +732,33 @@ void printDiagnostics() {
     Serial.print(systemStatusManager.getFreeHeap());
     Serial.println(" bytes");
 
-#ifdef ARDUINO
-    Serial.print("Heap Low Watermark: ");
-    Serial.print(ESP.getMinFreeHeap());
-    Serial.println(" bytes");
-#endif
+    // The largest block, not the total, decides whether a TLS handshake can allocate
+    SystemStatus heapStatus = systemStatusManager.getStatus();
+    Serial.printf("Heap Low Watermark: %lu bytes\n", (unsigned long)heapStatus.minFreeHeap);
+    Serial.printf("Largest Free Block: %lu bytes (%u%% of free)\n",
+                  (unsigned long)heapStatus.largestFreeBlock,
+                  heapStatus.freeHeap > 0
+                      ? (unsigned)(100ULL * heapStatus.largestFreeBlock / heapStatus.freeHeap)
+                      : 0u);
+    if (heapStatus.allocationsTracked) {
+        Serial.printf("Heap Allocations: %lu last loop, %lu max, %ld outstanding\n",
+                      (unsigned long)heapStatus.loopAllocations,
+                      (unsigned long)heapStatus.maxLoopAllocations,
+                      (long)HeapTrace::getOutstanding());
+    }
+
+    // Least free stack since each task started; CPU needs FreeRTOS run-time stats
+    Serial.println("Tasks (stack bytes, min free, CPU %):");
+    for (uint8_t i = 0; i < TaskMonitor::getCount(); i++) {
+        const TaskStats& task = TaskMonitor::get(i);
+        Serial.printf("  %-11s %6lu %6lu %s", task.name, (unsigned long)task.stackBytes,
+                      (unsigned long)task.minFreeStackBytes, task.stackLow ? "LOW " : "");
+        if (task.cpuPercent == TASK_CPU_UNKNOWN) {
+            Serial.println("n/a");
+        } else {
+            Serial.printf("%u\n", task.cpuPercent);
+        }
+    }
 
     // WiFi status
     Serial.print("WiFi Status: ");
@@ -87,23 +770,91 @@ void printDiagnostics() {
         Serial.println("Disconnected");
     }
 
+    // Upload/registration request phases (rolling window)
+    static const char* const phaseNames[NUM_NETWORK_PHASES] = {"DNS", "Connect", "Request",
+                                                               "Response"};
+    Serial.println("Network Request Latency (us, min/avg/p95/max):");
+    for (uint8_t phase = 0; phase < NUM_NETWORK_PHASES; phase++) {
+        LatencyStats lat = systemStatusManager.getNetworkLatency(phase);
+        Serial.printf("  %-9s %lu/%lu/%lu/%lu (n=%u)\n", phaseNames[phase],
+                      (unsigned long)lat.minUs, (unsigned long)lat.avgUs,
+                      (unsigned long)lat.p95Us, (unsigned long)lat.maxUs, lat.count);
+    }
+    SystemStatus netStatus = systemStatusManager.getStatus();
+    Serial.printf("  Bytes sent/received: %lu/%lu\n", (unsigned long)netStatus.netBytesSent,
+                  (unsigned long)netStatus.netBytesReceived);
+
+    // Startup phases, this boot and the one before (RTC memory, lost on power loss)
+    static const char* const bootPhaseNames[NUM_BOOT_PHASES] = {
+        "Config", "NVS", "Display", "Touch", "Sensors", "WiFi", "NTP"};
+    const BootProfile& boot = BootProfiler::current();
+    BootProfile lastBoot;
+    bool haveLastBoot = BootProfiler::previous(lastBoot);
+    Serial.println("\nBoot Phases (ms, this boot / previous):");
+    for (uint8_t phase = 0; phase < NUM_BOOT_PHASES; phase++) {
+        Serial.printf("  %-9s ", bootPhaseNames[phase]);
+        if (boot.doneMask & (1 << phase)) {
+            Serial.printf("%lu", (unsigned long)boot.phaseMs[phase]);
+        } else {
+            Serial.print("-");
+        }
+        if (haveLastBoot && (lastBoot.doneMask & (1 << phase))) {
+            Serial.printf(" / %lu\n", (unsigned long)lastBoot.phaseMs[phase]);
+        } else {
+            Serial.println(" / -");
+        }
+    }
+    Serial.printf("  %-9s %lu / %lu\n", "setup()", (unsigned long)boot.setupMs,
+                  haveLastBoot ? (unsigned long)lastBoot.setupMs : 0UL);
+
     // Sensor status
     Serial.println("\nSensor Status:");
     Serial.print("  BME280: ");
     Serial.println(sensorManager.isSensorAvailable(SensorType::BME280_TEMP) ? "Available"
                                                                             : "Unavailable");
     Serial.print("  DS18B20: ");
-    Serial.println(sensorManager.isSensorAvailable(SensorType::DS18B20_TEMP) ? "Available"
-                                                                             : "Unavailable");
+    Serial.print(sensorManager.isSensorAvailable(SensorType::DS18B20_TEMP) ? "Available"
+                                                                           : "Unavailable");
+    Serial.print(" (");
+    Serial.print(sensorManager.getDS18B20ProbeCount());
+    Serial.println(" probe(s))");
     Serial.print("  Soil Moisture: ");
     Serial.println(sensorManager.isSensorAvailable(SensorType::SOIL_MOISTURE) ? "Available"
                                                                               : "Unavailable");
 
+    // Per-sensor bus latency (rolling window)
+    static const char* const busNames[NUM_SENSOR_BUSES] = {"BME280", "DS18B20", "Soil ADC"};
+    Serial.println("\nSensor Read Latency (us, min/avg/p95/max):");
+    for (uint8_t bus = 0; bus < NUM_SENSOR_BUSES; bus++) {
+        LatencyStats lat = systemStatusManager.getSensorLatency(bus);
+        Serial.printf("  %-9s %lu/%lu/%lu/%lu (n=%u)\n", busNames[bus], (unsigned long)lat.minUs,
+                      (unsigned long)lat.avgUs, (unsigned long)lat.p95Us, (unsigned long)lat.maxUs,
+                      lat.count);
+    }
+
+    Serial.print("  Readings Dropped (acquisition queue): ");
+    Serial.println(acquisitionTask.getDroppedCount());
+    Serial.printf("  Sampling: every %lu ms (activity %.2f, pace step %d)\n",
+                  (unsigned long)currentReadingIntervalMs(), adaptiveSampler.getActivity(),
+                  adaptiveSampler.getPaceStep());
+
+    Serial.println();
+    printEnergy();
+
     // Queue depth
     Serial.print("\nTransmission Queue Depth: ");
     Serial.print(dataManager.getBufferedDataCount());
     Serial.println(" readings");
 
+    // Flash outbound queue (RAM ring overflow)
+    OutboundQueueStats outq = outboundQueue.getStats();
+    Serial.printf("Outbound Queue (flash): %lu queued in %u segment(s)\n",
+                  (unsigned long)outq.queuedRecords, outq.segmentCount);
+    Serial.printf("  Spilled: %lu  Drained: %lu  Dropped: %lu  Flushes: %lu  Segments GC'd: %lu\n",
+                  (unsigned long)outq.spilledRecords, (unsigned long)outq.drainedRecords,
+                  (unsigned long)outq.droppedRecords, (unsigned long)outq.flushes,
+                  (unsigned long)outq.segmentsCollected);
+
     // Last successful operations
     Serial.print("Last Sensor Read: ");
     unsigned long lastRead = systemStatusManager.getLastSensorReadTime();
@@ -134,8 +885,8 @@ void printDiagnostics() {
     Serial.println(status.errors.bufferOverflows);
 
     // Last error
-    const char* lastError = systemStatusManager.getLastError();
-    if (lastError && strlen(lastError) > 0) {
+    char lastError[128];
+    if (systemStatusManager.getLastError(lastError, sizeof(lastError)) > 0) {
         Serial.print("\nLast Error: ");
         Serial.println(lastError);
     }
@@ -143,10 +894,113 @@ void printDiagnostics() {
     Serial.println("==========================\n");
 }
 
+void detectTouchController(bool force = false);
+
+// Console command table: config commands from ConfigManager, diagnostics from here
+void registerConsoleCommands() {
+    configManager.registerSerialCommands(serialConsole);
+    serialConsole.addCommand("diag", [](const char*) { printDiagnostics(); });
+    serialConsole.addCommand("graph", handleGraphCommand);
+    serialConsole.addCommand("energy", [](const char* args) { handleEnergyCommand(args); });
+    serialConsole.addCommand("battery", [](const char*) { printBatteryStatus(); });
+    serialConsole.addCommand("perf", handlePerfCommand);
+    serialConsole.addCommand("touch", [](const char* args) {
+        if (strcmp(args, "detect") == 0) {
+            detectTouchController(true);  // Full sequence, refreshes the cache
+        } else {
+            Serial.println("[WARN] Usage: touch detect");
+        }
+    });
+    serialConsole.setUnknownHandler([](const char* line) {
+        Serial.printf("Unknown command: %s (type 'help')\n", line);
+    });
+}
+
+/**
+ * Probe for a touch controller and enable touch navigation. Not needed for the first
+ * sample, so it runs from loop() once that is in (off the boot critical path).
+ * @param force Skip the detection cache (console "touch detect")
+ */
+void detectTouchController(bool force) {
+    Serial.println("Detecting touch controller...");
+    // XPT2046 shares the panel's SPI bus: no frame may go out while probing
+    displayTask.lock();
+    PowerLock::acquire();
+    TouchDetector touchDetector;
+    TouchDetectionResult touchResult = touchDetector.detectCached(force);
+    PowerLock::release();
+    displayTask.unlock();
+    if (BootProfiler::isStarted(BOOT_PHASE_TOUCH)) {
+        BootProfiler::finish(BOOT_PHASE_TOUCH, millis());
+    }
+
+    if (touchResult.detected) {
+        Serial.print("Touch controller detected: ");
+        switch (touchResult.type) {
+            case TouchControllerType::XPT2046:
+                Serial.println("XPT2046 (SPI resistive)");
+                break;
+            case TouchControllerType::FT6236:
+                Serial.println("FT6236 (I2C capacitive)");
+                break;
+            case TouchControllerType::CST816:
+                Serial.println("CST816 (I2C capacitive)");
+                break;
+            case TouchControllerType::GT911:
+                Serial.println("GT911 (I2C capacitive)");
+                break;
+            default:
+                Serial.println("Unknown");
+                break;
+        }
+        Serial.print("Detection time: ");
+        Serial.print(touchResult.detectionTimeMs);
+        Serial.println(touchDetector.usedCache() ? " ms (cached)" : " ms");
+        ErrorLogger::info(ErrorType::SYSTEM, "Touch controller detected", "touch");
+    } else {
+        Serial.println("No touch controller detected");
+        Serial.print("Detection time: ");
+        Serial.print(touchResult.detectionTimeMs);
+        Serial.println(touchDetector.usedCache() ? " ms (cached)" : " ms");
+        ErrorLogger::info(ErrorType::SYSTEM, "No touch controller detected", "touch");
+    }
+
+    // Pass touch detection result to ConfigManager
+    configManager.setTouchDetected(touchResult.detected, touchResult.type);
+
+    // Pass touch detection result to DisplayManager
+    if (displayManager.isInitialized()) {
+        displayTask.lock();
+        displayManager.setTouchEnabled(touchResult.detected, touchResult.type);
+        displayTask.unlock();
+        if (touchResult.detected) {
+            Serial.println("Touch-based config page enabled");
+        } else {
+            Serial.println("Touch-based config page disabled (no touch controller)");
+        }
+    }
+
+    Serial.println("Touch detection complete");
+    systemStatusManager.setBootProfile(BootProfiler::current());
+}
+
 void setup() {
+    // Before anything logs: keep the RTC log ring if a watchdog or panic ended the last boot
+    ErrorLogger::beginPostMortem(static_cast<ResetReason>(esp_reset_reason()));
+
+    // A timer wake from deep sleep takes the fast path: RTC state instead of flash, no
+    // splash, no touch probing, no sensor bus discovery
+    bool sleepWake = powerManager.wokeFromDeepSleep();
+    BootProfiler::beginBoot(millis());
+
     // Initialize serial communication
     Serial.begin(115200);
-    delay(1000);  // Give serial time to initialize
+    if (!sleepWake) {
+        delay(1000);  // Give serial time to initialize
+    }
+    ErrorLogger::begin();
+    ErrorLogger::dumpPostMortem();
+    TaskMonitor::add("loop", xTaskGetCurrentTaskHandle(), getArduinoLoopTaskStackSize());
 
     Serial.println("\n\n=== ESP32 Sensor Firmware ===");
     Serial.print("Version: ");
@@ -172,7 +1026,10 @@ void setup() {
     // Try loading from config file first
     Serial.println("Loading configuration from file...");
     bool configLoaded = false;
-    if (configManager.loadFromFile()) {
+    BootProfiler::start(BOOT_PHASE_CONFIG_FILE, millis());
+    bool fileLoaded = configManager.loadFromFile();
+    BootProfiler::finish(BOOT_PHASE_CONFIG_FILE, millis());
+    if (fileLoaded) {
         Serial.println("Config file loaded successfully");
 
         // Validate required fields
@@ -206,7 +1063,10 @@ void setup() {
         Serial.println("Config file not found or invalid, trying NVS...");
 
         // Fall back to NVS
-        if (configManager.loadConfig()) {
+        BootProfiler::start(BOOT_PHASE_NVS, millis());
+        bool nvsLoaded = configManager.loadConfig();
+        BootProfiler::finish(BOOT_PHASE_NVS, millis());
+        if (nvsLoaded) {
             Serial.println("Config loaded from NVS");
 
             // Validate required fields from NVS
@@ -279,6 +1139,7 @@ void setup() {
     // Set up serial console command callbacks
     configManager.setBootIdReference(&g_bootId);
     configManager.setRegistrationCallback(triggerManualRegistration);
+    registerConsoleCommands();
 
     Serial.println("ConfigManager initialized");
     esp_task_wdt_reset();  // Feed watchdog
@@ -286,12 +1147,20 @@ void setup() {
     // Initialize TimeManager
     Serial.println("Initializing TimeManager...");
     timeManager.initialize();
+    timeManager.setSyncCallback(onTimeSync, nullptr);
+    timeManager.setNtpMaxAgeSec(configManager.getConfig().ntpMaxAgeSec);
+    if (timeManager.restoreAfterSleep(millis())) {
+        Serial.printf("[INFO] Clock restored from RTC memory (NTP %s)\n",
+                      timeManager.needsNtpSync() ? "re-sync due" : "skipped");
+    }
     Serial.println("TimeManager initialized");
     esp_task_wdt_reset();  // Feed watchdog
 
     // Initialize SystemStatusManager
     Serial.println("Initializing SystemStatusManager...");
     systemStatusManager.initialize();
+    systemStatusManager.setPostMortemPending(ErrorLogger::hasPostMortem());
+    systemStatusManager.setMetricsInterval(configManager.getConfig().metricsIntervalSec * 1000UL);
     Serial.println("SystemStatusManager initialized");
     esp_task_wdt_reset();  // Feed watchdog
 
@@ -309,85 +1178,191 @@ void setup() {
         Serial.print(powerManager.getBatteryPercentage());
         Serial.println("%)");
     }
+    // DVFS always; battery nodes also light sleep whenever every task is idle
+    powerManager.configureAutoPowerSave(config.batteryMode);
     Serial.println("PowerManager initialized");
     esp_task_wdt_reset();  // Feed watchdog
 
     // Initialize StateManager and check for persisted state
     Serial.println("Initializing StateManager...");
+    BootProfiler::start(BOOT_PHASE_NVS, millis());
     stateManager.initialize();
+    BootProfiler::finish(BOOT_PHASE_NVS, millis());
     Serial.println("StateManager initialized");
     esp_task_wdt_reset();  // Feed watchdog
 
-    // Initialize DisplayManager early to catch SPI/pin issues
-    Serial.println("Initializing DisplayManager...");
-    if (displayManager.initialize()) {
-        Serial.println("DisplayManager initialized");
-        displayManager.showStartupScreen(FIRMWARE_VERSION);
-        delay(2000);  // Show startup screen for 2 seconds
-    } else {
-        Serial.println("WARNING: DisplayManager initialization failed");
-        Serial.println("Continuing without display...");
-        ErrorLogger::warning(ErrorType::DISPLAY, "Display initialization failed", "setup");
-    }
-    esp_task_wdt_reset();  // Feed watchdog
+    // A battery node waking from deep sleep skips the splash and touch navigation
+    bool glanceWake = config.batteryMode && sleepWake;
 
-    // Perform touch detection after display initialization
-    Serial.println("Detecting touch controller...");
-    TouchDetector touchDetector;
-    TouchDetectionResult touchResult = touchDetector.detect();
+    // Initialize DataManager with publish interval from config
+    Serial.println("Initializing DataManager...");
+    dataManager.setPublishIntervalSamples(config.publishIntervalSamples);
+    // Mains nodes close windows on the wall clock; a battery node aligns its sleep instead
+    if (config.alignWindows && !config.batteryMode) {
+        dataManager.setWindowAlignment(config.publishIntervalSamples * config.readingIntervalMs);
+    }
+    DeadbandTolerances deadband = {config.deadbandTemp, config.deadbandHumidity,
+                                   config.deadbandPressure, config.deadbandSoil};
+    ReportDeadband::configure(deadband, config.deadbandHeartbeat);
+    eventDetector.configure(config.soilMoistureThresholdLow, config.soilMoistureThresholdHigh);
+    eventDetector.restoreAfterSleep();
+
+    // Size the backlog and history rings from free PSRAM unless the config pins them
+    uint16_t dataCapacity = 0;
+    uint16_t displayPoints = 0;
+    DataManager::recommendBufferSizes(ESP.getFreePsram(), dataCapacity, displayPoints);
+    if (config.dataBufferCapacity > 0) {
+        dataCapacity = config.dataBufferCapacity;
+    }
+    if (config.displayHistoryPoints > 0) {
+        displayPoints = config.displayHistoryPoints;
+    }
+    if (!dataManager.configureBuffers(dataCapacity, displayPoints)) {
+        ErrorLogger::warning(ErrorType::SYSTEM, "PSRAM ring allocation failed, using defaults",
+                             "setup");
+    }
+    Serial.printf("[INFO] DataManager: %u-window backlog, %u-point history (%lu KB PSRAM free)\n",
+                  dataManager.getDataBufferCapacity(), dataManager.getDisplayCapacity(),
+                  (unsigned long)(ESP.getFreePsram() / 1024));
+
+    // Soil readings the ULP took while asleep (this also stops it). A threshold wake
+    // cut the sleep short, so the display clock only skips the time actually asleep
+    SoilAggregate sleepSoil;
+    bool sleepSoilTaken = SoilUlp::take(sleepSoil);
+    uint32_t sleptMs =
+        sleepSoil.thresholdWake ? sleepSoil.elapsedMs : RtcStateStore::SLEPT_AS_PLANNED;
+
+    // Fast path after a deep-sleep wakeup: the RTC memory image, no flash access
+    if (RtcStateStore::restore(dataManager, millis(), sleptMs)) {
+        Serial.printf("[INFO] Restored %u backlog windows and %u display points from RTC\n",
+                      RtcStateStore::getDataCount(), RtcStateStore::getDisplayCount());
+    } else if (stateManager.hasPersistedState()) {
+        // No RTC image (power loss): fall back to the NVS copy
+        Serial.println("Found persisted state in NVS, restoring...");
+
+        // Restored directly into DataManager's rings
+        BootProfiler::start(BOOT_PHASE_NVS, millis());
+        bool stateRestored = stateManager.restoreState(dataManager, millis());
+        BootProfiler::finish(BOOT_PHASE_NVS, millis());
+        if (stateRestored) {
+            Serial.print("Restored ");
+            Serial.print(dataManager.getBufferedDataCount());
+            Serial.print(" data buffer entries and ");
+            Serial.print(dataManager.getDisplayDataCount(SensorType::BME280_TEMP));
+            Serial.println(" display buffer entries");
 
-    if (touchResult.detected) {
-        Serial.print("Touch controller detected: ");
-        switch (touchResult.type) {
-            case TouchControllerType::XPT2046:
-                Serial.println("XPT2046 (SPI resistive)");
-                break;
-            case TouchControllerType::FT6236:
-                Serial.println("FT6236 (I2C capacitive)");
-                break;
-            case TouchControllerType::CST816:
-                Serial.println("CST816 (I2C capacitive)");
-                break;
-            case TouchControllerType::GT911:
-                Serial.println("GT911 (I2C capacitive)");
-                break;
-            default:
-                Serial.println("Unknown");
-                break;
+            // The next checkpoint rewrites it; a stale copy must not replay later
+            stateManager.clearPersistedState();
+        } else {
+            Serial.println("Failed to restore persisted state");
         }
-        Serial.print("Detection time: ");
-        Serial.print(touchResult.detectionTimeMs);
-        Serial.println(" ms");
-        ErrorLogger::info(ErrorType::SYSTEM, "Touch controller detected", "setup");
+    }
+
+    // Spill windows evicted from the full RAM ring to the flash outbound queue
+    Serial.println("Initializing outbound queue...");
+    if (outboundQueue.begin()) {
+        dataManager.setOverflowSink(OutboundQueue::spill, &outboundQueue);
     } else {
-        Serial.println("No touch controller detected");
-        Serial.print("Detection time: ");
-        Serial.print(touchResult.detectionTimeMs);
-        Serial.println(" ms");
-        ErrorLogger::info(ErrorType::SYSTEM, "No touch controller detected", "setup");
+        ErrorLogger::warning(ErrorType::SYSTEM, "Outbound queue unavailable", "setup");
     }
+    systemStatusManager.setOutboundQueueStats(outboundQueue.getStats());
 
-    // Pass touch detection result to ConfigManager
-    configManager.setTouchDetected(touchResult.detected, touchResult.type);
+    Serial.println("DataManager initialized");
+    esp_task_wdt_reset();  // Feed watchdog
 
-    // Pass touch detection result to DisplayManager
-    if (displayManager.isInitialized()) {
-        displayManager.setTouchEnabled(touchResult.detected, touchResult.type);
-        if (touchResult.detected) {
-            Serial.println("Touch-based config page enabled");
+    // Initialize NetworkManager and start the WiFi connection early: association runs in
+    // the background while the sensors and the display come up
+    Serial.println("Initializing NetworkManager...");
+    networkManager.initialize();
+    networkManager.setDeviceIdentity(HardwareId::getHardwareId(), g_bootId, FIRMWARE_VERSION);
+    // No exchange of its own at boot: registration goes out with the first upload
+    if (!registrationManager.isRegistered()) {
+        registrationManager.registerWithNextUpload(HardwareId::getHardwareId(), g_bootId,
+                                                   config.deviceId, FIRMWARE_VERSION);
+    }
+    esp_task_wdt_reset();  // Feed watchdog before WiFi connection attempt
+
+    // Association continues in the background; checkConnection() in the network task
+    // picks up the result and runs the NTP sync once an IP is assigned. A battery wake leaves the
+    // radio off until the radio policy rejoins ahead of the next upload.
+    uint8_t bootBattery = config.batteryMode ? powerManager.getBatteryPercentage() : 100;
+    if (config.batteryMode && radioModeFor(RadioMode::OFF, msUntilUplink(), bootBattery,
+                                           true) == RadioMode::OFF) {
+        networkManager.setRadioMode(RadioMode::OFF);
+        Serial.println("WiFi deferred until the next uplink");
+    } else {
+        // Finished in loop() once an IP is assigned
+        BootProfiler::start(BOOT_PHASE_WIFI, millis());
+        if (networkManager.connectWiFi()) {
+            Serial.println("WiFi connecting in the background");
         } else {
-            Serial.println("Touch-based config page disabled (no touch controller)");
+            Serial.println("WiFi not configured");
+            Serial.println("Continuing in offline mode...");
+            ErrorLogger::warning(ErrorType::NETWORK, "Initial WiFi connection failed", "setup");
         }
     }
+    Serial.println("NetworkManager initialized");
 
-    Serial.println("Touch detection complete");
+    // From here on uploads and the WiFi state machine run on PRO_CPU with the WiFi stack
+    if (!networkTask.start()) {
+        ErrorLogger::error(ErrorType::SYSTEM, "Failed to start network task", "setup");
+    }
     esp_task_wdt_reset();  // Feed watchdog
 
-    // Initialize SensorManager with calibration from config
+    // Configure SensorManager from config; the acquisition task initializes it, so
+    // probing and init retries run while the display comes up and WiFi associates
     Serial.println("Initializing SensorManager...");
-    sensorManager.initialize();
-    Config& config = configManager.getConfig();
+    sensorManager.setBme280Profile(static_cast<Bme280Profile>(config.bme280Profile));
+    sensorManager.setDS18B20Resolution(config.ds18b20Resolution);
     sensorManager.calibrateSoilMoisture(config.soilDryAdc, config.soilWetAdc);
+    sensorManager.setSoilSampleWindow(config.soilSampleWindow);
+    if (sleepSoilTaken) {
+        RunningStats soilStats;
+        sensorManager.convertSoilAggregate(sleepSoil, soilStats);
+        dataManager.addSoilSamples(soilStats, millis());
+        Serial.printf("[INFO] SoilUlp: %u readings while asleep%s\n", sleepSoil.count,
+                      sleepSoil.thresholdWake ? " (threshold crossing)" : "");
+    }
+    sensorManager.setSampleDivisors(
+        SensorManager::intervalToDivisor(config.bme280IntervalMs, config.readingIntervalMs),
+        SensorManager::intervalToDivisor(config.ds18b20IntervalMs, config.readingIntervalMs),
+        SensorManager::intervalToDivisor(config.soilIntervalMs, config.readingIntervalMs));
+
+    // Start fixed-rate sensor acquisition (runs independently of loop())
+    Serial.println("Starting acquisition task...");
+    if (!acquisitionTask.start(config.readingIntervalMs, sleepWake)) {
+        ErrorLogger::error(ErrorType::SYSTEM, "Failed to start acquisition task", "setup");
+    }
+
+    // Bring up the display while the sensors initialize. A battery node waking from deep
+    // sleep only glances: one summary frame from the restored state, no splash
+    Serial.println("Initializing DisplayManager...");
+    BootProfiler::start(BOOT_PHASE_DISPLAY, millis());
+    if (displayManager.initialize(glanceWake)) {
+        Serial.println("DisplayManager initialized");
+        displayManager.setMaxFps(config.displayMaxFps);
+        if (!glanceWake) {
+            displayManager.showStartupScreen(FIRMWARE_VERSION);
+            delay(2000);  // Show startup screen for 2 seconds
+        }
+    } else {
+        Serial.println("WARNING: DisplayManager initialization failed");
+        Serial.println("Continuing without display...");
+        ErrorLogger::warning(ErrorType::DISPLAY, "Display initialization failed", "setup");
+    }
+    if (glanceWake && displayManager.isInitialized()) {
+        displayManager.showGlance(dataManager, powerManager.getBatteryPercentage());
+    }
+    BootProfiler::finish(BOOT_PHASE_DISPLAY, millis());
+    esp_task_wdt_reset();  // Feed watchdog
+
+    // Sensor init overlapped the display bring-up; its result gates the error checks
+    if (acquisitionTask.waitForSensors(SENSOR_INIT_TIMEOUT_MS)) {
+        BootProfiler::record(BOOT_PHASE_SENSORS, acquisitionTask.getSensorInitMs());
+    } else {
+        ErrorLogger::error(ErrorType::SENSOR, "Sensor initialization timed out", "setup");
+    }
+    esp_task_wdt_reset();  // Feed watchdog
 
     // Check if all sensors failed to initialize (critical error)
     if (!sensorManager.isSensorAvailable(SensorType::BME280_TEMP) &&
@@ -428,56 +1403,18 @@ void setup() {
         }
     }
 
-    // Initialize DataManager with publish interval from config
-    Serial.println("Initializing DataManager...");
-    dataManager.setPublishIntervalSamples(config.publishIntervalSamples);
-
-    // Check for persisted state from deep sleep
-    if (stateManager.hasPersistedState()) {
-        Serial.println("Found persisted state from deep sleep, restoring...");
-
-        // Restore data buffer
-        uint16_t dataBufferCount = 0;
-        uint16_t displayBufferCount = 0;
-        AveragedData tempDataBuffer[50];
-        DisplayPoint tempDisplayBuffer[240];
-
-        if (stateManager.restoreState(tempDataBuffer, dataBufferCount, tempDisplayBuffer,
-                                      displayBufferCount)) {
-            Serial.print("Restored ");
-            Serial.print(dataBufferCount);
-            Serial.print(" data buffer entries and ");
-            Serial.print(displayBufferCount);
-            Serial.println(" display buffer entries");
+    // Touch navigation is set up after the first sample; a glance wake has none
+    touchDetectionPending = displayManager.isInitialized() && !glanceWake;
 
-            // TODO: Add methods to DataManager to restore buffers
-            // For now, just clear the persisted state
-            stateManager.clearPersistedState();
-        } else {
-            Serial.println("Failed to restore persisted state");
+    // Rendering runs off the sensing path; a glance wake keeps its single frame
+    if (displayManager.isInitialized() && !glanceWake) {
+        if (!displayTask.start(&config)) {
+            ErrorLogger::error(ErrorType::SYSTEM, "Failed to start display task", "setup");
         }
     }
 
-    Serial.println("DataManager initialized");
-    esp_task_wdt_reset();  // Feed watchdog
-
-    // Initialize NetworkManager and attempt WiFi connection
-    Serial.println("Initializing NetworkManager...");
-    networkManager.initialize();
-    esp_task_wdt_reset();  // Feed watchdog before WiFi connection attempt
-
-    if (networkManager.connectWiFi()) {
-        Serial.println("WiFi connected successfully");
-        systemStatusManager.setWiFiRSSI(WiFi.RSSI());
-        // Attempt NTP sync when WiFi connects
-        timeManager.onWiFiConnected();
-    } else {
-        Serial.println("WiFi connection failed, will retry later");
-        Serial.println("Continuing in offline mode...");
-        ErrorLogger::warning(ErrorType::NETWORK, "Initial WiFi connection failed", "setup");
-    }
-    Serial.println("NetworkManager initialized");
-    esp_task_wdt_reset();  // Feed watchdog
+    BootProfiler::endSetup(millis());
+    systemStatusManager.setBootProfile(BootProfiler::current());
 
     Serial.println("\n=== Initialization Complete ===");
     Serial.print("Reading Interval: ");
@@ -489,39 +1426,90 @@ void setup() {
     Serial.println("Starting main loop...\n");
 }
 
+/**
+ * Register loop()'s periodic jobs; periods follow the power mode, and re-registering an
+ * unchanged period keeps its phase, so this runs every pass. Housekeeping is
+ * deferrable: between battery-mode readings it waits for the wake instead of ending the
+ * light sleep.
+ */
+void scheduleLoopJobs(unsigned long nowMs) {
+    bool lowPower = powerManager.isPowerManagementEnabled();
+    loopScheduler.setPeriodic(LOOP_JOB_STATUS, STATUS_UPDATE_INTERVAL_MS, nowMs, true);
+    loopScheduler.setPeriodic(LOOP_JOB_RADIO_POLICY, RADIO_CHECK_INTERVAL_MS, nowMs, true);
+    loopScheduler.setPeriodic(LOOP_JOB_WIFI_CHECK, WIFI_CHECK_INTERVAL, nowMs, true);
+    loopScheduler.setPeriodic(LOOP_JOB_DISPLAY,
+                              lowPower ? LOW_POWER_DISPLAY_TICK_MS : DISPLAY_TICK_MS, nowMs,
+                              true);
+    loopScheduler.setPeriodic(LOOP_JOB_CONSOLE, lowPower ? AUTO_SLEEP_LOOP_MS : CONSOLE_POLL_MS,
+                              nowMs, true);
+}
+
 void loop() {
     // Feed watchdog at start of loop
     esp_task_wdt_reset();
 
+    // The previous pass, its sleep included, goes into the phase histograms
+    LoopProfiler::endPass();
+    HeapTrace::endPass();
+    LoopProfiler::start(LOOP_PHASE_STATUS, micros());
+
     unsigned long currentTime = timeManager.monotonicMs();
     Config& config = configManager.getConfig();
+    scheduleLoopJobs(currentTime);
+
+    // Status update, energy accounting and the profiles that go into the health block
+    if (loopScheduler.isDue(LOOP_JOB_STATUS, currentTime)) {
+        systemStatusManager.update();
+        updateEnergyAccounting();
+        LoopPhaseSummary loopSummary[NUM_LOOP_PHASES];
+        LoopProfiler::summarize(loopSummary);
+        systemStatusManager.setLoopProfile(loopSummary);
+        if (TaskMonitor::sample(millis())) {
+            TaskStats taskStats[MAX_MONITORED_TASKS];
+            for (uint8_t i = 0; i < TaskMonitor::getCount(); i++) {
+                taskStats[i] = TaskMonitor::get(i);
+            }
+            systemStatusManager.setTaskStats(taskStats, TaskMonitor::getCount());
+        }
+    }
+    LoopProfiler::finish(LOOP_PHASE_STATUS, micros());
 
-    // Update system status every loop iteration
-    systemStatusManager.update();
+    // Reading interval from signal dynamics and the battery level
+    uint32_t effectiveReadingInterval = currentReadingIntervalMs();
 
-    // Get adaptive reading interval if in battery mode
-    uint32_t effectiveReadingInterval = config.readingIntervalMs;
-    if (powerManager.isPowerManagementEnabled()) {
-        effectiveReadingInterval =
-            powerManager.getAdaptiveReadingInterval(config.readingIntervalMs);
-    }
+    // Sensors are sampled by the acquisition task at the configured Reading_Interval
+    // (or adaptive interval); process every reading it has published since last pass
+    acquisitionTask.setPeriodMs(effectiveReadingInterval);
 
-    // Read sensors at configured Reading_Interval (or adaptive interval)
-    if (currentTime - lastSensorRead >= effectiveReadingInterval) {
-        lastSensorRead = currentTime;
+    SensorReadings readings;
+    while (acquisitionTask.receive(readings)) {
+        // A reading past the wall-clock end of the window opens the next one
+        uint64_t readingEpochMs = timeManager.epochAtMonotonicMs(readings.monotonicMs);
+        if (dataManager.closesAlignedWindow(readings.monotonicMs, readingEpochMs)) {
+            publishWindow();
+        }
 
-        // Read all sensors
-        SensorReadings readings = sensorManager.readSensors();
+        LoopProfiler::start(LOOP_PHASE_SENSORS, micros());
+        lastSensorRead = readings.monotonicMs;
 
         // Update system status with sensor read time
-        systemStatusManager.setLastSensorReadTime(currentTime);
+        systemStatusManager.setLastSensorReadTime(readings.monotonicMs);
         systemStatusManager.updateMinMax(readings);
+        systemStatusManager.recordSensorLatencies(readings);
+        adaptiveSampler.addReading(readings);
+        uint8_t soilEvents =
+            config.eventUplink ? eventDetector.addReading(readings) : SOIL_EVENT_NONE;
+        if (soilEvents != SOIL_EVENT_NONE) {
+            onSoilEvent(readings, soilEvents);
+        }
 
         // Add reading to averaging buffer
         dataManager.addReading(readings);
 
         // Add reading to display buffer (at fixed 1-minute intervals)
+        displayTask.lock();
         dataManager.addToDisplayBuffer(readings);
+        displayTask.unlock();
 
         // Print readings to serial console (verbose mode)
         Serial.println("=== Sensor Readings ===");
@@ -540,7 +1528,16 @@ void loop() {
         Serial.print("DS18B20 Temperature: ");
         if (readings.sensorStatus & (1 << 1)) {
             Serial.print(readings.ds18b20Temp, 2);
-            Serial.println(" °C");
+            Serial.print(" °C (age: ");
+            Serial.print(readings.ds18b20AgeMs);
+            Serial.println(" ms)");
+            for (uint8_t p = 1; p < readings.ds18b20ProbeCount; p++) {
+                Serial.print("  Probe ");
+                Serial.print(p);
+                Serial.print(": ");
+                Serial.print(readings.ds18b20Probes[p], 2);
+                Serial.println(" °C");
+            }
         } else {
             Serial.println("N/A");
         }
@@ -581,174 +1578,144 @@ void loop() {
         Serial.println(" bytes");
 
         Serial.println("=======================\n");
+        LoopProfiler::finish(LOOP_PHASE_SENSORS, micros());
 
-        // Check if we should publish (Publish_Interval samples reached)
+        // Check if we should publish (Publish_Interval samples reached, unaligned windows)
         if (dataManager.shouldPublish()) {
-            Serial.println("=== Publishing Averaged Data ===");
-
-            // Calculate averages
-            AveragedData avgData = dataManager.calculateAverages();
-
-            // Set timestamps using TimeManager
-            avgData.timeSynced = timeManager.timeSynced();
-            avgData.sampleStartEpochMs = timeManager.epochMsOrZero();
-            avgData.sampleEndEpochMs = timeManager.epochMsOrZero();
-            avgData.deviceBootEpochMs = timeManager.deviceBootEpochMs();
-            avgData.uptimeMs = timeManager.uptimeMs();
-
-            // Clear averaging buffer
-            dataManager.clearAveragingBuffer();
-
-            // Attempt to send data if WiFi is connected
-            if (networkManager.isConnected()) {
-                Serial.println("WiFi connected, attempting transmission...");
-
-                // Get all buffered data for batch transmission
-                uint16_t bufferedCount = 0;
-                const AveragedData* bufferedData = dataManager.getBufferedData(bufferedCount);
-
-                // Create vector with current data + buffered data
-                std::vector<AveragedData> dataToSend;
-                dataToSend.push_back(avgData);
-                for (uint16_t i = 0; i < bufferedCount; i++) {
-                    dataToSend.push_back(bufferedData[i]);
-                }
-
-                Serial.print("Sending ");
-                Serial.print(dataToSend.size());
-                Serial.println(" reading(s)...");
-
-                // Send data
-                if (networkManager.sendData(dataToSend)) {
-                    Serial.println("Transmission successful!");
-                    systemStatusManager.setLastTransmissionTime(currentTime);
-
-                    // Note: NetworkManager handles clearing acknowledged data from buffer
-
-                    // Check if deep sleep should be triggered after successful upload
-                    Config& config = configManager.getConfig();
-                    powerManager.checkAndTriggerDeepSleep(
-                        config.batteryMode,
-                        config.publishIntervalSamples * (config.readingIntervalMs / 1000));
-                } else {
-                    Serial.println("Transmission failed, buffering data...");
-                    dataManager.bufferForTransmission(avgData);
-                    systemStatusManager.incrementNetworkFailures();
-                }
-            } else {
-                Serial.println("WiFi not connected, buffering data...");
-                dataManager.bufferForTransmission(avgData);
-            }
+            publishWindow();
+        }
+    }
 
-            // Update queue depth in system status
-            systemStatusManager.setQueueDepth(dataManager.getBufferedDataCount());
+    // The next reading is due one interval after the last; once it is overdue (or before
+    // the first one) loop() stays awake and takes it as soon as it is queued
+    unsigned long readingDueMs = lastSensorRead + effectiveReadingInterval;
+    if (lastSensorRead == 0 || static_cast<long>(currentTime - readingDueMs) >= 0) {
+        readingDueMs = currentTime + READING_GRACE_MS;
+    }
+    loopScheduler.setDeadline(LOOP_JOB_SENSING, readingDueMs);
 
-            // Check for buffer overflow warning
-            if (dataManager.isBufferNearFull()) {
-                Serial.println("WARNING: Transmission buffer > 80% full!");
-            }
+    // Deferred boot work, once the first sample is in
+    if (touchDetectionPending && lastSensorRead != 0) {
+        touchDetectionPending = false;
+        BootProfiler::start(BOOT_PHASE_TOUCH, millis());
+        detectTouchController();
+    }
 
-            Serial.println("================================\n");
+    // The publish moment is known: DNS and the TLS handshake happen just before the
+    // closing reading, so the POST goes out as soon as the averages are ready
+    LoopProfiler::start(LOOP_PHASE_PUBLISH, micros());
+    bool windowClosesNext = dataManager.windowClosesAt(lastSensorRead + effectiveReadingInterval);
+    if (loopScheduler.isDue(LOOP_JOB_RADIO_POLICY, currentTime)) {
+        updateRadioPolicy(windowClosesNext);
+    }
+    if (windowClosesNext && !connectionPrewarmed) {
+        loopScheduler.setDeadline(LOOP_JOB_PUBLISH,
+                                  lastSensorRead + effectiveReadingInterval - PREWARM_LEAD_MS);
+        if (loopScheduler.isDue(LOOP_JOB_PUBLISH, timeManager.monotonicMs())) {
+            connectionPrewarmed = true;  // One try per window
+            networkTask.prewarmConnection();
         }
+    } else if (!networkTask.isUploadBusy()) {
+        loopScheduler.cancel(LOOP_JOB_PUBLISH);
+    }
+
+    // Upload steps and the WiFi state machine run in the network task (inline here if
+    // it is not running); a finished upload's result is handled on this side
+    networkTask.poll();
+    UploadResult uploadResult;
+    if (networkTask.takeResult(uploadResult)) {
+        onUploadComplete(uploadResult, nullptr);
     }
+    if (networkTask.isUploadBusy()) {
+        loopScheduler.setPeriodic(LOOP_JOB_PUBLISH,
+                                  networkTask.isRunning() ? UPLOAD_RESULT_POLL_MS : UPLOAD_POLL_MS,
+                                  timeManager.monotonicMs());
+    }
+    LoopProfiler::finish(LOOP_PHASE_PUBLISH, micros());
+
+    LoopProfiler::start(LOOP_PHASE_WIFI, micros());
 
-    // Check WiFi connection periodically
-    if (currentTime - lastWiFiCheck >= WIFI_CHECK_INTERVAL) {
-        lastWiFiCheck = currentTime;
+    // Startup phases that end after setup(): the first IP, then the first NTP sync
+    if (BootProfiler::isStarted(BOOT_PHASE_WIFI) && networkManager.isConnected()) {
+        BootProfiler::finish(BOOT_PHASE_WIFI, millis());
+        BootProfiler::start(BOOT_PHASE_NTP, millis());
+        systemStatusManager.setBootProfile(BootProfiler::current());
+    }
+    if (BootProfiler::isStarted(BOOT_PHASE_NTP) && timeManager.timeSynced()) {
+        BootProfiler::finish(BOOT_PHASE_NTP, millis());
+        systemStatusManager.setBootProfile(BootProfiler::current());
+    }
+    LoopProfiler::finish(LOOP_PHASE_WIFI, micros());
 
-        networkManager.checkConnection();
+    // An upload that came due while WiFi was down goes out once the link is back, a
+    // waiting alert first
+    LoopProfiler::start(LOOP_PHASE_PUBLISH, micros());
+    if (eventPending && networkManager.isConnected() && !networkTask.isUploadBusy()) {
+        startEventUpload();
+    }
+    if (uplinkWaiting && networkManager.isConnected() && !networkTask.isUploadBusy()) {
+        uplinkWaiting = false;
+        if (dataManager.getBufferedDataCount() > 0 || !outboundQueue.isEmpty()) {
+            drainPagesLeft = OUTBOUND_DRAIN_PAGES_PER_CYCLE;
+            startNextUpload();
+        }
+    }
+    LoopProfiler::finish(LOOP_PHASE_PUBLISH, micros());
 
+    // Refresh RSSI periodically
+    LoopProfiler::start(LOOP_PHASE_WIFI, micros());
+    if (loopScheduler.isDue(LOOP_JOB_WIFI_CHECK, currentTime)) {
         if (networkManager.isConnected()) {
             systemStatusManager.setWiFiRSSI(WiFi.RSSI());
         } else {
             systemStatusManager.setWiFiRSSI(-100);  // Disconnected indicator
         }
     }
-
-    // Update display in every loop iteration (only if initialized)
-    if (displayManager.isInitialized()) {
-        // Check if display should be disabled in battery mode
-        if (powerManager.isPowerManagementEnabled()) {
-            // Enable low power mode for display
-            if (!displayManager.isLowPowerMode()) {
-                displayManager.setLowPowerMode(true);
-                Serial.println("Display low power mode enabled");
-            }
-
-            // Optionally disable display completely if battery is very low
-            if (powerManager.isBatteryLow()) {
-                displayManager.disableDisplay();
-            }
-        }
-
-        SystemStatus status = systemStatusManager.getStatus();
-        SensorReadings currentReadings = sensorManager.readSensors();  // Get latest for display
-        displayManager.update(currentReadings, status);
-    }
-
-    // Handle serial configuration commands
-    configManager.handleSerialConfig();
-
-    // Handle diagnostic command
-    if (Serial.available()) {
-        String command = Serial.readStringUntil('\n');
-        command.trim();
-        if (command == "diag") {
-            printDiagnostics();
-        } else if (command == "battery") {
-            // Battery status command
-            if (powerManager.isPowerManagementEnabled()) {
-                Serial.println("\n=== Battery Status ===");
-                Serial.print("Voltage: ");
-                Serial.print(powerManager.readBatteryVoltage(), 2);
-                Serial.println(" V");
-                Serial.print("Percentage: ");
-                Serial.print(powerManager.getBatteryPercentage());
-                Serial.println(" %");
-                Serial.print("Status: ");
-                if (powerManager.isBatteryLow()) {
-                    Serial.println("LOW");
-                } else {
-                    Serial.println("OK");
-                }
-                Serial.print("Adaptive Interval: ");
-                Serial.print(powerManager.getAdaptiveReadingInterval(config.readingIntervalMs) /
-                             1000);
-                Serial.println(" seconds");
-                Serial.println("======================\n");
-            } else {
-                Serial.println("Battery mode not enabled");
-            }
-        }
+    LoopProfiler::finish(LOOP_PHASE_WIFI, micros());
+
+    // Hand the display task the latest state; it renders on its own schedule
+    LoopProfiler::start(LOOP_PHASE_DISPLAY, micros());
+    if (loopScheduler.isDue(LOOP_JOB_DISPLAY, currentTime) && displayTask.isRunning()) {
+        DisplayTask::Message message;
+        message.current = sensorManager.getLatestReadings();
+        message.status = systemStatusManager.getStatus();
+        message.lowPower = powerManager.isPowerManagementEnabled();
+        message.blank = message.lowPower && powerManager.isBatteryLow();
+        displayTask.publish(message);
     }
+    LoopProfiler::finish(LOOP_PHASE_DISPLAY, micros());
 
-    // Power management: enter light sleep between sensor readings if in battery mode
-    if (powerManager.isPowerManagementEnabled()) {
-        // Calculate time until next sensor reading
-        unsigned long timeSinceLastRead = currentTime - lastSensorRead;
-        uint32_t effectiveInterval =
-            powerManager.getAdaptiveReadingInterval(config.readingIntervalMs);
-
-        if (timeSinceLastRead < effectiveInterval) {
-            uint32_t sleepDuration = effectiveInterval - timeSinceLastRead;
-
-            // Only sleep if duration is significant (> 1 second)
-            if (sleepDuration > 1000) {
-                Serial.print("Entering light sleep for ");
-                Serial.print(sleepDuration / 1000);
-                Serial.println(" seconds...");
-
-                // Enter light sleep (maintains WiFi connection and RAM)
-                powerManager.enterLightSleep(sleepDuration);
-
-                // Update time after wakeup
-                currentTime = timeManager.monotonicMs();
-            }
+    // Console input (never waits for a partial line), then write a save once edits settle
+    LoopProfiler::start(LOOP_PHASE_SERIAL, micros());
+    if (loopScheduler.isDue(LOOP_JOB_CONSOLE, currentTime)) {
+        serialConsole.poll();
+        configManager.processPendingSave();
+    }
+    LoopProfiler::finish(LOOP_PHASE_SERIAL, micros());
+    LoopProfiler::start(LOOP_PHASE_SLEEP, micros());
+
+    // Sleep until the earliest job, waking early when a reading is queued. With
+    // automatic light sleep the idle task sleeps during the wait; in battery mode a wait
+    // long enough to pay off becomes a light sleep to the next job that cannot be deferred
+    unsigned long idleFromMs = timeManager.monotonicMs();
+    uint32_t idleMs = loopScheduler.msUntilNext(idleFromMs);
+    uint32_t sleepMs = loopScheduler.msUntilNext(idleFromMs, false);
+    if (powerManager.isPowerManagementEnabled() && !powerManager.isAutoLightSleepEnabled() &&
+        sleepMs > LIGHT_SLEEP_MIN_MS) {
+        Serial.print("Entering light sleep for ");
+        Serial.print(sleepMs / 1000);
+        Serial.println(" seconds...");
+
+        // Enter light sleep (maintains WiFi connection and RAM)
+        powerManager.enterLightSleep(sleepMs);
+    } else if (idleMs > 0) {
+        unsigned long waitStart = millis();
+        acquisitionTask.waitForReading(idleMs);
+        if (powerManager.isAutoLightSleepEnabled() && !networkTask.isUploadBusy()) {
+            powerManager.accountAutoSleep(millis() - waitStart);  // Less PowerLock hold time
         }
-    } else {
-        // Small delay to prevent tight loop when not in battery mode
-        delay(10);
     }
+    LoopProfiler::finish(LOOP_PHASE_SLEEP, micros());
 }
 
 #endif  // UNIT_TEST
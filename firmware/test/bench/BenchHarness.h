@@ -0,0 +1,77 @@
+#ifndef BENCH_HARNESS_H
+#define BENCH_HARNESS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <chrono>
+
+#include "CountingAllocator.h"
+
+/**
+ * Shared timing loop for the host benchmarks. Include it from the one source file of
+ * a bench suite: it brings in CountingAllocator.h, which replaces the global operator
+ * new/delete. Host timings rank alternatives on the same machine; they are not ESP32
+ * timings.
+ */
+
+#define BENCH_ROUNDS 200
+
+namespace bench {
+
+struct BenchResult {
+    double nsPerOp;
+    double allocationsPerOp;
+    double bytesPerOp;
+    size_t peakBytes;  // Worst heap growth during one timed round
+};
+
+/**
+ * Run prepare() untimed, then opsPerRound timed calls of op(i), BENCH_ROUNDS times,
+ * and print one [BENCH] line
+ * @param name Label in the report
+ * @param outputBytes Size of what op() produces, read after the last call (optional)
+ * @return Per-call means and the peak heap growth
+ */
+template <typename Prepare, typename Op>
+BenchResult run(const char* name, uint32_t opsPerRound, Prepare prepare, Op op,
+                const size_t* outputBytes = nullptr) {
+    using Clock = std::chrono::steady_clock;
+    uint64_t elapsedNs = 0;
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    size_t peak = 0;
+    for (uint32_t round = 0; round < BENCH_ROUNDS; round++) {
+        prepare();
+        HeapCounters before = heapCounters;
+        resetHeapPeak();
+        Clock::time_point start = Clock::now();
+        for (uint32_t i = 0; i < opsPerRound; i++) {
+            op(i);
+        }
+        Clock::time_point end = Clock::now();
+        elapsedNs += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        allocations += heapCounters.allocations - before.allocations;
+        bytes += heapCounters.bytes - before.bytes;
+        if (heapCounters.peakBytes - before.liveBytes > peak) {
+            peak = heapCounters.peakBytes - before.liveBytes;
+        }
+    }
+
+    double ops = static_cast<double>(BENCH_ROUNDS) * opsPerRound;
+    BenchResult result = {elapsedNs / ops, allocations / ops, bytes / ops, peak};
+    printf("[BENCH] %-34s %10.1f ns/op %7.2f allocs/op %9.1f B/op %7u B peak", name,
+           result.nsPerOp, result.allocationsPerOp, result.bytesPerOp,
+           static_cast<unsigned>(result.peakBytes));
+    if (outputBytes) {
+        printf(" %7u B out", static_cast<unsigned>(*outputBytes));
+    }
+    printf("\n");
+    return result;
+}
+
+}  // namespace bench
+
+#endif  // BENCH_HARNESS_H
@@ -0,0 +1,153 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "../BenchHarness.h"
+#include "DataManager.h"
+
+/**
+ * Host micro-benchmarks for the DataManager hot paths. Each one reports the mean
+ * time per call and the heap traffic per call, so a buffer-layout change can be
+ * compared against the previous numbers before it goes near a board:
+ *
+ *   pio test -e native_bench -v
+ */
+
+#define BENCH_DISPLAY_INTERVAL_MS 60000  // DataManager's 1-minute display tier
+
+namespace {
+
+// Heap-allocated: DataManager is tens of KB, too large for a comfortable stack frame
+DataManager* manager = nullptr;
+
+SensorReadings makeReading(uint32_t monotonicMs) {
+    SensorReadings reading = {};
+    reading.bme280Temp = 21.0f + (monotonicMs % 100) * 0.01f;
+    reading.ds18b20Temp = 19.5f;
+    reading.humidity = 48.0f;
+    reading.pressure = 1012.5f;
+    reading.soilMoisture = 37.0f;
+    reading.sensorStatus = 0x07;
+    reading.monotonicMs = monotonicMs;
+    reading.ds18b20Probes[0] = reading.ds18b20Temp;
+    reading.ds18b20ProbeCount = 1;
+    return reading;
+}
+
+// Fill the ring to its overflow threshold (it evicts at 90% rather than filling up)
+void fillTransmitBuffer() {
+    manager->acknowledgeThrough(manager->getNextSequence());
+    for (uint16_t i = 0; i < manager->getDataBufferCapacity(); i++) {
+        manager->bufferForTransmission(manager->calculateAverages());
+    }
+}
+
+}  // namespace
+
+// Bench: one reading folded into the running window statistics
+void bench_add_reading() {
+    manager->setPublishIntervalSamples(MAX_PUBLISH_SAMPLES);
+    uint32_t nowMs = 0;
+    bench::run(
+        "addReading", MAX_PUBLISH_SAMPLES, [] { manager->clearAveragingBuffer(); },
+        [&nowMs](uint32_t) { manager->addReading(makeReading(nowMs += 1000)); });
+    TEST_ASSERT_TRUE(manager->shouldPublish());
+}
+
+// Bench: closing a full window (means, spreads, batch ID)
+void bench_calculate_averages() {
+    manager->setPublishIntervalSamples(MAX_PUBLISH_SAMPLES);
+    manager->clearAveragingBuffer();
+    for (uint32_t i = 0; i < MAX_PUBLISH_SAMPLES; i++) {
+        manager->addReading(makeReading(i * 1000));
+    }
+    AveragedData average = {};
+    bench::run(
+        "calculateAverages", 100, [] {},
+        [&average](uint32_t) { average = manager->calculateAverages(); });
+    TEST_ASSERT_EQUAL_UINT16(MAX_PUBLISH_SAMPLES, average.sampleCount);
+}
+
+// Bench: packing closed windows into the transmit ring, from empty through the evictions
+void bench_buffer_for_transmission() {
+    AveragedData average = manager->calculateAverages();
+    bench::run(
+        "bufferForTransmission (evicting)", manager->getDataBufferCapacity(),
+        [] { manager->acknowledgeThrough(manager->getNextSequence()); },
+        [&average](uint32_t) { manager->bufferForTransmission(average); });
+    TEST_ASSERT_TRUE(manager->getBufferedDataCount() > 0);
+}
+
+// Bench: batch-ID acks of every window in a full ring, against one sequence ack
+void bench_clear_acknowledged_at_full_buffer() {
+    static char ids[MAX_DATA_BUFFER_SIZE][sizeof(AveragedData::batchId)];
+    static const char* idList[MAX_DATA_BUFFER_SIZE];
+    uint16_t count = 0;
+
+    bench::run(
+        "clearAcknowledgedData (full)", 1,
+        [&count] {
+            fillTransmitBuffer();
+            count = manager->getBufferedDataCount();
+            for (uint16_t i = 0; i < count; i++) {
+                AveragedData entry;
+                manager->getBufferedEntry(i, entry);
+                memcpy(ids[i], entry.batchId, sizeof(ids[i]));
+                idList[i] = ids[i];
+            }
+        },
+        [&count](uint32_t) { manager->clearAcknowledgedData(idList, count); });
+    TEST_ASSERT_EQUAL_UINT16(0, manager->getBufferedDataCount());
+
+    bench::run(
+        "acknowledgeThrough (full)", 1, [] { fillTransmitBuffer(); },
+        [](uint32_t) { manager->acknowledgeThrough(manager->getNextSequence()); });
+    TEST_ASSERT_EQUAL_UINT16(0, manager->getBufferedDataCount());
+}
+
+// Bench: a full 1-minute history downsampled for the graph, computed and cached
+void bench_get_display_data_downsampled() {
+    for (uint32_t i = 0; i < MAX_DISPLAY_POINTS; i++) {
+        manager->addToDisplayBuffer(makeReading(i * BENCH_DISPLAY_INTERVAL_MS));
+    }
+    uint16_t count = 0;
+
+    // Alternating point limits miss the per-sensor cache on every call
+    bench::run(
+        "getDisplayData (downsample)", 100, [] {},
+        [&count](uint32_t i) {
+            manager->getDisplayData(SensorType::BME280_TEMP, count,
+                                    MAX_GRAPH_POINTS - (i % 2));
+        });
+    TEST_ASSERT_TRUE(count > 0 && count <= MAX_GRAPH_POINTS);
+
+    bench::run(
+        "getDisplayData (cached)", 100, [] {},
+        [&count](uint32_t) {
+            manager->getDisplayData(SensorType::BME280_TEMP, count, MAX_GRAPH_POINTS);
+        });
+    TEST_ASSERT_TRUE(count > 0 && count <= MAX_GRAPH_POINTS);
+}
+
+void setUp(void) {
+    manager = new DataManager();
+}
+
+void tearDown(void) {
+    delete manager;
+    manager = nullptr;
+}
+
+int main(int argc, char** argv) {
+    printf("[BENCH] sizeof(DataManager) = %u bytes\n", static_cast<unsigned>(sizeof(DataManager)));
+
+    UNITY_BEGIN();
+
+    RUN_TEST(bench_add_reading);
+    RUN_TEST(bench_calculate_averages);
+    RUN_TEST(bench_buffer_for_transmission);
+    RUN_TEST(bench_clear_acknowledged_at_full_buffer);
+    RUN_TEST(bench_get_display_data_downsampled);
+
+    return UNITY_END();
+}
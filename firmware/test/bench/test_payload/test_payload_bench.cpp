@@ -0,0 +1,215 @@
+#include <unity.h>
+
+#include <stdio.h>
+
+#include <vector>
+
+#include "../BenchHarness.h"
+#include "DataManager.h"
+#include "GzipStream.h"
+#include "PayloadStream.h"
+#include "WString.h"
+
+/**
+ * Host benchmarks for the upload body encoders at 1, 10 and 50 readings: encode time,
+ * output size, heap allocations and peak heap per body.
+ *
+ *   pio test -e native_bench -v
+ *
+ * NetworkManager does not build on the host, so the two formatJsonPayload() variants
+ * are mirrored here line for line (collecting into String with the test/mocks String).
+ * That mock grows geometrically like std::string; the Arduino String reallocates on
+ * most appends, so the device sees at least as many allocations as reported here.
+ * The streaming cases are what an upload does: PayloadStream (or GzipStream on top)
+ * read into a socket-sized chunk that is then dropped.
+ */
+
+#define BENCH_SOCKET_CHUNK 1460  // One TCP segment, what HTTPClient copies per write
+
+namespace {
+
+const char* const DEVICE_ID = "bench-device-0001";
+const uint16_t ENTRY_COUNTS[] = {1, 10, 50};
+
+PackedAveragedData packedBacklog[50];
+AveragedData windows[50];
+SystemStatus status;
+
+// Encoders hold a scratch buffer each; keep them off the stack like the NetworkManager
+// members they stand in for
+PayloadStream* payload = nullptr;
+GzipStream* gzip = nullptr;
+
+AveragedData makeWindow(uint32_t index) {
+    AveragedData data = {};
+    data.avgBme280Temp = 22.5f + index * 0.01f;
+    data.avgDs18b20Temp = 19.75f;
+    data.avgHumidity = 45.25f;
+    data.avgPressure = 1013.2f;
+    data.avgSoilMoisture = 37.5f;
+    data.sensorStatus = 0x1F;
+    data.sampleStartUptimeMs = index * 60000;
+    data.sampleEndUptimeMs = data.sampleStartUptimeMs + 59000;
+    data.uptimeMs = data.sampleEndUptimeMs;
+    data.sampleCount = 60;
+    data.sequence = index + 1;
+    return data;
+}
+
+BufferedBatch backlogOf(uint16_t count) {
+    BufferedBatch backlog = {};
+    backlog.segments[0] = {packedBacklog, count};
+    return backlog;
+}
+
+// Mirror of NetworkManager::formatJsonPayload(const std::vector<AveragedData>&)
+String formatIntoString(const std::vector<AveragedData>& dataList) {
+    std::vector<char> scratch(PAYLOAD_SCRATCH_SIZE);
+    PayloadStream::formatHeader(scratch.data(), scratch.size(), DEVICE_ID);
+    String json = scratch.data();
+    for (size_t i = 0; i < dataList.size(); i++) {
+        if (i > 0)
+            json += ",";
+        PayloadStream::formatReading(scratch.data(), scratch.size(), dataList[i], DEVICE_ID);
+        json += scratch.data();
+    }
+    json += "]";
+    if (status.metricsDue) {
+        PayloadStream::formatMetrics(scratch.data(), scratch.size(), status);
+        json += scratch.data();
+    }
+    json += "}";
+    return json;
+}
+
+// Mirror of NetworkManager::formatJsonPayload(const BufferedBatch&, const AveragedData*)
+String streamIntoString(uint16_t count) {
+    payload->begin(backlogOf(count), nullptr, DEVICE_ID, status);
+    String json;
+    json.reserve(payload->contentLength());
+    char chunk[128];
+    size_t length;
+    while ((length = payload->readBytes(chunk, sizeof(chunk) - 1)) > 0) {
+        chunk[length] = '\0';
+        json += chunk;
+    }
+    return json;
+}
+
+// What an upload does: measure the body, then copy it out one segment at a time
+template <typename Source>
+size_t drain(Source& source) {
+    static char chunk[BENCH_SOCKET_CHUNK];
+    size_t total = 0;
+    size_t length;
+    while ((length = source.readBytes(chunk, sizeof(chunk))) > 0) {
+        total += length;
+    }
+    return total;
+}
+
+size_t streamBody(uint16_t count, PayloadFormat format) {
+    payload->begin(backlogOf(count), nullptr, DEVICE_ID, status, format);
+    size_t length = drain(*payload);
+    return length == payload->contentLength() ? length : 0;
+}
+
+size_t streamGzipBody(uint16_t count) {
+    payload->begin(backlogOf(count), nullptr, DEVICE_ID, status);
+    gzip->begin(*payload);
+    size_t length = drain(*gzip);
+    return length == gzip->contentLength() ? length : 0;
+}
+
+/**
+ * Time one encoder at every entry count
+ * @param label Encoder name in the report
+ * @param encode Called with the entry count, returns the body length (0 if it came out
+ *               shorter or longer than measured)
+ */
+template <typename Encode>
+void benchEncoder(const char* label, Encode encode) {
+    for (uint16_t count : ENTRY_COUNTS) {
+        size_t outputBytes = 0;
+        char name[48];
+        snprintf(name, sizeof(name), "%s x%u", label, count);
+        bench::run(
+            name, 10, [] {}, [&](uint32_t) { outputBytes = encode(count); }, &outputBytes);
+        TEST_ASSERT_TRUE(outputBytes > 0);
+    }
+}
+
+}  // namespace
+
+// Bench: String += collection, as formatJsonPayload(vector) builds test bodies
+void bench_string_concatenation() {
+    benchEncoder("String += (vector)", [](uint16_t count) {
+        std::vector<AveragedData> dataList(windows, windows + count);
+        return static_cast<size_t>(formatIntoString(dataList).length());
+    });
+}
+
+// Bench: PayloadStream read into a String reserved to contentLength()
+void bench_stream_into_string() {
+    benchEncoder("String reserve (stream)", [](uint16_t count) {
+        return static_cast<size_t>(streamIntoString(count).length());
+    });
+}
+
+// Bench: the upload path, one body per format straight to the socket
+void bench_stream_formats() {
+    benchEncoder("stream rows",
+                 [](uint16_t count) { return streamBody(count, PayloadFormat::ROWS); });
+    benchEncoder("stream columnar",
+                 [](uint16_t count) { return streamBody(count, PayloadFormat::COLUMNAR); });
+    benchEncoder("stream cbor",
+                 [](uint16_t count) { return streamBody(count, PayloadFormat::CBOR); });
+    benchEncoder("stream rows gzip", [](uint16_t count) { return streamGzipBody(count); });
+}
+
+// Bench: the health block alone, added to whichever body is sent while metrics are due
+void bench_health_block() {
+    static char scratch[PAYLOAD_SCRATCH_SIZE];
+    size_t length = 0;
+    bench::run(
+        "formatMetrics", 100, [] {},
+        [&length](uint32_t) {
+            length = PayloadStream::formatMetrics(scratch, sizeof(scratch), status);
+        },
+        &length);
+    TEST_ASSERT_TRUE(length > 0 && length < sizeof(scratch));
+}
+
+void setUp(void) {
+    for (uint16_t i = 0; i < 50; i++) {
+        windows[i] = makeWindow(i);
+        DataManager::packAveragedData(windows[i], packedBacklog[i]);
+    }
+    status = SystemStatus();
+    status.metricsDue = false;  // Readings alone; the health block is measured on its own
+    payload = new PayloadStream();
+    payload->setIdentity("AA:BB:CC:DD:EE:FF", "00000000-0000-4000-8000-000000000000", "1.0.0");
+    gzip = new GzipStream();
+}
+
+void tearDown(void) {
+    delete gzip;
+    gzip = nullptr;
+    delete payload;
+    payload = nullptr;
+}
+
+int main(int argc, char** argv) {
+    printf("[BENCH] sizeof(PayloadStream) = %u bytes, sizeof(GzipStream) = %u bytes\n",
+           static_cast<unsigned>(sizeof(PayloadStream)),
+           static_cast<unsigned>(sizeof(GzipStream)));
+
+    UNITY_BEGIN();
+
+    RUN_TEST(bench_string_concatenation);
+    RUN_TEST(bench_stream_into_string);
+    RUN_TEST(bench_stream_formats);
+    RUN_TEST(bench_health_block);
+
+    return UNITY_END();
+}
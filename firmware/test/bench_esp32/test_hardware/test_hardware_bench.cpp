@@ -0,0 +1,256 @@
+#include <Arduino.h>
+#include <unity.h>
+
+#include <stdlib.h>
+
+#include "ConfigManager.h"
+#include "DataManager.h"
+#include "DisplayManager.h"
+#include "NetworkManager.h"
+#include "SensorManager.h"
+#include "SystemStatusManager.h"
+#include "TimeManager.h"
+#if __has_include("Version.h")
+#include "Version.h"
+#endif
+
+#ifndef FIRMWARE_VERSION
+#define FIRMWARE_VERSION "dev"
+#endif
+#ifndef BUILD_NUMBER
+#define BUILD_NUMBER 0
+#endif
+
+/**
+ * On-target timing of what the host benchmarks cannot see: sensor bus transactions,
+ * full-page TFT renders and HTTPS uploads. Needs the board wired as for the integration
+ * tests and, for the upload case, WiFi and the endpoint provisioned in NVS:
+ *
+ *   pio test -e esp32bench -v
+ *
+ * Every figure is one JSON object on its own line, so a build-to-build tracker can grep
+ * the serial log for lines starting with {"bench": and ignore the Unity output around
+ * them:
+ *
+ *   {"bench":"sensor.bme280","fw":"1.4.2","build":57,"n":20,"min_us":...,
+ *    "median_us":...,"mean_us":...,"max_us":...}
+ *
+ * The upload case posts the same window every time, so the server stores it once and
+ * acknowledges the rest as duplicates.
+ */
+
+#define BENCH_SENSOR_SAMPLES 20
+#define BENCH_SENSOR_PERIOD_MS 1000  // Lets each DS18B20 conversion finish between reads
+#define BENCH_RENDER_SAMPLES 10      // Full-page renders per page
+#define BENCH_UPLOAD_SAMPLES 5       // Cold and kept-alive uploads each
+#define BENCH_WIFI_TIMEOUT_MS 20000
+#define BENCH_MAX_SAMPLES 20
+#define BENCH_DISPLAY_INTERVAL_MS 60000  // DataManager's 1-minute display tier
+
+ConfigManager configManager;
+TimeManager timeManager;
+SystemStatusManager statusManager;
+SensorManager sensorManager;
+DisplayManager displayManager;
+NetworkManager networkManager(configManager, timeManager, statusManager);
+DataManager* dataManager = nullptr;  // Tens of KB: allocated once in setup()
+
+static int compareSamples(const void* a, const void* b) {
+    uint32_t left = *static_cast<const uint32_t*>(a);
+    uint32_t right = *static_cast<const uint32_t*>(b);
+    return left < right ? -1 : (left > right ? 1 : 0);
+}
+
+/**
+ * Print one result line (sorts the samples)
+ * @param name Dotted metric name, e.g. "render.summary"
+ * @param samples Durations in microseconds
+ * @param count Samples taken (0 prints nothing)
+ */
+static void report(const char* name, uint32_t* samples, uint8_t count) {
+    if (count == 0) {
+        return;
+    }
+    qsort(samples, count, sizeof(samples[0]), compareSamples);
+    uint64_t sum = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        sum += samples[i];
+    }
+    Serial.printf(
+        "{\"bench\":\"%s\",\"fw\":\"%s\",\"build\":%d,\"n\":%u,\"min_us\":%lu,"
+        "\"median_us\":%lu,\"mean_us\":%lu,\"max_us\":%lu}\n",
+        name, FIRMWARE_VERSION, BUILD_NUMBER, count, static_cast<unsigned long>(samples[0]),
+        static_cast<unsigned long>(samples[count / 2]),
+        static_cast<unsigned long>(sum / count), static_cast<unsigned long>(samples[count - 1]));
+}
+
+static const char* pageKey(DisplayPage page) {
+    switch (page) {
+        case DisplayPage::SUMMARY:
+            return "render.summary";
+        case DisplayPage::GRAPH_BME280_TEMP:
+            return "render.graph_bme280_temp";
+        case DisplayPage::GRAPH_DS18B20_TEMP:
+            return "render.graph_ds18b20_temp";
+        case DisplayPage::GRAPH_HUMIDITY:
+            return "render.graph_humidity";
+        case DisplayPage::GRAPH_PRESSURE:
+            return "render.graph_pressure";
+        case DisplayPage::GRAPH_SOIL_MOISTURE:
+            return "render.graph_soil_moisture";
+        case DisplayPage::SYSTEM_HEALTH:
+            return "render.system_health";
+    }
+    return "render.unknown";
+}
+
+static constexpr uint8_t NUM_DISPLAY_PAGES = 7;
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+// Bench: readSensors() as a whole and each bus transaction inside it
+void bench_read_sensors() {
+    sensorManager.setSampleDivisors(1, 1, 1);
+    uint32_t total[BENCH_MAX_SAMPLES];
+    uint32_t perBus[NUM_SENSOR_BUSES][BENCH_MAX_SAMPLES];
+    uint8_t busCount[NUM_SENSOR_BUSES] = {};
+
+    for (uint8_t i = 0; i < BENCH_SENSOR_SAMPLES; i++) {
+        unsigned long waitStart = millis();
+        while (millis() - waitStart < BENCH_SENSOR_PERIOD_MS) {
+            sensorManager.update();  // Collects the DS18B20 conversion when it is done
+            delay(10);
+        }
+
+        uint32_t startUs = micros();
+        SensorReadings readings = sensorManager.readSensors();
+        total[i] = micros() - startUs;
+        for (uint8_t bus = 0; bus < NUM_SENSOR_BUSES; bus++) {
+            if (readings.readLatencyUs[bus] > 0) {
+                perBus[bus][busCount[bus]++] = readings.readLatencyUs[bus];
+            }
+        }
+        dataManager->addReading(readings);
+    }
+
+    report("sensor.read_all", total, BENCH_SENSOR_SAMPLES);
+    report("sensor.bme280", perBus[SENSOR_BME280_BIT], busCount[SENSOR_BME280_BIT]);
+    report("sensor.ds18b20", perBus[SENSOR_DS18B20_BIT], busCount[SENSOR_DS18B20_BIT]);
+    report("sensor.soil", perBus[SENSOR_SOIL_BIT], busCount[SENSOR_SOIL_BIT]);
+    TEST_ASSERT_TRUE(busCount[SENSOR_BME280_BIT] + busCount[SENSOR_DS18B20_BIT] +
+                         busCount[SENSOR_SOIL_BIT] >
+                     0);
+}
+
+// Bench: one full-page render (layout and every widget) per DisplayPage
+void bench_render_pages() {
+    TEST_ASSERT_TRUE_MESSAGE(displayManager.isInitialized(), "Display did not initialize");
+    displayManager.setDebugMode(true);  // Puts SYSTEM_HEALTH in the page cycle
+    SensorReadings current = sensorManager.getLatestReadings();
+    SystemStatus status = statusManager.getStatus();
+
+    // A full 1-minute history around the live values, so graphs plot every point
+    for (uint16_t i = 0; i < MAX_DISPLAY_POINTS; i++) {
+        SensorReadings point = current;
+        float wave = (i % 40) < 20 ? (i % 20) * 0.05f : (20 - i % 20) * 0.05f;
+        point.bme280Temp += wave;
+        point.ds18b20Temp -= wave;
+        point.humidity += wave * 4;
+        point.pressure += wave;
+        point.soilMoisture += wave * 2;
+        point.monotonicMs = current.monotonicMs + (i + 1) * BENCH_DISPLAY_INTERVAL_MS;
+        dataManager->addToDisplayBuffer(point);
+    }
+
+    uint32_t samples[NUM_DISPLAY_PAGES][BENCH_MAX_SAMPLES];
+    uint8_t counts[NUM_DISPLAY_PAGES] = {};
+    for (uint16_t frame = 0; frame < NUM_DISPLAY_PAGES * BENCH_RENDER_SAMPLES; frame++) {
+        displayManager.cyclePage();  // Marks the page dirty: the next frame draws it all
+        uint8_t page = static_cast<uint8_t>(displayManager.getCurrentPage());
+
+        // The frame-rate cap may hold the first calls back; time the one that draws
+        uint32_t framesBefore = displayManager.getFramesRendered();
+        uint32_t elapsedUs = 0;
+        unsigned long waitStart = millis();
+        while (displayManager.getFramesRendered() == framesBefore &&
+               millis() - waitStart < 1000) {
+            uint32_t startUs = micros();
+            displayManager.update(current, status, dataManager);
+            elapsedUs = micros() - startUs;
+        }
+        if (displayManager.getFramesRendered() != framesBefore &&
+            counts[page] < BENCH_MAX_SAMPLES) {
+            samples[page][counts[page]++] = elapsedUs;
+        }
+    }
+
+    for (uint8_t page = 0; page < NUM_DISPLAY_PAGES; page++) {
+        report(pageKey(static_cast<DisplayPage>(page)), samples[page], counts[page]);
+    }
+    TEST_ASSERT_TRUE(counts[static_cast<uint8_t>(DisplayPage::SUMMARY)] > 0);
+}
+
+// Bench: blocking upload of one window on a fresh connection and on a kept-alive one
+void bench_upload_latency() {
+    networkManager.connectWiFi();
+    unsigned long waitStart = millis();
+    while (!networkManager.isConnected() && millis() - waitStart < BENCH_WIFI_TIMEOUT_MS) {
+        networkManager.checkConnection();
+        delay(50);
+    }
+    if (!networkManager.isConnected()) {
+        TEST_IGNORE_MESSAGE("WiFi not provisioned or out of range; upload bench skipped");
+        return;
+    }
+    timeManager.onWiFiConnected();
+
+    AveragedData window = dataManager->calculateAverages();
+    BufferedBatch noBacklog = {};
+    uint32_t cold[BENCH_UPLOAD_SAMPLES];
+    uint32_t warm[BENCH_UPLOAD_SAMPLES];
+    uint8_t coldCount = 0;
+    uint8_t warmCount = 0;
+    for (uint8_t i = 0; i < BENCH_UPLOAD_SAMPLES; i++) {
+        networkManager.closeConnection();
+        uint32_t startUs = micros();
+        if (networkManager.sendData(noBacklog, &window)) {
+            cold[coldCount++] = micros() - startUs;
+        }
+
+        startUs = micros();
+        if (networkManager.sendData(noBacklog, &window)) {
+            warm[warmCount++] = micros() - startUs;
+        }
+    }
+
+    bool https = configManager.getConfig().apiEndpoint.startsWith("https");
+    report(https ? "upload.https_cold" : "upload.http_cold", cold, coldCount);
+    report(https ? "upload.https_keepalive" : "upload.http_keepalive", warm, warmCount);
+    TEST_ASSERT_TRUE_MESSAGE(coldCount > 0 && warmCount > 0, "No upload succeeded");
+}
+
+void setup() {
+    delay(2000);  // Wait for serial monitor
+
+    configManager.initialize();
+    timeManager.initialize();
+    statusManager.initialize();
+    sensorManager.initialize();
+    displayManager.initialize();
+    networkManager.initialize();
+    dataManager = new DataManager();
+
+    UNITY_BEGIN();
+
+    RUN_TEST(bench_read_sensors);
+    RUN_TEST(bench_render_pages);
+    RUN_TEST(bench_upload_latency);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Nothing to do here
+}
@@ -0,0 +1,80 @@
+#ifndef COUNTING_ALLOCATOR_H
+#define COUNTING_ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include <new>
+
+/**
+ * Counting replacement for the global operator new/delete, shared by the host
+ * benchmarks and the allocation-budget tests. Include it from exactly one source file
+ * of a test program.
+ *
+ * Every allocation carries a small header with its size, so besides the number of
+ * calls and bytes requested the counters know the live heap bytes and their peak.
+ * Only operator new is seen: String, std::vector and new-expressions, not a direct
+ * malloc() such as DataManager's one-off buffer allocation.
+ */
+
+struct HeapCounters {
+    uint64_t allocations;  // operator new calls
+    uint64_t bytes;        // Bytes requested by those calls
+    size_t liveBytes;      // Requested and not yet freed
+    size_t peakBytes;      // Highest liveBytes since the last resetHeapPeak()
+};
+
+inline HeapCounters heapCounters = {};
+
+inline void resetHeapPeak() {
+    heapCounters.peakBytes = heapCounters.liveBytes;
+}
+
+// Size header in front of every block, padded to keep the block maximally aligned
+static constexpr size_t COUNTING_BLOCK_HEADER = alignof(max_align_t);
+
+// Out of line, so the compiler cannot pair a new-expression with the free() inside
+#define COUNTING_ALLOCATOR __attribute__((noinline))
+
+COUNTING_ALLOCATOR void* operator new(size_t size) {
+    uint8_t* block = static_cast<uint8_t*>(malloc(COUNTING_BLOCK_HEADER + size));
+    if (!block) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<size_t*>(block) = size;
+    heapCounters.allocations++;
+    heapCounters.bytes += size;
+    heapCounters.liveBytes += size;
+    if (heapCounters.liveBytes > heapCounters.peakBytes) {
+        heapCounters.peakBytes = heapCounters.liveBytes;
+    }
+    return block + COUNTING_BLOCK_HEADER;
+}
+
+COUNTING_ALLOCATOR void operator delete(void* pointer) noexcept {
+    if (!pointer) {
+        return;
+    }
+    uint8_t* block = static_cast<uint8_t*>(pointer) - COUNTING_BLOCK_HEADER;
+    heapCounters.liveBytes -= *reinterpret_cast<size_t*>(block);
+    free(block);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete[](void* pointer) noexcept {
+    operator delete(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+#endif  // COUNTING_ALLOCATOR_H
@@ -57,6 +57,10 @@ class String {
 
     // String methods
     unsigned int length() const { return static_cast<unsigned int>(str.length()); }
+    unsigned char reserve(unsigned int size) {
+        str.reserve(size);
+        return 1;
+    }
     void clear() { str.clear(); }
     bool isEmpty() const { return str.empty(); }
 
@@ -0,0 +1,80 @@
+#include <unity.h>
+
+#include "AdaptiveSampler.h"
+
+static SensorReadings makeReading(uint32_t timeMs, float soil, float temp) {
+    SensorReadings readings = {};
+    readings.monotonicMs = timeMs;
+    readings.soilMoisture = soil;
+    readings.bme280Temp = temp;
+    readings.sensorStatus = (1 << SENSOR_SOIL_BIT) | (1 << SENSOR_BME280_BIT);
+    return readings;
+}
+
+// Test: a fast soil change drops to the event pace at once, within the battery speed-up
+void test_event_speeds_up() {
+    AdaptiveSampler sampler;
+    sampler.addReading(makeReading(0, 40.0f, 21.0f));
+    TEST_ASSERT_EQUAL_UINT32(60000, sampler.getIntervalMs(60000, BatteryLevel::NORMAL, true));
+
+    sampler.addReading(makeReading(60000, 45.0f, 21.0f));  // 5 %/min: irrigation
+    TEST_ASSERT_EQUAL_INT8(-1, sampler.getPaceStep());
+    TEST_ASSERT_EQUAL_UINT32(15000, sampler.getIntervalMs(60000, BatteryLevel::NORMAL, true));
+    TEST_ASSERT_EQUAL_UINT32(30000, sampler.getIntervalMs(60000, BatteryLevel::LOW_CHARGE, true));
+    TEST_ASSERT_EQUAL_UINT32(60000, sampler.getIntervalMs(60000, BatteryLevel::CRITICAL, true));
+    TEST_ASSERT_EQUAL_UINT32(ADAPTIVE_MIN_INTERVAL_MS,
+                             sampler.getIntervalMs(4000, BatteryLevel::NORMAL, true));
+}
+
+// Test: flat signals step back to the base, then double it while allowed
+void test_flat_signals_slow_down() {
+    AdaptiveSampler sampler;
+    sampler.addReading(makeReading(0, 40.0f, 21.0f));
+    sampler.addReading(makeReading(10000, 40.0f, 22.0f));  // 6 C/min
+    TEST_ASSERT_EQUAL_INT8(-1, sampler.getPaceStep());
+
+    uint32_t t = 10000;
+    while (sampler.getPaceStep() < 0) {
+        t += 10000;
+        sampler.addReading(makeReading(t, 40.0f, 22.0f));
+    }
+    TEST_ASSERT_EQUAL_INT8(0, sampler.getPaceStep());
+
+    for (uint8_t i = 0; i < 2 * ADAPTIVE_QUIET_READINGS + 10; i++) {
+        t += 10000;
+        sampler.addReading(makeReading(t, 40.0f, 22.0f));
+    }
+    TEST_ASSERT_EQUAL_INT8(ADAPTIVE_MAX_SLOW_STEPS, sampler.getPaceStep());
+    TEST_ASSERT_EQUAL_UINT32(40000, sampler.getIntervalMs(10000, BatteryLevel::NORMAL, true));
+    TEST_ASSERT_EQUAL_UINT32(10000, sampler.getIntervalMs(10000, BatteryLevel::NORMAL, false));
+}
+
+// Test: stale and unavailable values never count as changes
+void test_stale_values_ignored() {
+    AdaptiveSampler sampler;
+    sampler.addReading(makeReading(0, 40.0f, 21.0f));
+
+    SensorReadings stale = makeReading(10000, 80.0f, 21.0f);
+    stale.staleMask = 1 << SENSOR_SOIL_BIT;
+    sampler.addReading(stale);
+    SensorReadings missing = makeReading(20000, 40.0f, 30.0f);
+    missing.sensorStatus = 1 << SENSOR_SOIL_BIT;
+    sampler.addReading(missing);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, sampler.getActivity());
+    TEST_ASSERT_TRUE(sampler.getPaceStep() >= 0);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_event_speeds_up);
+    RUN_TEST(test_flat_signals_slow_down);
+    RUN_TEST(test_stale_values_ignored);
+
+    return UNITY_END();
+}
@@ -0,0 +1,76 @@
+#include <unity.h>
+
+#include "BatteryMonitor.h"
+
+// Test: the first sample seeds the filter, later ones are low-pass filtered
+void test_filter_seeds_and_smooths() {
+    BatteryMonitor monitor;
+    TEST_ASSERT_FALSE(monitor.hasSample());
+
+    monitor.addSample(3.8f);
+    TEST_ASSERT_TRUE(monitor.hasSample());
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 3.8f, monitor.getVoltage());
+
+    monitor.addSample(3.3f);  // One noisy sample moves the estimate only by alpha
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 3.8f - 0.5f * BATTERY_FILTER_ALPHA, monitor.getVoltage());
+}
+
+// Test: levels drop at the thresholds and clear only with hysteresis
+void test_levels_have_hysteresis() {
+    BatteryMonitor monitor;
+    monitor.addSample(3.29f);
+    TEST_ASSERT_TRUE(monitor.getLevel() == BatteryLevel::LOW_CHARGE);
+
+    // Settle just above the threshold: still low
+    for (int i = 0; i < 50; i++) {
+        monitor.addSample(3.32f);
+    }
+    TEST_ASSERT_TRUE(monitor.getLevel() == BatteryLevel::LOW_CHARGE);
+
+    for (int i = 0; i < 50; i++) {
+        monitor.addSample(3.40f);
+    }
+    TEST_ASSERT_TRUE(monitor.getLevel() == BatteryLevel::NORMAL);
+
+    for (int i = 0; i < 50; i++) {
+        monitor.addSample(2.9f);
+    }
+    TEST_ASSERT_TRUE(monitor.getLevel() == BatteryLevel::CRITICAL);
+    for (int i = 0; i < 50; i++) {
+        monitor.addSample(3.02f);
+    }
+    TEST_ASSERT_TRUE(monitor.getLevel() == BatteryLevel::CRITICAL);
+    for (int i = 0; i < 50; i++) {
+        monitor.addSample(3.4f);
+    }
+    TEST_ASSERT_TRUE(monitor.getLevel() == BatteryLevel::NORMAL);
+}
+
+// Test: the charge estimate is linear between empty and full and clamped
+void test_percent_range() {
+    BatteryMonitor monitor;
+    monitor.addSample(4.3f);
+    TEST_ASSERT_EQUAL_UINT8(100, monitor.getPercent());
+
+    BatteryMonitor half;
+    half.addSample(3.6f);
+    TEST_ASSERT_EQUAL_UINT8(50, half.getPercent());
+
+    BatteryMonitor empty;
+    empty.addSample(2.8f);
+    TEST_ASSERT_EQUAL_UINT8(0, empty.getPercent());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_filter_seeds_and_smooths);
+    RUN_TEST(test_levels_have_hysteresis);
+    RUN_TEST(test_percent_range);
+
+    return UNITY_END();
+}
@@ -0,0 +1,99 @@
+#include <unity.h>
+
+#include "BootProfiler.h"
+
+// Test: a started and finished phase records its duration once
+void test_phase_duration_recorded_once() {
+    BootProfiler::beginBoot(0);
+
+    BootProfiler::start(BOOT_PHASE_SENSORS, 100);
+    TEST_ASSERT_TRUE(BootProfiler::isStarted(BOOT_PHASE_SENSORS));
+    TEST_ASSERT_FALSE(BootProfiler::isFinished(BOOT_PHASE_SENSORS));
+
+    TEST_ASSERT_TRUE(BootProfiler::finish(BOOT_PHASE_SENSORS, 350));
+    TEST_ASSERT_FALSE(BootProfiler::isStarted(BOOT_PHASE_SENSORS));
+    TEST_ASSERT_FALSE(BootProfiler::finish(BOOT_PHASE_SENSORS, 900));
+
+    const BootProfile& profile = BootProfiler::current();
+    TEST_ASSERT_EQUAL_UINT32(250, profile.phaseMs[BOOT_PHASE_SENSORS]);
+    TEST_ASSERT_TRUE(profile.doneMask & (1 << BOOT_PHASE_SENSORS));
+}
+
+// Test: a phase timed in several pieces adds them up
+void test_split_phase_accumulates() {
+    BootProfiler::beginBoot(0);
+
+    BootProfiler::start(BOOT_PHASE_NVS, 100);
+    BootProfiler::finish(BOOT_PHASE_NVS, 130);
+    BootProfiler::start(BOOT_PHASE_NVS, 500);
+    BootProfiler::finish(BOOT_PHASE_NVS, 545);
+
+    TEST_ASSERT_EQUAL_UINT32(75, BootProfiler::current().phaseMs[BOOT_PHASE_NVS]);
+
+    // Time measured by another task adds to the same phase
+    BootProfiler::record(BOOT_PHASE_NVS, 25);
+    TEST_ASSERT_EQUAL_UINT32(100, BootProfiler::current().phaseMs[BOOT_PHASE_NVS]);
+}
+
+// Test: a phase that never started is not recorded and stays out of the mask
+void test_skipped_phase_not_recorded() {
+    BootProfiler::beginBoot(0);
+
+    TEST_ASSERT_FALSE(BootProfiler::finish(BOOT_PHASE_TOUCH, 500));
+    TEST_ASSERT_FALSE(BootProfiler::isFinished(BOOT_PHASE_TOUCH));
+    TEST_ASSERT_EQUAL_UINT8(0, BootProfiler::current().doneMask);
+}
+
+// Test: phases may finish after setup() returns (WiFi, NTP)
+void test_late_phases_and_setup_time() {
+    BootProfiler::beginBoot(50);
+
+    BootProfiler::start(BOOT_PHASE_WIFI, 400);
+    BootProfiler::endSetup(1050);
+    TEST_ASSERT_TRUE(BootProfiler::finish(BOOT_PHASE_WIFI, 2400));
+    BootProfiler::start(BOOT_PHASE_NTP, 2400);
+    TEST_ASSERT_TRUE(BootProfiler::finish(BOOT_PHASE_NTP, 2700));
+
+    const BootProfile& profile = BootProfiler::current();
+    TEST_ASSERT_EQUAL_UINT32(1000, profile.setupMs);
+    TEST_ASSERT_EQUAL_UINT32(2000, profile.phaseMs[BOOT_PHASE_WIFI]);
+    TEST_ASSERT_EQUAL_UINT32(300, profile.phaseMs[BOOT_PHASE_NTP]);
+}
+
+// Test: the next boot keeps the last profile as previous() and starts clean
+void test_next_boot_keeps_previous() {
+    BootProfiler::beginBoot(0);
+    BootProfiler::start(BOOT_PHASE_DISPLAY, 10);
+    BootProfiler::finish(BOOT_PHASE_DISPLAY, 2110);
+
+    BootProfiler::beginBoot(0);
+    BootProfile last;
+    TEST_ASSERT_TRUE(BootProfiler::previous(last));
+    TEST_ASSERT_EQUAL_UINT32(2100, last.phaseMs[BOOT_PHASE_DISPLAY]);
+    TEST_ASSERT_FALSE(BootProfiler::isStarted(BOOT_PHASE_DISPLAY));
+    TEST_ASSERT_EQUAL_UINT32(0, BootProfiler::current().phaseMs[BOOT_PHASE_DISPLAY]);
+}
+
+// Test: payload keys per phase, and out-of-range phases
+void test_phase_keys() {
+    TEST_ASSERT_EQUAL_STRING("config_file", BootProfiler::phaseKey(BOOT_PHASE_CONFIG_FILE));
+    TEST_ASSERT_EQUAL_STRING("ntp", BootProfiler::phaseKey(BOOT_PHASE_NTP));
+    TEST_ASSERT_EQUAL_STRING("unknown", BootProfiler::phaseKey(NUM_BOOT_PHASES));
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_phase_duration_recorded_once);
+    RUN_TEST(test_split_phase_accumulates);
+    RUN_TEST(test_skipped_phase_not_recorded);
+    RUN_TEST(test_late_phases_and_setup_time);
+    RUN_TEST(test_next_boot_keeps_previous);
+    RUN_TEST(test_phase_keys);
+
+    return UNITY_END();
+}
@@ -0,0 +1,105 @@
+#include <unity.h>
+
+#include "ConfigSnapshot.h"
+
+// Test: endpoint parts, fallback URL and auth header derive once from the config
+void test_rebuild_derives_endpoint_fields() {
+    Config config = {};
+    config.apiEndpoint = "https://user@api.example.com:8443/v1/sensor-data";
+    config.apiToken = "secret";
+
+    ConfigSnapshot snapshot;
+    snapshot.rebuild(config, 7);
+
+    TEST_ASSERT_EQUAL_UINT32(7, snapshot.getVersion());
+    TEST_ASSERT_TRUE(snapshot.hasEndpoint());
+    TEST_ASSERT_TRUE(snapshot.isHttps());
+    TEST_ASSERT_EQUAL_STRING("api.example.com", snapshot.getHost().c_str());
+    TEST_ASSERT_EQUAL_UINT16(8443, snapshot.getPort(true));
+    TEST_ASSERT_EQUAL_STRING("/v1/sensor-data", snapshot.getPath().c_str());
+    TEST_ASSERT_EQUAL_STRING("http://user@api.example.com:8443/v1/sensor-data",
+                             snapshot.getInsecureEndpoint().c_str());
+    TEST_ASSERT_EQUAL_STRING("Bearer secret", snapshot.getAuthHeader().c_str());
+    TEST_ASSERT_EQUAL_STRING("https://user@api.example.com:8443/v1/register",
+                             snapshot.getRegistrationUrl().c_str());
+    TEST_ASSERT_EQUAL_STRING("secret", snapshot.getConfig().apiToken.c_str());
+}
+
+// Test: scheme default ports, a bare host, and no token or endpoint
+void test_defaults_and_missing_fields() {
+    Config config = {};
+    config.apiEndpoint = "http://192.168.1.10";
+
+    ConfigSnapshot snapshot;
+    snapshot.rebuild(config, 1);
+    TEST_ASSERT_FALSE(snapshot.isHttps());
+    TEST_ASSERT_EQUAL_UINT16(80, snapshot.getPort(false));
+    TEST_ASSERT_EQUAL_UINT16(443, snapshot.getPort(true));
+    TEST_ASSERT_EQUAL_STRING("/", snapshot.getPath().c_str());
+    TEST_ASSERT_EQUAL_STRING("", snapshot.getAuthHeader().c_str());
+
+    config.apiEndpoint = "";
+    snapshot.rebuild(config, 2);
+    TEST_ASSERT_FALSE(snapshot.hasEndpoint());
+
+    config.apiEndpoint = "http://host:99999/data";
+    snapshot.rebuild(config, 3);
+    TEST_ASSERT_FALSE(snapshot.hasEndpoint());
+}
+
+// Test: the registration URL matches NetworkManager's former string surgery
+void test_registration_url_derivation() {
+    TEST_ASSERT_EQUAL_STRING(
+        "https://api.example.com/v1/register",
+        ConfigSnapshot::deriveRegistrationUrl("https://api.example.com/v1/sensor-data/").c_str());
+    TEST_ASSERT_EQUAL_STRING(
+        "https://api.example.com/v1/register",
+        ConfigSnapshot::deriveRegistrationUrl("https://api.example.com/v1/data#f?x=y").c_str());
+    TEST_ASSERT_EQUAL_STRING(
+        "https://api.example.com/register",
+        ConfigSnapshot::deriveRegistrationUrl("https://api.example.com").c_str());
+    TEST_ASSERT_EQUAL_STRING(
+        "http://192.168.1.100:8080/api/v2/register",
+        ConfigSnapshot::deriveRegistrationUrl("http://192.168.1.100:8080/api/v2/data").c_str());
+}
+
+// Test: the MQTT broker and topic derive once, with the scheme default ports
+void test_mqtt_fields() {
+    Config config = {};
+    config.deviceId = "dev-1";
+    config.mqttUrl = "mqtts://user@broker.example.com/ignored";
+
+    ConfigSnapshot snapshot;
+    snapshot.rebuild(config, 1);
+    TEST_ASSERT_TRUE(snapshot.isMqttTls());
+    TEST_ASSERT_EQUAL_STRING("broker.example.com", snapshot.getMqttHost().c_str());
+    TEST_ASSERT_EQUAL_UINT16(8883, snapshot.getMqttPort());
+    TEST_ASSERT_EQUAL_STRING("sensors/dev-1/readings", snapshot.getMqttTopic().c_str());
+
+    config.mqttUrl = "mqtt://10.0.0.2:1884";
+    config.mqttTopic = "farm/bed-3";
+    snapshot.rebuild(config, 2);
+    TEST_ASSERT_FALSE(snapshot.isMqttTls());
+    TEST_ASSERT_EQUAL_STRING("10.0.0.2", snapshot.getMqttHost().c_str());
+    TEST_ASSERT_EQUAL_UINT16(1884, snapshot.getMqttPort());
+    TEST_ASSERT_EQUAL_STRING("farm/bed-3", snapshot.getMqttTopic().c_str());
+
+    config.mqttUrl = "mqtt://broker:0";
+    snapshot.rebuild(config, 3);
+    TEST_ASSERT_EQUAL_STRING("", snapshot.getMqttHost().c_str());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_rebuild_derives_endpoint_fields);
+    RUN_TEST(test_defaults_and_missing_fields);
+    RUN_TEST(test_registration_url_derivation);
+    RUN_TEST(test_mqtt_fields);
+
+    return UNITY_END();
+}
@@ -0,0 +1,67 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "Crc32.h"
+
+// Bit-at-a-time CRC-32, the definition the fast paths must match
+static uint32_t referenceCrc(const uint8_t* bytes, size_t length, uint32_t previous) {
+    uint32_t crc = previous ^ 0xFFFFFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+        }
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+// Test: the standard check value and the empty input
+void test_check_value() {
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, crc32Update("123456789", 9));
+    TEST_ASSERT_EQUAL_HEX32(0x00000000, crc32Update("", 0));
+    TEST_ASSERT_EQUAL_HEX32(0x12345678, crc32Update("", 0, 0x12345678));
+}
+
+// Test: every length and alignment around the 8-byte blocks matches, in one call or split
+void test_matches_reference_across_lengths_and_offsets() {
+    uint8_t data[80];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+
+    for (size_t offset = 0; offset < 8; offset++) {
+        for (size_t length = 0; length + offset <= sizeof(data); length++) {
+            uint32_t expected = referenceCrc(data + offset, length, 0);
+            TEST_ASSERT_EQUAL_HEX32(expected, crc32Update(data + offset, length));
+
+            size_t split = length / 3;
+            uint32_t running = crc32Update(data + offset, split);
+            running = crc32Update(data + offset + split, length - split, running);
+            TEST_ASSERT_EQUAL_HEX32(expected, running);
+        }
+    }
+}
+
+// Test: checksum text is 8 uppercase hex digits with leading zeros
+void test_hex_format() {
+    char hex[CRC32_HEX_LENGTH + 1];
+    crc32ToHex(0xCBF43926, hex);
+    TEST_ASSERT_EQUAL_STRING("CBF43926", hex);
+    crc32ToHex(0x0000ABCD, hex);
+    TEST_ASSERT_EQUAL_STRING("0000ABCD", hex);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_check_value);
+    RUN_TEST(test_matches_reference_across_lengths_and_offsets);
+    RUN_TEST(test_hex_format);
+
+    return UNITY_END();
+}
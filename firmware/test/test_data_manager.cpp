@@ -187,6 +187,172 @@ void test_buffer_does_not_overflow() {
     TEST_ASSERT_EQUAL_UINT16(5, dm.getCurrentSampleCount());
 }
 
+void test_calculate_averages_per_probe() {
+    DataManager dm;
+    dm.setPublishIntervalSamples(2);
+
+    SensorReadings r1 = createTestReading(20.0f, 1000);
+    r1.ds18b20ProbeCount = 3;
+    r1.ds18b20Probes[0] = 18.0f;
+    r1.ds18b20Probes[1] = 16.0f;
+    r1.ds18b20Probes[2] = 14.0f;
+
+    SensorReadings r2 = createTestReading(22.0f, 2000);
+    r2.ds18b20ProbeCount = 3;
+    r2.ds18b20Probes[0] = 20.0f;
+    r2.ds18b20Probes[1] = 18.0f;
+    r2.ds18b20Probes[2] = 16.0f;
+
+    dm.addReading(r1);
+    dm.addReading(r2);
+
+    AveragedData avg = dm.calculateAverages();
+
+    TEST_ASSERT_EQUAL_UINT8(3, avg.ds18b20ProbeCount);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 19.0f, avg.avgDs18b20Probes[0]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 17.0f, avg.avgDs18b20Probes[1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 15.0f, avg.avgDs18b20Probes[2]);
+}
+
+void test_calculate_averages_skips_stale_fields() {
+    DataManager dm;
+    dm.setPublishIntervalSamples(3);
+
+    // BME280 sampled only on the first reading, soil on every reading
+    SensorReadings r1 = createTestReading(20.0f, 1000);
+    r1.soilMoisture = 40.0f;
+    SensorReadings r2 = createTestReading(20.0f, 2000);
+    r2.soilMoisture = 50.0f;
+    r2.bme280Temp = 99.0f;  // Would skew the average if counted
+    r2.staleMask = (1 << SENSOR_BME280_BIT);
+    SensorReadings r3 = createTestReading(20.0f, 3000);
+    r3.soilMoisture = 60.0f;
+    r3.bme280Temp = 99.0f;
+    r3.staleMask = (1 << SENSOR_BME280_BIT);
+
+    dm.addReading(r1);
+    dm.addReading(r2);
+    dm.addReading(r3);
+
+    AveragedData avg = dm.calculateAverages();
+
+    TEST_ASSERT_EQUAL_UINT16(3, avg.sampleCount);
+    TEST_ASSERT_EQUAL_UINT16(1, avg.bme280SampleCount);
+    TEST_ASSERT_EQUAL_UINT16(3, avg.ds18b20SampleCount);
+    TEST_ASSERT_EQUAL_UINT16(3, avg.soilSampleCount);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, avg.avgBme280Temp);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 50.0f, avg.avgSoilMoisture);
+}
+
+void test_calculate_window_spread() {
+    DataManager dm;
+    dm.setPublishIntervalSamples(4);
+
+    // Temperatures 2, 4, 4, 6 -> min 2, max 6, population stddev sqrt(2)
+    dm.addReading(createTestReading(2.0f, 1000));
+    dm.addReading(createTestReading(4.0f, 2000));
+    dm.addReading(createTestReading(4.0f, 3000));
+    dm.addReading(createTestReading(6.0f, 4000));
+
+    AveragedData avg = dm.calculateAverages();
+
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 2.0f, avg.bme280TempSpread.min);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 6.0f, avg.bme280TempSpread.max);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.4142f, avg.bme280TempSpread.stddev);
+
+    // Spread resets with the window
+    dm.clearAveragingBuffer();
+    dm.addReading(createTestReading(10.0f, 5000));
+    avg = dm.calculateAverages();
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 10.0f, avg.bme280TempSpread.min);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 10.0f, avg.bme280TempSpread.max);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, avg.bme280TempSpread.stddev);
+}
+
+// Test: ULP soil samples join the window without closing it
+void test_add_soil_samples_from_sleep() {
+    DataManager dm;
+    dm.setPublishIntervalSamples(10);
+
+    // 30 samples at 40% asleep, then one full wake reading at 60%
+    RunningStats sleep;
+    sleep.reset();
+    sleep.count = 30;
+    sleep.sum = 40.0f * 30;
+    sleep.min = 35.0f;
+    sleep.max = 45.0f;
+    sleep.welfordMean = 40.0f;
+
+    dm.addSoilSamples(sleep, 500);
+    TEST_ASSERT_EQUAL_UINT16(9, dm.getCurrentSampleCount());
+    TEST_ASSERT_FALSE(dm.shouldPublish());
+
+    dm.addReading(createTestReading(20.0f, 1000));
+    TEST_ASSERT_TRUE(dm.shouldPublish());
+
+    AveragedData avg = dm.calculateAverages();
+    TEST_ASSERT_EQUAL_UINT16(31, avg.soilSampleCount);
+    TEST_ASSERT_EQUAL_UINT16(1, avg.bme280SampleCount);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, (40.0f * 30 + 60.0f) / 31, avg.avgSoilMoisture);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 35.0f, avg.soilMoistureSpread.min);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 60.0f, avg.soilMoistureSpread.max);
+    TEST_ASSERT_EQUAL_UINT32(500, avg.sampleStartUptimeMs);
+}
+
+// Test: once synced, windows close on wall-clock multiples of their length
+void test_aligned_windows_close_on_the_clock() {
+    DataManager dm;
+    dm.setPublishIntervalSamples(5);
+    dm.setWindowAlignment(300000);
+
+    // Epoch 12:03:20 at monotonic 1000; readings every 60 s
+    const uint64_t epochAt1000 = 1704110600000ULL;
+    uint32_t now = 1000;
+    TEST_ASSERT_FALSE(dm.closesAlignedWindow(now, epochAt1000));
+    dm.addReading(createTestReading(20.0f, now));
+
+    // 12:04:20 is still in the 12:00-12:05 window
+    now += 60000;
+    TEST_ASSERT_FALSE(dm.windowClosesAt(now));
+    TEST_ASSERT_FALSE(dm.closesAlignedWindow(now, epochAt1000 + 60000));
+    dm.addReading(createTestReading(21.0f, now));
+    TEST_ASSERT_FALSE(dm.shouldPublish());
+
+    // 12:05:20 opens the next one: the partial window is published first
+    now += 60000;
+    TEST_ASSERT_TRUE(dm.windowClosesAt(now));
+    TEST_ASSERT_TRUE(dm.closesAlignedWindow(now, epochAt1000 + 120000));
+    TEST_ASSERT_EQUAL_UINT16(2, dm.getCurrentSampleCount());
+    dm.clearAveragingBuffer();
+
+    // A full window takes every reading until 12:10, past the sample count
+    for (uint32_t i = 0; i < 5; i++) {
+        TEST_ASSERT_FALSE(dm.closesAlignedWindow(now, epochAt1000 + 120000 + i * 50000));
+        dm.addReading(createTestReading(22.0f, now));
+        now += 50000;
+    }
+    TEST_ASSERT_FALSE(dm.shouldPublish());
+    TEST_ASSERT_FALSE(dm.closesAlignedWindow(now, epochAt1000 + 370000));
+    dm.addReading(createTestReading(22.0f, now));
+    TEST_ASSERT_EQUAL_UINT16(6, dm.getCurrentSampleCount());
+    TEST_ASSERT_TRUE(dm.closesAlignedWindow(now + 50000, epochAt1000 + 420000));
+}
+
+// Test: without a synced clock, aligned windows fall back to the sample count
+void test_aligned_windows_unsynced_use_count() {
+    DataManager dm;
+    dm.setPublishIntervalSamples(3);
+    dm.setWindowAlignment(300000);
+
+    for (uint32_t i = 0; i < 3; i++) {
+        TEST_ASSERT_FALSE(dm.closesAlignedWindow(1000 + i * 1000, 0));
+        dm.addReading(createTestReading(20.0f, 1000 + i * 1000));
+    }
+    TEST_ASSERT_TRUE(dm.shouldPublish());
+    TEST_ASSERT_EQUAL_UINT32(200000, DataManager::msToWindowBoundary(1704110500000ULL, 300000));
+    TEST_ASSERT_EQUAL_UINT32(300000, DataManager::msToWindowBoundary(1704110400000ULL, 300000));
+}
+
 void setup() {
     UNITY_BEGIN();
 
@@ -200,6 +366,12 @@ void setup() {
     RUN_TEST(test_batch_id_generation_unsynced);
     RUN_TEST(test_empty_buffer_averages);
     RUN_TEST(test_buffer_does_not_overflow);
+    RUN_TEST(test_calculate_averages_per_probe);
+    RUN_TEST(test_calculate_averages_skips_stale_fields);
+    RUN_TEST(test_calculate_window_spread);
+    RUN_TEST(test_add_soil_samples_from_sleep);
+    RUN_TEST(test_aligned_windows_close_on_the_clock);
+    RUN_TEST(test_aligned_windows_unsynced_use_count);
 
     UNITY_END();
 }
@@ -0,0 +1,216 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unity.h>
+
+#include "CountingAllocator.h"
+#include "DataManager.h"
+#include "WString.h"
+
+/**
+ * Allocation-Budget Property Tests for DataManager
+ *
+ * Feature: esp32-sensor-firmware
+ *
+ * Once constructed, DataManager runs out of fixed buffers: the averaging window, the
+ * transmission ring and the display tiers never touch the heap. These tests replace
+ * the global operator new (CountingAllocator.h) and fail if any steady-state call
+ * allocates, across randomly generated call sequences. Minimum 100 iterations per
+ * property test.
+ */
+
+#define ALLOC_OPS_PER_ITERATION 300
+#define ALLOC_READING_STEP_MS 1000
+#define ALLOC_DISPLAY_STEP_MS 60000  // DataManager's 1-minute display tier
+
+enum class SteadyOp : uint8_t {
+    ADD_READING,
+    PUBLISH_CYCLE,  // shouldPublish(), and on true calculateAverages() + buffer
+    CALCULATE_AVERAGES,
+    BUFFER_FOR_TRANSMISSION,
+    ADD_DISPLAY_POINT,
+    GET_DISPLAY_DATA,
+    GET_DISPLAY_HISTORY
+};
+
+static constexpr uint8_t NUM_STEADY_OPS = 7;
+
+static const char* const STEADY_OP_NAMES[NUM_STEADY_OPS] = {"addReading",
+                                                           "shouldPublish/calculateAverages",
+                                                           "calculateAverages",
+                                                           "bufferForTransmission",
+                                                           "addToDisplayBuffer",
+                                                           "getDisplayData",
+                                                           "getDisplayHistory"};
+
+// Random number generator helpers
+float randomFloat(float min, float max) {
+    return min + (float)rand() / ((float)RAND_MAX / (max - min));
+}
+
+uint32_t randomUInt32(uint32_t min, uint32_t max) {
+    return min + (rand() % (max - min + 1));
+}
+
+// Helper to create a random sensor reading
+SensorReadings createRandomReading(uint32_t timestamp) {
+    SensorReadings reading = {};
+    reading.bme280Temp = randomFloat(-40.0f, 85.0f);
+    reading.ds18b20Temp = randomFloat(-55.0f, 125.0f);
+    reading.humidity = randomFloat(0.0f, 100.0f);
+    reading.pressure = randomFloat(300.0f, 1100.0f);
+    reading.soilMoisture = randomFloat(0.0f, 100.0f);
+    reading.soilMoistureRaw = randomUInt32(0, 4095);
+    reading.sensorStatus = 0xFF;
+    reading.monotonicMs = timestamp;
+    return reading;
+}
+
+/**
+ * Run one operation against dm, advancing the virtual clock
+ * @return operator new calls made by the operation
+ */
+uint64_t runSteadyOp(DataManager& dm, SteadyOp op, uint32_t& nowMs) {
+    uint64_t before = heapCounters.allocations;
+    uint16_t count = 0;
+    SensorType type = static_cast<SensorType>(randomUInt32(0, NUM_SENSORS - 1));
+    const uint16_t maxPointChoices[] = {0, 30, MAX_GRAPH_POINTS};
+    uint16_t maxPoints = maxPointChoices[randomUInt32(0, 2)];
+
+    switch (op) {
+        case SteadyOp::ADD_READING:
+            nowMs += ALLOC_READING_STEP_MS;
+            dm.addReading(createRandomReading(nowMs));
+            break;
+        case SteadyOp::PUBLISH_CYCLE:
+            if (dm.shouldPublish()) {
+                AveragedData data = dm.calculateAverages();
+                dm.bufferForTransmission(data);
+            }
+            break;
+        case SteadyOp::CALCULATE_AVERAGES:
+            dm.calculateAverages();
+            break;
+        case SteadyOp::BUFFER_FOR_TRANSMISSION: {
+            AveragedData data = {};
+            snprintf(data.batchId, sizeof(data.batchId), "device_u_%lu_%lu",
+                     static_cast<unsigned long>(nowMs), static_cast<unsigned long>(nowMs + 1));
+            data.sampleStartUptimeMs = nowMs;
+            data.sampleEndUptimeMs = nowMs + 1;
+            data.avgBme280Temp = randomFloat(-40.0f, 85.0f);
+            dm.bufferForTransmission(data);
+            break;
+        }
+        case SteadyOp::ADD_DISPLAY_POINT:
+            nowMs += ALLOC_DISPLAY_STEP_MS;
+            dm.addToDisplayBuffer(createRandomReading(nowMs));
+            break;
+        case SteadyOp::GET_DISPLAY_DATA:
+            dm.getDisplayData(type, count, maxPoints);
+            break;
+        case SteadyOp::GET_DISPLAY_HISTORY: {
+            const uint32_t spanChoices[] = {0, 3600000UL, 86400000UL, 7UL * 86400000UL};
+            dm.getDisplayHistory(type, spanChoices[randomUInt32(0, 3)], count, maxPoints);
+            break;
+        }
+    }
+    return heapCounters.allocations - before;
+}
+
+// Run every operation once, so any first-use setup is out of the measured sequence
+void warmUp(DataManager& dm, uint32_t& nowMs) {
+    for (uint8_t op = 0; op < NUM_STEADY_OPS; op++) {
+        runSteadyOp(dm, static_cast<SteadyOp>(op), nowMs);
+    }
+}
+
+/**
+ * Property: Steady-state operations never allocate
+ *
+ * For any DataManager with any publish interval, and any sequence of addReading,
+ * shouldPublish, calculateAverages, bufferForTransmission, addToDisplayBuffer,
+ * getDisplayData and getDisplayHistory calls, no call makes a heap allocation.
+ */
+void property_steady_state_operations_do_not_allocate() {
+    const int NUM_ITERATIONS = 100;
+
+    for (int iter = 0; iter < NUM_ITERATIONS; iter++) {
+        DataManager* dm = new DataManager();
+        dm->setPublishIntervalSamples(randomUInt32(1, MAX_PUBLISH_SAMPLES));
+        uint32_t nowMs = randomUInt32(1, 1000000);
+        warmUp(*dm, nowMs);
+
+        for (int i = 0; i < ALLOC_OPS_PER_ITERATION; i++) {
+            uint8_t op = randomUInt32(0, NUM_STEADY_OPS - 1);
+            uint64_t allocations = runSteadyOp(*dm, static_cast<SteadyOp>(op), nowMs);
+            if (allocations != 0) {
+                char message[96];
+                snprintf(message, sizeof(message), "%s allocated %llu time(s) at step %d",
+                         STEADY_OP_NAMES[op], static_cast<unsigned long long>(allocations), i);
+                delete dm;
+                TEST_FAIL_MESSAGE(message);
+            }
+        }
+        delete dm;
+    }
+}
+
+/**
+ * Property: Full rings stay allocation-free
+ *
+ * For any data once the transmission ring evicts its oldest windows and the display
+ * history wraps, buffering and querying still make no heap allocation.
+ */
+void property_full_rings_do_not_allocate() {
+    const int NUM_ITERATIONS = 100;
+
+    for (int iter = 0; iter < NUM_ITERATIONS; iter++) {
+        DataManager* dm = new DataManager();
+        uint32_t nowMs = randomUInt32(1, 1000000);
+        warmUp(*dm, nowMs);
+
+        uint64_t before = heapCounters.allocations;
+        uint16_t overfill = randomUInt32(1, 50);
+        for (uint16_t i = 0; i < dm->getDataBufferCapacity() + overfill; i++) {
+            runSteadyOp(*dm, SteadyOp::BUFFER_FOR_TRANSMISSION, nowMs);
+        }
+        for (uint16_t i = 0; i < dm->getDisplayCapacity() + overfill; i++) {
+            runSteadyOp(*dm, SteadyOp::ADD_DISPLAY_POINT, nowMs);
+            runSteadyOp(*dm, SteadyOp::GET_DISPLAY_DATA, nowMs);
+        }
+        uint64_t allocations = heapCounters.allocations - before;
+        delete dm;
+        TEST_ASSERT_TRUE_MESSAGE(allocations == 0, "Wrapping a full ring must not allocate");
+    }
+}
+
+// Test: the counting allocator sees allocations, so a zero count means something
+void test_counting_allocator_counts_string_growth() {
+    uint64_t before = heapCounters.allocations;
+    String text("allocation budget");
+    text += " exceeded by a string longer than any small-buffer optimization";
+    TEST_ASSERT_TRUE(heapCounters.allocations > before);
+}
+
+void setUp() {
+    // Seed random number generator
+    srand((unsigned int)time(NULL));
+}
+
+void tearDown() {
+    // Nothing to tear down
+}
+
+void setup() {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_counting_allocator_counts_string_growth);
+    RUN_TEST(property_steady_state_operations_do_not_allocate);
+    RUN_TEST(property_full_rings_do_not_allocate);
+
+    UNITY_END();
+}
+
+void loop() {
+    // Empty
+}
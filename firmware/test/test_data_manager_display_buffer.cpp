@@ -1,7 +1,9 @@
 #include <unity.h>
 
 #include "DataManager.h"
+#include "models/DisplayBucket.h"
 #include "models/DisplayPoint.h"
+#include "models/DisplaySeries.h"
 #include "models/SensorReadings.h"
 #include "models/SensorType.h"
 
@@ -82,6 +84,260 @@ void test_display_buffer_downsampling_to_120_points() {
     TEST_ASSERT_FLOAT_WITHIN(0.01f, 259.0f, data[119].value);
 }
 
+void test_display_tier_selection() {
+    DataManager dm;
+
+    TEST_ASSERT_EQUAL(DisplayTier::MINUTE, dm.selectDisplayTier(0));
+    TEST_ASSERT_EQUAL(DisplayTier::MINUTE, dm.selectDisplayTier(4UL * 3600000UL));
+    TEST_ASSERT_EQUAL(DisplayTier::QUARTER_HOUR, dm.selectDisplayTier(24UL * 3600000UL));
+    TEST_ASSERT_EQUAL(DisplayTier::HOUR, dm.selectDisplayTier(7UL * 86400000UL));
+}
+
+void test_quarter_hour_buckets_roll_up_min_mean_max() {
+    DataManager dm;
+
+    // 30 one-minute points: values 0..29 -> buckets [0..14] and [15..29] (still open)
+    for (uint16_t i = 0; i < 30; i++) {
+        dm.addToDisplayBuffer(createReading(i * 60000UL, (float)i));
+    }
+
+    uint16_t count = 0;
+    const DisplayBucket* buckets =
+        dm.getDisplayBuckets(SensorType::BME280_TEMP, DisplayTier::QUARTER_HOUR, count);
+
+    TEST_ASSERT_NOT_NULL(buckets);
+    TEST_ASSERT_EQUAL_UINT16(2, count);
+    TEST_ASSERT_EQUAL_UINT32(0, buckets[0].timestamp);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.0f, buckets[0].min);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 7.0f, buckets[0].mean);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 14.0f, buckets[0].max);
+    TEST_ASSERT_EQUAL_UINT32(900000UL, buckets[1].timestamp);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 15.0f, buckets[1].min);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 29.0f, buckets[1].max);
+}
+
+// Test: fixed-point buckets keep hundredths, and pressure (which needs more than 16 bits
+// of hundredths) in tenths of hPa
+void test_buckets_keep_fixed_point_precision() {
+    DataManager dm;
+    for (uint16_t i = 0; i < 16; i++) {
+        dm.addToDisplayBuffer(createReading(i * 60000UL, 13.37f));
+    }
+
+    uint16_t count = 0;
+    const DisplayBucket* temp =
+        dm.getDisplayBuckets(SensorType::BME280_TEMP, DisplayTier::QUARTER_HOUR, count);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 13.37f, temp[0].mean);
+    const DisplayBucket* pressure =
+        dm.getDisplayBuckets(SensorType::PRESSURE, DisplayTier::QUARTER_HOUR, count);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 1013.37f, pressure[0].min);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 1013.37f, pressure[0].max);
+
+    DisplaySeries series = dm.getDisplaySeries(SensorType::PRESSURE, DisplayTier::QUARTER_HOUR);
+    TEST_ASSERT_EQUAL_UINT16(1, series.count);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 1013.37f, series.valueAt(0));
+}
+
+void test_history_spans_beyond_minute_tier() {
+    DataManager dm;
+
+    // 24 hours of 1-minute points
+    for (uint16_t i = 0; i < 1440; i++) {
+        dm.addToDisplayBuffer(createReading(i * 60000UL, 20.0f + (i / 60)));
+    }
+
+    // Minute tier only holds the last 4 hours
+    uint16_t count = 0;
+    const DisplayPoint* minutes = dm.getDisplayData(SensorType::BME280_TEMP, count);
+    TEST_ASSERT_EQUAL_UINT16(240, count);
+    TEST_ASSERT_EQUAL_UINT32(1200UL * 60000UL, minutes[0].timestamp);
+
+    // A 24 h query comes from the 15-minute tier and reaches back to the start
+    const DisplayPoint* day = dm.getDisplayHistory(SensorType::BME280_TEMP, 86400000UL, count);
+    TEST_ASSERT_NOT_NULL(day);
+    TEST_ASSERT_EQUAL_UINT16(96, count);
+    TEST_ASSERT_EQUAL_UINT32(0, day[0].timestamp);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, day[0].value);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 43.0f, day[count - 1].value);
+
+    // Downsampling is capped at MAX_GRAPH_POINTS and stays in time order
+    const DisplayPoint* week =
+        dm.getDisplayHistory(SensorType::BME280_TEMP, 7UL * 86400000UL, count, 200);
+    TEST_ASSERT_EQUAL_UINT16(24, count);
+    for (uint16_t i = 1; i < count; i++) {
+        TEST_ASSERT_TRUE(week[i].timestamp > week[i - 1].timestamp);
+    }
+}
+
+void test_display_series_view_after_wrap() {
+    DataManager dm;
+
+    for (uint16_t i = 0; i < 250; i++) {
+        dm.addToDisplayBuffer(createReading(i * 60000UL, 20.0f + i));
+    }
+
+    DisplaySeries temp = dm.getDisplaySeries(SensorType::BME280_TEMP);
+    DisplaySeries soil = dm.getDisplaySeries(SensorType::SOIL_MOISTURE);
+
+    TEST_ASSERT_EQUAL_UINT16(240, temp.count);
+    TEST_ASSERT_EQUAL_PTR(temp.timestamps, soil.timestamps);  // Shared timestamp column
+
+    // Oldest-first across the ring wrap
+    TEST_ASSERT_EQUAL_UINT32(10UL * 60000UL, temp.timestampAt(0));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 30.0f, temp.valueAt(0));
+    TEST_ASSERT_EQUAL_UINT32(249UL * 60000UL, temp.timestampAt(239));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 269.0f, temp.valueAt(239));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 272.0f, soil.valueAt(239));
+}
+
+void test_larger_history_extends_minute_tier() {
+    DataManager dm;
+    TEST_ASSERT_TRUE(dm.configureBuffers(MAX_DATA_BUFFER_SIZE, 480));
+    TEST_ASSERT_EQUAL_UINT16(480, dm.getDisplayCapacity());
+
+    for (uint16_t i = 0; i < 500; i++) {
+        dm.addToDisplayBuffer(createReading(i * 60000UL, (float)i));
+    }
+
+    // 8 hours now come from raw 1-minute points
+    TEST_ASSERT_EQUAL(DisplayTier::MINUTE, dm.selectDisplayTier(8UL * 3600000UL));
+
+    uint16_t count = 0;
+    const DisplayPoint* data = dm.getDisplayHistory(SensorType::BME280_TEMP, 0, count);
+    TEST_ASSERT_EQUAL_UINT16(480, count);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, data[0].value);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 499.0f, data[479].value);
+}
+
+void test_downsampling_keeps_spikes() {
+    DataManager dm;
+
+    // Flat series with one-minute spikes that evenly spaced picks would skip
+    for (uint16_t i = 0; i < 240; i++) {
+        float value = 20.0f;
+        if (i == 101) {
+            value = 35.0f;
+        } else if (i == 178) {
+            value = 5.0f;
+        }
+        dm.addToDisplayBuffer(createReading(i * 60000UL, value));
+    }
+
+    uint16_t count = 0;
+    const DisplayPoint* data = dm.getDisplayData(SensorType::BME280_TEMP, count, 120);
+    TEST_ASSERT_EQUAL_UINT16(120, count);
+
+    float minVal = data[0].value;
+    float maxVal = data[0].value;
+    for (uint16_t i = 1; i < count; i++) {
+        TEST_ASSERT_TRUE(data[i].timestamp > data[i - 1].timestamp);
+        minVal = data[i].value < minVal ? data[i].value : minVal;
+        maxVal = data[i].value > maxVal ? data[i].value : maxVal;
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 35.0f, maxVal);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 5.0f, minVal);
+}
+
+void test_bounded_history_cached_until_new_point() {
+    DataManager dm;
+
+    for (uint16_t i = 0; i < 240; i++) {
+        dm.addToDisplayBuffer(createReading(i * 60000UL, (float)i));
+    }
+
+    uint16_t count = 0;
+    const DisplayPoint* first = dm.getDisplayData(SensorType::HUMIDITY, count, 120);
+    float newestBefore = first[count - 1].value;
+
+    // A different sensor's query must not disturb the cached series
+    uint16_t otherCount = 0;
+    dm.getDisplayData(SensorType::PRESSURE, otherCount, 120);
+    const DisplayPoint* again = dm.getDisplayData(SensorType::HUMIDITY, count, 120);
+    TEST_ASSERT_EQUAL_PTR(first, again);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, newestBefore, again[count - 1].value);
+
+    // A new point invalidates the cache
+    dm.addToDisplayBuffer(createReading(240UL * 60000UL, 1000.0f));
+    const DisplayPoint* updated = dm.getDisplayData(SensorType::HUMIDITY, count, 120);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1002.0f, updated[count - 1].value);  // humidity = value + 2
+}
+
+// Brute-force min/max over the plotted history, for comparison with the running range
+void scanHistory(const DataManager& dm, SensorType type, uint32_t spanMs, float& minVal,
+                 float& maxVal) {
+    uint16_t count = 0;
+    const DisplayPoint* data = dm.getDisplayHistory(type, spanMs, count);
+    TEST_ASSERT_NOT_NULL(data);
+    minVal = data[0].value;
+    maxVal = data[0].value;
+    for (uint16_t i = 1; i < count; i++) {
+        minVal = data[i].value < minVal ? data[i].value : minVal;
+        maxVal = data[i].value > maxVal ? data[i].value : maxVal;
+    }
+}
+
+void test_display_range_tracks_minute_window() {
+    DataManager dm;
+    float minVal = 0.0f;
+    float maxVal = 0.0f;
+    TEST_ASSERT_FALSE(dm.getDisplayRange(SensorType::BME280_TEMP, 0, minVal, maxVal));
+
+    // Pseudo-random walk, checked against a full scan as points enter and leave the ring
+    float value = 20.0f;
+    for (uint16_t i = 0; i < 600; i++) {
+        value += ((i * 37) % 11) - 5.0f;
+        dm.addToDisplayBuffer(createReading(i * 60000UL, value));
+
+        uint32_t spans[3] = {0, 3600000UL, 4UL * 3600000UL};
+        for (uint32_t spanMs : spans) {
+            float scanMin = 0.0f;
+            float scanMax = 0.0f;
+            scanHistory(dm, SensorType::PRESSURE, spanMs, scanMin, scanMax);
+            TEST_ASSERT_TRUE(dm.getDisplayRange(SensorType::PRESSURE, spanMs, minVal, maxVal));
+            TEST_ASSERT_EQUAL_FLOAT(scanMin, minVal);
+            TEST_ASSERT_EQUAL_FLOAT(scanMax, maxVal);
+        }
+    }
+
+    // The snapshot rotates the ring in place; the range must survive it
+    float before = 0.0f;
+    dm.getDisplayRange(SensorType::PRESSURE, 3600000UL, before, maxVal);
+    dm.snapshot(600UL * 60000UL);
+    TEST_ASSERT_TRUE(dm.getDisplayRange(SensorType::PRESSURE, 3600000UL, minVal, maxVal));
+    TEST_ASSERT_EQUAL_FLOAT(before, minVal);
+    dm.addToDisplayBuffer(createReading(600UL * 60000UL, -500.0f));
+    TEST_ASSERT_TRUE(dm.getDisplayRange(SensorType::PRESSURE, 3600000UL, minVal, maxVal));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 500.0f, minVal);  // pressure = 1000 + value
+}
+
+void test_display_range_uses_bucket_extremes() {
+    DataManager dm;
+
+    // 24 hours with a one-minute spike the 15-minute means smooth out
+    for (uint16_t i = 0; i < 1440; i++) {
+        float value = i == 700 ? 90.0f : 20.0f + (i / 60);
+        dm.addToDisplayBuffer(createReading(i * 60000UL, value));
+    }
+
+    float minVal = 0.0f;
+    float maxVal = 0.0f;
+    TEST_ASSERT_TRUE(dm.getDisplayRange(SensorType::BME280_TEMP, 86400000UL, minVal, maxVal));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 20.0f, minVal);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 90.0f, maxVal);
+
+    // The plotted bucket means always lie inside the range
+    float scanMin = 0.0f;
+    float scanMax = 0.0f;
+    scanHistory(dm, SensorType::BME280_TEMP, 86400000UL, scanMin, scanMax);
+    TEST_ASSERT_TRUE(scanMin >= minVal && scanMax <= maxVal);
+
+    // A 6 h span covers only the last 24 quarter-hour buckets (plus the open one)
+    TEST_ASSERT_TRUE(dm.getDisplayRange(SensorType::BME280_TEMP, 6UL * 3600000UL, minVal,
+                                        maxVal));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 37.0f, minVal);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 43.0f, maxVal);
+}
+
 int main(int argc, char** argv) {
     UNITY_BEGIN();
 
@@ -89,6 +345,16 @@ int main(int argc, char** argv) {
     RUN_TEST(test_display_buffer_respects_1_minute_interval);
     RUN_TEST(test_display_buffer_capacity_limit);
     RUN_TEST(test_display_buffer_downsampling_to_120_points);
+    RUN_TEST(test_display_tier_selection);
+    RUN_TEST(test_quarter_hour_buckets_roll_up_min_mean_max);
+    RUN_TEST(test_buckets_keep_fixed_point_precision);
+    RUN_TEST(test_history_spans_beyond_minute_tier);
+    RUN_TEST(test_display_series_view_after_wrap);
+    RUN_TEST(test_larger_history_extends_minute_tier);
+    RUN_TEST(test_downsampling_keeps_spikes);
+    RUN_TEST(test_bounded_history_cached_until_new_point);
+    RUN_TEST(test_display_range_tracks_minute_window);
+    RUN_TEST(test_display_range_uses_bucket_extremes);
 
     return UNITY_END();
 }
@@ -177,18 +177,18 @@ void test_clear_acknowledged_data_all_matches_empties_buffer() {
     TEST_ASSERT_EQUAL_UINT16(0, dm.getBufferedDataCount());
 }
 
-// Test: getBufferedData returns nullptr for empty buffer
+// Test: getBufferedBatch returns an empty view for empty buffer
 void test_get_buffered_data_empty_returns_null() {
     DataManager dm;
-    uint16_t count = 0;
 
-    const AveragedData* data = dm.getBufferedData(count);
+    BufferedBatch batch = dm.getBufferedBatch();
 
-    TEST_ASSERT_NULL(data);
-    TEST_ASSERT_EQUAL_UINT16(0, count);
+    TEST_ASSERT_EQUAL_UINT16(0, batch.count());
+    TEST_ASSERT_EQUAL_UINT16(0, batch.segments[0].count);
+    TEST_ASSERT_EQUAL_UINT16(0, batch.segments[1].count);
 }
 
-// Test: getBufferedData returns correct count for non-empty buffer
+// Test: getBufferedBatch returns correct count for non-empty buffer
 void test_get_buffered_data_returns_correct_count() {
     DataManager dm;
 
@@ -198,11 +198,10 @@ void test_get_buffered_data_returns_correct_count() {
         dm.bufferForTransmission(data);
     }
 
-    uint16_t count = 0;
-    const AveragedData* data = dm.getBufferedData(count);
+    BufferedBatch batch = dm.getBufferedBatch();
 
-    TEST_ASSERT_NOT_NULL(data);
-    TEST_ASSERT_EQUAL_UINT16(5, count);
+    TEST_ASSERT_NOT_NULL(batch.segments[0].data);
+    TEST_ASSERT_EQUAL_UINT16(5, batch.count());
 }
 
 // Test: Ring buffer wraps around correctly
@@ -228,6 +227,230 @@ void test_ring_buffer_wraps_around() {
     TEST_ASSERT_TRUE(dm.getBufferOverflowCount() > 0);
 }
 
+// Test: buffered entries get increasing sequence numbers
+void test_buffered_entries_get_sequence_numbers() {
+    DataManager dm;
+
+    for (uint16_t i = 0; i < 3; i++) {
+        dm.bufferForTransmission(createSampleData(i * 1000, (i + 1) * 1000));
+    }
+
+    BufferedBatch batch = dm.getBufferedBatch();
+    TEST_ASSERT_EQUAL_UINT16(3, batch.count());
+    TEST_ASSERT_EQUAL_UINT32(1, batch.at(0).sequence);
+    TEST_ASSERT_EQUAL_UINT32(2, batch.at(1).sequence);
+    TEST_ASSERT_EQUAL_UINT32(3, batch.at(2).sequence);
+    TEST_ASSERT_EQUAL_UINT32(4, dm.getNextSequence());
+}
+
+// Test: cumulative watermark trims the oldest entries only
+void test_acknowledge_through_watermark() {
+    DataManager dm;
+
+    for (uint16_t i = 0; i < 5; i++) {
+        dm.bufferForTransmission(createSampleData(i * 1000, (i + 1) * 1000));
+    }
+
+    TEST_ASSERT_EQUAL_UINT16(3, dm.acknowledgeThrough(3));
+    TEST_ASSERT_EQUAL_UINT16(2, dm.getBufferedDataCount());
+
+    TEST_ASSERT_EQUAL_UINT32(4, dm.getBufferedBatch().at(0).sequence);
+
+    // Stale or repeated watermark is a no-op
+    TEST_ASSERT_EQUAL_UINT16(0, dm.acknowledgeThrough(2));
+    TEST_ASSERT_EQUAL_UINT16(2, dm.acknowledgeThrough(10));
+    TEST_ASSERT_EQUAL_UINT16(0, dm.getBufferedDataCount());
+}
+
+// Test: a range in the middle of the backlog leaves the rest in order
+void test_acknowledge_range_in_middle() {
+    DataManager dm;
+
+    for (uint16_t i = 0; i < 6; i++) {
+        dm.bufferForTransmission(createSampleData(i * 1000, (i + 1) * 1000));
+    }
+
+    TEST_ASSERT_EQUAL_UINT16(2, dm.acknowledgeRange(3, 4));
+    TEST_ASSERT_EQUAL_UINT16(4, dm.getBufferedDataCount());
+
+    BufferedBatch batch = dm.getBufferedBatch();
+    TEST_ASSERT_EQUAL_UINT32(1, batch.at(0).sequence);
+    TEST_ASSERT_EQUAL_UINT32(2, batch.at(1).sequence);
+    TEST_ASSERT_EQUAL_UINT32(5, batch.at(2).sequence);
+    TEST_ASSERT_EQUAL_UINT32(6, batch.at(3).sequence);
+
+    // New entries still append after the compacted backlog
+    dm.bufferForTransmission(createSampleData(6000, 7000));
+    batch = dm.getBufferedBatch();
+    TEST_ASSERT_EQUAL_UINT16(5, batch.count());
+    TEST_ASSERT_EQUAL_UINT32(7, batch.at(4).sequence);
+}
+
+// Test: a backlog that wraps the ring is exposed as two ordered segments
+void test_buffered_batch_splits_at_wrap() {
+    DataManager dm;
+
+    for (uint16_t i = 0; i < 40; i++) {
+        dm.bufferForTransmission(createSampleData(i * 1000, (i + 1) * 1000));
+    }
+    TEST_ASSERT_EQUAL_UINT16(30, dm.acknowledgeThrough(30));
+
+    // Tail is now at index 30; 20 more entries wrap past the end of the array
+    for (uint16_t i = 40; i < 60; i++) {
+        dm.bufferForTransmission(createSampleData(i * 1000, (i + 1) * 1000));
+    }
+
+    BufferedBatch batch = dm.getBufferedBatch();
+    TEST_ASSERT_EQUAL_UINT16(30, batch.count());
+    TEST_ASSERT_EQUAL_UINT16(20, batch.segments[0].count);
+    TEST_ASSERT_EQUAL_UINT16(10, batch.segments[1].count);
+    for (uint16_t i = 0; i < batch.count(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(31 + i, batch.at(i).sequence);
+    }
+    TEST_ASSERT_EQUAL_UINT32(51, batch.segments[1].data[0].sequence);
+}
+
+// Test: first() pages a wrapped backlog oldest-first, within or across the wrap
+void test_buffered_batch_first_pages() {
+    DataManager dm;
+
+    for (uint16_t i = 0; i < 40; i++) {
+        dm.bufferForTransmission(createSampleData(i * 1000, (i + 1) * 1000));
+    }
+    dm.acknowledgeThrough(30);
+    for (uint16_t i = 40; i < 60; i++) {
+        dm.bufferForTransmission(createSampleData(i * 1000, (i + 1) * 1000));
+    }
+    BufferedBatch batch = dm.getBufferedBatch();
+
+    BufferedBatch page = batch.first(16);
+    TEST_ASSERT_EQUAL_UINT16(16, page.count());
+    TEST_ASSERT_EQUAL_UINT16(0, page.segments[1].count);
+    TEST_ASSERT_EQUAL_UINT32(46, page.at(15).sequence);
+
+    page = batch.first(25);
+    TEST_ASSERT_EQUAL_UINT16(25, page.count());
+    TEST_ASSERT_EQUAL_UINT16(5, page.segments[1].count);
+    TEST_ASSERT_EQUAL_UINT32(55, page.at(24).sequence);
+
+    TEST_ASSERT_EQUAL_UINT16(30, batch.first(100).count());
+}
+
+// Test: a wrapped backlog snapshots as one block and restores with order and counters
+void test_snapshot_restore_keeps_order_and_counters() {
+    DataManager dm;
+    for (uint16_t i = 0; i < 40; i++) {
+        dm.bufferForTransmission(createSampleData(i * 1000, (i + 1) * 1000));
+    }
+    dm.acknowledgeThrough(30);
+    for (uint16_t i = 40; i < 80; i++) {
+        dm.bufferForTransmission(createSampleData(i * 1000, (i + 1) * 1000));
+    }
+    uint16_t overflows = dm.getBufferOverflowCount();
+    TEST_ASSERT_TRUE(overflows > 0);
+
+    DataSnapshot view = dm.snapshot(0);
+    TEST_ASSERT_EQUAL_UINT16(dm.getBufferedDataCount(), view.recordCount);
+    for (uint16_t i = 0; i < view.recordCount; i++) {
+        TEST_ASSERT_EQUAL_UINT32(dm.getBufferedBatch().at(i).sequence, view.records[i].sequence);
+    }
+
+    DataManager restored;
+    DataRestoreTarget target = restored.beginRestore();
+    TEST_ASSERT_NOT_NULL(target.records);
+    memcpy(target.records, view.records, view.recordCount * sizeof(PackedAveragedData));
+    TEST_ASSERT_TRUE(restored.commitRestore(view.recordCount, view.nextSequence,
+                                            view.bufferOverflowCount, 0, 0, 0));
+
+    TEST_ASSERT_EQUAL_UINT16(view.recordCount, restored.getBufferedDataCount());
+    TEST_ASSERT_EQUAL_UINT16(overflows, restored.getBufferOverflowCount());
+    BufferedBatch batch = restored.getBufferedBatch();
+    for (uint16_t i = 1; i < batch.count(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(batch.at(i - 1).sequence + 1, batch.at(i).sequence);
+    }
+
+    // New windows continue the sequence; a second restore is refused
+    restored.bufferForTransmission(createSampleData(99000, 100000));
+    BufferedBatch after = restored.getBufferedBatch();
+    TEST_ASSERT_EQUAL_UINT32(81, after.at(after.count() - 1).sequence);
+    TEST_ASSERT_NULL(restored.beginRestore().records);
+}
+
+// Test: a larger runtime capacity moves the overflow threshold with it
+void test_configured_capacity_scales_ring() {
+    DataManager dm;
+    TEST_ASSERT_TRUE(dm.configureBuffers(200, MAX_DISPLAY_POINTS));
+    TEST_ASSERT_EQUAL_UINT16(200, dm.getDataBufferCapacity());
+
+    for (uint16_t i = 0; i < 200; i++) {
+        dm.bufferForTransmission(createSampleData(i * 1000, (i + 1) * 1000));
+    }
+
+    // 90% of 200
+    TEST_ASSERT_EQUAL_UINT16(180, dm.getBufferedDataCount());
+    TEST_ASSERT_EQUAL_UINT32(21, dm.getBufferedBatch().at(0).sequence);
+
+    // Resizing is refused once data is buffered
+    TEST_ASSERT_FALSE(dm.configureBuffers(400, MAX_DISPLAY_POINTS));
+    TEST_ASSERT_EQUAL_UINT16(200, dm.getDataBufferCapacity());
+}
+
+// Test: buffer sizing falls back to the defaults without PSRAM and is capped with it
+void test_recommend_buffer_sizes() {
+    uint16_t dataCapacity = 0;
+    uint16_t displayPoints = 0;
+
+    DataManager::recommendBufferSizes(0, dataCapacity, displayPoints);
+    TEST_ASSERT_EQUAL_UINT16(MAX_DATA_BUFFER_SIZE, dataCapacity);
+    TEST_ASSERT_EQUAL_UINT16(MAX_DISPLAY_POINTS, displayPoints);
+
+    DataManager::recommendBufferSizes(4UL * 1024 * 1024, dataCapacity, displayPoints);
+    TEST_ASSERT_EQUAL_UINT16(PSRAM_DATA_BUFFER_SIZE, dataCapacity);
+    TEST_ASSERT_EQUAL_UINT16(PSRAM_DISPLAY_POINTS, displayPoints);
+}
+
+// Test: packed record is compact and expands back to the wire-format fields
+void test_packed_record_round_trip() {
+    TEST_ASSERT_TRUE(sizeof(PackedAveragedData) * 2 <= sizeof(AveragedData));
+
+    AveragedData data = createSampleData(5000, 65000);
+    data.sequence = 7;
+    data.timeSynced = true;
+    data.sampleStartEpochMs = 1704067200123ULL;
+    data.sampleEndEpochMs = 1704067260456ULL;
+    data.deviceBootEpochMs = 1704060000789ULL;
+    data.uptimeMs = 65000;
+    data.avgDs18b20Probes[1] = -12.34f;
+    data.ds18b20ProbeCount = 2;
+    data.pressureSpread.min = 1012.5f;
+    data.pressureSpread.max = 1014.0f;
+    data.pressureSpread.stddev = 0.42f;
+    data.bme280TempSpread.stddev = 0.25f;
+    DataManager::formatBatchId(data.batchId, sizeof(data.batchId), data);
+
+    PackedAveragedData packed;
+    DataManager::packAveragedData(data, packed);
+    AveragedData out;
+    DataManager::unpackAveragedData(packed, out);
+
+    TEST_ASSERT_EQUAL_STRING(data.batchId, out.batchId);
+    TEST_ASSERT_EQUAL_UINT32(7, out.sequence);
+    TEST_ASSERT_TRUE(out.timeSynced);
+    TEST_ASSERT_TRUE(out.sampleStartEpochMs == data.sampleStartEpochMs);
+    TEST_ASSERT_TRUE(out.sampleEndEpochMs == data.sampleEndEpochMs);
+    TEST_ASSERT_TRUE(out.deviceBootEpochMs == data.deviceBootEpochMs);
+    TEST_ASSERT_EQUAL_UINT32(5000, out.sampleStartUptimeMs);
+    TEST_ASSERT_EQUAL_UINT32(65000, out.sampleEndUptimeMs);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 22.5f, out.avgBme280Temp);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 1013.25f, out.avgPressure);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, -12.34f, out.avgDs18b20Probes[1]);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 1012.5f, out.pressureSpread.min);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 0.42f, out.pressureSpread.stddev);
+    TEST_ASSERT_FLOAT_WITHIN(0.005f, 0.25f, out.bme280TempSpread.stddev);
+    TEST_ASSERT_EQUAL_UINT8(2, out.ds18b20ProbeCount);
+    TEST_ASSERT_EQUAL_UINT16(20, out.sampleCount);
+}
+
 void setUp(void) {
     // Set up code if needed
 }
@@ -251,6 +474,15 @@ int main(int argc, char** argv) {
     RUN_TEST(test_get_buffered_data_empty_returns_null);
     RUN_TEST(test_get_buffered_data_returns_correct_count);
     RUN_TEST(test_ring_buffer_wraps_around);
+    RUN_TEST(test_buffered_entries_get_sequence_numbers);
+    RUN_TEST(test_acknowledge_through_watermark);
+    RUN_TEST(test_acknowledge_range_in_middle);
+    RUN_TEST(test_buffered_batch_splits_at_wrap);
+    RUN_TEST(test_buffered_batch_first_pages);
+    RUN_TEST(test_snapshot_restore_keeps_order_and_counters);
+    RUN_TEST(test_configured_capacity_scales_ring);
+    RUN_TEST(test_recommend_buffer_sizes);
+    RUN_TEST(test_packed_record_round_trip);
 
     return UNITY_END();
 }
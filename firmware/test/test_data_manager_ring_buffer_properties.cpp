@@ -190,14 +190,15 @@ void property_ring_buffer_fifo_order() {
         }
 
         // Get buffered data
-        uint16_t count = 0;
-        const AveragedData* bufferedData = dm.getBufferedData(count);
+        BufferedBatch batch = dm.getBufferedBatch();
 
-        TEST_ASSERT_EQUAL_UINT16(numItems, count);
-        TEST_ASSERT_NOT_NULL(bufferedData);
+        TEST_ASSERT_EQUAL_UINT16(numItems, batch.count());
+        TEST_ASSERT_NOT_NULL(batch.segments[0].data);
 
         // Property: First item in buffer should match first inserted item
-        TEST_ASSERT_EQUAL_STRING(expectedBatchIds[0], bufferedData[0].batchId);
+        AveragedData first;
+        TEST_ASSERT_TRUE(dm.getBufferedEntry(0, first));
+        TEST_ASSERT_EQUAL_STRING(expectedBatchIds[0], first.batchId);
     }
 }
 
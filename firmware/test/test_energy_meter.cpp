@@ -0,0 +1,72 @@
+#include <unity.h>
+
+#include "EnergyMeter.h"
+
+// Test: time in a state becomes charge with that state's coefficient
+void test_state_time_becomes_mah() {
+    EnergyMeter meter;
+    meter.setCoefficient(ENERGY_CPU_MAX, 36.0f);
+    meter.add(ENERGY_CPU_MAX, 3600000);  // One hour at 36 mA
+    meter.add(ENERGY_CPU_MAX, 1800000);  // Half an hour more
+
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 54.0f, meter.getMah(ENERGY_SUBSYSTEM_CPU));
+    TEST_ASSERT_EQUAL_UINT32(5400000, meter.getStateMs(ENERGY_CPU_MAX));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, meter.getMah(ENERGY_SUBSYSTEM_WIFI));
+}
+
+// Test: states sum into their subsystems and the report window counts CPU time only
+void test_subsystems_and_report() {
+    EnergyMeter meter;
+    meter.setCoefficient(ENERGY_CPU_MIN, 20.0f);
+    meter.setCoefficient(ENERGY_LIGHT_SLEEP, 1.0f);
+    meter.setCoefficient(ENERGY_WIFI_TX, 200.0f);
+    meter.setCoefficient(ENERGY_WIFI_IDLE, 2.0f);
+    meter.setCoefficient(ENERGY_BACKLIGHT, 40.0f);
+
+    meter.add(ENERGY_CPU_MIN, 360000);       // 2 mAh
+    meter.add(ENERGY_LIGHT_SLEEP, 3240000);  // 0.9 mAh
+    meter.add(ENERGY_WIFI_TX, 18000);        // 1 mAh
+    meter.add(ENERGY_WIFI_IDLE, 3600000);    // 2 mAh
+    meter.add(ENERGY_BACKLIGHT, 90000);      // 1 mAh
+
+    EnergyReport report = meter.getReport();
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 2.9f, report.subsystemMah[ENERGY_SUBSYSTEM_CPU]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 3.0f, report.subsystemMah[ENERGY_SUBSYSTEM_WIFI]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, report.subsystemMah[ENERGY_SUBSYSTEM_DISPLAY]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, report.subsystemMah[ENERGY_SUBSYSTEM_SENSORS]);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 6.9f, meter.getTotalMah());
+    TEST_ASSERT_EQUAL_UINT32(3600000, report.windowMs);
+}
+
+// Test: reset clears the totals but keeps the coefficients; bad input is ignored
+void test_reset_keeps_coefficients() {
+    EnergyMeter meter;
+    float defaultSleep = meter.getCoefficient(ENERGY_LIGHT_SLEEP);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, ENERGY_MA_LIGHT_SLEEP, defaultSleep);
+
+    meter.setCoefficient(ENERGY_SENSORS, 3.0f);
+    meter.setCoefficient(ENERGY_SENSORS, -1.0f);
+    meter.add(ENERGY_SENSORS, 1200000);
+    meter.add(NUM_ENERGY_STATES, 1000);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.0f, meter.getMah(ENERGY_SUBSYSTEM_SENSORS));
+
+    meter.reset();
+    TEST_ASSERT_EQUAL_UINT32(0, meter.getStateMs(ENERGY_SENSORS));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 3.0f, meter.getCoefficient(ENERGY_SENSORS));
+    TEST_ASSERT_EQUAL_STRING("wifi_idle", EnergyMeter::stateKey(ENERGY_WIFI_IDLE));
+    TEST_ASSERT_EQUAL_STRING("display", EnergyMeter::subsystemKey(ENERGY_SUBSYSTEM_DISPLAY));
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_state_time_becomes_mah);
+    RUN_TEST(test_subsystems_and_report);
+    RUN_TEST(test_reset_keeps_coefficients);
+
+    return UNITY_END();
+}
@@ -0,0 +1,153 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include <string>
+
+#include "ErrorLogger.h"
+#include "LoggingMacros.h"
+
+static std::string drainAll() {
+    std::string text;
+    char chunk[37];  // Odd size, so reads split records and wrap the ring
+    size_t length;
+    while ((length = ErrorLogger::read(chunk, sizeof(chunk))) > 0) {
+        text.append(chunk, length);
+    }
+    return text;
+}
+
+// Test: a record is formatted once with its timestamp, level, type and context
+void test_record_format() {
+    mockMillis = 3723045;  // 01:02:03.045
+    ErrorLogger::error(ErrorType::NETWORK, "Upload failed", "sendData");
+    ErrorLogger::info(ErrorType::SENSOR, "BME280 ready");
+
+    TEST_ASSERT_EQUAL_STRING(
+        "[01:02:03.045] [ERROR] [NETWORK] Upload failed (sendData)\r\n"
+        "[01:02:03.045] [INFO] [SENSOR] BME280 ready\r\n",
+        drainAll().c_str());
+}
+
+// Test: the runtime level drops records below it, and LOG_DEBUG is compiled out
+void test_level_filtering() {
+    mockMillis = 1000;
+    ErrorLogger::setMinLevel(ErrorLevel::WARNING);
+    ErrorLogger::info(ErrorType::SYSTEM, "hidden");
+    LOG_INFO("hidden %d", 1);
+    LOG_WARN("shown %d", 2);
+
+    int evaluated = 0;
+    LOG_DEBUG("never %d", ++evaluated);
+    TEST_ASSERT_EQUAL(0, evaluated);
+
+    TEST_ASSERT_EQUAL_STRING("[00:00:01.000] [WARN] [SYSTEM] shown 2\r\n", drainAll().c_str());
+}
+
+// Test: a full ring drops whole records, and draining makes room again
+void test_full_ring_drops_whole_records() {
+    mockMillis = 1000;
+    char message[100];
+    memset(message, 'x', sizeof(message) - 1);
+    message[sizeof(message) - 1] = '\0';
+
+    for (int i = 0; i < 40; i++) {
+        ErrorLogger::warning(ErrorType::MEMORY, message);
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(0, ErrorLogger::getDroppedCount());
+
+    std::string text = drainAll();
+    size_t recordLength = strlen("[00:00:01.000] [WARN] [MEMORY] ") + strlen(message) + 2;
+    TEST_ASSERT_EQUAL(0, text.size() % recordLength);
+    TEST_ASSERT_EQUAL(40 - ErrorLogger::getDroppedCount(), text.size() / recordLength);
+
+    ErrorLogger::critical(ErrorType::SYSTEM, "after");
+    TEST_ASSERT_EQUAL_STRING("[00:00:01.000] [CRIT] [SYSTEM] after\r\n", drainAll().c_str());
+}
+
+// Test: text longer than a record is cut, keeping the line end
+void test_long_message_is_cut() {
+    char message[LOG_LINE_MAX * 2];
+    memset(message, 'y', sizeof(message) - 1);
+    message[sizeof(message) - 1] = '\0';
+    ErrorLogger::info(ErrorType::SYSTEM, message);
+
+    std::string text = drainAll();
+    TEST_ASSERT_EQUAL(LOG_LINE_MAX - 1, text.size());
+    TEST_ASSERT_EQUAL_STRING("\r\n", text.substr(text.size() - 2).c_str());
+}
+
+// Test: after a watchdog reset the last records are kept, oldest first, tagged by boot
+void test_post_mortem_kept_after_watchdog_reset() {
+    ErrorLogger::beginPostMortem(RESET_POWERON);
+    mockMillis = 1000;
+    ErrorLogger::info(ErrorType::SENSOR, "slept");
+    ErrorLogger::beginPostMortem(RESET_DEEPSLEEP);  // A wake keeps recording
+    TEST_ASSERT_FALSE(ErrorLogger::hasPostMortem());
+
+    mockMillis = 2000;
+    for (int i = 0; i < POSTMORTEM_ENTRIES; i++) {
+        ErrorLogger::logf(ErrorLevel::WARNING, ErrorType::NETWORK, "Upload \"%d\" stalled", i);
+    }
+    TEST_ASSERT_TRUE(ErrorLogger::beginPostMortem(RESET_TASK_WDT));
+    drainAll();
+
+    TEST_ASSERT_TRUE(ErrorLogger::hasPostMortem());
+    TEST_ASSERT_EQUAL(RESET_TASK_WDT, ErrorLogger::getPostMortemReason());
+    TEST_ASSERT_EQUAL_STRING("task_wdt", ErrorLogger::resetReasonKey(RESET_TASK_WDT));
+    TEST_ASSERT_EQUAL(POSTMORTEM_ENTRIES, ErrorLogger::getPostMortemCount());
+
+    // The record from the earlier boot was pushed out; quotes are replaced
+    const PostMortemEntry& oldest = ErrorLogger::getPostMortemEntry(0);
+    TEST_ASSERT_EQUAL_STRING("Upload '0' stalled", oldest.text);
+    TEST_ASSERT_EQUAL(0, oldest.boot);
+    TEST_ASSERT_EQUAL_UINT32(2000, oldest.timeMs);
+    TEST_ASSERT_EQUAL(static_cast<uint8_t>(ErrorLevel::WARNING), oldest.level);
+
+    // Records after the reset do not touch the kept log; a sleep wake keeps it pending
+    ErrorLogger::info(ErrorType::SYSTEM, "rebooted");
+    TEST_ASSERT_FALSE(ErrorLogger::beginPostMortem(RESET_DEEPSLEEP));
+    TEST_ASSERT_EQUAL(POSTMORTEM_ENTRIES, ErrorLogger::getPostMortemCount());
+
+    ErrorLogger::clearPostMortem();
+    TEST_ASSERT_FALSE(ErrorLogger::hasPostMortem());
+}
+
+// Test: a power-on discards the ring, and long text is cut to the entry size
+void test_post_mortem_power_on_and_cut() {
+    ErrorLogger::beginPostMortem(RESET_POWERON);
+    ErrorLogger::error(ErrorType::STORAGE, "NVS commit failed after three retries");
+    ErrorLogger::beginPostMortem(RESET_POWERON);
+    TEST_ASSERT_FALSE(ErrorLogger::beginPostMortem(RESET_PANIC));
+
+    ErrorLogger::error(ErrorType::STORAGE, "NVS commit failed after three retries");
+    ErrorLogger::beginPostMortem(RESET_DEEPSLEEP);
+    TEST_ASSERT_TRUE(ErrorLogger::beginPostMortem(RESET_PANIC));
+    drainAll();
+
+    TEST_ASSERT_EQUAL(1, ErrorLogger::getPostMortemCount());
+    const PostMortemEntry& entry = ErrorLogger::getPostMortemEntry(0);
+    TEST_ASSERT_EQUAL(1, entry.boot);  // Logged one boot before the one that reset
+    TEST_ASSERT_EQUAL(POSTMORTEM_TEXT_LENGTH - 1, strlen(entry.text));
+    TEST_ASSERT_EQUAL(0, strncmp("NVS commit failed", entry.text, 17));
+    ErrorLogger::clearPostMortem();
+}
+
+void setUp(void) {
+    ErrorLogger::clear();
+}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_record_format);
+    RUN_TEST(test_level_filtering);
+    RUN_TEST(test_full_ring_drops_whole_records);
+    RUN_TEST(test_long_message_is_cut);
+    RUN_TEST(test_post_mortem_kept_after_watchdog_reset);
+    RUN_TEST(test_post_mortem_power_on_and_cut);
+
+    return UNITY_END();
+}
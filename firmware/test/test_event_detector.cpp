@@ -0,0 +1,128 @@
+#include <unity.h>
+
+#include "EventDetector.h"
+
+static SensorReadings makeReading(uint32_t timeMs, float soil) {
+    SensorReadings readings = {};
+    readings.monotonicMs = timeMs;
+    readings.soilMoisture = soil;
+    readings.bme280Temp = 21.0f;
+    readings.sensorStatus = (1 << SENSOR_SOIL_BIT) | (1 << SENSOR_BME280_BIT);
+    return readings;
+}
+
+static EventDetector makeDetector() {
+    EventDetector detector;
+    detector.configure(30.0f, 70.0f);
+    return detector;
+}
+
+// Test: the first reading only sets the zone, even when it is outside the thresholds
+void test_first_reading_sets_zone() {
+    EventDetector detector = makeDetector();
+    TEST_ASSERT_EQUAL_UINT8(SOIL_EVENT_NONE, detector.addReading(makeReading(0, 20.0f)));
+    TEST_ASSERT_EQUAL_INT8(-1, detector.getZone());
+}
+
+// Test: crossing the low threshold raises one event; leaving takes the hysteresis
+void test_low_crossing_with_hysteresis() {
+    EventDetector detector = makeDetector();
+    detector.addReading(makeReading(0, 32.0f));
+
+    TEST_ASSERT_EQUAL_UINT8(SOIL_EVENT_LOW, detector.addReading(makeReading(60000, 29.5f)));
+    TEST_ASSERT_EQUAL_UINT8(SOIL_EVENT_NONE, detector.addReading(makeReading(120000, 30.5f)));
+    TEST_ASSERT_EQUAL_UINT8(SOIL_EVENT_NONE, detector.addReading(makeReading(180000, 29.8f)));
+    TEST_ASSERT_EQUAL_INT8(-1, detector.getZone());
+
+    TEST_ASSERT_EQUAL_UINT8(SOIL_EVENT_NORMAL, detector.addReading(makeReading(240000, 33.0f)));
+    TEST_ASSERT_EQUAL_INT8(0, detector.getZone());
+}
+
+// Test: crossing the high threshold, and back inside past the hysteresis
+void test_high_crossing() {
+    EventDetector detector = makeDetector();
+    detector.addReading(makeReading(0, 68.0f));
+
+    TEST_ASSERT_EQUAL_UINT8(SOIL_EVENT_HIGH, detector.addReading(makeReading(60000, 71.0f)));
+    TEST_ASSERT_EQUAL_UINT8(SOIL_EVENT_NONE, detector.addReading(makeReading(120000, 68.0f)));
+    TEST_ASSERT_EQUAL_UINT8(SOIL_EVENT_NORMAL, detector.addReading(makeReading(180000, 66.0f)));
+}
+
+// Test: a fast change raises one event, re-armed once the rate drops and the gap passed
+void test_fast_change_rearms() {
+    EventDetector detector = makeDetector();
+    detector.addReading(makeReading(0, 40.0f));
+
+    TEST_ASSERT_EQUAL_UINT8(SOIL_EVENT_FAST, detector.addReading(makeReading(60000, 46.0f)));
+    TEST_ASSERT_EQUAL_UINT8(SOIL_EVENT_NONE, detector.addReading(makeReading(120000, 52.0f)));
+    TEST_ASSERT_EQUAL_UINT8(SOIL_EVENT_NONE, detector.addReading(makeReading(180000, 53.0f)));
+    TEST_ASSERT_EQUAL_UINT8(SOIL_EVENT_FAST, detector.addReading(makeReading(240000, 47.0f)));
+}
+
+// Test: a fast drop into the low zone raises both events in one reading
+void test_fast_drop_into_low_zone() {
+    EventDetector detector = makeDetector();
+    detector.addReading(makeReading(0, 36.0f));
+    TEST_ASSERT_EQUAL_UINT8(SOIL_EVENT_LOW | SOIL_EVENT_FAST,
+                            detector.addReading(makeReading(60000, 28.0f)));
+}
+
+// Test: stale soil values are skipped
+void test_stale_value_skipped() {
+    EventDetector detector = makeDetector();
+    detector.addReading(makeReading(0, 40.0f));
+    SensorReadings stale = makeReading(60000, 20.0f);
+    stale.staleMask = 1 << SENSOR_SOIL_BIT;
+    TEST_ASSERT_EQUAL_UINT8(SOIL_EVENT_NONE, detector.addReading(stale));
+    TEST_ASSERT_EQUAL_INT8(0, detector.getZone());
+}
+
+// Test: the zone carries across deep sleep, so the wake reading still raises its event
+void test_zone_restored_after_sleep() {
+    EventDetector before = makeDetector();
+    before.addReading(makeReading(0, 40.0f));
+    before.saveForSleep();
+
+    EventDetector after = makeDetector();
+    TEST_ASSERT_TRUE(after.restoreAfterSleep());
+    TEST_ASSERT_EQUAL_UINT8(SOIL_EVENT_LOW, after.addReading(makeReading(500, 25.0f)));
+
+    EventDetector again = makeDetector();
+    TEST_ASSERT_FALSE(again.restoreAfterSleep());  // One-shot
+}
+
+// Test: the event window is the reading itself
+void test_to_window() {
+    SensorReadings readings = makeReading(90000, 28.0f);
+    AveragedData window;
+    EventDetector::toWindow(readings, window);
+
+    TEST_ASSERT_EQUAL_FLOAT(28.0f, window.avgSoilMoisture);
+    TEST_ASSERT_EQUAL_FLOAT(28.0f, window.soilMoistureSpread.min);
+    TEST_ASSERT_EQUAL_FLOAT(21.0f, window.avgBme280Temp);
+    TEST_ASSERT_EQUAL_UINT16(1, window.sampleCount);
+    TEST_ASSERT_EQUAL_UINT16(1, window.soilSampleCount);
+    TEST_ASSERT_EQUAL_UINT16(0, window.ds18b20SampleCount);
+    TEST_ASSERT_EQUAL_UINT32(90000, window.sampleStartUptimeMs);
+    TEST_ASSERT_EQUAL_UINT32(90000, window.sampleEndUptimeMs);
+    TEST_ASSERT_EQUAL_UINT32(0, window.sequence);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_first_reading_sets_zone);
+    RUN_TEST(test_low_crossing_with_hysteresis);
+    RUN_TEST(test_high_crossing);
+    RUN_TEST(test_fast_change_rearms);
+    RUN_TEST(test_fast_drop_into_low_zone);
+    RUN_TEST(test_stale_value_skipped);
+    RUN_TEST(test_zone_restored_after_sleep);
+    RUN_TEST(test_to_window);
+
+    return UNITY_END();
+}
@@ -0,0 +1,226 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include <string>
+
+#include "Crc32.h"
+#include "DataManager.h"
+#include "GzipStream.h"
+#include "PayloadStream.h"
+
+static AveragedData makeWindow(uint32_t start) {
+    AveragedData data = {};
+    data.avgBme280Temp = 22.5f + (start % 7000) / 1000.0f;
+    data.avgHumidity = 45.25f;
+    data.sensorStatus = (1 << static_cast<uint8_t>(SensorType::BME280_TEMP)) |
+                        (1 << static_cast<uint8_t>(SensorType::HUMIDITY));
+    data.sampleStartUptimeMs = start;
+    data.sampleEndUptimeMs = start + 1000;
+    data.uptimeMs = start + 1000;
+    data.sampleCount = 20;
+    return data;
+}
+
+template <typename S>
+static std::string readAll(S& stream, size_t chunkSize) {
+    std::string body;
+    char chunk[64];
+    size_t length;
+    while ((length = stream.readBytes(chunk, chunkSize)) > 0) {
+        body.append(chunk, length);
+    }
+    return body;
+}
+
+static uint32_t readLe32(const std::string& data, size_t pos) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < 4; i++) {
+        value |= uint32_t(static_cast<uint8_t>(data[pos + i])) << (8 * i);
+    }
+    return value;
+}
+
+// Minimal inflater for single fixed-Huffman blocks, enough to round-trip the encoder
+struct BitReader {
+    const std::string& data;
+    size_t pos;
+    uint8_t bit;
+
+    uint32_t bits(uint8_t count) {
+        uint32_t value = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            uint8_t byte = static_cast<uint8_t>(data[pos]);
+            value |= uint32_t((byte >> bit) & 1) << i;
+            if (++bit == 8) {
+                bit = 0;
+                pos++;
+            }
+        }
+        return value;
+    }
+
+    // Huffman codes arrive MSB-first
+    uint32_t code(uint8_t count) {
+        uint32_t value = 0;
+        for (uint8_t i = 0; i < count; i++) {
+            value = (value << 1) | bits(1);
+        }
+        return value;
+    }
+};
+
+static bool inflateFixed(const std::string& deflate, std::string& out) {
+    static const uint16_t lengthBase[29] = {3,  4,  5,  6,  7,  8,  9,   10,  11,  13,
+                                            15, 17, 19, 23, 27, 31, 35,  43,  51,  59,
+                                            67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const uint8_t lengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2,
+                                            2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const uint16_t distanceBase[30] = {
+        1,   2,   3,   4,   5,   7,    9,    13,   17,   25,   33,   49,   65,    97,    129,
+        193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+
+    BitReader reader{deflate, 0, 0};
+    if (reader.bits(1) != 1 || reader.bits(2) != 1) {
+        return false;  // Expect BFINAL with fixed codes
+    }
+    while (reader.pos < deflate.size()) {
+        uint32_t symbol = reader.code(7);
+        if (symbol <= 0x17) {
+            symbol += 256;
+        } else {
+            symbol = (symbol << 1) | reader.bits(1);
+            if (symbol >= 0x30 && symbol <= 0xBF) {
+                symbol -= 0x30;
+            } else if (symbol >= 0xC0 && symbol <= 0xC7) {
+                symbol = symbol - 0xC0 + 280;
+            } else {
+                symbol = ((symbol << 1) | reader.bits(1)) - 0x190 + 144;
+            }
+        }
+
+        if (symbol < 256) {
+            out += static_cast<char>(symbol);
+        } else if (symbol == 256) {
+            return true;
+        } else {
+            uint8_t index = symbol - 257;
+            if (index >= 29) {
+                return false;
+            }
+            size_t length = lengthBase[index] + reader.bits(lengthExtra[index]);
+            uint8_t distanceCode = reader.code(5);
+            if (distanceCode >= 30) {
+                return false;
+            }
+            size_t distance = distanceBase[distanceCode] + reader.bits(distanceCode < 4
+                                                                           ? 0
+                                                                           : distanceCode / 2 - 1);
+            if (distance > out.size()) {
+                return false;
+            }
+            for (size_t i = 0; i < length; i++) {
+                out += out[out.size() - distance];
+            }
+        }
+    }
+    return false;
+}
+
+static SystemStatus status;
+
+// Test: Content-Length from the dry pass matches the streamed body, and rewind replays it
+void test_content_length_matches_body() {
+    DataManager dataManager;
+    for (uint32_t i = 0; i < 10; i++) {
+        dataManager.bufferForTransmission(makeWindow(i * 1000));
+    }
+    PayloadStream payload;
+    payload.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", status);
+
+    GzipStream gzip;
+    gzip.begin(payload);
+    std::string first = readAll(gzip, 7);
+    gzip.rewind();
+    std::string second = readAll(gzip, 64);
+
+    TEST_ASSERT_EQUAL(gzip.contentLength(), first.size());
+    TEST_ASSERT_TRUE(first == second);
+    TEST_ASSERT_EQUAL(0, gzip.available());
+}
+
+// Test: gzip framing, and the deflate data inflates back to the identical body
+void test_body_round_trips() {
+    DataManager dataManager;
+    for (uint32_t i = 0; i < 45; i++) {
+        dataManager.bufferForTransmission(makeWindow(i * 1000));
+    }
+    AveragedData current = makeWindow(90000);
+    PayloadStream payload;
+    payload.begin(dataManager.getBufferedBatch(), &current, "dev-1", status);
+    std::string plain = readAll(payload, 64);
+
+    GzipStream gzip;
+    gzip.begin(payload);
+    std::string body = readAll(gzip, 64);
+
+    TEST_ASSERT_EQUAL_HEX8(0x1F, static_cast<uint8_t>(body[0]));
+    TEST_ASSERT_EQUAL_HEX8(0x8B, static_cast<uint8_t>(body[1]));
+    TEST_ASSERT_EQUAL_HEX8(0x08, static_cast<uint8_t>(body[2]));
+    TEST_ASSERT_EQUAL_HEX32(crc32Update(plain.data(), plain.size()),
+                            readLe32(body, body.size() - 8));
+    TEST_ASSERT_EQUAL(plain.size(), readLe32(body, body.size() - 4));
+    TEST_ASSERT_EQUAL(plain.size(), gzip.uncompressedLength());
+
+    std::string inflated;
+    TEST_ASSERT_TRUE(inflateFixed(body.substr(10, body.size() - 18), inflated));
+    TEST_ASSERT_TRUE(inflated == plain);
+}
+
+// Test: repeated JSON keys compress several times over
+void test_rows_body_compresses() {
+    DataManager dataManager;
+    for (uint32_t i = 0; i < 45; i++) {
+        dataManager.bufferForTransmission(makeWindow(i * 1000));
+    }
+    PayloadStream payload;
+    payload.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", status);
+
+    GzipStream gzip;
+    gzip.begin(payload);
+
+    TEST_ASSERT_TRUE(gzip.contentLength() * 4 < payload.contentLength());
+}
+
+// Test: an empty source still yields a valid member with an empty block
+void test_empty_source() {
+    DataManager dataManager;
+    PayloadStream payload;
+    payload.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", status);
+    std::string plain = readAll(payload, 64);
+
+    GzipStream gzip;
+    gzip.begin(payload);
+    std::string body = readAll(gzip, 64);
+
+    std::string inflated;
+    TEST_ASSERT_TRUE(inflateFixed(body.substr(10, body.size() - 18), inflated));
+    TEST_ASSERT_TRUE(inflated == plain);
+}
+
+void setUp(void) {
+    status = SystemStatus();
+}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_content_length_matches_body);
+    RUN_TEST(test_body_round_trips);
+    RUN_TEST(test_rows_body_compresses);
+    RUN_TEST(test_empty_source);
+
+    return UNITY_END();
+}
@@ -0,0 +1,44 @@
+#include <unity.h>
+
+#include "HeapTrace.h"
+
+// Test: each pass reports its own allocations, and the busiest pass is kept
+void test_pass_counts_and_maximum() {
+    HeapTrace::recordAllocation(100);
+    HeapTrace::recordAllocation(28);
+    HeapTrace::recordFree();
+    HeapTrace::endPass();
+    TEST_ASSERT_EQUAL_UINT32(2, HeapTrace::getLastPassAllocations());
+    TEST_ASSERT_EQUAL_UINT32(128, HeapTrace::getLastPassBytes());
+
+    HeapTrace::recordAllocation(16);
+    HeapTrace::endPass();
+    TEST_ASSERT_EQUAL_UINT32(1, HeapTrace::getLastPassAllocations());
+    TEST_ASSERT_EQUAL_UINT32(2, HeapTrace::getMaxPassAllocations());
+    TEST_ASSERT_EQUAL_INT32(2, HeapTrace::getOutstanding());
+
+    HeapTrace::endPass();  // A pass that allocates nothing
+    TEST_ASSERT_EQUAL_UINT32(0, HeapTrace::getLastPassAllocations());
+    TEST_ASSERT_EQUAL_UINT32(2, HeapTrace::getMaxPassAllocations());
+}
+
+// Test: without the IDF hooks compiled in, tracing reports itself off
+void test_disabled_without_hooks() {
+    TEST_ASSERT_FALSE(HeapTrace::isEnabled());
+    TEST_ASSERT_EQUAL_UINT32(0, HeapTrace::getMaxPassAllocations());
+}
+
+void setUp(void) {
+    HeapTrace::reset();
+}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_pass_counts_and_maximum);
+    RUN_TEST(test_disabled_without_hooks);
+
+    return UNITY_END();
+}
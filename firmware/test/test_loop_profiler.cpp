@@ -0,0 +1,74 @@
+#include <unity.h>
+
+#include "LoopProfiler.h"
+
+// Test: durations land in log-scale buckets, the last one open-ended
+void test_bucket_boundaries() {
+    TEST_ASSERT_EQUAL(0, LoopProfiler::bucketFor(0));
+    TEST_ASSERT_EQUAL(0, LoopProfiler::bucketFor(15));
+    TEST_ASSERT_EQUAL(1, LoopProfiler::bucketFor(16));
+    TEST_ASSERT_EQUAL(2, LoopProfiler::bucketFor(64));
+    TEST_ASSERT_EQUAL(3, LoopProfiler::bucketFor(1000));     // 1 ms: [256 us, 1024 us)
+    TEST_ASSERT_EQUAL(8, LoopProfiler::bucketFor(1000000));  // 1 s
+    TEST_ASSERT_EQUAL(LOOP_HISTOGRAM_BUCKETS - 1, LoopProfiler::bucketFor(30000000));
+}
+
+// Test: time entered several times in one pass is one sample, recorded at endPass()
+void test_pass_accumulates_phase_time() {
+    for (uint32_t reading = 0; reading < 3; reading++) {
+        LoopProfiler::start(LOOP_PHASE_SENSORS, 1000 + reading * 100);
+        LoopProfiler::finish(LOOP_PHASE_SENSORS, 1040 + reading * 100);
+    }
+    LoopProfiler::finish(LOOP_PHASE_WIFI, 5000);  // Never started: ignored
+    TEST_ASSERT_EQUAL_UINT32(0, LoopProfiler::stats(LOOP_PHASE_SENSORS).count);
+
+    LoopProfiler::endPass();
+    const LoopPhaseStats& sensors = LoopProfiler::stats(LOOP_PHASE_SENSORS);
+    TEST_ASSERT_EQUAL_UINT32(1, sensors.count);
+    TEST_ASSERT_EQUAL_UINT32(120, sensors.lastUs);
+    TEST_ASSERT_EQUAL_UINT32(1, sensors.buckets[LoopProfiler::bucketFor(120)]);
+    TEST_ASSERT_EQUAL_UINT32(0, LoopProfiler::stats(LOOP_PHASE_WIFI).count);
+
+    LoopProfiler::endPass();  // A pass without readings adds nothing
+    TEST_ASSERT_EQUAL_UINT32(1, LoopProfiler::stats(LOOP_PHASE_SENSORS).count);
+}
+
+// Test: p95 is a bucket bound capped at the worst case, which is kept since boot
+void test_percentile_and_worst_case() {
+    TEST_ASSERT_EQUAL_UINT32(0, LoopProfiler::percentileUs(LOOP_PHASE_PUBLISH, 95));
+
+    for (uint32_t i = 0; i < 99; i++) {
+        LoopProfiler::start(LOOP_PHASE_PUBLISH, 0);
+        LoopProfiler::finish(LOOP_PHASE_PUBLISH, 200);  // Bucket [64, 256)
+        LoopProfiler::endPass();
+    }
+    LoopProfiler::start(LOOP_PHASE_PUBLISH, 0);
+    LoopProfiler::finish(LOOP_PHASE_PUBLISH, 2500000);  // One blocking upload
+    LoopProfiler::endPass();
+
+    TEST_ASSERT_EQUAL_UINT32(256, LoopProfiler::percentileUs(LOOP_PHASE_PUBLISH, 95));
+    TEST_ASSERT_EQUAL_UINT32(2500000, LoopProfiler::percentileUs(LOOP_PHASE_PUBLISH, 100));
+
+    LoopPhaseSummary summary[NUM_LOOP_PHASES];
+    LoopProfiler::summarize(summary);
+    TEST_ASSERT_EQUAL_UINT32(256, summary[LOOP_PHASE_PUBLISH].p95Us);
+    TEST_ASSERT_EQUAL_UINT32(2500000, summary[LOOP_PHASE_PUBLISH].maxUs);
+    TEST_ASSERT_EQUAL_UINT32(0, summary[LOOP_PHASE_SLEEP].maxUs);
+    TEST_ASSERT_EQUAL_STRING("publish", LoopProfiler::phaseKey(LOOP_PHASE_PUBLISH));
+}
+
+void setUp(void) {
+    LoopProfiler::reset();
+}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_bucket_boundaries);
+    RUN_TEST(test_pass_accumulates_phase_time);
+    RUN_TEST(test_percentile_and_worst_case);
+
+    return UNITY_END();
+}
@@ -0,0 +1,101 @@
+#include <unity.h>
+
+#include "LoopScheduler.h"
+
+// Test: a periodic job is due once per period and keeps its phase after a late pass
+void test_periodic_keeps_phase() {
+    LoopScheduler scheduler;
+    scheduler.setPeriodic(LOOP_JOB_STATUS, 1000, 0);
+
+    TEST_ASSERT_FALSE(scheduler.isDue(LOOP_JOB_STATUS, 999));
+    TEST_ASSERT_TRUE(scheduler.isDue(LOOP_JOB_STATUS, 1000));
+    TEST_ASSERT_FALSE(scheduler.isDue(LOOP_JOB_STATUS, 1000));
+    TEST_ASSERT_TRUE(scheduler.isDue(LOOP_JOB_STATUS, 2300));  // 300 ms late
+    TEST_ASSERT_EQUAL_UINT32(700, scheduler.msUntilNext(2300));
+
+    // Re-registering the same period changes nothing
+    scheduler.setPeriodic(LOOP_JOB_STATUS, 1000, 2500);
+    TEST_ASSERT_EQUAL_UINT32(500, scheduler.msUntilNext(2500));
+}
+
+// Test: a pass more than a period late runs the job once, not once per missed period
+void test_periodic_skips_missed_runs() {
+    LoopScheduler scheduler;
+    scheduler.setPeriodic(LOOP_JOB_DISPLAY, 100, 0);
+
+    TEST_ASSERT_TRUE(scheduler.isDue(LOOP_JOB_DISPLAY, 1050));
+    TEST_ASSERT_FALSE(scheduler.isDue(LOOP_JOB_DISPLAY, 1050));
+    TEST_ASSERT_EQUAL_UINT32(100, scheduler.msUntilNext(1050));
+}
+
+// Test: a new period counts from the last run
+void test_period_change_counts_from_last_run() {
+    LoopScheduler scheduler;
+    scheduler.setPeriodic(LOOP_JOB_CONSOLE, 50, 0);
+    TEST_ASSERT_TRUE(scheduler.isDue(LOOP_JOB_CONSOLE, 50));
+
+    scheduler.setPeriodic(LOOP_JOB_CONSOLE, 100, 60);
+    TEST_ASSERT_FALSE(scheduler.isDue(LOOP_JOB_CONSOLE, 149));
+    TEST_ASSERT_TRUE(scheduler.isDue(LOOP_JOB_CONSOLE, 150));
+}
+
+// Test: a deadline runs once, and cancel() or a zero period removes a job
+void test_deadline_and_cancel() {
+    LoopScheduler scheduler;
+    scheduler.setDeadline(LOOP_JOB_PUBLISH, 5000);
+    TEST_ASSERT_TRUE(scheduler.isScheduled(LOOP_JOB_PUBLISH));
+    TEST_ASSERT_FALSE(scheduler.isDue(LOOP_JOB_PUBLISH, 4999));
+    TEST_ASSERT_TRUE(scheduler.isDue(LOOP_JOB_PUBLISH, 5000));
+    TEST_ASSERT_FALSE(scheduler.isScheduled(LOOP_JOB_PUBLISH));
+    TEST_ASSERT_FALSE(scheduler.isDue(LOOP_JOB_PUBLISH, 9000));
+
+    scheduler.setDeadline(LOOP_JOB_PUBLISH, 8000);
+    scheduler.cancel(LOOP_JOB_PUBLISH);
+    TEST_ASSERT_FALSE(scheduler.isDue(LOOP_JOB_PUBLISH, 9000));
+
+    scheduler.setPeriodic(LOOP_JOB_WIFI_CHECK, 1000, 0);
+    scheduler.setPeriodic(LOOP_JOB_WIFI_CHECK, 0, 0);
+    TEST_ASSERT_FALSE(scheduler.isScheduled(LOOP_JOB_WIFI_CHECK));
+}
+
+// Test: the idle time is the earliest job; deferrable jobs do not shorten a light sleep
+void test_ms_until_next() {
+    LoopScheduler scheduler;
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, scheduler.msUntilNext(0));
+
+    scheduler.setDeadline(LOOP_JOB_SENSING, 30000);
+    scheduler.setPeriodic(LOOP_JOB_CONSOLE, 100, 0, true);
+    TEST_ASSERT_EQUAL_UINT32(100, scheduler.msUntilNext(0));
+    TEST_ASSERT_EQUAL_UINT32(30000, scheduler.msUntilNext(0, false));
+
+    // An overdue job means no wait at all
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.msUntilNext(200));
+}
+
+// Test: deadlines compare across the millis() wrap
+void test_deadline_across_wrap() {
+    LoopScheduler scheduler;
+    unsigned long nearWrap = static_cast<unsigned long>(-100L);
+    scheduler.setDeadline(LOOP_JOB_SENSING, nearWrap + 300);
+
+    TEST_ASSERT_EQUAL_UINT32(300, scheduler.msUntilNext(nearWrap));
+    TEST_ASSERT_FALSE(scheduler.isDue(LOOP_JOB_SENSING, nearWrap + 299));
+    TEST_ASSERT_TRUE(scheduler.isDue(LOOP_JOB_SENSING, nearWrap + 300));
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_periodic_keeps_phase);
+    RUN_TEST(test_periodic_skips_missed_runs);
+    RUN_TEST(test_period_change_counts_from_last_run);
+    RUN_TEST(test_deadline_and_cancel);
+    RUN_TEST(test_ms_until_next);
+    RUN_TEST(test_deadline_across_wrap);
+
+    return UNITY_END();
+}
@@ -0,0 +1,90 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "MqttPacket.h"
+
+// Test: Remaining Length uses the 1-4 byte boundaries of MQTT 3.1.1 §2.2.3
+void test_remaining_length_boundaries() {
+    uint8_t out[4];
+
+    TEST_ASSERT_EQUAL(1, MqttPacket::encodeRemainingLength(0, out));
+    TEST_ASSERT_EQUAL_HEX8(0x00, out[0]);
+    TEST_ASSERT_EQUAL(1, MqttPacket::encodeRemainingLength(127, out));
+    TEST_ASSERT_EQUAL_HEX8(0x7F, out[0]);
+
+    TEST_ASSERT_EQUAL(2, MqttPacket::encodeRemainingLength(128, out));
+    TEST_ASSERT_EQUAL_HEX8(0x80, out[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, out[1]);
+    TEST_ASSERT_EQUAL(2, MqttPacket::encodeRemainingLength(16383, out));
+
+    TEST_ASSERT_EQUAL(3, MqttPacket::encodeRemainingLength(16384, out));
+    TEST_ASSERT_EQUAL(4, MqttPacket::encodeRemainingLength(2097152, out));
+    TEST_ASSERT_EQUAL(4, MqttPacket::encodeRemainingLength(MqttPacket::MAX_REMAINING_LENGTH, out));
+    TEST_ASSERT_EQUAL_HEX8(0x7F, out[3]);
+    TEST_ASSERT_EQUAL(0, MqttPacket::encodeRemainingLength(MqttPacket::MAX_REMAINING_LENGTH + 1,
+                                                           out));
+}
+
+// Test: CONNECT carries protocol level 4, a persistent session, keep alive and credentials
+void test_connect_packet_layout() {
+    uint8_t out[64];
+    size_t length = MqttPacket::buildConnect(out, sizeof(out), "dev1", "dev1", "tok", 60, false);
+
+    const uint8_t expected[] = {0x10, 27,  0,   4,   'M', 'Q', 'T', 'T', 4,   0xC0,
+                                0,    60,  0,   4,   'd', 'e', 'v', '1', 0,   4,
+                                'd',  'e', 'v', '1', 0,   3,   't', 'o', 'k'};
+    TEST_ASSERT_EQUAL(sizeof(expected), length);
+    TEST_ASSERT_EQUAL_MEMORY(expected, out, sizeof(expected));
+}
+
+// Test: no user name means no password either, and clean session sets its flag
+void test_connect_without_credentials() {
+    uint8_t out[64];
+    size_t length = MqttPacket::buildConnect(out, sizeof(out), "dev1", "", "tok", 30, true);
+
+    TEST_ASSERT_EQUAL(18, length);
+    TEST_ASSERT_EQUAL_HEX8(0x02, out[9]);
+    TEST_ASSERT_EQUAL(0, MqttPacket::buildConnect(out, 10, "dev1", nullptr, nullptr, 30, true));
+}
+
+// Test: QoS 1 PUBLISH header counts the streamed payload in its Remaining Length
+void test_publish_header() {
+    uint8_t out[32];
+    size_t length = MqttPacket::buildPublishHeader(out, sizeof(out), "a/b", 0x1234, 200, false);
+
+    // 2 + 3 topic + 2 packet ID + 200 payload = 207 -> two length bytes
+    const uint8_t expected[] = {0x32, 0xCF, 0x01, 0, 3, 'a', '/', 'b', 0x12, 0x34};
+    TEST_ASSERT_EQUAL(sizeof(expected), length);
+    TEST_ASSERT_EQUAL_MEMORY(expected, out, sizeof(expected));
+
+    MqttPacket::buildPublishHeader(out, sizeof(out), "a/b", 0x1234, 200, true);
+    TEST_ASSERT_EQUAL_HEX8(0x3A, out[0]);  // DUP on a resend
+}
+
+// Test: PINGREQ and DISCONNECT are two bytes
+void test_empty_packets() {
+    uint8_t out[2];
+
+    TEST_ASSERT_EQUAL(2, MqttPacket::buildEmpty(out, sizeof(out), MqttPacket::PINGREQ));
+    TEST_ASSERT_EQUAL_HEX8(0xC0, out[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, out[1]);
+    MqttPacket::buildEmpty(out, sizeof(out), MqttPacket::DISCONNECT);
+    TEST_ASSERT_EQUAL_HEX8(0xE0, out[0]);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_remaining_length_boundaries);
+    RUN_TEST(test_connect_packet_layout);
+    RUN_TEST(test_connect_without_credentials);
+    RUN_TEST(test_publish_header);
+    RUN_TEST(test_empty_packets);
+
+    return UNITY_END();
+}
@@ -0,0 +1,177 @@
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#include "DataManager.h"
+#include "OutboundQueue.h"
+
+// Host build keeps the queue under a scratch directory
+static const char* TEST_ROOT = "/tmp/outq_test";
+
+static void clearQueueFiles() {
+    char path[64];
+    snprintf(path, sizeof(path), "%s/meta", TEST_ROOT);
+    remove(path);
+    for (int id = 0; id < 64; id++) {
+        snprintf(path, sizeof(path), "%s/%d.seg", TEST_ROOT, id);
+        remove(path);
+    }
+}
+
+static PackedAveragedData makeRecord(uint32_t sequence) {
+    PackedAveragedData record = {};
+    record.sequence = sequence;
+    record.sampleStartUptimeMs = sequence * 1000;
+    record.sampleDurationMs = 1000;
+    return record;
+}
+
+static AveragedData makeWindow(uint32_t start) {
+    AveragedData data = {};
+    data.sampleStartUptimeMs = start;
+    data.sampleEndUptimeMs = start + 1000;
+    data.sampleCount = 20;
+    return data;
+}
+
+// Test: appends below the write batch stay staged but are visible to peek
+void test_appends_are_staged_until_batch_fills() {
+    OutboundQueue queue(TEST_ROOT);
+    TEST_ASSERT_TRUE(queue.begin());
+
+    for (uint32_t i = 1; i < OutboundQueue::WRITE_BATCH_RECORDS; i++) {
+        TEST_ASSERT_TRUE(queue.append(makeRecord(i)));
+    }
+
+    OutboundQueueStats stats = queue.getStats();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.flushes);
+    TEST_ASSERT_EQUAL_UINT16(0, stats.segmentCount);
+    TEST_ASSERT_EQUAL_UINT32(OutboundQueue::WRITE_BATCH_RECORDS - 1, queue.size());
+
+    PackedAveragedData page[4];
+    TEST_ASSERT_EQUAL_UINT16(4, queue.peek(page, 4));
+    TEST_ASSERT_EQUAL_UINT32(1, page[0].sequence);
+    TEST_ASSERT_EQUAL_UINT32(4, page[3].sequence);
+
+    // The record that fills the batch triggers one flash write
+    queue.append(makeRecord(OutboundQueue::WRITE_BATCH_RECORDS));
+    stats = queue.getStats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.flushes);
+    TEST_ASSERT_EQUAL_UINT16(1, stats.segmentCount);
+    TEST_ASSERT_EQUAL_UINT32(OutboundQueue::WRITE_BATCH_RECORDS, queue.size());
+}
+
+// Test: drain is oldest-first across segments and drained segments are deleted
+void test_drain_oldest_first_and_collect_segments() {
+    OutboundQueue queue(TEST_ROOT);
+    queue.begin();
+
+    const uint32_t total = OutboundQueue::RECORDS_PER_SEGMENT + 20;
+    for (uint32_t i = 1; i <= total; i++) {
+        queue.append(makeRecord(i));
+    }
+    queue.flush();
+    TEST_ASSERT_EQUAL_UINT16(2, queue.getStats().segmentCount);
+
+    PackedAveragedData page[16];
+    uint32_t expected = 1;
+    while (!queue.isEmpty()) {
+        uint16_t count = queue.peek(page, 16);
+        TEST_ASSERT_TRUE(count > 0);
+        for (uint16_t i = 0; i < count; i++) {
+            TEST_ASSERT_EQUAL_UINT32(expected++, page[i].sequence);
+        }
+        queue.commit(count);
+    }
+
+    OutboundQueueStats stats = queue.getStats();
+    TEST_ASSERT_EQUAL_UINT32(total + 1, expected);
+    TEST_ASSERT_EQUAL_UINT32(total, stats.drainedRecords);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.segmentsCollected);
+    TEST_ASSERT_EQUAL_UINT16(0, stats.segmentCount);
+}
+
+// Test: cursor and flushed records survive a restart
+void test_cursor_survives_restart() {
+    {
+        OutboundQueue queue(TEST_ROOT);
+        queue.begin();
+        for (uint32_t i = 1; i <= 40; i++) {
+            queue.append(makeRecord(i));
+        }
+        queue.flush();
+
+        PackedAveragedData page[10];
+        queue.commit(queue.peek(page, 10));
+    }
+
+    OutboundQueue reopened(TEST_ROOT);
+    TEST_ASSERT_TRUE(reopened.begin());
+    TEST_ASSERT_EQUAL_UINT32(30, reopened.size());
+
+    PackedAveragedData first;
+    TEST_ASSERT_EQUAL_UINT16(1, reopened.peek(&first, 1));
+    TEST_ASSERT_EQUAL_UINT32(11, first.sequence);
+}
+
+// Test: when every segment is full the oldest segment is dropped
+void test_full_queue_drops_oldest_segment() {
+    OutboundQueue queue(TEST_ROOT);
+    queue.begin();
+
+    const uint32_t capacity =
+        (uint32_t)OutboundQueue::MAX_SEGMENTS * OutboundQueue::RECORDS_PER_SEGMENT;
+    for (uint32_t i = 1; i <= capacity + OutboundQueue::WRITE_BATCH_RECORDS; i++) {
+        queue.append(makeRecord(i));
+    }
+
+    OutboundQueueStats stats = queue.getStats();
+    TEST_ASSERT_EQUAL_UINT16(OutboundQueue::MAX_SEGMENTS, stats.segmentCount);
+    TEST_ASSERT_EQUAL_UINT32(OutboundQueue::RECORDS_PER_SEGMENT, stats.droppedRecords);
+
+    PackedAveragedData first;
+    queue.peek(&first, 1);
+    TEST_ASSERT_EQUAL_UINT32(OutboundQueue::RECORDS_PER_SEGMENT + 1, first.sequence);
+}
+
+// Test: the RAM ring spills evicted windows instead of counting an overflow
+void test_data_manager_spills_to_queue() {
+    OutboundQueue queue(TEST_ROOT);
+    queue.begin();
+
+    DataManager dm;
+    dm.setOverflowSink(OutboundQueue::spill, &queue);
+
+    for (uint32_t i = 0; i < 55; i++) {
+        dm.bufferForTransmission(makeWindow(i * 1000));
+    }
+
+    TEST_ASSERT_EQUAL_UINT16(0, dm.getBufferOverflowCount());
+    TEST_ASSERT_EQUAL_UINT32(10, queue.size());  // 45 stay in RAM
+
+    PackedAveragedData page[10];
+    TEST_ASSERT_EQUAL_UINT16(10, queue.peek(page, 10));
+    TEST_ASSERT_EQUAL_UINT32(1, page[0].sequence);
+    TEST_ASSERT_EQUAL_UINT32(10, page[9].sequence);
+    TEST_ASSERT_EQUAL_UINT32(11, dm.getBufferedBatch().at(0).sequence);
+}
+
+void setUp(void) {
+    clearQueueFiles();
+}
+
+void tearDown(void) {
+    clearQueueFiles();
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_appends_are_staged_until_batch_fills);
+    RUN_TEST(test_drain_oldest_first_and_collect_segments);
+    RUN_TEST(test_cursor_survives_restart);
+    RUN_TEST(test_full_queue_drops_oldest_segment);
+    RUN_TEST(test_data_manager_spills_to_queue);
+
+    return UNITY_END();
+}
@@ -0,0 +1,453 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include <string>
+
+#include "DataManager.h"
+#include "ErrorLogger.h"
+#include "PayloadStream.h"
+
+static AveragedData makeWindow(uint32_t start) {
+    AveragedData data = {};
+    data.avgBme280Temp = 22.5f;
+    data.avgHumidity = 45.25f;
+    data.sensorStatus = (1 << static_cast<uint8_t>(SensorType::BME280_TEMP)) |
+                        (1 << static_cast<uint8_t>(SensorType::HUMIDITY));
+    data.sampleStartUptimeMs = start;
+    data.sampleEndUptimeMs = start + 1000;
+    data.uptimeMs = start + 1000;
+    data.sampleCount = 20;
+    return data;
+}
+
+static std::string readAll(PayloadStream& stream, size_t chunkSize) {
+    std::string body;
+    char chunk[64];
+    size_t length;
+    while ((length = stream.readBytes(chunk, chunkSize)) > 0) {
+        body.append(chunk, length);
+    }
+    return body;
+}
+
+static size_t countOf(const std::string& text, const char* needle) {
+    size_t count = 0;
+    for (size_t pos = text.find(needle); pos != std::string::npos;
+         pos = text.find(needle, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+
+// Minimal CBOR walker: skips one well-formed item, returns false on malformed input
+static bool skipCborItem(const std::string& data, size_t& pos) {
+    if (pos >= data.size()) {
+        return false;
+    }
+    uint8_t initial = static_cast<uint8_t>(data[pos++]);
+    uint8_t major = initial >> 5;
+    uint8_t info = initial & 0x1F;
+    uint64_t value = info;
+    if (info >= 24 && info <= 27) {
+        size_t bytes = size_t(1) << (info - 24);
+        if (pos + bytes > data.size()) {
+            return false;
+        }
+        value = 0;
+        for (size_t i = 0; i < bytes; i++) {
+            value = (value << 8) | static_cast<uint8_t>(data[pos++]);
+        }
+    } else if (info > 27) {
+        return false;
+    }
+
+    switch (major) {
+        case 0:
+        case 1:
+        case 7:
+            return true;
+        case 2:
+        case 3:
+            pos += value;
+            return pos <= data.size();
+        case 4:
+            for (uint64_t i = 0; i < value; i++) {
+                if (!skipCborItem(data, pos)) {
+                    return false;
+                }
+            }
+            return true;
+        case 5:
+            for (uint64_t i = 0; i < 2 * value; i++) {
+                if (!skipCborItem(data, pos)) {
+                    return false;
+                }
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+static SystemStatus status;
+
+// Test: the dry-pass length matches the streamed body and the envelope is complete
+void test_content_length_matches_body() {
+    DataManager dataManager;
+    for (uint32_t i = 0; i < 5; i++) {
+        dataManager.bufferForTransmission(makeWindow(i * 1000));
+    }
+    AveragedData current = makeWindow(9000);
+    status.metricsDue = false;  // Data only
+
+    PayloadStream stream;
+    stream.begin(dataManager.getBufferedBatch(), &current, "dev-1", status);
+    std::string body = readAll(stream, 7);
+
+    TEST_ASSERT_FALSE(stream.overflowed());
+    TEST_ASSERT_EQUAL_UINT16(6, stream.readingCount());
+    TEST_ASSERT_EQUAL(stream.contentLength(), body.size());
+    TEST_ASSERT_EQUAL(0, body.find("{\"device_id\":\"dev-1\",\"readings\":[{\"batch_id\""));
+    TEST_ASSERT_EQUAL(body.size() - 2, body.rfind("]}"));
+    TEST_ASSERT_EQUAL(6, countOf(body, "\"sample_count\":20"));
+    TEST_ASSERT_EQUAL(0, stream.available());
+}
+
+// Test: rewind replays the identical body for a retry
+void test_rewind_replays_body() {
+    DataManager dataManager;
+    dataManager.bufferForTransmission(makeWindow(0));
+    dataManager.bufferForTransmission(makeWindow(1000));
+
+    PayloadStream stream;
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", status);
+    std::string first = readAll(stream, 64);
+    stream.rewind();
+    std::string second = readAll(stream, 3);
+
+    TEST_ASSERT_TRUE(first == second);
+}
+
+// Test: the health block follows the readings once, and only while it is due
+void test_health_block_only_when_due() {
+    DataManager dataManager;
+    for (uint32_t i = 0; i < 3; i++) {
+        dataManager.bufferForTransmission(makeWindow(i * 1000));
+    }
+    status.freeHeap = 123456;
+
+    PayloadStream stream;
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", status);
+    std::string body = readAll(stream, 64);
+    TEST_ASSERT_EQUAL(1, countOf(body, "\"health\""));
+    TEST_ASSERT_TRUE(body.find("}],\"health\":{\"uptime_ms\":0,\"free_heap_bytes\":123456,") !=
+                     std::string::npos);
+    TEST_ASSERT_EQUAL(body.size() - 2, body.rfind("}}"));
+
+    status.metricsDue = false;
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", status);
+    body = readAll(stream, 64);
+    TEST_ASSERT_EQUAL(stream.contentLength(), body.size());
+    TEST_ASSERT_EQUAL(0, countOf(body, "\"health\""));
+    TEST_ASSERT_EQUAL(body.size() - 3, body.rfind("}]}"));
+
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", status,
+                 PayloadFormat::COLUMNAR);
+    body = readAll(stream, 64);
+    TEST_ASSERT_EQUAL(0, countOf(body, "\"health\""));
+    TEST_ASSERT_EQUAL(body.size() - 2, body.rfind("]}"));
+
+    // Map of 16 pairs without health
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", status, PayloadFormat::CBOR);
+    body = readAll(stream, 64);
+    TEST_ASSERT_EQUAL_HEX8(0xB0, static_cast<uint8_t>(body[0]));
+    size_t pos = 0;
+    TEST_ASSERT_TRUE(skipCborItem(body, pos));
+    TEST_ASSERT_EQUAL(body.size(), pos);
+    TEST_ASSERT_EQUAL(0, countOf(body, "health"));
+}
+
+// Test: values and nulls use the same formatting as the buffered String payload
+void test_reading_formatting() {
+    char buffer[PAYLOAD_SCRATCH_SIZE];
+    AveragedData data = makeWindow(100000);
+    size_t length = PayloadStream::formatReading(buffer, sizeof(buffer), data, "dev-1");
+    std::string reading(buffer, length);
+
+    TEST_ASSERT_EQUAL(strlen(buffer), length);
+    TEST_ASSERT_TRUE(reading.find("\"bme280_temp_c\":22.50,") != std::string::npos);
+    TEST_ASSERT_TRUE(reading.find("\"humidity_pct\":45.25,") != std::string::npos);
+    TEST_ASSERT_TRUE(reading.find("\"ds18b20_temp_c\":null") != std::string::npos);
+    TEST_ASSERT_TRUE(reading.find("\"sample_start_epoch_ms\":0,") != std::string::npos);
+    TEST_ASSERT_TRUE(reading.find("\"time_synced\":false") != std::string::npos);
+    TEST_ASSERT_TRUE(reading.find("\"ds18b20\":\"unavailable\"") != std::string::npos);
+    TEST_ASSERT_TRUE(reading.find("health") == std::string::npos);
+}
+
+// Test: a fragment that does not fit reports the full capacity instead of truncating silently
+void test_reading_overflow_is_reported() {
+    char buffer[64];
+    AveragedData data = makeWindow(0);
+    TEST_ASSERT_EQUAL(sizeof(buffer),
+                      PayloadStream::formatReading(buffer, sizeof(buffer), data, "dev-1"));
+    TEST_ASSERT_EQUAL(sizeof(buffer), PayloadStream::formatMetrics(buffer, sizeof(buffer), status));
+}
+
+// Test: columnar body writes one array per field and the header once
+void test_columnar_body_layout() {
+    DataManager dataManager;
+    for (uint32_t i = 0; i < 3; i++) {
+        dataManager.bufferForTransmission(makeWindow(i * 1000));
+    }
+
+    PayloadStream stream;
+    stream.setIdentity("AA:BB:CC:DD:EE:FF", "boot-1", "1.2.3");
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", status,
+                 PayloadFormat::COLUMNAR);
+    std::string body = readAll(stream, 5);
+
+    TEST_ASSERT_FALSE(stream.overflowed());
+    TEST_ASSERT_EQUAL(stream.contentLength(), body.size());
+    TEST_ASSERT_EQUAL(0, body.find("{\"schema\":\"columnar-v1\",\"device_id\":\"dev-1\","
+                                   "\"hardware_id\":\"AA:BB:CC:DD:EE:FF\",\"boot_id\":\"boot-1\","
+                                   "\"firmware_version\":\"1.2.3\",\"count\":3,"));
+    TEST_ASSERT_TRUE(body.find("\"seq\":[1,2,3],") != std::string::npos);
+    TEST_ASSERT_TRUE(body.find("\"sensor_mask\":[5,5,5],") != std::string::npos);
+    TEST_ASSERT_TRUE(body.find("\"bme280_temp_c\":[22.50,22.50,22.50],") != std::string::npos);
+    TEST_ASSERT_TRUE(body.find("\"ds18b20_temp_c\":[0,0,0],") != std::string::npos);
+    TEST_ASSERT_EQUAL(1, countOf(body, "\"health\""));
+    TEST_ASSERT_EQUAL(body.size() - 2, body.rfind("}}"));
+}
+
+// Test: a catch-up batch is several times smaller in the columnar schema
+void test_columnar_body_is_smaller() {
+    DataManager dataManager;
+    for (uint32_t i = 0; i < 50; i++) {
+        dataManager.bufferForTransmission(makeWindow(i * 1000));
+    }
+
+    PayloadStream stream;
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", status);
+    size_t rows = stream.contentLength();
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", status,
+                 PayloadFormat::COLUMNAR);
+    size_t columnar = stream.contentLength();
+
+    TEST_ASSERT_TRUE(columnar * 3 < rows);
+    TEST_ASSERT_EQUAL(columnar, readAll(stream, 64).size());
+}
+
+// Test: the CBOR body is one well-formed map with float32 sensor columns
+void test_cbor_body_is_well_formed() {
+    DataManager dataManager;
+    for (uint32_t i = 0; i < 3; i++) {
+        dataManager.bufferForTransmission(makeWindow(i * 1000));
+    }
+
+    PayloadStream stream;
+    stream.setIdentity("AA:BB:CC:DD:EE:FF", "boot-1", "1.2.3");
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", status, PayloadFormat::CBOR);
+    std::string body = readAll(stream, 5);
+
+    TEST_ASSERT_FALSE(stream.overflowed());
+    TEST_ASSERT_EQUAL_STRING("application/cbor", stream.contentType());
+    TEST_ASSERT_EQUAL(stream.contentLength(), body.size());
+
+    // Map of 17 pairs, first key "schema"
+    TEST_ASSERT_EQUAL_HEX8(0xB1, static_cast<uint8_t>(body[0]));
+    TEST_ASSERT_EQUAL(1, body.find("\x66schema\x6B" "columnar-v1"));
+
+    size_t pos = 0;
+    TEST_ASSERT_TRUE(skipCborItem(body, pos));
+    TEST_ASSERT_EQUAL(body.size(), pos);
+
+    // "bme280_temp_c": [22.5f, 22.5f, 22.5f] as float32 items
+    const char bme280[] =
+        "\x6D" "bme280_temp_c\x83\xFA\x41\xB4\x00\x00\xFA\x41\xB4\x00\x00\xFA\x41\xB4\x00\x00";
+    TEST_ASSERT_TRUE(body.find(std::string(bme280, sizeof(bme280) - 1)) != std::string::npos);
+    // Missing sensors are uint 0
+    const char ds18b20[] = "\x6E" "ds18b20_temp_c\x83\x00\x00\x00";
+    TEST_ASSERT_TRUE(body.find(std::string(ds18b20, sizeof(ds18b20) - 1)) != std::string::npos);
+}
+
+// Test: a pending boot profile lists finished phases in the health block, in JSON and CBOR
+void test_boot_profile_in_health_when_pending() {
+    DataManager dataManager;
+    dataManager.bufferForTransmission(makeWindow(0));
+    SystemStatus bootStatus = status;
+    bootStatus.bootProfile.phaseMs[BOOT_PHASE_SENSORS] = 812;
+    bootStatus.bootProfile.doneMask = 1 << BOOT_PHASE_SENSORS;
+    bootStatus.bootProfile.setupMs = 1450;
+
+    PayloadStream stream;
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", bootStatus);
+    TEST_ASSERT_EQUAL(0, countOf(readAll(stream, 64), "boot_phases_ms"));
+
+    bootStatus.bootProfilePending = true;
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", bootStatus);
+    std::string body = readAll(stream, 64);
+    TEST_ASSERT_EQUAL(stream.contentLength(), body.size());
+    TEST_ASSERT_EQUAL(1, countOf(body, "\"boot_phases_ms\":{\"sensors\":812,\"setup\":1450}}"));
+
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", bootStatus,
+                 PayloadFormat::CBOR);
+    body = readAll(stream, 64);
+    size_t pos = 0;
+    TEST_ASSERT_TRUE(skipCborItem(body, pos));
+    TEST_ASSERT_EQUAL(body.size(), pos);
+    TEST_ASSERT_EQUAL(1, countOf(body, "boot_phases_ms"));
+}
+
+// Test: the health block carries the charge per subsystem, in JSON and CBOR
+void test_energy_in_health() {
+    DataManager dataManager;
+    dataManager.bufferForTransmission(makeWindow(0));
+    SystemStatus energyStatus = status;
+    energyStatus.energy.subsystemMah[ENERGY_SUBSYSTEM_WIFI] = 1.25f;
+    energyStatus.energy.windowMs = 3600000;
+
+    PayloadStream stream;
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", energyStatus);
+    std::string body = readAll(stream, 64);
+    TEST_ASSERT_EQUAL(1, countOf(body, "\"energy_mah\":{\"cpu\":0.000,\"wifi\":1.250,"
+                                       "\"display\":0.000,\"sensors\":0.000},"
+                                       "\"energy_window_ms\":3600000"));
+
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", energyStatus,
+                 PayloadFormat::CBOR);
+    body = readAll(stream, 64);
+    size_t pos = 0;
+    TEST_ASSERT_TRUE(skipCborItem(body, pos));
+    TEST_ASSERT_EQUAL(body.size(), pos);
+    TEST_ASSERT_EQUAL(1, countOf(body, "energy_window_ms"));
+}
+
+// Test: the health block carries [p95, worst case] per loop() phase, in JSON and CBOR
+void test_loop_timing_in_health() {
+    DataManager dataManager;
+    dataManager.bufferForTransmission(makeWindow(0));
+    SystemStatus loopStatus = status;
+    loopStatus.loopPhases[LOOP_PHASE_PUBLISH].p95Us = 1024;
+    loopStatus.loopPhases[LOOP_PHASE_PUBLISH].maxUs = 2500000;
+
+    PayloadStream stream;
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", loopStatus);
+    std::string body = readAll(stream, 64);
+    TEST_ASSERT_EQUAL(1, countOf(body, "\"loop_us\":{\"status\":[0,0],\"sensors\":[0,0],"
+                                       "\"averaging\":[0,0],\"publish\":[1024,2500000],"));
+
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", loopStatus,
+                 PayloadFormat::CBOR);
+    body = readAll(stream, 64);
+    size_t pos = 0;
+    TEST_ASSERT_TRUE(skipCborItem(body, pos));
+    TEST_ASSERT_EQUAL(body.size(), pos);
+    TEST_ASSERT_EQUAL(1, countOf(body, "loop_us"));
+}
+
+// Test: sampled tasks appear as [least free stack, CPU %], CPU null when unknown
+void test_task_stats_in_health() {
+    DataManager dataManager;
+    dataManager.bufferForTransmission(makeWindow(0));
+    SystemStatus taskStatus = status;
+    taskStatus.taskCount = 2;
+    taskStatus.tasks[0] = {"loop", 8192, 5120, TASK_CPU_UNKNOWN, false};
+    taskStatus.tasks[1] = {"display", 6144, 2608, 12, false};
+
+    PayloadStream stream;
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", taskStatus);
+    std::string body = readAll(stream, 64);
+    TEST_ASSERT_EQUAL(1, countOf(body, "\"tasks\":{\"loop\":[5120,null],\"display\":[2608,12]}"));
+
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", taskStatus,
+                 PayloadFormat::CBOR);
+    body = readAll(stream, 64);
+    size_t pos = 0;
+    TEST_ASSERT_TRUE(skipCborItem(body, pos));
+    TEST_ASSERT_EQUAL(body.size(), pos);
+    const std::string loopEntry("\x64loop\x82\x19\x14\x00\xF6", 9);  // "loop": [5120, null]
+    TEST_ASSERT_TRUE(body.find(loopEntry) != std::string::npos);
+}
+
+// Test: a pending post-mortem log closes the body in every format
+void test_post_mortem_ends_body_when_pending() {
+    ErrorLogger::beginPostMortem(RESET_POWERON);
+    mockMillis = 1500;
+    ErrorLogger::warning(ErrorType::NETWORK, "Upload blocked");
+    ErrorLogger::beginPostMortem(RESET_TASK_WDT);
+
+    DataManager dataManager;
+    dataManager.bufferForTransmission(makeWindow(0));
+    SystemStatus crashStatus = status;
+    crashStatus.postMortemPending = true;
+    const char* expected =
+        ",\"post_mortem\":{\"reset_reason\":\"task_wdt\","
+        "\"log\":[[0,1500,\"WARN\",\"NETWORK\",\"Upload blocked\"]]}}";
+
+    PayloadStream stream;
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", crashStatus);
+    std::string body = readAll(stream, 64);
+    TEST_ASSERT_EQUAL(stream.contentLength(), body.size());
+    TEST_ASSERT_EQUAL_STRING((std::string("}") + expected).c_str(),
+                             body.substr(body.size() - strlen(expected) - 1).c_str());
+
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", crashStatus,
+                 PayloadFormat::COLUMNAR);
+    body = readAll(stream, 64);
+    TEST_ASSERT_EQUAL(1, countOf(body, expected));
+    TEST_ASSERT_EQUAL(body.size() - strlen(expected), body.find(expected));
+
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", crashStatus,
+                 PayloadFormat::CBOR);
+    body = readAll(stream, 64);
+    size_t pos = 0;
+    TEST_ASSERT_TRUE(skipCborItem(body, pos));
+    TEST_ASSERT_EQUAL(body.size(), pos);
+    TEST_ASSERT_EQUAL(1, countOf(body, "Upload blocked"));
+    ErrorLogger::clearPostMortem();
+}
+
+// Test: CBOR is smaller than the same columns as JSON text
+void test_cbor_body_is_smaller_than_columnar_json() {
+    DataManager dataManager;
+    for (uint32_t i = 0; i < 40; i++) {
+        dataManager.bufferForTransmission(makeWindow(i * 1000));
+    }
+
+    PayloadStream stream;
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", status,
+                 PayloadFormat::COLUMNAR);
+    size_t json = stream.contentLength();
+    stream.begin(dataManager.getBufferedBatch(), nullptr, "dev-1", status, PayloadFormat::CBOR);
+
+    TEST_ASSERT_TRUE(stream.contentLength() < json);
+}
+
+void setUp(void) {
+    status = SystemStatus();
+    status.metricsDue = true;
+}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_content_length_matches_body);
+    RUN_TEST(test_rewind_replays_body);
+    RUN_TEST(test_health_block_only_when_due);
+    RUN_TEST(test_reading_formatting);
+    RUN_TEST(test_reading_overflow_is_reported);
+    RUN_TEST(test_columnar_body_layout);
+    RUN_TEST(test_columnar_body_is_smaller);
+    RUN_TEST(test_cbor_body_is_well_formed);
+    RUN_TEST(test_cbor_body_is_smaller_than_columnar_json);
+    RUN_TEST(test_boot_profile_in_health_when_pending);
+    RUN_TEST(test_energy_in_health);
+    RUN_TEST(test_loop_timing_in_health);
+    RUN_TEST(test_task_stats_in_health);
+    RUN_TEST(test_post_mortem_ends_body_when_pending);
+
+    return UNITY_END();
+}
@@ -0,0 +1,42 @@
+#include <unity.h>
+
+#include "models/RadioPolicy.h"
+
+// Test: the upload ETA counts the rest of this window plus the windows after it
+void test_uplink_eta() {
+    TEST_ASSERT_EQUAL_UINT32(8000, uplinkEtaMs(2, 5000, 2000, 0, 60000));
+    TEST_ASSERT_EQUAL_UINT32(128000, uplinkEtaMs(2, 5000, 2000, 2, 60000));
+    TEST_ASSERT_EQUAL_UINT32(0, uplinkEtaMs(1, 5000, 9000, 0, 60000));  // Reading overdue
+}
+
+// Test: far uploads turn the radio off, sooner on battery and sooner on a low battery
+void test_mode_follows_schedule_and_battery() {
+    RadioMode idle = RadioMode::MODEM_SLEEP;
+    TEST_ASSERT_TRUE(radioModeFor(idle, 80000, 100, true) == RadioMode::OFF);
+    TEST_ASSERT_TRUE(radioModeFor(idle, 70000, 100, true) == RadioMode::MODEM_SLEEP);
+    TEST_ASSERT_TRUE(radioModeFor(idle, 50000, 20, true) == RadioMode::OFF);
+    TEST_ASSERT_TRUE(radioModeFor(idle, 300000, 100, false) == RadioMode::MODEM_SLEEP);
+    TEST_ASSERT_TRUE(radioModeFor(idle, 900000, 100, false) == RadioMode::OFF);
+}
+
+// Test: an off radio stays off until the wake lead, then rejoins
+void test_off_holds_until_wake_lead() {
+    TEST_ASSERT_TRUE(radioModeFor(RadioMode::OFF, 20000, 100, true) == RadioMode::OFF);
+    TEST_ASSERT_TRUE(radioModeFor(RadioMode::OFF, RADIO_WAKE_LEAD_MS, 100, true) ==
+                     RadioMode::MODEM_SLEEP);
+    TEST_ASSERT_TRUE(radioModeFor(RadioMode::ACTIVE, 1000, 100, true) == RadioMode::MODEM_SLEEP);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_uplink_eta);
+    RUN_TEST(test_mode_follows_schedule_and_battery);
+    RUN_TEST(test_off_holds_until_wake_lead);
+
+    return UNITY_END();
+}
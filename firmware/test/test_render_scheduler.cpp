@@ -0,0 +1,74 @@
+#include <unity.h>
+
+#include "RenderScheduler.h"
+
+// Test: the first call draws, unchanged inputs wait for the clock tick
+void test_unchanged_inputs_wait_for_tick() {
+    RenderScheduler scheduler;
+
+    TEST_ASSERT_TRUE(scheduler.shouldRender(7, 1000));
+    TEST_ASSERT_FALSE(scheduler.shouldRender(7, 1500));
+    TEST_ASSERT_FALSE(scheduler.shouldRender(7, 1999));
+    TEST_ASSERT_TRUE(scheduler.shouldRender(7, 2000));
+    TEST_ASSERT_EQUAL(2, scheduler.getFramesRendered());
+}
+
+// Test: changed inputs draw, but no faster than the frame-rate cap
+void test_changes_are_rate_limited() {
+    RenderScheduler scheduler;
+    scheduler.setMaxFps(10);
+
+    TEST_ASSERT_TRUE(scheduler.shouldRender(1, 0));
+    TEST_ASSERT_FALSE(scheduler.shouldRender(2, 50));  // Within 100 ms
+    TEST_ASSERT_TRUE(scheduler.shouldRender(2, 100));  // Pending change goes out
+    TEST_ASSERT_FALSE(scheduler.shouldRender(2, 200));
+}
+
+// Test: a requested frame draws with unchanged inputs
+void test_requested_frame() {
+    RenderScheduler scheduler;
+
+    TEST_ASSERT_TRUE(scheduler.shouldRender(1, 0));
+    scheduler.requestFrame();
+    TEST_ASSERT_TRUE(scheduler.shouldRender(1, 100));
+    TEST_ASSERT_FALSE(scheduler.shouldRender(1, 200));
+}
+
+// Test: low power mode caps at one frame per second and slows the clock tick
+void test_low_power_throttles() {
+    RenderScheduler scheduler;
+    scheduler.setMaxFps(20);
+    scheduler.setLowPower(true);
+
+    TEST_ASSERT_TRUE(scheduler.shouldRender(1, 0));
+    TEST_ASSERT_FALSE(scheduler.shouldRender(2, 500));
+    TEST_ASSERT_TRUE(scheduler.shouldRender(2, 1000));
+    TEST_ASSERT_FALSE(scheduler.shouldRender(2, 5000));
+    TEST_ASSERT_TRUE(scheduler.shouldRender(2, 11000));
+}
+
+// Test: 0 selects the default rate and large values are capped
+void test_max_fps_bounds() {
+    RenderScheduler scheduler;
+
+    scheduler.setMaxFps(0);
+    TEST_ASSERT_EQUAL(RENDER_DEFAULT_MAX_FPS, scheduler.getMaxFps());
+    scheduler.setMaxFps(200);
+    TEST_ASSERT_EQUAL(RENDER_MAX_FPS_LIMIT, scheduler.getMaxFps());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_unchanged_inputs_wait_for_tick);
+    RUN_TEST(test_changes_are_rate_limited);
+    RUN_TEST(test_requested_frame);
+    RUN_TEST(test_low_power_throttles);
+    RUN_TEST(test_max_fps_bounds);
+
+    return UNITY_END();
+}
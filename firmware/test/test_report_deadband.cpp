@@ -0,0 +1,94 @@
+#include <unity.h>
+
+#include "ReportDeadband.h"
+
+static const uint8_t ALL_SENSORS = 0x1F;
+
+static AveragedData makeWindow(float temperature, float pressure) {
+    AveragedData data = {};
+    data.avgBme280Temp = temperature;
+    data.avgDs18b20Temp = temperature;
+    data.avgHumidity = 55.0f;
+    data.avgPressure = pressure;
+    data.avgSoilMoisture = 40.0f;
+    data.sensorStatus = ALL_SENSORS;
+    return data;
+}
+
+static void configure(uint8_t heartbeatWindows) {
+    DeadbandTolerances tolerances = {0.2f, 1.0f, 0.5f, 2.0f};
+    ReportDeadband::configure(tolerances, heartbeatWindows);
+}
+
+// Test: all tolerances 0 reports every window
+void test_disabled_reports_everything() {
+    DeadbandTolerances none = {0.0f, 0.0f, 0.0f, 0.0f};
+    ReportDeadband::configure(none, 12);
+
+    TEST_ASSERT_FALSE(ReportDeadband::isEnabled());
+    TEST_ASSERT_TRUE(ReportDeadband::shouldReport(makeWindow(20.0f, 1013.0f)));
+    TEST_ASSERT_TRUE(ReportDeadband::shouldReport(makeWindow(20.0f, 1013.0f)));
+}
+
+// Test: the first window reports, stable ones are dropped, a change reports again
+void test_stable_windows_dropped() {
+    configure(12);
+
+    TEST_ASSERT_TRUE(ReportDeadband::shouldReport(makeWindow(20.0f, 1013.0f)));
+    TEST_ASSERT_FALSE(ReportDeadband::shouldReport(makeWindow(20.1f, 1013.2f)));
+    TEST_ASSERT_FALSE(ReportDeadband::shouldReport(makeWindow(19.9f, 1012.8f)));
+    TEST_ASSERT_EQUAL(2, ReportDeadband::getSuppressedRun());
+
+    TEST_ASSERT_TRUE(ReportDeadband::shouldReport(makeWindow(20.0f, 1014.0f)));
+    TEST_ASSERT_EQUAL(0, ReportDeadband::getSuppressedRun());
+}
+
+// Test: drift is measured against the last reported window, not the previous one
+void test_drift_against_reference() {
+    configure(12);
+
+    TEST_ASSERT_TRUE(ReportDeadband::shouldReport(makeWindow(20.0f, 1013.0f)));
+    TEST_ASSERT_FALSE(ReportDeadband::shouldReport(makeWindow(20.15f, 1013.0f)));
+    TEST_ASSERT_TRUE(ReportDeadband::shouldReport(makeWindow(20.3f, 1013.0f)));
+}
+
+// Test: every heartbeat-th window reports even when nothing changed
+void test_heartbeat_forces_report() {
+    configure(3);
+
+    TEST_ASSERT_TRUE(ReportDeadband::shouldReport(makeWindow(20.0f, 1013.0f)));
+    TEST_ASSERT_FALSE(ReportDeadband::shouldReport(makeWindow(20.0f, 1013.0f)));
+    TEST_ASSERT_FALSE(ReportDeadband::shouldReport(makeWindow(20.0f, 1013.0f)));
+    TEST_ASSERT_TRUE(ReportDeadband::shouldReport(makeWindow(20.0f, 1013.0f)));
+}
+
+// Test: a sensor dropping out reports, and missing sensors are not compared
+void test_sensor_mask_change_reports() {
+    configure(12);
+
+    TEST_ASSERT_TRUE(ReportDeadband::shouldReport(makeWindow(20.0f, 1013.0f)));
+    AveragedData noSoil = makeWindow(20.0f, 1013.0f);
+    noSoil.sensorStatus = ALL_SENSORS & ~(1 << static_cast<uint8_t>(SensorType::SOIL_MOISTURE));
+    noSoil.avgSoilMoisture = 0.0f;
+    TEST_ASSERT_TRUE(ReportDeadband::shouldReport(noSoil));
+    noSoil.avgSoilMoisture = 90.0f;
+    TEST_ASSERT_FALSE(ReportDeadband::shouldReport(noSoil));
+}
+
+void setUp(void) {
+    ReportDeadband::reset();
+}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_disabled_reports_everything);
+    RUN_TEST(test_stable_windows_dropped);
+    RUN_TEST(test_drift_against_reference);
+    RUN_TEST(test_heartbeat_forces_report);
+    RUN_TEST(test_sensor_mask_change_reports);
+
+    return UNITY_END();
+}
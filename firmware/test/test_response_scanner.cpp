@@ -0,0 +1,115 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include <string>
+
+#include "ResponseScanner.h"
+
+static ResponseScanner scanner;
+
+static void feed(const std::string& body, size_t chunkSize) {
+    for (size_t pos = 0; pos < body.size(); pos += chunkSize) {
+        size_t length = body.size() - pos < chunkSize ? body.size() - pos : chunkSize;
+        scanner.write(reinterpret_cast<const uint8_t*>(body.data() + pos), length);
+    }
+}
+
+// Test: both ID lists land in one table, whichever chunk boundaries the body arrives in
+void test_collects_acked_and_duplicate_ids() {
+    std::string body =
+        "{\"acknowledged_batch_ids\": [\"device_e_1_2\", \"device_e_3_4\"],\n"
+        " \"duplicate_batch_ids\": [\"device_u_5_6\"]}";
+
+    for (size_t chunkSize = 1; chunkSize <= body.size(); chunkSize++) {
+        scanner.reset();
+        feed(body, chunkSize);
+
+        TEST_ASSERT_TRUE(scanner.hasAckList());
+        TEST_ASSERT_EQUAL_UINT16(3, scanner.batchIdCount());
+        TEST_ASSERT_EQUAL_STRING("device_e_1_2", scanner.batchId(0));
+        TEST_ASSERT_TRUE(scanner.containsBatchId("device_u_5_6"));
+        TEST_ASSERT_FALSE(scanner.containsBatchId("device_e_1"));
+        TEST_ASSERT_FALSE(scanner.truncated());
+    }
+}
+
+// Test: IDs in nested objects or other arrays are not taken for acknowledgements
+void test_ignores_nested_and_unrelated_fields() {
+    scanner.reset();
+    feed("{\"status\":\"ok\",\"meta\":{\"acknowledged_batch_ids\":[\"nested\"]},"
+         "\"other\":[\"device_e_1_2\",{\"x\":[1,2]}],\"count\":2,"
+         "\"acknowledged_batch_ids\":[],\"note\":\"a \\\"quoted\\\" [text]\"}",
+         7);
+
+    TEST_ASSERT_TRUE(scanner.hasAckList());
+    TEST_ASSERT_EQUAL_UINT16(0, scanner.batchIdCount());
+    TEST_ASSERT_FALSE(scanner.hasConfirmationId());
+}
+
+// Test: a response without ID lists is reported as such
+void test_missing_ack_list() {
+    scanner.reset();
+    feed("{\"status\":\"success\"}", 64);
+
+    TEST_ASSERT_FALSE(scanner.hasAckList());
+    TEST_ASSERT_EQUAL_UINT16(0, scanner.batchIdCount());
+}
+
+// Test: the registration confirmation_id is extracted
+void test_confirmation_id() {
+    scanner.reset();
+    feed("{\"device_id\":\"AA:BB\",\"confirmation_id\":\"7c9e6679-7425-40de-944b-e07fc1f90ae7\"}",
+         5);
+
+    TEST_ASSERT_TRUE(scanner.hasConfirmationId());
+    TEST_ASSERT_EQUAL_STRING("7c9e6679-7425-40de-944b-e07fc1f90ae7", scanner.confirmationId());
+}
+
+// Test: more IDs than slots and over-long IDs are dropped, flagged as truncated
+void test_table_and_slot_limits() {
+    std::string body = "{\"acknowledged_batch_ids\":[\"" + std::string(100, 'x') + "\"";
+    for (uint16_t i = 0; i < RESPONSE_MAX_BATCH_IDS + 5; i++) {
+        body += ",\"id" + std::to_string(i) + "\"";
+    }
+    body += "]}";
+
+    scanner.reset();
+    feed(body, 16);
+
+    TEST_ASSERT_TRUE(scanner.truncated());
+    TEST_ASSERT_EQUAL_UINT16(RESPONSE_MAX_BATCH_IDS, scanner.batchIdCount());
+    TEST_ASSERT_EQUAL_STRING("id0", scanner.batchId(0));
+    TEST_ASSERT_FALSE(scanner.containsBatchId(std::string(100, 'x').c_str()));
+}
+
+// Test: bytes past RESPONSE_MAX_BYTES are refused, IDs before the cap are kept
+void test_body_byte_cap() {
+    std::string body = "{\"acknowledged_batch_ids\":[\"device_e_1_2\"],\"pad\":\"" +
+                       std::string(RESPONSE_MAX_BYTES, ' ') + "\"}";
+
+    scanner.reset();
+    size_t accepted = scanner.write(reinterpret_cast<const uint8_t*>(body.data()), body.size());
+
+    TEST_ASSERT_EQUAL(RESPONSE_MAX_BYTES, accepted);
+    TEST_ASSERT_TRUE(scanner.truncated());
+    TEST_ASSERT_EQUAL(0, scanner.write(reinterpret_cast<const uint8_t*>("x"), 1));
+    TEST_ASSERT_TRUE(scanner.containsBatchId("device_e_1_2"));
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_collects_acked_and_duplicate_ids);
+    RUN_TEST(test_ignores_nested_and_unrelated_fields);
+    RUN_TEST(test_missing_ack_list);
+    RUN_TEST(test_confirmation_id);
+    RUN_TEST(test_table_and_slot_limits);
+    RUN_TEST(test_body_byte_cap);
+
+    return UNITY_END();
+}
@@ -0,0 +1,148 @@
+#include <unity.h>
+
+#include <math.h>
+
+#include "RingExtrema.h"
+
+// Test ring: values column plus its running extrema, overwriting the oldest when full
+struct TestRing {
+    static constexpr uint16_t CAPACITY = 8;
+    float values[CAPACITY];
+    uint16_t storage[2 * CAPACITY];
+    uint16_t head;
+    uint16_t count;
+    RingExtrema extrema;
+
+    TestRing() : values(), storage(), head(0), count(0) { extrema.attach(storage, CAPACITY); }
+
+    void add(float value) {
+        if (count == CAPACITY) {
+            extrema.evict(head);
+        } else {
+            count++;
+        }
+        values[head] = value;
+        extrema.push(head, values, values);
+        head = (head + 1) % CAPACITY;
+    }
+
+    uint16_t start() const { return (head + CAPACITY - count) % CAPACITY; }
+
+    bool range(uint16_t fromOffset, float& minValue, float& maxValue) const {
+        return extrema.range(values, values, start(), fromOffset, minValue, maxValue);
+    }
+};
+
+void test_empty_ring_has_no_range() {
+    TestRing ring;
+    float minValue = 0.0f;
+    float maxValue = 0.0f;
+
+    TEST_ASSERT_FALSE(ring.range(0, minValue, maxValue));
+}
+
+void test_range_follows_evictions() {
+    TestRing ring;
+    float minValue = 0.0f;
+    float maxValue = 0.0f;
+
+    // 50 and -50 are the extremes until they are overwritten
+    const float values[] = {50.0f, -50.0f, 3.0f, 1.0f, 4.0f, 1.0f, 5.0f, 9.0f};
+    for (float value : values) {
+        ring.add(value);
+    }
+    TEST_ASSERT_TRUE(ring.range(0, minValue, maxValue));
+    TEST_ASSERT_EQUAL_FLOAT(-50.0f, minValue);
+    TEST_ASSERT_EQUAL_FLOAT(50.0f, maxValue);
+
+    ring.add(2.0f);
+    TEST_ASSERT_TRUE(ring.range(0, minValue, maxValue));
+    TEST_ASSERT_EQUAL_FLOAT(-50.0f, minValue);
+    TEST_ASSERT_EQUAL_FLOAT(9.0f, maxValue);
+
+    ring.add(6.0f);
+    TEST_ASSERT_TRUE(ring.range(0, minValue, maxValue));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, minValue);
+    TEST_ASSERT_EQUAL_FLOAT(9.0f, maxValue);
+}
+
+void test_range_of_newest_entries() {
+    TestRing ring;
+    float minValue = 0.0f;
+    float maxValue = 0.0f;
+
+    for (uint16_t i = 0; i < 12; i++) {
+        ring.add(static_cast<float>((i * 5) % 7));  // 6 4 2 0 5 3 1 6 after the wrap
+    }
+
+    // Last three entries: 3 1 6
+    TEST_ASSERT_TRUE(ring.range(5, minValue, maxValue));
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, minValue);
+    TEST_ASSERT_EQUAL_FLOAT(6.0f, maxValue);
+
+    TEST_ASSERT_TRUE(ring.range(7, minValue, maxValue));
+    TEST_ASSERT_EQUAL_FLOAT(6.0f, minValue);
+    TEST_ASSERT_EQUAL_FLOAT(6.0f, maxValue);
+}
+
+void test_nan_values_are_skipped() {
+    TestRing ring;
+    float minValue = 0.0f;
+    float maxValue = 0.0f;
+
+    ring.add(NAN);
+    TEST_ASSERT_FALSE(ring.range(0, minValue, maxValue));
+
+    ring.add(3.0f);
+    ring.add(NAN);
+    TEST_ASSERT_TRUE(ring.range(0, minValue, maxValue));
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, minValue);
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, maxValue);
+}
+
+void test_rebase_after_rotation() {
+    TestRing ring;
+    float minValue = 0.0f;
+    float maxValue = 0.0f;
+
+    for (uint16_t i = 0; i < 11; i++) {
+        ring.add(static_cast<float>(i));
+    }
+
+    // Rotate the ring so the oldest entry sits at slot 0
+    uint16_t start = ring.start();
+    float rotated[TestRing::CAPACITY];
+    for (uint16_t i = 0; i < TestRing::CAPACITY; i++) {
+        rotated[i] = ring.values[(start + i) % TestRing::CAPACITY];
+    }
+    for (uint16_t i = 0; i < TestRing::CAPACITY; i++) {
+        ring.values[i] = rotated[i];
+    }
+    ring.extrema.rebase(start);
+    ring.head = 0;
+
+    TEST_ASSERT_TRUE(ring.range(0, minValue, maxValue));
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, minValue);
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, maxValue);
+
+    ring.add(-1.0f);
+    TEST_ASSERT_TRUE(ring.range(0, minValue, maxValue));
+    TEST_ASSERT_EQUAL_FLOAT(-1.0f, minValue);
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, maxValue);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_empty_ring_has_no_range);
+    RUN_TEST(test_range_follows_evictions);
+    RUN_TEST(test_range_of_newest_entries);
+    RUN_TEST(test_nan_values_are_skipped);
+    RUN_TEST(test_rebase_after_rotation);
+
+    return UNITY_END();
+}
@@ -0,0 +1,123 @@
+#include <unity.h>
+
+#include "DataManager.h"
+#include "RtcStateStore.h"
+#include "models/SensorReadings.h"
+
+static AveragedData makeWindow(uint32_t start) {
+    AveragedData data = {};
+    data.avgBme280Temp = 22.5f;
+    data.sampleStartUptimeMs = start;
+    data.sampleEndUptimeMs = start + 1000;
+    data.sampleCount = 20;
+    return data;
+}
+
+static SensorReadings makeReading(uint32_t timestamp, float value) {
+    SensorReadings reading = {};
+    reading.monotonicMs = timestamp;
+    reading.bme280Temp = value;
+    reading.ds18b20Temp = value;
+    reading.humidity = value;
+    reading.pressure = value;
+    reading.soilMoisture = value;
+    return reading;
+}
+
+// Test: standard check value of the CRC-32 used for the image
+void test_crc32_check_value() {
+    TEST_ASSERT_EQUAL_HEX32(0xCBF43926, RtcStateStore::crc32("123456789", 9));
+}
+
+// Test: backlog, counters and display history survive a save/restore cycle
+void test_round_trip_restores_backlog_and_history() {
+    DataManager before;
+    for (uint32_t i = 0; i < 5; i++) {
+        before.bufferForTransmission(makeWindow(i * 1000));
+        before.addToDisplayBuffer(makeReading(i * 60000, 10.0f + i));
+    }
+    TEST_ASSERT_TRUE(RtcStateStore::save(before, 4 * 60000 + 500, 300000));
+
+    DataManager after;
+    TEST_ASSERT_TRUE(RtcStateStore::restore(after, 100));
+
+    TEST_ASSERT_EQUAL_UINT16(5, after.getBufferedDataCount());
+    BufferedBatch batch = after.getBufferedBatch();
+    for (uint16_t i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_UINT32(i + 1, batch.at(i).sequence);
+    }
+    TEST_ASSERT_EQUAL_UINT32(before.getNextSequence(), after.getNextSequence());
+
+    DisplaySeries series = after.getDisplaySeries(SensorType::BME280_TEMP);
+    TEST_ASSERT_EQUAL_UINT16(5, series.count);
+    TEST_ASSERT_EQUAL_FLOAT(14.0f, series.valueAt(4));
+
+    // The image is consumed by the restore
+    TEST_ASSERT_FALSE(RtcStateStore::hasValidImage());
+}
+
+// Test: readings after the wakeup continue the saved display clock
+void test_display_clock_continues_after_wakeup() {
+    DataManager before;
+    before.addToDisplayBuffer(makeReading(0, 1.0f));
+    before.addToDisplayBuffer(makeReading(60000, 2.0f));
+    TEST_ASSERT_TRUE(RtcStateStore::save(before, 90000, 300000));
+
+    // millis() restarts near zero on wakeup
+    DataManager after;
+    TEST_ASSERT_TRUE(RtcStateStore::restore(after, 200));
+    after.addToDisplayBuffer(makeReading(300, 3.0f));
+
+    DisplaySeries series = after.getDisplaySeries(SensorType::BME280_TEMP);
+    TEST_ASSERT_EQUAL_UINT16(3, series.count);
+    TEST_ASSERT_EQUAL_UINT32(390100, series.timestampAt(2));
+    TEST_ASSERT_TRUE(series.timestampAt(2) > series.timestampAt(1));
+}
+
+// Test: an image is restored at most once (a later reset must fall back to NVS)
+void test_image_is_consumed_by_restore() {
+    DataManager before;
+    before.bufferForTransmission(makeWindow(1000));
+    TEST_ASSERT_TRUE(RtcStateStore::save(before, 0, 1000));
+    TEST_ASSERT_TRUE(RtcStateStore::hasValidImage());
+
+    DataManager first;
+    TEST_ASSERT_TRUE(RtcStateStore::restore(first, 0));
+
+    DataManager second;
+    TEST_ASSERT_FALSE(RtcStateStore::restore(second, 0));
+    TEST_ASSERT_EQUAL_UINT16(0, second.getBufferedDataCount());
+}
+
+// Test: only the newest windows fit; save reports the rest for the flash queue
+void test_large_backlog_keeps_newest_windows() {
+    DataManager before;
+    before.configureBuffers(200, MAX_DISPLAY_POINTS);
+    for (uint32_t i = 0; i < RTC_STATE_DATA_RECORDS + 10; i++) {
+        before.bufferForTransmission(makeWindow(i * 1000));
+    }
+    TEST_ASSERT_FALSE(RtcStateStore::save(before, 0, 1000));
+
+    DataManager after;
+    TEST_ASSERT_TRUE(RtcStateStore::restore(after, 0));
+    TEST_ASSERT_EQUAL_UINT16(RTC_STATE_DATA_RECORDS, after.getBufferedDataCount());
+    TEST_ASSERT_EQUAL_UINT32(11, after.getBufferedBatch().at(0).sequence);
+}
+
+void setUp(void) {
+    RtcStateStore::invalidate();
+}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_crc32_check_value);
+    RUN_TEST(test_round_trip_restores_backlog_and_history);
+    RUN_TEST(test_display_clock_continues_after_wakeup);
+    RUN_TEST(test_image_is_consumed_by_restore);
+    RUN_TEST(test_large_backlog_keeps_newest_windows);
+
+    return UNITY_END();
+}
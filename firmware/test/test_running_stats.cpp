@@ -0,0 +1,120 @@
+#include <unity.h>
+
+#include "RunningStats.h"
+
+void test_empty_stats_report_zero() {
+    RunningStats stats;
+    stats.reset();
+
+    TEST_ASSERT_EQUAL_UINT16(0, stats.count);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.mean());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.variance());
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.stddev());
+}
+
+void test_tracks_min_max_and_mean() {
+    RunningStats stats;
+    stats.reset();
+
+    stats.add(4.0f);
+    stats.add(-2.0f);
+    stats.add(10.0f);
+
+    TEST_ASSERT_EQUAL_UINT16(3, stats.count);
+    TEST_ASSERT_EQUAL_FLOAT(-2.0f, stats.min);
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, stats.max);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 4.0f, stats.mean());
+}
+
+void test_population_stddev() {
+    RunningStats stats;
+    stats.reset();
+
+    // Classic example: population stddev of {2,4,4,4,5,5,7,9} is 2
+    const float values[] = {2, 4, 4, 4, 5, 5, 7, 9};
+    for (float v : values) {
+        stats.add(v);
+    }
+
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 4.0f, stats.variance());
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, 2.0f, stats.stddev());
+}
+
+void test_variance_stable_on_large_offset() {
+    RunningStats stats;
+    stats.reset();
+
+    // Pressure-like values: tiny spread on a large offset
+    for (int i = 0; i < 3600; i++) {
+        stats.add(1013.0f + ((i % 2) ? 0.5f : -0.5f));
+    }
+
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1013.0f, stats.mean());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 0.5f, stats.stddev());
+}
+
+void test_reset_clears_state() {
+    RunningStats stats;
+    stats.reset();
+    stats.add(50.0f);
+    stats.add(70.0f);
+
+    stats.reset();
+    stats.add(1.0f);
+
+    TEST_ASSERT_EQUAL_UINT16(1, stats.count);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, stats.min);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, stats.max);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, stats.variance());
+}
+
+// Test: merging two halves matches adding every sample to one set
+void test_merge_matches_single_pass() {
+    RunningStats all;
+    RunningStats first;
+    RunningStats second;
+    all.reset();
+    first.reset();
+    second.reset();
+
+    const float values[] = {2, 4, 4, 4, 5, 5, 7, 9};
+    for (int i = 0; i < 8; i++) {
+        all.add(values[i]);
+        (i < 3 ? first : second).add(values[i]);
+    }
+    first.merge(second);
+
+    TEST_ASSERT_EQUAL_UINT16(8, first.count);
+    TEST_ASSERT_EQUAL_FLOAT(2.0f, first.min);
+    TEST_ASSERT_EQUAL_FLOAT(9.0f, first.max);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, all.mean(), first.mean());
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, all.variance(), first.variance());
+
+    // Merging into an empty set copies; merging an empty set changes nothing
+    RunningStats empty;
+    empty.reset();
+    empty.merge(first);
+    TEST_ASSERT_EQUAL_UINT16(8, empty.count);
+    TEST_ASSERT_FLOAT_WITHIN(0.0001f, all.variance(), empty.variance());
+
+    second.reset();
+    first.merge(second);
+    TEST_ASSERT_EQUAL_UINT16(8, first.count);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_empty_stats_report_zero);
+    RUN_TEST(test_tracks_min_max_and_mean);
+    RUN_TEST(test_population_stddev);
+    RUN_TEST(test_variance_stable_on_large_offset);
+    RUN_TEST(test_reset_clears_state);
+    RUN_TEST(test_merge_matches_single_pass);
+
+    return UNITY_END();
+}
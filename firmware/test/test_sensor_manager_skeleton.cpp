@@ -375,6 +375,23 @@ void test_calibration_minimum_range() {
     TEST_ASSERT_LESS_OR_EQUAL_FLOAT(100.0f, readings.soilMoisture);
 }
 
+// Test that the latest-readings snapshot mirrors the last acquisition
+void test_latest_readings_snapshot() {
+    SensorManager manager;
+    manager.initialize();
+
+    TEST_ASSERT_FALSE(manager.hasLatestReadings());
+
+    SensorReadings readings = manager.readSensors();
+
+    TEST_ASSERT_TRUE(manager.hasLatestReadings());
+    const SensorReadings& latest = manager.getLatestReadings();
+    TEST_ASSERT_EQUAL_UINT32(readings.monotonicMs, latest.monotonicMs);
+    TEST_ASSERT_EQUAL_UINT8(readings.sensorStatus, latest.sensorStatus);
+    TEST_ASSERT_EQUAL_FLOAT(readings.bme280Temp, latest.bme280Temp);
+    TEST_ASSERT_EQUAL_UINT16(readings.soilMoistureRaw, latest.soilMoistureRaw);
+}
+
 void setUp(void) {
     // Set up code here (runs before each test)
 }
@@ -418,5 +435,8 @@ int main(int argc, char** argv) {
     RUN_TEST(test_soil_moisture_clamp_upper_bound);
     RUN_TEST(test_calibration_minimum_range);
 
+    // Cached snapshot
+    RUN_TEST(test_latest_readings_snapshot);
+
     return UNITY_END();
 }
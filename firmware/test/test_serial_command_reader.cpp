@@ -0,0 +1,97 @@
+#include <unity.h>
+
+#include <string>
+
+#include "SerialCommandReader.h"
+
+static void feedText(SerialCommandReader& reader, const char* text) {
+    while (*text) {
+        reader.feed(*text++);
+    }
+}
+
+// Test: the first word picks the command; the rest arrives trimmed as its arguments
+void test_dispatches_by_command_word() {
+    SerialCommandReader reader;
+    std::string diagArgs = "unset";
+    std::string graphArgs;
+    std::string unknown;
+    reader.addCommand("diag", [&](const char* args) { diagArgs = args; });
+    reader.addCommand("graph", [&](const char* args) { graphArgs = args; });
+    reader.setUnknownHandler([&](const char* whole) { unknown = whole; });
+
+    feedText(reader, "  graph   24h \r\n");
+    TEST_ASSERT_EQUAL_STRING("24h", graphArgs.c_str());
+    TEST_ASSERT_EQUAL_STRING("unset", diagArgs.c_str());
+
+    feedText(reader, "diag\n");
+    TEST_ASSERT_EQUAL_STRING("", diagArgs.c_str());
+
+    feedText(reader, "diagnostics now\r");
+    TEST_ASSERT_EQUAL_STRING("diagnostics now", unknown.c_str());
+}
+
+// Test: nothing runs for a partial line, and typed characters can be erased
+void test_partial_line_and_backspace() {
+    SerialCommandReader reader;
+    int runs = 0;
+    reader.addCommand("show", [&](const char*) { runs++; });
+
+    feedText(reader, "sh");
+    TEST_ASSERT_EQUAL(0, runs);
+    feedText(reader, "ox\bw\n");
+    TEST_ASSERT_EQUAL(1, runs);
+}
+
+// Test: the filter sees every line first, empty ones included, and can consume it
+void test_line_filter_consumes_lines() {
+    SerialCommandReader reader;
+    int commandRuns = 0;
+    std::string seen;
+    bool consume = true;
+    reader.addCommand("save", [&](const char*) { commandRuns++; });
+    reader.setLineFilter([&](const char* line) {
+        seen += "[";
+        seen += line;
+        seen += "]";
+        return consume;
+    });
+
+    feedText(reader, "save\n\n");
+    TEST_ASSERT_EQUAL(0, commandRuns);
+    TEST_ASSERT_EQUAL_STRING("[save][]", seen.c_str());
+
+    consume = false;
+    feedText(reader, "save\n");
+    TEST_ASSERT_EQUAL(1, commandRuns);
+}
+
+// Test: an over-long line is dropped whole and the next line still works
+void test_overflow_drops_line() {
+    SerialCommandReader reader;
+    int runs = 0;
+    reader.addCommand("diag", [&](const char*) { runs++; });
+
+    std::string longLine = "diag " + std::string(SERIAL_LINE_CAPACITY, 'x') + "\n";
+    feedText(reader, longLine.c_str());
+    TEST_ASSERT_EQUAL(0, runs);
+    TEST_ASSERT_EQUAL_UINT32(1, reader.getOverflowCount());
+
+    feedText(reader, "diag\n");
+    TEST_ASSERT_EQUAL(1, runs);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_dispatches_by_command_word);
+    RUN_TEST(test_partial_line_and_backspace);
+    RUN_TEST(test_line_filter_consumes_lines);
+    RUN_TEST(test_overflow_drops_line);
+
+    return UNITY_END();
+}
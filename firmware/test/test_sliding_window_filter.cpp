@@ -0,0 +1,142 @@
+#include <unity.h>
+
+#include "SlidingWindowFilter.h"
+
+void test_empty_filter_returns_zero() {
+    SlidingWindowFilter filter;
+    filter.setWindow(5);
+
+    TEST_ASSERT_EQUAL_UINT8(0, filter.size());
+    TEST_ASSERT_EQUAL_UINT16(0, filter.median());
+    TEST_ASSERT_EQUAL_UINT16(0, filter.trimmedMean(1));
+}
+
+void test_median_odd_and_even_counts() {
+    SlidingWindowFilter filter;
+    filter.setWindow(5);
+
+    filter.push(300);
+    filter.push(100);
+    filter.push(200);
+    TEST_ASSERT_EQUAL_UINT16(200, filter.median());
+
+    filter.push(400);
+    TEST_ASSERT_EQUAL_UINT16(250, filter.median());
+}
+
+void test_window_evicts_oldest_sample() {
+    SlidingWindowFilter filter;
+    filter.setWindow(3);
+
+    filter.push(1000);
+    filter.push(10);
+    filter.push(20);
+    filter.push(30);  // Evicts 1000
+
+    TEST_ASSERT_EQUAL_UINT8(3, filter.size());
+    TEST_ASSERT_EQUAL_UINT16(20, filter.median());
+    TEST_ASSERT_EQUAL_UINT16(20, filter.trimmedMean(0));
+}
+
+void test_single_spike_rejected_by_median() {
+    SlidingWindowFilter filter;
+    filter.setWindow(9);
+
+    for (int i = 0; i < 8; i++) {
+        filter.push(2000);
+    }
+    filter.push(4095);  // WiFi TX burst spike
+
+    TEST_ASSERT_EQUAL_UINT16(2000, filter.median());
+    TEST_ASSERT_EQUAL_UINT16(2000, filter.trimmedMean(2));
+}
+
+void test_trimmed_mean_drops_both_tails() {
+    SlidingWindowFilter filter;
+    filter.setWindow(6);
+
+    filter.push(0);
+    filter.push(100);
+    filter.push(110);
+    filter.push(120);
+    filter.push(130);
+    filter.push(4000);
+
+    // Drops 0 and 4000, averages 100..130
+    TEST_ASSERT_EQUAL_UINT16(115, filter.trimmedMean(1));
+}
+
+void test_trimmed_mean_falls_back_to_median() {
+    SlidingWindowFilter filter;
+    filter.setWindow(4);
+
+    filter.push(10);
+    filter.push(20);
+
+    TEST_ASSERT_EQUAL_UINT16(filter.median(), filter.trimmedMean(1));
+}
+
+void test_matches_brute_force_over_long_stream() {
+    SlidingWindowFilter filter;
+    filter.setWindow(7);
+
+    uint16_t history[200];
+    uint32_t seed = 12345;
+    for (int i = 0; i < 200; i++) {
+        seed = seed * 1103515245 + 12345;
+        history[i] = (seed >> 16) % 4096;
+        filter.push(history[i]);
+
+        // Sorted copy of the last min(i+1, 7) samples
+        int n = i + 1 < 7 ? i + 1 : 7;
+        uint16_t window[7];
+        for (int j = 0; j < n; j++) {
+            window[j] = history[i - n + 1 + j];
+        }
+        for (int a = 1; a < n; a++) {
+            uint16_t v = window[a];
+            int b = a - 1;
+            while (b >= 0 && window[b] > v) {
+                window[b + 1] = window[b];
+                b--;
+            }
+            window[b + 1] = v;
+        }
+
+        uint16_t expected =
+            (n & 1) ? window[n / 2] : (uint16_t)((window[n / 2 - 1] + window[n / 2]) / 2);
+        TEST_ASSERT_EQUAL_UINT8(n, filter.size());
+        TEST_ASSERT_EQUAL_UINT16(expected, filter.median());
+    }
+}
+
+void test_set_window_clamps_and_resets() {
+    SlidingWindowFilter filter;
+    filter.push(100);
+
+    filter.setWindow(0);
+    TEST_ASSERT_EQUAL_UINT8(1, filter.getWindow());
+    TEST_ASSERT_EQUAL_UINT8(0, filter.size());
+
+    filter.setWindow(200);
+    TEST_ASSERT_EQUAL_UINT8(SlidingWindowFilter::MAX_WINDOW, filter.getWindow());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_empty_filter_returns_zero);
+    RUN_TEST(test_median_odd_and_even_counts);
+    RUN_TEST(test_window_evicts_oldest_sample);
+    RUN_TEST(test_single_spike_rejected_by_median);
+    RUN_TEST(test_trimmed_mean_drops_both_tails);
+    RUN_TEST(test_trimmed_mean_falls_back_to_median);
+    RUN_TEST(test_matches_brute_force_over_long_stream);
+    RUN_TEST(test_set_window_clamps_and_resets);
+
+    return UNITY_END();
+}
@@ -0,0 +1,371 @@
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#include <chrono>
+#include <vector>
+
+#include "DataManager.h"
+#include "MockSensor.h"
+#include "OutboundQueue.h"
+#include "PayloadStream.h"
+#include "SensorManager.h"
+#include "SensorTrace.h"
+
+// Soak pipeline: 10 s readings closed into 5-minute windows, like a mains-powered node
+#define SOAK_READING_MS 10000UL
+#define SOAK_WINDOW_SAMPLES 30
+#define SOAK_DAYS 7
+#define SOAK_UPLOAD_PAGE 16       // Windows per simulated upload body
+#define SOAK_PAGES_PER_CYCLE 4    // Upload bodies sent per window while online
+#define SOAK_START_MS 1000UL      // mockMillis 0 means "use the real clock"
+#define SOAK_HOUR_MS 3600000UL
+#define SOAK_DAY_MS (24 * SOAK_HOUR_MS)
+
+static const char* QUEUE_ROOT = "/tmp/soak_outq";
+
+static const char* CSV_TRACE =
+    "time_ms,bme280_temp,humidity,pressure,ds18b20_temp,soil_raw\n"
+    "# three samples, the BME280 humidity missing in the second\n"
+    "0,21.4,48.0,1012.6,19.8,2210\n"
+    "60000,21.5,,1012.7,19.9,2208\r\n"
+    "120000,21.7,47.5,1012.9,,2205\n";
+
+extern unsigned long mockMillis;
+
+static void clearQueueFiles() {
+    char path[64];
+    snprintf(path, sizeof(path), "%s/meta", QUEUE_ROOT);
+    remove(path);
+    for (int id = 0; id < 64; id++) {
+        snprintf(path, sizeof(path), "%s/%d.seg", QUEUE_ROOT, id);
+        remove(path);
+    }
+}
+
+/**
+ * Outcome of a soak run; every window closed ends up in exactly one of delivered,
+ * buffered, queued or dropped
+ */
+struct SoakResult {
+    uint32_t windows;
+    uint32_t delivered;
+    uint32_t duplicates;  // Windows delivered more than once (must stay 0)
+    uint32_t buffered;    // Still in the RAM ring at the end
+    uint32_t queued;      // Still in the flash queue at the end
+    uint32_t dropped;     // Ring overflows nobody took, plus flash queue drops
+    uint16_t peakBacklog;
+    uint32_t peakQueued;
+    size_t largestBody;
+    bool bodyOverflowed;
+    uint16_t historyPoints;  // Points of the last week-long graph query
+};
+
+// Offline for the whole of day 2, and for the first 20 minutes of every 6 hours
+static bool isOnline(uint32_t elapsedMs) {
+    if (elapsedMs >= SOAK_DAY_MS && elapsedMs < 2 * SOAK_DAY_MS) {
+        return false;
+    }
+    return elapsedMs % (6 * SOAK_HOUR_MS) >= 20 * 60000UL;
+}
+
+static size_t drainBody(PayloadStream& stream) {
+    static char chunk[512];
+    size_t total = 0;
+    size_t length;
+    while ((length = stream.readBytes(chunk, sizeof(chunk))) > 0) {
+        total += length;
+    }
+    return total;
+}
+
+static void noteDelivered(const BufferedBatch& body, std::vector<uint8_t>& seen,
+                          SoakResult& result) {
+    for (uint16_t i = 0; i < body.count(); i++) {
+        uint32_t sequence = body.at(i).sequence;
+        if (sequence >= seen.size()) {
+            seen.resize(sequence + 1, 0);
+        }
+        if (seen[sequence]++) {
+            result.duplicates++;
+        } else {
+            result.delivered++;
+        }
+    }
+}
+
+/**
+ * Replay a trace for SOAK_DAYS through SensorManager, DataManager, the flash queue and
+ * PayloadStream in virtual time
+ * @param trace Sensor values
+ * @param useQueue Spill ring overflows into the flash queue
+ */
+static SoakResult runSoak(const SensorTrace& trace, bool useQueue) {
+    DataManager* manager = new DataManager();  // Tens of KB: kept off the stack
+    DataManager& dataManager = *manager;
+    dataManager.setPublishIntervalSamples(SOAK_WINDOW_SAMPLES);
+
+    clearQueueFiles();
+    OutboundQueue queue(QUEUE_ROOT);
+    SoakResult result = {};
+    if (useQueue) {
+        if (!queue.begin()) {
+            delete manager;
+            return result;  // No windows: the caller's counts fail
+        }
+        dataManager.setOverflowSink(OutboundQueue::spill, &queue);
+    }
+
+    SensorManager sensorManager;
+    sensorManager.initialize();
+    sensorManager.setTrace(&trace);
+
+    static PayloadStream stream;
+    static PackedAveragedData page[SOAK_UPLOAD_PAGE];
+    SystemStatus status;
+    status.metricsDue = false;
+    std::vector<uint8_t> seen;
+
+    const uint32_t readings = SOAK_DAYS * (SOAK_DAY_MS / SOAK_READING_MS);
+    for (uint32_t n = 0; n < readings; n++) {
+        uint32_t elapsedMs = n * SOAK_READING_MS;
+        mockMillis = SOAK_START_MS + elapsedMs;
+        SensorReadings reading = sensorManager.readSensors();
+        dataManager.addReading(reading);
+        dataManager.addToDisplayBuffer(reading);
+        if (!dataManager.shouldPublish()) {
+            continue;
+        }
+
+        dataManager.bufferForTransmission(dataManager.calculateAverages());
+        dataManager.clearAveragingBuffer();
+        result.windows++;
+        if (dataManager.getBufferedDataCount() > result.peakBacklog) {
+            result.peakBacklog = dataManager.getBufferedDataCount();
+        }
+        if (useQueue && queue.size() > result.peakQueued) {
+            result.peakQueued = queue.size();
+        }
+
+        // Spilled windows go first, then the RAM backlog, a page per body
+        for (uint8_t body = 0; body < SOAK_PAGES_PER_CYCLE && isOnline(elapsedMs); body++) {
+            BufferedBatch batch = {};
+            bool fromQueue = useQueue && !queue.isEmpty();
+            if (fromQueue) {
+                batch.segments[0] = {page, queue.peek(page, SOAK_UPLOAD_PAGE)};
+            } else {
+                batch = dataManager.getBufferedBatch().first(SOAK_UPLOAD_PAGE);
+            }
+            if (batch.count() == 0) {
+                break;
+            }
+
+            stream.begin(batch, nullptr, "soak-device", status);
+            size_t length = drainBody(stream);
+            result.bodyOverflowed |= stream.overflowed() || length != stream.contentLength();
+            if (length > result.largestBody) {
+                result.largestBody = length;
+            }
+            noteDelivered(batch, seen, result);
+            if (fromQueue) {
+                queue.commit(batch.count());
+            } else {
+                dataManager.acknowledgeThrough(batch.at(batch.count() - 1).sequence);
+            }
+        }
+
+        // Hourly look at the week graph, as the display task would redraw it
+        if (elapsedMs % SOAK_HOUR_MS < SOAK_WINDOW_SAMPLES * SOAK_READING_MS) {
+            uint16_t count = 0;
+            dataManager.getDisplayHistory(SensorType::BME280_TEMP, SOAK_DAYS * SOAK_DAY_MS, count,
+                                          MAX_GRAPH_POINTS);
+            result.historyPoints = count;
+        }
+    }
+
+    result.buffered = dataManager.getBufferedDataCount();
+    result.dropped = dataManager.getBufferOverflowCount();
+    if (useQueue) {
+        queue.flush();
+        result.queued = queue.size();
+        result.dropped += queue.getStats().droppedRecords;
+    }
+    delete manager;
+    mockMillis = 0;
+    return result;
+}
+
+static void printSoak(const char* name, const SoakResult& result, double seconds) {
+    printf("[SOAK] %s: %u windows, %u delivered, %u buffered, %u queued, %u dropped, "
+           "peak backlog %u, peak queued %u, largest body %u B, %.2f s\n",
+           name, (unsigned)result.windows, (unsigned)result.delivered, (unsigned)result.buffered,
+           (unsigned)result.queued, (unsigned)result.dropped, (unsigned)result.peakBacklog,
+           (unsigned)result.peakQueued, (unsigned)result.largestBody, seconds);
+}
+
+void setUp(void) {
+    mockMillis = 0;
+}
+
+void tearDown(void) {
+    mockMillis = 0;
+    clearQueueFiles();
+}
+
+// Test: CSV samples are held until the next one, empty fields mark a sensor missing
+void test_csv_trace_holds_samples_and_marks_missing_sensors() {
+    SensorTrace trace;
+    TEST_ASSERT_TRUE(trace.loadCsv(CSV_TRACE));
+    TEST_ASSERT_EQUAL(3, trace.size());
+    TEST_ASSERT_EQUAL_UINT32(120000, trace.durationMs());
+
+    TraceSample sample;
+    TEST_ASSERT_TRUE(trace.sample(59999, sample));
+    TEST_ASSERT_EQUAL_UINT32(0, sample.timeMs);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 21.4f, sample.bme280Temp);
+    TEST_ASSERT_EQUAL_UINT8(0, sample.missingMask);
+
+    TEST_ASSERT_TRUE(trace.sample(60000, sample));
+    TEST_ASSERT_EQUAL_UINT8(1 << SENSOR_BME280_BIT, sample.missingMask);
+    TEST_ASSERT_TRUE(trace.sample(500000, sample));  // Past the end: last sample holds
+    TEST_ASSERT_EQUAL_UINT8(1 << SENSOR_DS18B20_BIT, sample.missingMask);
+    TEST_ASSERT_EQUAL_UINT16(2205, sample.soilMoistureRaw);
+
+    trace.setLoop(true);
+    TEST_ASSERT_TRUE(trace.sample(120000 + 60000, sample));
+    TEST_ASSERT_EQUAL_UINT32(60000, sample.timeMs);
+}
+
+// Test: malformed lines and times going backwards are rejected
+void test_csv_trace_rejects_malformed_input() {
+    SensorTrace trace;
+    TEST_ASSERT_FALSE(trace.loadCsv("0,21.4,48.0,1012.6,19.8\n"));
+    TEST_ASSERT_FALSE(trace.loadCsv("0,21.4,48.0,1012.6,19.8,2210,7\n"));
+    TEST_ASSERT_FALSE(trace.loadCsv("0,21.4x,48.0,1012.6,19.8,2210\n"));
+    TEST_ASSERT_FALSE(trace.loadCsv("60000,21.4,48.0,1012.6,19.8,2210\n0,21,48,1012,19,2210\n"));
+    TEST_ASSERT_EQUAL(0, trace.size());
+}
+
+// Test: the binary form written by saveBinary() loads back to the same samples
+void test_binary_trace_round_trips() {
+    const char* path = "/tmp/soak_trace.trace";
+    SensorTrace csv;
+    TEST_ASSERT_TRUE(csv.loadCsv(CSV_TRACE));
+    TEST_ASSERT_TRUE(csv.saveBinary(path));
+
+    SensorTrace binary;
+    TEST_ASSERT_TRUE(binary.loadFile(path));
+    TEST_ASSERT_EQUAL(csv.size(), binary.size());
+    TraceSample a;
+    TraceSample b;
+    for (uint32_t t = 0; t <= 120000; t += 30000) {
+        TEST_ASSERT_TRUE(csv.sample(t, a));
+        TEST_ASSERT_TRUE(binary.sample(t, b));
+        TEST_ASSERT_EQUAL_MEMORY(&a, &b, sizeof(a));
+    }
+    remove(path);
+}
+
+// Test: the synthetic profile is warmest in the afternoon, wets on irrigation, repeats
+void test_synthetic_profile_follows_the_day() {
+    SensorTrace trace;
+    SyntheticProfile profile = SensorTrace::defaultProfile();
+    profile.noise = 0.0f;
+    profile.dropoutIntervalMs = 0;
+    trace.setSynthetic(profile);
+
+    TraceSample afternoon;
+    TraceSample night;
+    TEST_ASSERT_TRUE(trace.sample(15 * SOAK_HOUR_MS, afternoon));
+    TEST_ASSERT_TRUE(trace.sample(3 * SOAK_HOUR_MS, night));
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, profile.tempMeanC + profile.tempSwingC, afternoon.bme280Temp);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, profile.tempMeanC - profile.tempSwingC, night.bme280Temp);
+    TEST_ASSERT_TRUE(afternoon.humidity < night.humidity);
+
+    TraceSample irrigated;
+    TraceSample drying;
+    TEST_ASSERT_TRUE(trace.sample(profile.irrigationIntervalMs, irrigated));
+    TEST_ASSERT_TRUE(trace.sample(profile.irrigationIntervalMs - 1000, drying));
+    TEST_ASSERT_EQUAL_UINT16(profile.soilWetRaw, irrigated.soilMoistureRaw);
+    TEST_ASSERT_TRUE(drying.soilMoistureRaw > irrigated.soilMoistureRaw);
+
+    TraceSample again;
+    TEST_ASSERT_TRUE(trace.sample(15 * SOAK_HOUR_MS, again));
+    TEST_ASSERT_EQUAL_MEMORY(&afternoon, &again, sizeof(again));
+}
+
+// Test: SensorManager reads the trace at millis(), a missing sensor clears its status bit
+void test_sensor_manager_replays_trace() {
+    SensorTrace trace;
+    TEST_ASSERT_TRUE(trace.loadCsv(CSV_TRACE));
+    trace.setStartMs(SOAK_START_MS);
+    SensorManager sensorManager;
+    sensorManager.initialize();
+    sensorManager.setTrace(&trace);
+
+    mockMillis = SOAK_START_MS + 60000;
+    SensorReadings readings = sensorManager.readSensors();
+    TEST_ASSERT_FALSE(readings.sensorStatus & (1 << SENSOR_BME280_BIT));
+    TEST_ASSERT_TRUE(readings.sensorStatus & (1 << SENSOR_DS18B20_BIT));
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, readings.bme280Temp);
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, 19.9f, readings.ds18b20Temp);
+    TEST_ASSERT_EQUAL_UINT16(2208, readings.soilMoistureRaw);
+
+    sensorManager.setTrace(nullptr);
+    readings = sensorManager.readSensors();
+    TEST_ASSERT_FLOAT_WITHIN(0.001f, MockSensor::BME280_TEMP_C, readings.bme280Temp);
+}
+
+// Test: a week with a day-long outage loses nothing when overflows spill to flash
+void test_week_soak_with_flash_queue_loses_nothing() {
+    SensorTrace trace;
+    trace.setSynthetic(SensorTrace::defaultProfile());
+    trace.setStartMs(SOAK_START_MS);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    SoakResult result = runSoak(trace, true);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    printSoak("week, flash queue", result, elapsed.count());
+
+    TEST_ASSERT_EQUAL_UINT32(SOAK_DAYS * SOAK_DAY_MS / (SOAK_WINDOW_SAMPLES * SOAK_READING_MS),
+                             result.windows);
+    TEST_ASSERT_EQUAL_UINT32(result.windows,
+                             result.delivered + result.buffered + result.queued + result.dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, result.duplicates);
+    TEST_ASSERT_EQUAL_UINT32(0, result.dropped);
+    TEST_ASSERT_TRUE(result.peakQueued > 0);  // The outage outgrew the RAM ring
+    TEST_ASSERT_FALSE(result.bodyOverflowed);
+    TEST_ASSERT_TRUE(result.historyPoints > 0 && result.historyPoints <= MAX_GRAPH_POINTS);
+}
+
+// Test: without the flash queue the same week drops exactly what the ring evicted
+void test_week_soak_without_flash_queue_counts_drops() {
+    SensorTrace trace;
+    trace.setSynthetic(SensorTrace::defaultProfile());
+    trace.setStartMs(SOAK_START_MS);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    SoakResult result = runSoak(trace, false);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    printSoak("week, RAM only", result, elapsed.count());
+
+    TEST_ASSERT_EQUAL_UINT32(result.windows,
+                             result.delivered + result.buffered + result.queued + result.dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, result.duplicates);
+    TEST_ASSERT_TRUE(result.dropped > 0);
+    TEST_ASSERT_TRUE(result.peakBacklog < MAX_DATA_BUFFER_SIZE);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_csv_trace_holds_samples_and_marks_missing_sensors);
+    RUN_TEST(test_csv_trace_rejects_malformed_input);
+    RUN_TEST(test_binary_trace_round_trips);
+    RUN_TEST(test_synthetic_profile_follows_the_day);
+    RUN_TEST(test_sensor_manager_replays_trace);
+    RUN_TEST(test_week_soak_with_flash_queue_loses_nothing);
+    RUN_TEST(test_week_soak_without_flash_queue_counts_drops);
+
+    return UNITY_END();
+}
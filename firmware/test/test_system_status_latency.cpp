@@ -0,0 +1,96 @@
+#include <unity.h>
+
+#include "SystemStatusManager.h"
+
+void test_latency_empty_before_samples() {
+    SystemStatusManager manager;
+    manager.initialize();
+
+    LatencyStats stats = manager.getSensorLatency(SENSOR_BME280_BIT);
+    TEST_ASSERT_EQUAL_UINT16(0, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.maxUs);
+}
+
+void test_latency_min_avg_max_p95() {
+    SystemStatusManager manager;
+    manager.initialize();
+
+    // 1..20 ms in 1 ms steps: p95 (nearest rank) is the 19th value
+    for (uint32_t i = 1; i <= 20; i++) {
+        manager.recordSensorLatency(SENSOR_DS18B20_BIT, i * 1000);
+    }
+
+    LatencyStats stats = manager.getSensorLatency(SENSOR_DS18B20_BIT);
+    TEST_ASSERT_EQUAL_UINT16(20, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(1000, stats.minUs);
+    TEST_ASSERT_EQUAL_UINT32(20000, stats.maxUs);
+    TEST_ASSERT_EQUAL_UINT32(10500, stats.avgUs);
+    TEST_ASSERT_EQUAL_UINT32(19000, stats.p95Us);
+}
+
+void test_latency_window_rolls_over() {
+    SystemStatusManager manager;
+    manager.initialize();
+
+    // One slow outlier, then a full window of fast reads pushes it out
+    manager.recordSensorLatency(SENSOR_SOIL_BIT, 500000);
+    for (uint8_t i = 0; i < SystemStatusManager::LATENCY_WINDOW; i++) {
+        manager.recordSensorLatency(SENSOR_SOIL_BIT, 100);
+    }
+
+    LatencyStats stats = manager.getSensorLatency(SENSOR_SOIL_BIT);
+    TEST_ASSERT_EQUAL_UINT16(SystemStatusManager::LATENCY_WINDOW, stats.count);
+    TEST_ASSERT_EQUAL_UINT32(100, stats.maxUs);
+}
+
+void test_latency_from_readings_skips_unsampled() {
+    SystemStatusManager manager;
+    manager.initialize();
+
+    SensorReadings readings = {};
+    readings.readLatencyUs[SENSOR_BME280_BIT] = 1200;
+    readings.readLatencyUs[SENSOR_SOIL_BIT] = 0;  // Not sampled this cycle
+
+    manager.recordSensorLatencies(readings);
+
+    TEST_ASSERT_EQUAL_UINT16(1, manager.getSensorLatency(SENSOR_BME280_BIT).count);
+    TEST_ASSERT_EQUAL_UINT16(0, manager.getSensorLatency(SENSOR_SOIL_BIT).count);
+    TEST_ASSERT_EQUAL_UINT32(1200, manager.getStatus().sensorLatency[SENSOR_BME280_BIT].p95Us);
+}
+
+void test_network_phases_and_bytes() {
+    SystemStatusManager manager;
+    manager.initialize();
+
+    manager.recordNetworkPhase(NET_PHASE_DNS, 30000);
+    manager.recordNetworkPhase(NET_PHASE_CONNECT, 250000);
+    manager.recordNetworkPhase(NET_PHASE_CONNECT, 150000);
+    manager.recordNetworkPhase(NUM_NETWORK_PHASES, 1);  // Out of range: ignored
+    manager.addNetworkBytes(1500, 0);
+    manager.addNetworkBytes(0, 120);
+
+    TEST_ASSERT_EQUAL_UINT16(1, manager.getNetworkLatency(NET_PHASE_DNS).count);
+    TEST_ASSERT_EQUAL_UINT32(200000, manager.getNetworkLatency(NET_PHASE_CONNECT).avgUs);
+    TEST_ASSERT_EQUAL_UINT16(0, manager.getNetworkLatency(NET_PHASE_RESPONSE).count);
+    TEST_ASSERT_EQUAL_UINT16(0, manager.getNetworkLatency(NUM_NETWORK_PHASES).count);
+    // Sensor windows are tracked separately
+    TEST_ASSERT_EQUAL_UINT16(0, manager.getSensorLatency(SENSOR_BME280_BIT).count);
+    TEST_ASSERT_EQUAL_UINT32(1500, manager.getStatus().netBytesSent);
+    TEST_ASSERT_EQUAL_UINT32(120, manager.getStatus().netBytesReceived);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_latency_empty_before_samples);
+    RUN_TEST(test_latency_min_avg_max_p95);
+    RUN_TEST(test_latency_window_rolls_over);
+    RUN_TEST(test_latency_from_readings_skips_unsampled);
+    RUN_TEST(test_network_phases_and_bytes);
+
+    return UNITY_END();
+}
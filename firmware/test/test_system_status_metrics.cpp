@@ -0,0 +1,96 @@
+#include <unity.h>
+
+#include "SystemStatusManager.h"
+
+// Test: the first upload of a boot carries the health block, the next ones do not
+void test_metrics_due_until_first_sent() {
+    SystemStatusManager manager;
+    manager.initialize();
+    manager.setMetricsInterval(60000);
+    TEST_ASSERT_TRUE(manager.getStatus().metricsDue);
+
+    manager.markMetricsSent(manager.getStatus());
+    manager.update();
+    TEST_ASSERT_FALSE(manager.getStatus().metricsDue);
+}
+
+// Test: the health block is due again once the interval has passed
+void test_metrics_due_after_interval() {
+    SystemStatusManager manager;
+    manager.initialize();
+    manager.setMetricsInterval(60000);
+    manager.markMetricsSent(manager.getStatus());
+
+    mockMillis = 1000 + 59999;
+    manager.update();
+    TEST_ASSERT_FALSE(manager.getStatus().metricsDue);
+    mockMillis = 1000 + 60000;
+    manager.update();
+    TEST_ASSERT_TRUE(manager.getStatus().metricsDue);
+}
+
+// Test: a changed error counter or a pending post-mortem log does not wait for the interval
+void test_metrics_due_on_change() {
+    SystemStatusManager manager;
+    manager.initialize();
+    manager.setMetricsInterval(60000);
+    manager.markMetricsSent(manager.getStatus());
+
+    manager.incrementNetworkFailures();
+    manager.update();
+    TEST_ASSERT_TRUE(manager.getStatus().metricsDue);
+    manager.markMetricsSent(manager.getStatus());
+    manager.update();
+    TEST_ASSERT_FALSE(manager.getStatus().metricsDue);
+
+    manager.setPostMortemPending(true);
+    manager.update();
+    TEST_ASSERT_TRUE(manager.getStatus().metricsDue);
+}
+
+// Test: an interval of 0 puts the health block in every upload
+void test_zero_interval_sends_every_upload() {
+    SystemStatusManager manager;
+    manager.initialize();
+    manager.setMetricsInterval(0);
+    manager.markMetricsSent(manager.getStatus());
+    manager.update();
+    TEST_ASSERT_TRUE(manager.getStatus().metricsDue);
+}
+
+// Test: the last error is copied out whole, or cut to the caller's buffer
+void test_last_error_copy() {
+    SystemStatusManager manager;
+    manager.initialize();
+    char error[16];
+    TEST_ASSERT_EQUAL(0, manager.getLastError(error, sizeof(error)));
+    TEST_ASSERT_EQUAL_STRING("", error);
+
+    manager.setLastError("HTTP 503");
+    TEST_ASSERT_EQUAL(8, manager.getLastError(error, sizeof(error)));
+    TEST_ASSERT_EQUAL_STRING("HTTP 503", error);
+
+    manager.setLastError("Registration TLS timeout");
+    TEST_ASSERT_EQUAL(24, manager.getLastError(error, sizeof(error)));
+    TEST_ASSERT_EQUAL_STRING("Registration TL", error);
+}
+
+void setUp(void) {
+    mockMillis = 1000;
+}
+
+void tearDown(void) {
+    mockMillis = 0;
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_metrics_due_until_first_sent);
+    RUN_TEST(test_metrics_due_after_interval);
+    RUN_TEST(test_metrics_due_on_change);
+    RUN_TEST(test_zero_interval_sends_every_upload);
+    RUN_TEST(test_last_error_copy);
+
+    return UNITY_END();
+}
@@ -0,0 +1,77 @@
+#include <unity.h>
+
+#include "TaskMonitor.h"
+
+static int loopTask;
+static int displayTask;
+static int spareTasks[MAX_MONITORED_TASKS];
+
+// Test: registered tasks are listed and a removed one leaves the table packed
+void test_add_and_remove() {
+    TEST_ASSERT_TRUE(TaskMonitor::add("loop", &loopTask, 8192));
+    TEST_ASSERT_TRUE(TaskMonitor::add("display", &displayTask, 6144));
+    TEST_ASSERT_FALSE(TaskMonitor::add("none", nullptr, 1024));
+    TEST_ASSERT_EQUAL_UINT8(2, TaskMonitor::getCount());
+    TEST_ASSERT_EQUAL_UINT32(6144, TaskMonitor::get(1).minFreeStackBytes);
+    TEST_ASSERT_EQUAL_UINT8(TASK_CPU_UNKNOWN, TaskMonitor::get(1).cpuPercent);
+
+    TaskMonitor::remove(&loopTask);
+    TEST_ASSERT_EQUAL_UINT8(1, TaskMonitor::getCount());
+    TEST_ASSERT_EQUAL_STRING("display", TaskMonitor::get(0).name);
+}
+
+// Test: the table holds MAX_MONITORED_TASKS tasks
+void test_table_full() {
+    for (uint8_t i = 0; i < MAX_MONITORED_TASKS; i++) {
+        TEST_ASSERT_TRUE(TaskMonitor::add("task", &spareTasks[i], 2048));
+    }
+    TEST_ASSERT_FALSE(TaskMonitor::add("extra", &displayTask, 2048));
+}
+
+// Test: CPU share comes from run-time deltas and is unknown without a time base
+void test_cpu_percent() {
+    TaskMonitor::add("loop", &loopTask, 8192);
+
+    TaskMonitor::record(0, 4000, 250, 1000);
+    TEST_ASSERT_EQUAL_UINT8(25, TaskMonitor::get(0).cpuPercent);
+    TaskMonitor::record(0, 4000, 1500, 1000);  // Counter wrapped oddly: clamp
+    TEST_ASSERT_EQUAL_UINT8(100, TaskMonitor::get(0).cpuPercent);
+    TaskMonitor::record(0, 4000, 0, 0);
+    TEST_ASSERT_EQUAL_UINT8(TASK_CPU_UNKNOWN, TaskMonitor::get(0).cpuPercent);
+}
+
+// Test: a low stack is reported once, not on every sample
+void test_stack_low_latched() {
+    TaskMonitor::add("log", &loopTask, 2048);
+
+    TEST_ASSERT_FALSE(TaskMonitor::record(0, 900, 0, 0));
+    TEST_ASSERT_TRUE(TaskMonitor::record(0, TASK_STACK_WARN_BYTES - 1, 0, 0));
+    TEST_ASSERT_TRUE(TaskMonitor::get(0).stackLow);
+    TEST_ASSERT_FALSE(TaskMonitor::record(0, 300, 0, 0));
+    TEST_ASSERT_FALSE(TaskMonitor::record(5, 100, 0, 0));  // Not registered
+}
+
+// Test: samples are rate-limited to TASK_MONITOR_INTERVAL_MS
+void test_sample_interval() {
+    TEST_ASSERT_TRUE(TaskMonitor::sample(1000));
+    TEST_ASSERT_FALSE(TaskMonitor::sample(1000 + TASK_MONITOR_INTERVAL_MS - 1));
+    TEST_ASSERT_TRUE(TaskMonitor::sample(1000 + TASK_MONITOR_INTERVAL_MS));
+}
+
+void setUp(void) {
+    TaskMonitor::clear();
+}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_add_and_remove);
+    RUN_TEST(test_table_full);
+    RUN_TEST(test_cpu_percent);
+    RUN_TEST(test_stack_low_latched);
+    RUN_TEST(test_sample_interval);
+
+    return UNITY_END();
+}
@@ -0,0 +1,68 @@
+#include <unity.h>
+
+#include "BootId.h"
+#include "TextBuffer.h"
+
+// Test: appends build the text in order
+void test_append_and_format() {
+    TextBuffer<32> text;
+    TEST_ASSERT_TRUE(text.empty());
+    TEST_ASSERT_TRUE(text.append("HTTP "));
+    TEST_ASSERT_TRUE(text.appendf("%d", 503));
+    TEST_ASSERT_TRUE(text.append('!'));
+    TEST_ASSERT_EQUAL_STRING("HTTP 503!", text.c_str());
+    TEST_ASSERT_EQUAL(9, text.length());
+    TEST_ASSERT_FALSE(text.truncated());
+}
+
+// Test: a bounded append stops at the given length
+void test_append_length() {
+    TextBuffer<16> text;
+    text.append("first line\nsecond", 10);
+    TEST_ASSERT_EQUAL_STRING("first line", text.c_str());
+}
+
+// Test: text that does not fit is cut at the capacity and reported
+void test_truncation() {
+    TextBuffer<8> text;
+    TEST_ASSERT_TRUE(text.append("abc"));
+    TEST_ASSERT_FALSE(text.appendf("%s", "defghij"));
+    TEST_ASSERT_EQUAL_STRING("abcdefg", text.c_str());
+    TEST_ASSERT_EQUAL(7, text.length());
+    TEST_ASSERT_TRUE(text.truncated());
+
+    TEST_ASSERT_FALSE(text.append('x'));  // Full: nothing more fits
+    TEST_ASSERT_EQUAL_STRING("abcdefg", text.c_str());
+
+    text.truncate(4);
+    TEST_ASSERT_TRUE(text.append("..."));
+    TEST_ASSERT_EQUAL_STRING("abcd...", text.c_str());
+
+    text.clear();
+    TEST_ASSERT_TRUE(text.empty());
+    TEST_ASSERT_FALSE(text.truncated());
+}
+
+// Test: the boot ID assembled in a TextBuffer is a valid UUID v4
+void test_boot_id_format() {
+    for (int i = 0; i < 100; i++) {
+        String uuid = BootId::generate();
+        TEST_ASSERT_EQUAL(BootId::UUID_LENGTH, uuid.length());
+        TEST_ASSERT_TRUE(BootId::isValidUuid(uuid));
+    }
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_append_and_format);
+    RUN_TEST(test_append_length);
+    RUN_TEST(test_truncation);
+    RUN_TEST(test_boot_id_format);
+
+    return UNITY_END();
+}
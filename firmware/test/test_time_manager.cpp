@@ -138,6 +138,132 @@ void test_uptimeMs_independentOfNtpSync(void) {
     TEST_ASSERT_GREATER_OR_EQUAL(uptime1, uptime2);
 }
 
+static const uint64_t SYNC_EPOCH_MS = 1704067200000ULL;
+
+void test_epochAtMonotonicMs_reachesBeforeTheSync(void) {
+    timeManager->recordSync(SYNC_EPOCH_MS, 50000);
+
+    // A window that started before the first sync still gets its epoch
+    TEST_ASSERT_EQUAL_UINT64(SYNC_EPOCH_MS - 20000, timeManager->epochAtMonotonicMs(30000));
+    TEST_ASSERT_EQUAL_UINT64(SYNC_EPOCH_MS + 1500, timeManager->epochAtMonotonicMs(51500));
+}
+
+void test_recordSync_slewsSmallOffset(void) {
+    timeManager->recordSync(SYNC_EPOCH_MS, 10000);
+
+    // The server is 200 ms ahead of the mapping: no jump, absorbed at SLEW_MAX_PPM
+    timeManager->recordSync(SYNC_EPOCH_MS + 30000 + 200, 40000);
+    TEST_ASSERT_EQUAL_UINT64(SYNC_EPOCH_MS + 30000, timeManager->epochAtMonotonicMs(40000));
+    TEST_ASSERT_EQUAL_UINT64(SYNC_EPOCH_MS + 30000 + 200000 + 100,
+                             timeManager->epochAtMonotonicMs(240000));
+    TEST_ASSERT_EQUAL_UINT64(SYNC_EPOCH_MS + 30000 + 400000 + 200,
+                             timeManager->epochAtMonotonicMs(440000));
+    TEST_ASSERT_EQUAL_UINT64(SYNC_EPOCH_MS + 30000 + 600000 + 200,
+                             timeManager->epochAtMonotonicMs(640000));
+    TEST_ASSERT_EQUAL_INT32(0, timeManager->getDriftPpm());  // Too soon to measure a rate
+
+    mockMillis = 240000;
+    TEST_ASSERT_EQUAL_INT32(100, timeManager->getPendingSlewMs());
+    mockMillis = 0;
+}
+
+void test_recordSync_stepsLargeOffset(void) {
+    timeManager->recordSync(SYNC_EPOCH_MS, 10000);
+    timeManager->recordSync(SYNC_EPOCH_MS + 30000 + 5000, 40000);
+
+    TEST_ASSERT_EQUAL_UINT64(SYNC_EPOCH_MS + 35000, timeManager->epochAtMonotonicMs(40000));
+    TEST_ASSERT_EQUAL_UINT32(2, timeManager->getSyncCount());
+}
+
+void test_recordSync_measuresDrift(void) {
+    // millis() runs 100 ppm slow: 360 ms short after an hour
+    timeManager->recordSync(SYNC_EPOCH_MS, 0);
+    timeManager->recordSync(SYNC_EPOCH_MS + 3600000, 3599640);
+
+    // Half of each measurement is taken
+    TEST_ASSERT_EQUAL_INT32(50, timeManager->getDriftPpm());
+}
+
+void test_restoreAfterSleep_continuesTheSavedClock(void) {
+    timeManager->recordSync(SYNC_EPOCH_MS, 10000);
+    timeManager->saveForSleep(70000, 900000);
+
+    // Next wake: millis() starts over, the saved clock carries on
+    TimeManager woken;
+    woken.initialize();
+    TEST_ASSERT_TRUE(woken.restoreAfterSleep(1200));
+    TEST_ASSERT_TRUE(woken.timeSynced());
+    TEST_ASSERT_EQUAL_UINT64(SYNC_EPOCH_MS + 60000 + 900000 + 1200,
+                             woken.epochAtMonotonicMs(1200));
+
+    // Used once: a reset without a new save starts unsynced
+    TimeManager reset;
+    reset.initialize();
+    TEST_ASSERT_FALSE(reset.restoreAfterSleep(1200));
+    TEST_ASSERT_FALSE(reset.timeSynced());
+}
+
+void test_restoreAfterSleep_usesTheMeasuredSleep(void) {
+    timeManager->recordSync(SYNC_EPOCH_MS, 0);
+    timeManager->saveForSleep(30000, 900000);
+
+    // A threshold wake cut the sleep short
+    TimeManager woken;
+    woken.initialize();
+    TEST_ASSERT_TRUE(woken.restoreAfterSleep(500, 120000));
+    TEST_ASSERT_EQUAL_UINT64(SYNC_EPOCH_MS + 30000 + 120000 + 500, woken.epochAtMonotonicMs(500));
+}
+
+void test_saveForSleep_skipsAnUnsyncedClock(void) {
+    timeManager->saveForSleep(30000, 900000);
+
+    TimeManager woken;
+    woken.initialize();
+    TEST_ASSERT_FALSE(woken.restoreAfterSleep(500));
+    TEST_ASSERT_TRUE(woken.needsNtpSync());
+}
+
+void test_needsNtpSync_afterTheStalenessBound(void) {
+    timeManager->recordSync(SYNC_EPOCH_MS, 0);
+    timeManager->saveForSleep(60000, 900000);
+
+    TimeManager woken;
+    woken.initialize();
+    woken.setNtpMaxAgeSec(3600);
+    woken.restoreAfterSleep(1000);
+
+    // 961 s after the last sync: no SNTP this wake
+    mockMillis = 1000;
+    TEST_ASSERT_FALSE(woken.needsNtpSync());
+    woken.tryNtpSync();
+    TEST_ASSERT_EQUAL_UINT32(0, woken.getSyncCount());
+
+    // Past the bound: sync again, after which SNTP keeps it fresh
+    mockMillis = 2700000;
+    TEST_ASSERT_TRUE(woken.needsNtpSync());
+    woken.tryNtpSync();
+    TEST_ASSERT_EQUAL_UINT32(1, woken.getSyncCount());
+    TEST_ASSERT_FALSE(woken.needsNtpSync());
+    mockMillis = 0;
+}
+
+void test_recordSync_afterRestoreKeepsTheDrift(void) {
+    // millis() runs 100 ppm slow: measured before the sleep
+    timeManager->recordSync(SYNC_EPOCH_MS, 0);
+    timeManager->recordSync(SYNC_EPOCH_MS + 3600000, 3599640);
+    timeManager->saveForSleep(3600000, 900000);
+
+    TimeManager woken;
+    woken.initialize();
+    woken.restoreAfterSleep(1000);
+    TEST_ASSERT_EQUAL_INT32(50, woken.getDriftPpm());
+
+    // The first real sync's offset is the RTC timer's error over the sleep, not a rate
+    uint64_t restored = woken.epochAtMonotonicMs(120000);
+    woken.recordSync(restored + 300, 120000);
+    TEST_ASSERT_EQUAL_INT32(50, woken.getDriftPpm());
+}
+
 int main(int argc, char** argv) {
     UNITY_BEGIN();
 
@@ -156,6 +282,15 @@ int main(int argc, char** argv) {
     RUN_TEST(test_onWiFiConnected_triggersNtpSync);
     RUN_TEST(test_timestampFormat_isUnixEpochMilliseconds);
     RUN_TEST(test_uptimeMs_independentOfNtpSync);
+    RUN_TEST(test_epochAtMonotonicMs_reachesBeforeTheSync);
+    RUN_TEST(test_recordSync_slewsSmallOffset);
+    RUN_TEST(test_recordSync_stepsLargeOffset);
+    RUN_TEST(test_recordSync_measuresDrift);
+    RUN_TEST(test_restoreAfterSleep_continuesTheSavedClock);
+    RUN_TEST(test_restoreAfterSleep_usesTheMeasuredSleep);
+    RUN_TEST(test_saveForSleep_skipsAnUnsyncedClock);
+    RUN_TEST(test_needsNtpSync_afterTheStalenessBound);
+    RUN_TEST(test_recordSync_afterRestoreKeepsTheDrift);
 
     return UNITY_END();
 }
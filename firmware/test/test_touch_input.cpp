@@ -0,0 +1,113 @@
+#include <unity.h>
+
+#include "TouchInput.h"
+
+// Test: nothing is reported before begin() or while the line is idle
+void test_idle_line_reports_nothing() {
+    TouchInput touch;
+    TouchGesture gesture;
+
+    TEST_ASSERT_FALSE(touch.begin(TouchControllerType::NONE, 33));
+    TEST_ASSERT_FALSE(touch.isActive());
+    TEST_ASSERT_TRUE(touch.begin(TouchControllerType::FT6236, 33));
+    TEST_ASSERT_FALSE(touch.poll(1000, gesture));
+}
+
+// Test: a level-mode press and release is one tap, once the line stays quiet
+void test_short_press_is_tap() {
+    TouchInput touch;
+    TouchGesture gesture;
+    touch.begin(TouchControllerType::XPT2046, 33);
+
+    touch.onIrqEdge(true, 1000);
+    touch.onIrqEdge(false, 1120);
+    TEST_ASSERT_FALSE(touch.poll(1150, gesture));  // Could still be a pulse train
+
+    TEST_ASSERT_TRUE(touch.poll(1120 + TouchInput::RELEASE_GAP_MS, gesture));
+    TEST_ASSERT_EQUAL(TouchGesture::TAP, gesture);
+    TEST_ASSERT_FALSE(touch.poll(5000, gesture));
+}
+
+// Test: holding reports a long press while held, and no tap on release
+void test_hold_is_long_press() {
+    TouchInput touch;
+    TouchGesture gesture;
+    touch.begin(TouchControllerType::XPT2046, 33);
+
+    touch.onIrqEdge(true, 1000);
+    TEST_ASSERT_FALSE(touch.poll(1500, gesture));
+    TEST_ASSERT_TRUE(touch.poll(1000 + TouchInput::LONG_PRESS_MS, gesture));
+    TEST_ASSERT_EQUAL(TouchGesture::LONG_PRESS, gesture);
+
+    touch.onIrqEdge(false, 2500);
+    TEST_ASSERT_FALSE(touch.poll(3000, gesture));
+}
+
+// Test: per-report INT pulses (CST816, GT911) merge into one touch
+void test_pulse_train_is_one_touch() {
+    TouchInput touch;
+    TouchGesture gesture;
+    touch.begin(TouchControllerType::GT911, 33);
+
+    for (uint32_t t = 1000; t < 1200; t += 20) {
+        touch.onIrqEdge(true, t);
+        touch.onIrqEdge(false, t + 1);
+    }
+    TEST_ASSERT_TRUE(touch.poll(1400, gesture));
+    TEST_ASSERT_EQUAL(TouchGesture::TAP, gesture);
+    TEST_ASSERT_FALSE(touch.poll(1500, gesture));
+}
+
+// Test: two queued taps come out one per poll, and a full queue counts drops
+void test_queued_taps_and_overflow() {
+    TouchInput touch;
+    TouchGesture gesture;
+    touch.begin(TouchControllerType::XPT2046, 33);
+
+    touch.onIrqEdge(true, 1000);
+    touch.onIrqEdge(false, 1050);
+    touch.onIrqEdge(true, 1500);
+    touch.onIrqEdge(false, 1550);
+    TEST_ASSERT_TRUE(touch.poll(2000, gesture));
+    TEST_ASSERT_EQUAL(TouchGesture::TAP, gesture);
+    TEST_ASSERT_TRUE(touch.poll(2000, gesture));
+    TEST_ASSERT_EQUAL(TouchGesture::TAP, gesture);
+    TEST_ASSERT_FALSE(touch.poll(2000, gesture));
+
+    for (uint8_t i = 0; i < TouchInput::EDGE_QUEUE_LENGTH + 3; i++) {
+        touch.onIrqEdge((i % 2) == 0, 3000 + i);
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, touch.getDroppedCount());
+}
+
+// Test: a press edge lost in light sleep is recovered from the line level
+void test_resync_recovers_missed_press() {
+    TouchInput touch;
+    TouchGesture gesture;
+    touch.begin(TouchControllerType::XPT2046, 33);
+
+    touch.resyncLevel(false, 900);  // Level agrees: nothing queued
+    TEST_ASSERT_FALSE(touch.poll(950, gesture));
+
+    touch.resyncLevel(true, 1000);  // Held, but the falling edge never arrived
+    touch.onIrqEdge(false, 1100);   // The release is seen
+    TEST_ASSERT_TRUE(touch.poll(1100 + TouchInput::RELEASE_GAP_MS, gesture));
+    TEST_ASSERT_EQUAL(TouchGesture::TAP, gesture);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_idle_line_reports_nothing);
+    RUN_TEST(test_short_press_is_tap);
+    RUN_TEST(test_hold_is_long_press);
+    RUN_TEST(test_pulse_train_is_one_touch);
+    RUN_TEST(test_queued_taps_and_overflow);
+    RUN_TEST(test_resync_recovers_missed_press);
+
+    return UNITY_END();
+}
@@ -0,0 +1,52 @@
+#include <unity.h>
+
+#include "models/UplinkPolicy.h"
+
+// Test: config file names round-trip, unknown names fall back to every window
+void test_policy_names() {
+    TEST_ASSERT_EQUAL_STRING("every_n", uplinkPolicyName(UplinkPolicy::EVERY_N));
+    TEST_ASSERT_TRUE(uplinkPolicyFromName("interval") == UplinkPolicy::INTERVAL);
+    TEST_ASSERT_TRUE(uplinkPolicyFromName("adaptive") == UplinkPolicy::ADAPTIVE);
+    TEST_ASSERT_TRUE(uplinkPolicyFromName("hourly") == UplinkPolicy::EVERY_WINDOW);
+    TEST_ASSERT_TRUE(uplinkPolicyFromName(nullptr) == UplinkPolicy::EVERY_WINDOW);
+}
+
+// Test: fixed strides (every window, every N, interval rounded up to whole windows)
+void test_fixed_strides() {
+    TEST_ASSERT_EQUAL(1, uplinkStride(UplinkPolicy::EVERY_WINDOW, 4, 900, 60, 100, 32));
+    TEST_ASSERT_EQUAL(4, uplinkStride(UplinkPolicy::EVERY_N, 4, 900, 60, 100, 32));
+    TEST_ASSERT_EQUAL(1, uplinkStride(UplinkPolicy::EVERY_N, 0, 900, 60, 100, 32));
+    TEST_ASSERT_EQUAL(15, uplinkStride(UplinkPolicy::INTERVAL, 4, 900, 60, 100, 32));
+    TEST_ASSERT_EQUAL(4, uplinkStride(UplinkPolicy::INTERVAL, 4, 1000, 300, 100, 32));
+    TEST_ASSERT_EQUAL(1, uplinkStride(UplinkPolicy::INTERVAL, 4, 30, 60, 100, 32));
+}
+
+// Test: adaptive stride grows as the battery drains
+void test_adaptive_stride() {
+    TEST_ASSERT_EQUAL(1, uplinkStride(UplinkPolicy::ADAPTIVE, 4, 900, 60, 100, 32));
+    TEST_ASSERT_EQUAL(1, uplinkStride(UplinkPolicy::ADAPTIVE, 4, 900, 60, 60, 32));
+    TEST_ASSERT_EQUAL(4, uplinkStride(UplinkPolicy::ADAPTIVE, 4, 900, 60, 59, 32));
+    TEST_ASSERT_EQUAL(8, uplinkStride(UplinkPolicy::ADAPTIVE, 4, 900, 60, 29, 32));
+}
+
+// Test: the stride never exceeds the backlog that survives until the upload
+void test_stride_limit() {
+    TEST_ASSERT_EQUAL(32, uplinkStride(UplinkPolicy::INTERVAL, 4, 86400, 60, 100, 32));
+    TEST_ASSERT_EQUAL(32, uplinkStride(UplinkPolicy::EVERY_N, 200, 900, 60, 100, 32));
+    TEST_ASSERT_EQUAL(1, uplinkStride(UplinkPolicy::EVERY_N, 4, 900, 60, 100, 0));
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_policy_names);
+    RUN_TEST(test_fixed_strides);
+    RUN_TEST(test_adaptive_stride);
+    RUN_TEST(test_stride_limit);
+
+    return UNITY_END();
+}
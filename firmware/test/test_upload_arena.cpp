@@ -0,0 +1,82 @@
+#include <unity.h>
+
+#include <string.h>
+
+#include "UploadArena.h"
+
+// Test: allocations are aligned, do not overlap, and fail once the block is used up
+void test_allocate_until_full() {
+    alignas(8) uint8_t storage[64];
+    UploadArena arena;
+    arena.attach(storage, sizeof(storage));
+
+    uint8_t* first = static_cast<uint8_t*>(arena.allocate(5, 1));
+    uint8_t* second = static_cast<uint8_t*>(arena.allocate(8, 8));
+    TEST_ASSERT_EQUAL_PTR(storage, first);
+    TEST_ASSERT_EQUAL_PTR(storage + 8, second);
+    TEST_ASSERT_EQUAL(16, arena.getUsed());
+
+    TEST_ASSERT_NOT_NULL(arena.allocate(48, 1));
+    TEST_ASSERT_NULL(arena.allocate(1, 1));
+    TEST_ASSERT_EQUAL_UINT32(1, arena.getFailedCount());
+    TEST_ASSERT_EQUAL(64, arena.getUsed());
+}
+
+// Test: reset() hands the whole block back and keeps the high-water mark
+void test_reset_reuses_the_block() {
+    uint8_t storage[32];
+    UploadArena arena;
+    arena.attach(storage, sizeof(storage));
+
+    for (int cycle = 0; cycle < 1000; cycle++) {
+        arena.reset();
+        TEST_ASSERT_EQUAL_PTR(storage, arena.allocate(20, 1));
+        TEST_ASSERT_NOT_NULL(arena.allocate(4, 1));
+    }
+    arena.reset();
+    TEST_ASSERT_EQUAL(0, arena.getUsed());
+    TEST_ASSERT_EQUAL(24, arena.getHighWater());
+    TEST_ASSERT_EQUAL_UINT32(0, arena.getFailedCount());
+}
+
+// Test: format() keeps each text in the arena, truncating to the room left
+void test_format_truncates() {
+    uint8_t storage[16];
+    UploadArena arena;
+    arena.attach(storage, sizeof(storage));
+
+    const char* code = arena.format("HTTP %d", 503);
+    TEST_ASSERT_EQUAL_STRING("HTTP 503", code);
+    TEST_ASSERT_EQUAL(9, arena.getUsed());
+
+    const char* error = arena.format("TLS error: %s", "read Timeout");
+    TEST_ASSERT_EQUAL_STRING("TLS er", error);  // 7 bytes left
+    TEST_ASSERT_EQUAL_STRING("HTTP 503", code);  // Earlier text untouched
+    TEST_ASSERT_EQUAL_UINT32(1, arena.getFailedCount());
+
+    TEST_ASSERT_EQUAL_STRING("", arena.format("full"));
+    TEST_ASSERT_EQUAL_UINT32(2, arena.getFailedCount());
+}
+
+// Test: an arena without storage refuses everything without crashing
+void test_unattached_arena() {
+    UploadArena arena;
+    TEST_ASSERT_NULL(arena.allocate(1, 1));
+    TEST_ASSERT_EQUAL_STRING("", arena.format("HTTP %d", 200));
+    TEST_ASSERT_EQUAL(0, arena.getCapacity());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_allocate_until_full);
+    RUN_TEST(test_reset_reuses_the_block);
+    RUN_TEST(test_format_truncates);
+    RUN_TEST(test_unattached_arena);
+
+    return UNITY_END();
+}
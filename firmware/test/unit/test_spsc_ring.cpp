@@ -0,0 +1,153 @@
+#include <unity.h>
+
+#include <thread>
+
+#include "../../include/SpscRing.h"
+
+// Test: items come out in the order they went in, and a full ring refuses a push
+void test_fifo_order_and_full() {
+    StaticSpscRing<int, 4> ring;
+    TEST_ASSERT_TRUE(ring.empty());
+    TEST_ASSERT_EQUAL_UINT16(4, ring.getCapacity());
+
+    for (int i = 1; i <= 4; i++) {
+        TEST_ASSERT_TRUE(ring.push(i));
+    }
+    TEST_ASSERT_TRUE(ring.full());  // Every slot is usable, no spare
+    TEST_ASSERT_FALSE(ring.push(5));
+    TEST_ASSERT_NULL(ring.reserve());
+
+    int out = 0;
+    for (int i = 1; i <= 4; i++) {
+        TEST_ASSERT_TRUE(ring.pop(out));
+        TEST_ASSERT_EQUAL_INT(i, out);
+    }
+    TEST_ASSERT_FALSE(ring.pop(out));
+    TEST_ASSERT_NULL(ring.front());
+}
+
+// Test: after wrapping, the first contiguous run ends at the end of the storage
+void test_wraparound_spans() {
+    StaticSpscRing<int, 5> ring;
+    for (int i = 0; i < 4; i++) {
+        ring.push(i);
+    }
+    ring.drop(3);
+    for (int i = 4; i < 8; i++) {
+        ring.push(i);
+    }
+
+    TEST_ASSERT_EQUAL_UINT16(5, ring.size());
+    TEST_ASSERT_EQUAL_UINT16(3, ring.tailSlot());
+    TEST_ASSERT_EQUAL_UINT16(2, ring.frontSpan());
+    for (uint16_t i = 0; i < ring.size(); i++) {
+        TEST_ASSERT_EQUAL_INT(3 + i, ring.at(i));
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, ring.slotOf(2));
+}
+
+// Test: linearize() moves the oldest item to slot 0 and reports where it was
+void test_linearize_and_retract() {
+    StaticSpscRing<int, 4> ring;
+    for (int i = 0; i < 6; i++) {
+        if (ring.full()) {
+            ring.drop();
+        }
+        ring.push(i);
+    }
+
+    TEST_ASSERT_EQUAL_UINT16(2, ring.linearize());
+    TEST_ASSERT_EQUAL_UINT16(0, ring.tailSlot());
+    TEST_ASSERT_EQUAL_UINT16(4, ring.frontSpan());
+    for (int i = 0; i < 4; i++) {
+        TEST_ASSERT_EQUAL_INT(2 + i, ring.storage()[i]);
+    }
+
+    ring.retract(3);
+    TEST_ASSERT_EQUAL_UINT16(1, ring.size());
+    TEST_ASSERT_EQUAL_INT(2, *ring.front());
+    ring.retract(5);  // More than present: empties the ring
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+// Test: attaching storage with a count resumes a saved ring (RTC memory or a restore)
+void test_attach_with_saved_count() {
+    int saved[6] = {10, 11, 12, 0, 0, 0};
+    SpscRing<int> ring;
+    ring.attach(saved, 6, 3);
+
+    TEST_ASSERT_EQUAL_UINT16(3, ring.size());
+    TEST_ASSERT_EQUAL_INT(10, *ring.front());
+    TEST_ASSERT_EQUAL_UINT16(3, ring.headSlot());
+    TEST_ASSERT_TRUE(ring.push(13));
+    TEST_ASSERT_EQUAL_INT(13, saved[3]);
+}
+
+// Test: a ring over a timestamp column indexes parallel value columns by slot
+void test_parallel_columns() {
+    StaticSpscRing<uint32_t, 3> timestamps;
+    float values[3] = {};
+
+    for (uint32_t t = 1; t <= 5; t++) {
+        if (timestamps.full()) {
+            timestamps.drop();
+        }
+        values[timestamps.headSlot()] = t * 1.5f;
+        timestamps.push(t);
+    }
+
+    for (uint16_t i = 0; i < timestamps.size(); i++) {
+        uint16_t slot = timestamps.slotOf(i);
+        TEST_ASSERT_EQUAL_FLOAT(timestamps.storage()[slot] * 1.5f, values[slot]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(3, *timestamps.front());
+}
+
+// Test: one producer thread and one consumer thread pass every item through in order
+void test_two_thread_handoff() {
+    static StaticSpscRing<uint32_t, 16> ring;
+    const uint32_t ITEMS = 200000;
+
+    std::thread producer([&]() {
+        for (uint32_t i = 0; i < ITEMS;) {
+            if (ring.push(i)) {
+                i++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    uint32_t expected = 0;
+    bool ordered = true;
+    while (expected < ITEMS) {
+        uint32_t value;
+        if (ring.pop(value)) {
+            ordered = ordered && value == expected;
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    TEST_ASSERT_TRUE_MESSAGE(ordered, "Items must arrive in push order, none lost");
+    TEST_ASSERT_TRUE(ring.empty());
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+
+    RUN_TEST(test_fifo_order_and_full);
+    RUN_TEST(test_wraparound_spans);
+    RUN_TEST(test_linearize_and_retract);
+    RUN_TEST(test_attach_with_saved_count);
+    RUN_TEST(test_parallel_columns);
+    RUN_TEST(test_two_thread_handoff);
+
+    return UNITY_END();
+}